@@ -29,6 +29,7 @@ LOCAL_SRC_FILES := \
     os/core/floatRt.c \
     os/core/heap.c \
     os/core/hostIntf.c \
+    os/core/hostIntfCompact.c \
     os/core/hostIntfI2c.c \
     os/core/hostIntfSpi.c \
     os/core/nanohubCommand.c \
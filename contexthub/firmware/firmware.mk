@@ -116,7 +116,7 @@ endif
 SRCS_os += os/core/spi.c
 SRCS_os += os/core/printf.c os/core/timer.c os/core/seos.c os/core/heap.c os/core/slab.c os/core/trylock.c
 #SRCS_os += os/core/hostIntf.c os/core/hostIntfI2c.c os/core/hostIntfSpi.c os/core/nanohubCommand.c os/core/sensors.c os/core/syscall.c
-SRCS_os += os/core/hostIntf.c os/core/nanohubCommand.c os/core/sensors.c os/core/syscall.c
+SRCS_os += os/core/hostIntf.c os/core/hostIntfCompact.c os/core/nanohubCommand.c os/core/sensors.c os/core/syscall.c
 SRCS_os += os/core/eventQ.c os/core/appSec.c os/core/simpleQ.c os/core/floatRt.c os/core/nanohub_chre.c
 SRCS_os += os/algos/ap_hub_sync.c
 ifeq ($(SUPPORT_EXT_APP), YES)
@@ -73,25 +73,25 @@ void diversityCheckerReset(struct DiversityChecker* diverse_data) {
 
 bool diversityCheckerFindNearestPoint(struct DiversityChecker* diverse_data,
                                       float x, float y, float z) {
-  // Converting three single inputs to a vector.
-  const float vec[THREE_AXIS_DATA_DIM] = {x, y, z};
-
-  // Result vector for vector difference.
-  float vec_diff[THREE_AXIS_DATA_DIM];
+  // Stored data point, three axis each.
+  const float* point = diverse_data->diverse_data;
 
   // normSquared result (k)
   float norm_squared_result;
 
   size_t i;
 
-  // Running over all existing data points
-  for (i = 0; i < diverse_data->num_points; ++i) {
+  // Running over all existing data points. This runs on every sample, so
+  // vecSub() and vecNormSquared() are unrolled here for the three axes, in
+  // the same order of operations.
+  for (i = 0; i < diverse_data->num_points; ++i, point += THREE_AXIS_DATA_DIM) {
     // v = v1 - v2;
-    vecSub(vec_diff, &diverse_data->diverse_data[i * THREE_AXIS_DATA_DIM], vec,
-           THREE_AXIS_DATA_DIM);
+    const float dx = point[0] - x;
+    const float dy = point[1] - y;
+    const float dz = point[2] - z;
 
     // k = |v|^2
-    norm_squared_result = vecNormSquared(vec_diff, THREE_AXIS_DATA_DIM);
+    norm_squared_result = dx * dx + dy * dy + dz * dz;
 
     // if k < Threshold then leave the function.
     if (norm_squared_result < diverse_data->threshold) {
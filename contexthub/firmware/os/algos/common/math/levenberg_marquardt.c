@@ -24,6 +24,11 @@ static bool computeResidualAndGradients(ResidualAndJacobianFunction func,
 static bool computeStep(const float *gradient, float *hessian, float *L,
                         float damping_factor, size_t dim, float *step);
 
+static void accumulateNormalEquations(const float *jacobian,
+                                      const float *residual, size_t meas_dim,
+                                      size_t state_dim, float *hessian,
+                                      float *gradient);
+
 const static float kEps = 1e-10f;
 
 // FUNCTION IMPLEMENTATIONS
@@ -227,14 +232,53 @@ bool computeResidualAndGradients(ResidualAndJacobianFunction func,
 
   // Compute the cost function hessian = jacobian' jacobian and
   // gradient = -jacobian' residual
-  matTransposeMultiplyMat(hessian, jacobian, meas_dim, state_dim);
-  matTransposeMultiplyVec(gradient, jacobian, residual, meas_dim, state_dim);
+  accumulateNormalEquations(jacobian, residual, meas_dim, state_dim, hessian,
+                            gradient);
   vecScalarMulInPlace(gradient, -1.f, state_dim);
 
   // Check if solution is found (cost function gradient is sufficiently small).
   return (vecMaxAbsoluteValue(gradient, state_dim) < gradient_threshold);
 }
 
+/*
+ * Computes hessian = J' J and gradient = J' f. Unlike matTransposeMultiplyMat()
+ * and matTransposeMultiplyVec(), each element is summed in a local, which the
+ * compiler can keep in a register since it cannot alias the jacobian, and the
+ * gradient is summed along with the diagonal of the hessian. Every element is
+ * still summed over the rows in increasing order, so the results are the
+ * same. Only the upper triangle of the hessian is summed, the lower one is
+ * mirrored from it.
+ */
+void accumulateNormalEquations(const float *jacobian, const float *residual,
+                               size_t meas_dim, size_t state_dim,
+                               float *hessian, float *gradient) {
+  size_t i, j, k;
+
+  for (i = 0; i < state_dim; ++i) {
+    float sum = 0.0f;
+    float gradient_sum = 0.0f;
+
+    // Diagonal and gradient.
+    for (k = 0; k < meas_dim; ++k) {
+      const float a = jacobian[k * state_dim + i];
+      sum += a * a;
+      gradient_sum += a * residual[k];
+    }
+    hessian[i * state_dim + i] = sum;
+    gradient[i] = gradient_sum;
+
+    // Off diagonal, mirrored.
+    for (j = i + 1; j < state_dim; ++j) {
+      sum = 0.0f;
+      for (k = 0; k < meas_dim; ++k) {
+        sum += jacobian[k * state_dim + i] * jacobian[k * state_dim + j];
+      }
+      hessian[i * state_dim + j] = sum;
+      hessian[j * state_dim + i] = sum;
+    }
+  }
+}
+
 /*
  * Computes the Levenberg-Marquardt solver step to satisfy the following:
  *    (J'J + uI) * step = - J' f
@@ -257,6 +257,43 @@ static void fusionCheckState(struct Fusion *fusion) {
 
 #define kEps 1.0E-4f
 
+// out = A0 * B0 + A1 * B1, summed in the same order as two mat33Multiply() and a mat33Add()
+UNROLLED
+static void blockMultiplyAdd(struct Mat33 *out, const struct Mat33 *A0, const struct Mat33 *B0,
+                             const struct Mat33 *A1, const struct Mat33 *B1) {
+    uint32_t i;
+    for (i = 0; i < 3; ++i) {
+        uint32_t j;
+        for (j = 0; j < 3; ++j) {
+            out->elem[i][j] =
+                    (A0->elem[i][0] * B0->elem[0][j] + A0->elem[i][1] * B0->elem[1][j] + A0->elem[i][2] * B0->elem[2][j]) +
+                    (A1->elem[i][0] * B1->elem[0][j] + A1->elem[i][1] * B1->elem[1][j] + A1->elem[i][2] * B1->elem[2][j]);
+        }
+    }
+}
+
+// out = A0 * B0^T + A1 * B1^T
+UNROLLED
+static void blockMultiplyTransposed2Add(struct Mat33 *out, const struct Mat33 *A0, const struct Mat33 *B0,
+                                        const struct Mat33 *A1, const struct Mat33 *B1) {
+    uint32_t i;
+    for (i = 0; i < 3; ++i) {
+        uint32_t j;
+        for (j = 0; j < 3; ++j) {
+            out->elem[i][j] =
+                    (A0->elem[i][0] * B0->elem[j][0] + A0->elem[i][1] * B0->elem[j][1] + A0->elem[i][2] * B0->elem[j][2]) +
+                    (A1->elem[i][0] * B1->elem[j][0] + A1->elem[i][1] * B1->elem[j][1] + A1->elem[i][2] * B1->elem[j][2]);
+        }
+    }
+}
+
+// GQGt blocks are diagonal, so only their diagonal needs adding
+static void addDiagonal(struct Mat33 *out, const struct Mat33 *D) {
+    out->elem[0][0] += D->elem[0][0];
+    out->elem[1][1] += D->elem[1][1];
+    out->elem[2][2] += D->elem[2][2];
+}
+
 UNROLLED
 static void fusionPredict(struct Fusion *fusion, const struct Vec3 *w) {
     const float dT = fusion->mPredictDt;
@@ -267,11 +304,11 @@ static void fusionPredict(struct Fusion *fusion, const struct Vec3 *w) {
     struct Vec3 we = *w;
     vec3Sub(&we, &b);
 
-    struct Mat33 I33;
-    initDiagonalMatrix(&I33, 1.0f);
+    float norm_we = vec3Norm(&we);
 
-    struct Mat33 I33dT;
-    initDiagonalMatrix(&I33dT, dT);
+    if (fabsf(norm_we) < kEps) {
+        return;
+    }
 
     struct Mat33 wx;
     matrixCross(&wx, &we, 0.0f);
@@ -279,12 +316,6 @@ static void fusionPredict(struct Fusion *fusion, const struct Vec3 *w) {
     struct Mat33 wx2;
     mat33Multiply(&wx2, &wx, &wx);
 
-    float norm_we = vec3Norm(&we);
-
-    if (fabsf(norm_we) < kEps) {
-        return;
-    }
-
     float lwedT = norm_we * dT;
     float hlwedT = 0.5f * lwedT;
     float ilwe = 1.0f / norm_we;
@@ -319,27 +350,18 @@ static void fusionPredict(struct Fusion *fusion, const struct Vec3 *w) {
     O.elem[1][3] = psi.y;
     O.elem[2][3] = psi.z;
 
-    struct Mat33 tmp = wx;
-    mat33ScalarMul(&tmp, k1 * ilwe);
-
-    fusion->Phi0[0] = I33;
-    mat33Sub(&fusion->Phi0[0], &tmp);
-
-    tmp = wx2;
-    mat33ScalarMul(&tmp, k0);
-
-    mat33Add(&fusion->Phi0[0], &tmp);
-
-    tmp = wx;
-    mat33ScalarMul(&tmp, k0);
-    fusion->Phi0[1] = tmp;
-
-    mat33Sub(&fusion->Phi0[1], &I33dT);
-
-    tmp = wx2;
-    mat33ScalarMul(&tmp, ilwe * ilwe * ilwe * (lwedT - k1));
-
-    mat33Sub(&fusion->Phi0[1], &tmp);
+    // Phi0[0] = I - wx * k1 / |we| + wx2 * k0
+    // Phi0[1] = wx * k0 - I * dT - wx2 * (|we| * dT - k1) / |we|^3
+    const float c0 = k1 * ilwe;
+    const float c1 = ilwe * ilwe * ilwe * (lwedT - k1);
+    for (i = 0; i < 3; ++i) {
+        uint32_t j;
+        for (j = 0; j < 3; ++j) {
+            const float id = (i == j) ? 1.0f : 0.0f;
+            fusion->Phi0[0].elem[i][j] = (id - wx.elem[i][j] * c0) + wx2.elem[i][j] * k0;
+            fusion->Phi0[1].elem[i][j] = (wx.elem[i][j] * k0 - id * dT) - wx2.elem[i][j] * c1;
+        }
+    }
 
     mat44Apply(&fusion->x0, &O, &q);
 
@@ -350,38 +372,25 @@ static void fusionPredict(struct Fusion *fusion, const struct Vec3 *w) {
         fusion->x0.w = -fusion->x0.w;
     }
 
-    // Pnew = Phi * P
+    // Pnew = Phi * P, the lower block row of Phi is [0 I] so Pnew[1][*] is P[1][*]
 
-    struct Mat33 Pnew[2][2];
-    mat33Multiply(&Pnew[0][0], &fusion->Phi0[0], &fusion->P[0][0]);
-    mat33Multiply(&tmp, &fusion->Phi0[1], &fusion->P[1][0]);
-    mat33Add(&Pnew[0][0], &tmp);
-
-    mat33Multiply(&Pnew[0][1], &fusion->Phi0[0], &fusion->P[0][1]);
-    mat33Multiply(&tmp, &fusion->Phi0[1], &fusion->P[1][1]);
-    mat33Add(&Pnew[0][1], &tmp);
-
-    Pnew[1][0] = fusion->P[1][0];
-    Pnew[1][1] = fusion->P[1][1];
+    struct Mat33 Pnew[2];
+    blockMultiplyAdd(&Pnew[0], &fusion->Phi0[0], &fusion->P[0][0], &fusion->Phi0[1], &fusion->P[1][0]);
+    blockMultiplyAdd(&Pnew[1], &fusion->Phi0[0], &fusion->P[0][1], &fusion->Phi0[1], &fusion->P[1][1]);
 
     // P = Pnew * Phi^T
 
-    mat33MultiplyTransposed2(&fusion->P[0][0], &Pnew[0][0], &fusion->Phi0[0]);
-    mat33MultiplyTransposed2(&tmp, &Pnew[0][1], &fusion->Phi0[1]);
-    mat33Add(&fusion->P[0][0], &tmp);
-
-    fusion->P[0][1] = Pnew[0][1];
-
-    mat33MultiplyTransposed2(&fusion->P[1][0], &Pnew[1][0], &fusion->Phi0[0]);
-    mat33MultiplyTransposed2(&tmp, &Pnew[1][1], &fusion->Phi0[1]);
-    mat33Add(&fusion->P[1][0], &tmp);
+    struct Mat33 tmp;
+    blockMultiplyTransposed2Add(&fusion->P[0][0], &Pnew[0], &fusion->Phi0[0], &Pnew[1], &fusion->Phi0[1]);
+    blockMultiplyTransposed2Add(&tmp, &fusion->P[1][0], &fusion->Phi0[0], &fusion->P[1][1], &fusion->Phi0[1]);
 
-    fusion->P[1][1] = Pnew[1][1];
+    fusion->P[0][1] = Pnew[1];
+    fusion->P[1][0] = tmp;
 
-    mat33Add(&fusion->P[0][0], &fusion->GQGt[0][0]);
-    mat33Add(&fusion->P[0][1], &fusion->GQGt[0][1]);
-    mat33Add(&fusion->P[1][0], &fusion->GQGt[1][0]);
-    mat33Add(&fusion->P[1][1], &fusion->GQGt[1][1]);
+    addDiagonal(&fusion->P[0][0], &fusion->GQGt[0][0]);
+    addDiagonal(&fusion->P[0][1], &fusion->GQGt[0][1]);
+    addDiagonal(&fusion->P[1][0], &fusion->GQGt[1][0]);
+    addDiagonal(&fusion->P[1][1], &fusion->GQGt[1][1]);
 
     fusionCheckState(fusion);
 }
@@ -420,6 +429,38 @@ static void scaleCovariance(struct Mat33 *out, const struct Mat33 *A, const stru
     }
 }
 
+// out = A * L for L = matrixCross(p, 0.0f), skipping the zero terms of L
+static void multiplyCross(struct Mat33 *out, const struct Mat33 *A, const struct Mat33 *L) {
+    uint32_t i;
+    for (i = 0; i < 3; ++i) {
+        out->elem[i][0] = A->elem[i][1] * L->elem[1][0] + A->elem[i][2] * L->elem[2][0];
+        out->elem[i][1] = A->elem[i][0] * L->elem[0][1] + A->elem[i][2] * L->elem[2][1];
+        out->elem[i][2] = A->elem[i][0] * L->elem[0][2] + A->elem[i][1] * L->elem[1][2];
+    }
+}
+
+// out = L^T * A for L = matrixCross(p, 0.0f)
+static void crossTransposedMultiply(struct Mat33 *out, const struct Mat33 *L, const struct Mat33 *A) {
+    uint32_t j;
+    for (j = 0; j < 3; ++j) {
+        out->elem[0][j] = L->elem[1][0] * A->elem[1][j] + L->elem[2][0] * A->elem[2][j];
+        out->elem[1][j] = L->elem[0][1] * A->elem[0][j] + L->elem[2][1] * A->elem[2][j];
+        out->elem[2][j] = L->elem[0][2] * A->elem[0][j] + L->elem[1][2] * A->elem[1][j];
+    }
+}
+
+// out -= A * B, B must not alias out
+UNROLLED
+static void multiplySub(struct Mat33 *out, const struct Mat33 *A, const struct Mat33 *B) {
+    uint32_t i;
+    for (i = 0; i < 3; ++i) {
+        uint32_t j;
+        for (j = 0; j < 3; ++j) {
+            out->elem[i][j] -= A->elem[i][0] * B->elem[0][j] + A->elem[i][1] * B->elem[1][j] + A->elem[i][2] * B->elem[2][j];
+        }
+    }
+}
+
 static void getF(struct Vec4 F[3], const struct Vec4 *q) {
     F[0].x = q->w;      F[1].x = -q->z;         F[2].x = q->y;
     F[0].y = q->z;      F[1].y = q->w;          F[2].y = -q->x;
@@ -438,36 +479,36 @@ static void fusionUpdate(
     struct Mat33 L;
     matrixCross(&L, &Bb, 0.0f);
 
-    struct Mat33 R;
-    initDiagonalMatrix(&R, sigma * sigma);
-
+    // S = L * P00 * L^T + R, R being sigma^2 on the diagonal
     struct Mat33 S;
     scaleCovariance(&S, &L, &fusion->P[0][0]);
 
-    mat33Add(&S, &R);
+    const float r = sigma * sigma;
+    S.elem[0][0] += r;
+    S.elem[1][1] += r;
+    S.elem[2][2] += r;
 
     struct Mat33 Si;
     mat33Invert(&Si, &S);
 
     struct Mat33 LtSi;
-    mat33MultiplyTransposed(&LtSi, &L, &Si);
+    crossTransposedMultiply(&LtSi, &L, &Si);
 
     struct Mat33 K[2];
     mat33Multiply(&K[0], &fusion->P[0][0], &LtSi);
     mat33MultiplyTransposed(&K[1], &fusion->P[0][1], &LtSi);
 
     struct Mat33 K0L;
-    mat33Multiply(&K0L, &K[0], &L);
+    multiplyCross(&K0L, &K[0], &L);
 
     struct Mat33 K1L;
-    mat33Multiply(&K1L, &K[1], &L);
+    multiplyCross(&K1L, &K[1], &L);
 
     struct Mat33 tmp;
     mat33Multiply(&tmp, &K0L, &fusion->P[0][0]);
     mat33Sub(&fusion->P[0][0], &tmp);
 
-    mat33Multiply(&tmp, &K1L, &fusion->P[0][1]);
-    mat33Sub(&fusion->P[1][1], &tmp);
+    multiplySub(&fusion->P[1][1], &K1L, &fusion->P[0][1]);
 
     mat33Multiply(&tmp, &K0L, &fusion->P[0][1]);
     mat33Sub(&fusion->P[0][1], &tmp);
@@ -20,137 +20,280 @@
 #include <timer.h>
 #include <stdio.h>
 #include <heap.h>
-#include <slab.h>
+#include <atomic.h>
 #include <cpu.h>
 #include <util.h>
 #include <plat/plat.h>
 #include <taggedPtr.h>
 
-#define for_each_item_safe(head, pos, tmp) \
-    for (pos = (head)->next; tmp = (pos)->next, (pos) != (head); pos = (tmp))
+/*
+ * Events live in a fixed pool of records and are queued by index on one of two
+ * bounded MPSC rings ("lanes"). Urgent events go on their own small lane that the
+ * consumer drains first, everything else keeps FIFO order on the normal lane.
+ *
+ * Each ring cell is a single 32-bit word: the upper half is the lap sequence used
+ * to hand the cell between producers and the consumer, the lower half the record
+ * index plus a discardable bit. Producers reserve a cell by CAS on the tail and
+ * publish it with one store, so enqueueing never masks interrupts. A queued event
+ * is cancelled by CAS-ing its cell payload to EVT_IDX_NONE; the consumer skips such
+ * cells. The record free list is a tagged Treiber stack, also a single word.
+ *
+ * Cancelled cells stay in the ring until the consumer passes them, so the normal
+ * lane gets twice as many cells as there are records.
+ */
 
-struct EvtList
-{
-    struct EvtList *next;
-    struct EvtList *prev;
+#define EVT_IDX_NONE                0x7FFF
+#define EVT_CELL_DISCARDABLE        0x8000
+#define EVT_CELL(seq, payload)      ((((uint32_t)(seq)) << 16) | (payload))
+#define EVT_CELL_SEQ(cell)          ((uint16_t)((cell) >> 16))
+#define EVT_CELL_IDX(cell)          ((cell) & EVT_IDX_NONE)
+
+#define EVT_QUEUE_MAX_SIZE          0x4000 /* keeps the 16-bit lap sequence unambiguous */
+#define EVT_URGENT_LANE_SIZE        16
+
+#define EVT_FREE_TAG_INC            0x10000
+
+enum EvtLaneId {
+    EVT_LANE_URGENT,
+    EVT_LANE_NORMAL,
+    EVT_LANE_NUM,
 };
 
 struct EvtRecord {
-    struct EvtList item;
-    uint32_t evtType;
+    union {
+        uint32_t evtType;
+        uint32_t next; /* free list link while the record is not queued */
+    };
     void* evtData;
     TaggedPtr evtFreeData;
 };
 
+struct EvtLane {
+    volatile uint32_t tail;
+    uint32_t head; /* only the consumer moves it */
+    uint32_t mask;
+    volatile uint32_t *cells;
+};
+
 struct EvtQueue {
-    struct EvtList head;
-    struct SlabAllocator *evtsSlab;
+    struct EvtLane lanes[EVT_LANE_NUM];
+    volatile uint32_t freeHead; /* ABA tag in the upper half, record index in the lower */
+    struct EvtRecord *records;
     EvtQueueForciblyDiscardEvtCbkF forceDiscardCbk;
 };
 
-static inline void __evtListDel(struct EvtList *prev, struct EvtList *next)
+static uint32_t evtLaneInit(struct EvtLane *lane, volatile uint32_t *cells, uint32_t size)
 {
-    next->prev = prev;
-    prev->next = next;
+    uint32_t i;
+
+    lane->tail = 0;
+    lane->head = 0;
+    lane->mask = size - 1;
+    lane->cells = cells;
+
+    for (i = 0; i < size; i++)
+        cells[i] = EVT_CELL(i, EVT_IDX_NONE);
+
+    return size;
 }
 
-static inline void evtListDel(struct EvtList *entry)
+static bool evtLanePut(struct EvtLane *lane, uint32_t payload)
 {
-    __evtListDel(entry->prev, entry->next);
-    entry->next = entry->prev = NULL;
+    volatile uint32_t *cell;
+    uint32_t pos;
+    int16_t dif;
+
+    while (1) {
+        pos = atomicRead32bits(&lane->tail);
+        cell = &lane->cells[pos & lane->mask];
+        dif = (int16_t)(EVT_CELL_SEQ(atomicRead32bits(cell)) - (uint16_t)pos);
+
+        if (dif < 0)
+            return false; // consumer has not released this cell yet: lane is full
+        if (!dif && atomicCmpXchg32bits(&lane->tail, pos, pos + 1))
+            break;
+    }
+
+    atomicXchg32bits(cell, EVT_CELL(pos + 1, payload));
+    return true;
 }
 
-struct EvtQueue* evtQueueAlloc(uint32_t size, EvtQueueForciblyDiscardEvtCbkF forceDiscardCbk)
+static bool evtLaneTake(struct EvtLane *lane, uint32_t *idxP)
 {
-    struct EvtQueue *q = heapAlloc(sizeof(struct EvtQueue));
-    struct SlabAllocator *slab = slabAllocatorNew(sizeof(struct EvtRecord),
-                                                  alignof(struct EvtRecord), size);
-
-    if (q && slab) {
-        q->forceDiscardCbk = forceDiscardCbk;
-        q->evtsSlab = slab;
-        q->head.next = &q->head;
-        q->head.prev = &q->head;
-        return q;
+    volatile uint32_t *cell;
+    uint32_t pos, val;
+
+    while (1) {
+        pos = lane->head;
+        cell = &lane->cells[pos & lane->mask];
+        val = atomicRead32bits(cell);
+
+        if (EVT_CELL_SEQ(val) != (uint16_t)(pos + 1))
+            return false;
+
+        // lose against a concurrent cancel and we just pick the cell up again as a hole
+        if (!atomicCmpXchg32bits(cell, val, EVT_CELL(pos + lane->mask + 1, EVT_IDX_NONE)))
+            continue;
+
+        lane->head = pos + 1;
+        if (EVT_CELL_IDX(val) != EVT_IDX_NONE) {
+            *idxP = EVT_CELL_IDX(val);
+            return true;
+        }
     }
+}
+
+static bool evtLaneIsEmpty(struct EvtLane *lane)
+{
+    return EVT_CELL_SEQ(atomicRead32bits(&lane->cells[lane->head & lane->mask])) != (uint16_t)(lane->head + 1);
+}
+
+// try to take queued cell at pos away from the consumer. returns the record index or EVT_IDX_NONE
+static uint32_t evtLaneCancel(struct EvtLane *lane, uint32_t pos, uint32_t val)
+{
+    volatile uint32_t *cell = &lane->cells[pos & lane->mask];
 
-    if (q)
-        heapFree(q);
-    if (slab)
-        slabAllocatorDestroy(slab);
+    if (EVT_CELL_SEQ(val) != (uint16_t)(pos + 1) || EVT_CELL_IDX(val) == EVT_IDX_NONE)
+        return EVT_IDX_NONE;
+    if (!atomicCmpXchg32bits(cell, val, EVT_CELL(pos + 1, EVT_IDX_NONE)))
+        return EVT_IDX_NONE;
 
-    return NULL;
+    return EVT_CELL_IDX(val);
 }
 
-void evtQueueFree(struct EvtQueue* q)
+static uint32_t evtRecordAlloc(struct EvtQueue *q)
 {
-    struct EvtList *pos, *tmp;
+    uint32_t old, idx;
 
-    for_each_item_safe (&q->head, pos, tmp) {
-        struct EvtRecord * rec = container_of(pos, struct EvtRecord, item);
+    do {
+        old = atomicRead32bits(&q->freeHead);
+        idx = old & 0xFFFF;
+        if (idx == EVT_IDX_NONE)
+            return EVT_IDX_NONE;
+    } while (!atomicCmpXchg32bits(&q->freeHead, old, ((old + EVT_FREE_TAG_INC) & 0xFFFF0000) | (q->records[idx].next & 0xFFFF)));
 
-        q->forceDiscardCbk(rec->evtType, rec->evtData, rec->evtFreeData);
-        slabAllocatorFree(q->evtsSlab, rec);
-    }
+    return idx;
+}
 
-    slabAllocatorDestroy(q->evtsSlab);
-    heapFree(q);
+static void evtRecordFree(struct EvtQueue *q, uint32_t idx)
+{
+    uint32_t old;
+
+    do {
+        old = atomicRead32bits(&q->freeHead);
+        q->records[idx].next = old & 0xFFFF;
+    } while (!atomicCmpXchg32bits(&q->freeHead, old, ((old + EVT_FREE_TAG_INC) & 0xFFFF0000) | idx));
 }
 
-bool evtQueueEnqueue(struct EvtQueue* q, uint32_t evtType, void *evtData,
-                    TaggedPtr evtFreeData, bool atFront)
+// pool is exhausted: take the oldest queued discardable event and reuse its record
+static uint32_t evtQueueStealDiscardable(struct EvtQueue *q)
 {
+    struct EvtLane *lane;
     struct EvtRecord *rec;
-    uint64_t intSta;
-    struct EvtList *item = NULL, *a, *b;
+    uint32_t i, pos, val, idx;
 
+    for (i = 0; i < EVT_LANE_NUM; i++) {
+        lane = &q->lanes[i];
+        for (pos = lane->head; pos != atomicRead32bits(&lane->tail); pos++) {
+            val = atomicRead32bits(&lane->cells[pos & lane->mask]);
+            if (!(val & EVT_CELL_DISCARDABLE))
+                continue;
+            idx = evtLaneCancel(lane, pos, val);
+            if (idx != EVT_IDX_NONE) {
+                rec = &q->records[idx];
+                q->forceDiscardCbk(rec->evtType, rec->evtData, rec->evtFreeData);
+                return idx;
+            }
+        }
+    }
+
+    return EVT_IDX_NONE;
+}
+
+static uint32_t roundUpToPow2(uint32_t val)
+{
+    uint32_t ret = 1;
+
+    while (ret < val)
+        ret <<= 1;
+
+    return ret;
+}
+
+struct EvtQueue* evtQueueAlloc(uint32_t size, EvtQueueForciblyDiscardEvtCbkF forceDiscardCbk)
+{
+    struct EvtQueue *q;
+    uint32_t normalSz, i;
+    volatile uint32_t *cells;
+
+    if (!size || size > EVT_QUEUE_MAX_SIZE)
+        return NULL;
+
+    normalSz = roundUpToPow2(size * 2);
+    q = heapAlloc(sizeof(struct EvtQueue) + sizeof(struct EvtRecord) * size +
+                  sizeof(uint32_t) * (normalSz + EVT_URGENT_LANE_SIZE));
     if (!q)
-        return false;
+        return NULL;
 
-    rec = slabAllocatorAlloc(q->evtsSlab);
-    if (!rec) {
-        struct EvtList *pos;
+    q->forceDiscardCbk = forceDiscardCbk;
+    q->records = (struct EvtRecord*)(q + 1);
+    cells = (volatile uint32_t*)(q->records + size);
+    cells += evtLaneInit(&q->lanes[EVT_LANE_URGENT], cells, EVT_URGENT_LANE_SIZE);
+    evtLaneInit(&q->lanes[EVT_LANE_NORMAL], cells, normalSz);
 
-        intSta = cpuIntsOff();
-        //find a victim for discarding
-        for (pos = q->head.next; pos != &q->head; pos = pos->next) {
-            rec = container_of(pos, struct EvtRecord, item);
-            if (!(rec->evtType & EVENT_TYPE_BIT_DISCARDABLE))
-                continue;
+    for (i = 0; i < size; i++)
+        q->records[i].next = i + 1 < size ? i + 1 : EVT_IDX_NONE;
+    q->freeHead = 0;
+
+    return q;
+}
+
+void evtQueueFree(struct EvtQueue* q)
+{
+    struct EvtRecord *rec;
+    uint32_t i, idx;
+
+    for (i = 0; i < EVT_LANE_NUM; i++) {
+        while (evtLaneTake(&q->lanes[i], &idx)) {
+            rec = &q->records[idx];
             q->forceDiscardCbk(rec->evtType, rec->evtData, rec->evtFreeData);
-            evtListDel(pos);
-            item = pos;
         }
-        cpuIntsRestore (intSta);
-    } else {
-        item = &rec->item;
     }
 
-    if (!item)
+    heapFree(q);
+}
+
+bool evtQueueEnqueue(struct EvtQueue* q, uint32_t evtType, void *evtData,
+                    TaggedPtr evtFreeData, bool atFront)
+{
+    struct EvtRecord *rec;
+    uint32_t idx, payload;
+
+    if (!q)
         return false;
 
-    item->prev = item->next = NULL;
+    idx = evtRecordAlloc(q);
+    if (idx == EVT_IDX_NONE)
+        idx = evtQueueStealDiscardable(q);
+    if (idx == EVT_IDX_NONE)
+        return false;
 
+    rec = &q->records[idx];
     rec->evtType = evtType;
     rec->evtData = evtData;
     rec->evtFreeData = evtFreeData;
 
-    intSta = cpuIntsOff();
+    payload = idx;
+    if (evtType & EVENT_TYPE_BIT_DISCARDABLE)
+        payload |= EVT_CELL_DISCARDABLE;
 
-    if (unlikely(atFront)) {
-        b = q->head.next;
-        a = b->prev;
-    } else {
-        a = q->head.prev;
-        b = a->next;
+    // a full urgent lane only costs the event its priority
+    if (!(unlikely(atFront) && evtLanePut(&q->lanes[EVT_LANE_URGENT], payload)) &&
+        !evtLanePut(&q->lanes[EVT_LANE_NORMAL], payload)) {
+        evtRecordFree(q, idx);
+        return false;
     }
 
-    a->next = item;
-    item->prev = a;
-    b->prev = item;
-    item->next = b;
-
-    cpuIntsRestore(intSta);
     platWake();
     return true;
 }
@@ -159,40 +302,43 @@ void evtQueueRemoveAllMatching(struct EvtQueue* q,
                                bool (*match)(uint32_t evtType, const void *data, void *context),
                                void *context)
 {
-    uint64_t intSta = cpuIntsOff();
-    struct EvtList *pos, *tmp;
-
-    for_each_item_safe (&q->head, pos, tmp) {
-        struct EvtRecord * rec = container_of(pos, struct EvtRecord, item);
+    struct EvtLane *lane;
+    struct EvtRecord *rec;
+    uint32_t i, pos, val, idx;
 
-        if (match(rec->evtType, rec->evtData, context)) {
-            q->forceDiscardCbk(rec->evtType, rec->evtData, rec->evtFreeData);
-            evtListDel(pos);
-            slabAllocatorFree(q->evtsSlab, rec);
+    for (i = 0; i < EVT_LANE_NUM; i++) {
+        lane = &q->lanes[i];
+        for (pos = lane->head; pos != atomicRead32bits(&lane->tail); pos++) {
+            val = atomicRead32bits(&lane->cells[pos & lane->mask]);
+            if (EVT_CELL_SEQ(val) != (uint16_t)(pos + 1) || EVT_CELL_IDX(val) == EVT_IDX_NONE)
+                continue;
+            rec = &q->records[EVT_CELL_IDX(val)];
+            if (!match(rec->evtType, rec->evtData, context))
+                continue;
+            idx = evtLaneCancel(lane, pos, val);
+            if (idx != EVT_IDX_NONE) {
+                q->forceDiscardCbk(rec->evtType, rec->evtData, rec->evtFreeData);
+                evtRecordFree(q, idx);
+            }
         }
     }
-    cpuIntsRestore(intSta);
 }
 
 bool evtQueueDequeue(struct EvtQueue* q, uint32_t *evtTypeP, void **evtDataP,
                      TaggedPtr *evtFreeDataP, bool sleepIfNone)
 {
-    struct EvtRecord *rec = NULL;
+    struct EvtRecord *rec;
     uint64_t intSta;
+    uint32_t idx;
 
-    while(1) {
-        struct EvtList *pos;
-        intSta = cpuIntsOff();
+    while (!evtLaneTake(&q->lanes[EVT_LANE_URGENT], &idx) && !evtLaneTake(&q->lanes[EVT_LANE_NORMAL], &idx)) {
+        if (!sleepIfNone)
+            return false;
 
-        pos = q->head.next;
-        if (pos != &q->head) {
-            rec = container_of(pos, struct EvtRecord, item);
-            evtListDel(pos);
-            break;
-        }
-        else if (!sleepIfNone)
-            break;
-        else if (!timIntHandler()) {
+        // producers do not mask interrupts, so recheck with them off before going to sleep
+        intSta = cpuIntsOff();
+        if (evtLaneIsEmpty(&q->lanes[EVT_LANE_URGENT]) && evtLaneIsEmpty(&q->lanes[EVT_LANE_NORMAL]) &&
+            !timIntHandler()) {
             // check for timers
             // if any fire, do not sleep (since by the time callbacks run, more might be due)
             platSleep();
@@ -202,15 +348,11 @@ bool evtQueueDequeue(struct EvtQueue* q, uint32_t *evtTypeP, void **evtDataP,
         cpuIntsRestore(intSta);
     }
 
-    cpuIntsRestore(intSta);
-
-    if (!rec)
-        return false;
-
+    rec = &q->records[idx];
     *evtTypeP = rec->evtType;
     *evtDataP = rec->evtData;
     *evtFreeDataP = rec->evtFreeData;
-    slabAllocatorFree(q->evtsSlab, rec);
+    evtRecordFree(q, idx);
 
     return true;
 }
@@ -18,6 +18,8 @@
 #include <atomic.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stddef.h>
+#include <string.h>
 #include <heap.h>
 #include <seos.h>
 #include <cmsis.h>
@@ -47,6 +49,33 @@ struct HeapNode {
     uint8_t  data[];
 };
 
+//the header ends where the data starts, on 64-bit hosts sizeof() would count the tail padding too
+#define HEAP_NODE_SIZE      offsetof(struct HeapNode, data)
+
+/*
+ * Free chunks are kept in two-level segregated lists (TLSF): the first level splits sizes by
+ * power of two, the second level splits each power of two into HEAP_SL_COUNT linear ranges.
+ * Bitmaps of non-empty lists find a fitting chunk with two bit scans, so alloc and free are O(1).
+ * Chunks smaller than HEAP_SMALL_SIZE share first level 0 with one list per 4 bytes.
+ */
+#define HEAP_ALIGN_LOG2     2
+#define HEAP_SL_COUNT_LOG2  3
+#define HEAP_SL_COUNT       (1 << HEAP_SL_COUNT_LOG2)
+#define HEAP_FL_SHIFT       (HEAP_SL_COUNT_LOG2 + HEAP_ALIGN_LOG2)
+#define HEAP_FL_COUNT       (MAX_HEAP_ORDER - HEAP_FL_SHIFT + 1)
+#define HEAP_SMALL_SIZE     (1UL << HEAP_FL_SHIFT)
+
+//links of a free chunk live in its data
+struct HeapFreeLinks {
+    struct HeapNode* next;
+    struct HeapNode* prev;
+};
+
+#define HEAP_MIN_DATA_SIZE  (sizeof(struct HeapFreeLinks))
+
+//tidx of a free chunk that heapFree() could not put to the lists since the lock was busy
+#define HEAP_TIDX_DEFERRED  1
+
 #ifdef FORCE_HEAP_IN_DOT_DATA
 
     static uint8_t __attribute__ ((aligned (8))) gHeap[HEAP_SIZE];
@@ -81,11 +110,174 @@ static TRYLOCK_DECL_STATIC(gHeapLock) = TRYLOCK_INIT_STATIC();
 static volatile uint8_t gNeedFreeMerge = false; /* cannot be bool since its size is ill defined */
 static struct HeapNode *gHeapTail;
 
+static uint32_t gHeapFlBitmap;
+static uint8_t gHeapSlBitmap[HEAP_FL_COUNT];
+static struct HeapNode* gHeapFreeLists[HEAP_FL_COUNT][HEAP_SL_COUNT];
+
+static struct HeapStats gHeapStats;
+
 static inline struct HeapNode* heapPrvGetNext(struct HeapNode* node)
 {
     return (gHeapTail == node) ? NULL : (struct HeapNode*)(node->data + node->size);
 }
 
+static inline struct HeapFreeLinks* heapPrvGetLinks(struct HeapNode* node)
+{
+    return (struct HeapFreeLinks*)node->data;
+}
+
+static inline bool heapPrvIsListed(struct HeapNode* node)
+{
+    return !node->used && node->tidx != HEAP_TIDX_DEFERRED;
+}
+
+static inline uint32_t heapPrvFls(uint32_t val)
+{
+    return 31 - __builtin_clz(val);
+}
+
+static inline uint32_t heapPrvFfs(uint32_t val)
+{
+    return __builtin_ctz(val);
+}
+
+static void heapPrvMapping(uint32_t size, uint32_t *fl, uint32_t *sl)
+{
+    uint32_t order;
+
+    if (size < HEAP_SMALL_SIZE) {
+        *fl = 0;
+        *sl = size >> HEAP_ALIGN_LOG2;
+    } else {
+        order = heapPrvFls(size);
+        *sl = (size >> (order - HEAP_SL_COUNT_LOG2)) ^ HEAP_SL_COUNT;
+        *fl = order - HEAP_FL_SHIFT + 1;
+    }
+}
+
+//round the size up to the next list, so that any chunk of the found list is big enough
+static void heapPrvMappingSearch(uint32_t size, uint32_t *fl, uint32_t *sl)
+{
+    if (size >= HEAP_SMALL_SIZE)
+        size += (1UL << (heapPrvFls(size) - HEAP_SL_COUNT_LOG2)) - 1;
+
+    heapPrvMapping(size, fl, sl);
+}
+
+static void heapPrvInsertFree(struct HeapNode* node)
+{
+    struct HeapFreeLinks *links = heapPrvGetLinks(node);
+    uint32_t fl, sl;
+
+    heapPrvMapping(node->size, &fl, &sl);
+
+    node->used = 0;
+    node->tidx = 0;
+    links->prev = NULL;
+    links->next = gHeapFreeLists[fl][sl];
+    if (links->next)
+        heapPrvGetLinks(links->next)->prev = node;
+
+    gHeapFreeLists[fl][sl] = node;
+    gHeapFlBitmap |= 1UL << fl;
+    gHeapSlBitmap[fl] |= 1UL << sl;
+}
+
+static void heapPrvRemoveFree(struct HeapNode* node)
+{
+    struct HeapFreeLinks *links = heapPrvGetLinks(node);
+    uint32_t fl, sl;
+
+    heapPrvMapping(node->size, &fl, &sl);
+
+    if (links->next)
+        heapPrvGetLinks(links->next)->prev = links->prev;
+    if (links->prev)
+        heapPrvGetLinks(links->prev)->next = links->next;
+    else
+        gHeapFreeLists[fl][sl] = links->next;
+
+    if (!gHeapFreeLists[fl][sl]) {
+        gHeapSlBitmap[fl] &= ~(1UL << sl);
+        if (!gHeapSlBitmap[fl])
+            gHeapFlBitmap &= ~(1UL << fl);
+    }
+}
+
+static struct HeapNode* heapPrvFindFree(uint32_t sz)
+{
+    struct HeapNode *node;
+    uint32_t fl, sl, slMap, flMap;
+
+    heapPrvMappingSearch(sz, &fl, &sl);
+    if (fl < HEAP_FL_COUNT) {
+        slMap = gHeapSlBitmap[fl] & (0xFFFFFFFFUL << sl);
+        if (!slMap) {
+            flMap = gHeapFlBitmap & (0xFFFFFFFFUL << (fl + 1));
+            fl = flMap ? heapPrvFfs(flMap) : HEAP_FL_COUNT;
+            slMap = (fl < HEAP_FL_COUNT) ? gHeapSlBitmap[fl] : 0;
+        }
+        if (slMap)
+            return gHeapFreeLists[fl][heapPrvFfs(slMap)];
+    }
+
+    //the rounded search skips the list of the request itself, which could still hold a big enough chunk.
+    //only its head is tried so that the search stays O(1), a list spans 1/HEAP_SL_COUNT of its size anyway
+    heapPrvMapping(sz, &fl, &sl);
+    node = gHeapFreeLists[fl][sl];
+    if (node && node->size >= sz)
+        return node;
+
+    return NULL;
+}
+
+//put a used chunk to the lists, merging it with free neighbours. only call with lock held please
+static struct HeapNode* heapPrvFreeChunk(struct HeapNode* node)
+{
+    struct HeapNode *prev = node->prev, *next;
+
+    gHeapStats.usedBytes -= node->size + HEAP_NODE_SIZE;
+    gHeapStats.freeCount++;
+
+    if (prev && heapPrvIsListed(prev)) {
+        heapPrvRemoveFree(prev);
+        prev->size += HEAP_NODE_SIZE + node->size;
+        if (gHeapTail == node)
+            gHeapTail = prev;
+        node = prev;
+    }
+
+    next = heapPrvGetNext(node);
+    if (next && heapPrvIsListed(next)) {
+        heapPrvRemoveFree(next);
+        node->size += HEAP_NODE_SIZE + next->size;
+        if (gHeapTail == next)
+            gHeapTail = node;
+    }
+
+    if ((next = heapPrvGetNext(node)))
+        next->prev = node;
+
+    heapPrvInsertFree(node);
+
+    return node;
+}
+
+//called to free chunks in case free() was unable to last time it tried. only call with lock held please
+static void heapMergeFreeChunks(void)
+{
+    while (atomicXchgByte(&gNeedFreeMerge, false)) {
+        struct HeapNode *node;
+
+        for (node = gHeapHead; node; node = heapPrvGetNext(node)) {
+            if (!node->used && node->tidx == HEAP_TIDX_DEFERRED) {
+                node->used = 1;
+                node = heapPrvFreeChunk(node);
+            }
+        }
+    }
+}
+
 bool heapInit(void)
 {
     uint32_t size = REAL_HEAP_SIZE;
@@ -93,7 +285,7 @@ bool heapInit(void)
 
     node = gHeapHead = (struct HeapNode*)ALIGNED_HEAP_START;
 
-    if (size < sizeof(struct HeapNode))
+    if (size < HEAP_NODE_SIZE + HEAP_MIN_DATA_SIZE || size - HEAP_NODE_SIZE >= (1UL << MAX_HEAP_ORDER))
     {
         HEAP_ASSERT(0);
         return false;
@@ -101,9 +293,15 @@ bool heapInit(void)
 
     gHeapTail = node;
 
-    node->used = 0;
+    gHeapFlBitmap = 0;
+    memset(gHeapSlBitmap, 0, sizeof(gHeapSlBitmap));
+    memset(gHeapFreeLists, 0, sizeof(gHeapFreeLists));
+    memset(&gHeapStats, 0, sizeof(gHeapStats));
+    gHeapStats.totalSize = size;
+
     node->prev = NULL;
-    node->size = size - sizeof(struct HeapNode);
+    node->size = size - HEAP_NODE_SIZE;
+    heapPrvInsertFree(node);
 
 #if defined(HEAP_DEBUG)
     heapHistoryInit();
@@ -119,30 +317,6 @@ void heapShowStatus(void)
 }
 #endif
 
-//called to merge free chunks in case free() was unable to last time it tried. only call with lock held please
-static void heapMergeFreeChunks(void)
-{
-    while (atomicXchgByte(&gNeedFreeMerge, false)) {
-        struct HeapNode *node = gHeapHead, *next;
-
-        while (node) {
-            next = heapPrvGetNext(node);
-
-            if (!node->used && next && !next->used) { /* merged */
-                node->size += sizeof(struct HeapNode) + next->size;
-
-                next = heapPrvGetNext(node);
-                if (next)
-                    next->prev = node;
-                else
-                    gHeapTail = node;
-            }
-            else
-                node = next;
-        }
-    }
-}
-
 #if defined(HEAP_DEBUG)
 void* __heapAlloc(uint32_t sz, const char* fn, int line)
 #else
@@ -161,32 +335,28 @@ void* heapAlloc(uint32_t sz)
         return NULL;
     }
 
-    /* merge free chunks to help better use space */
+    /* put chunks freed without the lock to the lists */
     heapMergeFreeChunks();
 
     sz = (sz + 3) &~ 3;
-    node = gHeapHead;
+    if (sz < HEAP_MIN_DATA_SIZE)
+        sz = HEAP_MIN_DATA_SIZE;
 
-    while (node) {
-        if (!node->used && node->size >= sz && (!best || best->size > node->size)) {
-            best = node;
-            if (best->size == sz)
-                break;
-        }
+    if (sz < (1UL << MAX_HEAP_ORDER))
+        best = heapPrvFindFree(sz);
 
-        node = heapPrvGetNext(node);
+    if (!best) { //alloc failed
+        gHeapStats.failCount++;
+        goto out;
     }
 
-    if (!best) //alloc failed
-        goto out;
+    heapPrvRemoveFree(best);
 
-    if (best->size - sz > sizeof(struct HeapNode)) {        //there is a point to split up the chunk
+    if (best->size - sz >= HEAP_NODE_SIZE + HEAP_MIN_DATA_SIZE) {        //there is a point to split up the chunk
 
         node = (struct HeapNode*)(best->data + sz);
 
-        node->used = 0;
-        node->tidx = 0;
-        node->size = best->size - sz - sizeof(struct HeapNode);
+        node->size = best->size - sz - HEAP_NODE_SIZE;
         node->prev = best;
 
         if (best != gHeapTail)
@@ -195,12 +365,20 @@ void* heapAlloc(uint32_t sz)
             gHeapTail = node;
 
         best->size = sz;
+
+        //neighbours of a free chunk are always used, so the rest doesn't need to be merged
+        heapPrvInsertFree(node);
     }
 
     best->used = 1;
     best->tidx = osGetCurrentTid();
     ret = best->data;
 
+    gHeapStats.allocCount++;
+    gHeapStats.usedBytes += best->size + HEAP_NODE_SIZE;
+    if (gHeapStats.peakUsedBytes < gHeapStats.usedBytes)
+        gHeapStats.peakUsedBytes = gHeapStats.usedBytes;
+
 out:
     trylockRelease(&gHeapLock);
     __enable_irq();
@@ -220,7 +398,7 @@ out:
 
 void heapFree(void* ptr)
 {
-    struct HeapNode *node, *t;
+    struct HeapNode *node;
     bool haveLock;
 
     if (ptr == NULL) {
@@ -233,28 +411,20 @@ void heapFree(void* ptr)
     __disable_irq();
     haveLock = trylockTryTake(&gHeapLock);
 
-    node = ((struct HeapNode*)ptr) - 1;
-    node->used = 0;
-    node->tidx = 0;
+    node = (struct HeapNode*)((uint8_t*)ptr - HEAP_NODE_SIZE);
 
     if (haveLock) {
-
-        while (node->prev && !node->prev->used)
-            node = node->prev;
-
-        while ((t = heapPrvGetNext(node)) && !t->used) {
-            node->size += sizeof(struct HeapNode) + t->size;
-            if (gHeapTail == t)
-                gHeapTail = node;
-        }
-
-        if ((t = heapPrvGetNext(node)))
-            t->prev = node;
+        heapMergeFreeChunks();
+        heapPrvFreeChunk(node);
 
         trylockRelease(&gHeapLock);
     }
-    else
+    else {
+        //the chunk is put to the lists by the next one taking the lock
+        node->used = 0;
+        node->tidx = HEAP_TIDX_DEFERRED;
         gNeedFreeMerge = true;
+    }
 
     __enable_irq();
 
@@ -285,18 +455,19 @@ int heapFreeAll(uint32_t tid)
         return -1;
     }
 
+    heapMergeFreeChunks();
+
     tid &= TIDX_MASK;
     for (node = gHeapHead; node; node = heapPrvGetNext(node)) {
-        if (node->tidx == tid) {
-            node->used = 0;
-            node->tidx = 0;
-            count++;
+        if (node->used && node->tidx == tid) {
 #if defined(HEAP_DEBUG)
             heapHistoryPop(node->data);
 #endif
+            //the merged chunk is followed by a used one, so walking on from it skips nothing
+            node = heapPrvFreeChunk(node);
+            count++;
         }
     }
-    gNeedFreeMerge = count > 0;
     trylockRelease(&gHeapLock);
     __enable_irq();
 
@@ -322,7 +493,7 @@ int heapGetFreeSize(int *numChunks, int *largestChunk)
         if (!node->used) {
             if (node->size > *largestChunk)
                 *largestChunk = node->size;
-            bytes += node->size + sizeof(struct HeapNode);
+            bytes += node->size + HEAP_NODE_SIZE;
             (*numChunks)++;
         }
     }
@@ -349,7 +520,7 @@ int heapGetTaskSize(uint32_t tid)
     tid &= TIDX_MASK;
     for (node = gHeapHead; node; node = heapPrvGetNext(node)) {
         if (node->used && node->tidx == tid) {
-            bytes += node->size + sizeof(struct HeapNode);
+            bytes += node->size + HEAP_NODE_SIZE;
         }
     }
     trylockRelease(&gHeapLock);
@@ -357,3 +528,41 @@ int heapGetTaskSize(uint32_t tid)
 
     return bytes;
 }
+
+bool heapGetStats(struct HeapStats *stats)
+{
+    struct HeapNode *node;
+    bool haveLock;
+
+    __disable_irq();
+    // this can only fail if called from interrupt
+    haveLock = trylockTryTake(&gHeapLock);
+    if (!haveLock) {
+        __enable_irq();
+        return false;
+    }
+
+    *stats = gHeapStats;
+    stats->freeBytes = 0;
+    stats->numFreeChunks = 0;
+    stats->largestFreeChunk = 0;
+
+    for (node = gHeapHead; node; node = heapPrvGetNext(node)) {
+        if (!node->used) {
+            if (node->size > stats->largestFreeChunk)
+                stats->largestFreeChunk = node->size;
+            stats->freeBytes += node->size + HEAP_NODE_SIZE;
+            stats->numFreeChunks++;
+        }
+    }
+    trylockRelease(&gHeapLock);
+    __enable_irq();
+
+    //share of free memory that is not in the largest chunk
+    if (stats->freeBytes)
+        stats->fragmentation = 100 - (uint32_t)((uint64_t)(stats->largestFreeChunk + HEAP_NODE_SIZE) * 100 / stats->freeBytes);
+    else
+        stats->fragmentation = 0;
+
+    return true;
+}
@@ -71,6 +71,9 @@ enum ConfigCmds
     CONFIG_CMD_SELF_TEST    = 5,
 };
 
+// struct ConfigCmd flags
+#define CONFIG_FLAGS_COMPACT_SAMPLES    0x0001  // AP decodes HOST_EVT_COMPACT_SENSOR_DATA blocks
+
 struct ConfigCmd
 {
     uint64_t latency;
@@ -104,7 +107,8 @@ struct ActiveSensor
     uint8_t oneshot : 1;
     uint8_t discard : 1;
     uint8_t raw : 1;
-    uint8_t reserved : 5;
+    uint8_t compact : 1;
+    uint8_t reserved : 4;
 } __attribute__((packed));
 
 static uint8_t mSensorList[SENS_TYPE_LAST_USER];
@@ -547,9 +551,22 @@ static void resetBuffer(struct ActiveSensor *sensor)
 {
     sensor->discard = true;
     sensor->buffer.length = 0;
+    sensor->buffer.dataType = HOSTINTF_SENSOR_DATA_FORMAT_DEFAULT;
     memset(&sensor->buffer.firstSample, 0x00, sizeof(struct SensorFirstSample));
 }
 
+// Re-encode a full block of float triple samples in the compact format, right
+// before it leaves the sensor, if the AP asked for it.
+static void compactTripleSamples(struct ActiveSensor *sensor)
+{
+    // raw sensors only send float triples for bias reports
+    if (!sensor->compact || sensor->numAxis != NUM_AXIS_THREE ||
+        (sensor->raw && sensor->buffer.sensType != sensor->biasReportType))
+        return;
+
+    hostIntfCompactTripleSamples(&sensor->buffer);
+}
+
 void hostIntfSetBusy(bool busy)
 {
     mBusy = busy;
@@ -606,6 +623,7 @@ bool hostIntfPacketDequeue(void *data, uint32_t *wakeup, uint32_t *nonwakeup)
             }
 
             if (sensor->buffer.length > 0) {
+                compactTripleSamples(sensor);
                 memcpy(buffer, &sensor->buffer, sizeof(struct HostIntfDataBuffer));
                 resetBuffer(sensor);
                 ret = true;
@@ -856,8 +874,11 @@ static uint32_t encodeDeltaTime(uint64_t time)
 
 static bool enqueueSensorBuffer(struct ActiveSensor *sensor)
 {
-    bool queued = simpleQueueEnqueue(mOutputQ, &sensor->buffer,
-                                     sizeof(uint32_t) + sensor->buffer.length, sensor->discard);
+    bool queued;
+
+    compactTripleSamples(sensor);
+    queued = simpleQueueEnqueue(mOutputQ, &sensor->buffer,
+                                sizeof(uint32_t) + sensor->buffer.length, sensor->discard);
 
     if (!queued) {
         // undo counters if failed to add buffer
@@ -1331,6 +1352,8 @@ static void onConfigCmdFlushOne(struct ActiveSensor *sensor, struct ConfigCmd *c
 
 static void onConfigCmdEnableOne(struct ActiveSensor *sensor, struct ConfigCmd *cmd)
 {
+    sensor->compact = !!(cmd->flags & CONFIG_FLAGS_COMPACT_SAMPLES);
+
     if (sensorRequestRateChange(mHostIntfTid, sensor->sensorHandle, cmd->rate, cmd->latency)) {
         sensor->rate = cmd->rate;
         if (sensor->latency != cmd->latency) {
@@ -1350,6 +1373,8 @@ static void onConfigCmdEnableOne(struct ActiveSensor *sensor, struct ConfigCmd *
 
 static void onConfigCmdEnableAll(struct ActiveSensor *sensor, struct ConfigCmd *cmd)
 {
+    sensor->compact = !!(cmd->flags & CONFIG_FLAGS_COMPACT_SAMPLES);
+
     for (uint32_t i = 0; sensorFind(cmd->sensType, i, &sensor->sensorHandle) != NULL; i++) {
         if (cmd->rate == SENSOR_RATE_ONESHOT) {
             cmd->rate = SENSOR_RATE_ONCHANGE;
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <hostIntf.h>
+
+// fixed point precision of compact samples, relative to the largest value of a block
+#define COMPACT_SAMPLE_PRECISION_BITS   16
+
+static inline int32_t floatToInt32(float val)
+{
+    if (val >= 0.0f)
+        return val + 0.5f;
+    else
+        return val - 0.5f;
+}
+
+static inline uint8_t *putVarint(uint8_t *p, const uint8_t *end, uint32_t val)
+{
+    do {
+        if (p == end)
+            return NULL;
+        *p++ = (val & 0x7F) | (val > 0x7F ? 0x80 : 0x00);
+        val >>= 7;
+    } while (val);
+
+    return p;
+}
+
+static inline uint32_t zigzag32(int32_t val)
+{
+    return ((uint32_t)val << 1) ^ (uint32_t)(val >> 31);
+}
+
+bool hostIntfCompactTripleSamples(struct HostIntfDataBuffer *buf)
+{
+    uint8_t data[HOSTINTF_SENSOR_DATA_MAX - sizeof(struct CompactTripleAxisHeader)];
+    uint8_t *p = data;
+    const uint8_t *end = data + sizeof(data);
+    uint32_t numSamples = buf->firstSample.numSamples;
+    uint32_t i, j, bits, maxBits = 0;
+    uint32_t prevDelta = 0;
+    int32_t q, prev[3] = { 0, 0, 0 };
+    int32_t scaleExp;
+    union {
+        uint32_t bits;
+        float val;
+    } scale;
+
+    if (!numSamples || buf->dataType != HOSTINTF_SENSOR_DATA_FORMAT_DEFAULT)
+        return false;
+
+    // largest magnitude of the block, straight from the float exponents
+    for (i = 0; i < numSamples; i++) {
+        uint32_t axis[3] = { buf->triple[i].ix, buf->triple[i].iy, buf->triple[i].iz };
+
+        for (j = 0; j < 3; j++) {
+            bits = axis[j] & 0x7FFFFFFF;
+            if (bits >= 0x7F800000)
+                return false; // inf or nan
+            if (bits > maxBits)
+                maxBits = bits;
+        }
+    }
+
+    // |value| < 2^(exponent + 1), so |q| <= 2^COMPACT_SAMPLE_PRECISION_BITS
+    scaleExp = (int32_t)(maxBits >> 23) - 127 + 1 - COMPACT_SAMPLE_PRECISION_BITS;
+    if (scaleExp < -127)
+        scaleExp = -127;
+    scale.bits = (uint32_t)(127 - scaleExp) << 23;
+
+    for (i = 0; i < numSamples && p; i++) {
+        float axis[3] = { buf->triple[i].x, buf->triple[i].y, buf->triple[i].z };
+
+        if (i > 0) {
+            p = putVarint(p, end, zigzag32((int32_t)(buf->triple[i].deltaTime - prevDelta)));
+            prevDelta = buf->triple[i].deltaTime;
+        }
+        for (j = 0; j < 3 && p; j++) {
+            q = floatToInt32(axis[j] * scale.val);
+            p = putVarint(p, end, zigzag32(q - prev[j]));
+            prev[j] = q;
+        }
+    }
+
+    if (!p || sizeof(uint64_t) + sizeof(struct CompactTripleAxisHeader) + (p - data) >= buf->length)
+        return false;
+
+    buf->compact.scaleExp = scaleExp;
+    buf->compact.dataLength = p - data;
+    memcpy(&buf->compact + 1, data, p - data);
+    buf->length = sizeof(uint64_t) + sizeof(struct CompactTripleAxisHeader) + (p - data);
+    buf->dataType = HOSTINTF_SENSOR_DATA_FORMAT_COMPACT;
+
+    return true;
+}
@@ -124,6 +124,7 @@ static struct ApHubSync mTimeSync;
 
 static inline bool isSensorEvent(uint32_t evtType)
 {
+    evtType &= ~HOST_EVT_COMPACT_SENSOR_DATA;
     return evtType > EVT_NO_FIRST_SENSOR_EVENT && evtType <= EVT_NO_FIRST_SENSOR_EVENT + SENS_TYPE_LAST_USER;
 }
 
@@ -825,7 +826,10 @@ static int fillBuffer(void *tx, uint32_t totLength, uint32_t *wakeup, uint32_t *
                 break;
             }
         } else {
-            packet->evtType = htole32(EVT_NO_FIRST_SENSOR_EVENT + packet->sensType);
+            if (packet->dataType == HOSTINTF_SENSOR_DATA_FORMAT_COMPACT)
+                packet->evtType = htole32((EVT_NO_FIRST_SENSOR_EVENT + packet->sensType) | HOST_EVT_COMPACT_SENSOR_DATA);
+            else
+                packet->evtType = htole32(EVT_NO_FIRST_SENSOR_EVENT + packet->sensType);
             if (packet->referenceTime)
                 packet->referenceTime += getAvgDelta(&mTimeSync);
 
@@ -44,6 +44,7 @@ struct Timer {
     uint64_t      period;  /* 0 for oneshot */
     uint8_t       id;      /* 0 for disabled */
     uint8_t       useRtc;  /* 1 for rtc, 0 for tim */
+    uint8_t       heapPos; /* position in the heap of its clock while armed */
     uint16_t      tid;     /* we need TID always, for system management */
     uint32_t      jitterPpm;
     uint32_t      driftPpm;
@@ -52,11 +53,26 @@ struct Timer {
 };
 
 
+/* armed timers of one clock, as a binary min-heap of mTimers indices keyed by expiry */
+struct TimerHeap {
+    uint8_t       count;
+    uint8_t       idx[MAX_TIMERS];
+};
+
 ATOMIC_BITSET_DECL(mTimersValid, MAX_TIMERS, static);
 static struct SlabAllocator *mInternalEvents;
 static struct Timer mTimers[MAX_TIMERS];
 static volatile uint32_t mNextTimerId = 0;
 
+/* all below is only touched with interrupts off */
+static struct TimerHeap mTimHeap;
+static struct TimerHeap mRtcHeap;
+static uint8_t mTimerIdMap[MAX_TIMER_ID + 1]; /* timer id -> index in mTimers + 1, may be stale */
+
+/* bounds over all armed timers; only recalculated when a timer holding one of them goes away */
+static uint32_t mMaxJitter, mMaxDrift, mMaxErrTotal;
+static bool mMaxErrStale;
+
 uint64_t timGetTime(void)
 {
     return platGetTicks();
@@ -74,13 +90,152 @@ static struct Timer *timFindTimerById(uint32_t timId) /* no locks taken. be care
 {
     uint32_t i;
 
-    for (i = 0; i < MAX_TIMERS; i++)
-        if (mTimers[i].id == timId)
-            return mTimers + i;
+    if (!timId || timId > MAX_TIMER_ID)
+        return NULL;
+
+    i = mTimerIdMap[timId];
+    if (i && mTimers[i - 1].id == timId)
+        return mTimers + i - 1;
+
+    return NULL;
+}
+
+static inline struct TimerHeap *timGetHeap(const struct Timer *tim)
+{
+    return tim->useRtc ? &mRtcHeap : &mTimHeap;
+}
+
+static inline void timHeapPut(struct TimerHeap *heap, uint32_t pos, uint8_t idx)
+{
+    heap->idx[pos] = idx;
+    mTimers[idx].heapPos = pos;
+}
+
+static void timHeapSiftUp(struct TimerHeap *heap, uint32_t pos)
+{
+    uint8_t idx = heap->idx[pos];
+    uint64_t expires = mTimers[idx].expires;
+    uint32_t parent;
+
+    while (pos) {
+        parent = (pos - 1) / 2;
+        if (mTimers[heap->idx[parent]].expires <= expires)
+            break;
+        timHeapPut(heap, pos, heap->idx[parent]);
+        pos = parent;
+    }
+    timHeapPut(heap, pos, idx);
+}
+
+static void timHeapSiftDown(struct TimerHeap *heap, uint32_t pos)
+{
+    uint8_t idx = heap->idx[pos];
+    uint64_t expires = mTimers[idx].expires;
+    uint32_t child;
+
+    while ((child = 2 * pos + 1) < heap->count) {
+        if (child + 1 < heap->count && mTimers[heap->idx[child + 1]].expires < mTimers[heap->idx[child]].expires)
+            child++;
+        if (mTimers[heap->idx[child]].expires >= expires)
+            break;
+        timHeapPut(heap, pos, heap->idx[child]);
+        pos = child;
+    }
+    timHeapPut(heap, pos, idx);
+}
+
+static void timHeapInsert(struct Timer *tim)
+{
+    struct TimerHeap *heap = timGetHeap(tim);
+    uint32_t pos = heap->count++;
+
+    timHeapPut(heap, pos, tim - mTimers);
+    timHeapSiftUp(heap, pos);
+
+    if (tim->jitterPpm > mMaxJitter)
+        mMaxJitter = tim->jitterPpm;
+    if (tim->driftPpm > mMaxDrift)
+        mMaxDrift = tim->driftPpm;
+    if (tim->driftPpm + tim->jitterPpm > mMaxErrTotal)
+        mMaxErrTotal = tim->driftPpm + tim->jitterPpm;
+}
+
+static void timHeapRemove(struct Timer *tim)
+{
+    struct TimerHeap *heap = timGetHeap(tim);
+    uint32_t pos = tim->heapPos;
+    uint32_t last = --heap->count;
+    uint8_t idx;
+
+    if (pos != last) {
+        idx = heap->idx[last];
+        timHeapPut(heap, pos, idx);
+        if (pos && mTimers[idx].expires < mTimers[heap->idx[(pos - 1) / 2]].expires)
+            timHeapSiftUp(heap, pos);
+        else
+            timHeapSiftDown(heap, pos);
+    }
+
+    if (tim->jitterPpm >= mMaxJitter || tim->driftPpm >= mMaxDrift || tim->driftPpm + tim->jitterPpm >= mMaxErrTotal)
+        mMaxErrStale = true;
+}
+
+static void timUpdateMaxErr(void)
+{
+    struct TimerHeap *heaps[] = { &mTimHeap, &mRtcHeap };
+    struct Timer *tim;
+    uint32_t i, j;
+
+    mMaxJitter = mMaxDrift = mMaxErrTotal = 0;
+    for (i = 0; i < ARRAY_SIZE(heaps); i++) {
+        for (j = 0; j < heaps[i]->count; j++) {
+            tim = mTimers + heaps[i]->idx[j];
+            if (tim->jitterPpm > mMaxJitter)
+                mMaxJitter = tim->jitterPpm;
+            if (tim->driftPpm > mMaxDrift)
+                mMaxDrift = tim->driftPpm;
+            if (tim->driftPpm + tim->jitterPpm > mMaxErrTotal)
+                mMaxErrTotal = tim->driftPpm + tim->jitterPpm;
+        }
+    }
+    mMaxErrStale = false;
+}
+
+static struct Timer *timGetExpired(void)
+{
+    struct Timer *tim;
+
+    if (mTimHeap.count) {
+        tim = mTimers + mTimHeap.idx[0];
+        if (tim->expires <= timGetTime())
+            return tim;
+    }
+    if (mRtcHeap.count) {
+        tim = mTimers + mRtcHeap.idx[0];
+        if (tim->expires <= rtcGetTime())
+            return tim;
+    }
 
     return NULL;
 }
 
+static uint64_t timGetNextExpiry(void)
+{
+    uint64_t nextTimer = 0, expires;
+    struct Timer *tim;
+
+    if (mTimHeap.count)
+        nextTimer = mTimers[mTimHeap.idx[0]].expires;
+    if (mRtcHeap.count) {
+        tim = mTimers + mRtcHeap.idx[0];
+        expires = tim->expires - rtcGetTime() + timGetTime();
+        if (!nextTimer || nextTimer > expires)
+            nextTimer = expires;
+    }
+
+    return nextTimer;
+}
+
 static void timerCallFuncFreeF(void* event)
 {
     slabAllocatorFree(mInternalEvents, event);
@@ -114,10 +269,8 @@ static void timCallFunc(struct Timer *tim)
 
 static bool timFireAsNeededAndUpdateAlarms(void)
 {
-    uint32_t maxDrift = 0, maxJitter = 0, maxErrTotal = 0;
     bool somethingDone, totalSomethingDone = false;
-    uint64_t nextTimer, expires;
-    uint32_t i;
+    uint64_t nextTimer;
     struct Timer *tim;
 
     // protect from concurrent execution [timIntHandler() and timTimerSetEx()]
@@ -126,43 +279,30 @@ static bool timFireAsNeededAndUpdateAlarms(void)
 
     do {
         somethingDone = false;
-        nextTimer = 0;
-
-        for (i = 0, tim = &mTimers[0]; i < MAX_TIMERS; i++, tim++) {
-            if (!tim->id)
-                continue;
-
-            if ((!tim->useRtc && tim->expires <= timGetTime()) || (tim->useRtc && tim->expires <= rtcGetTime())) {
-                somethingDone = true;
-                if (tim->period) {
-                    tim->expires += tim->period;
-                    timCallFunc(tim);
-                } else {
-                    timCallFunc(tim);
-                    tim->id = 0;
-                    atomicBitsetClearBit(mTimersValid, i);
-                }
-            }
-            else {
-                if (tim->jitterPpm > maxJitter)
-                    maxJitter = tim->jitterPpm;
-                if (tim->driftPpm > maxDrift)
-                    maxDrift = tim->driftPpm;
-                if (tim->driftPpm + tim->jitterPpm > maxErrTotal)
-                    maxErrTotal = tim->driftPpm + tim->jitterPpm;
-                if (tim->useRtc)
-                    expires = tim->expires - rtcGetTime() + timGetTime();
-                else
-                    expires = tim->expires;
-                if (!nextTimer || nextTimer > expires)
-                    nextTimer = expires;
+
+        // callbacks may set or cancel timers, so always look at the current heap heads
+        while ((tim = timGetExpired()) != NULL) {
+            somethingDone = true;
+            if (tim->period) {
+                tim->expires += tim->period;
+                timHeapSiftDown(timGetHeap(tim), tim->heapPos);
+                timCallFunc(tim);
+            } else {
+                timHeapRemove(tim);
+                timCallFunc(tim);
+                tim->id = 0;
+                atomicBitsetClearBit(mTimersValid, tim - mTimers);
             }
         }
 
+        if (mMaxErrStale)
+            timUpdateMaxErr();
+        nextTimer = timGetNextExpiry();
+
         totalSomethingDone = totalSomethingDone || somethingDone;
 
     //we loop while loop does something, or while (if next timer exists), it is due by the time loop ends, or platform code fails to set an alarm to wake us for it
-    } while (somethingDone || (nextTimer && (timGetTime() >= nextTimer || !platSleepClockRequest(nextTimer, maxJitter, maxDrift, maxErrTotal))));
+    } while (somethingDone || (nextTimer && (timGetTime() >= nextTimer || !platSleepClockRequest(nextTimer, mMaxJitter, mMaxDrift, mMaxErrTotal))));
 
     if (!nextTimer)
         platSleepClockRequest(0, 0, 0, 0);
@@ -179,6 +319,7 @@ static uint32_t timTimerSetEx(uint64_t length, uint32_t jitterPpm, uint32_t drif
     int32_t idx = atomicBitsetFindClearAndSet(mTimersValid);
     struct Timer *t;
     uint16_t timId;
+    uint64_t intState;
 
     if (idx < 0) /* no free timers */{
         ERROR_PRINT("no free timers\n");
@@ -202,7 +343,11 @@ static uint32_t timTimerSetEx(uint64_t length, uint32_t jitterPpm, uint32_t drif
     t->tid = osGetCurrentTid();
 
     /* as soon as we write timer Id, it becomes valid and might fire */
+    intState = cpuIntsOff();
     t->id = timId;
+    mTimerIdMap[timId] = idx + 1;
+    timHeapInsert(t);
+    cpuIntsRestore(intState);
 
     /* fire as needed & recalc alarms*/
     timFireAsNeededAndUpdateAlarms();
@@ -248,6 +393,7 @@ bool timTimerCancelEx(uint32_t timerId, bool cancelPending)
     if (t && t->tid == osGetCurrentTid()) {
         if (cancelPending)
             osRemovePendingEvents(timerEventMatch, t);
+        timHeapRemove(t);
         t->id = 0; /* this disables it */
     } else {
         t = NULL;
@@ -282,6 +428,8 @@ int timTimerCancelAll(uint32_t tid)
             continue;
         count++;
         osRemovePendingEvents(timerEventMatch, tim);
+        if (tim->id)
+            timHeapRemove(tim);
         tim->id = 0; /* this disables it */
         /* this frees struct */
         atomicBitsetClearBit(mTimersValid, tim - mTimers);
@@ -30,7 +30,8 @@ struct EvtQueue;
 
 typedef void (*EvtQueueForciblyDiscardEvtCbkF)(uint32_t evtType, void *evtData, TaggedPtr evtFreeData);
 
-//multi-producer, SINGLE consumer queue
+//multi-producer, SINGLE consumer queue. enqueue is lock-free and safe from any context without masking interrupts
+//evtQueueRemoveAllMatching and evtQueueFree must only be called from the consumer's context
 
 struct EvtQueue* evtQueueAlloc(uint32_t size, EvtQueueForciblyDiscardEvtCbkF forceDiscardCbk);
 void evtQueueFree(struct EvtQueue* q);
@@ -43,6 +43,8 @@
 
 // host-side events are 32-bit
 
+#define HOST_EVT_COMPACT_SENSOR_DATA     0x00010000    //set on EVT_NO_FIRST_SENSOR_EVENT + SENSOR_TYPE_x when samples are in struct CompactTripleAxisHeader format
+
 // DEBUG_LOG_EVT is normally undefined, or defined with a special value, recognized by nanohub driver: 0x3B474F4C
 // if defined with this value, the log message payload will appear in Linux kernel message log.
 // If defined with other value, it will still be sent to nanohub driver, and then forwarded to userland
@@ -24,6 +24,19 @@ extern "C" {
 #include <stdint.h>
 #include <stdbool.h>
 
+struct HeapStats {
+    uint32_t totalSize;
+    uint32_t usedBytes;       //used chunks including their headers
+    uint32_t peakUsedBytes;
+    uint32_t freeBytes;
+    uint32_t numFreeChunks;
+    uint32_t largestFreeChunk;
+    uint32_t fragmentation;   //percentage of free memory outside of the largest free chunk
+    uint32_t allocCount;
+    uint32_t freeCount;
+    uint32_t failCount;
+};
+
 bool heapInit(void);
 #if defined(HEAP_DEBUG)
 void* __heapAlloc(uint32_t sz, const char* fn, int line);
@@ -42,6 +55,7 @@ void heapFree(void* ptr);
 int heapFreeAll(uint32_t tid);
 int heapGetFreeSize(int *numChunks, int *largestChunk);
 int heapGetTaskSize(uint32_t tid);
+bool heapGetStats(struct HeapStats *stats);
 
 #ifdef __cplusplus
 }
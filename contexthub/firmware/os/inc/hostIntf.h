@@ -38,6 +38,30 @@ enum HostIntfDataType
     HOSTINTF_DATA_TYPE_DFS_TO_SENSOR_HAL,
 };
 
+// dataType of sensor blocks (sensType != SENS_TYPE_INVALID)
+enum HostIntfSensorDataFormat
+{
+    HOSTINTF_SENSOR_DATA_FORMAT_DEFAULT,
+    HOSTINTF_SENSOR_DATA_FORMAT_COMPACT,
+};
+
+/*
+ * Compact NUM_AXIS_THREE format, sent as HOST_EVT_COMPACT_SENSOR_DATA to an AP
+ * that enabled the sensor with CONFIG_FLAGS_COMPACT_SAMPLES.
+ * The header is followed by dataLength bytes of zigzag varints. Axis values are
+ * fixed point, value = q * 2^scaleExp, and sample 0 holds x, y, z as is. Every
+ * other sample holds the change of its encoded deltaTime to the previous one,
+ * then the change of x, y, z to the previous sample.
+ */
+SET_PACKED_STRUCT_MODE_ON
+struct CompactTripleAxisHeader
+{
+    struct SensorFirstSample firstSample;
+    int8_t scaleExp;
+    uint8_t dataLength;
+} ATTRIBUTE_PACKED;
+SET_PACKED_STRUCT_MODE_OFF
+
 SET_PACKED_STRUCT_MODE_ON
 struct HostIntfDataBuffer
 {
@@ -63,6 +87,7 @@ struct HostIntfDataBuffer
                 struct SingleAxisDataPoint single[HOSTINTF_SENSOR_DATA_MAX / sizeof(struct SingleAxisDataPoint)];
                 struct TripleAxisDataPoint triple[HOSTINTF_SENSOR_DATA_MAX / sizeof(struct TripleAxisDataPoint)];
                 struct RawTripleAxisDataPoint rawTriple[HOSTINTF_SENSOR_DATA_MAX / sizeof(struct RawTripleAxisDataPoint)];
+                struct CompactTripleAxisHeader compact;
             };
         };
         uint8_t buffer[sizeof(uint64_t) + HOSTINTF_SENSOR_DATA_MAX];
@@ -84,4 +109,11 @@ void hostIntfSetBusy(bool busy);
 void hostIntfRxPacket(bool wakeupActive);
 void hostIntfTxAck(void *buffer, uint8_t len);
 
+/*
+ * Re-encodes a block of NUM_AXIS_THREE float samples in place in the compact
+ * format. Returns false and keeps the block as is if it would not get smaller
+ * or holds inf or nan.
+ */
+bool hostIntfCompactTripleSamples(struct HostIntfDataBuffer *buf);
+
 #endif /* __HOSTINTF_H */
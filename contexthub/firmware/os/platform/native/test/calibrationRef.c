@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The diversity checker and the Levenberg-Marquardt solver as they were before their per-sample
+ * and normal equation loops were specialised, renamed so that calibration_test can run them next
+ * to the current ones. The sources in ref/ are plain copies of the old ones, keep them unchanged.
+ */
+
+#define diversityCheckerInit                refDiversityCheckerInit
+#define diversityCheckerReset               refDiversityCheckerReset
+#define diversityCheckerFindNearestPoint    refDiversityCheckerFindNearestPoint
+#define diversityCheckerUpdate              refDiversityCheckerUpdate
+#define diversityCheckerNormQuality         refDiversityCheckerNormQuality
+#define diversityCheckerLocalFieldUpdate    refDiversityCheckerLocalFieldUpdate
+
+#define lmSolverInit                        refLmSolverInit
+#define lmSolverDestroy                     refLmSolverDestroy
+#define lmSolverSetData                     refLmSolverSetData
+#define lmSolverSolve                       refLmSolverSolve
+#define computeGainRatio                    refComputeGainRatio
+
+#include "ref/diversity_checker.c"
+#include "ref/levenberg_marquardt.c"
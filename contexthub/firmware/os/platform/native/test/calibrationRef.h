@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _TEST_CALIBRATION_REF_H_
+#define _TEST_CALIBRATION_REF_H_
+
+#include <calibration/diversity_checker/diversity_checker.h>
+#include <common/math/levenberg_marquardt.h>
+
+void refDiversityCheckerInit(struct DiversityChecker *diverse_data,
+                             const struct DiversityCheckerParameters *parameters);
+void refDiversityCheckerReset(struct DiversityChecker *diverse_data);
+void refDiversityCheckerUpdate(struct DiversityChecker *diverse_data, float x, float y, float z);
+
+void refLmSolverInit(struct LmSolver *solver, const struct LmParams *params, ResidualAndJacobianFunction func);
+void refLmSolverSetData(struct LmSolver *solver, struct LmData *data);
+enum LmStatus refLmSolverSolve(struct LmSolver *solver, const float *initial_state, void *f_data,
+                               size_t state_dim, size_t meas_dim, float *state);
+
+#endif
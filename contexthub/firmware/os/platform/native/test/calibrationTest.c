@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The calibration kernels against the code they replaced (ref/), on synthetic magnetometer data:
+ * the diversity checker the mag calibration runs on every sample, fed by a turning device at
+ * 100Hz, and the Levenberg-Marquardt solver of the 9 parameter sphere fit, on batches of points
+ * on a skewed, offset sphere. Built without fused multiply-add the checker state and the fitted
+ * state have to be bit-identical, and the fit has to find the offset it was given. The cost per
+ * mag sample and per sphere fit of both is reported.
+ *
+ * usage: calibration_test [seconds] [fits] [seed]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <calibration/sphere_fit/sphere_fit_calibration.h>
+#include "calibrationRef.h"
+#include "testStubs.h"
+
+#define TEST_DEFAULT_SECONDS    600
+#define TEST_DEFAULT_FITS       2000
+#define TEST_RATE               100
+#define TEST_BATCH_SAMPLES      (3 * TEST_RATE)     //mag_cal resets the checker with every batch
+#define TEST_FIELD              48.0f               //uT
+#define TEST_NOISE              0.5f                //uT
+#define TEST_FIT_POINTS         MAX_LM_MEAS_DIMENSION
+#define TEST_MAX_OFFSET_ERROR   1.0f                //uT
+
+static const struct DiversityCheckerParameters mDiversityParams = {
+    .var_threshold = 6.0f,
+    .max_min_threshold = 10.0f,
+    .local_field = TEST_FIELD,
+    .threshold_tuning_param = 0.5f,
+    .max_distance_tuning_param = 2.552f,
+    .min_num_diverse_vectors = 8,
+    .max_num_max_distance = 1,
+};
+
+static const struct LmParams mLmParams = {
+    .max_iterations = 30,
+    .initial_u_scale = 1.0e-4f,
+    .gradient_threshold = 1.0e-16f,
+    .relative_step_threshold = 1.0e-7f,
+};
+
+static const float mOffset[3] = { 12.0f, -7.0f, 20.0f };
+
+static float *mMag;
+static uint32_t mNumSamples;
+static uint32_t mSeed;
+
+static float testRandFloat(float max)
+{
+    mSeed = mSeed * 1103515245 + 12345;
+    return max * (((float)(mSeed >> 8) / (float)(1 << 24)) * 2.0f - 1.0f);
+}
+
+//the field turning in device frame, with the hard iron offset and noise
+static void testMakeSamples(uint32_t seconds)
+{
+    uint32_t i;
+
+    mNumSamples = seconds * TEST_RATE;
+    mMag = malloc(sizeof(float) * 3 * mNumSamples);
+
+    for (i = 0; i < mNumSamples; i++) {
+        double t = (double)i / TEST_RATE;
+        double theta = 2.1 * t + 0.5 * sin(0.13 * t), phi = 3.7 * t;
+
+        mMag[i * 3 + 0] = TEST_FIELD * sin(theta) * cos(phi) + mOffset[0] + testRandFloat(TEST_NOISE);
+        mMag[i * 3 + 1] = TEST_FIELD * sin(theta) * sin(phi) + mOffset[1] + testRandFloat(TEST_NOISE);
+        mMag[i * 3 + 2] = TEST_FIELD * cos(theta) + mOffset[2] + testRandFloat(TEST_NOISE);
+    }
+}
+
+static void testDiversity(void)
+{
+    struct DiversityChecker checker, ref;
+    uint32_t i, diffStates = 0, points = 0, batches = 0;
+
+    memset(&checker, 0x00, sizeof(checker));
+    memset(&ref, 0x00, sizeof(ref));
+    diversityCheckerInit(&checker, &mDiversityParams);
+    refDiversityCheckerInit(&ref, &mDiversityParams);
+
+    for (i = 0; i < mNumSamples; i++) {
+        const float *m = &mMag[i * 3];
+
+        diversityCheckerUpdate(&checker, m[0], m[1], m[2]);
+        refDiversityCheckerUpdate(&ref, m[0], m[1], m[2]);
+        if (memcmp(&checker, &ref, sizeof(checker)))
+            diffStates++;
+
+        if (i % TEST_BATCH_SAMPLES == TEST_BATCH_SAMPLES - 1) {
+            points += checker.num_points;
+            batches++;
+            diversityCheckerReset(&checker);
+            refDiversityCheckerReset(&ref);
+        }
+    }
+
+#ifdef TEST_STRICT_FP
+    TEST_CHECK(diffStates == 0);
+#endif
+    TEST_CHECK(batches && points / batches >= mDiversityParams.min_num_diverse_vectors);
+
+    printf("diversity : %u of %u samples with a different state, %u points per batch\n", diffStates,
+            mNumSamples, batches ? points / batches : 0);
+}
+
+//points on the sphere of TEST_FIELD seen through the lower triangular scale matrix M and the offset
+static void testMakeFitData(float *data)
+{
+    static const float M[3][3] = { { 1.05f, 0, 0 }, { 0.02f, 0.97f, 0 }, { -0.01f, 0.03f, 1.02f } };
+    uint32_t i;
+
+    for (i = 0; i < TEST_FIT_POINTS; i++) {
+        float c[3], n, x0, x1, x2;
+
+        do {
+            c[0] = testRandFloat(1.0f);
+            c[1] = testRandFloat(1.0f);
+            c[2] = testRandFloat(1.0f);
+            n = sqrtf(c[0] * c[0] + c[1] * c[1] + c[2] * c[2]);
+        } while (n < 0.1f || n > 1.0f);
+
+        //M * (x - offset) = c, forward substitution
+        x0 = TEST_FIELD * c[0] / n / M[0][0];
+        x1 = (TEST_FIELD * c[1] / n - M[1][0] * x0) / M[1][1];
+        x2 = (TEST_FIELD * c[2] / n - M[2][0] * x0 - M[2][1] * x1) / M[2][2];
+        data[i * 3 + 0] = x0 + mOffset[0] + testRandFloat(TEST_NOISE);
+        data[i * 3 + 1] = x1 + mOffset[1] + testRandFloat(TEST_NOISE);
+        data[i * 3 + 2] = x2 + mOffset[2] + testRandFloat(TEST_NOISE);
+    }
+}
+
+//one fit from unit scale and the mean of the points as offset
+static enum LmStatus testFit(const float *data, bool ref, float *state, uint32_t *iterations)
+{
+    static struct LmData lmData;
+    struct LmSolver solver;
+    struct SphereFitData fitData = {
+        .fit_data = data,
+        .fit_data_std = NULL,
+        .num_fit_points = TEST_FIT_POINTS,
+        .expected_norm = TEST_FIELD,
+    };
+    float x0[SF_STATE_DIM];
+    enum LmStatus status;
+    uint32_t i, j;
+
+    memset(x0, 0x00, sizeof(x0));
+    x0[eParamScaleMatrix11] = x0[eParamScaleMatrix22] = x0[eParamScaleMatrix33] = 1.0f;
+    for (i = 0; i < TEST_FIT_POINTS; i++)
+        for (j = 0; j < 3; j++)
+            x0[eParamOffset1 + j] += data[i * 3 + j] / TEST_FIT_POINTS;
+
+    memset(&lmData, 0x00, sizeof(lmData));
+    if (ref) {
+        refLmSolverInit(&solver, &mLmParams, sphereFitResidAndJacobianFunc);
+        refLmSolverSetData(&solver, &lmData);
+        status = refLmSolverSolve(&solver, x0, &fitData, SF_STATE_DIM, TEST_FIT_POINTS, state);
+    } else {
+        lmSolverInit(&solver, &mLmParams, sphereFitResidAndJacobianFunc);
+        lmSolverSetData(&solver, &lmData);
+        status = lmSolverSolve(&solver, x0, &fitData, SF_STATE_DIM, TEST_FIT_POINTS, state);
+    }
+    *iterations = solver.num_iter;
+
+    return status;
+}
+
+static void testSphereFit(uint32_t fits)
+{
+    float data[TEST_FIT_POINTS * 3], state[SF_STATE_DIM], refState[SF_STATE_DIM];
+    uint32_t i, j, iterations, refIterations, diffStates = 0, totalIterations = 0;
+    float err, maxErr = 0.0f;
+    enum LmStatus status, refStatus;
+
+    for (i = 0; i < fits; i++) {
+        testMakeFitData(data);
+        status = testFit(data, false, state, &iterations);
+        refStatus = testFit(data, true, refState, &refIterations);
+        if (status != refStatus || iterations != refIterations || memcmp(state, refState, sizeof(state)))
+            diffStates++;
+        totalIterations += iterations;
+
+        TEST_CHECK(status != CHOLESKY_FAIL && status != INVALID_DATA_DIMENSIONS);
+        for (j = 0; j < 3; j++) {
+            err = fabsf(state[eParamOffset1 + j] - mOffset[j]);
+            if (err > maxErr)
+                maxErr = err;
+        }
+    }
+
+#ifdef TEST_STRICT_FP
+    TEST_CHECK(diffStates == 0);
+#endif
+    TEST_CHECK(maxErr <= TEST_MAX_OFFSET_ERROR);
+
+    printf("sphere fit: %u of %u fits with a different state, %u iterations per fit, offset error %.3f uT\n",
+            diffStates, fits, fits ? totalIterations / fits : 0, maxErr);
+}
+
+//ns per mag sample through the checker, and per sphere fit
+static void testBench(uint32_t fits, bool ref)
+{
+    struct DiversityChecker checker;
+    float data[TEST_FIT_POINTS * 3], state[SF_STATE_DIM];
+    uint64_t start, sampleNs, fitNs = 0;
+    uint32_t i, iterations;
+
+    memset(&checker, 0x00, sizeof(checker));
+    if (ref)
+        refDiversityCheckerInit(&checker, &mDiversityParams);
+    else
+        diversityCheckerInit(&checker, &mDiversityParams);
+
+    //the update is too short to time one by one, the resets go with it as they do in mag_cal
+    start = testGetTimeNs();
+    for (i = 0; i < mNumSamples; i++) {
+        const float *m = &mMag[i * 3];
+
+        if (ref)
+            refDiversityCheckerUpdate(&checker, m[0], m[1], m[2]);
+        else
+            diversityCheckerUpdate(&checker, m[0], m[1], m[2]);
+
+        if (i % TEST_BATCH_SAMPLES == TEST_BATCH_SAMPLES - 1) {
+            if (ref)
+                refDiversityCheckerReset(&checker);
+            else
+                diversityCheckerReset(&checker);
+        }
+    }
+    sampleNs = testGetTimeNs() - start;
+
+    mSeed = 1;
+    for (i = 0; i < fits; i++) {
+        testMakeFitData(data);
+        start = testGetTimeNs();
+        testFit(data, ref, state, &iterations);
+        fitNs += testGetTimeNs() - start;
+    }
+
+    printf("cost %-4s : diversity %llu ns per sample, sphere fit %llu ns\n", ref ? "old" : "new",
+            (unsigned long long)(sampleNs / mNumSamples), (unsigned long long)(fits ? fitNs / fits : 0));
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = (argc > 1) ? strtoul(argv[1], NULL, 0) : TEST_DEFAULT_SECONDS;
+    uint32_t fits = (argc > 2) ? strtoul(argv[2], NULL, 0) : TEST_DEFAULT_FITS;
+
+    mSeed = (argc > 3) ? strtoul(argv[3], NULL, 0) : 1;
+    if (seconds * TEST_RATE < TEST_BATCH_SAMPLES) {
+        printf("usage: %s [seconds(>= %u)] [fits] [seed]\n", argv[0], TEST_BATCH_SAMPLES / TEST_RATE);
+        return 1;
+    }
+
+    testMakeSamples(seconds);
+
+    testDiversity();
+    testSphereFit(fits);
+
+    testBench(fits, true);
+    testBench(fits, false);
+
+    free(mMag);
+
+    return testFinish("calibration_test");
+}
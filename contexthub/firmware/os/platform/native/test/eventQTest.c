@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The lock-free event queue of core/eventQ.c. The single thread part checks FIFO order, the
+ * urgent lane, the pool running out, stealing of discardable events and removal of matching
+ * ones. Then several producer threads enqueue against one consumer that also removes events
+ * now and then: every event has to be delivered or discarded exactly once, and the events of
+ * one producer have to come out in the order they went in. The enqueue cost is reported.
+ *
+ * usage: eventQ_test [events per producer] [producers]
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <heap.h>
+#include <eventQ.h>
+#include <platform.h>
+#include <timer.h>
+#include "testStubs.h"
+
+#define TEST_QUEUE_SIZE         64
+#define TEST_URGENT_LANE_SIZE   16
+#define TEST_DEFAULT_EVENTS     200000
+#define TEST_MAX_PRODUCERS      8
+#define TEST_REMOVE_EVERY       97
+
+#define TEST_EVT(producer, seq) ((void *)(uintptr_t)(((producer) << 24) | (seq)))
+#define TEST_EVT_PRODUCER(data) ((uint32_t)(uintptr_t)(data) >> 24)
+#define TEST_EVT_SEQ(data)      ((uint32_t)(uintptr_t)(data) & 0xFFFFFF)
+
+static struct EvtQueue *mQ;
+static volatile uint32_t mDiscarded;
+static uint32_t mProducerEvents;
+static uint64_t mEnqueueNs[TEST_MAX_PRODUCERS];
+
+/* the platform under the queue, the consumer never sleeps here */
+
+void platSleep(void)
+{
+}
+
+bool timIntHandler(void)
+{
+    return false;
+}
+
+uint64_t cpuIntsOff(void)
+{
+    return 0;
+}
+
+void cpuIntsRestore(uint64_t state)
+{
+}
+
+//only the consumer or a producer that steals calls this, the count is shared between them
+static void testDiscard(uint32_t evtType, void *evtData, TaggedPtr evtFreeData)
+{
+    __atomic_add_fetch(&mDiscarded, 1, __ATOMIC_RELAXED);
+}
+
+static bool testMatchSeq(uint32_t evtType, const void *data, void *context)
+{
+    return TEST_EVT_SEQ(data) % TEST_REMOVE_EVERY == 0;
+}
+
+static bool testMatchAll(uint32_t evtType, const void *data, void *context)
+{
+    return true;
+}
+
+static bool testDequeue(uint32_t *evtType, void **evtData)
+{
+    TaggedPtr evtFreeData;
+
+    return evtQueueDequeue(mQ, evtType, evtData, &evtFreeData, false);
+}
+
+static void testSingleThread(void)
+{
+    uint32_t evtType, i;
+    void *evtData;
+
+    mQ = evtQueueAlloc(TEST_QUEUE_SIZE, testDiscard);
+    TEST_CHECK(mQ != NULL);
+    TEST_CHECK(!testDequeue(&evtType, &evtData));
+
+    //fifo, with the urgent events ahead of everything else
+    for (i = 0; i < 8; i++)
+        TEST_CHECK(evtQueueEnqueue(mQ, 100 + i, TEST_EVT(0, i), 0, false));
+    TEST_CHECK(evtQueueEnqueue(mQ, 200, TEST_EVT(1, 0), 0, true));
+    TEST_CHECK(evtQueueEnqueue(mQ, 201, TEST_EVT(1, 1), 0, true));
+    TEST_CHECK(testDequeue(&evtType, &evtData) && evtType == 200);
+    TEST_CHECK(testDequeue(&evtType, &evtData) && evtType == 201);
+    for (i = 0; i < 8; i++)
+        TEST_CHECK(testDequeue(&evtType, &evtData) && evtType == 100 + i && evtData == TEST_EVT(0, i));
+    TEST_CHECK(!testDequeue(&evtType, &evtData));
+
+    //a full urgent lane only costs the event its priority
+    for (i = 0; i < TEST_URGENT_LANE_SIZE + 4; i++)
+        TEST_CHECK(evtQueueEnqueue(mQ, 300 + i, NULL, 0, true));
+    for (i = 0; i < TEST_URGENT_LANE_SIZE + 4; i++)
+        TEST_CHECK(testDequeue(&evtType, &evtData) && evtType == 300 + i);
+
+    //once the pool runs out, the oldest discardable event makes room for a new one
+    TEST_CHECK(evtQueueEnqueue(mQ, 400 | EVENT_TYPE_BIT_DISCARDABLE, NULL, 0, false));
+    for (i = 1; i < TEST_QUEUE_SIZE; i++)
+        TEST_CHECK(evtQueueEnqueue(mQ, 400 + i, NULL, 0, false));
+    TEST_CHECK(evtQueueEnqueue(mQ, 501, NULL, 0, false));
+    TEST_CHECK(mDiscarded == 1);
+    TEST_CHECK(!evtQueueEnqueue(mQ, 502 | EVENT_TYPE_BIT_DISCARDABLE, NULL, 0, false));
+    for (i = 1; i < TEST_QUEUE_SIZE; i++)
+        TEST_CHECK(testDequeue(&evtType, &evtData) && evtType == 400 + i);
+    TEST_CHECK(testDequeue(&evtType, &evtData) && evtType == 501);
+    TEST_CHECK(!testDequeue(&evtType, &evtData));
+
+    //removal leaves the others in order, also across the holes it leaves behind
+    mDiscarded = 0;
+    for (i = 0; i < 3 * TEST_REMOVE_EVERY; i++) {
+        TEST_CHECK(evtQueueEnqueue(mQ, 600, TEST_EVT(0, i), 0, false));
+        if (i % 32 == 31) {
+            evtQueueRemoveAllMatching(mQ, testMatchSeq, NULL);
+            while (testDequeue(&evtType, &evtData))
+                TEST_CHECK(TEST_EVT_SEQ(evtData) % TEST_REMOVE_EVERY != 0);
+        }
+    }
+    evtQueueRemoveAllMatching(mQ, testMatchAll, NULL);
+    TEST_CHECK(!testDequeue(&evtType, &evtData));
+
+    //whatever is left is discarded with the queue
+    for (i = 0; i < 5; i++)
+        TEST_CHECK(evtQueueEnqueue(mQ, 700, NULL, 0, i & 1));
+    i = mDiscarded;
+    evtQueueFree(mQ);
+    TEST_CHECK(mDiscarded == i + 5);
+}
+
+static void *testProducer(void *arg)
+{
+    uint32_t id = (uint32_t)(uintptr_t)arg, seq, evtType;
+    uint64_t start, enqueueNs = 0;
+
+    for (seq = 0; seq < mProducerEvents; seq++) {
+        //every fourth event may be dropped when the pool runs out, a few are urgent
+        evtType = 1 | ((seq & 3) ? 0 : EVENT_TYPE_BIT_DISCARDABLE);
+        while (1) {
+            start = testGetTimeNs();
+            if (evtQueueEnqueue(mQ, evtType, TEST_EVT(id, seq), 0, seq % 1000 == 1))
+                break;
+            sched_yield();
+        }
+        enqueueNs += testGetTimeNs() - start;
+    }
+    mEnqueueNs[id] = enqueueNs;
+
+    return NULL;
+}
+
+static void testThreads(uint32_t producers)
+{
+    pthread_t threads[TEST_MAX_PRODUCERS];
+    uint32_t next[TEST_MAX_PRODUCERS] = { 0 };
+    uint32_t i, evtType, delivered = 0, urgentAhead = 0, total = producers * mProducerEvents;
+    uint64_t start, elapsed, enqueueNs = 0;
+    void *evtData;
+
+    mDiscarded = 0;
+    mQ = evtQueueAlloc(TEST_QUEUE_SIZE, testDiscard);
+    TEST_CHECK(mQ != NULL);
+
+    start = testGetTimeNs();
+    for (i = 0; i < producers; i++)
+        pthread_create(&threads[i], NULL, testProducer, (void *)(uintptr_t)i);
+
+    while (delivered + __atomic_load_n(&mDiscarded, __ATOMIC_RELAXED) < total) {
+        if (!testDequeue(&evtType, &evtData)) {
+            sched_yield();
+            continue;
+        }
+        delivered++;
+        if (delivered % 4096 == 0)
+            evtQueueRemoveAllMatching(mQ, testMatchSeq, NULL);
+
+        i = TEST_EVT_PRODUCER(evtData);
+        TEST_CHECK(i < producers);
+        if (i >= producers)
+            continue;
+        //urgent events may overtake the ones of their producer, the others keep their order
+        if (TEST_EVT_SEQ(evtData) % 1000 == 1) {
+            urgentAhead++;
+            continue;
+        }
+        TEST_CHECK(TEST_EVT_SEQ(evtData) >= next[i]);
+        next[i] = TEST_EVT_SEQ(evtData) + 1;
+    }
+    elapsed = testGetTimeNs() - start;
+
+    for (i = 0; i < producers; i++) {
+        pthread_join(threads[i], NULL);
+        enqueueNs += mEnqueueNs[i];
+    }
+    TEST_CHECK(!testDequeue(&evtType, &evtData));
+    TEST_CHECK(delivered + mDiscarded == total);
+    evtQueueFree(mQ);
+
+    printf("threads   : %u producers, %u events, %u delivered, %u discarded, %u urgent\n",
+            producers, total, delivered, mDiscarded, urgentAhead);
+    printf("cost      : enqueue %llu ns, %.1f Mevents/s through the queue\n",
+            (unsigned long long)(enqueueNs / total), (double)total * 1000 / elapsed);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t producers = (argc > 2) ? strtoul(argv[2], NULL, 0) : 4;
+
+    mProducerEvents = (argc > 1) ? strtoul(argv[1], NULL, 0) : TEST_DEFAULT_EVENTS;
+    if (!producers || producers > TEST_MAX_PRODUCERS || mProducerEvents > 0xFFFFFF) {
+        printf("usage: %s [events per producer] [producers(1~%d)]\n", argv[0], TEST_MAX_PRODUCERS);
+        return 1;
+    }
+
+    TEST_CHECK(heapInit());
+
+    testSingleThread();
+    testThreads(producers);
+
+    return testFinish("eventQ_test");
+}
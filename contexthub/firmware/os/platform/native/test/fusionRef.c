@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The orientation filter as it was before its Kalman predict and update paths were specialised,
+ * renamed so that fusion_test can run it next to algos/fusion.c. ref/fusion.c is a plain copy of
+ * the old source, keep it unchanged.
+ */
+
+#define initFusion              refInitFusion
+#define fusionHasEstimate       refFusionHasEstimate
+#define fusionHandleGyro        refFusionHandleGyro
+#define fusionHandleAcc         refFusionHandleAcc
+#define fusionHandleMag         refFusionHandleMag
+#define fusionSetMagTrust       refFusionSetMagTrust
+#define fusionGetAttitude       refFusionGetAttitude
+#define fusionGetBias           refFusionGetBias
+#define fusionGetRotationMatrix refFusionGetRotationMatrix
+
+#include "ref/fusion.c"
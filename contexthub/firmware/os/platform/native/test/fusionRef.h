@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _TEST_FUSION_REF_H_
+#define _TEST_FUSION_REF_H_
+
+#include <algos/fusion.h>
+
+void refInitFusion(struct Fusion *fusion, uint32_t flags);
+void refFusionHandleGyro(struct Fusion *fusion, const struct Vec3 *w, float dT);
+int refFusionHandleAcc(struct Fusion *fusion, const struct Vec3 *a, float dT);
+int refFusionHandleMag(struct Fusion *fusion, const struct Vec3 *m, float dT);
+void refFusionGetAttitude(const struct Fusion *fusion, struct Vec4 *attitude);
+
+#endif
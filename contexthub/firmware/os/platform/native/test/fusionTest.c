@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * algos/fusion.c against the filter it replaced (ref/fusion.c), on a synthetic IMU run: a device
+ * turning on all axes, seen by a biased, noisy gyro at 400Hz, an accelerometer at 400Hz and a
+ * magnetometer at 100Hz. Both filters get the same samples in the 9-axis, game and geomagnetic
+ * modes. Built without fused multiply-add the whole filter state has to stay bit-identical, with
+ * it the attitudes have to stay within a few ULP of each other. With a gyro, the estimate also has
+ * to follow the true attitude. The cost per gyro, acc and mag sample of both filters is reported.
+ *
+ * usage: fusion_test [seconds] [seed]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algos/fusion.h>
+#include "fusionRef.h"
+#include "testStubs.h"
+
+#define TEST_DEFAULT_SECONDS    120
+#define TEST_RATE               400
+#define TEST_MAG_DECIMATION     4
+#define TEST_DT                 (1.0f / TEST_RATE)
+#define TEST_GRAVITY            9.81f
+#define TEST_MAX_ATTITUDE_DIFF  1e-5f   //only when the compiler contracts to fma
+#define TEST_MAX_GRAVITY_ERROR  0.15f   //rad, after the filter settled
+#define TEST_SETTLE_SAMPLES     (10 * TEST_RATE)
+
+struct TestSample {
+    struct Vec3 gyro, acc, mag;
+    struct Vec3 gravity;    //true gravity direction in device frame
+};
+
+struct TestMode {
+    const char *name;
+    uint32_t flags;
+    bool tracks;    //without a gyro the estimate lags a turning device too much to check it
+};
+
+static const struct TestMode mModes[] = {
+    { "9-axis",  FUSION_USE_MAG | FUSION_USE_GYRO, true },
+    { "game",    FUSION_USE_GYRO, true },
+    { "geomag",  FUSION_USE_MAG, false },
+};
+
+static struct TestSample *mSamples;
+static uint32_t mNumSamples, mSeed;
+
+static float testNoise(float stdev)
+{
+    //sum of uniforms, close enough to gaussian for a sensor
+    float sum = 0.0f;
+    uint32_t i;
+
+    for (i = 0; i < 4; i++) {
+        mSeed = mSeed * 1103515245 + 12345;
+        sum += (float)(mSeed >> 8) / (1 << 24) - 0.5f;
+    }
+
+    return sum * stdev * 1.732f;
+}
+
+//world to device: v_dev = R^T v_world, with the true attitude q as (x, y, z, w)
+static void testRotateToDevice(const double q[4], const double world[3], struct Vec3 *dev)
+{
+    double x = q[0], y = q[1], z = q[2], w = q[3];
+    double r[3][3] = {
+        { 1 - 2 * (y * y + z * z), 2 * (x * y - w * z), 2 * (x * z + w * y) },
+        { 2 * (x * y + w * z), 1 - 2 * (x * x + z * z), 2 * (y * z - w * x) },
+        { 2 * (x * z - w * y), 2 * (y * z + w * x), 1 - 2 * (x * x + y * y) },
+    };
+
+    dev->x = r[0][0] * world[0] + r[1][0] * world[1] + r[2][0] * world[2];
+    dev->y = r[0][1] * world[0] + r[1][1] * world[1] + r[2][1] * world[2];
+    dev->z = r[0][2] * world[0] + r[1][2] * world[1] + r[2][2] * world[2];
+}
+
+static void testMakeSamples(uint32_t seconds)
+{
+    static const double gravity[3] = { 0.0, 0.0, TEST_GRAVITY };
+    static const double magField[3] = { 0.0, 20.0, -40.0 };
+    static const double bias[3] = { 0.001, -0.002, 0.0005 };   //left over after gyro calibration
+    double q[4] = { 0.0, 0.0, 0.0, 1.0 }, w[3], dq[4], n;
+    uint32_t i, j;
+
+    mNumSamples = seconds * TEST_RATE;
+    mSamples = malloc(mNumSamples * sizeof(*mSamples));
+
+    for (i = 0; i < mNumSamples; i++) {
+        struct TestSample *s = &mSamples[i];
+        double t = (double)i / TEST_RATE;
+
+        //body rate, slow enough for the accelerometer to see mostly gravity
+        w[0] = 0.5 * sin(0.3 * t);
+        w[1] = 0.4 * cos(0.2 * t);
+        w[2] = 0.3 * sin(0.5 * t + 1.0);
+
+        s->gyro.x = w[0] + bias[0] + testNoise(0.002f);
+        s->gyro.y = w[1] + bias[1] + testNoise(0.002f);
+        s->gyro.z = w[2] + bias[2] + testNoise(0.002f);
+
+        testRotateToDevice(q, gravity, &s->gravity);
+        s->acc.x = s->gravity.x + testNoise(0.05f);
+        s->acc.y = s->gravity.y + testNoise(0.05f);
+        s->acc.z = s->gravity.z + testNoise(0.05f);
+        testRotateToDevice(q, magField, &s->mag);
+        s->mag.x += testNoise(0.5f);
+        s->mag.y += testNoise(0.5f);
+        s->mag.z += testNoise(0.5f);
+
+        //q = q * exp(w dt / 2)
+        dq[0] = w[0] * TEST_DT / 2;
+        dq[1] = w[1] * TEST_DT / 2;
+        dq[2] = w[2] * TEST_DT / 2;
+        dq[3] = 1.0;
+        {
+            double r[4] = {
+                q[3] * dq[0] + q[0] * dq[3] + q[1] * dq[2] - q[2] * dq[1],
+                q[3] * dq[1] - q[0] * dq[2] + q[1] * dq[3] + q[2] * dq[0],
+                q[3] * dq[2] + q[0] * dq[1] - q[1] * dq[0] + q[2] * dq[3],
+                q[3] * dq[3] - q[0] * dq[0] - q[1] * dq[1] - q[2] * dq[2],
+            };
+            n = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + r[3] * r[3]);
+            for (j = 0; j < 4; j++)
+                q[j] = r[j] / n;
+        }
+    }
+}
+
+static void testFeed(struct Fusion *fusion, const struct TestSample *s, uint32_t i, bool ref)
+{
+    if (fusion->flags & FUSION_USE_GYRO) {
+        if (ref)
+            refFusionHandleGyro(fusion, &s->gyro, TEST_DT);
+        else
+            fusionHandleGyro(fusion, &s->gyro, TEST_DT);
+    }
+    if (ref)
+        refFusionHandleAcc(fusion, &s->acc, TEST_DT);
+    else
+        fusionHandleAcc(fusion, &s->acc, TEST_DT);
+    if ((fusion->flags & FUSION_USE_MAG) && i % TEST_MAG_DECIMATION == 0) {
+        if (ref)
+            refFusionHandleMag(fusion, &s->mag, TEST_DT * TEST_MAG_DECIMATION);
+        else
+            fusionHandleMag(fusion, &s->mag, TEST_DT * TEST_MAG_DECIMATION);
+    }
+}
+
+//angle between the true gravity and the one the estimate expects in device frame
+static float testGravityError(const struct Fusion *fusion, const struct TestSample *s)
+{
+    struct Mat33 R;
+    float gx, gy, gz, dot;
+
+    //R takes world to device, the filter predicts its measurements as R * Ba
+    fusionGetRotationMatrix(fusion, &R);
+    gx = R.elem[0][2];
+    gy = R.elem[1][2];
+    gz = R.elem[2][2];
+    dot = (gx * s->gravity.x + gy * s->gravity.y + gz * s->gravity.z) / TEST_GRAVITY;
+
+    return acosf(dot > 1.0f ? 1.0f : dot);
+}
+
+static void testCompare(const struct TestMode *mode)
+{
+    struct Fusion fusion, ref;
+    struct Vec4 att, refAtt;
+    uint32_t i, diffStates = 0;
+    float diff, maxDiff = 0.0f, err, maxErr = 0.0f;
+
+    memset(&fusion, 0x00, sizeof(fusion));
+    memset(&ref, 0x00, sizeof(ref));
+    initFusion(&fusion, mode->flags);
+    refInitFusion(&ref, mode->flags);
+
+    for (i = 0; i < mNumSamples; i++) {
+        testFeed(&fusion, &mSamples[i], i, false);
+        testFeed(&ref, &mSamples[i], i, true);
+
+        if (memcmp(&fusion, &ref, sizeof(fusion)))
+            diffStates++;
+
+        fusionGetAttitude(&fusion, &att);
+        refFusionGetAttitude(&ref, &refAtt);
+        diff = fmaxf(fmaxf(fabsf(att.x - refAtt.x), fabsf(att.y - refAtt.y)),
+                     fmaxf(fabsf(att.z - refAtt.z), fabsf(att.w - refAtt.w)));
+        if (diff > maxDiff)
+            maxDiff = diff;
+
+        if (i >= TEST_SETTLE_SAMPLES && fusionHasEstimate(&fusion)) {
+            err = testGravityError(&fusion, &mSamples[i]);
+            if (err > maxErr)
+                maxErr = err;
+        }
+    }
+
+#ifdef TEST_STRICT_FP
+    TEST_CHECK(diffStates == 0);
+#endif
+    TEST_CHECK(maxDiff <= TEST_MAX_ATTITUDE_DIFF);
+    TEST_CHECK(fusionHasEstimate(&fusion));
+    if (mode->tracks)
+        TEST_CHECK(maxErr <= TEST_MAX_GRAVITY_ERROR);
+
+    printf("%-8s  : %u of %u samples with a different state, attitude diff %g, gravity error %.4f rad\n",
+            mode->name, diffStates, mNumSamples, maxDiff, maxErr);
+}
+
+//ns per sample of one kind, the filter is run over the whole recording once per kind
+static void testBench(const struct TestMode *mode, bool ref)
+{
+    struct Fusion fusion;
+    uint64_t start, gyroNs = 0, accNs = 0, magNs = 0;
+    uint32_t i, mags = 0;
+
+    memset(&fusion, 0x00, sizeof(fusion));
+    if (ref)
+        refInitFusion(&fusion, mode->flags);
+    else
+        initFusion(&fusion, mode->flags);
+
+    for (i = 0; i < mNumSamples; i++) {
+        const struct TestSample *s = &mSamples[i];
+
+        start = testGetTimeNs();
+        if (ref)
+            refFusionHandleGyro(&fusion, &s->gyro, TEST_DT);
+        else
+            fusionHandleGyro(&fusion, &s->gyro, TEST_DT);
+        gyroNs += testGetTimeNs() - start;
+
+        start = testGetTimeNs();
+        if (ref)
+            refFusionHandleAcc(&fusion, &s->acc, TEST_DT);
+        else
+            fusionHandleAcc(&fusion, &s->acc, TEST_DT);
+        accNs += testGetTimeNs() - start;
+
+        if (i % TEST_MAG_DECIMATION == 0) {
+            start = testGetTimeNs();
+            if (ref)
+                refFusionHandleMag(&fusion, &s->mag, TEST_DT * TEST_MAG_DECIMATION);
+            else
+                fusionHandleMag(&fusion, &s->mag, TEST_DT * TEST_MAG_DECIMATION);
+            magNs += testGetTimeNs() - start;
+            mags++;
+        }
+    }
+
+    printf("cost %-4s : gyro %llu ns, acc %llu ns, mag %llu ns per sample\n", ref ? "old" : "new",
+            (unsigned long long)(gyroNs / mNumSamples), (unsigned long long)(accNs / mNumSamples),
+            (unsigned long long)(magNs / mags));
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = (argc > 1) ? strtoul(argv[1], NULL, 0) : TEST_DEFAULT_SECONDS;
+    uint32_t i;
+
+    mSeed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+    if (seconds * TEST_RATE <= TEST_SETTLE_SAMPLES) {
+        printf("usage: %s [seconds(> %u)] [seed]\n", argv[0], TEST_SETTLE_SAMPLES / TEST_RATE);
+        return 1;
+    }
+
+    testMakeSamples(seconds);
+
+    for (i = 0; i < sizeof(mModes) / sizeof(mModes[0]); i++)
+        testCompare(&mModes[i]);
+
+    testBench(&mModes[0], true);
+    testBench(&mModes[0], false);
+
+    free(mSamples);
+
+    return testFinish("fusion_test");
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Alloc/free stress of core/heap.c. Chunks of random size are allocated and freed in random
+ * order, each is filled with a pattern that is checked before it is freed, and the heap
+ * accounting is checked against a walk of the chunks. The stress keeps the heap fragmented,
+ * the cost of alloc/free, their interrupt-off sections and the fragmentation it ends up
+ * with are reported.
+ *
+ * usage: heap_test [iterations] [seed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <heap.h>
+#include "testStubs.h"
+
+#define TEST_SLOTS              256
+#define TEST_MAX_SMALL_ALLOC    64
+#define TEST_MAX_ALLOC          2048
+#define TEST_DEFAULT_ITERATION  200000
+
+struct TestChunk {
+    uint8_t *ptr;
+    uint32_t size;
+    uint8_t pattern;
+};
+
+static struct TestChunk mChunks[TEST_SLOTS];
+static uint32_t mSeed;
+
+static uint32_t testRand(void)
+{
+    mSeed = mSeed * 1103515245 + 12345;
+    return mSeed >> 8;
+}
+
+//mostly small chunks like the events and the app buffers, and some big ones that need a long free run
+static uint32_t testRandSize(void)
+{
+    if (testRand() % 8)
+        return 1 + testRand() % TEST_MAX_SMALL_ALLOC;
+    else
+        return 1 + testRand() % TEST_MAX_ALLOC;
+}
+
+static void testFill(struct TestChunk *chunk)
+{
+    memset(chunk->ptr, chunk->pattern, chunk->size);
+}
+
+static bool testVerify(const struct TestChunk *chunk)
+{
+    uint32_t i;
+
+    for (i = 0; i < chunk->size; i++)
+        if (chunk->ptr[i] != chunk->pattern)
+            return false;
+
+    return true;
+}
+
+static void testCheckStats(void)
+{
+    struct HeapStats stats;
+    int numChunks, largest, freeBytes;
+
+    TEST_CHECK(heapGetStats(&stats));
+    TEST_CHECK(stats.usedBytes + stats.freeBytes == stats.totalSize);
+
+    freeBytes = heapGetFreeSize(&numChunks, &largest);
+    TEST_CHECK(freeBytes == (int)stats.freeBytes);
+    TEST_CHECK(numChunks == (int)stats.numFreeChunks);
+    TEST_CHECK(largest == (int)stats.largestFreeChunk);
+}
+
+//random alloc/free, returns the average ns of one heapAlloc() and of one heapFree(), and the irq off of each
+static void testStress(uint32_t iteration, uint64_t *allocNs, uint64_t *freeNs, struct TestHist *allocIrq, struct TestHist *freeIrq)
+{
+    uint32_t i, allocs = 0, frees = 0, fails = 0;
+    uint64_t allocTime = 0, freeTime = 0, start;
+
+    testIrqTakeMaxNs();
+
+    for (i = 0; i < iteration; i++) {
+        struct TestChunk *chunk = &mChunks[testRand() % TEST_SLOTS];
+
+        if (chunk->ptr) {
+            TEST_CHECK(testVerify(chunk));
+            start = testGetTimeNs();
+            heapFree(chunk->ptr);
+            freeTime += testGetTimeNs() - start;
+            testHistAdd(freeIrq, testIrqTakeMaxNs());
+            chunk->ptr = NULL;
+            frees++;
+        } else {
+            chunk->size = testRandSize();
+            chunk->pattern = (uint8_t)(i | 1);
+            start = testGetTimeNs();
+            chunk->ptr = heapAlloc(chunk->size);
+            allocTime += testGetTimeNs() - start;
+            testHistAdd(allocIrq, testIrqTakeMaxNs());
+            allocs++;
+            if (chunk->ptr)
+                testFill(chunk);
+            else
+                fails++;
+        }
+
+        if (i % 1024 == 0) {
+            testCheckStats();
+            testIrqTakeMaxNs();
+        }
+    }
+
+    *allocNs = allocs ? allocTime / allocs : 0;
+    *freeNs = frees ? freeTime / frees : 0;
+    printf("stress    : %u allocs, %u frees, %u failed allocs\n", allocs, frees, fails);
+}
+
+static void testFreeAllChunks(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < TEST_SLOTS; i++) {
+        if (mChunks[i].ptr) {
+            TEST_CHECK(testVerify(&mChunks[i]));
+            heapFree(mChunks[i].ptr);
+            mChunks[i].ptr = NULL;
+        }
+    }
+}
+
+//everything freed must merge back to the one chunk heapInit() made
+static void testCheckMerged(void)
+{
+    struct HeapStats stats;
+
+    TEST_CHECK(heapGetStats(&stats));
+    TEST_CHECK(stats.usedBytes == 0);
+    TEST_CHECK(stats.numFreeChunks == 1);
+    TEST_CHECK(stats.fragmentation == 0);
+    TEST_CHECK(stats.allocCount == stats.freeCount);
+}
+
+//a chunk that fits the request exactly has to be found, even though the rounded search skips its list
+static void testExactFit(void)
+{
+    static const uint32_t sizes[] = { 8, 36, 100, 600, 1000, 3000 };
+    uint32_t i;
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        struct HeapStats stats;
+        void *hole, *guard, *rest, *again;
+
+        hole = heapAlloc(sizes[i]);
+        guard = heapAlloc(4);
+        TEST_CHECK(heapGetStats(&stats));
+        rest = heapAlloc(stats.largestFreeChunk);
+        TEST_CHECK(hole && guard && rest);
+
+        //the hole is now the only free chunk
+        heapFree(hole);
+        again = heapAlloc(sizes[i]);
+        TEST_CHECK(again == hole);
+
+        heapFree(again);
+        heapFree(guard);
+        heapFree(rest);
+        testCheckMerged();
+    }
+}
+
+//heapFreeAll() frees the chunks of one task only
+static void testFreeAll(void)
+{
+    void *kept[8];
+    uint32_t i;
+
+    for (i = 0; i < 16; i++) {
+        gTestTid = (i & 1) ? 5 : 6;
+        if (gTestTid == 5)
+            (void)heapAlloc(32 + i);
+        else
+            kept[i / 2] = heapAlloc(32 + i);
+    }
+    gTestTid = 1;
+
+    TEST_CHECK(heapGetTaskSize(5) > 0);
+    TEST_CHECK(heapFreeAll(5) == 8);
+    TEST_CHECK(heapGetTaskSize(5) == 0);
+    TEST_CHECK(heapGetTaskSize(6) > 0);
+
+    for (i = 0; i < 8; i++)
+        heapFree(kept[i]);
+    testCheckMerged();
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iteration = (argc > 1) ? strtoul(argv[1], NULL, 0) : TEST_DEFAULT_ITERATION;
+    struct HeapStats stats;
+    static struct TestHist allocIrq, freeIrq;
+    uint64_t allocNs, freeNs;
+
+    mSeed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+
+    TEST_CHECK(heapInit());
+    testCheckMerged();
+
+    testExactFit();
+    testFreeAll();
+
+    testStress(iteration, &allocNs, &freeNs, &allocIrq, &freeIrq);
+    TEST_CHECK(heapGetStats(&stats));
+    printf("heap      : %u bytes, peak used %u bytes\n", stats.totalSize, stats.peakUsedBytes);
+    printf("fragments : %u free chunks, largest %u of %u free bytes, fragmentation %u%%\n",
+            stats.numFreeChunks, stats.largestFreeChunk, stats.freeBytes, stats.fragmentation);
+    printf("cost      : alloc %llu ns, free %llu ns\n", (unsigned long long)allocNs, (unsigned long long)freeNs);
+    printf("irq off   : alloc p99 %llu ns max %llu ns, free p99 %llu ns max %llu ns\n",
+            (unsigned long long)testHistPercentile(&allocIrq, 990), (unsigned long long)allocIrq.maxNs,
+            (unsigned long long)testHistPercentile(&freeIrq, 990), (unsigned long long)freeIrq.maxNs);
+
+    testFreeAllChunks();
+    testCheckMerged();
+
+    return testFinish("heap_test");
+}
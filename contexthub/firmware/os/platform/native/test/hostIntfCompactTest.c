@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Round trip of the compact three-axis encoding of core/hostIntfCompact.c. Blocks of random
+ * sensor-like samples are encoded and decoded again the way the AP does, see struct
+ * CompactTripleAxisHeader. The time deltas have to come back exactly and the axis values within
+ * half a step of the block scale. Blocks holding inf or nan must be left as they are. The bytes per sample and the encoding cost are reported.
+ *
+ * usage: hostIntf_compact_test [blocks] [seed]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <hostIntf.h>
+#include "testStubs.h"
+
+#define TEST_DEFAULT_BLOCKS     20000
+#define TEST_MAX_SAMPLES        (HOSTINTF_SENSOR_DATA_MAX / sizeof(struct TripleAxisDataPoint))
+
+struct TestSample {
+    uint32_t deltaTime;
+    float axis[3];
+};
+
+static uint32_t mSeed;
+
+static uint32_t testRand(void)
+{
+    mSeed = mSeed * 1103515245 + 12345;
+    return mSeed >> 8;
+}
+
+static float testRandFloat(float range)
+{
+    return range * ((float)(testRand() & 0xFFFF) / 0x8000 - 1.0f);
+}
+
+static void testFillBlock(struct HostIntfDataBuffer *buf, struct TestSample *samples, uint32_t numSamples)
+{
+    //a slowly moving signal with noise, like a gyro or a magnetometer, at a random full scale
+    float range = ldexpf(1.0f, (int)(testRand() % 24) - 12);
+    float base[3] = { testRandFloat(range), testRandFloat(range), testRandFloat(range) };
+    uint32_t delta = 1000 + testRand() % 100000;
+    uint32_t i, j;
+
+    memset(buf, 0x00, sizeof(*buf));
+    buf->sensType = SENS_TYPE_GYRO;
+    buf->length = sizeof(struct TripleAxisDataEvent) + numSamples * sizeof(struct TripleAxisDataPoint);
+    buf->referenceTime = 123456789;
+
+    for (i = 0; i < numSamples; i++) {
+        //delta times jitter a bit around the sampling period
+        samples[i].deltaTime = i ? delta + testRand() % 64 : 0;
+        for (j = 0; j < 3; j++)
+            samples[i].axis[j] = base[j] + testRandFloat(range / 64);
+
+        if (i)
+            buf->triple[i].deltaTime = samples[i].deltaTime;
+        buf->triple[i].x = samples[i].axis[0];
+        buf->triple[i].y = samples[i].axis[1];
+        buf->triple[i].z = samples[i].axis[2];
+    }
+    buf->triple[0].firstSample.numSamples = numSamples;
+}
+
+static bool testGetVarint(const uint8_t **p, const uint8_t *end, uint32_t *val)
+{
+    uint32_t shift = 0;
+
+    *val = 0;
+    while (*p < end && shift < 32) {
+        uint8_t byte = *(*p)++;
+
+        *val |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+        shift += 7;
+    }
+
+    return false;
+}
+
+static int32_t testUnzigzag32(uint32_t val)
+{
+    return (int32_t)(val >> 1) ^ -(int32_t)(val & 1);
+}
+
+//decode the way the AP does, returns false on a truncated block
+static bool testDecodeBlock(const struct HostIntfDataBuffer *buf, struct TestSample *samples)
+{
+    const struct CompactTripleAxisHeader *header = &buf->compact;
+    const uint8_t *p = (const uint8_t *)(header + 1);
+    const uint8_t *end = p + header->dataLength;
+    uint32_t i, j, val, deltaTime = 0;
+    int32_t q[3] = { 0, 0, 0 };
+
+    for (i = 0; i < header->firstSample.numSamples; i++) {
+        if (i > 0) {
+            if (!testGetVarint(&p, end, &val))
+                return false;
+            deltaTime += testUnzigzag32(val);
+        }
+        for (j = 0; j < 3; j++) {
+            if (!testGetVarint(&p, end, &val))
+                return false;
+            q[j] += testUnzigzag32(val);
+            samples[i].axis[j] = ldexpf(q[j], header->scaleExp);
+        }
+        samples[i].deltaTime = deltaTime;
+    }
+
+    return p == end;
+}
+
+static void testRoundTrip(uint32_t blocks)
+{
+    struct HostIntfDataBuffer buf;
+    struct TestSample in[TEST_MAX_SAMPLES], out[TEST_MAX_SAMPLES];
+    uint64_t inBytes = 0, outBytes = 0, samples = 0, encodeNs = 0, start;
+    uint32_t b, i, j, compacted = 0;
+    double maxErr = 0.0;
+
+    for (b = 0; b < blocks; b++) {
+        uint32_t numSamples = 1 + testRand() % TEST_MAX_SAMPLES;
+
+        testFillBlock(&buf, in, numSamples);
+        inBytes += buf.length;
+        samples += numSamples;
+
+        start = testGetTimeNs();
+        if (!hostIntfCompactTripleSamples(&buf)) {
+            encodeNs += testGetTimeNs() - start;
+            TEST_CHECK(buf.dataType == HOSTINTF_SENSOR_DATA_FORMAT_DEFAULT);
+            outBytes += buf.length;
+            continue;
+        }
+        encodeNs += testGetTimeNs() - start;
+        compacted++;
+        outBytes += buf.length;
+
+        TEST_CHECK(buf.dataType == HOSTINTF_SENSOR_DATA_FORMAT_COMPACT);
+        TEST_CHECK(buf.length == sizeof(uint64_t) + sizeof(struct CompactTripleAxisHeader) + buf.compact.dataLength);
+        TEST_CHECK(buf.compact.firstSample.numSamples == numSamples);
+        TEST_CHECK(buf.referenceTime == 123456789);
+        TEST_CHECK(testDecodeBlock(&buf, out));
+
+        for (i = 0; i < numSamples; i++) {
+            TEST_CHECK(out[i].deltaTime == in[i].deltaTime);
+            for (j = 0; j < 3; j++) {
+                //rounding to the fixed point step is the only loss
+                double err = fabs((double)out[i].axis[j] - in[i].axis[j]) / ldexp(1.0, buf.compact.scaleExp);
+
+                TEST_CHECK(err <= 0.5);
+                if (err > maxErr)
+                    maxErr = err;
+            }
+        }
+    }
+
+    printf("round trip: %u of %u blocks compacted, largest error %.3f step\n", compacted, blocks, maxErr);
+    printf("size      : %.1f -> %.1f bytes per sample\n", (double)inBytes / samples, (double)outBytes / samples);
+    printf("cost      : %llu ns per block\n", (unsigned long long)(encodeNs / blocks));
+}
+
+static void testEdgeBlocks(void)
+{
+    struct HostIntfDataBuffer buf, orig;
+    struct TestSample in[TEST_MAX_SAMPLES], out[TEST_MAX_SAMPLES];
+    uint32_t i;
+
+    //inf and nan can not be scaled
+    testFillBlock(&buf, in, TEST_MAX_SAMPLES);
+    buf.triple[3].y = INFINITY;
+    orig = buf;
+    TEST_CHECK(!hostIntfCompactTripleSamples(&buf));
+    TEST_CHECK(memcmp(&buf, &orig, sizeof(buf)) == 0);
+
+    testFillBlock(&buf, in, TEST_MAX_SAMPLES);
+    buf.triple[7].z = NAN;
+    orig = buf;
+    TEST_CHECK(!hostIntfCompactTripleSamples(&buf));
+    TEST_CHECK(memcmp(&buf, &orig, sizeof(buf)) == 0);
+
+    //full scale swings and delta times take the longest varints, and still decode
+    testFillBlock(&buf, in, TEST_MAX_SAMPLES);
+    for (i = 0; i < TEST_MAX_SAMPLES; i++) {
+        in[i].axis[0] = in[i].axis[2] = buf.triple[i].x = buf.triple[i].z = (i & 1) ? 1.0f : -1.0f;
+        in[i].axis[1] = buf.triple[i].y = (i & 1) ? -1.0f : 1.0f;
+        in[i].deltaTime = i ? ((i & 1) ? 0x7FFFFFFF : 1) : 0;
+        if (i)
+            buf.triple[i].deltaTime = in[i].deltaTime;
+    }
+    TEST_CHECK(hostIntfCompactTripleSamples(&buf));
+    TEST_CHECK(testDecodeBlock(&buf, out));
+    for (i = 0; i < TEST_MAX_SAMPLES; i++) {
+        TEST_CHECK(out[i].deltaTime == in[i].deltaTime);
+        TEST_CHECK(out[i].axis[0] == in[i].axis[0] && out[i].axis[1] == in[i].axis[1] && out[i].axis[2] == in[i].axis[2]);
+    }
+
+    //a block is compacted once
+    testFillBlock(&buf, in, TEST_MAX_SAMPLES);
+    TEST_CHECK(hostIntfCompactTripleSamples(&buf));
+    orig = buf;
+    TEST_CHECK(!hostIntfCompactTripleSamples(&buf));
+    TEST_CHECK(memcmp(&buf, &orig, sizeof(buf)) == 0);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t blocks = (argc > 1) ? strtoul(argv[1], NULL, 0) : TEST_DEFAULT_BLOCKS;
+
+    mSeed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+
+    testEdgeBlocks();
+    testRoundTrip(blocks);
+
+    return testFinish("hostIntf_compact_test");
+}
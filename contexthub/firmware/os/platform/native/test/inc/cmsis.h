@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _TEST_CMSIS_H_
+#define _TEST_CMSIS_H_
+
+/* there is nothing to mask, the sections are only timed, see testStubs.h */
+void testIrqOff(void);
+void testIrqRestore(void);
+
+static inline void __disable_irq(void)
+{
+    testIrqOff();
+}
+
+static inline void __enable_irq(void)
+{
+    testIrqRestore();
+}
+
+#endif
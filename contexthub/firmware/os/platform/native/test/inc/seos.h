@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _TEST_SEOS_H_
+#define _TEST_SEOS_H_
+
+/* the part of seos.h the core sources under test need, without the os behind it */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <taggedPtr.h>
+#include <eventnums.h>
+
+#define TASK_IDX_BITS                     8
+#define OS_SYSTEM_TID                     0
+
+typedef void (*EventFreeF)(void* event);
+
+bool osEnqueuePrivateEvt(uint32_t evtType, void *evtData, EventFreeF evtFreeF, uint32_t toTid);
+void osRemovePendingEvents(bool (*match)(uint32_t evtType, const void *evtData, void *context), void *context);
+
+enum LogLevel {
+    LOG_ERROR   = 'E',
+    LOG_WARN    = 'W',
+    LOG_CAUTION = 'C',
+    LOG_INFO    = 'I',
+    LOG_DEBUG   = 'D',
+    LOG_VERBOSE = 'V',
+    LOG_TIME    = 'T',
+    LOG_ALL     = 'A',
+};
+
+uint32_t osGetCurrentTid();
+uint32_t osSetCurrentTid(uint32_t);
+void osLog(enum LogLevel level, const char *str, ...) __attribute__((format(printf, 2, 3)));
+
+#endif
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _TEST_SEOS_PRIV_H_
+#define _TEST_SEOS_PRIV_H_
+
+/* the part of seos_priv.h the core sources under test need */
+
+#include <stdint.h>
+
+#define EVT_PRIVATE_EVT              0x00000003
+
+union SeosInternalSlabData {
+    struct {
+        uint32_t evtType;
+        void *evtData;
+        void *evtFreeInfo;
+        uint16_t fromTid;
+        uint16_t toTid;
+    } privateEvt;
+};
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <time.h>
+#include <seos.h>
+#include "testStubs.h"
+
+uint32_t gTestTid = 1;
+uint32_t gTestLogErrors;
+uint32_t gTestFailures;
+
+//per thread, eventQ_test posts from several threads at once
+static __thread uint32_t mIrqDepth;
+static __thread uint64_t mIrqOffTime, mIrqMaxNs;
+
+uint32_t osGetCurrentTid()
+{
+    return gTestTid;
+}
+
+void osLog(enum LogLevel level, const char *str, ...)
+{
+    va_list vl;
+
+    if (level == LOG_ERROR)
+        gTestLogErrors++;
+
+    if (level != LOG_ERROR || getenv("TEST_VERBOSE")) {
+        va_start(vl, str);
+        vprintf(str, vl);
+        va_end(vl);
+    }
+}
+
+uint64_t testGetTimeNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void testIrqOff(void)
+{
+    if (!mIrqDepth++)
+        mIrqOffTime = testGetTimeNs();
+}
+
+void testIrqRestore(void)
+{
+    uint64_t ns;
+
+    if (mIrqDepth && !--mIrqDepth) {
+        ns = testGetTimeNs() - mIrqOffTime;
+        if (ns > mIrqMaxNs)
+            mIrqMaxNs = ns;
+    }
+}
+
+uint64_t testIrqTakeMaxNs(void)
+{
+    uint64_t ns = mIrqMaxNs;
+
+    mIrqMaxNs = 0;
+    return ns;
+}
+
+void testHistAdd(struct TestHist *hist, uint64_t ns)
+{
+    uint64_t i = ns / TEST_HIST_STEP_NS;
+
+    hist->bucket[i < TEST_HIST_BUCKETS ? i : TEST_HIST_BUCKETS - 1]++;
+    hist->count++;
+    if (ns > hist->maxNs)
+        hist->maxNs = ns;
+}
+
+//upper bound of the bucket the percentile falls in
+uint64_t testHistPercentile(const struct TestHist *hist, uint32_t permille)
+{
+    uint64_t want = ((uint64_t)hist->count * permille + 999) / 1000, seen = 0;
+    uint32_t i;
+
+    for (i = 0; i < TEST_HIST_BUCKETS - 1; i++) {
+        seen += hist->bucket[i];
+        if (seen >= want)
+            return (i + 1) * TEST_HIST_STEP_NS;
+    }
+
+    return hist->maxNs;
+}
+
+int testFinish(const char *name)
+{
+    printf("%s: %s (%u failed checks)\n", name, gTestFailures ? "FAIL" : "PASS", gTestFailures);
+
+    return gTestFailures ? 1 : 0;
+}
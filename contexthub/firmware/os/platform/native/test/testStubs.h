@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _TEST_STUBS_H_
+#define _TEST_STUBS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+extern uint32_t gTestTid;
+extern uint32_t gTestLogErrors;
+extern uint32_t gTestFailures;
+
+#define TEST_CHECK(cond)                                                        \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);     \
+            gTestFailures++;                                                    \
+        }                                                                       \
+    } while (0)
+
+uint64_t testGetTimeNs(void);
+int testFinish(const char *name);
+
+/* interrupt-off sections, timed by the irq stubs. the clock reads are part of the section */
+void testIrqOff(void);
+void testIrqRestore(void);
+uint64_t testIrqTakeMaxNs(void);    //longest section since the last call
+
+/* the longest section is host scheduling noise more often than not, the tests report a percentile next to it */
+#define TEST_HIST_STEP_NS   10
+#define TEST_HIST_BUCKETS   4096
+
+struct TestHist {
+    uint32_t count;
+    uint64_t maxNs;
+    uint32_t bucket[TEST_HIST_BUCKETS];
+};
+
+void testHistAdd(struct TestHist *hist, uint64_t ns);
+uint64_t testHistPercentile(const struct TestHist *hist, uint32_t permille);
+
+#endif
@@ -0,0 +1,364 @@
+/*
+ * Copyright (C) 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Timers of core/timer.c against a model, on fake tim and rtc clocks. Timers are set, cancelled
+ * and expired in random order; every expiration is checked against the model, and so is the
+ * wakeup requested from the platform. The cost of set, cancel and expire with many armed timers
+ * is reported, and so are their interrupt-off sections.
+ *
+ * usage: timer_test [iterations] [seed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <heap.h>
+#include <timer.h>
+#include <seos.h>
+#include <cpu.h>
+#include <platform.h>
+#include <plat/rtc.h>
+#include "testStubs.h"
+
+#define TEST_DEFAULT_ITERATION  100000
+#define TEST_RTC_OFFSET         1000000000ULL   //the clocks differ, the rtc timers are converted to tim time
+#define TEST_MAX_LENGTH         1000000
+#define TEST_BENCH_ROUNDS       10000
+
+struct TestTimer {
+    uint32_t id;
+    uint64_t expires;
+    uint64_t period;
+    bool rtc;
+    uint32_t fired;
+    uint32_t expected;
+};
+
+static struct TestTimer mModel[MAX_TIMERS];
+static uint64_t mTime = 1, mWakeup;
+static bool mWakeupRequested;
+static uint32_t mIntsOff, mFires, mEvents, mSeed;
+static uint32_t mCancelInCallback;
+
+/* the platform under the timers */
+
+uint64_t platGetTicks(void)
+{
+    return mTime;
+}
+
+uint64_t rtcGetTime(void)
+{
+    return mTime + TEST_RTC_OFFSET;
+}
+
+bool platSleepClockRequest(uint64_t wakeupTime, uint32_t maxJitterPpm, uint32_t maxDriftPpm, uint32_t maxErrTotalPpm)
+{
+    mWakeup = wakeupTime;
+    mWakeupRequested = true;
+    return true;
+}
+
+uint64_t cpuIntsOff(void)
+{
+    testIrqOff();
+    return mIntsOff++;
+}
+
+void cpuIntsRestore(uint64_t state)
+{
+    mIntsOff = state;
+    testIrqRestore();
+}
+
+uint32_t osSetCurrentTid(uint32_t tid)
+{
+    uint32_t old = gTestTid;
+
+    gTestTid = tid;
+    return old;
+}
+
+static struct TestTimer *testFindModel(uint32_t id)
+{
+    uint32_t i;
+
+    for (i = 0; i < MAX_TIMERS; i++)
+        if (mModel[i].id == id)
+            return &mModel[i];
+
+    return NULL;
+}
+
+static void testFired(uint32_t id)
+{
+    struct TestTimer *t = testFindModel(id);
+
+    TEST_CHECK(t != NULL);
+    if (t)
+        t->fired++;
+    mFires++;
+}
+
+//the rtc timers come as events
+bool osEnqueuePrivateEvt(uint32_t evtType, void *evtData, EventFreeF evtFreeF, uint32_t toTid)
+{
+    struct TimerEvent *evt = evtData;
+
+    TEST_CHECK(evtType == EVT_APP_TIMER);
+    testFired(evt->timerId);
+    mEvents++;
+    evtFreeF(evtData);
+
+    return true;
+}
+
+void osRemovePendingEvents(bool (*match)(uint32_t evtType, const void *evtData, void *context), void *context)
+{
+}
+
+static void testCallback(uint32_t timerId, void *data)
+{
+    struct TestTimer *t;
+
+    testFired(timerId);
+
+    //cancel the timer that is due next, the cancelled one must not fire anymore
+    if (mCancelInCallback) {
+        t = testFindModel(mCancelInCallback);
+        mCancelInCallback = 0;
+        TEST_CHECK(timTimerCancel(t->id));
+        t->id = 0;
+    }
+}
+
+/* the model */
+
+static struct TestTimer *testNewModel(uint32_t id, uint64_t length, bool oneShot, bool rtc)
+{
+    struct TestTimer *t = testFindModel(0);
+
+    t->id = id;
+    t->expires = mTime + length;
+    t->period = oneShot ? 0 : length;
+    t->rtc = rtc;
+    t->fired = t->expected = 0;
+
+    return t;
+}
+
+//expire the model up to now, like the timers should have
+static void testExpireModel(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < MAX_TIMERS; i++) {
+        struct TestTimer *t = &mModel[i];
+
+        if (!t->id)
+            continue;
+        while (t->expires <= mTime) {
+            t->expected++;
+            if (!t->period)
+                break;
+            t->expires += t->period;
+        }
+    }
+}
+
+//set and expire request the exact wakeup, cancel leaves an early one behind, which is only a spurious interrupt
+static void testCheckModel(bool exactWakeup)
+{
+    uint64_t next = 0;
+    uint32_t i;
+
+    for (i = 0; i < MAX_TIMERS; i++) {
+        struct TestTimer *t = &mModel[i];
+
+        if (!t->id)
+            continue;
+        TEST_CHECK(t->fired == t->expected);
+        if (!t->period && t->expected) {
+            t->id = 0;
+            continue;
+        }
+        if (!next || t->expires < next)
+            next = t->expires;
+    }
+
+    if (exactWakeup)
+        TEST_CHECK(mWakeup == next);
+    else
+        TEST_CHECK(!next || (mWakeup && mWakeup <= next));
+}
+
+static uint32_t testRand(void)
+{
+    mSeed = mSeed * 1103515245 + 12345;
+    return mSeed >> 8;
+}
+
+static uint32_t testArmed(void)
+{
+    uint32_t i, count = 0;
+
+    for (i = 0; i < MAX_TIMERS; i++)
+        count += !!mModel[i].id;
+
+    return count;
+}
+
+static uint32_t testSet(uint64_t length, bool oneShot, bool rtc)
+{
+    uint32_t id;
+
+    if (rtc)
+        id = timTimerSetNew(length, NULL, oneShot);
+    else
+        id = timTimerSet(length, 0, 50, testCallback, NULL, oneShot);
+    TEST_CHECK(id != 0);
+    if (id)
+        testNewModel(id, length, oneShot, rtc);
+
+    return id;
+}
+
+static void testStress(uint32_t iteration)
+{
+    uint32_t i, sets = 0, cancels = 0;
+
+    for (i = 0; i < iteration; i++) {
+        uint32_t op = testRand() % 8;
+
+        if (op < 3 && testArmed() < MAX_TIMERS) {
+            testSet(1 + testRand() % TEST_MAX_LENGTH, testRand() % 4, !(testRand() % 4));
+            sets++;
+        } else if (op < 5) {
+            struct TestTimer *t = &mModel[testRand() % MAX_TIMERS];
+            if (t->id) {
+                TEST_CHECK(timTimerCancel(t->id));
+                t->id = 0;
+                cancels++;
+            }
+        } else {
+            mTime += testRand() % (TEST_MAX_LENGTH / 4);
+            testExpireModel();
+            timIntHandler();
+        }
+
+        testCheckModel(mWakeupRequested);
+        mWakeupRequested = false;
+    }
+
+    for (i = 0; i < MAX_TIMERS; i++) {
+        if (mModel[i].id) {
+            TEST_CHECK(timTimerCancel(mModel[i].id));
+            mModel[i].id = 0;
+        }
+    }
+    TEST_CHECK(!timTimerCancel(1));
+
+    printf("stress    : %u sets, %u cancels, %u expirations (%u as events)\n", sets, cancels, mFires, mEvents);
+}
+
+//a callback cancelling the next due timer of the same interrupt
+static void testCancelInCallback(void)
+{
+    uint32_t first, second;
+
+    first = testSet(100, true, false);
+    second = testSet(100, true, false);
+    mCancelInCallback = second;
+    mTime += 100;
+    timIntHandler();
+
+    TEST_CHECK(testFindModel(first) && testFindModel(first)->fired == 1);
+    TEST_CHECK(mCancelInCallback == 0);
+    testFindModel(first)->id = 0;
+    TEST_CHECK(!timTimerCancel(second));
+    TEST_CHECK(mWakeup == 0);
+}
+
+//per operation cost and interrupt-off sections with the timer table nearly full
+static void testBench(void)
+{
+    static struct TestHist setIrq, cancelIrq, fireIrq;
+    uint64_t start, setNs = 0, cancelNs = 0, fireNs = 0;
+    uint32_t i, armed = 0, id;
+
+    while (armed < MAX_TIMERS - 1) {
+        testSet(TEST_MAX_LENGTH * 1000ULL + testRand() % TEST_MAX_LENGTH, true, armed & 1);
+        armed++;
+    }
+    testIrqTakeMaxNs();
+
+    for (i = 0; i < TEST_BENCH_ROUNDS; i++) {
+        start = testGetTimeNs();
+        id = timTimerSet(1 + testRand() % TEST_MAX_LENGTH, 0, 50, testCallback, NULL, true);
+        setNs += testGetTimeNs() - start;
+        testHistAdd(&setIrq, testIrqTakeMaxNs());
+        testNewModel(id, 0, true, false);
+
+        start = testGetTimeNs();
+        timTimerCancel(id);
+        cancelNs += testGetTimeNs() - start;
+        testHistAdd(&cancelIrq, testIrqTakeMaxNs());
+        testFindModel(id)->id = 0;
+
+        id = timTimerSet(1, 0, 50, testCallback, NULL, true);
+        testNewModel(id, 0, true, false);
+        mTime += 1;
+        testIrqTakeMaxNs();
+        start = testGetTimeNs();
+        timIntHandler();
+        fireNs += testGetTimeNs() - start;
+        testHistAdd(&fireIrq, testIrqTakeMaxNs());
+        testFindModel(id)->id = 0;
+    }
+
+    printf("cost      : %u armed, set %llu ns, cancel %llu ns, expire %llu ns\n", armed,
+            (unsigned long long)(setNs / TEST_BENCH_ROUNDS), (unsigned long long)(cancelNs / TEST_BENCH_ROUNDS),
+            (unsigned long long)(fireNs / TEST_BENCH_ROUNDS));
+    printf("irq off   : set p99 %llu ns max %llu ns, cancel p99 %llu ns max %llu ns, expire p99 %llu ns max %llu ns\n",
+            (unsigned long long)testHistPercentile(&setIrq, 990), (unsigned long long)setIrq.maxNs,
+            (unsigned long long)testHistPercentile(&cancelIrq, 990), (unsigned long long)cancelIrq.maxNs,
+            (unsigned long long)testHistPercentile(&fireIrq, 990), (unsigned long long)fireIrq.maxNs);
+
+    for (i = 0; i < MAX_TIMERS; i++) {
+        if (mModel[i].id) {
+            TEST_CHECK(timTimerCancel(mModel[i].id));
+            mModel[i].id = 0;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t iteration = (argc > 1) ? strtoul(argv[1], NULL, 0) : TEST_DEFAULT_ITERATION;
+
+    mSeed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+
+    TEST_CHECK(heapInit());
+    timInit();
+
+    testCancelInCallback();
+    testStress(iteration);
+    testBench();
+    TEST_CHECK(mIntsOff == 0);
+
+    return testFinish("timer_test");
+}
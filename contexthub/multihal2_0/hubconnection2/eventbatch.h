@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EVENT_BATCH_H_
+
+#define EVENT_BATCH_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+namespace android {
+
+// Converted events waiting to be posted, one batch per wakeup class.
+// The batches are reserved up front and only cleared after posting, so
+// steady state does not allocate. post is called as
+// post(const std::vector<E>& events, bool wakeup) with a non-empty batch.
+// Kept free of the HAL types so that it can be tested on the host, see
+// multihal2_0/test.
+template <typename E, size_t MAX_EVENTS>
+class EventBatch {
+public:
+    EventBatch() {
+        mEvents[0].reserve(MAX_EVENTS);
+        mEvents[1].reserve(MAX_EVENTS);
+    }
+
+    // Keeps the delivery order across classes, e.g. a flush complete must
+    // not overtake the samples of the sensor it was requested for, so the
+    // other class is posted before the event is queued. A full batch is
+    // posted early.
+    template <typename F>
+    void add(const E& event, bool wakeup, F post) {
+        if (!mEvents[!wakeup].empty())
+            flush(!wakeup, post);
+        if (mEvents[wakeup].size() >= MAX_EVENTS)
+            flush(wakeup, post);
+
+        mEvents[wakeup].push_back(event);
+    }
+
+    // At most one of the two is pending, see add()
+    template <typename F>
+    void flush(F post) {
+        flush(false, post);
+        flush(true, post);
+    }
+
+    size_t pending(bool wakeup) const {
+        return mEvents[wakeup].size();
+    }
+
+private:
+    template <typename F>
+    void flush(bool wakeup, F post) {
+        std::vector<E>& events = mEvents[wakeup];
+
+        if (events.empty())
+            return;
+
+        post(events, wakeup);
+        // clear() keeps the capacity
+        events.clear();
+    }
+
+    std::vector<E> mEvents[2];
+};
+
+} // namespace android
+
+#endif // EVENT_BATCH_H_
@@ -1014,7 +1014,7 @@ ssize_t HubConnection::processBuf(uint8_t *buf, size_t len)
     struct nAxisEvent *data = (struct nAxisEvent *)buf;
     uint32_t type, sensor, bias, currSensor;
     int i, numSamples;
-    bool one, rawThree, three;
+    bool one, rawThree, three, compact;
     sensors_event_t ev;
     uint64_t timestamp;
     ssize_t ret = 0;
@@ -1023,8 +1023,9 @@ ssize_t HubConnection::processBuf(uint8_t *buf, size_t len)
     if (len >= sizeof(data->evtType)) {
         ret = sizeof(data->evtType);
         one = three = rawThree = false;
+        compact = data->evtType & HOST_EVT_COMPACT_SENSOR_DATA;
         bias = 0;
-        switch (data->evtType) {
+        switch (data->evtType & ~HOST_EVT_COMPACT_SENSOR_DATA) {
         case SENS_TYPE_TO_EVENT(SENS_TYPE_ACCEL):
             type = SENSOR_TYPE_ACCELEROMETER;
             sensor = COMMS_SENSOR_ACCEL;
@@ -1170,10 +1171,23 @@ ssize_t HubConnection::processBuf(uint8_t *buf, size_t len)
         return -1;
     }
 
+    if (compact && !three) {
+        ALOGW("sensor %d: compact samples are only supported for three axis data\n", sensor);
+        return -1;
+    }
+
     if (len >= sizeof(data->evtType) + sizeof(data->referenceTime) + sizeof(data->firstSample)) {
         ret += sizeof(data->referenceTime);
         timestamp = data->referenceTime;
-        numSamples = data->firstSample.numSamples;
+        numSamples = compact ? 0 : data->firstSample.numSamples;
+
+        if (compact) {
+            ssize_t size = processCompactSamples(data, len, type, sensor, bias);
+
+            if (size < 0)
+                return -1;
+            ret += size;
+        }
 
         for (i=0; i<numSamples; i++) {
             if (data->firstSample.biasPresent && data->firstSample.biasSample == i)
@@ -1214,7 +1228,7 @@ ssize_t HubConnection::processBuf(uint8_t *buf, size_t len)
             }
         }
 
-        if (!numSamples)
+        if (!compact && !numSamples)
             ret += sizeof(data->firstSample);
 
         // If no primary sensor type is specified,
@@ -1253,6 +1267,80 @@ ssize_t HubConnection::processBuf(uint8_t *buf, size_t len)
     return ret;
 }
 
+static bool getVarint(const uint8_t **p, const uint8_t *end, uint32_t *val)
+{
+    uint32_t shift = 0;
+
+    *val = 0;
+    while (*p < end && shift < 32) {
+        uint8_t byte = *(*p)++;
+
+        *val |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return true;
+        shift += 7;
+    }
+
+    return false;
+}
+
+static inline int32_t unzigzag32(uint32_t val)
+{
+    return (int32_t)(val >> 1) ^ -(int32_t)(val & 1);
+}
+
+// Decodes the samples of a HOST_EVT_COMPACT_SENSOR_DATA block, see struct
+// CompactTripleAxisHeader in firmware/inc/hostIntf.h. Returns the number of
+// bytes used after referenceTime.
+ssize_t HubConnection::processCompactSamples(struct nAxisEvent *data, size_t len, uint32_t type, uint32_t sensor, uint32_t bias)
+{
+    const struct CompactThreeAxisHeader &header = data->compactHeader;
+    size_t size = sizeof(data->evtType) + sizeof(data->referenceTime) + sizeof(header);
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(&header + 1);
+    const uint8_t *end;
+    struct ThreeAxisSample sample;
+    uint64_t timestamp = data->referenceTime;
+    uint32_t val, deltaTime = 0, currSensor;
+    int32_t q[3] = { 0, 0, 0 };
+
+    if (len < size || len < size + header.dataLength) {
+        ALOGW("sensor %d (compact): len=%zu, dataLength=%d\n", sensor, len, header.dataLength);
+        return -1;
+    }
+    end = p + header.dataLength;
+
+    for (int i=0; i<header.firstSample.numSamples; i++) {
+        if (i > 0) {
+            if (!getVarint(&p, end, &val))
+                goto truncated;
+            deltaTime += unzigzag32(val);
+            timestamp += ((uint64_t)deltaTime) << delta_time_shift_table[deltaTime & delta_time_encoded];
+        }
+        for (int j=0; j<3; j++) {
+            if (!getVarint(&p, end, &val))
+                goto truncated;
+            q[j] += unzigzag32(val);
+        }
+
+        if (header.firstSample.biasPresent && header.firstSample.biasSample == i)
+            currSensor = bias;
+        else
+            currSensor = sensor;
+
+        sample.deltaTime = deltaTime;
+        sample.x = ldexpf(q[0], header.scaleExp);
+        sample.y = ldexpf(q[1], header.scaleExp);
+        sample.z = ldexpf(q[2], header.scaleExp);
+        processSample(timestamp, type, currSensor, &sample, header.firstSample.highAccuracy);
+    }
+
+    return sizeof(header) + header.dataLength;
+
+truncated:
+    ALOGW("sensor %d (compact): truncated samples, numSamples=%d\n", sensor, header.firstSample.numSamples);
+    return -1;
+}
+
 void HubConnection::sendCalibrationOffsets()
 {
     sp<JSONObject> settings;
@@ -1350,6 +1438,10 @@ bool HubConnection::threadLoop() {
                     else
                         break;
                 }
+
+                // hand everything converted from this read over in one go
+                Mutex::Autolock autoLock(mLock);
+                postPendingEventsLocked();
             } else {
                 ALOGW("read -1: errno=%d\n", errno);
             }
@@ -1365,6 +1457,7 @@ void HubConnection::initConfigCmd(struct ConfigCmd *cmd, int handle)
 
     cmd->evtType = EVT_NO_SENSOR_CONFIG_EVENT;
     cmd->sensorType = mSensorState[handle].sensorType;
+    cmd->flags = CONFIG_FLAGS_COMPACT_SAMPLES;
 
     if (mSensorState[handle].enable) {
         cmd->cmd = CONFIG_CMD_ENABLE;
@@ -1576,6 +1669,14 @@ void HubConnection::postEvents(const std::vector<Event>& events, bool wakeup) {
     mCallback->postEvents(events, std::move(wakelock));
 }
 
+void HubConnection::postPendingEventsLocked() {
+    mPendingEvents.flush([this](const std::vector<Event>& events, bool wakeup) {
+        postEvents(events, wakeup);
+    });
+}
+
+// Events are only converted here; threadLoop() posts them once the whole
+// buffer read from the hub is processed, with one wakelock per class.
 ssize_t HubConnection::write(const sensors_event_t *ev, size_t n) {
     Event event;
     Mutex::Autolock autoLock(mLock);
@@ -1583,10 +1684,11 @@ ssize_t HubConnection::write(const sensors_event_t *ev, size_t n) {
     ssize_t ret = 0;
     //ALOGI("%s, sensor 0x%x, type 0x%x (%d)", __func__, ev->sensor, ev->type, (int) n);
     for (size_t i=0; i<n; i++) {
-        std::vector<Event> events;
         convertFromSensorEvent(ev[i], &event);
-        events.push_back(event);
-        postEvents(events, isWakeEvent(ev[i].sensor));
+        mPendingEvents.add(event, isWakeEvent(ev[i].sensor),
+                [this](const std::vector<Event>& events, bool wakeup) {
+                    postEvents(events, wakeup);
+                });
         memset(&event, 0, sizeof(Event));
     }
 
@@ -32,6 +32,7 @@
 #include <list>
 
 #include "directchannel.h"
+#include "eventbatch.h"
 #include "../../firmware/os/inc/eventnums.h"
 #include "../../firmware/os/inc/halIntf.h"
 #include "hubdefs.h"
@@ -129,6 +130,11 @@ private:
         CONFIG_CMD_CALIBRATE    = 4,
     };
 
+    enum
+    {
+        CONFIG_FLAGS_COMPACT_SAMPLES = 0x0001,
+    };
+
     struct ConfigCmd
     {
         uint32_t evtType;
@@ -189,6 +195,15 @@ private:
         float x, y, z;
     } __attribute__((packed));
 
+    // The following structure should match struct CompactTripleAxisHeader found in
+    // firmware/inc/hostIntf.h; it is followed by dataLength bytes of samples
+    struct CompactThreeAxisHeader
+    {
+        struct FirstSample firstSample;
+        int8_t scaleExp;
+        uint8_t dataLength;
+    } __attribute__((packed));
+
     struct OneAxisSample
     {
         uint32_t deltaTime;
@@ -215,6 +230,7 @@ private:
                     struct OneAxisSample oneSamples[];
                     struct RawThreeAxisSample rawThreeSamples[];
                     struct ThreeAxisSample threeSamples[];
+                    struct CompactThreeAxisHeader compactHeader;
                 };
             };
             uint8_t buffer[];
@@ -228,6 +244,11 @@ private:
     // sensorservice) and the read thread polling from the nanohub driver.
     Mutex mLock;
 
+    // Converted events waiting to be posted, per wakeup class.
+    // Reused across reads so that a FIFO flush does not allocate per sample.
+    static constexpr size_t MAX_PENDING_EVENTS = 128;
+    EventBatch<Event, MAX_PENDING_EVENTS> mPendingEvents;
+
     int32_t mWriteFailures;
 
     float mMagBias[3];
@@ -262,6 +283,8 @@ private:
     void processSample(uint64_t timestamp, uint32_t type, uint32_t sensor, struct RawThreeAxisSample *sample, bool highAccuracy);
     void processSample(uint64_t timestamp, uint32_t type, uint32_t sensor, struct ThreeAxisSample *sample, bool highAccuracy);
     ssize_t processBuf(uint8_t *buf, size_t len);
+    ssize_t processCompactSamples(struct nAxisEvent *data, size_t len, uint32_t type, uint32_t sensor, uint32_t bias);
+    void postPendingEventsLocked();
 
     inline bool isValidHandle(int handle) {
         return handle >= 0
@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Batching of hubconnection2/eventbatch.h, the way HubConnection drives it: write() adds the
+ * converted events of one read from the hub, threadLoop() flushes after the read. Reads of random
+ * length and wakeup class mix go through it; the delivery order, the class of every batch and the
+ * batch boundaries (class change, full batch, end of read) are checked against a model, and so is
+ * that steady state does not allocate.
+ *
+ * The AP CPU time per 1000 samples is reported for the batches and for posting every sample on
+ * its own, as write() did before. The HAL callback is a copy into a queue and there is no
+ * wakelock behind it, so the time is that of HubConnection only; the posts, each with its own
+ * wakelock, are counted as well.
+ *
+ * usage: event_batch_test [reads] [seed]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <new>
+#include <vector>
+
+#include "eventbatch.h"
+
+using namespace android;
+
+#define TEST_DEFAULT_READS      100000
+#define TEST_MAX_EVENTS         128
+#define TEST_MAX_READ_EVENTS    24      //about what a 256 byte read of three-axis samples holds
+#define TEST_BENCH_SAMPLES      1000000
+#define TEST_HAL_QUEUE          1024
+
+#define TEST_CHECK(cond)                                                        \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);     \
+            mFailures++;                                                        \
+        }                                                                       \
+    } while (0)
+
+// as big as V2_1::Event
+struct TestEvent {
+    int64_t timestamp;
+    int32_t sensorHandle;
+    int32_t sensorType;
+    float data[16];
+};
+
+typedef EventBatch<TestEvent, TEST_MAX_EVENTS> TestBatch;
+
+// what reaches the HAL: a copy into a queue, like the event FMQ, and the delivery checked on the way
+struct TestHal {
+    TestEvent queue[TEST_HAL_QUEUE];
+    uint32_t delivered;
+    uint32_t posts;
+    uint32_t bad;
+    uint32_t misordered;
+    uint32_t misclassed;
+
+    void reset() {
+        delivered = posts = bad = misordered = misclassed = 0;
+    }
+
+    void post(const std::vector<TestEvent>& batch, bool wakeup);
+};
+
+static uint32_t mFailures;
+static uint32_t mSeed;
+static uint64_t mAllocs;
+
+void *operator new(size_t size)
+{
+    void *p = malloc(size ? size : 1);
+
+    if (!p)
+        throw std::bad_alloc();
+    mAllocs++;
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+static uint32_t testRand(void)
+{
+    mSeed = mSeed * 1103515245 + 12345;
+    return mSeed >> 8;
+}
+
+static uint64_t testGetCpuTimeNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// mostly non-wakeup samples, now and then a wakeup one
+static bool testWakeup(uint32_t seq)
+{
+    return (seq * 2654435761u) % 16 == 0;
+}
+
+static void testMakeEvent(uint32_t seq, TestEvent *event)
+{
+    memset(event, 0, sizeof(*event));
+    event->timestamp = seq;
+    event->sensorHandle = testWakeup(seq) ? 2 : 1;
+    event->data[0] = (float)seq;
+}
+
+void TestHal::post(const std::vector<TestEvent>& batch, bool wakeup)
+{
+    if (batch.empty() || batch.size() > TEST_MAX_EVENTS)
+        bad++;
+    posts++;
+    for (size_t i = 0; i < batch.size(); i++) {
+        misordered += batch[i].timestamp != delivered;
+        misclassed += wakeup != testWakeup(batch[i].timestamp);
+        queue[delivered++ % TEST_HAL_QUEUE] = batch[i];
+    }
+}
+
+// posts the model expects for one read: one per run of a class, and one more per full batch
+static uint32_t testExpectedPosts(uint32_t first, uint32_t count)
+{
+    uint32_t i, posts = 0, run = 0;
+
+    for (i = 0; i < count; i++) {
+        if (run && testWakeup(first + i) == testWakeup(first + i - 1) && run < TEST_MAX_EVENTS) {
+            run++;
+            continue;
+        }
+        posts++;
+        run = 1;
+    }
+
+    return posts;
+}
+
+static void testRead(TestBatch *batch, TestHal *hal, uint32_t first, uint32_t count)
+{
+    auto post = [hal](const std::vector<TestEvent>& events, bool wakeup) {
+        hal->post(events, wakeup);
+    };
+    TestEvent event;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        testMakeEvent(first + i, &event);
+        batch->add(event, testWakeup(first + i), post);
+    }
+    batch->flush(post);
+}
+
+static void testCheckDelivered(const TestHal *hal, uint32_t count)
+{
+    TEST_CHECK(hal->delivered == count);
+    TEST_CHECK(hal->bad == 0);
+    TEST_CHECK(hal->misordered == 0);
+    TEST_CHECK(hal->misclassed == 0);
+}
+
+// reads of random length, each one posted at its end
+static void testStress(uint32_t reads)
+{
+    static TestHal hal;
+    TestBatch batch;
+    uint32_t i, seq = 0, posts = 0;
+    uint64_t allocs;
+
+    hal.reset();
+
+    allocs = mAllocs;
+    for (i = 0; i < reads; i++) {
+        uint32_t count = 1 + testRand() % TEST_MAX_READ_EVENTS;
+
+        testRead(&batch, &hal, seq, count);
+        posts += testExpectedPosts(seq, count);
+        seq += count;
+
+        TEST_CHECK(batch.pending(false) == 0 && batch.pending(true) == 0);
+    }
+    allocs = mAllocs - allocs;
+
+    testCheckDelivered(&hal, seq);
+    TEST_CHECK(hal.posts == posts);
+    TEST_CHECK(allocs == 0);
+
+    printf("stress    : %u reads, %u events, %u posts, %llu allocations\n", reads, seq, hal.posts,
+            (unsigned long long)allocs);
+}
+
+// a read bigger than a batch, e.g. a FIFO flush, is posted in full batches
+static void testFullBatch(void)
+{
+    static TestHal hal;
+    TestBatch batch;
+    TestEvent event;
+    uint32_t i;
+
+    hal.reset();
+
+    // one class only, so that it never changes
+    for (i = 0; i < 2 * TEST_MAX_EVENTS + 44; i++) {
+        testMakeEvent(i, &event);
+        batch.add(event, false, [](const std::vector<TestEvent>& events, bool wakeup) {
+            hal.post(events, wakeup);
+        });
+    }
+
+    TEST_CHECK(hal.posts == 2);
+    TEST_CHECK(batch.pending(false) == 44);
+    batch.flush([](const std::vector<TestEvent>& events, bool wakeup) {
+        hal.post(events, wakeup);
+    });
+    TEST_CHECK(hal.posts == 3);
+    TEST_CHECK(batch.pending(false) == 0);
+
+    // an empty batch is not posted
+    batch.flush([](const std::vector<TestEvent>& events, bool wakeup) {
+        hal.post(events, wakeup);
+    });
+    TEST_CHECK(hal.posts == 3);
+    TEST_CHECK(hal.delivered == 2 * TEST_MAX_EVENTS + 44);
+    TEST_CHECK(hal.bad == 0 && hal.misordered == 0);
+}
+
+// AP CPU time per 1000 samples, the same reads posted per sample and in batches
+static void testBench(void)
+{
+    static TestHal hal;
+    TestBatch batch;
+    TestEvent event;
+    uint32_t i, seq, count;
+    uint64_t start, singleNs, batchNs, singleAllocs, batchAllocs;
+    uint32_t singlePosts, batchPosts;
+
+    hal.reset();
+    mSeed = 1;
+    start = testGetCpuTimeNs();
+    singleAllocs = mAllocs;
+    for (seq = 0; seq < TEST_BENCH_SAMPLES; seq += count) {
+        count = 1 + testRand() % TEST_MAX_READ_EVENTS;
+        for (i = 0; i < count; i++) {
+            std::vector<TestEvent> events;
+
+            testMakeEvent(seq + i, &event);
+            events.push_back(event);
+            hal.post(events, testWakeup(seq + i));
+        }
+    }
+    singleAllocs = mAllocs - singleAllocs;
+    singleNs = testGetCpuTimeNs() - start;
+    singlePosts = hal.posts;
+    testCheckDelivered(&hal, seq);
+
+    hal.reset();
+    mSeed = 1;
+    start = testGetCpuTimeNs();
+    batchAllocs = mAllocs;
+    for (seq = 0; seq < TEST_BENCH_SAMPLES; seq += count) {
+        count = 1 + testRand() % TEST_MAX_READ_EVENTS;
+        testRead(&batch, &hal, seq, count);
+    }
+    batchAllocs = mAllocs - batchAllocs;
+    batchNs = testGetCpuTimeNs() - start;
+    batchPosts = hal.posts;
+    testCheckDelivered(&hal, seq);
+
+    printf("per sample: %llu ns cpu, %llu posts and wakelocks, %llu allocations per 1000 samples\n",
+            (unsigned long long)(singleNs * 1000 / seq), (unsigned long long)singlePosts * 1000 / seq,
+            (unsigned long long)singleAllocs * 1000 / seq);
+    printf("batched   : %llu ns cpu, %llu posts and wakelocks, %llu allocations per 1000 samples\n",
+            (unsigned long long)(batchNs * 1000 / seq), (unsigned long long)batchPosts * 1000 / seq,
+            (unsigned long long)batchAllocs * 1000 / seq);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t reads = (argc > 1) ? strtoul(argv[1], NULL, 0) : TEST_DEFAULT_READS;
+
+    mSeed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 1;
+
+    testFullBatch();
+    testStress(reads);
+    testBench();
+
+    printf("event_batch_test: %s (%u failed checks)\n", mFailures ? "FAIL" : "PASS", mFailures);
+
+    return mFailures ? 1 : 0;
+}
@@ -17059,8 +17059,17 @@ status_t ExynosCamera::m_copyPreview2Callback(ExynosCameraFrameSP_sptr_t frame,
             m_previewCallbackPP = ExynosCameraPPFactory::newPP(m_cameraId, m_configurations, m_parameters[m_cameraId], PREVIEW_GSC_NODE_NUM);
 
             ret = m_previewCallbackPP->create();
+            if (ret != NO_ERROR) {
+                CLOGW("m_previewCallbackPP(%s)->create() fail. so, fall back to ExynosCameraPPSW",
+                        m_previewCallbackPP->getName());
+                SAFE_DELETE(m_previewCallbackPP);
+
+                m_previewCallbackPP = ExynosCameraPPFactory::newSWPP(m_cameraId, m_configurations, m_parameters[m_cameraId], PREVIEW_GSC_NODE_NUM);
+                ret = m_previewCallbackPP->create();
+            }
             if (ret != NO_ERROR) {
                 CLOGE("m_previewCallbackPP->create() fail");
+                SAFE_DELETE(m_previewCallbackPP);
                 goto done;
             }
         }
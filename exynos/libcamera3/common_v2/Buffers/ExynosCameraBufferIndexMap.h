@@ -0,0 +1,146 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file      ExynosCameraBufferIndexMap.h
+ * \brief     header file for ExynosCameraBufferIndexMap
+ *
+ */
+
+#ifndef EXYNOS_CAMERA_BUFFER_INDEX_MAP_H__
+#define EXYNOS_CAMERA_BUFFER_INDEX_MAP_H__
+
+#include <stdint.h>
+
+namespace android {
+
+/*
+ * Open addressed map from a buffer key (FD) to a buffer index.
+ * Collisions are resolved by linear probing and erase shifts the following
+ * entries back, so the table never holds tombstones.
+ * The map is only a hint: callers check the returned index against the buffer
+ * itself, and fall back to a scan when the map is full or out of date.
+ */
+class ExynosCameraBufferIndexMap {
+public:
+    ExynosCameraBufferIndexMap()
+    {
+        clear();
+    }
+
+    void clear(void)
+    {
+        for (int i = 0; i < INDEX_MAP_SIZE; i++) {
+            m_key[i] = 0;
+            m_index[i] = INDEX_MAP_EMPTY;
+        }
+        m_count = 0;
+    }
+
+    /* returns false if the map is full */
+    bool insert(uintptr_t key, int index)
+    {
+        uint32_t slot = m_hash(key);
+
+        while (m_index[slot] != INDEX_MAP_EMPTY) {
+            if (m_key[slot] == key) {
+                m_index[slot] = index;
+                return true;
+            }
+            slot = (slot + 1) & (INDEX_MAP_SIZE - 1);
+        }
+
+        /* keep one slot empty so that probing always ends */
+        if (m_count >= INDEX_MAP_SIZE - 1)
+            return false;
+
+        m_key[slot] = key;
+        m_index[slot] = index;
+        m_count++;
+
+        return true;
+    }
+
+    void erase(uintptr_t key)
+    {
+        uint32_t slot = m_hash(key);
+        uint32_t next;
+
+        while (m_index[slot] != INDEX_MAP_EMPTY && m_key[slot] != key)
+            slot = (slot + 1) & (INDEX_MAP_SIZE - 1);
+
+        if (m_index[slot] == INDEX_MAP_EMPTY)
+            return;
+
+        /* move back every following entry whose home slot is not between the hole and itself */
+        next = slot;
+        while (1) {
+            next = (next + 1) & (INDEX_MAP_SIZE - 1);
+            if (m_index[next] == INDEX_MAP_EMPTY)
+                break;
+
+            uint32_t home = m_hash(m_key[next]);
+            if (((next - home) & (INDEX_MAP_SIZE - 1)) >= ((next - slot) & (INDEX_MAP_SIZE - 1))) {
+                m_key[slot] = m_key[next];
+                m_index[slot] = m_index[next];
+                slot = next;
+            }
+        }
+
+        m_key[slot] = 0;
+        m_index[slot] = INDEX_MAP_EMPTY;
+        m_count--;
+    }
+
+    /* returns -1 if the key is not in the map */
+    int find(uintptr_t key)
+    {
+        uint32_t slot = m_hash(key);
+
+        while (m_index[slot] != INDEX_MAP_EMPTY) {
+            if (m_key[slot] == key)
+                return m_index[slot];
+            slot = (slot + 1) & (INDEX_MAP_SIZE - 1);
+        }
+
+        return INDEX_MAP_EMPTY;
+    }
+
+private:
+    enum {
+        /* power of 2, m_hash() returns INDEX_MAP_BITS bits */
+        INDEX_MAP_BITS  = 8,
+        INDEX_MAP_SIZE  = 1 << INDEX_MAP_BITS,
+        INDEX_MAP_EMPTY = -1,
+    };
+
+    uint32_t m_hash(uintptr_t key)
+    {
+        uint64_t value = (uint64_t)key;
+
+        value ^= value >> 32;
+        return ((uint32_t)value * 0x9E3779B1U) >> (32 - INDEX_MAP_BITS);
+    }
+
+private:
+    uintptr_t   m_key[INDEX_MAP_SIZE];
+    int         m_index[INDEX_MAP_SIZE];
+    int         m_count;
+};
+
+}; /* namespace android */
+
+#endif
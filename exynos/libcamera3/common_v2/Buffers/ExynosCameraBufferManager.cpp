@@ -524,19 +524,54 @@ status_t ExynosCameraBufferManager::getStatus(
 
 status_t ExynosCameraBufferManager::getIndexByFd(int fd, int *index)
 {
+    return m_getIndexByFd(m_buffer, fd, index);
+}
+
+/*
+ * The FD map is filled on allocation, but a buffer can drop or change its FD
+ * without going through m_defaultFree() (ex. buffer container), so the mapped
+ * index is used only if the buffer still owns the FD. Otherwise it is looked up
+ * again and the map is fixed.
+ */
+status_t ExynosCameraBufferManager::m_getIndexByFd(struct ExynosCameraBuffer *buffer, int fd, int *index)
+{
+    int bufIndex;
+
     if (fd < 0) {
         CLOGE("Invalid FD %d", fd);
         return BAD_VALUE;
     }
 
+    Mutex::Autolock lock(m_indexMapLock);
+
     *index = -1;
-    for (int bufIndex = m_indexOffset; bufIndex < m_reqBufCount + m_indexOffset; bufIndex++) {
-        if (m_buffer[bufIndex].fd[0] == fd) {
-            *index = bufIndex;
-            break;
+    bufIndex = m_fdIndexMap.find((uintptr_t)fd);
+    if (m_indexOffset <= bufIndex && bufIndex < m_reqBufCount + m_indexOffset
+        && buffer[bufIndex].fd[0] == fd) {
+        *index = bufIndex;
+    } else {
+        m_fdIndexMap.erase((uintptr_t)fd);
+
+        for (bufIndex = m_indexOffset; bufIndex < m_reqBufCount + m_indexOffset; bufIndex++) {
+            if (buffer[bufIndex].fd[0] == fd) {
+                *index = bufIndex;
+                m_fdIndexMap.insert((uintptr_t)fd, bufIndex);
+                break;
+            }
         }
     }
 
+#ifdef EXYNOS_CAMERA_BUFFER_INDEX_CHECK
+    for (bufIndex = m_indexOffset; bufIndex < m_reqBufCount + m_indexOffset; bufIndex++) {
+        if (buffer[bufIndex].fd[0] == fd)
+            break;
+    }
+    if (bufIndex == m_reqBufCount + m_indexOffset)
+        bufIndex = -1;
+    if (bufIndex != *index)
+        CLOGE("FD %d is mapped to buffer %d, but scan finds buffer %d", fd, *index, bufIndex);
+#endif
+
     if (*index < 0 || *index > m_allowedMaxBufCount + m_indexOffset) {
         CLOGE("Invalid buffer index %d. fd %d", *index, fd);
 
@@ -547,6 +582,27 @@ status_t ExynosCameraBufferManager::getIndexByFd(int fd, int *index)
     return NO_ERROR;
 }
 
+void ExynosCameraBufferManager::m_mapIndexByFd(int fd, int index)
+{
+    Mutex::Autolock lock(m_indexMapLock);
+
+    if (fd < 0)
+        return;
+
+    if (m_fdIndexMap.insert((uintptr_t)fd, index) == false)
+        CLOGW("FD map is full. fd %d index %d", fd, index);
+}
+
+void ExynosCameraBufferManager::m_unmapIndexByFd(int fd)
+{
+    Mutex::Autolock lock(m_indexMapLock);
+
+    if (fd < 0)
+        return;
+
+    m_fdIndexMap.erase((uintptr_t)fd);
+}
+
 bool ExynosCameraBufferManager::isAllocated(void)
 {
     return m_flagAllocated;
@@ -872,6 +928,9 @@ status_t ExynosCameraBufferManager::m_defaultAlloc(int bIndex, int eIndex, bool
             }
         }
 
+        if (isMetaPlane == false)
+            m_mapIndexByFd(m_buffer[bufIndex].fd[0], bufIndex);
+
         if (updateStatus(
                 bufIndex,
                 0,
@@ -946,6 +1005,9 @@ status_t ExynosCameraBufferManager::m_defaultFree(int bIndex, int eIndex, bool i
             planeIndexEnd   = m_buffer[bufIndex].getMetaPlaneIndex();
         }
 
+        if (isMetaPlane == false)
+            m_unmapIndexByFd(m_buffer[bufIndex].fd[0]);
+
         for (int planeIndex = planeIndexStart; planeIndex < planeIndexEnd; planeIndex++) {
             if (m_defaultAllocator->free(
                     m_buffer[bufIndex].size[planeIndex],
@@ -2025,6 +2087,8 @@ status_t ServiceExynosCameraBufferManager::putBuffer(
         goto func_exit;
     }
 
+    m_unmapIndexByFd(m_buffer[bufIndex].fd[0]);
+
     /* Clear Image Plane Information */
     totalPlaneCount = m_getTotalPlaneCount(m_buffer[bufIndex].planeCount,
                                            m_buffer[bufIndex].batchSize,
@@ -2253,6 +2317,8 @@ loop_continue:
         }
     }
 
+    m_mapIndexByFd(m_buffer[bufferIndex].fd[0], bufferIndex);
+
     if (m_buffer[bufferIndex].batchSize > 1) {
         ret = m_constructBufferContainer(bufferIndex);
         if (ret != NO_ERROR) {
@@ -3020,27 +3086,7 @@ status_t SWExynosCameraBufferManager::getStatus(
 
 status_t SWExynosCameraBufferManager::getIndexByFd(int fd, int *index)
 {
-    if (fd < 0) {
-        CLOGE("Invalid FD %d", fd);
-        return BAD_VALUE;
-    }
-
-    *index = -1;
-    for (int bufIndex = m_indexOffset; bufIndex < m_reqBufCount + m_indexOffset; bufIndex++) {
-        if (m_swBuffer[bufIndex].fd[0] == fd) {
-            *index = bufIndex;
-            break;
-        }
-    }
-
-    if (*index < 0 || *index > m_allowedMaxBufCount + m_indexOffset) {
-        CLOGE("Invalid buffer index %d. fd %d", *index, fd);
-
-        *index = -1;
-        return INVALID_OPERATION;
-    }
-
-    return NO_ERROR;
+    return m_getIndexByFd(m_swBuffer, fd, index);
 }
 
 bool SWExynosCameraBufferManager::isAvaliable(int bufIndex)
@@ -3324,6 +3370,9 @@ status_t SWExynosCameraBufferManager::m_defaultAlloc(int bIndex, int eIndex, boo
             }
         }
 
+        if (isMetaPlane == false)
+            m_mapIndexByFd(m_swBuffer[bufIndex].fd[0], bufIndex);
+
         if (updateStatus(
                 bufIndex,
                 0,
@@ -3399,6 +3448,9 @@ status_t SWExynosCameraBufferManager::m_defaultFree(int bIndex, int eIndex, bool
             planeIndexEnd   = m_swBuffer[bufIndex].getMetaPlaneIndex();
         }
 
+        if (isMetaPlane == false)
+            m_unmapIndexByFd(m_swBuffer[bufIndex].fd[0]);
+
         for (int planeIndex = planeIndexStart; planeIndex < planeIndexEnd; planeIndex++) {
             if (m_defaultAllocator->free(
                     m_swBuffer[bufIndex].size[planeIndex],
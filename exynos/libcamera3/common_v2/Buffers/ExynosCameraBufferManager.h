@@ -46,6 +46,7 @@
 #include "ExynosCameraList.h"
 #include "ExynosCameraAutoTimer.h"
 #include "ExynosCameraBuffer.h"
+#include "ExynosCameraBufferIndexMap.h"
 #include "ExynosCameraMemory.h"
 #include "ExynosCameraThread.h"
 
@@ -53,6 +54,7 @@ namespace android {
 
 /* #define DUMP_2_FILE */
 /* #define EXYNOS_CAMERA_BUFFER_TRACE */
+/* #define EXYNOS_CAMERA_BUFFER_INDEX_CHECK */
 
 #ifdef EXYNOS_CAMERA_BUFFER_TRACE
 #define EXYNOS_CAMERA_BUFFER_IN()   CLOGD("IN..")
@@ -208,6 +210,9 @@ protected:
     virtual bool     m_checkInfoForAlloc(void);
     status_t         m_createDefaultAllocator(bool isCached = false);
     int              m_getTotalPlaneCount(int planeCount, int batchSize, bool hasMetaPlane);
+    status_t         m_getIndexByFd(struct ExynosCameraBuffer *buffer, int fd, int *index);
+    void             m_mapIndexByFd(int fd, int index);
+    void             m_unmapIndexByFd(int fd);
 
     virtual void     m_resetSequenceQ(void);
 
@@ -239,6 +244,10 @@ protected:
 
     buffer_manager_allocation_mode_t m_allocMode;
     int                         m_indexOffset;
+
+    /* FD of the first plane to buffer index */
+    ExynosCameraBufferIndexMap  m_fdIndexMap;
+    mutable Mutex               m_indexMapLock;
 };
 
 class InternalExynosCameraBufferManager : public ExynosCameraBufferManager {
@@ -23,12 +23,41 @@
 
 namespace android {
 
+/*
+ * Frames are recycled at the request rate, each with one entity per pipe.
+ * The slabs grow on demand and keep their chunks, so the retained memory
+ * is bounded by the peak number of frames and entities alive at once.
+ */
+#define FRAME_SLAB_CHUNK_SLOTS      (32)
+#define FRAME_SLAB_MAX_CHUNKS       (16)
+#define ENTITY_SLAB_CHUNK_SLOTS     (128)
+#define ENTITY_SLAB_MAX_CHUNKS      (48)
+
 #ifdef DEBUG_FRAME_MEMORY_LEAK
 unsigned long long ExynosCameraFrame::m_checkLeakCount;
 unsigned long long ExynosCameraFrame::m_checkLeakFrameCount;
 Mutex ExynosCameraFrame::m_countLock;
 #endif
 
+ExynosCameraObjectSlab<ExynosCameraFrame> *ExynosCameraFrame::getSlab(void)
+{
+    /* never destroyed, frames may still be released during static destruction */
+    static ExynosCameraObjectSlab<ExynosCameraFrame> *slab =
+        new ExynosCameraObjectSlab<ExynosCameraFrame>(FRAME_SLAB_CHUNK_SLOTS, FRAME_SLAB_MAX_CHUNKS);
+
+    return slab;
+}
+
+void *ExynosCameraFrame::operator new(size_t size)
+{
+    return getSlab()->alloc(size);
+}
+
+void ExynosCameraFrame::operator delete(void *ptr)
+{
+    getSlab()->release(ptr);
+}
+
 ExynosCameraFrame::ExynosCameraFrame(
         int cameraId,
         ExynosCameraConfigurations *configurations,
@@ -2501,6 +2530,24 @@ bool ExynosCameraFrame::getNeedDynamicBayer(void)
  * ExynosCameraFrameEntity class
  */
 
+ExynosCameraObjectSlab<ExynosCameraFrameEntity> *ExynosCameraFrameEntity::getSlab(void)
+{
+    static ExynosCameraObjectSlab<ExynosCameraFrameEntity> *slab =
+        new ExynosCameraObjectSlab<ExynosCameraFrameEntity>(ENTITY_SLAB_CHUNK_SLOTS, ENTITY_SLAB_MAX_CHUNKS);
+
+    return slab;
+}
+
+void *ExynosCameraFrameEntity::operator new(size_t size)
+{
+    return getSlab()->alloc(size);
+}
+
+void ExynosCameraFrameEntity::operator delete(void *ptr)
+{
+    getSlab()->release(ptr);
+}
+
 ExynosCameraFrameEntity::ExynosCameraFrameEntity(
         uint32_t pipeId,
         entity_type_t type,
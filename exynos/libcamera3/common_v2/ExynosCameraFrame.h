@@ -26,6 +26,7 @@
 #include "ExynosCameraBuffer.h"
 #include "ExynosCameraList.h"
 #include "ExynosCameraNode.h"
+#include "ExynosCameraObjectSlab.h"
 
 typedef ExynosCameraList<uint32_t> frame_key_queue_t;
 
@@ -198,6 +199,12 @@ public:
         uint32_t pipeId,
         entity_type_t type,
         entity_buffer_type_t bufType);
+
+    /* entities are recycled through a slab instead of the heap */
+    static void *operator new(size_t size);
+    static void  operator delete(void *ptr);
+    static ExynosCameraObjectSlab<ExynosCameraFrameEntity> *getSlab(void);
+
     uint32_t getPipeId(void);
 
     status_t setSrcBuf(ExynosCameraBuffer buf, uint32_t nodeIndex = 0);
@@ -331,6 +338,11 @@ private:
     ~ExynosCameraFrame();
 
 public:
+    /* frames are recycled through a slab instead of the heap */
+    static void *operator new(size_t size);
+    static void  operator delete(void *ptr);
+    static ExynosCameraObjectSlab<ExynosCameraFrame> *getSlab(void);
+
     /* If curEntity is NULL, newEntity is added to m_linkageList */
     status_t        addSiblingEntity(
                         ExynosCameraFrameEntity *curEntity,
@@ -1361,6 +1361,12 @@ ExynosCameraFrameSP_sptr_t ExynosCameraFrameManager::m_createFrame(ExynosCameraC
 status_t ExynosCameraFrameManager::dump()
 {
     status_t ret = FRAMEMGR_ERRCODE::OK;
+    ExynosCameraObjectSlab<ExynosCameraFrame> *frameSlab = ExynosCameraFrame::getSlab();
+    ExynosCameraObjectSlab<ExynosCameraFrameEntity> *entitySlab = ExynosCameraFrameEntity::getSlab();
+
+    CLOGI("frame slab inUse(%d) slots(%d) fallback(%d), entity slab inUse(%d) slots(%d) fallback(%d)",
+            frameSlab->getNumInUse(), frameSlab->getNumSlots(), frameSlab->getNumFallback(),
+            entitySlab->getNumInUse(), entitySlab->getNumSlots(), entitySlab->getNumFallback());
 
     return ret;
 }
@@ -22,8 +22,90 @@
 
 #define FLASHED_LLS_COUNT 4
 
+/* weights of ExynosCameraFrameScorePolicyDefault */
+#define SCORE_AF_FOCUSED            (4000)
+#define SCORE_AF_INACTIVE           (2000)
+#define SCORE_AF_UNFOCUSED          (-2000)
+#define SCORE_AE_CONVERGED          (2000)
+#define SCORE_AE_OTHERS             (1000)
+#define SCORE_EXPOSURE_CHANGED      (-1000)
+#define SCORE_EXPOSURE_CHANGE_RATIO (10)    /* % */
+#define SCORE_BLUR_DIVIDER          (10)    /* urad of the blur per a score */
+#define SCORE_GMV_PENALTY           (50)    /* per a pixel of the GMV */
+#define SCORE_TIME_PER_MS           (20)
+
 namespace android {
 
+static bool isScoreExposureChanged(uint64_t value, uint64_t prevValue)
+{
+    uint64_t diff = (value > prevValue) ? (value - prevValue) : (prevValue - value);
+
+    if (prevValue == 0)
+        return false;
+
+    return (diff * 100 > prevValue * SCORE_EXPOSURE_CHANGE_RATIO);
+}
+
+int64_t ExynosCameraFrameScorePolicyDefault::score(const frame_score_meta_t *meta,
+                                                   const frame_score_meta_t *prevMeta)
+{
+    int64_t score = 0;
+    float angularSpeed = 0.0f;
+    int64_t blur = 0;
+
+    switch (meta->afState) {
+    case AA_AFSTATE_PASSIVE_FOCUSED:
+    case AA_AFSTATE_FOCUSED_LOCKED:
+        score += SCORE_AF_FOCUSED;
+        break;
+    case AA_AFSTATE_INACTIVE:
+        score += SCORE_AF_INACTIVE;
+        break;
+    case AA_AFSTATE_NOT_FOCUSED_LOCKED:
+    case AA_AFSTATE_PASSIVE_UNFOCUSED:
+        score += SCORE_AF_UNFOCUSED;
+        break;
+    default:
+        /* scanning */
+        break;
+    }
+
+    switch (meta->aeState) {
+    case AE_STATE_CONVERGED:
+    case AE_STATE_LOCKED:
+    case AE_STATE_LOCKED_CONVERGED:
+        score += SCORE_AE_CONVERGED;
+        break;
+    case AE_STATE_SEARCHING:
+    case AE_STATE_SEARCHING_FLASH_REQUIRED:
+        break;
+    default:
+        score += SCORE_AE_OTHERS;
+        break;
+    }
+
+    /* the exposure is still moving */
+    if (prevMeta != NULL
+        && (isScoreExposureChanged(meta->exposureTime, prevMeta->exposureTime) == true
+            || isScoreExposureChanged(meta->sensitivity, prevMeta->sensitivity) == true)) {
+        score += SCORE_EXPOSURE_CHANGED;
+    }
+
+    /* rad/s x ns / 1000 = urad, the angle the camera turns while the exposure */
+    angularSpeed = sqrtf(meta->gyro[0] * meta->gyro[0]
+                         + meta->gyro[1] * meta->gyro[1]
+                         + meta->gyro[2] * meta->gyro[2]);
+    blur = (int64_t)(angularSpeed * (float)meta->exposureTime / 1000.0f);
+    score -= blur / SCORE_BLUR_DIVIDER;
+
+    score -= (int64_t)(abs(meta->gmvX) + abs(meta->gmvY)) * SCORE_GMV_PENALTY;
+
+    /* the distance from the shutter */
+    score += (int64_t)(meta->timeStamp / 1000000) * SCORE_TIME_PER_MS;
+
+    return score;
+}
+
 ExynosCameraFrameSelector::ExynosCameraFrameSelector(int cameraId,
                                                      ExynosCameraConfigurations *configurations,
                                                      ExynosCameraParameters *param,
@@ -67,6 +149,11 @@ ExynosCameraFrameSelector::ExynosCameraFrameSelector(int cameraId,
     memset(m_name, 0x00, sizeof(m_name));
     m_state = STATE_BASE;
     m_selectorId = SELECTOR_ID_BASE;
+
+    m_flagScoreSelect = property_get_bool("vendor.camera.selector.score", false);
+    m_scorePolicy = &m_defaultScorePolicy;
+    memset(&m_lastScoreMeta, 0x00, sizeof(m_lastScoreMeta));
+    m_hasLastScoreMeta = false;
 }
 
 ExynosCameraFrameSelector::~ExynosCameraFrameSelector()
@@ -79,6 +166,8 @@ status_t ExynosCameraFrameSelector::m_release(frame_queue_t *list)
     int ret = 0;
     ExynosCameraFrameSP_sptr_t frame = NULL;
 
+    m_clearScore(list);
+
     while (list->getSizeOfProcessQ() > 0) {
         ret = m_popQ(list, frame, true, 1);
         if (ret != NO_ERROR) {
@@ -103,6 +192,10 @@ status_t ExynosCameraFrameSelector::manageFrameHoldListForDynamicBayer(ExynosCam
         return BAD_VALUE;
     }
 
+    /* not scored, and it may be out of the frameCount order of the scored ones */
+    if (m_flagScoreSelect == true)
+        m_clearScore(&m_frameHoldList);
+
     m_pushQ(&m_frameHoldList, frame, true);
     CLOGI(" [F%d T%d] m_frameHoldList size(%d)",
             frame->getFrameCount(), frame->getFrameType(), m_frameHoldList.getSizeOfProcessQ());
@@ -390,6 +483,8 @@ status_t ExynosCameraFrameSelector::m_clearList(frame_queue_t *list)
         return INVALID_OPERATION;
     }
 
+    m_clearScore(list);
+
     while (list->getSizeOfProcessQ() > 0) {
         if (m_popQ(list, frame, false, 1) != NO_ERROR) {
             CLOGE("getBufferToManageQ fail");
@@ -468,4 +563,91 @@ ExynosCameraFrameSelector::SELECTOR_ID_t ExynosCameraFrameSelector::getId(void)
 {
     return m_selectorId;
 }
+
+void ExynosCameraFrameSelector::setScorePolicy(ExynosCameraFrameScorePolicy *policy)
+{
+    Mutex::Autolock lock(m_listLock);
+
+    /* the held frames keep the scores of the previous policy */
+    m_scorePolicy = (policy != NULL) ? policy : &m_defaultScorePolicy;
+}
+
+void ExynosCameraFrameSelector::m_getScoreMeta(ExynosCameraFrameSP_sptr_t frame, frame_score_meta_t *meta)
+{
+    const struct camera2_shot_ext *shot_ext = frame->getConstMeta();
+
+    memset(meta, 0x00, sizeof(frame_score_meta_t));
+
+    meta->frameCount = frame->getFrameCount();
+    meta->timeStamp = shot_ext->shot.dm.sensor.timeStamp;
+    meta->afState = shot_ext->shot.dm.aa.afState;
+    meta->aeState = shot_ext->shot.dm.aa.aeState;
+    meta->exposureTime = shot_ext->shot.dm.sensor.exposureTime;
+    meta->sensitivity = shot_ext->shot.dm.sensor.sensitivity;
+    meta->gyro[0] = shot_ext->shot.udm.aa.gyroInfo.x;
+    meta->gyro[1] = shot_ext->shot.udm.aa.gyroInfo.y;
+    meta->gyro[2] = shot_ext->shot.udm.aa.gyroInfo.z;
+#ifdef SUPPORT_GMV
+    meta->gmvX = shot_ext->shot.uctl.gmvUd.gmX;
+    meta->gmvY = shot_ext->shot.uctl.gmvUd.gmY;
+#endif
+}
+
+/* m_listLock is held by the caller, and the frame was just pushed to m_frameHoldList */
+void ExynosCameraFrameSelector::m_pushScore(ExynosCameraFrameSP_sptr_t frame)
+{
+    frame_score_meta_t meta;
+    int64_t score = 0;
+
+    m_getScoreMeta(frame, &meta);
+
+    score = m_scorePolicy->score(&meta, (m_hasLastScoreMeta == true) ? &m_lastScoreMeta : NULL);
+    m_scoreHeap.push(&m_frameHoldList, score, meta.frameCount);
+
+    m_lastScoreMeta = meta;
+    m_hasLastScoreMeta = true;
+
+    CLOGV("[F%d] score(%jd) AF(%d) AE(%d) exposure(%ju) sensitivity(%d)",
+            meta.frameCount, (intmax_t)score, meta.afState, meta.aeState,
+            (uintmax_t)meta.exposureTime, meta.sensitivity);
+}
+
+/* m_listLock is held by the caller */
+void ExynosCameraFrameSelector::m_removeScore(ExynosCameraFrameSP_sptr_t frame)
+{
+    m_scoreHeap.remove(frame->getFrameCount());
+}
+
+void ExynosCameraFrameSelector::m_clearScore(frame_queue_t *list)
+{
+    if (list != &m_frameHoldList)
+        return;
+
+    Mutex::Autolock lock(m_listLock);
+
+    m_scoreHeap.clear();
+    m_hasLastScoreMeta = false;
+}
+
+/*
+ * Pops the frame of the best score from the list.
+ * The entries of the frames which left the list in the other ways are dropped here.
+ * It returns NULL if no scored frame is in the list.
+ */
+ExynosCameraFrameSP_sptr_t ExynosCameraFrameSelector::m_popBestFrame(frame_queue_t *list)
+{
+    ExynosCameraFrameSP_sptr_t selectedFrame = NULL;
+    uint32_t frameCount = 0;
+    int64_t score = 0;
+
+    Mutex::Autolock lock(m_listLock);
+
+    selectedFrame = m_scoreHeap.popBest(list, &frameCount, &score);
+    if (selectedFrame != NULL) {
+        CLOGD("[F%d] selected by score(%jd), remains(%d)",
+                frameCount, (intmax_t)score, list->getSizeOfProcessQ());
+    }
+
+    return selectedFrame;
+}
 }
@@ -37,6 +37,229 @@ namespace android{
 
 using namespace std;
 
+#define FRAME_SCORE_HEAP_SIZE   (16)
+
+/* the metadata of a held frame, which is scored once when the frame comes in */
+typedef struct frame_score_meta {
+    uint32_t    frameCount;
+    uint64_t    timeStamp;      /* ns */
+    int         afState;        /* enum aa_afstate */
+    int         aeState;        /* enum ae_state */
+    uint64_t    exposureTime;   /* ns */
+    uint32_t    sensitivity;
+    float       gyro[3];        /* rad/s */
+    int         gmvX;           /* pixel, 0 without SUPPORT_GMV */
+    int         gmvY;
+} frame_score_meta_t;
+
+/*
+ * ExynosCameraFrameScorePolicy
+ *
+ * Scores a frame of the ZSL hold list. The higher is the better.
+ * The shutter comes after all the held frames, so the distance from the shutter
+ * is (shutter - timeStamp), and only the timeStamp differs between the frames.
+ * So the policy folds the distance into the score as a term of the timeStamp,
+ * and the frames are never scored again on the selection.
+ */
+class ExynosCameraFrameScorePolicy {
+public:
+    virtual ~ExynosCameraFrameScorePolicy() {}
+
+    /* prevMeta is the previous held frame, NULL for the first one */
+    virtual int64_t score(const frame_score_meta_t *meta, const frame_score_meta_t *prevMeta) = 0;
+};
+
+/*
+ * AF settled, AE converged with the stable exposure, less motion blur
+ * (gyro x exposure time, GMV) and closer to the shutter.
+ */
+class ExynosCameraFrameScorePolicyDefault : public ExynosCameraFrameScorePolicy {
+public:
+    virtual int64_t score(const frame_score_meta_t *meta, const frame_score_meta_t *prevMeta);
+};
+
+/*
+ * ExynosCameraFrameScoreHeap
+ *
+ * Max-heap of the scores of the frames held in an ExynosCameraList. The key is the frameCount.
+ * Each entry keeps the position of its frame in the list, so popBest() takes the frame out
+ * without looking for it in the list.
+ * The frames leave the list from the front, but for the ones taken by popBest(), and the
+ * entries are pushed in the frameCount order (push() drops the entries out of the order).
+ * So an entry older than the front of the list is of a frame which has left it, and it is
+ * dropped without touching its position.
+ * push() and popBest() are O(log n), and remove() of the evicted frame is O(n) to find it.
+ * It is not thread safe. The caller holds its lock.
+ */
+template <typename T>
+class ExynosCameraFrameScoreHeap {
+public:
+    typedef typename ExynosCameraList<T>::iterator iterator;
+
+    ExynosCameraFrameScoreHeap() : m_size(0), m_lastKey(0), m_hasLastKey(false) {}
+
+    int getSize(void) { return m_size; }
+
+    /*
+     * The frame of the key was just pushed to the back of the list.
+     * It drops the oldest entry if it is full.
+     * It returns false if the frame has already left the list.
+     */
+    bool push(ExynosCameraList<T> *list, int64_t score, uint32_t key)
+    {
+        List<T> *rawList = NULL;
+        iterator iter;
+        bool found = false;
+
+        /* the entries before can not be told from the front of the list any more */
+        if (m_hasLastKey == true && key <= m_lastKey)
+            clear();
+
+        m_lastKey = key;
+        m_hasLastKey = true;
+
+        list->rawLockProcessList();
+        rawList = list->getRawProcessList();
+        if (rawList->empty() == false) {
+            iter = rawList->end();
+            --iter;
+            found = ((*iter)->getFrameCount() == key);
+        }
+        list->rawUnLockProcessList();
+
+        if (found == false)
+            return false;
+
+        if (m_size >= FRAME_SCORE_HEAP_SIZE) {
+            int oldest = 0;
+            for (int i = 1; i < m_size; i++) {
+                if (m_entry[i].key < m_entry[oldest].key)
+                    oldest = i;
+            }
+            m_removeAt(oldest);
+        }
+
+        m_entry[m_size].score = score;
+        m_entry[m_size].key = key;
+        m_entry[m_size].iter = iter;
+        m_siftUp(m_size++);
+
+        return true;
+    }
+
+    /* takes the frame of the best score out of the list, NULL if none of the entries is in it */
+    T popBest(ExynosCameraList<T> *list, uint32_t *key, int64_t *score)
+    {
+        List<T> *rawList = NULL;
+        T frame = NULL;
+
+        list->rawLockProcessList();
+        rawList = list->getRawProcessList();
+        while (m_size > 0) {
+            score_entry_t best = m_entry[0];
+            m_removeAt(0);
+
+            if (rawList->empty() == true || best.key < (*rawList->begin())->getFrameCount())
+                continue;
+
+            frame = *best.iter;
+            rawList->erase(best.iter);
+            if (key != NULL)
+                *key = best.key;
+            if (score != NULL)
+                *score = best.score;
+            break;
+        }
+        list->rawUnLockProcessList();
+
+        return frame;
+    }
+
+    bool remove(uint32_t key)
+    {
+        for (int i = 0; i < m_size; i++) {
+            if (m_entry[i].key == key) {
+                m_removeAt(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear(void)
+    {
+        for (int i = 0; i < m_size; i++)
+            m_entry[i].iter = iterator();
+        m_size = 0;
+        m_hasLastKey = false;
+    }
+
+private:
+    /* the newer one is better on the same score */
+    bool m_isBetter(int a, int b)
+    {
+        if (m_entry[a].score != m_entry[b].score)
+            return m_entry[a].score > m_entry[b].score;
+        return m_entry[a].key > m_entry[b].key;
+    }
+
+    void m_swap(int a, int b)
+    {
+        score_entry_t temp = m_entry[a];
+        m_entry[a] = m_entry[b];
+        m_entry[b] = temp;
+    }
+
+    void m_siftUp(int index)
+    {
+        while (index > 0 && m_isBetter(index, (index - 1) / 2)) {
+            m_swap(index, (index - 1) / 2);
+            index = (index - 1) / 2;
+        }
+    }
+
+    void m_siftDown(int index)
+    {
+        for (;;) {
+            int best = index;
+            int child = index * 2 + 1;
+
+            if (child < m_size && m_isBetter(child, best))
+                best = child;
+            if (child + 1 < m_size && m_isBetter(child + 1, best))
+                best = child + 1;
+            if (best == index)
+                break;
+
+            m_swap(index, best);
+            index = best;
+        }
+    }
+
+    void m_removeAt(int index)
+    {
+        m_size--;
+        if (index != m_size) {
+            m_entry[index] = m_entry[m_size];
+            m_siftUp(index);
+            m_siftDown(index);
+        }
+        m_entry[m_size].iter = iterator();
+    }
+
+private:
+    typedef struct score_entry {
+        int64_t     score;
+        uint32_t    key;
+        iterator    iter;
+    } score_entry_t;
+
+    score_entry_t   m_entry[FRAME_SCORE_HEAP_SIZE];
+    int             m_size;
+    uint32_t        m_lastKey;
+    bool            m_hasLastKey;
+};
+
 class ExynosCameraFrameSelector {
 public:
     /* Frame Select result */
@@ -103,6 +326,9 @@ public:
     void setId(SELECTOR_ID_t selectorId);
     SELECTOR_ID_t getId(void);
 
+    /* NULL to use ExynosCameraFrameScorePolicyDefault */
+    void setScorePolicy(ExynosCameraFrameScorePolicy *policy);
+
 protected:
     status_t m_manageNormalFrameHoldListHAL3(ExynosCameraFrameSP_sptr_t frame, int pipeID, bool isSrc, int32_t dstPos);
     status_t m_manageHdrFrameHoldList(ExynosCameraFrameSP_sptr_t frame, int pipeID, bool isSrc, int32_t dstPos);
@@ -145,6 +371,12 @@ protected:
 
     bool m_isFrameMetaTypeShotExt(void);
 
+    void m_getScoreMeta(ExynosCameraFrameSP_sptr_t frame, frame_score_meta_t *meta);
+    void m_pushScore(ExynosCameraFrameSP_sptr_t frame);
+    void m_removeScore(ExynosCameraFrameSP_sptr_t frame);
+    void m_clearScore(frame_queue_t *list);
+    ExynosCameraFrameSP_sptr_t m_popBestFrame(frame_queue_t *list);
+
 protected:
     frame_queue_t m_frameHoldList;
     frame_queue_t m_hdrFrameHoldList;
@@ -178,6 +410,14 @@ protected:
     char m_name[EXYNOS_CAMERA_NAME_STR_SIZE];
     state_t m_state;
     SELECTOR_ID_t m_selectorId;
+
+    /* scored selection of m_frameHoldList, guarded by m_listLock */
+    bool m_flagScoreSelect;
+    ExynosCameraFrameScorePolicy *m_scorePolicy;
+    ExynosCameraFrameScorePolicyDefault m_defaultScorePolicy;
+    ExynosCameraFrameScoreHeap<ExynosCameraFrameSP_sptr_t> m_scoreHeap;
+    frame_score_meta_t m_lastScoreMeta;
+    bool m_hasLastScoreMeta;
 };
 
 }
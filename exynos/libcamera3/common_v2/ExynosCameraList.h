@@ -39,8 +39,11 @@
 #include <sys/poll.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sched.h>
 #include <utils/threads.h>
 
+#include <atomic>
+
 #include <utils/RefBase.h>
 #include <utils/String8.h>
 #include <utils/List.h>
@@ -49,6 +52,7 @@
 #define THREAD_NAME_DEFAULT "ExynosList%d"
 #define WAIT_TIME (150 * 1000000)
 #define DEFAULT_PROCESSQ_MARGIN (1)
+#define DEFAULT_RING_SIZE (32)
 
 using namespace android;
 
@@ -56,6 +60,27 @@ enum LIST_CMD {
     WAKE_UP = 1,
 };
 
+enum LIST_QUEUE_TYPE {
+    /* List guarded by the mutex */
+    LIST_QUEUE_TYPE_LIST = 0,
+    /* ring, pushed by one thread */
+    LIST_QUEUE_TYPE_SPSC,
+    /* ring, pushed by any thread */
+    LIST_QUEUE_TYPE_MPSC,
+};
+
+/*
+ * Process queue of the pipes and the frame lists.
+ * By default the items are kept in a List under the mutex. setQueueType() moves a
+ * queue onto a bounded ring instead, where push and pop are a few atomics:
+ *  - producers take the mutex only to wake up a consumer sleeping on the empty ring,
+ *    or to start the thread of the queue.
+ *  - pops claim the head by CAS, because release() and the frame selector drain the
+ *    queues from other threads than the consumer.
+ *  - when the ring is full, items are spilled to the List, and every push goes there
+ *    until the List is drained, so the order is kept.
+ * The raw List of a ring queue holds only the spilled items.
+ */
 template<typename T>
 class ExynosCameraList {
 public:
@@ -68,7 +93,15 @@ public:
         m_waitProcessQ = false;
         m_waitTime = WAIT_TIME;
         m_thread = NULL;
+        m_hasThread = false;
         m_processQMargin = processQMargin;
+
+        m_queueType = LIST_QUEUE_TYPE_LIST;
+        m_ring = NULL;
+        m_ringMask = 0;
+        m_ringHead = 0;
+        m_ringTail = 0;
+        m_numSpilled = 0;
     }
 
     ExynosCameraList(sp<Thread> thread, uint32_t processQMargin = DEFAULT_PROCESSQ_MARGIN)
@@ -79,12 +112,65 @@ public:
         m_thread = NULL;
 
         m_thread = thread;
+        m_hasThread = (thread != NULL);
         m_processQMargin = processQMargin;
+
+        m_queueType = LIST_QUEUE_TYPE_LIST;
+        m_ring = NULL;
+        m_ringMask = 0;
+        m_ringHead = 0;
+        m_ringTail = 0;
+        m_numSpilled = 0;
     }
 
     ~ExynosCameraList()
     {
         release();
+
+        if (m_ring != NULL)
+            delete[] m_ring;
+    }
+
+    /*
+     * ringSize is rounded up to a power of 2.
+     * The type can be changed only while the queue is empty.
+     */
+    status_t setQueueType(enum LIST_QUEUE_TYPE type, uint32_t ringSize = DEFAULT_RING_SIZE)
+    {
+        Mutex::Autolock lock(m_processQMutex);
+        uint32_t size = 1;
+
+        if (m_getSizeOfQ() > 0) {
+            ALOGE("ERR(%s[%d]):queue is not empty(%d)", __FUNCTION__, __LINE__, m_getSizeOfQ());
+            return INVALID_OPERATION;
+        }
+
+        if (m_ring != NULL) {
+            delete[] m_ring;
+            m_ring = NULL;
+        }
+
+        if (type != LIST_QUEUE_TYPE_LIST) {
+            while (size < ringSize)
+                size <<= 1;
+
+            m_ring = new ring_cell_t[size];
+            for (uint32_t i = 0; i < size; i++)
+                m_ring[i].seq.store(i, std::memory_order_relaxed);
+            m_ringMask = size - 1;
+        }
+
+        m_ringHead = 0;
+        m_ringTail = 0;
+        m_numSpilled = 0;
+        m_queueType = type;
+
+        return NO_ERROR;
+    }
+
+    enum LIST_QUEUE_TYPE getQueueType(void)
+    {
+        return m_queueType;
     }
 
     void setName(const char* name, ...)
@@ -105,6 +191,7 @@ public:
     {
         m_processQMutex.lock();
         m_thread = thread;
+        m_hasThread = (thread != NULL);
         m_processQMutex.unlock();
     }
 
@@ -144,50 +231,23 @@ public:
     /* Process Queue */
     void pushProcessQ(T *buf)
     {
-        status_t ret = NO_ERROR;
-        int retryCount = 3;
-        bool retryFlag = false;
-
         if (buf == NULL) {
             ALOGW("WARN(%s[%d]):Input buf is NULL", __FUNCTION__, __LINE__);
             return;
         }
 
+        if (m_queueType != LIST_QUEUE_TYPE_LIST) {
+            m_pushRingQ(buf);
+            return;
+        }
+
         Mutex::Autolock lock(m_processQMutex);
         m_processQ.push_back(*buf);
 
         if (m_waitProcessQ && m_processQ.size() >= m_processQMargin) {
             m_processQCondition.signal();
         } else if (m_thread != NULL && m_thread->isRunning() == false && m_processQ.size() >= m_processQMargin) {
-            do {
-                if (m_name.empty())
-                    setName(THREAD_NAME_DEFAULT, gettid());
-
-                ret = m_thread->run(m_name.c_str());
-                switch (ret) {
-                    case INVALID_OPERATION:
-                        /* Already running */
-                        ALOGW("WARN(%s[%d]):[TID %d]Failed to run thread. Already running.",
-                                __FUNCTION__, __LINE__, m_thread->getTid());
-
-                        retryFlag = false;
-                        break;
-                    case UNKNOWN_ERROR:
-                        /* Failed to run thread */
-                        ALOGE("ERR(%s[%d]):[TID %d]Failed to run Thread. Unknown error. Retry. RemainCount %d",
-                                __FUNCTION__, __LINE__, m_thread->getTid(), retryCount);
-
-                        retryFlag = true;
-                        break;
-                    default:
-                        /* Success to run thread */
-                        ALOGV("DEBUG(%s[%d]):[TID %d]Success to run thread",
-                                __FUNCTION__, __LINE__, m_thread->getTid());
-
-                        retryFlag = false;
-                        break;
-                }
-            } while (retryFlag == true && retryCount-- > 0);
+            m_runThread();
         }
     };
 
@@ -195,6 +255,9 @@ public:
     {
         iterator r;
 
+        if (m_queueType != LIST_QUEUE_TYPE_LIST)
+            return (m_popRingQ(buf) == true) ? OK : TIMED_OUT;
+
         Mutex::Autolock lock(m_processQMutex);
         if (m_processQ.empty())
             return TIMED_OUT;
@@ -211,6 +274,10 @@ public:
         iterator r;
 
         status_t ret;
+
+        if (m_queueType != LIST_QUEUE_TYPE_LIST)
+            return m_waitAndPopRingQ(buf);
+
         m_processQMutex.lock();
         if (m_processQ.size() < m_processQMargin) {
             m_waitProcessQ = true;
@@ -257,6 +324,9 @@ public:
 
     int getSizeOfProcessQ(void)
     {
+        if (m_queueType != LIST_QUEUE_TYPE_LIST)
+            return m_getSizeOfQ();
+
         Mutex::Autolock lock(m_processQMutex);
         return m_processQ.size();
     };
@@ -264,15 +334,26 @@ public:
     /* release both Queue */
     void release(void)
     {
+        T item;
+        int size;
+
         setStatusException(TIMED_OUT);
 
         m_processQMutex.lock();
         if (m_waitProcessQ)
             m_processQCondition.signal();
 
-        if (m_processQ.size() > 0) {
-            ALOGD("DEBUG(%s):Remained item %zu will be deleted",
-                    __FUNCTION__, m_processQ.size());
+        size = m_getSizeOfQ();
+        if (size > 0) {
+            ALOGD("DEBUG(%s):Remained item %d will be deleted",
+                    __FUNCTION__, size);
+        }
+
+        /* the popped cells drop their item */
+        if (m_queueType != LIST_QUEUE_TYPE_LIST) {
+            while (m_popRing(&item) == true)
+                ;
+            m_numSpilled = 0;
         }
 
         m_processQ.clear();
@@ -302,15 +383,233 @@ public:
 
     /* for all element control in loop */
     List<T> *getRawProcessList(void) {
+        if (m_queueType != LIST_QUEUE_TYPE_LIST)
+            ALOGE("ERR(%s[%d]):the items on the ring are not in the list", __FUNCTION__, __LINE__);
+
         return &m_processQ;
     }
 
+private:
+    typedef struct ring_cell {
+        /* index of the push which may fill the cell, +1 once it is filled */
+        std::atomic<uint32_t> seq;
+        T item;
+    } ring_cell_t;
+
+    /* m_processQMutex is held */
+    void m_runThread(void)
+    {
+        status_t ret = NO_ERROR;
+        int retryCount = 3;
+        bool retryFlag = false;
+
+        do {
+            if (m_name.empty())
+                setName(THREAD_NAME_DEFAULT, gettid());
+
+            ret = m_thread->run(m_name.c_str());
+            switch (ret) {
+                case INVALID_OPERATION:
+                    /* Already running */
+                    ALOGW("WARN(%s[%d]):[TID %d]Failed to run thread. Already running.",
+                            __FUNCTION__, __LINE__, m_thread->getTid());
+
+                    retryFlag = false;
+                    break;
+                case UNKNOWN_ERROR:
+                    /* Failed to run thread */
+                    ALOGE("ERR(%s[%d]):[TID %d]Failed to run Thread. Unknown error. Retry. RemainCount %d",
+                            __FUNCTION__, __LINE__, m_thread->getTid(), retryCount);
+
+                    retryFlag = true;
+                    break;
+                default:
+                    /* Success to run thread */
+                    ALOGV("DEBUG(%s[%d]):[TID %d]Success to run thread",
+                            __FUNCTION__, __LINE__, m_thread->getTid());
+
+                    retryFlag = false;
+                    break;
+            }
+        } while (retryFlag == true && retryCount-- > 0);
+    }
+
+    int m_getSizeOfQ(void)
+    {
+        int32_t size;
+
+        if (m_queueType == LIST_QUEUE_TYPE_LIST)
+            return m_processQ.size();
+
+        /* the head can pass the tail of a SPSC ring for a moment */
+        size = (int32_t)(m_ringTail.load(std::memory_order_acquire) - m_ringHead.load(std::memory_order_acquire));
+        if (size < 0)
+            size = 0;
+
+        return size + m_numSpilled.load(std::memory_order_acquire);
+    }
+
+    bool m_pushRing(const T &item)
+    {
+        uint32_t pos = m_ringTail.load(std::memory_order_relaxed);
+        ring_cell_t *cell;
+        int32_t diff;
+
+        while (1) {
+            cell = &m_ring[pos & m_ringMask];
+            diff = (int32_t)(cell->seq.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (m_queueType == LIST_QUEUE_TYPE_SPSC)
+                    break;
+                if (m_ringTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                /* full, the cell is not popped since the last lap */
+                return false;
+            } else {
+                pos = m_ringTail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->item = item;
+        cell->seq.store(pos + 1, std::memory_order_release);
+
+        if (m_queueType == LIST_QUEUE_TYPE_SPSC)
+            m_ringTail.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool m_popRing(T *buf)
+    {
+        uint32_t pos = m_ringHead.load(std::memory_order_relaxed);
+        ring_cell_t *cell;
+        int32_t diff;
+
+        while (1) {
+            cell = &m_ring[pos & m_ringMask];
+            diff = (int32_t)(cell->seq.load(std::memory_order_acquire) - (pos + 1));
+            if (diff == 0) {
+                if (m_ringHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                if (pos == m_ringTail.load(std::memory_order_acquire))
+                    return false;
+
+                /* a producer took the cell, but has not filled it yet */
+                sched_yield();
+                pos = m_ringHead.load(std::memory_order_relaxed);
+            } else {
+                pos = m_ringHead.load(std::memory_order_relaxed);
+            }
+        }
+
+        *buf = cell->item;
+        cell->item = T();
+        cell->seq.store(pos + m_ringMask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    void m_pushRingQ(T *buf)
+    {
+        bool pushed = false;
+
+        if (m_numSpilled.load(std::memory_order_acquire) == 0)
+            pushed = m_pushRing(*buf);
+
+        if (pushed == false) {
+            Mutex::Autolock lock(m_processQMutex);
+            m_processQ.push_back(*buf);
+            m_numSpilled.fetch_add(1, std::memory_order_release);
+        }
+
+        /* pairs with the fence in m_waitAndPopRingQ(), either side sees the other */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (m_waitProcessQ.load(std::memory_order_relaxed) == true) {
+            Mutex::Autolock lock(m_processQMutex);
+            if (m_waitProcessQ && (uint32_t)m_getSizeOfQ() >= m_processQMargin)
+                m_processQCondition.signal();
+        } else if (m_hasThread.load(std::memory_order_relaxed) == true) {
+            Mutex::Autolock lock(m_processQMutex);
+            if (m_thread != NULL && m_thread->isRunning() == false && (uint32_t)m_getSizeOfQ() >= m_processQMargin)
+                m_runThread();
+        }
+    }
+
+    bool m_popRingQ(T *buf)
+    {
+        iterator r;
+
+        /* the spilled items are pushed after every item on the ring */
+        if (m_popRing(buf) == true)
+            return true;
+
+        if (m_numSpilled.load(std::memory_order_acquire) == 0)
+            return false;
+
+        Mutex::Autolock lock(m_processQMutex);
+        if (m_processQ.empty())
+            return false;
+
+        r = m_processQ.begin();
+        *buf = *r;
+        m_processQ.erase(r);
+        m_numSpilled.fetch_sub(1, std::memory_order_release);
+
+        return true;
+    }
+
+    status_t m_waitAndPopRingQ(T *buf)
+    {
+        status_t ret = NO_ERROR;
+
+        if ((uint32_t)m_getSizeOfQ() < m_processQMargin) {
+            m_processQMutex.lock();
+            m_waitProcessQ = true;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            setStatusException(NO_ERROR);
+            if ((uint32_t)m_getSizeOfQ() < m_processQMargin)
+                ret = m_processQCondition.waitRelative(m_processQMutex, m_waitTime);
+            m_waitProcessQ = false;
+            m_processQMutex.unlock();
+
+            if (ret < 0) {
+                if (ret == TIMED_OUT)
+                    ALOGV("DEBUG(%s):Time out, Skip to pop process Q", __FUNCTION__);
+                else
+                    ALOGE("ERR(%s):Fail to pop processQ", __FUNCTION__);
+
+                return ret;
+            }
+
+            ret = getStatusException();
+            if (ret != NO_ERROR) {
+                if (ret == TIMED_OUT) {
+                    ALOGV("DEBUG(%s):return CAM_ECANCELED.(%d).", __FUNCTION__, ret);
+                } else {
+                    ALOGW("WARN(%s[%d]): Exception status(%d)", __FUNCTION__, __LINE__, ret);
+                }
+                return ret;
+            }
+        }
+
+        if (m_popRingQ(buf) == false) {
+            ALOGE("ERR(%s[%d]): processQ is empty, invalid state", __FUNCTION__, __LINE__);
+            return INVALID_OPERATION;
+        }
+
+        return OK;
+    }
+
 private:
     List<T>             m_processQ;
     Mutex               m_processQMutex;
     Mutex               m_flagMutex;
     mutable Condition   m_processQCondition;
-    bool                m_waitProcessQ;
+    std::atomic<bool>   m_waitProcessQ;
     status_t            m_statusException;
     uint64_t            m_waitTime;
 
@@ -318,5 +617,13 @@ private:
 
     String8             m_name;
     sp<Thread>          m_thread;
+    std::atomic<bool>   m_hasThread;
+
+    enum LIST_QUEUE_TYPE m_queueType;
+    ring_cell_t         *m_ring;
+    uint32_t            m_ringMask;
+    std::atomic<uint32_t> m_ringHead;
+    std::atomic<uint32_t> m_ringTail;
+    std::atomic<uint32_t> m_numSpilled;
 };
 #endif
@@ -32,6 +32,70 @@ namespace android {
 #define META_VALIDATE_CHECK(x)
 #endif
 
+/* the tags read by the translator of a shot group and the part of the shot it writes */
+struct shot_group_info {
+    const uint32_t  *tags;
+    size_t          numTags;
+    size_t          offset;
+    size_t          size;
+};
+
+#define SHOT_GROUP_INFO(tags, field) \
+    { tags, sizeof(tags) / sizeof(tags[0]), \
+      offsetof(struct camera2_shot_ext, shot.ctl.field), \
+      sizeof(((struct camera2_shot_ext *)0)->shot.ctl.field) }
+
+static const uint32_t shotGroupColorTags[] = {
+    ANDROID_COLOR_CORRECTION_MODE,
+    ANDROID_COLOR_CORRECTION_TRANSFORM,
+    ANDROID_COLOR_CORRECTION_GAINS,
+    ANDROID_COLOR_CORRECTION_ABERRATION_MODE,
+};
+
+static const uint32_t shotGroupDemosaicTags[] = {
+    ANDROID_DEMOSAIC_MODE,
+};
+
+static const uint32_t shotGroupHotPixelTags[] = {
+    ANDROID_HOT_PIXEL_MODE,
+};
+
+static const uint32_t shotGroupJpegTags[] = {
+    ANDROID_JPEG_GPS_COORDINATES,
+    ANDROID_JPEG_GPS_PROCESSING_METHOD,
+    ANDROID_JPEG_GPS_TIMESTAMP,
+    ANDROID_JPEG_ORIENTATION,
+    ANDROID_JPEG_QUALITY,
+    ANDROID_JPEG_THUMBNAIL_QUALITY,
+    ANDROID_JPEG_THUMBNAIL_SIZE,
+};
+
+static const uint32_t shotGroupShadingTags[] = {
+    ANDROID_SHADING_MODE,
+    ANDROID_SHADING_STRENGTH,
+};
+
+static const uint32_t shotGroupTonemapTags[] = {
+    ANDROID_TONEMAP_MODE,
+    ANDROID_TONEMAP_CURVE_BLUE,
+    ANDROID_TONEMAP_CURVE_GREEN,
+    ANDROID_TONEMAP_CURVE_RED,
+};
+
+static const uint32_t shotGroupBlackLevelTags[] = {
+    ANDROID_BLACK_LEVEL_LOCK,
+};
+
+static const struct shot_group_info shotGroupInfo[SHOT_GROUP_MAX] = {
+    SHOT_GROUP_INFO(shotGroupColorTags,      color),
+    SHOT_GROUP_INFO(shotGroupDemosaicTags,   demosaic),
+    SHOT_GROUP_INFO(shotGroupHotPixelTags,   hotpixel),
+    SHOT_GROUP_INFO(shotGroupJpegTags,       jpeg),
+    SHOT_GROUP_INFO(shotGroupShadingTags,    shading),
+    SHOT_GROUP_INFO(shotGroupTonemapTags,    tonemap),
+    SHOT_GROUP_INFO(shotGroupBlackLevelTags, blacklevel),
+};
+
 
 ExynosCameraMetadataConverter::ExynosCameraMetadataConverter(int cameraId,
                                                              ExynosCameraConfigurations *configurations,
@@ -68,6 +132,12 @@ ExynosCameraMetadataConverter::ExynosCameraMetadataConverter(int cameraId,
 #ifdef SUPPORT_MULTI_AF
     m_flagMultiAf = false;
 #endif
+
+    m_shotGroupCacheEnable = true;
+    for (int i = 0; i < SHOT_GROUP_MAX; i++) {
+        m_shotGroupCache[i].valid = false;
+    }
+    memset(&m_shotGroupShot, 0x00, sizeof(m_shotGroupShot));
 }
 
 ExynosCameraMetadataConverter::~ExynosCameraMetadataConverter()
@@ -2629,6 +2699,100 @@ void ExynosCameraMetadataConverter::setPreviousMeta(CameraMetadata *meta)
     m_prevMeta = meta;
 }
 
+void ExynosCameraMetadataConverter::setShotGroupCache(bool enable)
+{
+    Mutex::Autolock lock(m_shotGroupLock);
+
+    m_shotGroupCacheEnable = enable;
+    for (int i = 0; i < SHOT_GROUP_MAX; i++) {
+        m_shotGroupCache[i].valid = false;
+    }
+}
+
+status_t ExynosCameraMetadataConverter::m_translateShotGroup(enum shot_group_index group,
+                                                             CameraMetadata *settings,
+                                                             struct camera2_shot_ext *dst_ext)
+{
+    switch (group) {
+    case SHOT_GROUP_COLOR:
+        return translateColorControlData(settings, dst_ext);
+    case SHOT_GROUP_DEMOSAIC:
+        return translateDemosaicControlData(settings, dst_ext);
+    case SHOT_GROUP_HOTPIXEL:
+        return translateHotPixelControlData(settings, dst_ext);
+    case SHOT_GROUP_JPEG:
+        return translateJpegControlData(settings, dst_ext);
+    case SHOT_GROUP_SHADING:
+        return translateShadingControlData(settings, dst_ext);
+    case SHOT_GROUP_TONEMAP:
+        return translateTonemapControlData(settings, dst_ext);
+    case SHOT_GROUP_BLACKLEVEL:
+        return translateBlackLevelControlData(settings, dst_ext);
+    default:
+        CLOGE("Invalid shot group(%d)", group);
+        return BAD_VALUE;
+    }
+}
+
+/*
+ * Nothing but initShotData() writes the part of a shot group before its translator runs,
+ * so the same tags always translate to the same bytes and the last result can be copied.
+ * m_shotGroupLock is held by convertRequestToShot() for all the groups of a request.
+ */
+status_t ExynosCameraMetadataConverter::m_translateCachedShotGroup(enum shot_group_index group,
+                                                                   CameraMetadata *settings,
+                                                                   struct camera2_shot_ext *dst_ext)
+{
+    const struct shot_group_info *info = &shotGroupInfo[group];
+    struct shot_group_cache *cache = &m_shotGroupCache[group];
+    uint8_t *dst = (uint8_t *)dst_ext + info->offset;
+    uint8_t *cached = (uint8_t *)&m_shotGroupShot + info->offset;
+    camera_metadata_entry_t entry;
+    status_t ret;
+
+    if (m_shotGroupCacheEnable == false)
+        return m_translateShotGroup(group, settings, dst_ext);
+
+    m_shotGroupKey.clear();
+    for (size_t i = 0; i < info->numTags; i++) {
+        entry = settings->find(info->tags[i]);
+
+        uint32_t header[2] = {info->tags[i], (uint32_t)entry.count};
+        m_shotGroupKey.insert(m_shotGroupKey.end(), (uint8_t *)header, (uint8_t *)header + sizeof(header));
+        if (entry.count > 0) {
+            m_shotGroupKey.insert(m_shotGroupKey.end(), entry.data.u8,
+                                  entry.data.u8 + entry.count * camera_metadata_type_size[entry.type]);
+        }
+    }
+
+    if (cache->valid == true && cache->key == m_shotGroupKey) {
+#if ENABLE_SHOT_GROUP_CACHE_CHECK
+        struct camera2_shot_ext *check_ext = new struct camera2_shot_ext;
+
+        memcpy(check_ext, dst_ext, sizeof(struct camera2_shot_ext));
+        m_translateShotGroup(group, settings, check_ext);
+        if (memcmp((uint8_t *)check_ext + info->offset, cached, info->size) != 0)
+            CLOGE("[R%d]Reused shot group(%d) is different from translation",
+                    dst_ext->shot.ctl.request.id, group);
+        delete check_ext;
+#endif
+        memcpy(dst, cached, info->size);
+        return OK;
+    }
+
+    ret = m_translateShotGroup(group, settings, dst_ext);
+    if (ret != OK) {
+        cache->valid = false;
+        return ret;
+    }
+
+    memcpy(cached, dst, info->size);
+    cache->key.swap(m_shotGroupKey);
+    cache->valid = true;
+
+    return OK;
+}
+
 status_t ExynosCameraMetadataConverter::convertRequestToShot(ExynosCameraRequestSP_sprt_t request, int *reqId)
 {
     status_t ret = OK;
@@ -2663,13 +2827,19 @@ status_t ExynosCameraMetadataConverter::convertRequestToShot(ExynosCameraRequest
 
     META_VALIDATE_CHECK(meta);
 
-    ret = translateColorControlData(meta, dst_ext);
+#if ENABLE_SHOT_GROUP_CACHE_CHECK
+    nsecs_t translateStartTime = systemTime();
+#endif
+
+    m_shotGroupLock.lock();
+
+    ret = m_translateCachedShotGroup(SHOT_GROUP_COLOR, meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 0);
     ret = translateControlControlData(meta, dst_ext, metaParameters);
     if (ret != OK)
         errorFlag |= (1 << 1);
-    ret = translateDemosaicControlData(meta, dst_ext);
+    ret = m_translateCachedShotGroup(SHOT_GROUP_DEMOSAIC, meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 2);
     ret = translateEdgeControlData(meta, dst_ext);
@@ -2678,10 +2848,10 @@ status_t ExynosCameraMetadataConverter::convertRequestToShot(ExynosCameraRequest
     ret = translateFlashControlData(meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 4);
-    ret = translateHotPixelControlData(meta, dst_ext);
+    ret = m_translateCachedShotGroup(SHOT_GROUP_HOTPIXEL, meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 5);
-    ret = translateJpegControlData(meta, dst_ext);
+    ret = m_translateCachedShotGroup(SHOT_GROUP_JPEG, meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 6);
     ret = translateScalerControlData(meta, dst_ext, metaParameters);
@@ -2699,22 +2869,29 @@ status_t ExynosCameraMetadataConverter::convertRequestToShot(ExynosCameraRequest
     ret = translateSensorControlData(meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 11);
-    ret = translateShadingControlData(meta, dst_ext);
+    ret = m_translateCachedShotGroup(SHOT_GROUP_SHADING, meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 12);
     ret = translateStatisticsControlData(meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 13);
-    ret = translateTonemapControlData(meta, dst_ext);
+    ret = m_translateCachedShotGroup(SHOT_GROUP_TONEMAP, meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 14);
     ret = translateLedControlData(meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 15);
-    ret = translateBlackLevelControlData(meta, dst_ext);
+    ret = m_translateCachedShotGroup(SHOT_GROUP_BLACKLEVEL, meta, dst_ext);
     if (ret != OK)
         errorFlag |= (1 << 16);
 
+    m_shotGroupLock.unlock();
+
+#if ENABLE_SHOT_GROUP_CACHE_CHECK
+    CLOGD("[R%d]Translation takes %lld nsec", dst_ext->shot.ctl.request.id,
+            (long long)(systemTime() - translateStartTime));
+#endif
+
     request->setRequestUnlock();
 
     if (errorFlag != 0) {
@@ -17,8 +17,11 @@
 #ifndef EXYNOS_CAMERA_METADATA_CONVERTER_H__
 #define EXYNOS_CAMERA_METADATA_CONVERTER_H__
 
+#include <vector>
+
 #include <log/log.h>
 #include <utils/RefBase.h>
+#include <utils/Mutex.h>
 #include <hardware/camera3.h>
 #include <CameraMetadata.h>
 
@@ -39,6 +42,14 @@
 #define ACTUAL_PIPELINE_DEPTH               (4)
 #define FRAMECOUNT_MAP_LENGTH               (100)
 
+/*
+ * Translate every reused shot group again and log when the copy differs,
+ * with the translation time of each request
+ */
+#ifndef ENABLE_SHOT_GROUP_CACHE_CHECK
+#define ENABLE_SHOT_GROUP_CACHE_CHECK       (0)
+#endif
+
 namespace android {
 
 class ExynosCameraRequestManager;
@@ -98,6 +109,21 @@ enum metadata_type {
     PARTIAL_MAX,
 };
 
+/*
+ * Tag groups whose part of the shot is decided only by their own tags.
+ * Their translation is reused while the tags stay the same as the last request.
+ */
+enum shot_group_index {
+    SHOT_GROUP_COLOR,
+    SHOT_GROUP_DEMOSAIC,
+    SHOT_GROUP_HOTPIXEL,
+    SHOT_GROUP_JPEG,
+    SHOT_GROUP_SHADING,
+    SHOT_GROUP_TONEMAP,
+    SHOT_GROUP_BLACKLEVEL,
+    SHOT_GROUP_MAX,
+};
+
 class ExynosCameraMetadataConverter : public virtual RefBase {
 public:
     ExynosCameraMetadataConverter(int cameraId, ExynosCameraConfigurations *configuraitons,
@@ -112,6 +138,7 @@ public:
     virtual status_t        convertRequestToShot(ExynosCameraRequestSP_sprt_t request, int *reqId = NULL);
     virtual status_t        updateDynamicMeta(ExynosCameraRequestSP_sprt_t requestInfo, enum metadata_type metaType);
     virtual void            setPreviousMeta(CameraMetadata *meta);
+    virtual void            setShotGroupCache(bool enable);
 
     /* meta -> shot */
     virtual status_t        translateColorControlData(CameraMetadata *settings, struct camera2_shot_ext *dst_ext);
@@ -288,6 +315,10 @@ private:
     void                    setSceneMode(int value, struct camera2_shot_ext *dst_ext);
     uint32_t                m_getFrameInfoForTimeStamp(enum frame_count_map_item_index index, uint64_t timeStamp);
     enum aa_afstate         translateVendorAfStateMetaData(enum aa_afstate mainAfState);
+    status_t                m_translateShotGroup(enum shot_group_index group, CameraMetadata *settings,
+                                                 struct camera2_shot_ext *dst_ext);
+    status_t                m_translateCachedShotGroup(enum shot_group_index group, CameraMetadata *settings,
+                                                       struct camera2_shot_ext *dst_ext);
 
 private:
     int                             m_cameraId;
@@ -320,6 +351,20 @@ private:
     bool                            m_flagMultiAf;
 #endif
     int                             m_sceneMode;
+
+    /*
+     * Translated part of the last request for each shot group, and its fingerprint:
+     * the raw values of the tags of the group as they were in that request.
+     */
+    struct shot_group_cache {
+        bool                        valid;
+        std::vector<uint8_t>        key;
+    };
+    bool                            m_shotGroupCacheEnable;
+    Mutex                           m_shotGroupLock;
+    struct shot_group_cache         m_shotGroupCache[SHOT_GROUP_MAX];
+    std::vector<uint8_t>            m_shotGroupKey;
+    struct camera2_shot_ext         m_shotGroupShot;
 };
 
 }; /* namespace android */
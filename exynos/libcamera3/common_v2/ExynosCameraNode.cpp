@@ -100,6 +100,7 @@ ExynosCameraNode::ExynosCameraNode()
     }
 
     m_nodeType = NODE_TYPE_BASE;
+    m_simulator = NULL;
 }
 
 ExynosCameraNode::~ExynosCameraNode()
@@ -224,6 +225,11 @@ status_t ExynosCameraNode::destroy(void)
 
     m_removeItemBufferQ();
 
+    if (m_simulator != NULL) {
+        delete m_simulator;
+        m_simulator = NULL;
+    }
+
     m_nodeType = NODE_TYPE_BASE;
 
     EXYNOS_CAMERA_NODE_OUT();
@@ -254,6 +260,12 @@ status_t ExynosCameraNode::open(int videoNodeNum)
 
         CLOGW(" dummy node opened");
     } else {
+#ifdef EXYNOS_CAMERA_NODE_SIMULATOR
+        m_nodeType = NODE_TYPE_SIMULATOR;
+        m_simulator = new ExynosCameraNodeSimulator(m_cameraId, m_name, videoNodeNum);
+
+        CLOGW(" simulated node(%d)(%s) opened", videoNodeNum, node_name);
+#else
         m_fd = exynos_v4l2_open(node_name, O_RDWR, 0);
         if (m_fd < 0) {
             CLOGE("exynos_v4l2_open(%s) fail, ret(%d)",
@@ -261,6 +273,7 @@ status_t ExynosCameraNode::open(int videoNodeNum)
             return INVALID_OPERATION;
         }
         CLOGD(" Node(%d)(%s) opened. m_fd(%d)", videoNodeNum, node_name, m_fd);
+#endif
     }
 
     m_videoNodeNum = videoNodeNum;
@@ -294,6 +307,11 @@ status_t ExynosCameraNode::close(void)
     if (m_nodeType == NODE_TYPE_DUMMY) {
         m_dummyIndexQ.clear();
         CLOGW("dummy node closed");
+    } else if (m_nodeType == NODE_TYPE_SIMULATOR) {
+        m_simulator->dump();
+        delete m_simulator;
+        m_simulator = NULL;
+        CLOGW("simulated node closed");
     } else {
         if (exynos_v4l2_close(m_fd) != 0) {
             CLOGE("close fail");
@@ -783,7 +801,7 @@ status_t ExynosCameraNode::setCrop(enum v4l2_buf_type type, int x, int y, int w,
         crop.c.left);
 #endif
 
-    if (m_nodeType == NODE_TYPE_DUMMY) {
+    if (m_nodeType == NODE_TYPE_DUMMY || m_nodeType == NODE_TYPE_SIMULATOR) {
         /* nop */
     } else {
         ret = exynos_v4l2_s_crop(m_fd, &crop);
@@ -944,6 +962,8 @@ status_t ExynosCameraNode::prepareBuffer(ExynosCameraBuffer *buf)
 
     if (m_nodeType == NODE_TYPE_DUMMY) {
         m_dummyIndexQ.push_back(v4l2_buf.index);
+    } else if (m_nodeType == NODE_TYPE_SIMULATOR) {
+        /* nop */
     } else {
         ret = exynos_v4l2_prepare(m_fd, &v4l2_buf);
         if (ret < 0) {
@@ -1050,6 +1070,9 @@ void ExynosCameraNode::dumpState(void)
 
     CLOGI("Node state(%d)", m_nodeRequest.getState());
 
+    if (m_nodeType == NODE_TYPE_SIMULATOR)
+        m_simulator->dump();
+
     return;
 }
 
@@ -1081,6 +1104,8 @@ int ExynosCameraNode::m_polling(void)
 
     if (m_nodeType == NODE_TYPE_DUMMY)
         return 0;
+    else if (m_nodeType == NODE_TYPE_SIMULATOR)
+        return m_simulator->polling();
 
     /* 50 msec * 40 = 2sec */
     int cnt = 40;
@@ -1127,6 +1152,8 @@ int ExynosCameraNode::m_streamOn(void)
 
     if (m_nodeType == NODE_TYPE_DUMMY) {
         /* nop */
+    } else if (m_nodeType == NODE_TYPE_SIMULATOR) {
+        m_simulator->start();
     } else {
         ret = exynos_v4l2_streamon(m_fd, (enum v4l2_buf_type)m_v4l2ReqBufs.type);
         if (ret < 0) {
@@ -1152,6 +1179,8 @@ int ExynosCameraNode::m_streamOff(void)
 
     if (m_nodeType == NODE_TYPE_DUMMY) {
         /* nop */
+    } else if (m_nodeType == NODE_TYPE_SIMULATOR) {
+        m_simulator->stop();
     } else {
         ret = exynos_v4l2_streamoff(m_fd, (enum v4l2_buf_type)m_v4l2ReqBufs.type);
         if (ret < 0) {
@@ -1178,7 +1207,7 @@ int ExynosCameraNode::m_setInput(int id)
     CLOGD("fd %d, index %d", m_fd, id);
 #endif
 
-    if (m_nodeType == NODE_TYPE_DUMMY) {
+    if (m_nodeType == NODE_TYPE_DUMMY || m_nodeType == NODE_TYPE_SIMULATOR) {
         /* nop */
     } else {
         ret = exynos_v4l2_s_input(m_fd, id);
@@ -1215,7 +1244,7 @@ int ExynosCameraNode::m_setFmt(void)
 
     m_v4l2Format.type = m_v4l2ReqBufs.type;
 
-    if (m_nodeType == NODE_TYPE_DUMMY) {
+    if (m_nodeType == NODE_TYPE_DUMMY || m_nodeType == NODE_TYPE_SIMULATOR) {
         /* nop */
     } else {
         ret = exynos_v4l2_s_fmt(m_fd, &m_v4l2Format);
@@ -1241,7 +1270,7 @@ int ExynosCameraNode::m_reqBuffers(int *reqCount)
         m_v4l2ReqBufs.memory);
 #endif
 
-    if (m_nodeType == NODE_TYPE_DUMMY) {
+    if (m_nodeType == NODE_TYPE_DUMMY || m_nodeType == NODE_TYPE_SIMULATOR) {
         /* nop */
     } else {
         ret = exynos_v4l2_reqbufs(m_fd, &m_v4l2ReqBufs);
@@ -1293,7 +1322,7 @@ int ExynosCameraNode::m_clrBuffers(int *reqCount)
         m_v4l2ReqBufs.memory);
 #endif
 
-    if (m_nodeType == NODE_TYPE_DUMMY) {
+    if (m_nodeType == NODE_TYPE_DUMMY || m_nodeType == NODE_TYPE_SIMULATOR) {
         /* nop */
     } else {
         ret = exynos_v4l2_reqbufs(m_fd, &m_v4l2ReqBufs);
@@ -1329,6 +1358,9 @@ int ExynosCameraNode::setParam(struct v4l2_streamparm *stream_parm)
 
     if (m_nodeType == NODE_TYPE_DUMMY) {
         /* nop */
+    } else if (m_nodeType == NODE_TYPE_SIMULATOR) {
+        m_simulator->setFrameInterval(stream_parm->parm.capture.timeperframe.numerator,
+                                      stream_parm->parm.capture.timeperframe.denominator);
     } else {
         ret = exynos_v4l2_s_parm(m_fd, stream_parm);
         if (ret < 0) {
@@ -1344,7 +1376,7 @@ int ExynosCameraNode::m_setControl(unsigned int id, int value)
 {
     int ret = 0;
 
-    if (m_nodeType == NODE_TYPE_DUMMY) {
+    if (m_nodeType == NODE_TYPE_DUMMY || m_nodeType == NODE_TYPE_SIMULATOR) {
         /* nop */
     } else {
         ret = exynos_v4l2_s_ctrl(m_fd, id, value);
@@ -1362,7 +1394,7 @@ int ExynosCameraNode::m_getControl(unsigned int id, int *value)
 {
     int ret = 0;
 
-    if (m_nodeType == NODE_TYPE_DUMMY) {
+    if (m_nodeType == NODE_TYPE_DUMMY || m_nodeType == NODE_TYPE_SIMULATOR) {
         /* nop */
     } else {
         ret = exynos_v4l2_g_ctrl(m_fd, id, value);
@@ -1380,7 +1412,7 @@ int ExynosCameraNode::m_setExtControl(struct v4l2_ext_controls *ctrl)
 {
     int ret = 0;
 
-    if (m_nodeType == NODE_TYPE_DUMMY) {
+    if (m_nodeType == NODE_TYPE_DUMMY || m_nodeType == NODE_TYPE_SIMULATOR) {
         /* no operation */
     } else {
         ret = exynos_v4l2_s_ext_ctrl(m_fd, ctrl);
@@ -1484,6 +1516,10 @@ int ExynosCameraNode::m_qBuf(ExynosCameraBuffer *buf)
 
     if (m_nodeType == NODE_TYPE_DUMMY) {
         m_dummyIndexQ.push_back(v4l2_buf.index);
+    } else if (m_nodeType == NODE_TYPE_SIMULATOR) {
+        ret = m_simulator->qbuf(v4l2_buf.index);
+        if (ret < 0)
+            return ret;
     } else {
         ret = exynos_v4l2_qbuf(m_fd, &v4l2_buf);
         if (ret < 0) {
@@ -1645,6 +1681,17 @@ int ExynosCameraNode::m_dqBuf(ExynosCameraBuffer *buf, int *dqIndex)
             v4l2_buf.index = *r;
             m_dummyIndexQ.erase(r);
         }
+    } else if (m_nodeType == NODE_TYPE_SIMULATOR) {
+        int index = 0;
+
+        ret = m_simulator->dqbuf(&index);
+        if (ret < 0) {
+            if (ret != -EAGAIN)
+                CLOGE("simulated dqbuf fail (%d)", ret);
+
+            return ret;
+        }
+        v4l2_buf.index = index;
     } else {
         ret = exynos_v4l2_dqbuf(m_fd, &v4l2_buf);
         if (ret < 0) {
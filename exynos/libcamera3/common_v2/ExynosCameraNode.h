@@ -61,6 +61,7 @@
 
 #include "ExynosJpegEncoderForCamera.h"
 #include "exynos_v4l2.h"
+#include "ExynosCameraNodeSimulator.h"
 
 #include "fimc-is-metadata.h"
 
@@ -73,6 +74,7 @@ namespace android {
 /* #define EXYNOS_CAMERA_NODE_TRACE */
 /* #define EXYNOS_CAMERA_NODE_TRACE_Q_DURATION */
 /* #define EXYNOS_CAMERA_NODE_TRACE_DQ_DURATION */
+/* EXYNOS_CAMERA_NODE_SIMULATOR is defined by BOARD_CAMERA_USES_NODE_SIMULATOR := true */
 
 #ifdef EXYNOS_CAMERA_NODE_TRACE
 #define EXYNOS_CAMERA_NODE_IN()   CLOGD("IN...m_nodeState[%d]", m_nodeState)
@@ -219,6 +221,7 @@ public:
     enum EXYNOS_CAMERA_NODE_TYPE {
         NODE_TYPE_BASE = 0,
         NODE_TYPE_DUMMY = 999,
+        NODE_TYPE_SIMULATOR,
         NODE_TYPE_MAX,
     };
 
@@ -457,6 +460,7 @@ protected:
 
     enum EXYNOS_CAMERA_NODE_TYPE m_nodeType;
     List<int>           m_dummyIndexQ;
+    ExynosCameraNodeSimulator *m_simulator;
 
 #ifdef EXYNOS_CAMERA_NODE_TRACE_Q_DURATION
     ExynosCameraDurationTimer m_qTimer;
@@ -0,0 +1,309 @@
+/*
+ * Copyright 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file      ExynosCameraNodeSimulator.h
+ * \brief     header file for ExynosCameraNodeSimulator
+ *
+ */
+
+#ifndef EXYNOS_CAMERA_NODE_SIMULATOR_H__
+#define EXYNOS_CAMERA_NODE_SIMULATOR_H__
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <utils/Condition.h>
+#include <utils/Mutex.h>
+#include <utils/Timers.h>
+#include "cutils/properties.h"
+
+#include "ExynosCameraObject.h"
+
+namespace android {
+
+#define NODE_SIMULATOR_LATENCY_US       (3000)
+#define NODE_SIMULATOR_QUEUE_SIZE       (64)
+#define NODE_SIMULATOR_WAIT_TIMEOUT     (2000000000LL) /* 2 sec, same as m_polling() */
+
+/*
+ * Timing model of a video node, to run the pipes without the driver.
+ * Buffers are done in queued order, each one the node latency (+ random jitter)
+ * after it starts:
+ *  - a node which got the frame rate by setParam() is a sensor. It starts a frame
+ *    every frame interval, and the frame is dropped if no buffer is queued for it.
+ *  - the others are M2M devices. A buffer starts when it is queued and the previous
+ *    one is done.
+ * dqbuf() blocks until the oldest buffer is done. The planes are never touched,
+ * so any memory can stand in for the dma-buf of the buffers.
+ * The latency of a node is set by "vendor.camera.sim.node<N>" as "latency_us[,jitter_us]".
+ */
+class ExynosCameraNodeSimulator : public ExynosCameraObject {
+public:
+    ExynosCameraNodeSimulator(int cameraId, const char *name, int videoNodeNum)
+    {
+        char propName[PROPERTY_KEY_MAX];
+        char prop[PROPERTY_VALUE_MAX];
+        int latencyUs = NODE_SIMULATOR_LATENCY_US;
+        int jitterUs = 0;
+
+        setCameraId(cameraId);
+        setName(name);
+
+        snprintf(propName, sizeof(propName), "vendor.camera.sim.node%d", videoNodeNum);
+        if (property_get(propName, prop, "") > 0)
+            sscanf(prop, "%d,%d", &latencyUs, &jitterUs);
+
+        m_latency = (nsecs_t)latencyUs * 1000LL;
+        m_jitter = (nsecs_t)jitterUs * 1000LL;
+        m_frameInterval = 0;
+        m_seed = (unsigned int)videoNodeNum;
+        m_flagStreamOn = false;
+
+        m_head = 0;
+        m_numQueued = 0;
+        m_lastStartTime = 0;
+        m_lastDoneTime = 0;
+
+        m_numQbuf = 0;
+        m_numDqbuf = 0;
+        m_numDropped = 0;
+        m_sumDepth = 0;
+        m_maxDepth = 0;
+        m_sumLatency = 0;
+        m_maxLatency = 0;
+        m_sumLag = 0;
+
+        CLOGD("simulated node(%d) latency(%d us) jitter(%d us)", videoNodeNum, latencyUs, jitterUs);
+    }
+
+    /* from v4l2_streamparm.parm.capture.timeperframe */
+    void setFrameInterval(int numerator, int denominator)
+    {
+        Mutex::Autolock lock(m_lock);
+
+        if (numerator > 0 && denominator > 0)
+            m_frameInterval = (nsecs_t)numerator * 1000000000LL / denominator;
+    }
+
+    /* instead of the property, the benchmark runs the nodes without it */
+    void setLatency(int latencyUs, int jitterUs)
+    {
+        Mutex::Autolock lock(m_lock);
+
+        m_latency = (nsecs_t)latencyUs * 1000LL;
+        m_jitter = (nsecs_t)jitterUs * 1000LL;
+    }
+
+    /* the sensor frames which had no buffer */
+    uint64_t getNumDropped(void)
+    {
+        Mutex::Autolock lock(m_lock);
+
+        return m_numDropped;
+    }
+
+    void start(void)
+    {
+        Mutex::Autolock lock(m_lock);
+        nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+
+        m_flagStreamOn = true;
+        m_lastStartTime = now - m_frameInterval;
+        m_lastDoneTime = now;
+
+        /* the buffers queued before stream on start from now */
+        for (int i = 0; i < m_numQueued; i++)
+            m_schedule(&m_queue[(m_head + i) % NODE_SIMULATOR_QUEUE_SIZE], now);
+
+        m_cond.broadcast();
+    }
+
+    /* the queued buffers are taken back by the node, like streamoff */
+    void stop(void)
+    {
+        Mutex::Autolock lock(m_lock);
+
+        m_flagStreamOn = false;
+        m_head = 0;
+        m_numQueued = 0;
+
+        m_cond.broadcast();
+    }
+
+    int qbuf(int index)
+    {
+        Mutex::Autolock lock(m_lock);
+        nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+        sim_buffer_t *buffer;
+
+        if (m_numQueued >= NODE_SIMULATOR_QUEUE_SIZE) {
+            CLOGE("queue is full, index(%d)", index);
+            return -EINVAL;
+        }
+
+        buffer = &m_queue[(m_head + m_numQueued) % NODE_SIMULATOR_QUEUE_SIZE];
+        buffer->index = index;
+        buffer->qTime = now;
+        if (m_flagStreamOn == true)
+            m_schedule(buffer, now);
+        m_numQueued++;
+
+        m_numQbuf++;
+        m_sumDepth += m_numQueued;
+        if (m_maxDepth < m_numQueued)
+            m_maxDepth = m_numQueued;
+
+        m_cond.broadcast();
+
+        return 0;
+    }
+
+    int dqbuf(int *index)
+    {
+        Mutex::Autolock lock(m_lock);
+        nsecs_t now;
+        sim_buffer_t *buffer;
+        int ret;
+
+        ret = m_waitDone();
+        if (ret != 0)
+            return ret;
+
+        now = systemTime(SYSTEM_TIME_MONOTONIC);
+        buffer = &m_queue[m_head];
+        m_head = (m_head + 1) % NODE_SIMULATOR_QUEUE_SIZE;
+        m_numQueued--;
+
+        m_numDqbuf++;
+        m_sumLatency += now - buffer->qTime;
+        if (m_maxLatency < now - buffer->qTime)
+            m_maxLatency = now - buffer->qTime;
+        m_sumLag += now - buffer->doneTime;
+
+        *index = buffer->index;
+
+        return 0;
+    }
+
+    int polling(void)
+    {
+        Mutex::Autolock lock(m_lock);
+
+        return (m_waitDone() == 0) ? 0 : -1;
+    }
+
+    void dump(void)
+    {
+        Mutex::Autolock lock(m_lock);
+        uint64_t numQbuf = (m_numQbuf > 0) ? m_numQbuf : 1;
+        uint64_t numDqbuf = (m_numDqbuf > 0) ? m_numDqbuf : 1;
+
+        CLOGI("qbuf(%ju) dqbuf(%ju) dropped(%ju) interval(%jd us) latency(%jd us)",
+                (uintmax_t)m_numQbuf, (uintmax_t)m_numDqbuf, (uintmax_t)m_numDropped,
+                (intmax_t)(m_frameInterval / 1000), (intmax_t)(m_latency / 1000));
+        CLOGI("queue depth avg(%ju.%02ju) max(%d), qbuf to dqbuf avg(%jd us) max(%jd us), done to dqbuf avg(%jd us)",
+                (uintmax_t)(m_sumDepth / numQbuf), (uintmax_t)((m_sumDepth * 100 / numQbuf) % 100), m_maxDepth,
+                (intmax_t)(m_sumLatency / numDqbuf / 1000), (intmax_t)(m_maxLatency / 1000),
+                (intmax_t)(m_sumLag / numDqbuf / 1000));
+    }
+
+private:
+    typedef struct sim_buffer {
+        int index;
+        nsecs_t qTime;
+        nsecs_t doneTime;
+    } sim_buffer_t;
+
+    void m_schedule(sim_buffer_t *buffer, nsecs_t now)
+    {
+        nsecs_t startTime;
+        nsecs_t jitter = 0;
+        int64_t frames;
+
+        if (m_frameInterval > 0) {
+            /* the sensor frames which started before this qbuf had no buffer */
+            startTime = m_lastStartTime + m_frameInterval;
+            if (startTime < now) {
+                frames = (now - startTime + m_frameInterval - 1) / m_frameInterval;
+                m_numDropped += frames;
+                startTime += frames * m_frameInterval;
+            }
+            m_lastStartTime = startTime;
+        } else {
+            startTime = (m_lastDoneTime > now) ? m_lastDoneTime : now;
+        }
+
+        if (m_jitter > 0)
+            jitter = (nsecs_t)(rand_r(&m_seed) % (m_jitter / 1000 + 1)) * 1000LL;
+
+        buffer->doneTime = startTime + m_latency + jitter;
+        if (buffer->doneTime < m_lastDoneTime)
+            buffer->doneTime = m_lastDoneTime;
+        m_lastDoneTime = buffer->doneTime;
+    }
+
+    /* m_lock is held */
+    int m_waitDone(void)
+    {
+        nsecs_t waitTime;
+
+        while (1) {
+            if (m_flagStreamOn == false)
+                return -EINVAL;
+
+            if (m_numQueued > 0) {
+                waitTime = m_queue[m_head].doneTime - systemTime(SYSTEM_TIME_MONOTONIC);
+                if (waitTime <= 0)
+                    return 0;
+            } else {
+                waitTime = NODE_SIMULATOR_WAIT_TIMEOUT;
+            }
+
+            if (m_cond.waitRelative(m_lock, waitTime) == TIMED_OUT && m_numQueued == 0)
+                return -EAGAIN;
+        }
+    }
+
+private:
+    nsecs_t             m_latency;
+    nsecs_t             m_jitter;
+    nsecs_t             m_frameInterval;
+    unsigned int        m_seed;
+    bool                m_flagStreamOn;
+
+    mutable Mutex       m_lock;
+    mutable Condition   m_cond;
+    sim_buffer_t        m_queue[NODE_SIMULATOR_QUEUE_SIZE];
+    int                 m_head;
+    int                 m_numQueued;
+    nsecs_t             m_lastStartTime;
+    nsecs_t             m_lastDoneTime;
+
+    uint64_t            m_numQbuf;
+    uint64_t            m_numDqbuf;
+    uint64_t            m_numDropped;
+    uint64_t            m_sumDepth;
+    int                 m_maxDepth;
+    nsecs_t             m_sumLatency;
+    nsecs_t             m_maxLatency;
+    nsecs_t             m_sumLag;
+};
+
+}; /* namespace android */
+
+#endif
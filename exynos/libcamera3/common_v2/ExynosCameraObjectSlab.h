@@ -0,0 +1,211 @@
+/*
+**
+** Copyright 2017, Samsung Electronics Co. LTD
+**
+** Licensed under the Apache License, Version 2.0 (the "License");
+** you may not use this file except in compliance with the License.
+** You may obtain a copy of the License at
+**
+**     http://www.apache.org/licenses/LICENSE-2.0
+**
+** Unless required by applicable law or agreed to in writing, software
+** distributed under the License is distributed on an "AS IS" BASIS,
+** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+** See the License for the specific language governing permissions and
+** limitations under the License.
+*/
+
+#ifndef EXYNOS_CAMERA_OBJECT_SLAB_H
+#define EXYNOS_CAMERA_OBJECT_SLAB_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <new>
+
+#include <utils/Mutex.h>
+
+namespace android {
+
+/*
+ * Storage for objects of one class which are created and destroyed on the request path.
+ * Slots are carved out of chunks that are allocated on demand, up to maxChunks, and are
+ * kept for the lifetime of the slab. Released slots go back on a lock-free free list, so
+ * steady state allocation never reaches the heap. Requests that do not fit a slot, or
+ * that come after every chunk is in use, fall back to the global operator new.
+ */
+template <typename T>
+class ExynosCameraObjectSlab {
+public:
+    ExynosCameraObjectSlab(uint32_t chunkSlots, uint32_t maxChunks)
+    {
+        m_chunkSlots = chunkSlots;
+        m_maxChunks = maxChunks;
+        m_chunks = new Slot*[maxChunks];
+        for (uint32_t i = 0; i < maxChunks; i++)
+            m_chunks[i] = NULL;
+        m_numChunks = 0;
+
+        m_freeHead = FREE_LIST_EMPTY;
+        m_numInUse = 0;
+        m_numFallback = 0;
+    }
+
+    /* every object must be released already */
+    virtual ~ExynosCameraObjectSlab()
+    {
+        for (uint32_t i = 0; i < m_numChunks; i++)
+            free(m_chunks[i]);
+        delete[] m_chunks;
+    }
+
+    void *alloc(size_t size)
+    {
+        Slot *slot = NULL;
+
+        if (size <= sizeof(T)) {
+            slot = m_pop();
+            if (slot == NULL)
+                slot = m_grow();
+        }
+
+        if (slot == NULL) {
+            slot = (Slot *)::operator new(offsetof(Slot, storage) + size);
+            slot->index = FALLBACK_INDEX;
+            m_numFallback++;
+        }
+
+        m_numInUse++;
+        return slot->storage;
+    }
+
+    void release(void *ptr)
+    {
+        Slot *slot;
+
+        if (ptr == NULL)
+            return;
+
+        slot = (Slot *)((uint8_t *)ptr - offsetof(Slot, storage));
+        m_numInUse--;
+
+        if (slot->index == FALLBACK_INDEX) {
+            m_numFallback--;
+            ::operator delete(slot);
+        } else {
+            m_push(slot);
+        }
+    }
+
+    uint32_t getNumInUse(void)
+    {
+        return m_numInUse;
+    }
+
+    uint32_t getNumSlots(void)
+    {
+        Mutex::Autolock lock(m_growLock);
+        return m_numChunks * m_chunkSlots;
+    }
+
+    uint32_t getNumFallback(void)
+    {
+        return m_numFallback;
+    }
+
+private:
+    enum {
+        FREE_LIST_EMPTY = 0xFFFFFFFF,
+        FALLBACK_INDEX  = 0xFFFFFFFF,
+    };
+
+    struct Slot {
+        uint32_t                index;
+        std::atomic<uint32_t>   next;
+        alignas(max_align_t) uint8_t storage[sizeof(T)];
+    };
+
+    Slot *m_getSlot(uint32_t index)
+    {
+        return &m_chunks[index / m_chunkSlots][index % m_chunkSlots];
+    }
+
+    /* the head carries a modification count in its upper half against ABA */
+    Slot *m_pop(void)
+    {
+        uint64_t head = m_freeHead.load(std::memory_order_acquire);
+        uint64_t newHead;
+        Slot *slot;
+
+        do {
+            if ((uint32_t)head == FREE_LIST_EMPTY)
+                return NULL;
+            slot = m_getSlot((uint32_t)head);
+            newHead = ((head >> 32) + 1) << 32 | slot->next.load(std::memory_order_relaxed);
+        } while (!m_freeHead.compare_exchange_weak(head, newHead,
+                                                   std::memory_order_acquire,
+                                                   std::memory_order_acquire));
+
+        return slot;
+    }
+
+    void m_push(Slot *slot)
+    {
+        uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+        uint64_t newHead;
+
+        do {
+            slot->next.store((uint32_t)head, std::memory_order_relaxed);
+            newHead = ((head >> 32) + 1) << 32 | slot->index;
+        } while (!m_freeHead.compare_exchange_weak(head, newHead,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed));
+    }
+
+    Slot *m_grow(void)
+    {
+        Mutex::Autolock lock(m_growLock);
+        Slot *chunk;
+        Slot *slot;
+        uint32_t base;
+
+        /* another thread may have grown the slab while this one waited */
+        slot = m_pop();
+        if (slot != NULL || m_numChunks >= m_maxChunks)
+            return slot;
+
+        chunk = (Slot *)malloc(sizeof(Slot) * m_chunkSlots);
+        if (chunk == NULL)
+            return NULL;
+
+        base = m_numChunks * m_chunkSlots;
+        for (uint32_t i = 0; i < m_chunkSlots; i++) {
+            chunk[i].index = base + i;
+            new (&chunk[i].next) std::atomic<uint32_t>(FREE_LIST_EMPTY);
+        }
+        m_chunks[m_numChunks++] = chunk;
+
+        /* keep the first slot for the caller */
+        for (uint32_t i = 1; i < m_chunkSlots; i++)
+            m_push(&chunk[i]);
+
+        return &chunk[0];
+    }
+
+private:
+    uint32_t                m_chunkSlots;
+    uint32_t                m_maxChunks;
+    Slot                    **m_chunks;
+    uint32_t                m_numChunks;
+    mutable Mutex           m_growLock;
+
+    std::atomic<uint64_t>   m_freeHead;
+    std::atomic<uint32_t>   m_numInUse;
+    std::atomic<uint32_t>   m_numFallback;
+};
+
+}; /* namespace android */
+
+#endif
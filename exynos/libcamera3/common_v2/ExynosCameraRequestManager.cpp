@@ -224,8 +224,12 @@ status_t ExynosCameraRequest::m_init()
     }
 
     m_requestState = EXYNOS_REQUEST::STATE_SERVICE;
-    m_factoryMap.clear();
-    m_acquireFenceDoneMap.clear();
+    for (int i = 0; i < HAL_STREAM_ID_MAX; i++) {
+        m_factory[i] = NULL;
+    }
+    for (int i = 0; i < HAL_STREAM_ID_MAX + 1; i++) {
+        m_acquireFenceDone[i] = false;
+    }
     m_numOfCompleteBuffers = 0;
     m_pipelineDepth = 0;
 
@@ -403,16 +407,12 @@ uint32_t ExynosCameraRequest::getNumOfOutputBuffer()
 
 void ExynosCameraRequest::increaseCompleteBufferCount(void)
 {
-    m_resultStatusLock.lock();
     m_numOfCompleteBuffers++;
-    m_resultStatusLock.unlock();
 }
 
 void ExynosCameraRequest::resetCompleteBufferCount(void)
 {
-    m_resultStatusLock.lock();
     m_numOfCompleteBuffers = 0;
-    m_resultStatusLock.unlock();
 }
 
 int ExynosCameraRequest::getCompleteBufferCount(void)
@@ -451,92 +451,67 @@ int ExynosCameraRequest::getRequestId(void) {
     return m_requestId;
 }
 
-status_t ExynosCameraRequest::m_push(int key, ExynosCameraFrameFactory* item, FrameFactoryMap *list, Mutex *lock)
+status_t ExynosCameraRequest::m_push(int key, ExynosCameraFrameFactory* item)
 {
     status_t ret = NO_ERROR;
-    pair<FrameFactoryMap::iterator,bool> listRet;
-    lock->lock();
-    listRet = list->insert( pair<uint32_t, ExynosCameraFrameFactory*>(key, item));
-    if (listRet.second == false) {
+    ExynosCameraFrameFactory *factory = NULL;
+
+    if (m_factory[key].compare_exchange_strong(factory, item) == false) {
         ret = INVALID_OPERATION;
         CLOGE2("m_push failed, request already exist!! Request frameCnt( %d )", key);
     }
-    lock->unlock();
 
     return ret;
 }
 
-status_t ExynosCameraRequest::m_pop(int key, ExynosCameraFrameFactory** item, FrameFactoryMap *list, Mutex *lock)
+status_t ExynosCameraRequest::m_pop(int key, ExynosCameraFrameFactory** item)
 {
     status_t ret = NO_ERROR;
-    pair<FrameFactoryMap::iterator,bool> listRet;
-    FrameFactoryMapIterator iter;
     ExynosCameraFrameFactory *factory = NULL;
 
-    lock->lock();
-    iter = list->find(key);
-    if (iter != list->end()) {
-        factory = iter->second;
+    factory = m_factory[key].exchange(NULL);
+    if (factory != NULL) {
         *item = factory;
-        list->erase( iter );
     } else {
         CLOGE2("m_pop failed, factory is not EXIST Request frameCnt( %d )", key);
         ret = INVALID_OPERATION;
     }
-    lock->unlock();
 
     return ret;
 }
 
-status_t ExynosCameraRequest::m_get(int streamID, ExynosCameraFrameFactory** item, FrameFactoryMap *list, Mutex *lock)
+status_t ExynosCameraRequest::m_get(int streamID, ExynosCameraFrameFactory** item)
 {
     status_t ret = NO_ERROR;
-    pair<FrameFactoryMap::iterator,bool> listRet;
-    FrameFactoryMapIterator iter;
     ExynosCameraFrameFactory *factory = NULL;
 
-    lock->lock();
-    iter = list->find(streamID);
-    if (iter != list->end()) {
-        factory = iter->second;
+    factory = m_factory[streamID];
+    if (factory != NULL) {
         *item = factory;
     } else {
         CLOGE2("m_pop failed, request is not EXIST Request streamID( %d )", streamID);
         ret = INVALID_OPERATION;
     }
-    lock->unlock();
 
     return ret;
 }
 
-bool ExynosCameraRequest::m_find(int streamID, FrameFactoryMap *list, Mutex *lock)
+bool ExynosCameraRequest::m_find(int streamID)
 {
-    bool ret = false;
-    pair<FrameFactoryMap::iterator,bool> listRet;
-    FrameFactoryMapIterator iter;
-
-    lock->lock();
-    iter = list->find(streamID);
-    if (iter != list->end()) {
-        ret = true;
-    }
-    lock->unlock();
-
-    return ret;
+    return (m_factory[streamID] != NULL);
 }
 
-status_t ExynosCameraRequest::m_getList(FrameFactoryList *factorylist, FrameFactoryMap *list, Mutex *lock)
+status_t ExynosCameraRequest::m_getList(FrameFactoryList *factorylist)
 {
     status_t ret = NO_ERROR;
-    FrameFactoryMapIterator iter;
     ExynosCameraFrameFactory *factory = NULL;
 
-    lock->lock();
-    for (iter = list->begin(); iter != list->end() ; iter++) {
-        factory = iter->second;
-        factorylist->push_back(factory);
+    for (int i = 0; i < HAL_STREAM_ID_MAX; i++) {
+        factory = m_factory[i];
+        if (factory != NULL) {
+            factorylist->push_back(factory);
+        }
     }
-    lock->unlock();
 
     return ret;
 }
@@ -544,7 +519,7 @@ status_t ExynosCameraRequest::m_getList(FrameFactoryList *factorylist, FrameFact
 status_t ExynosCameraRequest::pushFrameFactory(int StreamID, ExynosCameraFrameFactory* factory)
 {
     status_t ret = NO_ERROR;
-    ret = m_push(StreamID % HAL_STREAM_ID_MAX, factory, &m_factoryMap, &m_factoryMapLock);
+    ret = m_push(StreamID % HAL_STREAM_ID_MAX, factory);
     if (ret < 0) {
         CLOGE2("pushFrameFactory is failed StreamID(%d) factory(%p)", StreamID, factory);
     }
@@ -557,7 +532,7 @@ ExynosCameraFrameFactory* ExynosCameraRequest::popFrameFactory(int streamID)
     status_t ret = NO_ERROR;
     ExynosCameraFrameFactory* factory = NULL;
 
-    ret = m_pop(streamID % HAL_STREAM_ID_MAX, &factory, &m_factoryMap, &m_factoryMapLock);
+    ret = m_pop(streamID % HAL_STREAM_ID_MAX, &factory);
     if (ret < 0) {
         CLOGE2("popFrameFactory is failed StreamID(%d) factory(%p)", streamID, factory);
     }
@@ -569,7 +544,7 @@ ExynosCameraFrameFactory* ExynosCameraRequest::getFrameFactory(int streamID)
     status_t ret = NO_ERROR;
     ExynosCameraFrameFactory* factory = NULL;
 
-    ret = m_get(streamID % HAL_STREAM_ID_MAX, &factory, &m_factoryMap, &m_factoryMapLock);
+    ret = m_get(streamID % HAL_STREAM_ID_MAX, &factory);
     if (ret < 0) {
         CLOGE2("getFrameFactory is failed StreamID(%d) factory(%p)", streamID, factory);
     }
@@ -579,14 +554,14 @@ ExynosCameraFrameFactory* ExynosCameraRequest::getFrameFactory(int streamID)
 
 bool ExynosCameraRequest::isFrameFactory(int streamID)
 {
-    return m_find(streamID % HAL_STREAM_ID_MAX, &m_factoryMap, &m_factoryMapLock);
+    return m_find(streamID % HAL_STREAM_ID_MAX);
 }
 
 status_t ExynosCameraRequest::getFrameFactoryList(FrameFactoryList *list)
 {
     status_t ret = NO_ERROR;
 
-    ret = m_getList(list, &m_factoryMap, &m_factoryMapLock);
+    ret = m_getList(list);
     if (ret < 0) {
         CLOGE2("getFrameFactoryList is failed");
     }
@@ -689,27 +664,22 @@ status_t ExynosCameraRequest::pushRequestInputStreams(int requestStreamId)
 status_t ExynosCameraRequest::setAcquireFenceDone(buffer_handle_t *handle, bool done)
 {
     status_t ret = NO_ERROR;
-    pair<map<buffer_handle_t *, bool>::iterator, bool> listRet;
-    Mutex::Autolock l(m_acquireFenceDoneLock);
-    listRet = m_acquireFenceDoneMap.insert(pair<buffer_handle_t *, bool>(handle, done));
-    if (listRet.second == false) {
-        map<buffer_handle_t *, bool>::iterator iter = m_acquireFenceDoneMap.find(handle);
-        bool fenceDone = false;
-
-        if (iter != m_acquireFenceDoneMap.end()) {
-            fenceDone = iter->second;
-            if (fenceDone != done) {
-                m_acquireFenceDoneMap.at(handle) = done;
-                CLOGW2("[R%d F%d] duplicate KEY, value old: %s/ new: %s",
-                        m_key, m_frameCount,
-                        fenceDone == true ? "Done" : "Wait",
-                        done == true ? "Done" : "Wait");
-            }
-        } else {
-            ret = INVALID_OPERATION;
-            CLOGE2("[R%d F%d] m_pop failed, handle is not EXIST",
-                    m_key, m_frameCount);
-        }
+    bool fenceDone = false;
+    int index = m_getBufferIndexOfHandle(handle);
+
+    if (index < 0) {
+        ret = INVALID_OPERATION;
+        CLOGE2("[R%d F%d] handle(%p) is not the buffer of the request",
+                m_key, m_frameCount, handle);
+        return ret;
+    }
+
+    fenceDone = m_acquireFenceDone[index].exchange(done);
+    if (fenceDone == true && done == false) {
+        CLOGW2("[R%d F%d] duplicate KEY, value old: %s/ new: %s",
+                m_key, m_frameCount,
+                fenceDone == true ? "Done" : "Wait",
+                done == true ? "Done" : "Wait");
     }
 
     return ret;
@@ -717,28 +687,21 @@ status_t ExynosCameraRequest::setAcquireFenceDone(buffer_handle_t *handle, bool
 
 bool ExynosCameraRequest::getAcquireFenceDone(buffer_handle_t *handle)
 {
-    bool fenceDone = false;
-    pair<map<buffer_handle_t *, bool>::iterator, bool> listRet;
-    map<buffer_handle_t *, bool>::iterator iter;
-    ExynosCameraRequestSP_sprt_t request = NULL;
+    int index = m_getBufferIndexOfHandle(handle);
 
-    Mutex::Autolock l(m_acquireFenceDoneLock);
-    iter = m_acquireFenceDoneMap.find(handle);
-    if (iter != m_acquireFenceDoneMap.end()) {
-        fenceDone = iter->second;
-    } else {
-        CLOGE2("[R%d F%d] m_pop failed, handle is not EXIST",
-                m_key, m_frameCount);
-        fenceDone = false;
+    if (index < 0) {
+        CLOGE2("[R%d F%d] handle(%p) is not the buffer of the request",
+                m_key, m_frameCount, handle);
+        return false;
     }
 
-    return fenceDone;
+    return m_acquireFenceDone[index];
 }
 
 status_t ExynosCameraRequest::setCallbackDone(EXYNOS_REQUEST_RESULT::TYPE reqType, bool flag)
 {
     status_t ret = NO_ERROR;
-    ret = m_setCallbackDone(reqType, flag, &m_resultStatusLock);
+    ret = m_setCallbackDone(reqType, flag);
     if (ret < 0) {
         CLOGE2("m_get request is failed, request type(%d) ", reqType);
     }
@@ -749,14 +712,14 @@ status_t ExynosCameraRequest::setCallbackDone(EXYNOS_REQUEST_RESULT::TYPE reqTyp
 bool ExynosCameraRequest::getCallbackDone(EXYNOS_REQUEST_RESULT::TYPE reqType)
 {
     bool ret = false;
-    ret = m_getCallbackDone(reqType, &m_resultStatusLock);
+    ret = m_getCallbackDone(reqType);
     return ret;
 }
 
 status_t ExynosCameraRequest::setCallbackStreamDone(int streamId, bool flag)
 {
     status_t ret = NO_ERROR;
-    ret = m_setCallbackStreamDone(streamId, flag, &m_resultStatusLock);
+    ret = m_setCallbackStreamDone(streamId, flag);
     if (ret < 0) {
         CLOGE2("[R%d F%d S%d] setCallbackStreamDone is failed.", m_key, m_frameCount, streamId);
     }
@@ -767,7 +730,7 @@ status_t ExynosCameraRequest::setCallbackStreamDone(int streamId, bool flag)
 bool ExynosCameraRequest::getCallbackStreamDone(int streamId)
 {
     bool ret = false;
-    ret = m_getCallbackStreamDone(streamId, &m_resultStatusLock);
+    ret = m_getCallbackStreamDone(streamId);
     return ret;
 }
 
@@ -778,9 +741,9 @@ bool ExynosCameraRequest::isComplete()
     bool partial = false;
     bool capture = false;
 
-    notify = m_getCallbackDone(EXYNOS_REQUEST_RESULT::CALLBACK_NOTIFY_ONLY, &m_resultStatusLock);
-    partial = m_getCallbackDone(EXYNOS_REQUEST_RESULT::CALLBACK_PARTIAL_3AA, &m_resultStatusLock);
-    capture = m_getCallbackDone(EXYNOS_REQUEST_RESULT::CALLBACK_ALL_RESULT, &m_resultStatusLock);
+    notify = m_getCallbackDone(EXYNOS_REQUEST_RESULT::CALLBACK_NOTIFY_ONLY);
+    partial = m_getCallbackDone(EXYNOS_REQUEST_RESULT::CALLBACK_PARTIAL_3AA);
+    capture = m_getCallbackDone(EXYNOS_REQUEST_RESULT::CALLBACK_ALL_RESULT);
 
     if (notify == true && capture == true && partial == true) {
         ret = true;
@@ -973,25 +936,21 @@ CameraMetadata ExynosCameraRequest::getShutterMeta()
 
 void ExynosCameraRequest::setSkipMetaResult(bool skip)
 {
-    Mutex::Autolock l(m_SkipMetaResultLock);
     m_isSkipMetaResult = skip;
 }
 
 bool ExynosCameraRequest::getSkipMetaResult(void)
 {
-    Mutex::Autolock l(m_SkipMetaResultLock);
     return m_isSkipMetaResult;
 }
 
 void ExynosCameraRequest::setSkipCaptureResult(bool skip)
 {
-    Mutex::Autolock l(m_SkipCaptureResultLock);
     m_isSkipCaptureResult = skip;
 }
 
 bool ExynosCameraRequest::getSkipCaptureResult(void)
 {
-    Mutex::Autolock l(m_SkipCaptureResultLock);
     return m_isSkipCaptureResult;
 }
 
@@ -1077,7 +1036,29 @@ int ExynosCameraRequest::m_getOutputBufferIndex(int streamId)
     return -1;
 }
 
-status_t ExynosCameraRequest::m_setCallbackDone(EXYNOS_REQUEST_RESULT::TYPE reqType, bool flag, Mutex *lock)
+int ExynosCameraRequest::m_getBufferIndexOfHandle(buffer_handle_t *handle)
+{
+    if (m_request == NULL) {
+        return -1;
+    }
+
+    if (m_request->output_buffers != NULL) {
+        for (int i = 0; i < m_numOfOutputBuffers && i < HAL_STREAM_ID_MAX; i++) {
+            if (m_request->output_buffers[i].buffer == handle) {
+                return i;
+            }
+        }
+    }
+
+    if (m_request->input_buffer != NULL
+        && m_request->input_buffer->buffer == handle) {
+        return HAL_STREAM_ID_MAX;
+    }
+
+    return -1;
+}
+
+status_t ExynosCameraRequest::m_setCallbackDone(EXYNOS_REQUEST_RESULT::TYPE reqType, bool flag)
 {
     status_t ret = NO_ERROR;
     if (reqType >= EXYNOS_REQUEST_RESULT::CALLBACK_MAX) {
@@ -1087,13 +1068,11 @@ status_t ExynosCameraRequest::m_setCallbackDone(EXYNOS_REQUEST_RESULT::TYPE reqT
         return ret;
     }
 
-    lock->lock();
     m_resultStatus[reqType] = flag;
-    lock->unlock();
     return ret;
 }
 
-bool ExynosCameraRequest::m_getCallbackDone(EXYNOS_REQUEST_RESULT::TYPE reqType, Mutex *lock)
+bool ExynosCameraRequest::m_getCallbackDone(EXYNOS_REQUEST_RESULT::TYPE reqType)
 {
     bool ret = false;
     if (reqType >= EXYNOS_REQUEST_RESULT::CALLBACK_MAX) {
@@ -1102,85 +1081,75 @@ bool ExynosCameraRequest::m_getCallbackDone(EXYNOS_REQUEST_RESULT::TYPE reqType,
         return ret;
     }
 
-    lock->lock();
     ret = m_resultStatus[reqType];
-    lock->unlock();
     return ret;
 }
 
-status_t ExynosCameraRequest::m_setCallbackStreamDone(int streamId, bool flag, Mutex *lock)
+status_t ExynosCameraRequest::m_setCallbackStreamDone(int streamId, bool flag)
 {
     int index = m_getOutputBufferIndex(streamId);
     if (index == -1) {
         if (m_isInputStreamId(streamId) == true) {
-            Mutex::Autolock l(lock);
             m_inputStreamDone = flag;
         } else {
             ALOGE("ERR(%s[%d]):streamId(%d) is mismatched", __FUNCTION__, __LINE__, streamId);
             return NAME_NOT_FOUND;
         }
     } else {
-        Mutex::Autolock l(lock);
         m_outputStreamDone[index] = flag;
     }
 
     return NO_ERROR;
 }
 
-bool ExynosCameraRequest::m_getCallbackStreamDone(int streamId, Mutex *lock)
+bool ExynosCameraRequest::m_getCallbackStreamDone(int streamId)
 {
     bool ret = false;
     int index = m_getOutputBufferIndex(streamId);
     if (index == -1) {
         if (m_isInputStreamId(streamId) == true) {
-            Mutex::Autolock l(lock);
             ret = m_inputStreamDone;
         } else {
             ALOGE("ERR(%s[%d]):streamId(%d) is mismatched", __FUNCTION__, __LINE__, streamId);
             return false;
         }
     } else {
-        Mutex::Autolock l(lock);
         ret = m_outputStreamDone[index];
     }
 
     return ret;
 }
 
-status_t ExynosCameraRequest::m_setStreamBufferStatus(int streamId, camera3_buffer_status_t status, Mutex *lock)
+status_t ExynosCameraRequest::m_setStreamBufferStatus(int streamId, camera3_buffer_status_t status)
 {
     int index = m_getOutputBufferIndex(streamId);
     if (index == -1) {
         if (m_isInputStreamId(streamId) == true) {
-            Mutex::Autolock l(lock);
             m_inputStreamStatus = status;
         } else {
             ALOGE("ERR(%s[%d]):streamId(%d) is mismatched", __FUNCTION__, __LINE__, streamId);
             return NAME_NOT_FOUND;
         }
     } else {
-        Mutex::Autolock l(lock);
         m_outputStreamStatus[index] = status;
     }
 
     return NO_ERROR;
 }
 
-camera3_buffer_status_t ExynosCameraRequest::m_getStreamBufferStatus(int streamId, Mutex *lock)
+camera3_buffer_status_t ExynosCameraRequest::m_getStreamBufferStatus(int streamId)
 {
     camera3_buffer_status_t status = CAMERA3_BUFFER_STATUS_ERROR;
 
     int index = m_getOutputBufferIndex(streamId);
     if (index == -1) {
         if (m_isInputStreamId(streamId) == true) {
-            Mutex::Autolock l(lock);
             status = m_inputStreamStatus;
         } else {
             ALOGE("ERR(%s[%d]):streamId(%d) is mismatched", __FUNCTION__, __LINE__, streamId);
             return CAMERA3_BUFFER_STATUS_ERROR;
         }
     } else {
-        Mutex::Autolock l(lock);
         status = m_outputStreamStatus[index];
     }
 
@@ -1190,14 +1159,14 @@ camera3_buffer_status_t ExynosCameraRequest::m_getStreamBufferStatus(int streamI
 void ExynosCameraRequest::printCallbackDoneState()
 {
     for (int i = 0 ; i < EXYNOS_REQUEST_RESULT::CALLBACK_MAX ; i++)
-        CLOGD2("m_key(%d), m_resultStatus[%d](%d)", m_key, i, m_resultStatus[i]);
+        CLOGD2("m_key(%d), m_resultStatus[%d](%d)", m_key, i, m_resultStatus[i].load());
 }
 
 status_t ExynosCameraRequest::setStreamBufferStatus(int streamId, camera3_buffer_status_t bufferStatus)
 {
     status_t ret = NO_ERROR;
 
-    ret = m_setStreamBufferStatus(streamId, bufferStatus, &m_streamStatusLock);
+    ret = m_setStreamBufferStatus(streamId, bufferStatus);
     if (ret != NO_ERROR) {
         ALOGE("ERR(%s[%d]):[R%d F%d S%d] setCallbackStreamDone is failed.",
                 __FUNCTION__, __LINE__, m_key, m_frameCount, streamId);
@@ -1208,7 +1177,7 @@ status_t ExynosCameraRequest::setStreamBufferStatus(int streamId, camera3_buffer
 
 camera3_buffer_status_t ExynosCameraRequest::getStreamBufferStatus(int streamId)
 {
-    return m_getStreamBufferStatus(streamId, &m_streamStatusLock);
+    return m_getStreamBufferStatus(streamId);
 }
 
 void ExynosCameraRequest::setBvOffset(uint32_t bvOffset)
@@ -1493,70 +1462,45 @@ status_t ExynosCameraRequestManager::m_get(uint32_t frameCount,
     return ret;
 }
 
-status_t ExynosCameraRequestManager::m_push(ExynosCameraRequestSP_sprt_t request, RequestInfoMap *list, Mutex *lock)
+status_t ExynosCameraRequestManager::m_push(ExynosCameraRequestSP_sprt_t request, RequestInfoRing *list)
 {
     status_t ret = NO_ERROR;
-    pair<RequestInfoMap::iterator,bool> listRet;
-    lock->lock();
-    listRet = list->insert( pair<uint32_t, ExynosCameraRequestSP_sprt_t>(request->getKey(), request));
-    if (listRet.second == false) {
+
+    ret = list->push(request->getKey(), request);
+    if (ret != NO_ERROR) {
         ret = INVALID_OPERATION;
         CLOGE("m_push failed, request already exist!! Request frameCnt( %d )", request->getFrameCount());
     }
-    lock->unlock();
-
-    //m_printAllRequestInfo(list, lock);
 
     return ret;
 }
 
 status_t ExynosCameraRequestManager::m_pop(uint32_t key,
                                             ExynosCameraRequestSP_dptr_t item,
-                                            RequestInfoMap *list,
-                                            Mutex *lock)
+                                            RequestInfoRing *list)
 {
     status_t ret = NO_ERROR;
-    pair<RequestInfoMap::iterator,bool> listRet;
-    RequestInfoMapIterator iter;
-    ExynosCameraRequestSP_sprt_t request = NULL;
 
-    lock->lock();
-    iter = list->find(key);
-    if (iter != list->end()) {
-        request = iter->second;
-        item = request;
-        list->erase( iter );
-    } else {
+    ret = list->pop(key, &item);
+    if (ret != NO_ERROR) {
         CLOGE("m_pop failed, request is not EXIST Request key(%d)", key);
         ret = INVALID_OPERATION;
     }
-    lock->unlock();
 
     return ret;
 }
 
 status_t ExynosCameraRequestManager::m_get(uint32_t key,
                                            ExynosCameraRequestSP_dptr_t item,
-                                           RequestInfoMap *list,
-                                           Mutex *lock)
+                                           RequestInfoRing *list)
 {
     status_t ret = NO_ERROR;
-    pair<RequestInfoMap::iterator,bool> listRet;
-    RequestInfoMapIterator iter;
-    ExynosCameraRequestSP_sprt_t request = NULL;
 
-    lock->lock();
-    iter = list->find(key);
-    if (iter != list->end()) {
-        request = iter->second;
-        item = request;
-    } else {
+    ret = list->get(key, &item);
+    if (ret != NO_ERROR) {
         CLOGE("m_pop failed, request is not EXIST Request key(%d)", key);
         ret = INVALID_OPERATION;
     }
-    lock->unlock();
-
-    //m_printAllRequestInfo(list, lock);
 
     return ret;
 }
@@ -1582,21 +1526,19 @@ void ExynosCameraRequestManager::m_printAllServiceRequestInfo(void)
     }
 }
 
-void ExynosCameraRequestManager::m_printAllRequestInfo(RequestInfoMap *map, Mutex *lock)
+void ExynosCameraRequestManager::m_printAllRequestInfo(RequestInfoRing *list)
 {
+    RequestInfoMap requestMap;
     RequestInfoMapIterator iter;
     ExynosCameraRequestSP_sprt_t request = NULL;
-    ExynosCameraRequestSP_sprt_t item = NULL;
     camera3_capture_request_t *serviceRequest = NULL;
 
-    lock->lock();
-    iter = map->begin();
+    list->getAll(&requestMap);
 
-    while(iter != map->end()) {
+    for (iter = requestMap.begin(); iter != requestMap.end(); iter++) {
         request = iter->second;
-        item = request;
 
-        serviceRequest = item->getServiceRequest();
+        serviceRequest = request->getServiceRequest();
 
         CLOGI("key(%d), serviceFrameCount(%d), (%p) frame_number(%d), outputNum(%d)",
             request->getKey(),
@@ -1604,10 +1546,7 @@ void ExynosCameraRequestManager::m_printAllRequestInfo(RequestInfoMap *map, Mute
             serviceRequest,
             serviceRequest->frame_number,
             serviceRequest->num_output_buffers);
-
-        iter++;
     }
-    lock->unlock();
 }
 
 status_t ExynosCameraRequestManager::m_pushFactory(int key,
@@ -1673,7 +1612,7 @@ status_t ExynosCameraRequestManager::m_getFactory(int key, ExynosCameraFrameFact
 uint32_t ExynosCameraRequestManager::getAllRequestCount(void)
 {
     Mutex::Autolock l(m_requestLock);
-    return m_serviceRequests.size() + m_runningRequests.size();
+    return m_serviceRequests.size() + m_runningRequests.getSize();
 }
 
 uint32_t ExynosCameraRequestManager::getServiceRequestCount(void)
@@ -1684,8 +1623,7 @@ uint32_t ExynosCameraRequestManager::getServiceRequestCount(void)
 
 uint32_t ExynosCameraRequestManager::getRunningRequestCount(void)
 {
-    Mutex::Autolock lock(m_requestLock);
-    return m_runningRequests.size();
+    return m_runningRequests.getSize();
 }
 
 ExynosCameraRequestSP_sprt_t ExynosCameraRequestManager::eraseFromServiceList(void)
@@ -1709,14 +1647,14 @@ status_t ExynosCameraRequestManager::registerToRunningList(ExynosCameraRequestSP
 
     m_waitFlushDone();
 
-    ret = m_push(request_in, &m_runningRequests, &m_requestLock);
+    ret = m_push(request_in, &m_runningRequests);
     if (ret < 0){
         CLOGE("request m_push is failed request");
         ret = INVALID_OPERATION;
         return ret;
     }
 
-    ret = m_increasePipelineDepth(&m_runningRequests, &m_requestLock);
+    ret = m_increasePipelineDepth(&m_runningRequests);
     if (ret != NO_ERROR)
         CLOGE("Failed to increase the pipeline depth");
 
@@ -1731,7 +1669,7 @@ status_t ExynosCameraRequestManager::m_removeFromRunningList(uint32_t requestKey
     status_t ret = NO_ERROR;
     ExynosCameraRequestSP_sprt_t request = NULL;
 
-    ret = m_pop(requestKey, request, &m_runningRequests, &m_requestLock);
+    ret = m_pop(requestKey, request, &m_runningRequests);
     if (ret < 0){
         ret = INVALID_OPERATION;
         CLOGE("request m_popFront is failed request");
@@ -1761,7 +1699,7 @@ ExynosCameraRequestSP_sprt_t ExynosCameraRequestManager::getRunningRequest(uint3
         return NULL;
     }
 
-    ret = m_get(key, request, &m_runningRequests, &m_requestLock);
+    ret = m_get(key, request, &m_runningRequests);
     if (ret < 0) {
         ret = INVALID_OPERATION;
         CLOGE("request m_popFront is failed request");
@@ -1825,10 +1763,11 @@ status_t ExynosCameraRequestManager::flush()
             eraseFromServiceList();
         }
 
-        while (m_runningRequests.begin() != m_runningRequests.end()) {
-            RequestInfoMapIterator requestMapIter = m_runningRequests.begin();
+        while (m_runningRequests.getSize() > 0) {
+            if (m_runningRequests.getFirst(&request) != NO_ERROR) {
+                break;
+            }
 
-            request = requestMapIter->second;
             requestKey = request->getKey();
 
             notifyMsg = NULL;
@@ -2032,17 +1971,12 @@ status_t ExynosCameraRequestManager::flush()
 status_t ExynosCameraRequestManager::m_getKey(uint32_t *key, uint32_t frameCount)
 {
     status_t ret = NO_ERROR;
-    RequestFrameCountMapIterator iter;
 
-    m_requestFrameCountMapLock.lock();
-    iter = m_requestFrameCountMap.find(frameCount);
-    if (iter != m_requestFrameCountMap.end()) {
-        *key = iter->second;
-    } else {
+    ret = m_requestFrameCountMap.get(frameCount, key);
+    if (ret != NO_ERROR) {
         CLOGE("get request key is failed. request for framecount(%d) is not EXIST", frameCount);
         ret = INVALID_OPERATION;
     }
-    m_requestFrameCountMapLock.unlock();
 
     return ret;
 }
@@ -2050,27 +1984,19 @@ status_t ExynosCameraRequestManager::m_getKey(uint32_t *key, uint32_t frameCount
 status_t ExynosCameraRequestManager::m_popKey(uint32_t *key, uint32_t frameCount)
 {
     status_t ret = NO_ERROR;
-    RequestFrameCountMapIterator iter;
 
-    m_requestFrameCountMapLock.lock();
-    iter = m_requestFrameCountMap.find(frameCount);
-    if (iter != m_requestFrameCountMap.end()) {
-        *key = iter->second;
-        m_requestFrameCountMap.erase(iter);
-    } else {
+    ret = m_requestFrameCountMap.pop(frameCount, key);
+    if (ret != NO_ERROR) {
         CLOGE("get request key is failed. request for framecount(%d) is not EXIST", frameCount);
         ret = INVALID_OPERATION;
     }
-    m_requestFrameCountMapLock.unlock();
 
     return ret;
 }
 
 uint32_t ExynosCameraRequestManager::m_generateResultKey()
 {
-    m_requestResultKeyLock.lock();
     uint32_t key = m_requestResultKey++;
-    m_requestResultKeyLock.unlock();
     return key;
 }
 
@@ -2095,20 +2021,16 @@ status_t ExynosCameraRequestManager::setCallbackOps(const camera3_callback_ops *
 status_t ExynosCameraRequestManager::setFrameCount(uint32_t frameCount, uint32_t requestKey)
 {
     status_t ret = NO_ERROR;
-    pair<RequestFrameCountMapIterator, bool> listRet;
     ExynosCameraRequestSP_sprt_t request = NULL;
 
-    m_requestFrameCountMapLock.lock();
-    listRet = m_requestFrameCountMap.insert(pair<uint32_t, uint32_t>(frameCount, requestKey));
-    if (listRet.second == false) {
+    ret = m_requestFrameCountMap.push(frameCount, requestKey);
+    if (ret != NO_ERROR) {
         ret = INVALID_OPERATION;
         CLOGE("Failed, requestKey(%d) already exist!!", frameCount);
-        m_requestFrameCountMapLock.unlock();
         return ret;
     }
-    m_requestFrameCountMapLock.unlock();
 
-    ret = m_get(requestKey, request, &m_runningRequests, &m_requestLock);
+    ret = m_get(requestKey, request, &m_runningRequests);
     if (ret < 0)
         CLOGE("m_get is failed. requestKey(%d)", requestKey);
 
@@ -2170,7 +2092,7 @@ status_t ExynosCameraRequestManager::m_sendCallbackResult(ResultRequest result)
     camera3_notify_msg_t *notify_msg = NULL;
     ExynosCameraRequestSP_sprt_t request = NULL;
 
-    ret = m_get(result->getRequestKey(), request, &m_runningRequests, &m_requestLock);
+    ret = m_get(result->getRequestKey(), request, &m_runningRequests);
     if (ret < NO_ERROR) {
         CLOGE("[R%d F%d] m_get is failed.",
                 result->getRequestKey(), result->getFrameCount());
@@ -2315,33 +2237,26 @@ status_t ExynosCameraRequestManager::m_callbackOpsNotify(camera3_notify_msg_t *m
     return ret;
 }
 
-/* Increase the pipeline depth value from each request in running request map */
-status_t ExynosCameraRequestManager::m_increasePipelineDepth(RequestInfoMap *map, Mutex *lock)
+/* Increase the pipeline depth value from each request in running request ring */
+status_t ExynosCameraRequestManager::m_increasePipelineDepth(RequestInfoRing *list)
 {
     status_t ret = NO_ERROR;
-    RequestInfoMapIterator requestIter;
-    ExynosCameraRequestSP_sprt_t request = NULL;
 
-    lock->lock();
-    if (map->size() < 1) {
-        CLOGV("map is empty. Skip to increase the pipeline depth");
-        ret = NO_ERROR;
-        goto func_exit;
+    if (list->getSize() < 1) {
+        CLOGV("ring is empty. Skip to increase the pipeline depth");
+        return ret;
     }
 
-    requestIter = map->begin();
-    while (requestIter != map->end()) {
-        request = requestIter->second;
-
-        request->increasePipelineDepth();
-        requestIter++;
-    }
+    list->forEach(m_increaseRequestPipelineDepth);
 
-func_exit:
-    lock->unlock();
     return ret;
 }
 
+void ExynosCameraRequestManager::m_increaseRequestPipelineDepth(ExynosCameraRequestSP_sprt_t &request)
+{
+    request->increasePipelineDepth();
+}
+
 status_t ExynosCameraRequestManager::pushResultRequest(ResultRequest result)
 {
     if (m_resultCallbackThread->isRunning() == false) {
@@ -2414,7 +2329,7 @@ void ExynosCameraRequestManager::dump(void)
     m_printAllServiceRequestInfo();
 
     CLOGD("----- All Remained Request Info (m_runningRequests-----");
-    m_printAllRequestInfo(&m_runningRequests, &m_requestLock);
+    m_printAllRequestInfo(&m_runningRequests);
 }
 
 bool ExynosCameraRequestManager::m_requestDeleteFunc(ExynosCameraRequestSP_sprt_t curRequest)
@@ -2479,7 +2394,7 @@ status_t ExynosCameraRequestManager::m_resultCallback(void)
         return BAD_VALUE;
     }
 
-    ret = m_get(result->getRequestKey(), curRequest, &m_runningRequests, &m_requestLock);
+    ret = m_get(result->getRequestKey(), curRequest, &m_runningRequests);
     if (ret < NO_ERROR) {
         CLOGE("[R%d T%d] m_get is failed.", result->getRequestKey(), result->getType());
         return ret;
@@ -2843,11 +2758,11 @@ status_t ExynosCameraRequestManager::waitforRequestflush()
 {
     int count = 0;
 
-    CLOGD("m_serviceRequest size(%zu) m_runningRequest size(%zu)",
-           m_serviceRequests.size(), m_runningRequests.size());
+    CLOGD("m_serviceRequest size(%zu) m_runningRequest size(%u)",
+           m_serviceRequests.size(), m_runningRequests.getSize());
 
     while (true) {
-        if (m_serviceRequests.size() == 0 && m_runningRequests.size() == 0)
+        if (m_serviceRequests.size() == 0 && m_runningRequests.getSize() == 0)
             break;
 
         usleep(50000);
@@ -2857,8 +2772,8 @@ status_t ExynosCameraRequestManager::waitforRequestflush()
     }
 
     if (count > 200) {
-        CLOGW("m_serviceRequest size(%zu) m_runningRequest size(%zu), count(%d)",
-               m_serviceRequests.size(), m_runningRequests.size(), count);
+        CLOGW("m_serviceRequest size(%zu) m_runningRequest size(%u), count(%d)",
+               m_serviceRequests.size(), m_runningRequests.getSize(), count);
     } else {
         CLOGD("Done : count(%d)", count);
     }
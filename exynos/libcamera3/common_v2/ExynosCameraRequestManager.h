@@ -24,6 +24,7 @@
 #include <CameraMetadata.h>
 #include <map>
 #include <list>
+#include <atomic>
 #include <android/sync.h>
 
 #include "ExynosCameraDefine.h"
@@ -235,19 +236,20 @@ private:
     virtual status_t                       m_init();
     virtual status_t                       m_deinit();
 
-    virtual status_t                       m_push(int key, ExynosCameraFrameFactory* item, FrameFactoryMap *list, Mutex *lock);
-    virtual status_t                       m_pop(int key, ExynosCameraFrameFactory** item, FrameFactoryMap *list, Mutex *lock);
-    virtual status_t                       m_get(int streamID, ExynosCameraFrameFactory** item, FrameFactoryMap *list, Mutex *lock);
-    virtual bool                           m_find(int streamID, FrameFactoryMap *list, Mutex *lock);
-    virtual status_t                       m_getList(FrameFactoryList *factorylist, FrameFactoryMap *list, Mutex *lock);
+    virtual status_t                       m_push(int key, ExynosCameraFrameFactory* item);
+    virtual status_t                       m_pop(int key, ExynosCameraFrameFactory** item);
+    virtual status_t                       m_get(int streamID, ExynosCameraFrameFactory** item);
+    virtual bool                           m_find(int streamID);
+    virtual status_t                       m_getList(FrameFactoryList *factorylist);
     virtual bool                           m_isInputStreamId(int streamId);
     virtual int                            m_getOutputBufferIndex(int streamId);
-    virtual status_t                       m_setCallbackDone(EXYNOS_REQUEST_RESULT::TYPE reqType, bool flag, Mutex *lock);
-    virtual bool                           m_getCallbackDone(EXYNOS_REQUEST_RESULT::TYPE reqType, Mutex *lock);
-    virtual status_t                       m_setCallbackStreamDone(int streamId, bool flag, Mutex *lock);
-    virtual bool                           m_getCallbackStreamDone(int streamId, Mutex *lock);
-    virtual status_t                       m_setStreamBufferStatus(int streamId, camera3_buffer_status_t status, Mutex *lock);
-    virtual camera3_buffer_status_t        m_getStreamBufferStatus(int streamId, Mutex *lock);
+    virtual int                            m_getBufferIndexOfHandle(buffer_handle_t *handle);
+    virtual status_t                       m_setCallbackDone(EXYNOS_REQUEST_RESULT::TYPE reqType, bool flag);
+    virtual bool                           m_getCallbackDone(EXYNOS_REQUEST_RESULT::TYPE reqType);
+    virtual status_t                       m_setCallbackStreamDone(int streamId, bool flag);
+    virtual bool                           m_getCallbackStreamDone(int streamId);
+    virtual status_t                       m_setStreamBufferStatus(int streamId, camera3_buffer_status_t status);
+    virtual camera3_buffer_status_t        m_getStreamBufferStatus(int streamId);
     virtual void                           m_updateMetaDataU8(uint32_t tag, CameraMetadata &resultMeta);
     virtual void                           m_updateMetaDataI32(uint32_t tag, CameraMetadata &resultMeta);
 
@@ -263,37 +265,36 @@ private:
     EXYNOS_REQUEST::STATE         m_requestState;
     int                           m_requestId;
 
-    map<buffer_handle_t *, bool>  m_acquireFenceDoneMap;
-    mutable Mutex                 m_acquireFenceDoneLock;
+    /*
+     * The status of the results is updated by the result callback and the frame
+     * handling threads together, so each one is an atomic instead of a lock of the request.
+     * The index of the buffers is the index of the output buffers, and HAL_STREAM_ID_MAX is
+     * for the input buffer.
+     */
+    std::atomic<bool>             m_acquireFenceDone[HAL_STREAM_ID_MAX + 1];
 
-    bool                          m_resultStatus[EXYNOS_REQUEST_RESULT::CALLBACK_MAX];
-    mutable Mutex                 m_resultStatusLock;
+    std::atomic<bool>             m_resultStatus[EXYNOS_REQUEST_RESULT::CALLBACK_MAX];
 
-    bool                          m_inputStreamDone;
-    bool                          m_outputStreamDone[HAL_STREAM_ID_MAX];
+    std::atomic<bool>             m_inputStreamDone;
+    std::atomic<bool>             m_outputStreamDone[HAL_STREAM_ID_MAX];
 
-    camera3_buffer_status_t       m_inputStreamStatus;
-    camera3_buffer_status_t       m_outputStreamStatus[HAL_STREAM_ID_MAX];
+    std::atomic<camera3_buffer_status_t> m_inputStreamStatus;
+    std::atomic<camera3_buffer_status_t> m_outputStreamStatus[HAL_STREAM_ID_MAX];
     int                           m_streamPipeId[HAL_STREAM_ID_MAX];
     int                           m_streamParentPipeId[HAL_STREAM_ID_MAX];
 
-    mutable Mutex                 m_streamStatusLock;
-
     int                           m_numOfOutputBuffers;
-    int                           m_numOfCompleteBuffers;
+    std::atomic<int>              m_numOfCompleteBuffers;
     List<int>                     m_requestOutputStreamList;
     List<int>                     m_requestInputStreamList;
 
-    FrameFactoryMap               m_factoryMap;
-    mutable Mutex                 m_factoryMapLock;
+    /* indexed by streamID % HAL_STREAM_ID_MAX */
+    std::atomic<ExynosCameraFrameFactory *> m_factory[HAL_STREAM_ID_MAX];
 
     unsigned int                  m_pipelineDepth;
 
-    bool                          m_isSkipMetaResult;
-    mutable Mutex                 m_SkipMetaResultLock;
-
-    bool                          m_isSkipCaptureResult;
-    mutable Mutex                 m_SkipCaptureResultLock;
+    std::atomic<bool>             m_isSkipMetaResult;
+    std::atomic<bool>             m_isSkipCaptureResult;
 
     uint64_t                      m_sensorTimeStampBoot;
 
@@ -341,6 +342,221 @@ private:
 
 typedef ExynosCameraList<ResultRequest> result_queue_t;
 
+/* It must be a power of 2, and larger than the requests in flight in the preview */
+#define REQUEST_RING_SIZE (64)
+
+/*
+ * ExynosCameraRequestRing
+ *
+ * The items in flight, indexed by the key modulo REQUEST_RING_SIZE.
+ * Each slot has its own lock, so the results of the different requests
+ * do not wait for each other. A key whose slot is taken by an older one
+ * still in flight (e.g. a long reprocessing request) is kept in the
+ * overflow map, which is looked up only while it is not empty.
+ */
+template <typename T>
+class ExynosCameraRequestRing {
+public:
+    ExynosCameraRequestRing()
+    {
+        m_numOfItem = 0;
+        m_numOfOverflow = 0;
+        for (int i = 0; i < REQUEST_RING_SIZE; i++) {
+            m_slot[i].valid = false;
+            m_slot[i].key = 0;
+        }
+    }
+
+    status_t push(uint32_t key, T item)
+    {
+        status_t ret = NO_ERROR;
+        ring_slot_t *slot = &m_slot[key & (REQUEST_RING_SIZE - 1)];
+
+        Mutex::Autolock l(slot->lock);
+        if (slot->valid == true && slot->key == key) {
+            return INVALID_OPERATION;
+        }
+
+        if (m_numOfOverflow > 0 || slot->valid == true) {
+            Mutex::Autolock overflowLock(m_overflowLock);
+            if (m_overflow.find(key) != m_overflow.end()) {
+                return INVALID_OPERATION;
+            }
+
+            if (slot->valid == true) {
+                m_overflow.insert(pair<uint32_t, T>(key, item));
+                m_numOfOverflow++;
+                m_numOfItem++;
+                return ret;
+            }
+        }
+
+        slot->key = key;
+        slot->item = item;
+        slot->valid = true;
+        m_numOfItem++;
+
+        return ret;
+    }
+
+    status_t pop(uint32_t key, T *item)
+    {
+        return m_find(key, item, true);
+    }
+
+    status_t get(uint32_t key, T *item)
+    {
+        return m_find(key, item, false);
+    }
+
+    uint32_t getSize(void)
+    {
+        return m_numOfItem;
+    }
+
+    /*
+     * Calls func on every item in place, in no particular order.
+     * The empty slots are skipped without taking their lock.
+     */
+    void forEach(void (*func)(T &item))
+    {
+        for (int i = 0; i < REQUEST_RING_SIZE; i++) {
+            ring_slot_t *slot = &m_slot[i];
+
+            if (slot->valid == false) {
+                continue;
+            }
+
+            Mutex::Autolock l(slot->lock);
+            if (slot->valid == true) {
+                func(slot->item);
+            }
+        }
+
+        if (m_numOfOverflow > 0) {
+            Mutex::Autolock l(m_overflowLock);
+            for (typename map<uint32_t, T>::iterator iter = m_overflow.begin(); iter != m_overflow.end(); iter++) {
+                func(iter->second);
+            }
+        }
+    }
+
+    /* the item of the smallest key */
+    status_t getFirst(T *item)
+    {
+        bool found = false;
+        uint32_t firstKey = 0;
+
+        for (int i = 0; i < REQUEST_RING_SIZE; i++) {
+            ring_slot_t *slot = &m_slot[i];
+
+            if (slot->valid == false) {
+                continue;
+            }
+
+            Mutex::Autolock l(slot->lock);
+            if (slot->valid == true && (found == false || slot->key < firstKey)) {
+                firstKey = slot->key;
+                *item = slot->item;
+                found = true;
+            }
+        }
+
+        if (m_numOfOverflow > 0) {
+            Mutex::Autolock l(m_overflowLock);
+            if (m_overflow.empty() == false && (found == false || m_overflow.begin()->first < firstKey)) {
+                *item = m_overflow.begin()->second;
+                found = true;
+            }
+        }
+
+        return (found == true) ? NO_ERROR : INVALID_OPERATION;
+    }
+
+    /* the snapshot of all items in the key order */
+    void getAll(map<uint32_t, T> *list)
+    {
+        for (int i = 0; i < REQUEST_RING_SIZE; i++) {
+            Mutex::Autolock l(m_slot[i].lock);
+            if (m_slot[i].valid == true) {
+                list->insert(pair<uint32_t, T>(m_slot[i].key, m_slot[i].item));
+            }
+        }
+
+        if (m_numOfOverflow > 0) {
+            Mutex::Autolock l(m_overflowLock);
+            list->insert(m_overflow.begin(), m_overflow.end());
+        }
+    }
+
+    void clear(void)
+    {
+        for (int i = 0; i < REQUEST_RING_SIZE; i++) {
+            Mutex::Autolock l(m_slot[i].lock);
+            if (m_slot[i].valid == true) {
+                m_slot[i].item = T();
+                m_slot[i].valid = false;
+                m_numOfItem--;
+            }
+        }
+
+        Mutex::Autolock l(m_overflowLock);
+        m_numOfItem -= m_overflow.size();
+        m_overflow.clear();
+        m_numOfOverflow = 0;
+    }
+
+private:
+    status_t m_find(uint32_t key, T *item, bool erase)
+    {
+        ring_slot_t *slot = &m_slot[key & (REQUEST_RING_SIZE - 1)];
+
+        {
+            Mutex::Autolock l(slot->lock);
+            if (slot->valid == true && slot->key == key) {
+                *item = slot->item;
+                if (erase == true) {
+                    slot->item = T();
+                    slot->valid = false;
+                    m_numOfItem--;
+                }
+                return NO_ERROR;
+            }
+        }
+
+        if (m_numOfOverflow > 0) {
+            Mutex::Autolock l(m_overflowLock);
+            typename map<uint32_t, T>::iterator iter = m_overflow.find(key);
+            if (iter != m_overflow.end()) {
+                *item = iter->second;
+                if (erase == true) {
+                    m_overflow.erase(iter);
+                    m_numOfOverflow--;
+                    m_numOfItem--;
+                }
+                return NO_ERROR;
+            }
+        }
+
+        return INVALID_OPERATION;
+    }
+
+private:
+    typedef struct ring_slot {
+        Mutex       lock;
+        /* written under the lock, read without it to skip the empty slots */
+        std::atomic<bool> valid;
+        uint32_t    key;
+        T           item;
+    } ring_slot_t;
+
+    ring_slot_t                 m_slot[REQUEST_RING_SIZE];
+    map<uint32_t, T>            m_overflow;
+    Mutex                       m_overflowLock;
+    std::atomic<uint32_t>       m_numOfOverflow;
+    std::atomic<uint32_t>       m_numOfItem;
+};
+
 class ExynosCameraRequestManager : public ExynosCameraObject, public virtual RefBase {
 public:
     /* Constructor */
@@ -398,8 +614,8 @@ private:
     typedef map<uint32_t, ExynosCameraRequestSP_sprt_t>::iterator RequestInfoMapIterator;
     typedef list<ExynosCameraRequestSP_sprt_t>                    RequestInfoList;
     typedef list<ExynosCameraRequestSP_sprt_t>::iterator          RequestInfoListIterator;
-    typedef map<uint32_t, uint32_t>                       RequestFrameCountMap;
-    typedef map<uint32_t, uint32_t>::iterator             RequestFrameCountMapIterator;
+    typedef ExynosCameraRequestRing<ExynosCameraRequestSP_sprt_t> RequestInfoRing;
+    typedef ExynosCameraRequestRing<uint32_t>                     RequestFrameCountRing;
 
     status_t                       m_pushBack(ExynosCameraRequestSP_sprt_t item, RequestInfoList *list, Mutex *lock);
     status_t                       m_popBack(ExynosCameraRequestSP_dptr_t item, RequestInfoList *list, Mutex *lock);
@@ -407,12 +623,12 @@ private:
     status_t                       m_popFront(ExynosCameraRequestSP_dptr_t item, RequestInfoList *list, Mutex *lock);
     status_t                       m_get(uint32_t frameCount, ExynosCameraRequestSP_dptr_t item, RequestInfoList *list, Mutex *lock);
 
-    status_t                       m_push(ExynosCameraRequestSP_sprt_t item, RequestInfoMap *list, Mutex *lock);
-    status_t                       m_pop(uint32_t frameCount, ExynosCameraRequestSP_dptr_t item, RequestInfoMap *list, Mutex *lock);
-    status_t                       m_get(uint32_t frameCount, ExynosCameraRequestSP_dptr_t item, RequestInfoMap *list, Mutex *lock);
+    status_t                       m_push(ExynosCameraRequestSP_sprt_t item, RequestInfoRing *list);
+    status_t                       m_pop(uint32_t frameCount, ExynosCameraRequestSP_dptr_t item, RequestInfoRing *list);
+    status_t                       m_get(uint32_t frameCount, ExynosCameraRequestSP_dptr_t item, RequestInfoRing *list);
 
     void                           m_printAllServiceRequestInfo(void);
-    void                           m_printAllRequestInfo(RequestInfoMap *map, Mutex *lock);
+    void                           m_printAllRequestInfo(RequestInfoRing *list);
 
     status_t                       m_removeFromRunningList(uint32_t requestKey);
 
@@ -430,7 +646,8 @@ private:
     status_t                       m_releaseCameraMetadata(ExynosCameraRequestSP_sprt_t request, ResultRequest result);
     status_t                       m_sendCallbackResult(ResultRequest result);
 
-    status_t                       m_increasePipelineDepth(RequestInfoMap *map, Mutex *lock);
+    status_t                       m_increasePipelineDepth(RequestInfoRing *list);
+    static void                    m_increaseRequestPipelineDepth(ExynosCameraRequestSP_sprt_t &request);
 
     void                           m_debugCallbackFPS();
 
@@ -462,8 +679,8 @@ private:
     mutable Mutex                 m_flushLock;
 
     RequestInfoList               m_serviceRequests;
-    RequestInfoMap                m_runningRequests;
     mutable Mutex                 m_requestLock;
+    RequestInfoRing               m_runningRequests;
 
     camera_metadata_t             *m_defaultRequestTemplate[CAMERA3_TEMPLATE_COUNT];
     CameraMetadata                m_previousMeta;
@@ -473,14 +690,12 @@ private:
 
     const camera3_callback_ops_t  *m_callbackOps;
 
-    int32_t                       m_requestResultKey;
-    mutable Mutex                 m_requestResultKeyLock;
+    std::atomic<int32_t>          m_requestResultKey;
 
     FrameFactoryMap               m_factoryMap;
     mutable Mutex                 m_factoryMapLock;
 
-    RequestFrameCountMap          m_requestFrameCountMap;
-    mutable Mutex                 m_requestFrameCountMapLock;
+    RequestFrameCountRing         m_requestFrameCountMap;
 
     ExynosCameraDurationTimer     m_callbackFlushTimer;
 
@@ -16,9 +16,51 @@
 
 #define LOG_TAG "ExynosCameraTimeLogger"
 
+#include <unistd.h>
+#include <algorithm>
+#include <new>
 
 #include "ExynosCameraTimeLogger.h"
 
+#define TIME_LOGGER_STAGE_KEY(type, category, pipeId) \
+            (((uint64_t)(type) << 48) | ((uint64_t)(category) << 32) | (uint64_t)(pipeId))
+#define TIME_LOGGER_DURATION_KEY(cameraId, type, category, pipeId) \
+            (((uint64_t)(cameraId) << 56) | TIME_LOGGER_STAGE_KEY(type, category, pipeId))
+
+/* log2 buckets, each split into 2^TIME_LOGGER_HISTOGRAM_SUB_BITS linear sub buckets */
+static inline uint32_t getHistogramIndex(uint32_t value)
+{
+    uint32_t exp;
+
+    if (value < (1U << TIME_LOGGER_HISTOGRAM_SUB_BITS))
+        return value;
+
+    exp = 31 - __builtin_clz(value);
+    return ((exp - TIME_LOGGER_HISTOGRAM_SUB_BITS + 1) << TIME_LOGGER_HISTOGRAM_SUB_BITS)
+            | ((value >> (exp - TIME_LOGGER_HISTOGRAM_SUB_BITS)) & ((1U << TIME_LOGGER_HISTOGRAM_SUB_BITS) - 1));
+}
+
+/* the largest value of the bucket */
+static inline uint32_t getHistogramValue(uint32_t index)
+{
+    uint32_t exp;
+    uint64_t value;
+
+    if (index < (1U << TIME_LOGGER_HISTOGRAM_SUB_BITS))
+        return index;
+
+    exp = (index >> TIME_LOGGER_HISTOGRAM_SUB_BITS) + TIME_LOGGER_HISTOGRAM_SUB_BITS - 1;
+    value = (uint64_t)((1U << TIME_LOGGER_HISTOGRAM_SUB_BITS) | (index & ((1U << TIME_LOGGER_HISTOGRAM_SUB_BITS) - 1)));
+    value = ((value + 1) << (exp - TIME_LOGGER_HISTOGRAM_SUB_BITS)) - 1;
+
+    return (uint32_t)value;
+}
+
+static bool compareTimeStamp(const ExynosCameraTimeLogger::timeLogger_t &a, const ExynosCameraTimeLogger::timeLogger_t &b)
+{
+    return a.timeStamp < b.timeStamp;
+}
+
 /*
  * Class ExynosCameraTimeLogger
  */
@@ -122,36 +164,81 @@ ExynosCameraTimeLogger::ExynosCameraTimeLogger()
     m_categoryStr[LOGGER_CATEGORY_POST_DESTRUCTOR_END]                  = MAKE_STRING(POST_DESTRUCTOR_END);
 
     for (int i = 0; i < CAMERA_ID_MAX; i++) {
-        m_buffer[i] = NULL;
-        m_bufferIndex[i] = 0;
+        m_stage[i] = NULL;
         m_stopFlag[i] = true;
-        m_firstCheckFlag[i] = true;
+        m_count[i] = 0;
+        m_initTime[i] = 0;
+        m_realTimeOffset[i] = 0;
+        m_numDropped[i] = 0;
     }
+
+    for (int i = 0; i < TIME_LOGGER_THREAD_MAX; i++) {
+        m_thread[i].inUse = false;
+        m_thread[i].head = 0;
+        m_thread[i].ring = NULL;
+        m_thread[i].size = 0;
+        m_thread[i].tid = 0;
+        m_thread[i].numDuration = 0;
+    }
+
+    /* the ring index is masked, so round down to a power of 2 */
+    int32_t ringSize = property_get_int32(TIME_LOGGER_SIZE_PROPERTY, TIME_LOGGER_SIZE);
+    if (ringSize < TIME_LOGGER_SIZE_MIN)
+        ringSize = TIME_LOGGER_SIZE_MIN;
+    else if (ringSize > TIME_LOGGER_SIZE_MAX)
+        ringSize = TIME_LOGGER_SIZE_MAX;
+    m_ringSize = 1U << (31 - __builtin_clz((uint32_t)ringSize));
+
+    pthread_key_create(&m_threadKey, m_releaseThread);
 }
 
 ExynosCameraTimeLogger::~ExynosCameraTimeLogger()
-{}
+{
+    pthread_key_delete(m_threadKey);
+
+    for (int i = 0; i < TIME_LOGGER_THREAD_MAX; i++) {
+        if (m_thread[i].ring != NULL)
+            delete[] m_thread[i].ring;
+    }
+
+    for (int i = 0; i < CAMERA_ID_MAX; i++) {
+        if (m_stage[i] != NULL)
+            delete[] m_stage[i];
+    }
+}
 
 status_t ExynosCameraTimeLogger::init(int cameraId)
 {
     status_t ret = NO_ERROR;
+    timeLoggerStage_t *stage;
 
     CLOGD3(cameraId, "");
 
-    /* alloc buffer for dump */
-    m_buffer[cameraId] = (timeLogger_t *)malloc(sizeof(timeLogger_t) * TIME_LOGGER_SIZE);
-    if (m_buffer[cameraId] == NULL) {
-        CLOGE3(cameraId, "can't alloc buffer");
-        return INVALID_OPERATION;
+    /* the histograms are kept after save() to be read */
+    if (m_stage[cameraId] == NULL) {
+        m_stage[cameraId] = new (std::nothrow) timeLoggerStage_t[TIME_LOGGER_STAGE_MAX]();
+        if (m_stage[cameraId] == NULL) {
+            CLOGE3(cameraId, "can't alloc histogram");
+            return INVALID_OPERATION;
+        }
+    } else {
+        for (int i = 0; i < TIME_LOGGER_STAGE_MAX; i++) {
+            stage = &m_stage[cameraId][i];
+            stage->key.store(0, std::memory_order_relaxed);
+            stage->lastTime.store(0, std::memory_order_relaxed);
+            stage->sum.store(0, std::memory_order_relaxed);
+            stage->max.store(0, std::memory_order_relaxed);
+            for (int j = 0; j < TIME_LOGGER_HISTOGRAM_SIZE; j++)
+                stage->bucket[j].store(0, std::memory_order_relaxed);
+        }
     }
 
-    memset(m_buffer[cameraId], 0x0, sizeof(timeLogger_t) * TIME_LOGGER_SIZE);
-
     /* init the variables */
-    m_bufferIndex[cameraId] = 0;
-    m_stopFlag[cameraId] = false;
-    m_firstCheckFlag[cameraId] = false;
     m_count[cameraId] = 0;
+    m_numDropped[cameraId] = 0;
+    m_initTime[cameraId] = systemTime(SYSTEM_TIME_MONOTONIC);
+    m_realTimeOffset[cameraId] = systemTime(SYSTEM_TIME_REALTIME) - m_initTime[cameraId];
+    m_stopFlag[cameraId] = false;
 
     return ret;
 }
@@ -159,18 +246,20 @@ status_t ExynosCameraTimeLogger::init(int cameraId)
 status_t ExynosCameraTimeLogger::update(int cameraId, uint64_t key, uint32_t pipeId, LOGGER_TYPE type, LOGGER_CATEGORY category, uint64_t userData)
 {
     status_t ret = NO_ERROR;
-    ExynosCameraDurationTimer *timer;
+    timeLoggerThread_t *thread;
+    timeLoggerStage_t *stage = NULL;
+    timeLoggerRecord_t *record;
     timeLogger_t *buffer;
-    int bufferIndex;
+    uint64_t durationKey;
+    int64_t timeStamp;
+    int64_t startTime = 0;
+    uint32_t calTime = 0;
+    uint32_t head;
+    int i;
 
     if (m_stopFlag[cameraId] == true || checkCondition(category) == false)
         return ret;
 
-    if (m_buffer[cameraId] == NULL) {
-        CLOGE3(cameraId, "can't alloc buffer");
-        return INVALID_OPERATION;
-    }
-
     if (type <= LOGGER_TYPE_BASE || type >= LOGGER_TYPE_MAX) {
         CLOGE3(cameraId, "invalid type(%d)", type);
         return INVALID_OPERATION;
@@ -181,75 +270,86 @@ status_t ExynosCameraTimeLogger::update(int cameraId, uint64_t key, uint32_t pip
         return INVALID_OPERATION;
     }
 
-    timer = &m_timer[cameraId][type][category][pipeId];
+    thread = m_getThread();
+    timeStamp = systemTime(SYSTEM_TIME_MONOTONIC);
 
     switch (type) {
     case LOGGER_TYPE_INTERVAL:
-        timer->stop();
+        stage = m_getStage(cameraId, TIME_LOGGER_STAGE_KEY(type, category, pipeId));
+        if (stage == NULL)
+            goto p_drop;
 
-        if (m_firstCheckFlag[cameraId] == false) {
-            timer->start();
-            m_firstCheckFlag[cameraId] = true;
-        } else {
-            goto p_logger;
-        }
+        startTime = stage->lastTime.exchange(timeStamp, std::memory_order_relaxed);
+        if (startTime == 0)
+            return ret;
         break;
     case LOGGER_TYPE_DURATION:
+        if (thread == NULL)
+            goto p_drop;
+
+        durationKey = TIME_LOGGER_DURATION_KEY(cameraId, type, category, pipeId);
+        for (i = 0; i < thread->numDuration; i++) {
+            if (thread->durationKey[i] == durationKey)
+                break;
+        }
+
         if (userData) {
-            timer->start();
-        } else {
-            timer->stop();
-            goto p_logger;
+            if (i == thread->numDuration) {
+                if (thread->numDuration >= TIME_LOGGER_THREAD_DURATION_MAX)
+                    goto p_drop;
+                thread->durationKey[thread->numDuration++] = durationKey;
+            }
+            thread->durationTime[i] = timeStamp;
+            return ret;
         }
+
+        /* stop without start */
+        if (i == thread->numDuration)
+            return ret;
+
+        startTime = thread->durationTime[i];
+        thread->numDuration--;
+        thread->durationKey[i] = thread->durationKey[thread->numDuration];
+        thread->durationTime[i] = thread->durationTime[thread->numDuration];
+
+        stage = m_getStage(cameraId, TIME_LOGGER_STAGE_KEY(type, category, pipeId));
         break;
     case LOGGER_TYPE_CUMULATIVE_CNT:
-        if (m_firstCheckFlag[cameraId] == false) {
-            m_count[cameraId] = 1;
-            m_firstCheckFlag[cameraId] = true;
-        } else {
-            m_count[cameraId]++;
-        }
-        goto p_logger;
+        calTime = android_atomic_inc(&m_count[cameraId]) + 1;
         break;
     case LOGGER_TYPE_USER_DATA:
-        goto p_logger;
+        calTime = userData;
         break;
     default:
         break;
     }
 
-    return ret;
+    /* save the time(us) or count */
+    if (startTime != 0) {
+        calTime = (timeStamp - startTime) / 1000LL;
+        if (stage != NULL)
+            m_addSample(stage, calTime);
+    }
 
-p_logger:
-    bufferIndex = (android_atomic_inc(&m_bufferIndex[cameraId])) % TIME_LOGGER_SIZE;
-    buffer = &m_buffer[cameraId][bufferIndex];
+    if (thread == NULL)
+        goto p_drop;
 
-    /* save the time(us) or count */
-    switch (type) {
-    case LOGGER_TYPE_INTERVAL:
-        buffer->calTime = timer->durationUsecs();
-        /* for interval time */
-        if (type == LOGGER_TYPE_INTERVAL)
-            timer->start();
-        break;
-    case LOGGER_TYPE_DURATION:
-        buffer->calTime = timer->durationUsecs();
-        break;
-    case LOGGER_TYPE_CUMULATIVE_CNT:
-        buffer->calTime = m_count[cameraId];
-        break;
-    case LOGGER_TYPE_USER_DATA:
-        buffer->calTime = userData;
-        break;
-    default:
-        break;
-    };
-    buffer->timeStamp = systemTime(SYSTEM_TIME_REALTIME) / 1000000LL;
-    buffer->cameraId = cameraId;
+    head = thread->head.load(std::memory_order_relaxed);
+    record = &thread->ring[head & (thread->size - 1)];
+    record->seq.store(head * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    buffer = &record->logger;
+    buffer->timeStamp = timeStamp;
     buffer->key = key;
     buffer->pipeId = pipeId;
+    buffer->calTime = calTime;
+    buffer->tid = thread->tid;
+    buffer->cameraId = cameraId;
     buffer->type = type;
     buffer->category = category;
+    record->seq.store(head * 2 + 2, std::memory_order_release);
+    thread->head.store(head + 1, std::memory_order_release);
 
     CLOGV3(cameraId, "TimeStamp:%jd,Key:%jd,Pipe:%d,Type:%s,Cate:%s,CalT:%d",
             buffer->timeStamp,
@@ -260,6 +360,10 @@ p_logger:
             buffer->calTime);
 
     return ret;
+
+p_drop:
+    m_numDropped[cameraId].fetch_add(1, std::memory_order_relaxed);
+    return ret;
 }
 
 status_t ExynosCameraTimeLogger::save(int cameraId)
@@ -267,22 +371,20 @@ status_t ExynosCameraTimeLogger::save(int cameraId)
     status_t ret = NO_ERROR;
     FILE *fd = NULL;
     char filePath[128];
+    std::vector<timeLogger_t> events;
     timeLogger_t *buffer;
 
-    if (m_stopFlag[cameraId] == true) {
+    if (m_stopFlag[cameraId] == true)
         return ret;
-    } else if (m_bufferIndex[cameraId] == 0) {
+
+    m_collect(cameraId, &events);
+    if (events.size() == 0) {
         CLOGD3(cameraId, "No data to save");
         return ret;
     }
 
     m_stopFlag[cameraId] = true;
 
-    if (m_buffer[cameraId] == NULL) {
-        CLOGE3(cameraId, "can't alloc buffer");
-        return INVALID_OPERATION;
-    }
-
     snprintf(filePath, sizeof(filePath), TIME_LOGGER_PATH, cameraId, (unsigned long long)systemTime(SYSTEM_TIME_MONOTONIC));
 
     fd = fopen(filePath, "w+");
@@ -295,13 +397,11 @@ status_t ExynosCameraTimeLogger::save(int cameraId)
 
     /* save the file */
     fprintf(fd, "timestamp(ms),key,pipeId,type,category,calTime(us)\n");
-    for (int i = 0; i < TIME_LOGGER_SIZE; i++) {
-        buffer = &m_buffer[cameraId][i];
-        if (buffer->timeStamp == 0)
-            continue;
+    for (size_t i = 0; i < events.size(); i++) {
+        buffer = &events[i];
 
         fprintf(fd, "%jd,%jd,%d,%s,%s,%d\n",
-                buffer->timeStamp,
+                (intmax_t)((buffer->timeStamp + m_realTimeOffset[cameraId]) / 1000000LL),
                 buffer->key,
                 buffer->pipeId,
                 m_typeStr[buffer->type],
@@ -314,15 +414,352 @@ status_t ExynosCameraTimeLogger::save(int cameraId)
 
     CLOGD3(cameraId, "success!! to save the time logger(%s)", filePath);
 
-    /* free the memory */
     if (fd)
         fclose(fd);
-    free(m_buffer[cameraId]);
-    m_buffer[cameraId] = NULL;
+
+    ret = m_saveTrace(cameraId, &events);
+
+    dumpStatistics(cameraId);
 
     return ret;
 }
 
+status_t ExynosCameraTimeLogger::saveTrace(int cameraId)
+{
+    std::vector<timeLogger_t> events;
+
+    m_collect(cameraId, &events);
+    if (events.size() == 0) {
+        CLOGD3(cameraId, "No data to save");
+        return NO_ERROR;
+    }
+
+    return m_saveTrace(cameraId, &events);
+}
+
+status_t ExynosCameraTimeLogger::getLoggers(int cameraId, std::vector<timeLogger_t> *loggers)
+{
+    if (loggers == NULL) {
+        CLOGE3(cameraId, "loggers is NULL");
+        return BAD_VALUE;
+    }
+
+    loggers->clear();
+    m_collect(cameraId, loggers);
+
+    return NO_ERROR;
+}
+
+status_t ExynosCameraTimeLogger::getStatistics(int cameraId, uint32_t pipeId, LOGGER_TYPE type, LOGGER_CATEGORY category, timeLoggerStatistics_t *statistics)
+{
+    timeLoggerStage_t *stage;
+
+    if (statistics == NULL) {
+        CLOGE3(cameraId, "statistics is NULL");
+        return BAD_VALUE;
+    }
+
+    if (type != LOGGER_TYPE_INTERVAL && type != LOGGER_TYPE_DURATION) {
+        CLOGE3(cameraId, "invalid type(%d)", type);
+        return BAD_VALUE;
+    }
+
+    stage = m_findStage(cameraId, TIME_LOGGER_STAGE_KEY(type, category, pipeId));
+    if (stage == NULL)
+        return NAME_NOT_FOUND;
+
+    m_getStageStatistics(stage, statistics);
+
+    return NO_ERROR;
+}
+
+void ExynosCameraTimeLogger::dumpStatistics(int cameraId)
+{
+    timeLoggerStage_t *stage;
+    timeLoggerStatistics_t statistics;
+    uint64_t stageKey;
+
+    if (m_stage[cameraId] == NULL)
+        return;
+
+    for (int i = 0; i < TIME_LOGGER_STAGE_MAX; i++) {
+        stage = &m_stage[cameraId][i];
+        stageKey = stage->key.load(std::memory_order_acquire);
+        if (stageKey == 0)
+            continue;
+
+        m_getStageStatistics(stage, &statistics);
+        CLOGD3(cameraId, "Pipe:%d,Type:%s,Cate:%s,Count:%d,Avg:%d,P50:%d,P99:%d,Max:%d(us)",
+                (uint32_t)stageKey,
+                m_typeStr[(stageKey >> 48) & 0xFFFF],
+                m_categoryStr[(stageKey >> 32) & 0xFFFF],
+                statistics.count,
+                statistics.avg,
+                statistics.p50,
+                statistics.p99,
+                statistics.max);
+    }
+
+    if (m_numDropped[cameraId] > 0)
+        CLOGW3(cameraId, "%d loggers are dropped", (uint32_t)m_numDropped[cameraId]);
+}
+
+void ExynosCameraTimeLogger::m_releaseThread(void *thread)
+{
+    /* keep the ring to be saved, the next thread continues from its head */
+    ((timeLoggerThread_t *)thread)->inUse.store(false, std::memory_order_release);
+}
+
+ExynosCameraTimeLogger::timeLoggerThread_t *ExynosCameraTimeLogger::m_getThread(void)
+{
+    timeLoggerThread_t *thread = (timeLoggerThread_t *)pthread_getspecific(m_threadKey);
+    bool inUse;
+
+    if (thread != NULL)
+        return thread;
+
+    for (int i = 0; i < TIME_LOGGER_THREAD_MAX; i++) {
+        thread = &m_thread[i];
+        inUse = false;
+        if (thread->inUse.compare_exchange_strong(inUse, true, std::memory_order_acquire) == false)
+            continue;
+
+        if (thread->ring == NULL) {
+            timeLoggerRecord_t *ring = new (std::nothrow) timeLoggerRecord_t[m_ringSize]();
+            if (ring == NULL) {
+                thread->inUse.store(false, std::memory_order_release);
+                return NULL;
+            }
+            thread->ring = ring;
+            thread->size = m_ringSize;
+        }
+        thread->tid = gettid();
+        thread->numDuration = 0;
+
+        pthread_setspecific(m_threadKey, thread);
+        return thread;
+    }
+
+    return NULL;
+}
+
+ExynosCameraTimeLogger::timeLoggerStage_t *ExynosCameraTimeLogger::m_getStage(int cameraId, uint64_t stageKey)
+{
+    timeLoggerStage_t *stage;
+    uint32_t slot = ((uint32_t)(stageKey ^ (stageKey >> 32)) * 0x9E3779B1U) & (TIME_LOGGER_STAGE_MAX - 1);
+    uint64_t key;
+
+    for (int i = 0; i < TIME_LOGGER_STAGE_MAX; i++) {
+        stage = &m_stage[cameraId][slot];
+        key = stage->key.load(std::memory_order_acquire);
+        if (key == stageKey)
+            return stage;
+
+        if (key == 0) {
+            if (stage->key.compare_exchange_strong(key, stageKey, std::memory_order_acq_rel)
+                || key == stageKey)
+                return stage;
+        }
+
+        slot = (slot + 1) & (TIME_LOGGER_STAGE_MAX - 1);
+    }
+
+    return NULL;
+}
+
+ExynosCameraTimeLogger::timeLoggerStage_t *ExynosCameraTimeLogger::m_findStage(int cameraId, uint64_t stageKey)
+{
+    timeLoggerStage_t *stage;
+    uint32_t slot = ((uint32_t)(stageKey ^ (stageKey >> 32)) * 0x9E3779B1U) & (TIME_LOGGER_STAGE_MAX - 1);
+    uint64_t key;
+
+    if (m_stage[cameraId] == NULL)
+        return NULL;
+
+    for (int i = 0; i < TIME_LOGGER_STAGE_MAX; i++) {
+        stage = &m_stage[cameraId][slot];
+        key = stage->key.load(std::memory_order_acquire);
+        if (key == stageKey)
+            return stage;
+        else if (key == 0)
+            break;
+
+        slot = (slot + 1) & (TIME_LOGGER_STAGE_MAX - 1);
+    }
+
+    return NULL;
+}
+
+void ExynosCameraTimeLogger::m_addSample(timeLoggerStage_t *stage, uint32_t calTime)
+{
+    uint32_t max = stage->max.load(std::memory_order_relaxed);
+
+    stage->bucket[getHistogramIndex(calTime)].fetch_add(1, std::memory_order_relaxed);
+    stage->sum.fetch_add(calTime, std::memory_order_relaxed);
+
+    while (calTime > max
+           && stage->max.compare_exchange_weak(max, calTime, std::memory_order_relaxed) == false);
+}
+
+void ExynosCameraTimeLogger::m_getStageStatistics(timeLoggerStage_t *stage, timeLoggerStatistics_t *statistics)
+{
+    uint32_t bucket[TIME_LOGGER_HISTOGRAM_SIZE];
+    uint64_t count = 0;
+    uint64_t p50Count, p99Count;
+    uint64_t sum = 0;
+
+    memset(statistics, 0x0, sizeof(timeLoggerStatistics_t));
+
+    for (int i = 0; i < TIME_LOGGER_HISTOGRAM_SIZE; i++) {
+        bucket[i] = stage->bucket[i].load(std::memory_order_relaxed);
+        count += bucket[i];
+    }
+
+    if (count == 0)
+        return;
+
+    statistics->count = count;
+    statistics->max = stage->max.load(std::memory_order_relaxed);
+    statistics->avg = stage->sum.load(std::memory_order_relaxed) / count;
+
+    p50Count = (count * 50 + 99) / 100;
+    p99Count = (count * 99 + 99) / 100;
+    for (int i = 0; i < TIME_LOGGER_HISTOGRAM_SIZE; i++) {
+        if (bucket[i] == 0)
+            continue;
+
+        sum += bucket[i];
+        if (statistics->p50 == 0 && sum >= p50Count)
+            statistics->p50 = getHistogramValue(i);
+        if (sum >= p99Count) {
+            statistics->p99 = getHistogramValue(i);
+            break;
+        }
+    }
+
+    if (statistics->p50 > statistics->max)
+        statistics->p50 = statistics->max;
+    if (statistics->p99 > statistics->max)
+        statistics->p99 = statistics->max;
+}
+
+void ExynosCameraTimeLogger::m_collect(int cameraId, std::vector<timeLogger_t> *events)
+{
+    timeLoggerThread_t *thread;
+    timeLoggerRecord_t *record;
+    timeLogger_t buffer;
+    uint32_t head, tail, index, seq;
+    uint32_t numSkipped = 0;
+
+    for (int i = 0; i < TIME_LOGGER_THREAD_MAX; i++) {
+        thread = &m_thread[i];
+        head = thread->head.load(std::memory_order_acquire);
+        if (head == 0)
+            continue;
+
+        tail = (head > thread->size) ? (head - thread->size) : 0;
+        for (index = tail; index != head; index++) {
+            record = &thread->ring[index & (thread->size - 1)];
+
+            /* skip the logger which the owner is writing or has overwritten, before or while copying */
+            seq = record->seq.load(std::memory_order_acquire);
+            if (seq != index * 2 + 2) {
+                numSkipped++;
+                continue;
+            }
+
+            buffer = record->logger;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (record->seq.load(std::memory_order_relaxed) != seq) {
+                numSkipped++;
+                continue;
+            }
+
+            if (buffer.cameraId == cameraId && buffer.timeStamp >= m_initTime[cameraId])
+                events->push_back(buffer);
+        }
+    }
+
+    if (numSkipped > 0)
+        CLOGD3(cameraId, "%d loggers are overwritten while copying", numSkipped);
+
+    std::sort(events->begin(), events->end(), compareTimeStamp);
+}
+
+status_t ExynosCameraTimeLogger::m_saveTrace(int cameraId, std::vector<timeLogger_t> *events)
+{
+    FILE *fd = NULL;
+    char filePath[128];
+    bool pipeNamed[MAX_PIPE_NUM];
+    timeLogger_t *buffer;
+    int64_t timeStamp;
+
+    snprintf(filePath, sizeof(filePath), TIME_LOGGER_TRACE_PATH, cameraId, (unsigned long long)systemTime(SYSTEM_TIME_MONOTONIC));
+
+    fd = fopen(filePath, "w+");
+    if (fd == NULL) {
+        CLOGE3(cameraId, "can't open file(%s)", filePath);
+        return INVALID_OPERATION;
+    }
+
+    /*
+     * chrome trace event format : chrome://tracing or ui.perfetto.dev
+     * one process per camera, one track per pipe
+     */
+    fprintf(fd, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(fd, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"camera%d\"}}",
+            cameraId, cameraId);
+
+    memset(pipeNamed, 0x0, sizeof(pipeNamed));
+    for (size_t i = 0; i < events->size(); i++) {
+        buffer = &(*events)[i];
+
+        if (buffer->pipeId < MAX_PIPE_NUM && pipeNamed[buffer->pipeId] == false) {
+            fprintf(fd, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"pipe%d\"}}",
+                    cameraId, buffer->pipeId, buffer->pipeId);
+            pipeNamed[buffer->pipeId] = true;
+        }
+
+        timeStamp = buffer->timeStamp / 1000LL;
+
+        switch (buffer->type) {
+        case LOGGER_TYPE_INTERVAL:
+        case LOGGER_TYPE_DURATION:
+            fprintf(fd, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,"
+                    "\"ts\":%jd,\"dur\":%d,\"args\":{\"key\":%ju,\"tid\":%d}}",
+                    m_categoryStr[buffer->category],
+                    m_typeStr[buffer->type],
+                    cameraId,
+                    buffer->pipeId,
+                    (intmax_t)(timeStamp - buffer->calTime),
+                    buffer->calTime,
+                    (uintmax_t)buffer->key,
+                    buffer->tid);
+            break;
+        default:
+            fprintf(fd, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%d,"
+                    "\"ts\":%jd,\"args\":{\"key\":%ju,\"value\":%d,\"tid\":%d}}",
+                    m_categoryStr[buffer->category],
+                    m_typeStr[buffer->type],
+                    cameraId,
+                    buffer->pipeId,
+                    (intmax_t)timeStamp,
+                    (uintmax_t)buffer->key,
+                    buffer->calTime,
+                    buffer->tid);
+            break;
+        }
+    }
+    fprintf(fd, "\n]}\n");
+
+    fflush(fd);
+    fclose(fd);
+
+    CLOGD3(cameraId, "success!! to save the time logger trace(%s)", filePath);
+
+    return NO_ERROR;
+}
+
 bool ExynosCameraTimeLogger::checkCondition(LOGGER_CATEGORY category)
 {
     if (category > LOGGER_CATEGORY_LAUNCHING_TIME_START
@@ -28,20 +28,34 @@
 #define EXYNOS_CAMERA_TIME_LOGGER_H
 
 #include "string.h"
+#include <pthread.h>
 #include <utils/Log.h>
 #include <cutils/atomic.h>
 
+#include <atomic>
+#include <vector>
+
 #include "ExynosCameraUtils.h"
 #include "ExynosCameraAutoTimer.h"
 #include "ExynosCameraCommonInclude.h"
 #include "ExynosCameraSingleton.h"
 #include "ExynosCameraSensorInfoBase.h"
 
-#define TIME_LOGGER_SIZE (1024 * 100) /* 100K * logger */
+#define TIME_LOGGER_SIZE (1024) /* default loggers per thread, power of 2 */
+#define TIME_LOGGER_SIZE_MIN (64)
+#define TIME_LOGGER_SIZE_MAX (1024 * 64)
+#define TIME_LOGGER_SIZE_PROPERTY "vendor.camera.time_logger.size" /* loggers per thread */
+#define TIME_LOGGER_THREAD_MAX (64)
+#define TIME_LOGGER_THREAD_DURATION_MAX (16) /* DURATION loggers started and not stopped yet per thread */
+#define TIME_LOGGER_STAGE_MAX (128) /* histograms per camera, power of 2 */
+#define TIME_LOGGER_HISTOGRAM_SUB_BITS (4)
+#define TIME_LOGGER_HISTOGRAM_SIZE ((33 - TIME_LOGGER_HISTOGRAM_SUB_BITS) << TIME_LOGGER_HISTOGRAM_SUB_BITS)
 #ifdef CAMERA_GED_FEATURE
 #define TIME_LOGGER_PATH "/data/dump/exynos_camera_time_logger_cam%d_%lld.csv"
+#define TIME_LOGGER_TRACE_PATH "/data/dump/exynos_camera_time_logger_cam%d_%lld.json"
 #else
 #define TIME_LOGGER_PATH "/data/camera/exynos_camera_time_logger_cam%d_%lld.csv"
+#define TIME_LOGGER_TRACE_PATH "/data/camera/exynos_camera_time_logger_cam%d_%lld.json"
 #endif
 
 #define TIME_LOGGER_INIT_BASE(logger, cameraId)          \
@@ -50,6 +64,8 @@
             ({ (logger)->update(cameraId, key, pipeId, LOGGER_TYPE_ ## type, LOGGER_CATEGORY_ ## category, userData); })
 #define TIME_LOGGER_SAVE_BASE(logger, cameraId)          \
             ({ (logger)->save(cameraId); })
+#define TIME_LOGGER_DUMP_BASE(logger, cameraId)          \
+            ({ (logger)->dumpStatistics(cameraId); })
 
 #ifdef TIME_LOGGER_ENABLE
 #define TIME_LOGGER_INIT(cameraId)          \
@@ -68,11 +84,17 @@
             ExynosCameraTimeLogger *logger = ExynosCameraSingleton<ExynosCameraTimeLogger>::getInstance(); \
             TIME_LOGGER_SAVE_BASE(logger, cameraId);         \
         })
+#define TIME_LOGGER_DUMP(cameraId)          \
+        ({                                  \
+            ExynosCameraTimeLogger *logger = ExynosCameraSingleton<ExynosCameraTimeLogger>::getInstance(); \
+            TIME_LOGGER_DUMP_BASE(logger, cameraId);         \
+        })
 #else
 #define TIME_LOGGER_INIT(cameraId)
 #define TIME_LOGGER_UPDATE(cameraId, key, pipeId, type, category, userData) \
         ({LOGGER_TYPE_ ## type; LOGGER_CATEGORY_ ## category; })
 #define TIME_LOGGER_SAVE(cameraId)
+#define TIME_LOGGER_DUMP(cameraId)
 #endif
 
 using namespace android;
@@ -188,23 +210,39 @@ typedef enum LOGGER_CATEGORY {
 /*
  * Class ExynosCameraTimeLogger
  * ExynosCameraTimeLogger is the time logging class for profiling performance.
- * This class cannot support concurrent processing of timelogging for same logger
+ * Every thread records into its own ring, so update() takes no lock and the rings
+ * keep the latest loggers of each thread until save().
+ * A ring is allocated by the first update() of a thread and holds TIME_LOGGER_SIZE
+ * loggers, or the power of 2 set by TIME_LOGGER_SIZE_PROPERTY.
+ * INTERVAL and DURATION times also go to a histogram per logger, which can be
+ * read at any time with getStatistics() or dumpStatistics().
  * (same logger condition : same pipeLine && same logger_type && same logger_category)
+ *  - INTERVAL : time between two updates of the same logger, from any thread
+ *  - DURATION : start and stop must be called by the same thread
  */
 class ExynosCameraTimeLogger
 {
 public:
 
     typedef struct timeLogger {
-        uint64_t timeStamp;     /* ns : logging time */
-        int cameraId;
+        int64_t timeStamp;      /* ns : monotonic logging time */
         uint64_t key;
         uint32_t pipeId;
-        LOGGER_TYPE type;
-        LOGGER_CATEGORY category;
         uint32_t calTime;       /* us : cacluated time(duration, interval..) */
+        int32_t tid;
+        uint8_t cameraId;
+        uint8_t type;
+        uint16_t category;
     } timeLogger_t;
 
+    typedef struct timeLoggerStatistics {
+        uint32_t count;
+        uint32_t avg;           /* us */
+        uint32_t p50;           /* us */
+        uint32_t p99;           /* us */
+        uint32_t max;           /* us */
+    } timeLoggerStatistics_t;
+
     /* memset all logger information */
     status_t init(int cameraId);
 
@@ -229,10 +267,32 @@ public:
     status_t update(int cameraId, uint64_t key, uint32_t pipeId, LOGGER_TYPE type, LOGGER_CATEGORY category, uint64_t userData);
 
     /*
-     * save all information to file
+     * save all information to file, as csv and as chrome trace event json
      */
     status_t save(int cameraId);
 
+    /*
+     * save the loggers to chrome trace event json without stopping the logging
+     */
+    status_t saveTrace(int cameraId);
+
+    /*
+     * copy the loggers of the camera in time order without stopping the logging
+     * loggers overwritten while they are copied are skipped
+     */
+    status_t getLoggers(int cameraId, std::vector<timeLogger_t> *loggers);
+
+    /*
+     * get the statistics of INTERVAL or DURATION logger
+     * percentiles are the upper bound of the histogram bucket (within 1/16)
+     */
+    status_t getStatistics(int cameraId, uint32_t pipeId, LOGGER_TYPE type, LOGGER_CATEGORY category, timeLoggerStatistics_t *statistics);
+
+    /*
+     * print the statistics of all INTERVAL and DURATION loggers
+     */
+    void dumpStatistics(int cameraId);
+
     /*
      * check define condition to do logging
      */
@@ -242,13 +302,55 @@ public:
     ExynosCameraTimeLogger();
     virtual ~ExynosCameraTimeLogger();
 
+private:
+    /*
+     * seq is odd while the owner writes the logger and 2 * (index + 1) after,
+     * so a reader knows whether its copy is complete and is the one it looked for
+     */
+    typedef struct timeLoggerRecord {
+        std::atomic<uint32_t> seq;
+        timeLogger_t logger;
+    } timeLoggerRecord_t;
+
+    /* written only by the owner thread, head is published after the event */
+    typedef struct timeLoggerThread {
+        std::atomic<bool> inUse;
+        std::atomic<uint32_t> head;
+        timeLoggerRecord_t *ring;
+        uint32_t size;
+        int32_t tid;
+        int numDuration;
+        uint64_t durationKey[TIME_LOGGER_THREAD_DURATION_MAX];
+        int64_t durationTime[TIME_LOGGER_THREAD_DURATION_MAX];
+    } timeLoggerThread_t;
+
+    typedef struct timeLoggerStage {
+        std::atomic<uint64_t> key;          /* 0 : empty */
+        std::atomic<int64_t> lastTime;      /* ns : last update of INTERVAL */
+        std::atomic<uint64_t> sum;
+        std::atomic<uint32_t> max;
+        std::atomic<uint32_t> bucket[TIME_LOGGER_HISTOGRAM_SIZE];
+    } timeLoggerStage_t;
+
+    static void m_releaseThread(void *thread);
+    timeLoggerThread_t *m_getThread(void);
+    timeLoggerStage_t *m_getStage(int cameraId, uint64_t stageKey);
+    timeLoggerStage_t *m_findStage(int cameraId, uint64_t stageKey);
+    void m_addSample(timeLoggerStage_t *stage, uint32_t calTime);
+    void m_getStageStatistics(timeLoggerStage_t *stage, timeLoggerStatistics_t *statistics);
+    void m_collect(int cameraId, std::vector<timeLogger_t> *events);
+    status_t m_saveTrace(int cameraId, std::vector<timeLogger_t> *events);
+
 private:
     bool                    m_stopFlag[CAMERA_ID_MAX];
-    bool                    m_firstCheckFlag[CAMERA_ID_MAX];
-    ExynosCameraDurationTimer   m_timer[CAMERA_ID_MAX][LOGGER_TYPE_MAX][LOGGER_CATEGORY_MAX][MAX_PIPE_NUM];
-    uint32_t                m_count[CAMERA_ID_MAX];
-    int32_t                 m_bufferIndex[CAMERA_ID_MAX];
-    timeLogger_t            *m_buffer[CAMERA_ID_MAX];
+    int32_t                 m_count[CAMERA_ID_MAX];
+    int64_t                 m_initTime[CAMERA_ID_MAX];
+    int64_t                 m_realTimeOffset[CAMERA_ID_MAX];
+    uint32_t                m_ringSize;
+    std::atomic<uint32_t>   m_numDropped[CAMERA_ID_MAX];
+    timeLoggerStage_t       *m_stage[CAMERA_ID_MAX];
+    pthread_key_t           m_threadKey;
+    timeLoggerThread_t      m_thread[TIME_LOGGER_THREAD_MAX];
     char                    m_name[EXYNOS_CAMERA_NAME_STR_SIZE];
     char                    *m_typeStr[LOGGER_TYPE_MAX];
     char                    *m_categoryStr[LOGGER_CATEGORY_MAX];
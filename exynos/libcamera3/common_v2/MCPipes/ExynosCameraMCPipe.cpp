@@ -1287,6 +1287,10 @@ status_t ExynosCameraMCPipe::m_preCreate(void)
         m_requestFrameQ = new frame_queue_t;
     }
 
+    /* frames are pushed by the factory and the previous pipes, requests only by putBufferThread */
+    m_inputFrameQ->setQueueType(LIST_QUEUE_TYPE_MPSC);
+    m_requestFrameQ->setQueueType(LIST_QUEUE_TYPE_SPSC);
+
 #ifdef DEBUG_DUMP_IMAGE
     m_dumpFrameQ = new frame_queue_t(m_dumpBufferThread);
 #endif
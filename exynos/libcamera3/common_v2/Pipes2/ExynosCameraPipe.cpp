@@ -72,6 +72,8 @@ status_t ExynosCameraPipe::create(int32_t *sensorIds)
     m_mainThread = new ExynosCameraThread<ExynosCameraPipe>(this, &ExynosCameraPipe::m_mainThreadFunc, "mainThread");
 
     m_inputFrameQ = new frame_queue_t;
+    /* frames are pushed by the factory and the previous pipes */
+    m_inputFrameQ->setQueueType(LIST_QUEUE_TYPE_MPSC);
 
     m_prepareBufferCount = 0;
     m_timeLogCount = TIME_LOG_COUNT;
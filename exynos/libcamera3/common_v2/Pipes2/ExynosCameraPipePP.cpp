@@ -238,6 +238,20 @@ status_t ExynosCameraPipePP::m_run(void)
             if (nextPP == NULL) {
                 nextPP = ExynosCameraPPFactory::newPP(m_cameraId, m_configurations, m_parameters, PICTURE_GSC_NODE_NUM);
 
+                ret = nextPP->create();
+                if (ret != NO_ERROR) {
+                    CLOGW("nextPP(%s)->create() fail. so, fall back to ExynosCameraPPSW", nextPP->getName());
+                    SAFE_DELETE(nextPP);
+
+                    nextPP = ExynosCameraPPFactory::newSWPP(m_cameraId, m_configurations, m_parameters, PICTURE_GSC_NODE_NUM);
+                    ret = nextPP->create();
+                    if (ret != NO_ERROR) {
+                        CLOGE("nextPP(%s)->create() fail", nextPP->getName());
+                        SAFE_DELETE(nextPP);
+                        goto func_exit;
+                    }
+                }
+
                 CLOGD("m_pp(%s) can't support [SRC]%c%c%c%c, fullW(%d) / [DST]%c%c%c%c, fullW(%d). make nextPP(nodeNum : %d)",
                     m_pp->getName(), nextPP->getNodeNum(),
                     v4l2Format2Char(srcImage[0].rect.colorFormat, 0),
@@ -51,5 +51,29 @@ ExynosCameraPP *ExynosCameraPPFactory::newPP(
         break;
     }
 
+    if (newPP == NULL)
+        return newPP;
+
+    if (property_get_bool("vendor.camera.pp.force_sw", false) == true) {
+        CLOGW("vendor.camera.pp.force_sw is set. so, %s is not used(nodeNum : %d)", newPP->getName(), nodeNum);
+        SAFE_DELETE(newPP);
+
+        newPP = newSWPP(cameraId, configurations, parameters, nodeNum);
+    }
+
     return newPP;
 }
+
+ExynosCameraPP *ExynosCameraPPFactory::newSWPP(
+        int cameraId,
+        ExynosCameraConfigurations *configurations,
+        ExynosCameraParameters *parameters,
+        int nodeNum)
+{
+    int m_cameraId = cameraId;
+    char m_name[EXYNOS_CAMERA_NAME_STR_SIZE] = "ExynosCameraPPFactory";
+
+    CLOGD("new ExynosCameraPPSW(cameraId : %d, nodeNum : %d)", cameraId, nodeNum);
+
+    return new ExynosCameraPPSW(cameraId, configurations, parameters, nodeNum);
+}
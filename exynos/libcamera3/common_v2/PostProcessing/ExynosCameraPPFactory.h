@@ -35,6 +35,7 @@
 #include "ExynosCameraPPLibcsc.h"
 /* #include "ExynosCameraPPLibacryl.h" */
 #include "ExynosCameraPPJPEG.h"
+#include "ExynosCameraPPSW.h"
 #ifdef SAMSUNG_TN_FEATURE
 #include "ExynosCameraPPUniPlugin.h"
 #endif
@@ -60,6 +61,8 @@ protected:
 public:
     /*
      * Use this API to get the real object.
+     * The PP is not created. The caller calls create(), and when create()
+     * of the H/W PP fails, it deletes the PP and uses newSWPP() instead.
      */
     static ExynosCameraPP *newPP(
             int cameraId,
@@ -67,6 +70,15 @@ public:
             ExynosCameraParameters *parameters,
             int nodeNum);
 
+    /*
+     * ExynosCameraPPSW, which draws on the CPU in place of the H/W PP of nodeNum.
+     */
+    static ExynosCameraPP *newSWPP(
+            int cameraId,
+            ExynosCameraConfigurations *configurations,
+            ExynosCameraParameters *parameters,
+            int nodeNum);
+
     static ExynosCameraPP *newPP(
             int cameraId,
             ExynosCameraConfigurations *configurations,
@@ -0,0 +1,852 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*#define LOG_NDEBUG 0 */
+#define LOG_TAG "ExynosCameraPPSW"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "ExynosCameraPPSW.h"
+
+/* samples are interpolated with 7 bit weights, to multiply 8 bit samples in 16 bit */
+#define PP_SW_WEIGHT_BITS   (7)
+#define PP_SW_WEIGHT_ONE    (1 << PP_SW_WEIGHT_BITS)
+
+static int getNumOfPlanePPSW(int colorFormat)
+{
+    switch (colorFormat) {
+    case V4L2_PIX_FMT_NV12:
+    case V4L2_PIX_FMT_NV21:
+    case V4L2_PIX_FMT_YVU420:
+        return 1;
+    case V4L2_PIX_FMT_NV12M:
+    case V4L2_PIX_FMT_NV21M:
+        return 2;
+    case V4L2_PIX_FMT_YVU420M:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+/* dst = (r0 * (128 - w) + r1 * w) / 128, for the vertical interpolation */
+static void blendRowPPSW(uint8_t *dst, const uint8_t *r0, const uint8_t *r1, int len, int w)
+{
+    int i = 0;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    uint8x8_t w0 = vdup_n_u8(PP_SW_WEIGHT_ONE - w);
+    uint8x8_t w1 = vdup_n_u8(w);
+
+    for (; i + 16 <= len; i += 16) {
+        uint8x16_t a = vld1q_u8(r0 + i);
+        uint8x16_t b = vld1q_u8(r1 + i);
+        uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(a), w0), vget_low_u8(b), w1);
+        uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(a), w0), vget_high_u8(b), w1);
+
+        vst1q_u8(dst + i, vcombine_u8(vrshrn_n_u16(lo, PP_SW_WEIGHT_BITS),
+                                      vrshrn_n_u16(hi, PP_SW_WEIGHT_BITS)));
+    }
+#elif defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+    __m128i w0 = _mm_set1_epi16(PP_SW_WEIGHT_ONE - w);
+    __m128i w1 = _mm_set1_epi16(w);
+    __m128i round = _mm_set1_epi16(PP_SW_WEIGHT_ONE / 2);
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(r0 + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(r1 + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), w0),
+                                   _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), w1));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), w0),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), w1));
+
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, round), PP_SW_WEIGHT_BITS);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, round), PP_SW_WEIGHT_BITS);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+
+    for (; i < len; i++)
+        dst[i] = (r0[i] * (PP_SW_WEIGHT_ONE - w) + r1[i] * w + PP_SW_WEIGHT_ONE / 2) >> PP_SW_WEIGHT_BITS;
+}
+
+/* 16.16 position to the clamped integer position, the next one and the weight of the next one */
+static inline void splitPosPPSW(int64_t pos, int min, int max, int *p0, int *p1, int *w)
+{
+    if (pos < ((int64_t)min << 16))
+        pos = (int64_t)min << 16;
+    else if (pos > ((int64_t)max << 16))
+        pos = (int64_t)max << 16;
+
+    *p0 = (int)(pos >> 16);
+    *p1 = (*p0 < max) ? *p0 + 1 : *p0;
+    *w  = (int)((pos >> (16 - PP_SW_WEIGHT_BITS)) & (PP_SW_WEIGHT_ONE - 1));
+}
+
+ExynosCameraPPSW::~ExynosCameraPPSW()
+{
+    delete[] m_xOffset;
+    delete[] m_xWeight;
+}
+
+status_t ExynosCameraPPSW::m_create(void)
+{
+    status_t ret = NO_ERROR;
+
+    // create your own library.
+    int numOfThread = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int propThread = property_get_int32("vendor.camera.pp.sw.threads", 0);
+
+    if (0 < propThread)
+        numOfThread = propThread;
+
+    if (PP_SW_MAX_THREADS < numOfThread)
+        numOfThread = PP_SW_MAX_THREADS;
+
+    m_flagWorkerExit = false;
+    m_numOfWorker = 0;
+
+    /* the caller draws too */
+    for (int i = 0; i < numOfThread - 1; i++) {
+        m_workerThread[i] = new ExynosCameraThread<ExynosCameraPPSW>(this,
+                &ExynosCameraPPSW::m_workerThreadFunc, "PPSWWorkerThread");
+
+        ret = m_workerThread[i]->run();
+        if (ret != NO_ERROR) {
+            CLOGW("m_workerThread[%d]->run() fail, ret(%d). so, draw with %d thread(s)",
+                    i, ret, m_numOfWorker + 1);
+            m_workerThread[i] = NULL;
+            break;
+        }
+
+        m_numOfWorker++;
+    }
+
+    CLOGD("nodeNum(%d) GDC(%d) threads(%d)", m_nodeNum, m_flagGDC, m_numOfWorker + 1);
+
+    return NO_ERROR;
+}
+
+status_t ExynosCameraPPSW::m_destroy(void)
+{
+    status_t ret = NO_ERROR;
+
+    // destroy your own library.
+    m_jobLock.lock();
+    m_flagWorkerExit = true;
+    m_jobCondition.broadcast();
+    m_jobLock.unlock();
+
+    for (int i = 0; i < m_numOfWorker; i++) {
+        m_workerThread[i]->requestExitAndWait();
+        m_workerThread[i] = NULL;
+    }
+
+    m_numOfWorker = 0;
+
+    return ret;
+}
+
+status_t ExynosCameraPPSW::m_extControl(int controlType, void *data)
+{
+    status_t ret = NO_ERROR;
+
+    switch (controlType) {
+    case PP_SW_EXT_CONTROL_SET_GDC_MESH:
+        if (data == NULL) {
+            m_flagMesh = false;
+            break;
+        }
+
+        {
+            pp_sw_gdc_mesh_t *mesh = (pp_sw_gdc_mesh_t *)data;
+
+            if (mesh->gridW < 2 || PP_SW_MESH_MAX_GRID < mesh->gridW ||
+                mesh->gridH < 2 || PP_SW_MESH_MAX_GRID < mesh->gridH) {
+                CLOGE("Invalid mesh grid(%d x %d). so, fail", mesh->gridW, mesh->gridH);
+                return BAD_VALUE;
+            }
+
+            m_mesh = *mesh;
+            m_flagMesh = true;
+        }
+        break;
+    default:
+        break;
+    }
+
+    return ret;
+}
+
+status_t ExynosCameraPPSW::m_draw(ExynosCameraImage *srcImage,
+                                  ExynosCameraImage *dstImage,
+                                  __unused ExynosCameraParameters *params)
+{
+    status_t ret = NO_ERROR;
+
+    uint8_t *srcPlanes[3] = {NULL, NULL, NULL};
+    uint8_t *dstPlanes[3] = {NULL, NULL, NULL};
+    bool srcMapped[3] = {false, false, false};
+    bool dstMapped[3] = {false, false, false};
+
+    pp_sw_channel_t srcY, srcCb, srcCr;
+    pp_sw_channel_t dstY, dstCb, dstCr;
+
+    int rotation = dstImage[0].rotation;
+    bool flipH = dstImage[0].flipH;
+    bool flipV = dstImage[0].flipV;
+
+    int numOfTable = 0;
+
+    // draw your own library.
+    if (m_flagGDC == true && (rotation != 0 || flipH == true || flipV == true)) {
+        CLOGW("GDC does not rotate/flip. so, ignore rotation(%d) flipH(%d) flipV(%d)",
+                rotation, flipH, flipV);
+        rotation = 0;
+        flipH = false;
+        flipV = false;
+    }
+
+    ret = m_mapImage(&srcImage[0], srcPlanes, srcMapped);
+    if (ret != NO_ERROR) {
+        CLOGE("m_mapImage([SRC]) fail");
+        goto done;
+    }
+
+    ret = m_mapImage(&dstImage[0], dstPlanes, dstMapped);
+    if (ret != NO_ERROR) {
+        CLOGE("m_mapImage([DST]) fail");
+        goto done;
+    }
+
+    ret  = m_getChannels(&srcImage[0], srcPlanes, &srcY, &srcCb, &srcCr);
+    ret |= m_getChannels(&dstImage[0], dstPlanes, &dstY, &dstCb, &dstCr);
+    if (ret != NO_ERROR) {
+        CLOGE("m_getChannels() fail");
+        goto done;
+    }
+
+    m_numOfGroup = 0;
+
+    // Y
+    m_group[m_numOfGroup].numOfChannel = 1;
+    m_group[m_numOfGroup].src[0] = srcY;
+    m_group[m_numOfGroup].dst[0] = dstY;
+    m_numOfGroup++;
+
+    // CbCr of the semi-planar source at once, or Cb and Cr of the planar source
+    if (srcCb.step == 2) {
+        m_group[m_numOfGroup].numOfChannel = 2;
+        m_group[m_numOfGroup].src[0] = srcCb;
+        m_group[m_numOfGroup].src[1] = srcCr;
+        m_group[m_numOfGroup].dst[0] = dstCb;
+        m_group[m_numOfGroup].dst[1] = dstCr;
+        m_numOfGroup++;
+    } else {
+        m_group[m_numOfGroup].numOfChannel = 1;
+        m_group[m_numOfGroup].src[0] = srcCb;
+        m_group[m_numOfGroup].dst[0] = dstCb;
+        m_numOfGroup++;
+
+        m_group[m_numOfGroup].numOfChannel = 1;
+        m_group[m_numOfGroup].src[0] = srcCr;
+        m_group[m_numOfGroup].dst[0] = dstCr;
+        m_numOfGroup++;
+    }
+
+    for (int i = 0; i < m_numOfGroup; i++) {
+        int shift = (i == 0) ? 0 : 1;
+
+        ret = m_setGroup(&m_group[i], srcImage[0].rect, dstImage[0].rect,
+                         rotation, flipH, flipV, shift, shift);
+        if (ret != NO_ERROR) {
+            CLOGE("m_setGroup(%d) fail", i);
+            goto done;
+        }
+
+        numOfTable += m_group[i].dstW * 2;
+    }
+
+    if (m_xTableSize < numOfTable) {
+        delete[] m_xOffset;
+        delete[] m_xWeight;
+
+        m_xOffset = new int[numOfTable];
+        m_xWeight = new uint8_t[numOfTable];
+        m_xTableSize = numOfTable;
+    }
+
+    numOfTable = 0;
+    for (int i = 0; i < m_numOfGroup; i++) {
+        m_group[i].xOffset = &m_xOffset[numOfTable];
+        m_group[i].xWeight = &m_xWeight[numOfTable];
+        numOfTable += m_group[i].dstW * 2;
+
+        m_setSeparable(&m_group[i]);
+    }
+
+    m_runJob();
+
+done:
+    m_unmapImage(&srcImage[0], srcPlanes, srcMapped);
+    m_unmapImage(&dstImage[0], dstPlanes, dstMapped);
+
+    return ret;
+}
+
+status_t ExynosCameraPPSW::m_getChannels(ExynosCameraImage *image, uint8_t *planes[],
+                                         pp_sw_channel_t *y, pp_sw_channel_t *cb, pp_sw_channel_t *cr)
+{
+    int fullW = image->rect.fullW;
+    int fullH = image->rect.fullH;
+    int cStride = 0;
+    uint8_t *c = NULL;
+
+    y->base   = planes[0];
+    y->stride = fullW;
+    y->step   = 1;
+
+    switch (image->rect.colorFormat) {
+    case V4L2_PIX_FMT_NV12:
+    case V4L2_PIX_FMT_NV21:
+    case V4L2_PIX_FMT_NV12M:
+    case V4L2_PIX_FMT_NV21M:
+        if (getNumOfPlanePPSW(image->rect.colorFormat) == 1)
+            c = planes[0] + fullW * fullH;
+        else
+            c = planes[1];
+
+        cb->stride = cr->stride = fullW;
+        cb->step   = cr->step   = 2;
+
+        if (image->rect.colorFormat == V4L2_PIX_FMT_NV21 ||
+            image->rect.colorFormat == V4L2_PIX_FMT_NV21M) {
+            cr->base = c;
+            cb->base = c + 1;
+        } else {
+            cb->base = c;
+            cr->base = c + 1;
+        }
+        break;
+    case V4L2_PIX_FMT_YVU420:
+        /* same as getYuvPlaneSize() */
+        cStride = ALIGN_UP(fullW >> 1, 16);
+
+        cr->base = planes[0] + fullW * fullH;
+        cb->base = cr->base + cStride * (fullH >> 1);
+        cb->stride = cr->stride = cStride;
+        cb->step   = cr->step   = 1;
+        break;
+    case V4L2_PIX_FMT_YVU420M:
+        cr->base = planes[1];
+        cb->base = planes[2];
+        cb->stride = cr->stride = fullW >> 1;
+        cb->step   = cr->step   = 1;
+        break;
+    default:
+        CLOGE("Invalid colorFormat(%c%c%c%c)",
+            v4l2Format2Char(image->rect.colorFormat, 0),
+            v4l2Format2Char(image->rect.colorFormat, 1),
+            v4l2Format2Char(image->rect.colorFormat, 2),
+            v4l2Format2Char(image->rect.colorFormat, 3));
+        return BAD_VALUE;
+    }
+
+    return NO_ERROR;
+}
+
+status_t ExynosCameraPPSW::m_mapImage(ExynosCameraImage *image, uint8_t *planes[], bool *flagMapped)
+{
+    int numOfPlane = getNumOfPlanePPSW(image->rect.colorFormat);
+
+    if (numOfPlane == 0) {
+        CLOGE("Invalid colorFormat(%c%c%c%c)",
+            v4l2Format2Char(image->rect.colorFormat, 0),
+            v4l2Format2Char(image->rect.colorFormat, 1),
+            v4l2Format2Char(image->rect.colorFormat, 2),
+            v4l2Format2Char(image->rect.colorFormat, 3));
+        return BAD_VALUE;
+    }
+
+    for (int i = 0; i < numOfPlane; i++) {
+        if (image->buf.addr[i] != NULL) {
+            planes[i] = (uint8_t *)image->buf.addr[i];
+            continue;
+        }
+
+        /* the buffer without the virtual address is mapped only while drawing */
+        if (image->buf.fd[i] < 0 || image->buf.size[i] == 0) {
+            CLOGE("Invalid buffer plane(%d) fd(%d) size(%d)",
+                    i, image->buf.fd[i], image->buf.size[i]);
+            return BAD_VALUE;
+        }
+
+        void *addr = mmap(NULL, image->buf.size[i], PROT_READ | PROT_WRITE, MAP_SHARED, image->buf.fd[i], 0);
+        if (addr == MAP_FAILED) {
+            CLOGE("mmap(fd(%d), size(%d)) fail", image->buf.fd[i], image->buf.size[i]);
+            return INVALID_OPERATION;
+        }
+
+        planes[i] = (uint8_t *)addr;
+        flagMapped[i] = true;
+    }
+
+    return NO_ERROR;
+}
+
+void ExynosCameraPPSW::m_unmapImage(ExynosCameraImage *image, uint8_t *planes[], bool *flagMapped)
+{
+    for (int i = 0; i < 3; i++) {
+        if (flagMapped[i] == true)
+            munmap(planes[i], image->buf.size[i]);
+
+        flagMapped[i] = false;
+    }
+}
+
+status_t ExynosCameraPPSW::m_setGroup(pp_sw_group_t *group, ExynosRect srcRect, ExynosRect dstRect,
+                                      int rotation, bool flipH, bool flipV, int shiftX, int shiftY)
+{
+    int cx = srcRect.x >> shiftX;
+    int cy = srcRect.y >> shiftY;
+    int cw = srcRect.w >> shiftX;
+    int ch = srcRect.h >> shiftY;
+    int dw = dstRect.w >> shiftX;
+    int dh = dstRect.h >> shiftY;
+
+    if (cw <= 0 || ch <= 0 || dw <= 0 || dh <= 0) {
+        CLOGE("Invalid size [SRC] %d x %d, [DST] %d x %d", cw, ch, dw, dh);
+        return BAD_VALUE;
+    }
+
+    group->srcX0 = cx;
+    group->srcY0 = cy;
+    group->srcX1 = cx + cw - 1;
+    group->srcY1 = cy + ch - 1;
+
+    group->dstX = dstRect.x >> shiftX;
+    group->dstY = dstRect.y >> shiftY;
+    group->dstW = dw;
+    group->dstH = dh;
+
+    /* the size before the rotation */
+    int pw = (rotation == 90 || rotation == 270) ? dh : dw;
+    int ph = (rotation == 90 || rotation == 270) ? dw : dh;
+    int64_t scaleX = ((int64_t)cw << 16) / pw;
+    int64_t scaleY = ((int64_t)ch << 16) / ph;
+
+    /*
+     * dst (u, v) -> (u', v') before the flip -> (x, y) before the rotation
+     * x = xu * u' + xv * v' + x0, y = yu * u' + yv * v' + y0
+     */
+    int fu  = flipH ? -1 : 1;
+    int fu0 = flipH ? dw - 1 : 0;
+    int fv  = flipV ? -1 : 1;
+    int fv0 = flipV ? dh - 1 : 0;
+    int xu, xv, x0, yu, yv, y0;
+
+    switch (rotation) {
+    case 90:
+        xu = 0;  xv = 1;  x0 = 0;
+        yu = -1; yv = 0;  y0 = dw - 1;
+        break;
+    case 180:
+        xu = -1; xv = 0;  x0 = dw - 1;
+        yu = 0;  yv = -1; y0 = dh - 1;
+        break;
+    case 270:
+        xu = 0;  xv = -1; x0 = dh - 1;
+        yu = 1;  yv = 0;  y0 = 0;
+        break;
+    default:
+        xu = 1;  xv = 0;  x0 = 0;
+        yu = 0;  yv = 1;  y0 = 0;
+        break;
+    }
+
+    /* the center of a dst pixel is on the center of the source area */
+    group->a = (int64_t)(xu * fu) * scaleX;
+    group->b = (int64_t)(xv * fv) * scaleX;
+    group->c = ((int64_t)cx << 16) + (int64_t)(xu * fu0 + xv * fv0 + x0) * scaleX + scaleX / 2 - 32768;
+    group->d = (int64_t)(yu * fu) * scaleY;
+    group->e = (int64_t)(yv * fv) * scaleY;
+    group->f = ((int64_t)cy << 16) + (int64_t)(yu * fu0 + yv * fv0 + y0) * scaleY + scaleY / 2 - 32768;
+
+    group->flagMesh = (m_flagGDC == true && m_flagMesh == true);
+    group->cropX = (int64_t)cx << 16;
+    group->cropY = (int64_t)cy << 16;
+    group->cropW = cw;
+    group->cropH = ch;
+
+    group->xOffset = NULL;
+    group->xWeight = NULL;
+    group->numOfTask = (dh + PP_SW_STRIPE_HEIGHT - 1) / PP_SW_STRIPE_HEIGHT;
+
+    return NO_ERROR;
+}
+
+status_t ExynosCameraPPSW::m_setSeparable(pp_sw_group_t *group)
+{
+    int step = group->src[0].step;
+    int x0, x1, w;
+
+    /* rows of the dst are rows of the source, without the rotation by 90 or 270 */
+    if (group->flagMesh == true || group->b != 0 || group->d != 0)
+        goto generic;
+
+    group->xMin = group->srcX1;
+    group->xMax = group->srcX0;
+
+    for (int u = 0; u < group->dstW; u++) {
+        splitPosPPSW(group->a * u + group->c, group->srcX0, group->srcX1, &x0, &x1, &w);
+
+        group->xOffset[u * 2]     = x0;
+        group->xOffset[u * 2 + 1] = x1;
+        group->xWeight[u] = (uint8_t)w;
+
+        if (x0 < group->xMin)
+            group->xMin = x0;
+        if (group->xMax < x1)
+            group->xMax = x1;
+    }
+
+    if (PP_SW_MAX_ROW_BYTES < (group->xMax - group->xMin + 1) * step)
+        goto generic;
+
+    for (int u = 0; u < group->dstW * 2; u++)
+        group->xOffset[u] = (group->xOffset[u] - group->xMin) * step;
+
+    return NO_ERROR;
+
+generic:
+    group->xOffset = NULL;
+    group->xWeight = NULL;
+
+    return NO_ERROR;
+}
+
+void ExynosCameraPPSW::m_runJob(void)
+{
+    int task = 0;
+    int numOfTask = 0;
+
+    for (int i = 0; i < m_numOfGroup; i++)
+        numOfTask += m_group[i].numOfTask;
+
+    m_jobLock.lock();
+    m_numOfTask = numOfTask;
+    m_nextTask = 0;
+    m_numOfDoneTask = 0;
+    m_jobCondition.broadcast();
+    m_jobLock.unlock();
+
+    /* the caller draws too */
+    while (m_getTask(&task) == true) {
+        m_runTask(task);
+        m_doneTask();
+    }
+
+    m_jobLock.lock();
+    while (m_numOfDoneTask < m_numOfTask)
+        m_doneCondition.wait(m_jobLock);
+
+    m_numOfTask = 0;
+    m_nextTask = 0;
+    m_jobLock.unlock();
+}
+
+bool ExynosCameraPPSW::m_getTask(int *task)
+{
+    Mutex::Autolock lock(m_jobLock);
+
+    if (m_numOfTask <= m_nextTask)
+        return false;
+
+    *task = m_nextTask++;
+
+    return true;
+}
+
+void ExynosCameraPPSW::m_doneTask(void)
+{
+    Mutex::Autolock lock(m_jobLock);
+
+    m_numOfDoneTask++;
+    if (m_numOfDoneTask == m_numOfTask)
+        m_doneCondition.signal();
+}
+
+void ExynosCameraPPSW::m_runTask(int task)
+{
+    pp_sw_group_t *group = NULL;
+
+    for (int i = 0; i < m_numOfGroup; i++) {
+        if (task < m_group[i].numOfTask) {
+            group = &m_group[i];
+            break;
+        }
+
+        task -= m_group[i].numOfTask;
+    }
+
+    if (group == NULL)
+        return;
+
+    int rowStart = task * PP_SW_STRIPE_HEIGHT;
+    int rowEnd = rowStart + PP_SW_STRIPE_HEIGHT;
+
+    if (group->dstH < rowEnd)
+        rowEnd = group->dstH;
+
+    if (group->xOffset == NULL) {
+        m_drawGeneric(group, rowStart, rowEnd);
+    } else if (group->a == (1 << 16) && group->e == (1 << 16) &&
+               (group->c & 0xFFFF) == 0 && (group->f & 0xFFFF) == 0) {
+        m_drawCopy(group, rowStart, rowEnd);
+    } else {
+        m_drawSeparable(group, rowStart, rowEnd);
+    }
+}
+
+void ExynosCameraPPSW::m_drawCopy(pp_sw_group_t *group, int rowStart, int rowEnd)
+{
+    int srcX = (int)(group->c >> 16);
+    int srcY = (int)(group->f >> 16);
+    int dw = group->dstW;
+    bool flagSameLayout = true;
+
+    for (int ch = 0; ch < group->numOfChannel; ch++) {
+        if (group->src[ch].step != group->dst[ch].step ||
+            group->src[ch].base - group->src[0].base != group->dst[ch].base - group->dst[0].base)
+            flagSameLayout = false;
+    }
+
+    for (int v = rowStart; v < rowEnd; v++) {
+        if (flagSameLayout == true) {
+            /* every channel in a memcpy() */
+            uint8_t *src = group->src[0].base;
+            uint8_t *dst = group->dst[0].base;
+            int step = group->src[0].step;
+
+            if (group->numOfChannel == 2 && group->src[1].base < src) {
+                src = group->src[1].base;
+                dst = group->dst[1].base;
+            }
+
+            memcpy(dst + (group->dstY + v) * group->dst[0].stride + group->dstX * step,
+                   src + (srcY + v) * group->src[0].stride + srcX * step,
+                   dw * step);
+            continue;
+        }
+
+        for (int ch = 0; ch < group->numOfChannel; ch++) {
+            pp_sw_channel_t *s = &group->src[ch];
+            pp_sw_channel_t *d = &group->dst[ch];
+            const uint8_t *src = s->base + (srcY + v) * s->stride + srcX * s->step;
+            uint8_t *dst = d->base + (group->dstY + v) * d->stride + group->dstX * d->step;
+
+            for (int u = 0; u < dw; u++)
+                dst[u * d->step] = src[u * s->step];
+        }
+    }
+}
+
+void ExynosCameraPPSW::m_drawSeparable(pp_sw_group_t *group, int rowStart, int rowEnd)
+{
+    uint8_t row[PP_SW_MAX_ROW_BYTES];
+    int step = group->src[0].step;
+    int stride = group->src[0].stride;
+    int len = (group->xMax - group->xMin + 1) * step;
+    uint8_t *srcBase = group->src[0].base;
+    int offset[2] = {0, 0};
+
+    if (group->numOfChannel == 2 && group->src[1].base < srcBase)
+        srcBase = group->src[1].base;
+
+    for (int ch = 0; ch < group->numOfChannel; ch++)
+        offset[ch] = (int)(group->src[ch].base - srcBase);
+
+    for (int v = rowStart; v < rowEnd; v++) {
+        int y0, y1, wy;
+        const uint8_t *src;
+
+        splitPosPPSW(group->e * v + group->f, group->srcY0, group->srcY1, &y0, &y1, &wy);
+
+        src = srcBase + y0 * stride + group->xMin * step;
+        if (wy != 0) {
+            blendRowPPSW(row, src, srcBase + y1 * stride + group->xMin * step, len, wy);
+            src = row;
+        }
+
+        for (int ch = 0; ch < group->numOfChannel; ch++) {
+            pp_sw_channel_t *d = &group->dst[ch];
+            const uint8_t *s = src + offset[ch];
+            uint8_t *dst = d->base + (group->dstY + v) * d->stride + group->dstX * d->step;
+            const int *xOffset = group->xOffset;
+            const uint8_t *xWeight = group->xWeight;
+
+            for (int u = 0; u < group->dstW; u++) {
+                int w = xWeight[u];
+
+                dst[u * d->step] = (s[xOffset[u * 2]] * (PP_SW_WEIGHT_ONE - w) +
+                                    s[xOffset[u * 2 + 1]] * w + PP_SW_WEIGHT_ONE / 2) >> PP_SW_WEIGHT_BITS;
+            }
+        }
+    }
+}
+
+/* rotation by 90 or 270 and the mesh : every dst pixel has its own source position */
+void ExynosCameraPPSW::m_drawGeneric(pp_sw_group_t *group, int rowStart, int rowEnd)
+{
+    int64_t meshX[PP_SW_MESH_MAX_GRID];
+    int64_t meshY[PP_SW_MESH_MAX_GRID];
+
+    /* tiles keep the source columns of the rotation in the cache */
+    for (int tile = 0; tile < group->dstW; tile += PP_SW_TILE_WIDTH) {
+        int tileEnd = tile + PP_SW_TILE_WIDTH;
+
+        if (group->dstW < tileEnd)
+            tileEnd = group->dstW;
+
+        for (int v = rowStart; v < rowEnd; v++) {
+            if (group->flagMesh == true) {
+                /* source position of the grid points on this row, by the rows of the grid */
+                int64_t gridPos = ((int64_t)(2 * v + 1) * (m_mesh.gridH - 1) << 16) / (2 * group->dstH);
+                int gy = (int)(gridPos >> 16);
+                int64_t wy = gridPos & 0xFFFF;
+
+                if (m_mesh.gridH - 2 < gy) {
+                    gy = m_mesh.gridH - 2;
+                    wy = 1 << 16;
+                }
+
+                for (int i = 0; i < m_mesh.gridW; i++) {
+                    int p0 = gy * m_mesh.gridW + i;
+                    int p1 = p0 + m_mesh.gridW;
+                    int64_t mx = m_mesh.x[p0] + (((int64_t)(m_mesh.x[p1] - m_mesh.x[p0]) * wy) >> 16);
+                    int64_t my = m_mesh.y[p0] + (((int64_t)(m_mesh.y[p1] - m_mesh.y[p0]) * wy) >> 16);
+
+                    meshX[i] = group->cropX + mx * group->cropW;
+                    meshY[i] = group->cropY + my * group->cropH;
+                }
+            }
+
+            for (int u = tile; u < tileEnd; u++) {
+                int64_t sx, sy;
+                int x0, x1, wx, y0, y1, wy;
+
+                if (group->flagMesh == true) {
+                    int64_t gridPos = ((int64_t)(2 * u + 1) * (m_mesh.gridW - 1) << 16) / (2 * group->dstW);
+                    int gx = (int)(gridPos >> 16);
+                    int64_t w = gridPos & 0xFFFF;
+
+                    if (m_mesh.gridW - 2 < gx) {
+                        gx = m_mesh.gridW - 2;
+                        w = 1 << 16;
+                    }
+
+                    /* the mesh is on the edges of the pixels */
+                    sx = meshX[gx] + (((meshX[gx + 1] - meshX[gx]) * w) >> 16) - 32768;
+                    sy = meshY[gx] + (((meshY[gx + 1] - meshY[gx]) * w) >> 16) - 32768;
+                } else {
+                    sx = group->a * u + group->b * v + group->c;
+                    sy = group->d * u + group->e * v + group->f;
+                }
+
+                splitPosPPSW(sx, group->srcX0, group->srcX1, &x0, &x1, &wx);
+                splitPosPPSW(sy, group->srcY0, group->srcY1, &y0, &y1, &wy);
+
+                for (int ch = 0; ch < group->numOfChannel; ch++) {
+                    pp_sw_channel_t *s = &group->src[ch];
+                    pp_sw_channel_t *d = &group->dst[ch];
+                    const uint8_t *r0 = s->base + y0 * s->stride;
+                    const uint8_t *r1 = s->base + y1 * s->stride;
+                    int top = r0[x0 * s->step] * (PP_SW_WEIGHT_ONE - wx) + r0[x1 * s->step] * wx;
+                    int bottom = r1[x0 * s->step] * (PP_SW_WEIGHT_ONE - wx) + r1[x1 * s->step] * wx;
+
+                    d->base[(group->dstY + v) * d->stride + (group->dstX + u) * d->step] =
+                        (top * (PP_SW_WEIGHT_ONE - wy) + bottom * wy +
+                         (1 << (2 * PP_SW_WEIGHT_BITS - 1))) >> (2 * PP_SW_WEIGHT_BITS);
+                }
+            }
+        }
+    }
+}
+
+bool ExynosCameraPPSW::m_workerThreadFunc(void)
+{
+    int task = 0;
+
+    m_jobLock.lock();
+    while (m_flagWorkerExit == false && m_numOfTask <= m_nextTask)
+        m_jobCondition.wait(m_jobLock);
+
+    if (m_flagWorkerExit == true) {
+        m_jobLock.unlock();
+        return false;
+    }
+
+    task = m_nextTask++;
+    m_jobLock.unlock();
+
+    m_runTask(task);
+    m_doneTask();
+
+    return true;
+}
+
+void ExynosCameraPPSW::m_init(void)
+{
+    m_flagGDC = (m_nodeNum == FIMC_IS_VIDEO_GDC_NUM);
+    m_flagMesh = false;
+    memset(&m_mesh, 0x00, sizeof(m_mesh));
+
+    m_numOfGroup = 0;
+    m_xOffset = NULL;
+    m_xWeight = NULL;
+    m_xTableSize = 0;
+
+    m_numOfWorker = 0;
+    m_numOfTask = 0;
+    m_nextTask = 0;
+    m_numOfDoneTask = 0;
+    m_flagWorkerExit = false;
+
+    /* GDC takes the bcrop image too */
+    m_srcImageCapacity.setNumOfImage(m_flagGDC ? 2 : 1);
+    m_srcImageCapacity.addColorFormat(V4L2_PIX_FMT_NV12M, 2);
+    m_srcImageCapacity.addColorFormat(V4L2_PIX_FMT_NV21M, 2);
+    m_srcImageCapacity.addColorFormat(V4L2_PIX_FMT_NV12, 2);
+    m_srcImageCapacity.addColorFormat(V4L2_PIX_FMT_NV21, 2);
+    m_srcImageCapacity.addColorFormat(V4L2_PIX_FMT_YVU420M, 2);
+    m_srcImageCapacity.addColorFormat(V4L2_PIX_FMT_YVU420, 2);
+
+    m_dstImageCapacity.setNumOfImage(1);
+    m_dstImageCapacity.addColorFormat(V4L2_PIX_FMT_NV12M, 2);
+    m_dstImageCapacity.addColorFormat(V4L2_PIX_FMT_NV21M, 2);
+    m_dstImageCapacity.addColorFormat(V4L2_PIX_FMT_NV12, 2);
+    m_dstImageCapacity.addColorFormat(V4L2_PIX_FMT_NV21, 2);
+    m_dstImageCapacity.addColorFormat(V4L2_PIX_FMT_YVU420M, 2);
+    m_dstImageCapacity.addColorFormat(V4L2_PIX_FMT_YVU420, 2);
+}
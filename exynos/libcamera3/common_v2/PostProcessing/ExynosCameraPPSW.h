@@ -0,0 +1,178 @@
+/*
+ * Copyright@ Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*!
+ * \file      ExynosCameraPPSW.h
+ * \brief     header file for ExynosCameraPPSW
+ *
+ */
+
+#ifndef EXYNOS_CAMERA_PP_SW_H
+#define EXYNOS_CAMERA_PP_SW_H
+
+#include "ExynosCameraPP.h"
+#include "ExynosCameraThread.h"
+
+using namespace android;
+
+#define PP_SW_MAX_THREADS       (4)
+#define PP_SW_STRIPE_HEIGHT     (32)  /* dst rows of a task of the workers */
+#define PP_SW_TILE_WIDTH        (64)  /* dst columns of a tile of the rotated/warped drawing */
+#define PP_SW_MAX_ROW_BYTES     (16384)
+#define PP_SW_MESH_MAX_GRID     (33)
+
+enum PP_SW_EXT_CONTROL_TYPE {
+    PP_SW_EXT_CONTROL_SET_GDC_MESH = 0x5350, /* data : pp_sw_gdc_mesh_t *, NULL to clear */
+};
+
+/*
+ * GDC mesh of ExynosCameraPPSW.
+ * Grid point (i, j) of the destination is at (i * dstW / (gridW - 1), j * dstH / (gridH - 1)),
+ * and x[j * gridW + i], y[j * gridW + i] are its source position in 1/65536 of the source crop.
+ * So, the identity is x = i * 65536 / (gridW - 1), y = j * 65536 / (gridH - 1).
+ */
+typedef struct pp_sw_gdc_mesh {
+    int gridW;
+    int gridH;
+    int x[PP_SW_MESH_MAX_GRID * PP_SW_MESH_MAX_GRID];
+    int y[PP_SW_MESH_MAX_GRID * PP_SW_MESH_MAX_GRID];
+} pp_sw_gdc_mesh_t;
+
+/*
+ * Class ExynosCameraPPSW
+ *
+ * Crop, scale, rotation/flip and NV21/NV12/YV12 conversion on the CPU.
+ * It takes the place of the H/W PP which fails to be created. Given the GDC node number,
+ * it takes the bcrop image like ExynosCameraPPGDC and warps the image by the mesh of
+ * PP_SW_EXT_CONTROL_SET_GDC_MESH.
+ * The destination rows are split into stripes, which the caller and the worker threads
+ * draw together. The number of the threads is "vendor.camera.pp.sw.threads".
+ */
+class ExynosCameraPPSW : public ExynosCameraPP
+{
+protected:
+    ExynosCameraPPSW()
+    {
+        m_init();
+    }
+
+    ExynosCameraPPSW(
+            int cameraId,
+            ExynosCameraConfigurations *configurations,
+            ExynosCameraParameters *parameters,
+            int nodeNum) : ExynosCameraPP(cameraId, configurations, parameters, nodeNum)
+    {
+        strncpy(m_name, "ExynosCameraPPSW",  EXYNOS_CAMERA_NAME_STR_SIZE - 1);
+
+        m_init();
+    }
+
+    /* ExynosCameraPPSW's constructor is protected
+     * to prevent new without ExynosCameraPPFactory::newPP()
+     */
+    friend class ExynosCameraPPFactory;
+
+public:
+    virtual ~ExynosCameraPPSW();
+
+protected:
+    /* a plane of the image and the channels of Y, Cb and Cr in it */
+    typedef struct pp_sw_channel {
+        uint8_t    *base;   /* the first channel sample of the plane */
+        int         stride;
+        int         step;   /* 1 : planar, 2 : interleaved */
+    } pp_sw_channel_t;
+
+    /*
+     * A group is the channels which are drawn together:
+     * Y, or CbCr of a semi-planar source, or Cb or Cr of a planar source.
+     * The source position of the dst (u, v) is (a * u + b * v + c, d * u + e * v + f) in 16.16.
+     */
+    typedef struct pp_sw_group {
+        int             numOfChannel;
+        pp_sw_channel_t src[2];
+        pp_sw_channel_t dst[2];
+
+        int             srcX0, srcY0, srcX1, srcY1;  /* clamp of the source, inclusive */
+        int             dstX, dstY, dstW, dstH;
+
+        int64_t         a, b, c, d, e, f;
+        bool            flagMesh;
+        int64_t         cropX, cropY, cropW, cropH;  /* for the mesh, in 16.16 */
+
+        int            *xOffset;    /* separable drawing: source offset of the dst column */
+        uint8_t        *xWeight;
+        int             xMin, xMax;
+
+        int             numOfTask;
+    } pp_sw_group_t;
+
+    enum {
+        GROUP_MAX = 3,
+    };
+
+    virtual status_t m_create(void);
+    virtual status_t m_destroy(void);
+    virtual status_t m_extControl(int controlType, void *data);
+    virtual status_t m_draw(ExynosCameraImage *srcImage,
+                            ExynosCameraImage *dstImage,
+                            ExynosCameraParameters *params);
+
+            status_t m_getChannels(ExynosCameraImage *image, uint8_t *planes[],
+                                   pp_sw_channel_t *y, pp_sw_channel_t *cb, pp_sw_channel_t *cr);
+            status_t m_mapImage(ExynosCameraImage *image, uint8_t *planes[], bool *flagMapped);
+            void     m_unmapImage(ExynosCameraImage *image, uint8_t *planes[], bool *flagMapped);
+            status_t m_setGroup(pp_sw_group_t *group, ExynosRect srcRect, ExynosRect dstRect,
+                                int rotation, bool flipH, bool flipV, int shiftX, int shiftY);
+            status_t m_setSeparable(pp_sw_group_t *group);
+
+            void     m_runJob(void);
+            bool     m_getTask(int *task);
+            void     m_doneTask(void);
+            void     m_runTask(int task);
+            void     m_drawSeparable(pp_sw_group_t *group, int rowStart, int rowEnd);
+            void     m_drawCopy(pp_sw_group_t *group, int rowStart, int rowEnd);
+            void     m_drawGeneric(pp_sw_group_t *group, int rowStart, int rowEnd);
+
+            bool     m_workerThreadFunc(void);
+
+private:
+            void     m_init(void);
+
+protected:
+    bool                m_flagGDC;
+    bool                m_flagMesh;
+    pp_sw_gdc_mesh_t    m_mesh;
+
+    pp_sw_group_t       m_group[GROUP_MAX];
+    int                 m_numOfGroup;
+    int                *m_xOffset;
+    uint8_t            *m_xWeight;
+    int                 m_xTableSize;
+
+    int                 m_numOfWorker;
+    sp<ExynosCameraThread<ExynosCameraPPSW>> m_workerThread[PP_SW_MAX_THREADS];
+
+    Mutex               m_jobLock;
+    Condition           m_jobCondition;
+    Condition           m_doneCondition;
+    int                 m_numOfTask;
+    int                 m_nextTask;
+    int                 m_numOfDoneTask;
+    bool                m_flagWorkerExit;
+};
+
+#endif //EXYNOS_CAMERA_PP_SW_H
@@ -172,7 +172,11 @@ status_t ExynosCameraFrameSelector::m_manageNormalFrameHoldListHAL3(ExynosCamera
      * if (m_parameters->getUseFastenAeStable() == true ||
      *     newFrame->getFrameCount() > INITIAL_SKIP_FRAME) {
      */
+    m_listLock.lock();
+
     m_pushQ(&m_frameHoldList, newFrame, true);
+    if (m_flagScoreSelect == true)
+        m_pushScore(newFrame);
 
     if (m_frameHoldList.getSizeOfProcessQ() > m_frameHoldCount) {
         if( m_popQ(&m_frameHoldList, oldFrame, true, 1) != NO_ERROR ) {
@@ -181,16 +185,23 @@ status_t ExynosCameraFrameSelector::m_manageNormalFrameHoldListHAL3(ExynosCamera
             m_bufMgr->printBufferState();
             m_bufMgr->printBufferQState();
 #endif
-        } else {
-            /*
-            Frames in m_frameHoldList and m_hdrFrameHoldList are locked when they are inserted
-            on the list. So we need to use m_LockedFrameComplete() to remove those frames.
-            */
-            m_LockedFrameComplete(oldFrame);
             oldFrame = NULL;
+        } else if (m_flagScoreSelect == true) {
+            m_removeScore(oldFrame);
         }
     }
 
+    m_listLock.unlock();
+
+    if (oldFrame != NULL) {
+        /*
+        Frames in m_frameHoldList and m_hdrFrameHoldList are locked when they are inserted
+        on the list. So we need to use m_LockedFrameComplete() to remove those frames.
+        */
+        m_LockedFrameComplete(oldFrame);
+        oldFrame = NULL;
+    }
+
     return ret;
 }
 
@@ -198,6 +209,8 @@ status_t ExynosCameraFrameSelector::m_list_release(frame_queue_t *list)
 {
     ExynosCameraFrameSP_sptr_t frame  = NULL;
 
+    m_clearScore(list);
+
     while (list->getSizeOfProcessQ() > 0) {
         if (m_popQ(list, frame, true, 1) != NO_ERROR) {
             CLOGE("getBufferToManageQ fail");
@@ -662,7 +675,14 @@ ExynosCameraFrameSP_sptr_t ExynosCameraFrameSelector::m_selectNormalFrame(int tr
     int ret = 0;
     ExynosCameraFrameSP_sptr_t selectedFrame = NULL;
 
-    ret = m_waitAndpopQ(&m_frameHoldList, selectedFrame, false, tryCount);
+    /* the best scored frame in the list, or the oldest one */
+    if (m_flagScoreSelect == true)
+        selectedFrame = m_popBestFrame(&m_frameHoldList);
+
+    if (selectedFrame == NULL) {
+        ret = m_waitAndpopQ(&m_frameHoldList, selectedFrame, false, tryCount);
+    }
+
     if (ret < 0 || selectedFrame == NULL) {
         CLOGD("getFrame Fail ret(%d)", ret);
         return NULL;
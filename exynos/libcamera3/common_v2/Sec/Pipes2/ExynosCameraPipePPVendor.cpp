@@ -42,6 +42,13 @@ status_t ExynosCameraPipePP::create(__unused int32_t *sensorIds)
 
         if (m_pp->flagCreated() == false) {
             ret = m_pp->create();
+            if (ret != NO_ERROR) {
+                CLOGW("m_pp(%s)->create() fail. so, fall back to ExynosCameraPPSW", m_pp->getName());
+                SAFE_DELETE(m_pp);
+
+                m_pp = ExynosCameraPPFactory::newSWPP(m_cameraId, m_configurations, m_parameters, m_nodeNum);
+                ret = m_pp->create();
+            }
             if (ret != NO_ERROR) {
                 CLOGE("m_pp->create() fail");
                 return INVALID_OPERATION;
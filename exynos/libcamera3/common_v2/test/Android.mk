@@ -0,0 +1,226 @@
+# Copyright (C) 2017 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Tests and benchmarks of libexynoscamera3.
+# Included by the libcamera3 makefile of the SoC, which sets LIBEXYNOSCAMERA3_C_INCLUDES
+# and LIBEXYNOSCAMERA3_CFLAGS to the ones libexynoscamera3 is built with.
+
+LOCAL_PATH:= $(call my-dir)
+
+include $(CLEAR_VARS)
+
+LOCAL_STATIC_LIBRARIES := android.hardware.camera.common@1.0-helper
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog libcamera_metadata
+LOCAL_SHARED_LIBRARIES += libexynoscamera3
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES := $(LIBEXYNOSCAMERA3_C_INCLUDES)
+LOCAL_CFLAGS := $(LIBEXYNOSCAMERA3_CFLAGS)
+
+LOCAL_SRC_FILES:= \
+	./ExynosCameraMetadataConverterTest.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscamera3_converter_test
+
+include $(BUILD_NATIVE_TEST)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_SHARED_LIBRARIES += libexynoscamera3
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES := $(LIBEXYNOSCAMERA3_C_INCLUDES)
+LOCAL_CFLAGS := $(LIBEXYNOSCAMERA3_CFLAGS)
+
+LOCAL_SRC_FILES:= \
+	./ExynosCameraBufferIndexMapBenchmark.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscamera3_index_map_benchmark
+
+include $(BUILD_EXECUTABLE)
+
+# the logger is built in with TIME_LOGGER_ENABLE, whatever libexynoscamera3 is built with
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_SHARED_LIBRARIES += libexynoscamera3
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES := $(LIBEXYNOSCAMERA3_C_INCLUDES)
+LOCAL_CFLAGS := $(LIBEXYNOSCAMERA3_CFLAGS)
+LOCAL_CFLAGS += -DTIME_LOGGER_ENABLE
+
+LOCAL_SRC_FILES:= \
+	../ExynosCameraTimeLogger.cpp \
+	./ExynosCameraTimeLoggerBenchmark.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscamera3_time_logger_benchmark
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES := $(LIBEXYNOSCAMERA3_C_INCLUDES)
+LOCAL_CFLAGS := $(LIBEXYNOSCAMERA3_CFLAGS)
+
+LOCAL_SRC_FILES:= \
+	./ExynosCameraListBenchmark.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscamera3_list_benchmark
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_STATIC_LIBRARIES := android.hardware.camera.common@1.0-helper
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog libcamera_metadata
+LOCAL_SHARED_LIBRARIES += libexynoscamera3
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES := $(LIBEXYNOSCAMERA3_C_INCLUDES)
+LOCAL_CFLAGS := $(LIBEXYNOSCAMERA3_CFLAGS)
+
+LOCAL_SRC_FILES:= \
+	./ExynosCameraRequestRingTest.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscamera3_request_ring_test
+
+include $(BUILD_NATIVE_TEST)
+
+include $(CLEAR_VARS)
+
+LOCAL_STATIC_LIBRARIES := android.hardware.camera.common@1.0-helper
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog libcamera_metadata
+LOCAL_SHARED_LIBRARIES += libexynoscamera3
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES := $(LIBEXYNOSCAMERA3_C_INCLUDES)
+LOCAL_CFLAGS := $(LIBEXYNOSCAMERA3_CFLAGS)
+
+LOCAL_SRC_FILES:= \
+	./ExynosCameraRequestRingBenchmark.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscamera3_request_ring_benchmark
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_STATIC_LIBRARIES := android.hardware.camera.common@1.0-helper
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog libcamera_metadata
+LOCAL_SHARED_LIBRARIES += libexynoscamera3
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES := $(LIBEXYNOSCAMERA3_C_INCLUDES)
+LOCAL_CFLAGS := $(LIBEXYNOSCAMERA3_CFLAGS)
+
+LOCAL_SRC_FILES:= \
+	./ExynosCameraFrameScoreTest.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscamera3_frame_score_test
+
+include $(BUILD_NATIVE_TEST)
+
+include $(CLEAR_VARS)
+
+LOCAL_STATIC_LIBRARIES := android.hardware.camera.common@1.0-helper
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog libcamera_metadata
+LOCAL_SHARED_LIBRARIES += libexynoscamera3
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES := $(LIBEXYNOSCAMERA3_C_INCLUDES)
+LOCAL_CFLAGS := $(LIBEXYNOSCAMERA3_CFLAGS)
+
+LOCAL_SRC_FILES:= \
+	./ExynosCameraFrameSelectorBenchmark.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscamera3_frame_selector_benchmark
+
+include $(BUILD_EXECUTABLE)
+
+# the slab is header only, the frame and entity classes are stood in for by objects of their size
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES := $(LIBEXYNOSCAMERA3_C_INCLUDES)
+LOCAL_CFLAGS := $(LIBEXYNOSCAMERA3_CFLAGS)
+
+LOCAL_SRC_FILES:= \
+	./ExynosCameraObjectSlabTest.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscamera3_object_slab_test
+
+include $(BUILD_NATIVE_TEST)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES := $(LIBEXYNOSCAMERA3_C_INCLUDES)
+LOCAL_CFLAGS := $(LIBEXYNOSCAMERA3_CFLAGS)
+
+LOCAL_SRC_FILES:= \
+	./ExynosCameraObjectSlabBenchmark.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscamera3_object_slab_benchmark
+
+include $(BUILD_EXECUTABLE)
+
+# the simulator is header only, so it runs on the host as well as on a device without the driver
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES := $(LIBEXYNOSCAMERA3_C_INCLUDES)
+LOCAL_CFLAGS := $(LIBEXYNOSCAMERA3_CFLAGS)
+
+LOCAL_SRC_FILES:= \
+	./ExynosCameraNodeSimulatorBenchmark.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscamera3_node_simulator_benchmark
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+
+LOCAL_C_INCLUDES := $(LOCAL_PATH)/..
+
+LOCAL_SRC_FILES:= \
+	./ExynosCameraNodeSimulatorBenchmark.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscamera3_node_simulator_benchmark
+
+include $(BUILD_HOST_EXECUTABLE)
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Cost of ExynosCameraBufferManager::getIndexByFd(), the FD map lookup checked against the buffer
+ * as the manager does it, and the linear scan over the buffers it replaces.
+ * Before the lookups are timed, the buffers are reallocated many times with new FDs and every
+ * lookup of the map is compared with the scan, so a stale or lost entry shows up as a mismatch.
+ *
+ * usage: ExynosCameraBufferIndexMapBenchmark [lookups]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ExynosCameraBuffer.h"
+#include "ExynosCameraBufferIndexMap.h"
+
+using namespace android;
+
+#define BENCH_DEFAULT_LOOKUP    1000000
+#define BENCH_CHURN             100000
+#define BENCH_FD_BASE           16
+
+static const int benchBufferCount[] = {8, 16, 32, 64, 128};
+
+static uint64_t getTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int scanIndexByFd(struct ExynosCameraBuffer *buffer, int count, int fd)
+{
+    for (int bufIndex = 0; bufIndex < count; bufIndex++) {
+        if (buffer[bufIndex].fd[0] == fd)
+            return bufIndex;
+    }
+
+    return -1;
+}
+
+/* the lookup of ExynosCameraBufferManager::m_getIndexByFd() */
+static int mapIndexByFd(ExynosCameraBufferIndexMap *map, struct ExynosCameraBuffer *buffer, int count, int fd)
+{
+    int bufIndex = map->find((uintptr_t)fd);
+
+    if (0 <= bufIndex && bufIndex < count && buffer[bufIndex].fd[0] == fd)
+        return bufIndex;
+
+    map->erase((uintptr_t)fd);
+    bufIndex = scanIndexByFd(buffer, count, fd);
+    if (bufIndex >= 0)
+        map->insert((uintptr_t)fd, bufIndex);
+
+    return bufIndex;
+}
+
+/* a free FD, the kernel hands out the lowest free one but the manager sees them in any order */
+static int newFd(struct ExynosCameraBuffer *buffer, int count)
+{
+    int fd;
+
+    do {
+        fd = BENCH_FD_BASE + rand() % (count * 4);
+    } while (scanIndexByFd(buffer, count, fd) >= 0);
+
+    return fd;
+}
+
+int main(int argc, char **argv)
+{
+    int lookup = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_LOOKUP;
+    int mismatch = 0;
+
+    if (lookup <= 0) {
+        printf("usage: %s [lookups]\n", argv[0]);
+        return -1;
+    }
+
+    srand(1);
+
+    printf("%d lookups\n", lookup);
+    printf("buffers |    map |   scan\n");
+
+    for (size_t n = 0; n < sizeof(benchBufferCount) / sizeof(benchBufferCount[0]); n++) {
+        int count = benchBufferCount[n];
+        struct ExynosCameraBuffer *buffer = new struct ExynosCameraBuffer[count];
+        ExynosCameraBufferIndexMap *map = new ExynosCameraBufferIndexMap;
+        int *fds = new int[lookup];
+        volatile int sink = 0;
+
+        for (int i = 0; i < count; i++)
+            buffer[i].fd[0] = -1;
+        for (int i = 0; i < count; i++) {
+            buffer[i].fd[0] = newFd(buffer, count);
+            map->insert((uintptr_t)buffer[i].fd[0], i);
+        }
+
+        /*
+         * free and allocate again with a new FD, through the map as m_defaultFree() and
+         * m_defaultAlloc() do, or behind its back as the buffer container does
+         */
+        for (int i = 0; i < BENCH_CHURN; i++) {
+            int bufIndex = rand() % count;
+
+            if (rand() % 4)
+                map->erase((uintptr_t)buffer[bufIndex].fd[0]);
+            buffer[bufIndex].fd[0] = -1;
+            buffer[bufIndex].fd[0] = newFd(buffer, count);
+            if (rand() % 4)
+                map->insert((uintptr_t)buffer[bufIndex].fd[0], bufIndex);
+
+            int fd = (rand() % 2) ? buffer[rand() % count].fd[0] : BENCH_FD_BASE + rand() % (count * 4);
+            if (mapIndexByFd(map, buffer, count, fd) != scanIndexByFd(buffer, count, fd))
+                mismatch++;
+        }
+
+        for (int i = 0; i < lookup; i++)
+            fds[i] = buffer[rand() % count].fd[0];
+
+        uint64_t start = getTimeNs();
+        for (int i = 0; i < lookup; i++)
+            sink += mapIndexByFd(map, buffer, count, fds[i]);
+        uint64_t mapNs = getTimeNs() - start;
+
+        start = getTimeNs();
+        for (int i = 0; i < lookup; i++)
+            sink += scanIndexByFd(buffer, count, fds[i]);
+        uint64_t scanNs = getTimeNs() - start;
+
+        printf("%7d | %3.1f ns | %3.1f ns\n", count, (double)mapNs / lookup, (double)scanNs / lookup);
+
+        delete[] fds;
+        delete map;
+        delete[] buffer;
+    }
+
+    printf("map : %s (%d lookups differ from the scan)\n", mismatch ? "MISMATCH" : "match", mismatch);
+
+    return mismatch ? -1 : 0;
+}
@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The scored ZSL selection of ExynosCameraFrameSelector, without the frames and the pipes.
+ * The traces are the per frame metadata the selector reads from the dm of the shot
+ * (frame_score_meta_t), replayed through the hold list as m_manageNormalFrameHoldListHAL3()
+ * keeps it, and the frame m_selectNormalFrame() would take at the shutter is checked.
+ * The traces are written by hand in that form. A trace dumped on a device from the CLOGV of
+ * m_pushScore() can be added to the tables the same way.
+ */
+
+#define LOG_TAG "ExynosCameraFrameScoreTest"
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ExynosCameraFrameSelector.h"
+
+using namespace android;
+
+class ScoreFrame : public LightRefBase<ScoreFrame> {
+public:
+    ScoreFrame(uint32_t frameCount) : m_frameCount(frameCount) {}
+
+    uint32_t getFrameCount(void) { return m_frameCount; }
+
+private:
+    uint32_t m_frameCount;
+};
+
+typedef sp<ScoreFrame> ScoreFrameSP_t;
+typedef ExynosCameraList<ScoreFrameSP_t> score_queue_t;
+
+struct scoreHold {
+    score_queue_t                               list;
+    ExynosCameraFrameScoreHeap<ScoreFrameSP_t>  heap;
+    ExynosCameraFrameScorePolicyDefault         policy;
+    frame_score_meta_t                          lastMeta;
+    bool                                        hasLastMeta;
+
+    scoreHold() : hasLastMeta(false) {}
+};
+
+/* frameCount, timeStamp, afState, aeState, exposureTime, sensitivity, gyro, gmvX, gmvY */
+
+/* the AF settles, then a shake, then the AE moves on the last frame */
+static const frame_score_meta_t afSettleTrace[] = {
+    {1, 1033333333, AA_AFSTATE_PASSIVE_SCAN,    AE_STATE_SEARCHING, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {2, 1066666666, AA_AFSTATE_PASSIVE_SCAN,    AE_STATE_SEARCHING, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {3, 1099999999, AA_AFSTATE_PASSIVE_SCAN,    AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {4, 1133333332, AA_AFSTATE_PASSIVE_SCAN,    AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {5, 1166666665, AA_AFSTATE_PASSIVE_FOCUSED, AE_STATE_CONVERGED, 33000000, 400, {0.02f, 0.0f, 0.0f}, 0, 0},
+    {6, 1199999998, AA_AFSTATE_PASSIVE_FOCUSED, AE_STATE_CONVERGED, 33000000, 400, {0.4f, 0.3f, 0.2f}, 0, 0},
+    {7, 1233333331, AA_AFSTATE_PASSIVE_FOCUSED, AE_STATE_CONVERGED, 33000000, 400, {0.03f, 0.0f, 0.0f}, 0, 0},
+    {8, 1266666664, AA_AFSTATE_PASSIVE_FOCUSED, AE_STATE_CONVERGED, 25000000, 520, {0.02f, 0.0f, 0.0f}, 0, 0},
+};
+
+/* touch AF locked, the AE converges, a shake, then the light changes */
+static const frame_score_meta_t aeConvergeTrace[] = {
+    {1,  1033333333, AA_AFSTATE_FOCUSED_LOCKED, AE_STATE_SEARCHING, 10000000, 800, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {2,  1066666666, AA_AFSTATE_FOCUSED_LOCKED, AE_STATE_SEARCHING, 14000000, 700, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {3,  1099999999, AA_AFSTATE_FOCUSED_LOCKED, AE_STATE_SEARCHING, 20000000, 600, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {4,  1133333332, AA_AFSTATE_FOCUSED_LOCKED, AE_STATE_SEARCHING, 26000000, 520, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {5,  1166666665, AA_AFSTATE_FOCUSED_LOCKED, AE_STATE_SEARCHING, 30000000, 500, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {6,  1199999998, AA_AFSTATE_FOCUSED_LOCKED, AE_STATE_CONVERGED, 33000000, 480, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {7,  1233333331, AA_AFSTATE_FOCUSED_LOCKED, AE_STATE_CONVERGED, 33000000, 480, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {8,  1266666664, AA_AFSTATE_FOCUSED_LOCKED, AE_STATE_CONVERGED, 33000000, 480, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {9,  1299999997, AA_AFSTATE_FOCUSED_LOCKED, AE_STATE_CONVERGED, 33000000, 480, {0.6f, 0.5f, 0.1f}, 0, 0},
+    {10, 1333333330, AA_AFSTATE_FOCUSED_LOCKED, AE_STATE_SEARCHING, 28000000, 560, {0.01f, 0.0f, 0.0f}, 0, 0},
+};
+
+/* a still scene, nothing to tell the frames apart but the time */
+static const frame_score_meta_t stillTrace[] = {
+    {1, 1033333333, AA_AFSTATE_PASSIVE_FOCUSED, AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {2, 1066666666, AA_AFSTATE_PASSIVE_FOCUSED, AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {3, 1099999999, AA_AFSTATE_PASSIVE_FOCUSED, AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {4, 1133333332, AA_AFSTATE_PASSIVE_FOCUSED, AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {5, 1166666665, AA_AFSTATE_PASSIVE_FOCUSED, AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {6, 1199999998, AA_AFSTATE_PASSIVE_FOCUSED, AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+};
+
+/* the only focused frame is evicted long before the shutter */
+static const frame_score_meta_t evictedTrace[] = {
+    {1, 1033333333, AA_AFSTATE_PASSIVE_SCAN,         AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {2, 1066666666, AA_AFSTATE_FOCUSED_LOCKED,       AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {3, 1099999999, AA_AFSTATE_NOT_FOCUSED_LOCKED,   AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {4, 1133333332, AA_AFSTATE_NOT_FOCUSED_LOCKED,   AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {5, 1166666665, AA_AFSTATE_NOT_FOCUSED_LOCKED,   AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {6, 1199999998, AA_AFSTATE_NOT_FOCUSED_LOCKED,   AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {7, 1233333331, AA_AFSTATE_NOT_FOCUSED_LOCKED,   AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+    {8, 1266666664, AA_AFSTATE_NOT_FOCUSED_LOCKED,   AE_STATE_CONVERGED, 33000000, 400, {0.01f, 0.0f, 0.0f}, 0, 0},
+};
+
+#define TRACE_SIZE(trace) (sizeof(trace) / sizeof(trace[0]))
+
+/* as m_manageNormalFrameHoldListHAL3() */
+static void holdFrame(struct scoreHold *hold, const frame_score_meta_t *meta, uint32_t holdCount)
+{
+    ScoreFrameSP_t frame = new ScoreFrame(meta->frameCount);
+    ScoreFrameSP_t oldFrame = NULL;
+    int64_t score = hold->policy.score(meta, (hold->hasLastMeta == true) ? &hold->lastMeta : NULL);
+
+    hold->list.pushProcessQ(&frame);
+    hold->heap.push(&hold->list, score, meta->frameCount);
+    hold->lastMeta = *meta;
+    hold->hasLastMeta = true;
+
+    if (hold->list.getSizeOfProcessQ() > (int)holdCount) {
+        hold->list.popProcessQ(&oldFrame);
+        hold->heap.remove(oldFrame->getFrameCount());
+    }
+}
+
+/* the frameCount m_selectNormalFrame() takes after the trace, 0 for none */
+static uint32_t replay(struct scoreHold *hold, const frame_score_meta_t *trace, size_t size, uint32_t holdCount)
+{
+    ScoreFrameSP_t frame = NULL;
+
+    for (size_t i = 0; i < size; i++)
+        holdFrame(hold, &trace[i], holdCount);
+
+    frame = hold->heap.popBest(&hold->list, NULL, NULL);
+
+    return (frame != NULL) ? frame->getFrameCount() : 0;
+}
+
+TEST(ExynosCameraFrameScoreTest, AfSettledWithoutShake)
+{
+    struct scoreHold hold;
+
+    /* 6 shakes and 8 changes the exposure, 7 is later than 5 */
+    EXPECT_EQ(7u, replay(&hold, afSettleTrace, TRACE_SIZE(afSettleTrace), 5));
+    EXPECT_EQ(4, hold.list.getSizeOfProcessQ());
+}
+
+TEST(ExynosCameraFrameScoreTest, AeConvergedWithoutShake)
+{
+    struct scoreHold hold;
+
+    /* 7 ~ 10 are held, 9 shakes and 10 is searching again */
+    EXPECT_EQ(8u, replay(&hold, aeConvergeTrace, TRACE_SIZE(aeConvergeTrace), 4));
+}
+
+TEST(ExynosCameraFrameScoreTest, StillSceneClosestToShutter)
+{
+    struct scoreHold hold;
+
+    EXPECT_EQ(6u, replay(&hold, stillTrace, TRACE_SIZE(stillTrace), 4));
+}
+
+TEST(ExynosCameraFrameScoreTest, EvictedFrameNotSelected)
+{
+    struct scoreHold hold;
+    ScoreFrameSP_t frame = NULL;
+
+    EXPECT_EQ(8u, replay(&hold, evictedTrace, TRACE_SIZE(evictedTrace), 3));
+
+    /* then the rest of the held ones, and nothing from the evicted ones */
+    frame = hold.heap.popBest(&hold.list, NULL, NULL);
+    ASSERT_TRUE(frame != NULL);
+    EXPECT_EQ(7u, frame->getFrameCount());
+    frame = hold.heap.popBest(&hold.list, NULL, NULL);
+    ASSERT_TRUE(frame != NULL);
+    EXPECT_EQ(6u, frame->getFrameCount());
+    frame = hold.heap.popBest(&hold.list, NULL, NULL);
+    EXPECT_TRUE(frame == NULL);
+    EXPECT_EQ(0, hold.list.getSizeOfProcessQ());
+}
+
+/* only the newest FRAME_SCORE_HEAP_SIZE frames are scored, and they are taken in the score order */
+TEST(ExynosCameraFrameScoreTest, PopInScoreOrder)
+{
+    score_queue_t list;
+    ExynosCameraFrameScoreHeap<ScoreFrameSP_t> heap;
+    std::vector<std::pair<int64_t, uint32_t> > expected;
+    ScoreFrameSP_t frame = NULL;
+    ScoreFrameSP_t front = NULL;
+    uint32_t numOfFrame = FRAME_SCORE_HEAP_SIZE * 2 + 8;
+    uint32_t key = 0;
+    int64_t score = 0;
+
+    for (uint32_t frameCount = 1; frameCount <= numOfFrame; frameCount++) {
+        frame = new ScoreFrame(frameCount);
+        score = (frameCount * 7919) % 101;
+        list.pushProcessQ(&frame);
+        EXPECT_TRUE(heap.push(&list, score, frameCount));
+
+        if (frameCount > numOfFrame - FRAME_SCORE_HEAP_SIZE)
+            expected.push_back(std::make_pair(score, frameCount));
+    }
+    EXPECT_EQ(FRAME_SCORE_HEAP_SIZE, heap.getSize());
+
+    /* the newer one first on the same score */
+    std::sort(expected.rbegin(), expected.rend());
+    for (size_t i = 0; i < expected.size(); i++) {
+        frame = heap.popBest(&list, &key, &score);
+        ASSERT_TRUE(frame != NULL);
+        EXPECT_EQ(expected[i].second, frame->getFrameCount());
+        EXPECT_EQ(expected[i].second, key);
+        EXPECT_EQ(expected[i].first, score);
+    }
+    EXPECT_TRUE(heap.popBest(&list, NULL, NULL) == NULL);
+
+    EXPECT_EQ((int)(numOfFrame - FRAME_SCORE_HEAP_SIZE), list.getSizeOfProcessQ());
+    ASSERT_EQ(NO_ERROR, list.popProcessQ(&front));
+    EXPECT_EQ(1u, front->getFrameCount());
+}
+
+/* the FIFO pops of the selector take the frames out of the list behind the heap */
+TEST(ExynosCameraFrameScoreTest, FramesLeftFromFront)
+{
+    score_queue_t list;
+    ExynosCameraFrameScoreHeap<ScoreFrameSP_t> heap;
+    ScoreFrameSP_t frame = NULL;
+
+    /* the older is the better */
+    for (uint32_t frameCount = 1; frameCount <= 5; frameCount++) {
+        frame = new ScoreFrame(frameCount);
+        list.pushProcessQ(&frame);
+        heap.push(&list, 100 - frameCount * 10, frameCount);
+    }
+
+    list.popProcessQ(&frame);
+    list.popProcessQ(&frame);
+    frame = heap.popBest(&list, NULL, NULL);
+    ASSERT_TRUE(frame != NULL);
+    EXPECT_EQ(3u, frame->getFrameCount());
+
+    list.popProcessQ(&frame);
+    EXPECT_EQ(4u, frame->getFrameCount());
+    frame = heap.popBest(&list, NULL, NULL);
+    ASSERT_TRUE(frame != NULL);
+    EXPECT_EQ(5u, frame->getFrameCount());
+
+    EXPECT_TRUE(heap.popBest(&list, NULL, NULL) == NULL);
+    EXPECT_EQ(0, list.getSizeOfProcessQ());
+}
+
+/* a frameCount out of the order drops the older entries, which could not be checked any more */
+TEST(ExynosCameraFrameScoreTest, FrameCountOutOfOrder)
+{
+    score_queue_t list;
+    ExynosCameraFrameScoreHeap<ScoreFrameSP_t> heap;
+    ScoreFrameSP_t frame = NULL;
+
+    frame = new ScoreFrame(10);
+    list.pushProcessQ(&frame);
+    heap.push(&list, 100, 10);
+    frame = new ScoreFrame(11);
+    list.pushProcessQ(&frame);
+    heap.push(&list, 0, 11);
+
+    /* e.g. the frame count is reset on the restart of the stream */
+    frame = new ScoreFrame(5);
+    list.pushProcessQ(&frame);
+    heap.push(&list, 50, 5);
+    EXPECT_EQ(1, heap.getSize());
+
+    list.popProcessQ(&frame);
+    list.popProcessQ(&frame);
+    frame = heap.popBest(&list, NULL, NULL);
+    ASSERT_TRUE(frame != NULL);
+    EXPECT_EQ(5u, frame->getFrameCount());
+
+    /* a frame which left the list before it is scored */
+    EXPECT_FALSE(heap.push(&list, 50, 6));
+    EXPECT_EQ(0, heap.getSize());
+}
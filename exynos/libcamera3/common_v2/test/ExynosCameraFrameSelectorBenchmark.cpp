@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Selection latency of the ZSL hold list of ExynosCameraFrameSelector, for a given hold count.
+ * The frames come in with the metadata of a shaky preview, the oldest one is evicted past the
+ * hold count, and a frame is selected on every frame.
+ *
+ * fifo  : the oldest frame, m_waitAndpopQ() without the wait
+ * scan  : the best score, found by a walk of the raw list, O(n) as m_popBestFrame() was
+ * heap  : the best score, ExynosCameraFrameScoreHeap::popBest()
+ * score : ExynosCameraFrameScorePolicyDefault::score() and the heap push of a new frame
+ *
+ * scan and heap must select the same frames, otherwise it is counted as a mismatch.
+ *
+ * usage: ExynosCameraFrameSelectorBenchmark [frames]
+ */
+
+#define LOG_TAG "ExynosCameraFrameSelectorBenchmark"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "ExynosCameraFrameSelector.h"
+
+using namespace android;
+
+#define BENCH_DEFAULT_FRAMES    200000
+
+static const int benchHoldCount[] = {2, 4, 8, 16};
+
+class BenchFrame : public LightRefBase<BenchFrame> {
+public:
+    BenchFrame(uint32_t frameCount, int64_t score) : m_frameCount(frameCount), m_score(score) {}
+
+    uint32_t getFrameCount(void) { return m_frameCount; }
+    int64_t getScore(void) { return m_score; }
+
+private:
+    uint32_t m_frameCount;
+    int64_t m_score;
+};
+
+typedef sp<BenchFrame> BenchFrameSP_t;
+typedef ExynosCameraList<BenchFrameSP_t> bench_queue_t;
+
+enum BENCH_TYPE {
+    BENCH_TYPE_FIFO = 0,
+    BENCH_TYPE_SCAN,
+    BENCH_TYPE_HEAP,
+    BENCH_TYPE_MAX,
+};
+
+struct benchResult {
+    std::vector<uint64_t> selectTime;
+    std::vector<uint32_t> selected;
+    uint64_t scoreTime;
+};
+
+static uint64_t getTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* a 30fps preview, the AF and the AE move now and then, and the hand shakes */
+static void getMeta(uint32_t frameCount, uint32_t *seed, frame_score_meta_t *meta)
+{
+    static const int afState[] = {AA_AFSTATE_PASSIVE_SCAN, AA_AFSTATE_PASSIVE_FOCUSED,
+                                  AA_AFSTATE_PASSIVE_FOCUSED, AA_AFSTATE_PASSIVE_UNFOCUSED};
+    static const int aeState[] = {AE_STATE_SEARCHING, AE_STATE_CONVERGED,
+                                  AE_STATE_CONVERGED, AE_STATE_CONVERGED};
+
+    *seed = *seed * 1103515245 + 12345;
+
+    memset(meta, 0x00, sizeof(frame_score_meta_t));
+    meta->frameCount = frameCount;
+    meta->timeStamp = (uint64_t)frameCount * 33333333;
+    meta->afState = afState[(*seed >> 8) & 0x3];
+    meta->aeState = aeState[(*seed >> 10) & 0x3];
+    meta->exposureTime = ((*seed >> 12) & 0x1) ? 33000000 : 25000000;
+    meta->sensitivity = 400;
+    meta->gyro[0] = (float)((*seed >> 16) & 0xff) / 256.0f;
+}
+
+/* the best score in the list, the newer one on the same score */
+static BenchFrameSP_t popScanned(bench_queue_t *list)
+{
+    BenchFrameSP_t selectedFrame = NULL;
+    List<BenchFrameSP_t> *rawList = NULL;
+    List<BenchFrameSP_t>::iterator best;
+    List<BenchFrameSP_t>::iterator r;
+
+    list->rawLockProcessList();
+    rawList = list->getRawProcessList();
+    if (rawList->empty() == false) {
+        best = rawList->begin();
+        for (r = rawList->begin(); r != rawList->end(); r++) {
+            if ((*r)->getScore() >= (*best)->getScore())
+                best = r;
+        }
+        selectedFrame = *best;
+        rawList->erase(best);
+    }
+    list->rawUnLockProcessList();
+
+    return selectedFrame;
+}
+
+static void run(enum BENCH_TYPE type, int holdCount, int frames, struct benchResult *result)
+{
+    bench_queue_t list;
+    ExynosCameraFrameScoreHeap<BenchFrameSP_t> heap;
+    ExynosCameraFrameScorePolicyDefault policy;
+    frame_score_meta_t meta;
+    frame_score_meta_t lastMeta;
+    BenchFrameSP_t frame = NULL;
+    uint32_t seed = 1;
+    uint64_t start = 0;
+
+    result->selectTime.clear();
+    result->selected.clear();
+    result->scoreTime = 0;
+
+    for (uint32_t frameCount = 1; frameCount <= (uint32_t)frames; frameCount++) {
+        getMeta(frameCount, &seed, &meta);
+
+        start = getTimeNs();
+        int64_t score = policy.score(&meta, (frameCount > 1) ? &lastMeta : NULL);
+        frame = new BenchFrame(frameCount, score);
+        list.pushProcessQ(&frame);
+        if (type == BENCH_TYPE_HEAP)
+            heap.push(&list, score, frameCount);
+        result->scoreTime += getTimeNs() - start;
+        lastMeta = meta;
+
+        if (list.getSizeOfProcessQ() > holdCount) {
+            list.popProcessQ(&frame);
+            if (type == BENCH_TYPE_HEAP)
+                heap.remove(frame->getFrameCount());
+        }
+
+        if (list.getSizeOfProcessQ() < holdCount)
+            continue;
+
+        start = getTimeNs();
+        if (type == BENCH_TYPE_FIFO)
+            list.popProcessQ(&frame);
+        else if (type == BENCH_TYPE_SCAN)
+            frame = popScanned(&list);
+        else
+            frame = heap.popBest(&list, NULL, NULL);
+        result->selectTime.push_back(getTimeNs() - start);
+
+        result->selected.push_back((frame != NULL) ? frame->getFrameCount() : 0);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int frames = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_FRAMES;
+    int mismatch = 0;
+    struct benchResult result[BENCH_TYPE_MAX];
+
+    if (frames <= 0) {
+        printf("usage: %s [frames]\n", argv[0]);
+        return -1;
+    }
+
+    printf("%d frames, selection on every frame, ns per selection (p50/p99)\n", frames);
+    printf("hold |     fifo     |     scan     |     heap     | score+push\n");
+
+    for (size_t n = 0; n < sizeof(benchHoldCount) / sizeof(benchHoldCount[0]); n++) {
+        int holdCount = benchHoldCount[n];
+        uint64_t p50[BENCH_TYPE_MAX];
+        uint64_t p99[BENCH_TYPE_MAX];
+
+        for (int type = 0; type < BENCH_TYPE_MAX; type++) {
+            std::vector<uint64_t> *time = &result[type].selectTime;
+
+            run((enum BENCH_TYPE)type, holdCount, frames, &result[type]);
+
+            std::sort(time->begin(), time->end());
+            p50[type] = time->empty() ? 0 : (*time)[time->size() / 2];
+            p99[type] = time->empty() ? 0 : (*time)[time->size() * 99 / 100];
+        }
+
+        for (size_t i = 0; i < result[BENCH_TYPE_SCAN].selected.size(); i++) {
+            if (result[BENCH_TYPE_SCAN].selected[i] != result[BENCH_TYPE_HEAP].selected[i])
+                mismatch++;
+        }
+
+        printf("%4d | %5ju/%5ju  | %5ju/%5ju  | %5ju/%5ju  | %6.1f\n", holdCount,
+                (uintmax_t)p50[BENCH_TYPE_FIFO], (uintmax_t)p99[BENCH_TYPE_FIFO],
+                (uintmax_t)p50[BENCH_TYPE_SCAN], (uintmax_t)p99[BENCH_TYPE_SCAN],
+                (uintmax_t)p50[BENCH_TYPE_HEAP], (uintmax_t)p99[BENCH_TYPE_HEAP],
+                (double)result[BENCH_TYPE_HEAP].scoreTime / frames);
+    }
+
+    printf("selection : %s (%d frames)\n", mismatch ? "MISMATCH" : "match", mismatch);
+
+    return mismatch ? -1 : 0;
+}
@@ -0,0 +1,366 @@
+/*
+ * Copyright (C) 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ExynosCameraList on the ring (SPSC, MPSC) against the List under the mutex (LIST).
+ * The items are sp<> of a frame, as in frame_queue_t.
+ *
+ * push+pop     : ns per pushProcessQ() and popProcessQ() from one thread
+ * throughput   : ns per item, producers pushing while one consumer waits in waitAndPopProcessQ()
+ * wake latency : pushProcessQ() to the return of waitAndPopProcessQ() of a consumer sleeping
+ *                on the empty queue
+ *
+ * Before the timing, every queue type is checked:
+ *  - the items of each producer come out in order, also with a ring of 4 cells that spills
+ *    into the List all the time
+ *  - release() drops the references of the items left, as m_list_release() expects
+ *  - wakeupAll() returns a consumer waiting on the empty queue
+ *
+ * usage: ExynosCameraListBenchmark [items] [producers]
+ */
+
+#define LOG_TAG "ExynosCameraListBenchmark"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <utils/Log.h>
+
+#include "ExynosCameraList.h"
+
+#define BENCH_DEFAULT_ITEM      1000000
+#define BENCH_DEFAULT_PRODUCER  4
+#define BENCH_MAX_PRODUCER      16
+#define BENCH_RING_SIZE         64
+#define BENCH_SPILL_RING_SIZE   4
+#define BENCH_LATENCY_LOOP      2000
+#define BENCH_LATENCY_GAP_US    200
+#define BENCH_WAIT_TIME         (1000000000LL)
+
+class BenchFrame : public LightRefBase<BenchFrame> {
+public:
+    BenchFrame(uint32_t key = 0, int64_t time = 0) : key(key), time(time) {}
+
+    uint32_t key;
+    int64_t time;
+};
+
+typedef sp<BenchFrame> BenchFrameSP_t;
+typedef ExynosCameraList<BenchFrameSP_t> bench_queue_t;
+
+struct benchProducer {
+    bench_queue_t   *queue;
+    pthread_t       thread;
+    uint32_t        id;
+    int             item;
+    BenchFrameSP_t  frame;
+};
+
+static const char *typeName[] = {"list", "spsc", "mpsc"};
+
+static uint64_t getTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static bench_queue_t *newQueue(enum LIST_QUEUE_TYPE type, uint32_t ringSize)
+{
+    bench_queue_t *queue = new bench_queue_t();
+
+    if (type != LIST_QUEUE_TYPE_LIST)
+        queue->setQueueType(type, ringSize);
+    queue->setWaitTime(BENCH_WAIT_TIME);
+
+    return queue;
+}
+
+/* a new frame per item, tagged with the producer and the sequence */
+static void *orderProducerThread(void *data)
+{
+    struct benchProducer *producer = (struct benchProducer *)data;
+
+    for (int i = 0; i < producer->item; i++) {
+        BenchFrameSP_t frame = new BenchFrame((producer->id << 24) | i);
+        producer->queue->pushProcessQ(&frame);
+    }
+
+    return NULL;
+}
+
+/* the same frame again and again, like a pipe passing its frames on */
+static void *producerThread(void *data)
+{
+    struct benchProducer *producer = (struct benchProducer *)data;
+
+    for (int i = 0; i < producer->item; i++) {
+        producer->queue->pushProcessQ(&producer->frame);
+        /* let the consumer run on a single CPU */
+        if ((i & 31) == 31)
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+/* returns the number of items out of order */
+static int checkOrder(enum LIST_QUEUE_TYPE type, uint32_t ringSize, int numProducer, int item)
+{
+    bench_queue_t *queue = newQueue(type, ringSize);
+    struct benchProducer producer[BENCH_MAX_PRODUCER];
+    std::vector<int> last(numProducer, -1);
+    BenchFrameSP_t frame;
+    int mismatch = 0;
+
+    for (int p = 0; p < numProducer; p++) {
+        producer[p].queue = queue;
+        producer[p].id = p;
+        producer[p].item = item;
+        pthread_create(&producer[p].thread, NULL, orderProducerThread, &producer[p]);
+    }
+
+    for (int i = 0; i < item * numProducer; i++) {
+        if (queue->waitAndPopProcessQ(&frame) != NO_ERROR) {
+            mismatch++;
+            continue;
+        }
+
+        uint32_t p = frame->key >> 24;
+        int seq = frame->key & 0xffffff;
+        if (p >= (uint32_t)numProducer || seq != last[p] + 1)
+            mismatch++;
+        else
+            last[p] = seq;
+    }
+
+    for (int p = 0; p < numProducer; p++)
+        pthread_join(producer[p].thread, NULL);
+
+    if (queue->getSizeOfProcessQ() != 0)
+        mismatch++;
+
+    delete queue;
+
+    return mismatch;
+}
+
+/* returns the number of failed checks */
+static int checkRelease(enum LIST_QUEUE_TYPE type)
+{
+    bench_queue_t *queue = newQueue(type, BENCH_SPILL_RING_SIZE);
+    BenchFrameSP_t frame = new BenchFrame();
+    BenchFrameSP_t popped;
+    int fail = 0;
+
+    /* half of them spilled to the List */
+    for (int i = 0; i < BENCH_SPILL_RING_SIZE * 2; i++)
+        queue->pushProcessQ(&frame);
+
+    if (queue->popProcessQ(&popped) != NO_ERROR)
+        fail++;
+    popped = NULL;
+
+    queue->release();
+    if (frame->getStrongCount() != 1 || queue->getSizeOfProcessQ() != 0)
+        fail++;
+    if (queue->popProcessQ(&popped) != TIMED_OUT)
+        fail++;
+
+    /* still usable after release() */
+    queue->pushProcessQ(&frame);
+    if (queue->popProcessQ(&popped) != NO_ERROR || popped != frame)
+        fail++;
+
+    delete queue;
+
+    return fail;
+}
+
+static void *wakeupThread(void *data)
+{
+    bench_queue_t *queue = (bench_queue_t *)data;
+
+    usleep(20000);
+    queue->wakeupAll();
+
+    return NULL;
+}
+
+/* returns 1 if the consumer is not woken up */
+static int checkWakeup(enum LIST_QUEUE_TYPE type)
+{
+    bench_queue_t *queue = newQueue(type, BENCH_RING_SIZE);
+    BenchFrameSP_t frame;
+    pthread_t thread;
+    status_t ret;
+
+    queue->setWaitTime(BENCH_WAIT_TIME * 2);
+    pthread_create(&thread, NULL, wakeupThread, queue);
+
+    uint64_t start = getTimeNs();
+    ret = queue->waitAndPopProcessQ(&frame);
+    uint64_t elapsed = getTimeNs() - start;
+
+    pthread_join(thread, NULL);
+    delete queue;
+
+    return (ret != TIMED_OUT || elapsed >= BENCH_WAIT_TIME) ? 1 : 0;
+}
+
+static double measurePushPop(enum LIST_QUEUE_TYPE type, int item)
+{
+    bench_queue_t *queue = newQueue(type, BENCH_RING_SIZE);
+    BenchFrameSP_t frame = new BenchFrame();
+    BenchFrameSP_t popped;
+
+    uint64_t start = getTimeNs();
+    for (int i = 0; i < item; i++) {
+        queue->pushProcessQ(&frame);
+        queue->popProcessQ(&popped);
+    }
+    uint64_t elapsed = getTimeNs() - start;
+
+    delete queue;
+
+    return (double)elapsed / item;
+}
+
+static double measureThroughput(enum LIST_QUEUE_TYPE type, int numProducer, int item)
+{
+    bench_queue_t *queue = newQueue(type, BENCH_RING_SIZE);
+    struct benchProducer producer[BENCH_MAX_PRODUCER];
+    BenchFrameSP_t frame = new BenchFrame();
+    BenchFrameSP_t popped;
+    int perProducer = item / numProducer;
+
+    uint64_t start = getTimeNs();
+    for (int p = 0; p < numProducer; p++) {
+        producer[p].queue = queue;
+        producer[p].id = p;
+        producer[p].item = perProducer;
+        producer[p].frame = frame;
+        pthread_create(&producer[p].thread, NULL, producerThread, &producer[p]);
+    }
+
+    for (int i = 0; i < perProducer * numProducer; i++) {
+        while (queue->waitAndPopProcessQ(&popped) != NO_ERROR)
+            ;
+    }
+    uint64_t elapsed = getTimeNs() - start;
+
+    for (int p = 0; p < numProducer; p++)
+        pthread_join(producer[p].thread, NULL);
+
+    delete queue;
+
+    return (double)elapsed / (perProducer * numProducer);
+}
+
+static void *latencyConsumerThread(void *data)
+{
+    bench_queue_t *queue = (bench_queue_t *)data;
+    std::vector<uint64_t> *latency = new std::vector<uint64_t>;
+    BenchFrameSP_t frame;
+
+    for (int i = 0; i < BENCH_LATENCY_LOOP; i++) {
+        while (queue->waitAndPopProcessQ(&frame) != NO_ERROR)
+            ;
+        latency->push_back(getTimeNs() - frame->time);
+    }
+
+    return latency;
+}
+
+static void measureWakeLatency(enum LIST_QUEUE_TYPE type, uint64_t *p50, uint64_t *p99)
+{
+    bench_queue_t *queue = newQueue(type, BENCH_RING_SIZE);
+    std::vector<uint64_t> *latency = NULL;
+    pthread_t thread;
+
+    pthread_create(&thread, NULL, latencyConsumerThread, queue);
+
+    for (int i = 0; i < BENCH_LATENCY_LOOP; i++) {
+        /* the consumer is asleep on the empty queue */
+        usleep(BENCH_LATENCY_GAP_US);
+        BenchFrameSP_t frame = new BenchFrame(i, getTimeNs());
+        queue->pushProcessQ(&frame);
+    }
+
+    pthread_join(thread, (void **)&latency);
+
+    std::sort(latency->begin(), latency->end());
+    *p50 = (*latency)[latency->size() / 2];
+    *p99 = (*latency)[latency->size() * 99 / 100];
+
+    delete latency;
+    delete queue;
+}
+
+int main(int argc, char **argv)
+{
+    int item = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_ITEM;
+    int numProducer = (argc > 2) ? atoi(argv[2]) : BENCH_DEFAULT_PRODUCER;
+    int mismatch = 0;
+
+    if (item < BENCH_MAX_PRODUCER || numProducer <= 0 || numProducer > BENCH_MAX_PRODUCER) {
+        printf("usage: %s [items(%d~)] [producers(1~%d)]\n", argv[0], BENCH_MAX_PRODUCER, BENCH_MAX_PRODUCER);
+        return -1;
+    }
+
+    printf("%d items, %d producers, ring of %d cells\n", item, numProducer, BENCH_RING_SIZE);
+
+    for (int t = LIST_QUEUE_TYPE_LIST; t <= LIST_QUEUE_TYPE_MPSC; t++) {
+        enum LIST_QUEUE_TYPE type = (enum LIST_QUEUE_TYPE)t;
+        /* only one thread may push to a SPSC queue */
+        int producers = (type == LIST_QUEUE_TYPE_SPSC) ? 1 : numProducer;
+        int bad = 0;
+
+        bad += checkOrder(type, BENCH_RING_SIZE, producers, item / 10 / producers);
+        bad += checkOrder(type, BENCH_SPILL_RING_SIZE, producers, item / 10 / producers);
+        bad += checkRelease(type);
+        bad += checkWakeup(type);
+        if (bad)
+            printf("%s : MISMATCH (%d)\n", typeName[t], bad);
+        mismatch += bad;
+    }
+
+    printf("type | push+pop | 1 producer | %2d producers | wake p50 | wake p99\n", numProducer);
+    for (int t = LIST_QUEUE_TYPE_LIST; t <= LIST_QUEUE_TYPE_MPSC; t++) {
+        enum LIST_QUEUE_TYPE type = (enum LIST_QUEUE_TYPE)t;
+        uint64_t p50, p99;
+        char producers[16] = "-";
+
+        if (type != LIST_QUEUE_TYPE_SPSC)
+            snprintf(producers, sizeof(producers), "%.1f ns", measureThroughput(type, numProducer, item));
+        double pushPop = measurePushPop(type, item);
+        double single = measureThroughput(type, 1, item);
+        measureWakeLatency(type, &p50, &p99);
+
+        printf("%4s | %5.1f ns | %7.1f ns | %13s | %5.1f us | %5.1f us\n", typeName[t],
+                pushPop, single, producers, p50 / 1000.0, p99 / 1000.0);
+    }
+
+    printf("queues : %s (%d failed checks)\n", mismatch ? "MISMATCH" : "match", mismatch);
+
+    return mismatch ? -1 : 0;
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Replays a request stream through two converters, one reusing the translation of the unchanged
+ * shot groups and one translating every group, and compares the shots of every request.
+ * The stream starts from the preview and still capture templates and changes the tags of the
+ * cached groups the way an app does: JPEG orientation and GPS per capture, tonemap curves,
+ * color gains, shading and black level lock, with a tag dropped now and then.
+ */
+
+#define LOG_TAG "ExynosCameraMetadataConverterTest"
+
+#include <stdio.h>
+
+#include <gtest/gtest.h>
+#include <utils/Timers.h>
+
+#include "ExynosCameraConfigurations.h"
+#include "ExynosCameraParameters.h"
+#include "ExynosCameraMetadataConverter.h"
+#include "ExynosCameraRequestManager.h"
+
+using namespace android;
+
+#define REPLAY_CAMERA_ID        (CAMERA_ID_BACK)
+#define REPLAY_REQUEST_NUM      (600)
+
+class ReplayConverter {
+public:
+    ReplayConverter(bool cache)
+    {
+        m_configurations = new ExynosCameraConfigurations(REPLAY_CAMERA_ID, SCENARIO_NORMAL);
+        m_parameters = new ExynosCameraParameters(REPLAY_CAMERA_ID, SCENARIO_NORMAL, m_configurations);
+        m_converter = new ExynosCameraMetadataConverter(REPLAY_CAMERA_ID, m_configurations, m_parameters);
+        m_converter->setShotGroupCache(cache);
+        m_elapsed = 0;
+    }
+
+    ~ReplayConverter()
+    {
+        m_converter = NULL;
+        delete m_parameters;
+        delete m_configurations;
+    }
+
+    /* the same calls as ExynosCameraRequestManager::registerToServiceList() */
+    status_t convert(CameraMetadata &settings, uint32_t frameNumber, struct camera2_shot_ext *shot)
+    {
+        camera3_capture_request_t captureRequest;
+        const camera_metadata_t *raw = settings.getAndLock();
+        status_t ret;
+
+        memset(&captureRequest, 0x00, sizeof(captureRequest));
+        captureRequest.frame_number = frameNumber;
+        captureRequest.settings = raw;
+        ExynosCameraRequestSP_sprt_t request = new ExynosCameraRequest(&captureRequest, m_prevMeta);
+        settings.unlock(raw);
+
+        m_converter->setPreviousMeta(&m_prevMeta);
+
+        nsecs_t start = systemTime();
+        ret = m_converter->convertRequestToShot(request);
+        m_elapsed += systemTime() - start;
+
+        memcpy(shot, request->getServiceShot(), sizeof(struct camera2_shot_ext));
+        m_prevMeta = *request->getServiceMeta();
+
+        return ret;
+    }
+
+    sp<ExynosCameraMetadataConverter> converter() { return m_converter; }
+    nsecs_t elapsed() { return m_elapsed; }
+
+private:
+    ExynosCameraConfigurations          *m_configurations;
+    ExynosCameraParameters              *m_parameters;
+    sp<ExynosCameraMetadataConverter>   m_converter;
+    CameraMetadata                      m_prevMeta;
+    nsecs_t                             m_elapsed;
+};
+
+static void makeTemplate(sp<ExynosCameraMetadataConverter> converter, int type, CameraMetadata *settings)
+{
+    camera_metadata_t *raw = NULL;
+
+    ASSERT_EQ(OK, converter->constructDefaultRequestSettings(type, &raw));
+    ASSERT_TRUE(raw != NULL);
+    *settings = raw;
+    free_camera_metadata(raw);
+}
+
+/* the settings of request i, every change lands on a different request than the others */
+static void makeRequest(const CameraMetadata &preview, const CameraMetadata &capture,
+                        uint32_t i, CameraMetadata *settings)
+{
+    *settings = (i % 30 == 29) ? capture : preview;
+
+    int32_t orientation = ((i / 50) % 4) * 90;
+    settings->update(ANDROID_JPEG_ORIENTATION, &orientation, 1);
+
+    if (i % 90 < 80) {
+        double gps[3] = {37.25 + (i / 10) * 0.0001, 127.05, 40.0};
+        settings->update(ANDROID_JPEG_GPS_COORDINATES, gps, 3);
+    } else {
+        settings->erase(ANDROID_JPEG_GPS_COORDINATES);
+    }
+
+    float gains[4] = {1.5f + (i / 7 % 5) * 0.125f, 1.0f, 1.0f, 2.0f};
+    settings->update(ANDROID_COLOR_CORRECTION_GAINS, gains, 4);
+
+    if ((i / 100) % 2) {
+        uint8_t tonemapMode = ANDROID_TONEMAP_MODE_CONTRAST_CURVE;
+        float curve[4] = {0.0f, 0.0f, 1.0f, 0.5f + (i / 25 % 4) * 0.125f};
+        settings->update(ANDROID_TONEMAP_MODE, &tonemapMode, 1);
+        settings->update(ANDROID_TONEMAP_CURVE_RED, curve, 4);
+        settings->update(ANDROID_TONEMAP_CURVE_GREEN, curve, 4);
+        settings->update(ANDROID_TONEMAP_CURVE_BLUE, curve, 4);
+    }
+
+    uint8_t shadingMode = ((i / 150) % 2) ? ANDROID_SHADING_MODE_OFF : ANDROID_SHADING_MODE_FAST;
+    settings->update(ANDROID_SHADING_MODE, &shadingMode, 1);
+
+    uint8_t blackLevelLock = ((i / 60) % 2) ? ANDROID_BLACK_LEVEL_LOCK_ON : ANDROID_BLACK_LEVEL_LOCK_OFF;
+    settings->update(ANDROID_BLACK_LEVEL_LOCK, &blackLevelLock, 1);
+
+    /* a group that is never cached changes as well */
+    int32_t aeCompensation = (i / 40) % 3 - 1;
+    settings->update(ANDROID_CONTROL_AE_EXPOSURE_COMPENSATION, &aeCompensation, 1);
+}
+
+TEST(ExynosCameraMetadataConverterTest, CachedShotGroupsReplay)
+{
+    ReplayConverter cached(true);
+    ReplayConverter uncached(false);
+    CameraMetadata preview, capture, settings;
+    struct camera2_shot_ext *cachedShot = new struct camera2_shot_ext;
+    struct camera2_shot_ext *uncachedShot = new struct camera2_shot_ext;
+    uint32_t diffCount = 0;
+
+    makeTemplate(uncached.converter(), CAMERA3_TEMPLATE_PREVIEW, &preview);
+    makeTemplate(uncached.converter(), CAMERA3_TEMPLATE_STILL_CAPTURE, &capture);
+
+    for (uint32_t i = 0; i < REPLAY_REQUEST_NUM; i++) {
+        makeRequest(preview, capture, i, &settings);
+
+        ASSERT_EQ(OK, cached.convert(settings, i, cachedShot));
+        ASSERT_EQ(OK, uncached.convert(settings, i, uncachedShot));
+
+        if (memcmp(cachedShot, uncachedShot, sizeof(struct camera2_shot_ext)) != 0) {
+            if (diffCount == 0)
+                ADD_FAILURE() << "shot of request " << i << " differs from the translation";
+            diffCount++;
+        }
+    }
+
+    EXPECT_EQ(0u, diffCount);
+
+    printf("%d requests, %u shots differ\n", REPLAY_REQUEST_NUM, diffCount);
+    printf("convertRequestToShot : cached %lld ns, uncached %lld ns per request\n",
+            (long long)(cached.elapsed() / REPLAY_REQUEST_NUM),
+            (long long)(uncached.elapsed() / REPLAY_REQUEST_NUM));
+
+    delete cachedShot;
+    delete uncachedShot;
+}
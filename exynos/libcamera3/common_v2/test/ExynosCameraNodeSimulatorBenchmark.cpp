@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Timing of ExynosCameraNodeSimulator, on the host or on a device without the driver.
+ *
+ * overhead : ns per qbuf() and dqbuf() of a M2M node without latency
+ * pipeline : a sensor node feeding a M2M node, with 1 to BENCH_MAX_BUFFERS buffers going around.
+ *            One thread moves the buffers from the sensor to the M2M node and one gives them back
+ *            to the sensor, as the pipe threads do. Frames per second, interval of the M2M
+ *            output, and the sensor frames dropped for want of a buffer.
+ *
+ * The sensor frame a buffer got is known from its dqbuf time, so the drops are counted here as
+ * well and checked against the ones of the simulator. With more buffers than the frames in flight
+ * and a M2M node as fast as the sensor, nothing may be dropped.
+ *
+ * usage: ExynosCameraNodeSimulatorBenchmark [frames] [fps] [sensor latency us] [M2M latency us]
+ */
+
+#define LOG_TAG "ExynosCameraNodeSimulatorBenchmark"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <utils/Log.h>
+
+#include "ExynosCameraNodeSimulator.h"
+
+using namespace android;
+
+#define BENCH_CAMERA_ID             (0)
+#define BENCH_SENSOR_NODE_NUM       (100)
+#define BENCH_M2M_NODE_NUM          (101)
+#define BENCH_DEFAULT_FRAMES        150
+#define BENCH_DEFAULT_FPS           30
+#define BENCH_DEFAULT_SENSOR_US     33000
+#define BENCH_DEFAULT_M2M_US        10000
+#define BENCH_OVERHEAD_LOOP         100000
+#define BENCH_MAX_BUFFERS           4
+
+struct benchPipe {
+    ExynosCameraNodeSimulator   *sensor;
+    ExynosCameraNodeSimulator   *m2m;
+    pthread_t                   sensorThread;
+    pthread_t                   m2mThread;
+    int                         frames;
+    nsecs_t                     startTime;
+    nsecs_t                     interval;
+    nsecs_t                     sensorLatency;
+    /* sensor thread */
+    int64_t                     lastSlot;
+    /* M2M thread */
+    int                         numSensorQbuf;
+    std::vector<nsecs_t>        doneTime;
+};
+
+static void *sensorThread(void *data)
+{
+    struct benchPipe *pipe = (struct benchPipe *)data;
+    int index;
+
+    for (int i = 0; i < pipe->frames; i++) {
+        if (pipe->sensor->dqbuf(&index) != 0)
+            break;
+
+        /* the frame of the buffer, the dqbuf is late by much less than half a frame */
+        nsecs_t frameTime = systemTime(SYSTEM_TIME_MONOTONIC) - pipe->startTime - pipe->sensorLatency;
+        pipe->lastSlot = (frameTime + pipe->interval / 2) / pipe->interval;
+
+        pipe->m2m->qbuf(index);
+    }
+
+    return NULL;
+}
+
+static void *m2mThread(void *data)
+{
+    struct benchPipe *pipe = (struct benchPipe *)data;
+    int index;
+
+    for (int i = 0; i < pipe->frames; i++) {
+        if (pipe->m2m->dqbuf(&index) != 0)
+            break;
+
+        pipe->doneTime.push_back(systemTime(SYSTEM_TIME_MONOTONIC));
+
+        /* no more buffers to the sensor than the frames taken, it drops nothing after the last one */
+        if (pipe->numSensorQbuf < pipe->frames) {
+            pipe->sensor->qbuf(index);
+            pipe->numSensorQbuf++;
+        }
+    }
+
+    return NULL;
+}
+
+static double measureOverhead(void)
+{
+    ExynosCameraNodeSimulator *node = new ExynosCameraNodeSimulator(BENCH_CAMERA_ID, "M2M", BENCH_M2M_NODE_NUM);
+    int index;
+
+    node->setLatency(0, 0);
+    node->start();
+
+    nsecs_t start = systemTime(SYSTEM_TIME_MONOTONIC);
+    for (int i = 0; i < BENCH_OVERHEAD_LOOP; i++) {
+        node->qbuf(i % BENCH_MAX_BUFFERS);
+        node->dqbuf(&index);
+    }
+    nsecs_t elapsed = systemTime(SYSTEM_TIME_MONOTONIC) - start;
+
+    node->stop();
+    delete node;
+
+    return (double)elapsed / (BENCH_OVERHEAD_LOOP * 2);
+}
+
+/* returns the number of drops the simulator counts differently, or which should not happen */
+static int runPipe(int numBuffer, int frames, int fps, int sensorLatencyUs, int m2mLatencyUs)
+{
+    struct benchPipe pipe;
+    int mismatch = 0;
+
+    pipe.sensor = new ExynosCameraNodeSimulator(BENCH_CAMERA_ID, "SENSOR", BENCH_SENSOR_NODE_NUM);
+    pipe.m2m = new ExynosCameraNodeSimulator(BENCH_CAMERA_ID, "M2M", BENCH_M2M_NODE_NUM);
+    pipe.frames = frames;
+    pipe.interval = 1000000000LL / fps;
+    pipe.sensorLatency = (nsecs_t)sensorLatencyUs * 1000LL;
+    pipe.lastSlot = -1;
+    pipe.numSensorQbuf = numBuffer;
+    pipe.doneTime.reserve(frames);
+
+    pipe.sensor->setFrameInterval(1, fps);
+    pipe.sensor->setLatency(sensorLatencyUs, 0);
+    pipe.m2m->setLatency(m2mLatencyUs, 0);
+
+    for (int i = 0; i < numBuffer; i++)
+        pipe.sensor->qbuf(i);
+
+    pipe.startTime = systemTime(SYSTEM_TIME_MONOTONIC);
+    pipe.m2m->start();
+    pipe.sensor->start();
+
+    pthread_create(&pipe.sensorThread, NULL, sensorThread, &pipe);
+    pthread_create(&pipe.m2mThread, NULL, m2mThread, &pipe);
+    pthread_join(pipe.m2mThread, NULL);
+    pthread_join(pipe.sensorThread, NULL);
+
+    pipe.sensor->stop();
+    pipe.m2m->stop();
+
+    int64_t dropped = pipe.lastSlot + 1 - frames;
+    int64_t simDropped = (int64_t)pipe.sensor->getNumDropped();
+    /* the frames in flight, one more buffer covers the thread hand-over */
+    int inFlight = (sensorLatencyUs + m2mLatencyUs) / (1000000 / fps) + 1;
+    /* a M2M node slower than the sensor drops frames with any number of buffers */
+    bool keepUp = ((int64_t)m2mLatencyUs * fps <= 1000000);
+
+    std::vector<nsecs_t> interval;
+    for (size_t i = 1; i < pipe.doneTime.size(); i++)
+        interval.push_back(pipe.doneTime[i] - pipe.doneTime[i - 1]);
+    std::sort(interval.begin(), interval.end());
+
+    nsecs_t elapsed = pipe.doneTime.back() - pipe.doneTime.front();
+    printf("%7d | %6.2f | %9jd us | %9jd us | %7jd | %9jd\n", numBuffer,
+            (double)(pipe.doneTime.size() - 1) * 1000000000LL / elapsed,
+            (intmax_t)(interval[interval.size() / 2] / 1000),
+            (intmax_t)(interval[interval.size() * 99 / 100] / 1000),
+            (intmax_t)dropped, (intmax_t)simDropped);
+
+    if (dropped != simDropped)
+        mismatch++;
+    if (keepUp == true && numBuffer > inFlight && dropped != 0)
+        mismatch++;
+
+    delete pipe.sensor;
+    delete pipe.m2m;
+
+    return mismatch;
+}
+
+int main(int argc, char **argv)
+{
+    int frames = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_FRAMES;
+    int fps = (argc > 2) ? atoi(argv[2]) : BENCH_DEFAULT_FPS;
+    int sensorLatencyUs = (argc > 3) ? atoi(argv[3]) : BENCH_DEFAULT_SENSOR_US;
+    int m2mLatencyUs = (argc > 4) ? atoi(argv[4]) : BENCH_DEFAULT_M2M_US;
+    int mismatch = 0;
+
+    if (frames < BENCH_MAX_BUFFERS || fps <= 0 || sensorLatencyUs < 0 || m2mLatencyUs < 0) {
+        printf("usage: %s [frames(%d~)] [fps] [sensor latency us] [M2M latency us]\n", argv[0], BENCH_MAX_BUFFERS);
+        return -1;
+    }
+
+    printf("overhead : %.1f ns per qbuf or dqbuf\n", measureOverhead());
+
+    printf("%d frames, %d fps, sensor latency %d us, M2M latency %d us\n",
+            frames, fps, sensorLatencyUs, m2mLatencyUs);
+    printf("buffers |    fps | p50 interval | p99 interval | dropped | simulator\n");
+    for (int numBuffer = 1; numBuffer <= BENCH_MAX_BUFFERS; numBuffer++)
+        mismatch += runPipe(numBuffer, frames, fps, sensorLatencyUs, m2mLatencyUs);
+
+    printf("drops : %s (%d pipes)\n", mismatch ? "MISMATCH" : "match", mismatch);
+
+    return mismatch ? -1 : 0;
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Allocation rate of the objects of a request, from the heap and from ExynosCameraObjectSlab.
+ * Every frame constructs a frame object and one entity per pipe, and destructs them again,
+ * on each of the request threads at once. The objects are as big as ExynosCameraFrame and
+ * ExynosCameraFrameEntity, and the slabs are sized like theirs.
+ *
+ * heap : the global operator new/delete, as before the slab
+ * slab : a class-level operator new/delete backed by ExynosCameraObjectSlab
+ *
+ * Every object must hold what it was constructed with until it is destructed, otherwise
+ * it is counted as a mismatch.
+ *
+ * usage: ExynosCameraObjectSlabBenchmark [frames] [pipes]
+ */
+
+#define LOG_TAG "ExynosCameraObjectSlabBenchmark"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <atomic>
+
+#include "ExynosCameraObjectSlab.h"
+
+using namespace android;
+
+#define BENCH_DEFAULT_FRAME     200000
+#define BENCH_DEFAULT_PIPE      12
+#define BENCH_MAX_PIPE          64
+/* of the order of sizeof(ExynosCameraFrame) and sizeof(ExynosCameraFrameEntity) */
+#define BENCH_FRAME_SIZE        4096
+#define BENCH_ENTITY_SIZE       2600
+
+static const int benchThreads[] = {1, 2, 4};
+
+template <size_t SIZE>
+class BenchObject {
+public:
+    BenchObject(uint32_t id) : id(id)
+    {
+        memset(data, id & 0xFF, 64);
+    }
+
+    bool isIntact(uint32_t expected)
+    {
+        return (id == expected && data[0] == (expected & 0xFF) && data[63] == (expected & 0xFF));
+    }
+
+    uint8_t data[SIZE];
+    uint32_t id;
+};
+
+/* the same objects with the class-level allocator of ExynosCameraFrame */
+template <size_t SIZE, uint32_t CHUNK_SLOTS, uint32_t MAX_CHUNKS>
+class BenchSlabObject : public BenchObject<SIZE> {
+public:
+    BenchSlabObject(uint32_t id) : BenchObject<SIZE>(id) {}
+
+    static void *operator new(size_t size) { return getSlab()->alloc(size); }
+    static void  operator delete(void *ptr) { getSlab()->release(ptr); }
+
+    static ExynosCameraObjectSlab<BenchSlabObject> *getSlab(void)
+    {
+        static ExynosCameraObjectSlab<BenchSlabObject> *slab =
+            new ExynosCameraObjectSlab<BenchSlabObject>(CHUNK_SLOTS, MAX_CHUNKS);
+
+        return slab;
+    }
+};
+
+typedef BenchObject<BENCH_FRAME_SIZE> HeapFrame;
+typedef BenchObject<BENCH_ENTITY_SIZE> HeapEntity;
+/* the slab sizes of ExynosCameraFrame.cpp */
+typedef BenchSlabObject<BENCH_FRAME_SIZE, 32, 16> SlabFrame;
+typedef BenchSlabObject<BENCH_ENTITY_SIZE, 128, 48> SlabEntity;
+
+enum BENCH_TYPE {
+    BENCH_TYPE_HEAP = 0,
+    BENCH_TYPE_SLAB,
+    BENCH_TYPE_MAX,
+};
+
+struct benchContext {
+    pthread_t           thread;
+    int                 frames;
+    int                 pipes;
+    std::atomic<int>    *mismatch;
+};
+
+static uint64_t getTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+template <typename FRAME, typename ENTITY>
+static void *requestThread(void *data)
+{
+    benchContext *context = (benchContext *)data;
+    ENTITY *entity[BENCH_MAX_PIPE];
+    int mismatch = 0;
+
+    for (int frameCount = 0; frameCount < context->frames; frameCount++) {
+        FRAME *frame = new FRAME(frameCount);
+
+        for (int pipe = 0; pipe < context->pipes; pipe++)
+            entity[pipe] = new ENTITY(pipe);
+
+        for (int pipe = 0; pipe < context->pipes; pipe++) {
+            if (entity[pipe]->isIntact(pipe) == false)
+                mismatch++;
+            delete entity[pipe];
+        }
+
+        if (frame->isIntact(frameCount) == false)
+            mismatch++;
+        delete frame;
+    }
+
+    *context->mismatch += mismatch;
+
+    return NULL;
+}
+
+/* returns the ns per object, an allocation and a release, with the given number of threads */
+static double measure(enum BENCH_TYPE type, int threads, int frames, int pipes,
+                      std::atomic<int> *mismatch)
+{
+    benchContext context[benchThreads[sizeof(benchThreads) / sizeof(benchThreads[0]) - 1]];
+    void *(*func)(void *) = (type == BENCH_TYPE_HEAP) ? requestThread<HeapFrame, HeapEntity>
+                                                      : requestThread<SlabFrame, SlabEntity>;
+
+    uint64_t start = getTimeNs();
+    for (int i = 0; i < threads; i++) {
+        context[i].frames = frames;
+        context[i].pipes = pipes;
+        context[i].mismatch = mismatch;
+        pthread_create(&context[i].thread, NULL, func, &context[i]);
+    }
+    for (int i = 0; i < threads; i++)
+        pthread_join(context[i].thread, NULL);
+    uint64_t elapsed = getTimeNs() - start;
+
+    return (double)elapsed / ((double)threads * frames * (pipes + 1));
+}
+
+int main(int argc, char **argv)
+{
+    int frames = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_FRAME;
+    int pipes = (argc > 2) ? atoi(argv[2]) : BENCH_DEFAULT_PIPE;
+    std::atomic<int> mismatch(0);
+
+    if (frames <= 0 || pipes <= 0 || pipes > BENCH_MAX_PIPE) {
+        printf("usage: %s [frames] [pipes(<= %d)]\n", argv[0], BENCH_MAX_PIPE);
+        return -1;
+    }
+
+    /* the first round of the slab grows its chunks, like the first frames of a session */
+    measure(BENCH_TYPE_SLAB, benchThreads[sizeof(benchThreads) / sizeof(benchThreads[0]) - 1],
+            1, pipes, &mismatch);
+
+    printf("%d frames per thread, each a frame object and %d entities\n", frames, pipes);
+    printf("threads |      heap |      slab\n");
+
+    for (size_t n = 0; n < sizeof(benchThreads) / sizeof(benchThreads[0]); n++) {
+        int threads = benchThreads[n];
+        double ns[BENCH_TYPE_MAX];
+
+        for (int type = 0; type < BENCH_TYPE_MAX; type++)
+            ns[type] = measure((enum BENCH_TYPE)type, threads, frames, pipes, &mismatch);
+
+        printf("%7d | %6.1f ns | %6.1f ns\n", threads, ns[BENCH_TYPE_HEAP], ns[BENCH_TYPE_SLAB]);
+    }
+
+    printf("slab : %u slots of frames, %u of entities, %u and %u in use, %u and %u from the heap\n",
+            SlabFrame::getSlab()->getNumSlots(), SlabEntity::getSlab()->getNumSlots(),
+            SlabFrame::getSlab()->getNumInUse(), SlabEntity::getSlab()->getNumInUse(),
+            SlabFrame::getSlab()->getNumFallback(), SlabEntity::getSlab()->getNumFallback());
+    printf("objects : %s (%d objects)\n", mismatch ? "MISMATCH" : "match", mismatch.load());
+
+    return mismatch ? -1 : 0;
+}
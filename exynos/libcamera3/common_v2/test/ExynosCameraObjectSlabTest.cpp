@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ExynosCameraObjectSlab behind a class-level operator new/delete, the way
+ * ExynosCameraFrame and ExynosCameraFrameEntity use it, with a small slab so that
+ * its limit is reached. A released slot is handed out again, the slab grows one chunk
+ * at a time up to its limit and falls back to the heap past it and for a derived class
+ * which does not fit a slot, and every object is accounted for once it is released,
+ * also when the result threads release the objects of the request thread.
+ */
+
+#define LOG_TAG "ExynosCameraObjectSlabTest"
+
+#include <pthread.h>
+#include <string.h>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ExynosCameraObjectSlab.h"
+
+using namespace android;
+
+#define SLAB_CHUNK_SLOTS        (4)
+#define SLAB_MAX_CHUNKS         (3)
+#define SLAB_SLOTS              (SLAB_CHUNK_SLOTS * SLAB_MAX_CHUNKS)
+
+#define STRESS_THREADS          (8)
+#define STRESS_ROUNDS           (20000)
+/* entities of a frame, held together by one thread */
+#define STRESS_OBJECTS          (6)
+#define STRESS_SLAB_CHUNKS      (STRESS_THREADS * STRESS_OBJECTS / SLAB_CHUNK_SLOTS)
+
+/* as big as an entity, with its pipe id at the end where a crossed slot would show */
+class SlabItem {
+public:
+    SlabItem(uint32_t id) : id(id)
+    {
+        memset(data, id & 0xFF, sizeof(data));
+    }
+
+    bool isIntact(uint32_t expected)
+    {
+        for (size_t i = 0; i < sizeof(data); i++) {
+            if (data[i] != (expected & 0xFF))
+                return false;
+        }
+        return (id == expected);
+    }
+
+    static void *operator new(size_t size) { return getSlab()->alloc(size); }
+    static void  operator delete(void *ptr) { getSlab()->release(ptr); }
+    static ExynosCameraObjectSlab<SlabItem> *getSlab(void);
+
+    uint8_t data[2600];
+    uint32_t id;
+};
+
+/* does not fit a slot of SlabItem */
+class SlabBigItem : public SlabItem {
+public:
+    SlabBigItem(uint32_t id) : SlabItem(id) {}
+
+    uint8_t more[128];
+};
+
+/* the stress test has its own slab, big enough for all of its threads */
+class SlabStressItem : public SlabItem {
+public:
+    SlabStressItem(uint32_t id) : SlabItem(id) {}
+
+    static void *operator new(size_t size) { return getStressSlab()->alloc(size); }
+    static void  operator delete(void *ptr) { getStressSlab()->release(ptr); }
+    static ExynosCameraObjectSlab<SlabStressItem> *getStressSlab(void);
+};
+
+ExynosCameraObjectSlab<SlabItem> *SlabItem::getSlab(void)
+{
+    static ExynosCameraObjectSlab<SlabItem> *slab =
+        new ExynosCameraObjectSlab<SlabItem>(SLAB_CHUNK_SLOTS, SLAB_MAX_CHUNKS);
+
+    return slab;
+}
+
+ExynosCameraObjectSlab<SlabStressItem> *SlabStressItem::getStressSlab(void)
+{
+    static ExynosCameraObjectSlab<SlabStressItem> *slab =
+        new ExynosCameraObjectSlab<SlabStressItem>(SLAB_CHUNK_SLOTS, STRESS_SLAB_CHUNKS);
+
+    return slab;
+}
+
+/* the tests share the slab of SlabItem, each one leaves it empty */
+static void expectEmpty(void)
+{
+    EXPECT_EQ(0u, SlabItem::getSlab()->getNumInUse());
+    EXPECT_EQ(0u, SlabItem::getSlab()->getNumFallback());
+}
+
+TEST(ExynosCameraObjectSlabTest, ReleasedSlotIsReused)
+{
+    SlabItem *item = new SlabItem(1);
+    void *slot = item;
+
+    EXPECT_EQ(1u, SlabItem::getSlab()->getNumInUse());
+    EXPECT_LE((uint32_t)SLAB_CHUNK_SLOTS, SlabItem::getSlab()->getNumSlots());
+    delete item;
+
+    /* the last slot released is the first one handed out, and is constructed again */
+    item = new SlabItem(2);
+    EXPECT_EQ(slot, (void *)item);
+    EXPECT_TRUE(item->isIntact(2));
+    delete item;
+
+    expectEmpty();
+}
+
+TEST(ExynosCameraObjectSlabTest, GrowsToLimitThenFallsBack)
+{
+    std::vector<SlabItem *> items;
+
+    for (uint32_t i = 0; i < SLAB_SLOTS + 5; i++) {
+        items.push_back(new SlabItem(i));
+        /* one chunk more only when the ones before are in use */
+        EXPECT_EQ(std::min(i / SLAB_CHUNK_SLOTS + 1, (uint32_t)SLAB_MAX_CHUNKS) * SLAB_CHUNK_SLOTS,
+                  SlabItem::getSlab()->getNumSlots());
+    }
+
+    EXPECT_EQ((uint32_t)SLAB_SLOTS, SlabItem::getSlab()->getNumSlots());
+    EXPECT_EQ(5u, SlabItem::getSlab()->getNumFallback());
+    EXPECT_EQ((uint32_t)SLAB_SLOTS + 5, SlabItem::getSlab()->getNumInUse());
+
+    for (uint32_t i = 0; i < items.size(); i++) {
+        EXPECT_TRUE(items[i]->isIntact(i));
+        delete items[i];
+    }
+    items.clear();
+
+    /* the chunks are kept, and filled again before anything falls back */
+    EXPECT_EQ((uint32_t)SLAB_SLOTS, SlabItem::getSlab()->getNumSlots());
+    expectEmpty();
+
+    for (uint32_t i = 0; i < SLAB_SLOTS; i++)
+        items.push_back(new SlabItem(i));
+    EXPECT_EQ(0u, SlabItem::getSlab()->getNumFallback());
+    for (uint32_t i = 0; i < items.size(); i++)
+        delete items[i];
+
+    expectEmpty();
+}
+
+TEST(ExynosCameraObjectSlabTest, DerivedClassFallsBack)
+{
+    SlabItem *item = new SlabBigItem(3);
+
+    EXPECT_EQ(1u, SlabItem::getSlab()->getNumFallback());
+    EXPECT_EQ(1u, SlabItem::getSlab()->getNumInUse());
+    EXPECT_TRUE(item->isIntact(3));
+    delete (SlabBigItem *)item;
+
+    expectEmpty();
+}
+
+struct stressContext {
+    pthread_t   thread;
+    uint32_t    id;
+    uint32_t    numOfCrossed;
+};
+
+/* a frame worth of entities, taken and released in a different order */
+static void *stressThread(void *data)
+{
+    stressContext *context = (stressContext *)data;
+    SlabStressItem *items[STRESS_OBJECTS];
+
+    for (uint32_t round = 0; round < STRESS_ROUNDS; round++) {
+        for (uint32_t i = 0; i < STRESS_OBJECTS; i++)
+            items[i] = new SlabStressItem(context->id * STRESS_OBJECTS + i);
+
+        for (uint32_t i = 0; i < STRESS_OBJECTS; i++) {
+            uint32_t n = (round + i) % STRESS_OBJECTS;
+
+            if (items[n]->isIntact(context->id * STRESS_OBJECTS + n) == false)
+                context->numOfCrossed++;
+            delete items[n];
+        }
+    }
+
+    return NULL;
+}
+
+TEST(ExynosCameraObjectSlabTest, ChurnDoesNotLeak)
+{
+    ExynosCameraObjectSlab<SlabStressItem> *slab = SlabStressItem::getStressSlab();
+    stressContext context[STRESS_THREADS];
+
+    for (uint32_t i = 0; i < STRESS_THREADS; i++) {
+        context[i].id = i;
+        context[i].numOfCrossed = 0;
+        pthread_create(&context[i].thread, NULL, stressThread, &context[i]);
+    }
+
+    for (uint32_t i = 0; i < STRESS_THREADS; i++) {
+        pthread_join(context[i].thread, NULL);
+        EXPECT_EQ(0u, context[i].numOfCrossed);
+    }
+
+    EXPECT_EQ(0u, slab->getNumInUse());
+    EXPECT_EQ(0u, slab->getNumFallback());
+    /* no more chunks than the objects alive at once need */
+    EXPECT_GE((uint32_t)STRESS_SLAB_CHUNKS * SLAB_CHUNK_SLOTS, slab->getNumSlots());
+}
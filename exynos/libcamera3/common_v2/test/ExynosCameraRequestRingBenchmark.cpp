@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Cost of a request in the running list of ExynosCameraRequestManager, with a given number
+ * of requests in flight. Each request is registered, the pipeline depth of the requests in
+ * flight is increased, as registerToRunningList() does, and the oldest one is looked up and
+ * taken out, as the result path does.
+ *
+ * map      : std::map under one lock, the depth increased by walking the map
+ * snapshot : ExynosCameraRequestRing, the depth increased through a getAll() copy
+ * ring     : ExynosCameraRequestRing, the depth increased in place by forEach()
+ *
+ * Every request must leave with the depth of the requests registered while it was in flight,
+ * otherwise it is counted as a mismatch.
+ *
+ * usage: ExynosCameraRequestRingBenchmark [requests]
+ */
+
+#define LOG_TAG "ExynosCameraRequestRingBenchmark"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ExynosCameraRequestManager.h"
+
+using namespace android;
+
+#define BENCH_DEFAULT_REQUEST   1000000
+
+static const int benchInFlight[] = {4, 8, 16, 32};
+
+class BenchRequest : public LightRefBase<BenchRequest> {
+public:
+    BenchRequest() : depth(0) {}
+
+    void increasePipelineDepth(void) { depth++; }
+
+    uint32_t depth;
+};
+
+typedef sp<BenchRequest> BenchRequestSP_t;
+typedef map<uint32_t, BenchRequestSP_t> bench_map_t;
+typedef ExynosCameraRequestRing<BenchRequestSP_t> bench_ring_t;
+
+enum BENCH_TYPE {
+    BENCH_TYPE_MAP = 0,
+    BENCH_TYPE_SNAPSHOT,
+    BENCH_TYPE_RING,
+    BENCH_TYPE_MAX,
+};
+
+static uint64_t getTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void increasePipelineDepth(BenchRequestSP_t &request)
+{
+    request->increasePipelineDepth();
+}
+
+/* the running list before the ring */
+static void registerToMap(bench_map_t *list, Mutex *lock, uint32_t key)
+{
+    Mutex::Autolock l(*lock);
+
+    list->insert(pair<uint32_t, BenchRequestSP_t>(key, new BenchRequest()));
+    for (bench_map_t::iterator iter = list->begin(); iter != list->end(); iter++)
+        iter->second->increasePipelineDepth();
+}
+
+static BenchRequestSP_t removeFromMap(bench_map_t *list, Mutex *lock, uint32_t key)
+{
+    Mutex::Autolock l(*lock);
+    BenchRequestSP_t request = NULL;
+    bench_map_t::iterator iter = list->find(key);
+
+    if (iter != list->end()) {
+        request = iter->second;
+        list->erase(iter);
+    }
+
+    return request;
+}
+
+static void registerToRing(bench_ring_t *ring, uint32_t key, bool snapshot)
+{
+    ring->push(key, new BenchRequest());
+
+    if (snapshot == true) {
+        bench_map_t requestMap;
+
+        ring->getAll(&requestMap);
+        for (bench_map_t::iterator iter = requestMap.begin(); iter != requestMap.end(); iter++)
+            iter->second->increasePipelineDepth();
+    } else {
+        ring->forEach(increasePipelineDepth);
+    }
+}
+
+static BenchRequestSP_t removeFromRing(bench_ring_t *ring, uint32_t key)
+{
+    BenchRequestSP_t request = NULL;
+
+    /* the result path looks the request up before it is done */
+    if (ring->get(key, &request) == NO_ERROR)
+        ring->pop(key, &request);
+
+    return request;
+}
+
+/* returns the ns per request, and counts the requests which left with a wrong depth */
+static double measure(enum BENCH_TYPE type, int inFlight, int request, int *mismatch)
+{
+    bench_map_t list;
+    Mutex lock;
+    bench_ring_t ring;
+    BenchRequestSP_t done;
+
+    uint64_t start = getTimeNs();
+    for (uint32_t key = 0; key < (uint32_t)(request + inFlight); key++) {
+        if (type == BENCH_TYPE_MAP)
+            registerToMap(&list, &lock, key);
+        else
+            registerToRing(&ring, key, (type == BENCH_TYPE_SNAPSHOT));
+
+        if (key < (uint32_t)inFlight)
+            continue;
+
+        if (type == BENCH_TYPE_MAP)
+            done = removeFromMap(&list, &lock, key - inFlight);
+        else
+            done = removeFromRing(&ring, key - inFlight);
+
+        /* itself and the ones after it */
+        if (done == NULL || done->depth != (uint32_t)inFlight + 1)
+            (*mismatch)++;
+    }
+    uint64_t elapsed = getTimeNs() - start;
+
+    return (double)elapsed / (request + inFlight);
+}
+
+int main(int argc, char **argv)
+{
+    int request = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_REQUEST;
+    int mismatch = 0;
+
+    if (request <= 0) {
+        printf("usage: %s [requests]\n", argv[0]);
+        return -1;
+    }
+
+    printf("%d requests, ring of %d slots\n", request, REQUEST_RING_SIZE);
+    printf("in flight |       map |  snapshot |      ring\n");
+
+    for (size_t n = 0; n < sizeof(benchInFlight) / sizeof(benchInFlight[0]); n++) {
+        int inFlight = benchInFlight[n];
+        double ns[BENCH_TYPE_MAX];
+
+        for (int type = 0; type < BENCH_TYPE_MAX; type++)
+            ns[type] = measure((enum BENCH_TYPE)type, inFlight, request, &mismatch);
+
+        printf("%9d | %6.1f ns | %6.1f ns | %6.1f ns\n", inFlight,
+                ns[BENCH_TYPE_MAP], ns[BENCH_TYPE_SNAPSHOT], ns[BENCH_TYPE_RING]);
+    }
+
+    printf("pipeline depth : %s (%d requests)\n", mismatch ? "MISMATCH" : "match", mismatch);
+
+    return mismatch ? -1 : 0;
+}
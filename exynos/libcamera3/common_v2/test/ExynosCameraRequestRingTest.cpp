@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * ExynosCameraRequestRing under the traffic of ExynosCameraRequestManager.
+ * One thread registers the requests and increases the pipeline depth of the ones in flight,
+ * as registerToRunningList() does, while the result threads take them out of the ring.
+ * Every STRESS_HOLD_INTERVAL th request is held for long by another thread, like a
+ * reprocessing capture, so its slot is reused by a later key, which goes to the overflow map.
+ */
+
+#define LOG_TAG "ExynosCameraRequestRingTest"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ExynosCameraRequestManager.h"
+
+using namespace android;
+
+#define STRESS_REQUEST_NUM      (200000)
+#define STRESS_RESULT_THREADS   (4)
+#define STRESS_IN_FLIGHT        (8)
+#define STRESS_HOLD_INTERVAL    (50)
+/* a held request leaves after this many requests are registered after it */
+#define STRESS_HOLD_REQUESTS    (REQUEST_RING_SIZE * 3)
+/* the held requests in flight at most, and one more */
+#define STRESS_MAX_HELD         (STRESS_HOLD_REQUESTS / STRESS_HOLD_INTERVAL + 1)
+
+class RingItem : public LightRefBase<RingItem> {
+public:
+    RingItem(uint32_t key) : key(key), depth(0) {}
+
+    uint32_t key;
+    std::atomic<uint32_t> depth;
+};
+
+typedef sp<RingItem> RingItemSP_t;
+typedef ExynosCameraRequestRing<RingItemSP_t> ring_t;
+
+struct stressContext {
+    ring_t                  ring;
+    std::atomic<uint32_t>   numOfRegistered;
+    std::atomic<uint32_t>   numOfDone;
+    std::atomic<uint32_t>   numOfMissed;
+    std::atomic<uint32_t>   numOfBadDepth;
+    uint32_t                numOfBadPush;
+};
+
+struct stressResult {
+    stressContext   *context;
+    pthread_t       thread;
+    uint32_t        id;
+};
+
+static void increaseDepth(RingItemSP_t &item)
+{
+    item->depth++;
+}
+
+static bool isHeld(uint32_t key)
+{
+    return (key % STRESS_HOLD_INTERVAL) == 0;
+}
+
+static void takeResult(stressContext *context, uint32_t key, uint32_t ready)
+{
+    RingItemSP_t item;
+
+    if (ready > STRESS_REQUEST_NUM)
+        ready = STRESS_REQUEST_NUM;
+
+    while (context->numOfRegistered.load() < ready)
+        sched_yield();
+
+    if (context->ring.get(key, &item) != NO_ERROR || item->key != key) {
+        context->numOfMissed++;
+    } else if (context->ring.pop(key, &item) != NO_ERROR || item->key != key) {
+        context->numOfMissed++;
+    } else if (item->depth.load() < ready - key) {
+        /* its depth was increased by itself and by every request registered after it */
+        context->numOfBadDepth++;
+    }
+
+    context->numOfDone++;
+}
+
+/* the results of the preview, taken in the key order of each thread */
+static void *resultThread(void *data)
+{
+    struct stressResult *result = (struct stressResult *)data;
+
+    for (uint32_t key = result->id; key < STRESS_REQUEST_NUM; key += STRESS_RESULT_THREADS) {
+        if (isHeld(key) == false)
+            takeResult(result->context, key, key + 1);
+    }
+
+    return NULL;
+}
+
+/* the long requests, while the ones after them come and go */
+static void *holdThread(void *data)
+{
+    stressContext *context = (stressContext *)data;
+
+    for (uint32_t key = 0; key < STRESS_REQUEST_NUM; key += STRESS_HOLD_INTERVAL)
+        takeResult(context, key, key + STRESS_HOLD_REQUESTS);
+
+    return NULL;
+}
+
+TEST(ExynosCameraRequestRingTest, RegisterAndResultStress)
+{
+    stressContext *context = new stressContext;
+    struct stressResult result[STRESS_RESULT_THREADS];
+    pthread_t holder;
+
+    context->numOfRegistered = 0;
+    context->numOfDone = 0;
+    context->numOfMissed = 0;
+    context->numOfBadDepth = 0;
+    context->numOfBadPush = 0;
+
+    for (uint32_t i = 0; i < STRESS_RESULT_THREADS; i++) {
+        result[i].context = context;
+        result[i].id = i;
+        pthread_create(&result[i].thread, NULL, resultThread, &result[i]);
+    }
+    pthread_create(&holder, NULL, holdThread, context);
+
+    for (uint32_t key = 0; key < STRESS_REQUEST_NUM; key++) {
+        /* the pipeline is full, wait for a result as the service does */
+        while (key - context->numOfDone.load() >= STRESS_IN_FLIGHT + STRESS_MAX_HELD)
+            sched_yield();
+
+        if (context->ring.push(key, new RingItem(key)) != NO_ERROR)
+            context->numOfBadPush++;
+        /* a key in the ring can not be pushed again */
+        if (context->ring.push(key, new RingItem(key)) == NO_ERROR)
+            context->numOfBadPush++;
+
+        context->ring.forEach(increaseDepth);
+        context->numOfRegistered++;
+    }
+
+    for (uint32_t i = 0; i < STRESS_RESULT_THREADS; i++)
+        pthread_join(result[i].thread, NULL);
+    pthread_join(holder, NULL);
+
+    EXPECT_EQ(0u, context->numOfBadPush);
+    EXPECT_EQ(0u, context->numOfMissed.load());
+    EXPECT_EQ(0u, context->numOfBadDepth.load());
+    EXPECT_EQ((uint32_t)STRESS_REQUEST_NUM, context->numOfDone.load());
+    EXPECT_EQ(0u, context->ring.getSize());
+
+    delete context;
+}
+
+/* the flush takes the requests out in the key order, from the slots and the overflow map */
+TEST(ExynosCameraRequestRingTest, FirstInKeyOrder)
+{
+    ring_t ring;
+    RingItemSP_t item;
+    uint32_t numOfVisited = 0;
+    std::vector<uint32_t> keys;
+
+    /* 5 and 5 + REQUEST_RING_SIZE share a slot, the later one overflows */
+    for (uint32_t key = 5; key < 5 + REQUEST_RING_SIZE + 10; key++) {
+        ASSERT_EQ(NO_ERROR, ring.push(key, new RingItem(key)));
+        keys.push_back(key);
+    }
+    ASSERT_EQ(NO_ERROR, ring.push(1000, new RingItem(1000)));
+    keys.push_back(1000);
+    ASSERT_EQ(keys.size(), ring.getSize());
+
+    ring.forEach(increaseDepth);
+    for (uint32_t i = 0; i < keys.size(); i++) {
+        ASSERT_EQ(NO_ERROR, ring.get(keys[i], &item));
+        EXPECT_EQ(1u, item->depth.load());
+        numOfVisited += item->depth.load();
+    }
+    EXPECT_EQ(keys.size(), numOfVisited);
+
+    for (uint32_t i = 0; i < keys.size(); i++) {
+        ASSERT_EQ(NO_ERROR, ring.getFirst(&item));
+        ASSERT_EQ(keys[i], item->key);
+        ASSERT_EQ(NO_ERROR, ring.pop(keys[i], &item));
+    }
+
+    EXPECT_NE(NO_ERROR, ring.getFirst(&item));
+    EXPECT_EQ(0u, ring.getSize());
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2017, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Cost of ExynosCameraTimeLogger::update() and check of the loggers read while they are written.
+ *
+ * single thread : ns per update of each type
+ * threads       : ns per update of every writer, while one more thread copies the loggers
+ *                 with getLoggers() in a loop. Each writer logs USER_DATA loggers whose value
+ *                 is a hash of the key, so a torn copy shows up as a logger whose value does
+ *                 not match its key, and a logger copied twice as a duplicated key.
+ *
+ * usage: ExynosCameraTimeLoggerBenchmark [updates] [threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "ExynosCameraTimeLogger.h"
+
+#define BENCH_CAMERA_ID         (0)
+#define BENCH_DEFAULT_UPDATE    1000000
+#define BENCH_DEFAULT_THREADS   4
+#define BENCH_MAX_THREADS       16
+
+struct benchWriter {
+    ExynosCameraTimeLogger  *logger;
+    pthread_t               thread;
+    uint32_t                pipeId;
+    int                     update;
+    uint64_t                elapsedNs;
+};
+
+static std::atomic<int> benchDone;
+
+static uint64_t getTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static uint32_t keyHash(uint64_t key)
+{
+    return (uint32_t)(key * 2654435761U) >> 1;
+}
+
+static void *writerThread(void *data)
+{
+    struct benchWriter *writer = (struct benchWriter *)data;
+    uint64_t start = getTimeNs();
+
+    for (int i = 0; i < writer->update; i++)
+        writer->logger->update(BENCH_CAMERA_ID, i, writer->pipeId, LOGGER_TYPE_USER_DATA,
+                               LOGGER_CATEGORY_POINT0, keyHash(i));
+
+    writer->elapsedNs = getTimeNs() - start;
+    benchDone.fetch_add(1);
+
+    return NULL;
+}
+
+static bool compareKey(const ExynosCameraTimeLogger::timeLogger_t &a, const ExynosCameraTimeLogger::timeLogger_t &b)
+{
+    return (a.pipeId != b.pipeId) ? (a.pipeId < b.pipeId) : (a.key < b.key);
+}
+
+/* returns the number of bad loggers */
+static int checkLoggers(std::vector<ExynosCameraTimeLogger::timeLogger_t> *loggers, int numWriter)
+{
+    int bad = 0;
+
+    for (size_t i = 0; i < loggers->size(); i++) {
+        ExynosCameraTimeLogger::timeLogger_t *logger = &(*loggers)[i];
+
+        if (logger->pipeId >= (uint32_t)numWriter
+            || logger->type != LOGGER_TYPE_USER_DATA
+            || logger->category != LOGGER_CATEGORY_POINT0
+            || logger->calTime != keyHash(logger->key))
+            bad++;
+    }
+
+    std::sort(loggers->begin(), loggers->end(), compareKey);
+    for (size_t i = 1; i < loggers->size(); i++) {
+        if ((*loggers)[i].pipeId == (*loggers)[i - 1].pipeId && (*loggers)[i].key == (*loggers)[i - 1].key)
+            bad++;
+    }
+
+    return bad;
+}
+
+static double measureUpdate(ExynosCameraTimeLogger *logger, LOGGER_TYPE type, int update)
+{
+    uint64_t start = getTimeNs();
+
+    for (int i = 0; i < update; i++) {
+        if (type == LOGGER_TYPE_DURATION) {
+            logger->update(BENCH_CAMERA_ID, i, 0, type, LOGGER_CATEGORY_POINT1, true);
+            logger->update(BENCH_CAMERA_ID, i, 0, type, LOGGER_CATEGORY_POINT1, false);
+        } else {
+            logger->update(BENCH_CAMERA_ID, i, 0, type, LOGGER_CATEGORY_POINT1, i);
+        }
+    }
+
+    return (double)(getTimeNs() - start) / ((type == LOGGER_TYPE_DURATION) ? update * 2 : update);
+}
+
+int main(int argc, char **argv)
+{
+    int update = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_UPDATE;
+    int numWriter = (argc > 2) ? atoi(argv[2]) : BENCH_DEFAULT_THREADS;
+    ExynosCameraTimeLogger *logger = new ExynosCameraTimeLogger();
+    struct benchWriter writer[BENCH_MAX_THREADS];
+    std::vector<ExynosCameraTimeLogger::timeLogger_t> loggers;
+    int numCopy = 0, bad = 0;
+    size_t numCopied = 0;
+
+    if (update <= 0 || numWriter <= 0 || numWriter > BENCH_MAX_THREADS) {
+        printf("usage: %s [updates] [threads(1~%d)]\n", argv[0], BENCH_MAX_THREADS);
+        return -1;
+    }
+
+    logger->init(BENCH_CAMERA_ID);
+
+    printf("%d updates, ring of %d loggers per thread\n", update,
+            property_get_int32(TIME_LOGGER_SIZE_PROPERTY, TIME_LOGGER_SIZE));
+    printf("single thread : INTERVAL %.1f ns, DURATION %.1f ns, USER_DATA %.1f ns\n",
+            measureUpdate(logger, LOGGER_TYPE_INTERVAL, update),
+            measureUpdate(logger, LOGGER_TYPE_DURATION, update / 2),
+            measureUpdate(logger, LOGGER_TYPE_USER_DATA, update));
+
+    /* only the loggers of the writers from here */
+    logger->init(BENCH_CAMERA_ID);
+
+    benchDone = 0;
+    for (int i = 0; i < numWriter; i++) {
+        writer[i].logger = logger;
+        writer[i].pipeId = i;
+        writer[i].update = update;
+        writer[i].elapsedNs = 0;
+        pthread_create(&writer[i].thread, NULL, writerThread, &writer[i]);
+    }
+
+    /* copy while writing, until every writer is done */
+    while (benchDone.load() < numWriter) {
+        logger->getLoggers(BENCH_CAMERA_ID, &loggers);
+        numCopied += loggers.size();
+        bad += checkLoggers(&loggers, numWriter);
+        numCopy++;
+    }
+
+    uint64_t elapsedNs = 0;
+    for (int i = 0; i < numWriter; i++) {
+        pthread_join(writer[i].thread, NULL);
+        elapsedNs += writer[i].elapsedNs;
+    }
+
+    printf("%d threads     : %.1f ns per update, %d copies of %zu loggers on average\n",
+            numWriter, (double)elapsedNs / ((uint64_t)update * numWriter),
+            numCopy, numCopy ? numCopied / numCopy : 0);
+    printf("loggers : %s (%d torn or duplicated)\n", bad ? "MISMATCH" : "match", bad);
+
+    delete logger;
+
+    return bad ? -1 : 0;
+}
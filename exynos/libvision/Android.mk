@@ -24,6 +24,11 @@ LOCAL_SHARED_LIBRARIES += libexynosutils libion
 LOCAL_SHARED_LIBRARIES += libexpat
 
 LOCAL_CFLAGS += -DDISPLAY_PROCESS_GRAPH_TIME=0
+LOCAL_CFLAGS += -DGRAPH_NODE_FUSION=1
+LOCAL_CFLAGS += -DGRAPH_MEMORY_PLANNER=1
+LOCAL_CFLAGS += -DGRAPH_CPU_FALLBACK=1
+LOCAL_CFLAGS += -DGRAPH_WORKER_POOL=1
+LOCAL_CFLAGS += -DGRAPH_NODE_TILING=1
 
 LOCAL_LDLIBS := -llog -ldl
 
@@ -51,7 +56,9 @@ LOCAL_SRC_FILES:= \
 	./system/ExynosVisionBufObject.cpp \
 	./system/ExynosVisionResManager.cpp \
 	./system/ExynosVisionMemoryAllocator.cpp \
+	./system/ExynosVisionMemoryPlanner.cpp \
 	./system/ExynosVisionSubgraph.cpp \
+	./system/ExynosVisionWorkerPool.cpp \
 	./common/ExynosVisionContext.cpp \
 	./common/ExynosVisionGraph.cpp \
 	./common/ExynosVisionTarget.cpp \
@@ -90,4 +97,6 @@ $(warning ##############################################)
 
 include $(LOCAL_ROOT_PATH)/kernel/vpu/Android.mk
 include $(LOCAL_ROOT_PATH)/kernel/score/Android.mk
+include $(LOCAL_ROOT_PATH)/kernel/cpu/Android.mk
+include $(LOCAL_ROOT_PATH)/test/Android.mk
 #include $(LOCAL_ROOT_PATH)/kernel/opencl/Android.mk
@@ -574,6 +574,22 @@ ExynosVisionArray::allocateMemory(vx_enum res_type, struct resource_param *param
     return allocateMemory_T(res_type, param, vx_true_e, &m_res_mngr, &m_res_list, &m_cur_res);
 }
 
+vx_status
+ExynosVisionArray::getMemorySize(Vector<vx_size> *size_vector)
+{
+    size_vector->clear();
+
+    vx_size size = m_item_size * m_capacity;
+    if (size == 0) {
+        VXLOGE("%s, calculating allocation size is zero", getName());
+        return VX_ERROR_INVALID_DIMENSION;
+    }
+
+    size_vector->push_back(size);
+
+    return VX_SUCCESS;
+}
+
 vx_status
 ExynosVisionArray::allocateResource(default_resource_t **ret_resource)
 {
@@ -84,6 +84,7 @@ public:
 
     /* resource management function */
     vx_status allocateMemory(vx_enum res_type, struct resource_param *param);
+    virtual vx_status getMemorySize(Vector<vx_size> *size_vector);
     virtual vx_status allocateResource(default_resource_t **ret_resource);
     virtual vx_status freeResource(default_resource_t *image_vector);
 
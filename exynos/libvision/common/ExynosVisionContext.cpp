@@ -16,6 +16,7 @@
 
 #define LOG_TAG "ExynosVisionContext"
 #include <cutils/log.h>
+#include <cutils/properties.h>
 
 #include "ExynosVisionContext.h"
 
@@ -113,6 +114,7 @@ ExynosVisionContext::ExynosVisionContext(void) : ExynosVisionReference(this, VX_
     m_immediate_target = NULL;
 
     m_performance_monitor = NULL;
+    m_worker_pool = NULL;
 
     EXYNOS_VISION_SYSTEM_OUT();
 }
@@ -161,12 +163,35 @@ ExynosVisionContext::init(void)
     else
         VXLOGD("loading kernels: exynosscorekernel");
 
+    /* Load cpu kernels, used for the nodes placed on or falling back to the cpu target */
+    VXLOGD("loading exynoscpukernel");
+    load_status = loadKernels("exynoscpukernel");
+    if (load_status != VX_SUCCESS)
+        VXLOGE("ERR(%d):loading kernel of exynoscpukernel fail", load_status);
+    else
+        VXLOGD("loading kernels: exynoscpukernel");
+
     m_performance_monitor = new ExynosVisionPerfMonitor<ExynosVisionGraph*>;
     if (m_performance_monitor == NULL) {
         VXLOGE("performance monitor can't create");
         return VX_FAILURE;
     }
 
+#if (GRAPH_WORKER_POOL==1)
+    /* the pool could be turned off to compare with the thread per subgraph */
+    if (property_get_bool(WORKER_POOL_PROPERTY, true) == false) {
+        VXLOGD("worker pool is disabled by %s, subgraphs run on own threads", WORKER_POOL_PROPERTY);
+    } else {
+        m_worker_pool = new ExynosVisionWorkerPool();
+        if (m_worker_pool->init(0) != VX_SUCCESS) {
+            VXLOGE("worker pool can't initialize, subgraphs run on own threads");
+            m_worker_pool->destroy();
+            delete m_worker_pool;
+            m_worker_pool = NULL;
+        }
+    }
+#endif
+
     EXYNOS_VISION_SYSTEM_OUT();
 
     return VX_SUCCESS;
@@ -247,6 +272,13 @@ ExynosVisionContext::destroy(void)
     }
     m_internal_lock.unlock();
 
+    /* every graph is released above, no subgraph uses the pool any more */
+    if (m_worker_pool) {
+        m_worker_pool->destroy();
+        delete m_worker_pool;
+        m_worker_pool = NULL;
+    }
+
     if (m_performance_monitor)
         delete m_performance_monitor;
 
@@ -29,11 +29,15 @@
 
 #include "ExynosVisionMemoryAllocator.h"
 #include "ExynosVisionPerfMonitor.h"
+#include "ExynosVisionWorkerPool.h"
 
 namespace android {
 
 using namespace std;
 
+/* "false" runs every subgraph on its own thread instead of the shared worker pool */
+#define WORKER_POOL_PROPERTY "vendor.vision.worker_pool"
+
 struct user_struct {
     /*! \brief Type constant */
     vx_enum type;
@@ -73,6 +77,9 @@ private:
 
     ExynosVisionPerfMonitor<ExynosVisionGraph*> *m_performance_monitor;
 
+    /* threads running the subgraphs of all graphs in normal mode */
+    ExynosVisionWorkerPool *m_worker_pool;
+
     ExynosVisionTarget* m_immediate_target;
 public:
 
@@ -132,6 +139,10 @@ public:
     {
         return m_performance_monitor;
     }
+    ExynosVisionWorkerPool* getWorkerPool()
+    {
+        return m_worker_pool;
+    }
 
     virtual void displayInfo(vx_uint32 tab_num, vx_bool detail_info);
 };
@@ -41,6 +41,7 @@ ExynosVisionGraph::ExynosVisionGraph(ExynosVisionContext *context)
     m_exec_mode = GRAPH_EXEC_NORMAL;
 
     m_performance_monitor = NULL;
+    m_memory_planner = NULL;
     m_is_replaced_flag = vx_false_e;
 
     m_error_queue = NULL;
@@ -63,6 +64,8 @@ ExynosVisionGraph::init(void)
     if (m_performance_monitor == NULL)
         VXLOGE("performance monitor can't create");
 
+    m_memory_planner = new ExynosVisionMemoryPlanner(this);
+
     m_error_queue = new ExynosVisionQueue<graph_error_message_t>(0);
     m_error_thread = new ExynosVisionThread<ExynosVisionGraph>(this, &ExynosVisionGraph::errorThreadFunc, "graph_err", PRIORITY_DEFAULT);
     if (m_error_thread.get() != NULL) {
@@ -165,6 +168,14 @@ ExynosVisionGraph::destroy(void)
         m_performance_monitor = NULL;
     }
 
+    if (m_memory_planner) {
+        status = m_memory_planner->destroy();
+        if (status != VX_SUCCESS)
+            VXLOGE("destroying memory planner fails, err:%d", status);
+        delete m_memory_planner;
+        m_memory_planner = NULL;
+    }
+
     if (m_schedule_complete_event) {
         delete m_schedule_complete_event;
         m_schedule_complete_event = NULL;
@@ -272,6 +283,13 @@ ExynosVisionGraph::removeNode(ExynosVisionNode *node)
         }
 
         if (sg_iter != m_sg_list.end()) {
+            /* fused nodes lose their subgraph together */
+            List<ExynosVisionNode*>::iterator fused_iter;
+            for (fused_iter=m_node_list.begin(); fused_iter!=m_node_list.end(); fused_iter++) {
+                if (((*fused_iter) != node) && ((*fused_iter)->getSubgraph() == *sg_iter))
+                    (*fused_iter)->setSubgraph(NULL);
+            }
+
             status = (*sg_iter)->destroy();
             if (status != VX_SUCCESS)
                 VXLOGE("destorying %s fails, err:%d", (*sg_iter)->getSgName(), status);
@@ -523,6 +541,18 @@ ExynosVisionGraph::verifyGraph(void)
         goto Exit;
     }
 
+#if (GRAPH_MEMORY_PLANNER==1)
+    /* slots of stream mode are used by several frames at once, so only normal mode shares memory */
+    if (getExecMode() == GRAPH_EXEC_NORMAL) {
+        VXLOGD3("planning memory phase\n");
+        status = m_memory_planner->planMemory(&m_sorted_node_list);
+        if (status != VX_SUCCESS) {
+            VXLOGE("planning memory fails in verify(%d)", status);
+            goto Exit;
+        }
+    }
+#endif
+
     VXLOGD3("fixing subgraph phase\n");
     status = fixAllSubgraph();
     if (status != VX_SUCCESS) {
@@ -735,6 +765,17 @@ ExynosVisionGraph::initializeKernel(void)
     for (List<ExynosVisionNode*>::iterator node_iter=m_sorted_node_list.begin(); node_iter!=m_sorted_node_list.end(); node_iter++) {
         ExynosVisionNode *node = (*node_iter);
         status = node->initilalizeKernel();
+#if (GRAPH_CPU_FALLBACK==1)
+        if (status != VX_SUCCESS) {
+            /* the accelerator could not take the node, run it by the cpu kernel of the same function if exists */
+            VXLOGW("node(%d,%s) is not initialized(%d), falling back to cpu", node->getId(), node->getKernelName(), status);
+            status = node->setNodeTarget(VX_TARGET_CPU);
+            if (status == VX_SUCCESS)
+                status = node->verifyNode();
+            if (status == VX_SUCCESS)
+                status = node->initilalizeKernel();
+        }
+#endif
         if (status != VX_SUCCESS) {
             VXLOGE("node(%d,%s) is not initialized", node->getId(), node->getKernelName());
             break;
@@ -754,6 +795,22 @@ ExynosVisionGraph::groupingSubgraph(void)
 
     for (List<ExynosVisionNode*>::iterator node_iter = m_sorted_node_list.begin(); node_iter != m_sorted_node_list.end(); node_iter++ ) {
         ExynosVisionNode *cur_node = *node_iter;
+
+#if (GRAPH_NODE_FUSION==1)
+        ExynosVisionSubgraph *fused_subgraph = findFusableSubgraph(cur_node);
+        if (fused_subgraph != NULL) {
+            status = fused_subgraph->addNode(cur_node);
+            cur_node->setSubgraph(fused_subgraph);
+
+            if (status != VX_SUCCESS) {
+                VXLOGE("node can't be fused, err:%d", status);
+                break;
+            }
+
+            continue;
+        }
+#endif
+
         ExynosVisionSubgraph *cur_subgraph = new ExynosVisionSubgraph(this);
 
         status = cur_subgraph->init(cur_node);
@@ -772,6 +829,125 @@ ExynosVisionGraph::groupingSubgraph(void)
     return status;
 }
 
+#if (GRAPH_NODE_FUSION==1)
+vx_bool
+ExynosVisionGraph::isFusableKernel(ExynosVisionNode *node)
+{
+    /* kernels that read and write whole images once, without internal state between frames */
+    switch (node->getKernelHandle()->getEnumeration()) {
+    case VX_KERNEL_COLOR_CONVERT:
+    case VX_KERNEL_CHANNEL_EXTRACT:
+    case VX_KERNEL_CHANNEL_COMBINE:
+    case VX_KERNEL_SOBEL_3x3:
+    case VX_KERNEL_MAGNITUDE:
+    case VX_KERNEL_PHASE:
+    case VX_KERNEL_TABLE_LOOKUP:
+    case VX_KERNEL_ABSDIFF:
+    case VX_KERNEL_THRESHOLD:
+    case VX_KERNEL_DILATE_3x3:
+    case VX_KERNEL_ERODE_3x3:
+    case VX_KERNEL_MEDIAN_3x3:
+    case VX_KERNEL_BOX_3x3:
+    case VX_KERNEL_GAUSSIAN_3x3:
+    case VX_KERNEL_CONVERTDEPTH:
+    case VX_KERNEL_AND:
+    case VX_KERNEL_OR:
+    case VX_KERNEL_XOR:
+    case VX_KERNEL_NOT:
+    case VX_KERNEL_MULTIPLY:
+    case VX_KERNEL_ADD:
+    case VX_KERNEL_SUBTRACT:
+        return vx_true_e;
+    default:
+        return vx_false_e;
+    }
+}
+
+vx_bool
+ExynosVisionGraph::isGraphParameter(ExynosVisionNode *node, vx_uint32 index)
+{
+    Vector<graph_param_info>::iterator graph_param_iter;
+    for (graph_param_iter=m_param_vector.begin(); graph_param_iter!=m_param_vector.end(); graph_param_iter++) {
+        if ((graph_param_iter->node == node) && (graph_param_iter->index == index))
+            return vx_true_e;
+    }
+
+    return vx_false_e;
+}
+
+ExynosVisionSubgraph*
+ExynosVisionGraph::findFusableSubgraph(ExynosVisionNode *node)
+{
+    ExynosVisionNode *pre_node = NULL;
+    ExynosVisionSubgraph *subgraph;
+
+    if (isFusableKernel(node) == vx_false_e)
+        return NULL;
+
+    /* every written input should come from a single previous node */
+    for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+        if (node->getKernelHandle()->getParamDirection(p) != VX_INPUT)
+            continue;
+
+        ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+        if ((data_ref == NULL) || (data_ref->getIndirectInputNodeNum(this) == 0))
+            continue;
+
+        if ((data_ref->getDirectInputNodeNum(this) != 1) || (data_ref->getIndirectInputNodeNum(this) != 1))
+            return NULL;
+
+        ExynosVisionNode *writer = data_ref->getDirectInputNode(this, 0);
+        if ((pre_node != NULL) && (pre_node != writer))
+            return NULL;
+        pre_node = writer;
+    }
+
+    if ((pre_node == NULL) || (isFusableKernel(pre_node) == vx_false_e))
+        return NULL;
+
+    subgraph = pre_node->getSubgraph();
+    if ((subgraph == NULL) || (subgraph->getTailNode() != pre_node) || (subgraph->getNodeNum() >= GRAPH_FUSION_MAX_NODE_NUM))
+        return NULL;
+
+    /* kernels of the same target, the name is same until function name */
+    const ExynosVisionKernel *kernel = node->getKernelHandle();
+    const ExynosVisionKernel *pre_kernel = pre_node->getKernelHandle();
+    vx_uint32 target_name_len = kernel->getKernelFuncName() - kernel->getKernelName();
+    if ((target_name_len != (vx_uint32)(pre_kernel->getKernelFuncName() - pre_kernel->getKernelName())) ||
+        (strncmp(kernel->getKernelName(), pre_kernel->getKernelName(), target_name_len) != 0))
+        return NULL;
+
+    /* every output of previous node should be handed over only to the node */
+    for (vx_uint32 p = 0; p < pre_node->getDataRefNum(); p++) {
+        if (pre_node->getKernelHandle()->getParamDirection(p) != VX_OUTPUT)
+            continue;
+
+        ExynosVisionDataReference *data_ref = pre_node->getDataRefByIndex(p);
+        if (data_ref == NULL)
+            continue;
+
+        if ((data_ref->isDelayElement() == vx_true_e) || (data_ref->isQueue() == vx_true_e) ||
+            (data_ref->getDirectOutputNodeNum(this) != data_ref->getIndirectOutputNodeNum(this)) ||
+            (data_ref->getDirectOutputNodeNum(this) == 0) || isGraphParameter(pre_node, p))
+            return NULL;
+
+        for (vx_uint32 i = 0; i < data_ref->getDirectOutputNodeNum(this); i++) {
+            if (data_ref->getDirectOutputNode(this, i) != node)
+                return NULL;
+        }
+    }
+
+    for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+        if ((node->getKernelHandle()->getParamDirection(p) == VX_INPUT) && isGraphParameter(node, p))
+            return NULL;
+    }
+
+    VXLOGD2("%s is fused to %s", node->getName(), subgraph->getSgName());
+
+    return subgraph;
+}
+#endif
+
 vx_status
 ExynosVisionGraph::fixAllSubgraph(void)
 {
@@ -1164,6 +1340,9 @@ ExynosVisionGraph::displayInfo(vx_uint32 tab_num, vx_bool detail_info)
     if (m_parent_node)
         VXLOGI("%s          Parent node:%s(%s)", MAKE_TAB(tap, tab_num), m_parent_node->getName(), m_parent_node->getKernelName());
 
+    if (m_memory_planner)
+        m_memory_planner->displayInfo(tab_num+1, detail_info);
+
     VXLOGI("%s[-------] all subgraph: %d", MAKE_TAB(tap, tab_num), m_sg_list.size());
     if (m_sg_list.size() != 0) {
         List<ExynosVisionSubgraph*>::iterator sg_iter;
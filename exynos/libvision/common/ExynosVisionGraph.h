@@ -25,6 +25,7 @@
 #include "ExynosVisionThread.h"
 
 #include "ExynosVisionPerfMonitor.h"
+#include "ExynosVisionMemoryPlanner.h"
 
 #include "ExynosVisionReference.h"
 #include "ExynosVisionContext.h"
@@ -60,6 +61,9 @@ struct graph_param_info {
 
 #define COMPLETE_WAIT_TIME ((vx_uint64)5 * 1000 * 1000 * 1000)     // 5 sec
 
+/* fusable kernels have 4 inputs at most, so the input port of fused subgraph fits in 32bit done bitmask */
+#define GRAPH_FUSION_MAX_NODE_NUM 8
+
 class ExynosVisionGraph : public ExynosVisionReference {
 
 private:
@@ -107,6 +111,9 @@ private:
 
     ExynosVisionPerfMonitor<ExynosVisionNode*> *m_performance_monitor;
 
+    /* shares memory between virtual objects of normal mode graph */
+    ExynosVisionMemoryPlanner *m_memory_planner;
+
     /* This indicates that whether child graph is merged or not */
     vx_bool m_is_replaced_flag;
 
@@ -128,6 +135,12 @@ private:
     vx_status checkDataReference(void);
     vx_status initializeKernel(void);
     vx_status groupingSubgraph(void);
+#if (GRAPH_NODE_FUSION==1)
+    /* find the subgraph that the node can be fused to, return null if the node needs own subgraph */
+    ExynosVisionSubgraph* findFusableSubgraph(ExynosVisionNode *node);
+    vx_bool isFusableKernel(ExynosVisionNode *node);
+    vx_bool isGraphParameter(ExynosVisionNode *node, vx_uint32 index);
+#endif
     vx_status fixAllSubgraph(void);
     vx_status checkExecutionModePropriety(void);
 
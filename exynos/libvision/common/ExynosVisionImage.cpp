@@ -1324,6 +1324,43 @@ ExynosVisionImage::allocateMemory(vx_enum res_type, struct resource_param *param
     return allocateMemory_T(res_type, param, vx_true_e, &m_res_mngr, &m_res_list, &m_cur_res);
 }
 
+vx_size
+ExynosVisionImage::calculateMemorySize(vx_uint32 mem_index)
+{
+    vx_size memory_size = 0;
+    vx_size plane_size = 0;
+
+    for (vx_uint32 sp = 0; sp < m_memory.subplane_num[mem_index]; sp++) {
+        plane_size = m_memory.element_byte_size;
+        for (vx_uint32 d = 0; d < VX_DIM_MAX; d++) {
+            m_memory.strides[mem_index][sp][d] = (vx_int32)plane_size;
+            plane_size *= (vx_size)abs(m_memory.dims[mem_index][sp][d]);
+            m_memory.subplane_mem_offset[mem_index][sp] = memory_size;
+        }
+        memory_size += plane_size;
+    }
+
+    return memory_size;
+}
+
+vx_status
+ExynosVisionImage::getMemorySize(Vector<vx_size> *size_vector)
+{
+    size_vector->clear();
+
+    for (vx_uint32 m = 0; m < m_memory.memory_num; m++) {
+        vx_size memory_size = calculateMemorySize(m);
+        if (memory_size == 0) {
+            VXLOGE("%s, calculating allocation size is zero", getName());
+            return VX_ERROR_INVALID_DIMENSION;
+        }
+
+        size_vector->push_back(memory_size);
+    }
+
+    return VX_SUCCESS;
+}
+
 vx_status
 ExynosVisionImage::allocateResource(image_resource_t **ret_resource)
 {
@@ -1335,19 +1372,8 @@ ExynosVisionImage::allocateResource(image_resource_t **ret_resource)
     vx_status status = VX_SUCCESS;
     image_resource_t*buf_vector = new image_resource_t();
 
-    vx_size plane_size = 0;
-
     for (vx_uint32 m = 0; m < m_memory.memory_num; m++) {
-        vx_size memory_size = 0;
-        for (vx_uint32 sp = 0; sp < m_memory.subplane_num[m]; sp++) {
-            plane_size = m_memory.element_byte_size;
-            for (vx_uint32 d = 0; d < VX_DIM_MAX; d++) {
-                m_memory.strides[m][sp][d] = (vx_int32)plane_size;
-                plane_size *= (vx_size)abs(m_memory.dims[m][sp][d]);
-                m_memory.subplane_mem_offset[m][sp] = memory_size;
-            }
-            memory_size += plane_size;
-        }
+        vx_size memory_size = calculateMemorySize(m);
 
         if (memory_size == 0) {
             VXLOGE("%s, calculating allocation size is zero", getName());
@@ -234,6 +234,8 @@ public:
     /* resource management function */
     void copyMemoryInfo(const ExynosVisionImage *src_image);
     virtual vx_status allocateMemory(vx_enum res_type, struct resource_param *param);
+    virtual vx_status getMemorySize(Vector<vx_size> *size_vector);
+    vx_size calculateMemorySize(vx_uint32 mem_index);
     virtual vx_status allocateResource(image_resource_t **ret_resource);
     virtual vx_status freeResource(image_resource_t *buf_vector);
 
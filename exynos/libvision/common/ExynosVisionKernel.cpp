@@ -40,6 +40,7 @@ ExynosVisionKernel::ExynosVisionKernel(ExynosVisionContext *context)
     m_initialize = 0;
     m_deinitialize = 0;
     memset(&m_attributes, 0x0, sizeof(m_attributes));
+    memset(&m_tile, 0x0, sizeof(m_tile));
 }
 
 ExynosVisionKernel::~ExynosVisionKernel()
@@ -100,6 +101,12 @@ ExynosVisionKernel::setKernelAttribute(vx_enum attribute, const void *ptr, vx_si
         else
             status = VX_ERROR_INVALID_PARAMETERS;
         break;
+    case VX_KERNEL_ATTRIBUTE_TILE:
+        if (VX_CHECK_PARAM(ptr, size, vx_kernel_tile_t, 0x3))
+            m_tile = *(vx_kernel_tile_t *)ptr;
+        else
+            status = VX_ERROR_INVALID_PARAMETERS;
+        break;
 
     default:
         status = VX_ERROR_NOT_SUPPORTED;
@@ -335,6 +342,28 @@ ExynosVisionKernel::kernelFunction(ExynosVisionNode *node, const ExynosVisionDat
     return status;
 }
 
+vx_status
+ExynosVisionKernel::tileFunction(ExynosVisionNode *node, const ExynosVisionDataReference **parameters, vx_uint32 num,
+                                              vx_uint32 start_y, vx_uint32 end_y) const
+{
+    EXYNOS_VISION_SYSTEM_IN();
+    vx_status status;
+
+    if (m_tile.function) {
+        status = m_tile.function((vx_node)node, (vx_reference*)parameters, num, start_y, end_y);
+        if (status != VX_SUCCESS) {
+            VXLOGE("tile function fail at kernel(%s) from %s, rows %d~%d, err:%d", m_kernel_name, node->getName(), start_y, end_y, status);
+        }
+    } else {
+        VXLOGE("tile function is not implemented");
+        status = VX_ERROR_NOT_IMPLEMENTED;
+    }
+
+    EXYNOS_VISION_SYSTEM_OUT();
+
+    return status;
+}
+
 void
 ExynosVisionKernel::fiiledAttr(vx_kernel_attr_t *attributes)
 {
@@ -72,6 +72,8 @@ private:
     vx_kernel_deinitialize_f m_deinitialize;
     /*! \brief The collection of attributes of a kernel */
     vx_kernel_attr_t m_attributes;
+    /*! \brief The row range entry point, function is null if the kernel only takes whole images */
+    vx_kernel_tile_t m_tile;
 
 public:
 
@@ -111,6 +113,16 @@ public:
     vx_status initialize(ExynosVisionNode *node, const ExynosVisionDataReference **parameters, vx_uint32 num);
     vx_status deinitialize(ExynosVisionNode *node, const ExynosVisionDataReference **parameters, vx_uint32 num);
     vx_status kernelFunction(ExynosVisionNode *node, const ExynosVisionDataReference **parameters, vx_uint32 num) const;
+    vx_status tileFunction(ExynosVisionNode *node, const ExynosVisionDataReference **parameters, vx_uint32 num,
+                           vx_uint32 start_y, vx_uint32 end_y) const;
+    vx_bool isTilable(void) const
+    {
+        return (m_tile.function != NULL) ? vx_true_e : vx_false_e;
+    }
+    vx_uint32 getTileHalo(void) const
+    {
+        return m_tile.halo_y;
+    }
 
     void fiiledAttr(vx_kernel_attr_t *attributes);
 
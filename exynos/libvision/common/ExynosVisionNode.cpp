@@ -459,7 +459,7 @@ ExynosVisionNode::nodeSetParameter(vx_uint32 index, ExynosVisionDataReference *d
     }
 
     if (m_subgraph) {
-        if (m_subgraph->replaceDataRef(old_data_ref, data_ref, index, m_kernel->getParamDirection(index)) != VX_SUCCESS)
+        if (m_subgraph->replaceDataRef(old_data_ref, data_ref, this, index, m_kernel->getParamDirection(index)) != VX_SUCCESS)
             VXLOGE("%s cannot replace old reference", m_subgraph->getSgName());
     }
 
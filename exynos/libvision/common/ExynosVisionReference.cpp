@@ -550,6 +550,7 @@ ExynosVisionDataReference::ExynosVisionDataReference(ExynosVisionContext* contex
 
     m_allocator_need_flag = vx_false_e;
     m_allocator = NULL;
+    m_planned_allocator = NULL;
 
     m_kernel_count = 0;
     m_access_count = 0;
@@ -566,6 +567,9 @@ ExynosVisionDataReference::~ExynosVisionDataReference(void)
         if ((*ref_iter).second)
             delete (*ref_iter).second;
     }
+
+    if (m_planned_allocator)
+        delete m_planned_allocator;
 }
 
 vx_status
@@ -777,6 +781,28 @@ ExynosVisionDataReference::getIndirectOutputNodeNum(ExynosVisionGraph *graph)
     return output_node_num;
 }
 
+ExynosVisionNode*
+ExynosVisionDataReference::getDirectInputNode(ExynosVisionGraph *graph, vx_uint32 node_idx)
+{
+    EXYNOS_VISION_REF_IN();
+    Mutex::Autolock lock(m_internal_lock);
+
+    List<node_connect_info_t> *node_list = &m_input_node_list[graph];
+
+    if (node_list->size() < (node_idx+1)) {
+        VXLOGE("out of bound node index:%d", node_idx);
+        return NULL;
+    }
+
+    List<node_connect_info_t>::iterator iter_pos = node_list->begin();
+    for (vx_uint32 i = 0; i<node_idx; i++, iter_pos++);
+
+    ExynosVisionNode *node = (*iter_pos).node;
+    EXYNOS_VISION_REF_OUT();
+
+    return node;
+}
+
 ExynosVisionNode*
 ExynosVisionDataReference::getDirectOutputNode(ExynosVisionGraph *graph, vx_uint32 node_idx)
 {
@@ -869,6 +895,28 @@ ExynosVisionDataReference::allocateMemory(vx_enum res_type, struct resource_para
     return VX_FAILURE;
 }
 
+vx_status
+ExynosVisionDataReference::getMemorySize(Vector<vx_size> *size_vector)
+{
+    VXLOGD3("%s doesn't support memory planning, %p", getName(), size_vector);
+    return VX_ERROR_NOT_SUPPORTED;
+}
+
+vx_status
+ExynosVisionDataReference::setPlannedAllocator(ExynosVisionAllocator *allocator)
+{
+    if (m_is_allocated == vx_true_e) {
+        VXLOGE("%s is already allocated", getName());
+        return VX_FAILURE;
+    }
+
+    if (m_planned_allocator)
+        delete m_planned_allocator;
+    m_planned_allocator = allocator;
+
+    return VX_SUCCESS;
+}
+
 vx_status
 ExynosVisionDataReference::triggerDoneEventIndirect(ExynosVisionGraph *graph, vx_uint32 frame_cnt)
 {
@@ -906,7 +954,7 @@ ExynosVisionDataReference::triggerDoneEventDirect(ExynosVisionGraph *graph, vx_u
             status = VX_FAILURE;
             break;
         } else {
-            subgraph->pushDoneEvent(frame_cnt, this, (*node_iter).node_index);
+            subgraph->pushDoneEvent(frame_cnt, this, (*node_iter).node, (*node_iter).node_index);
         }
     }
 
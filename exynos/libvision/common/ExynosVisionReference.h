@@ -215,6 +215,8 @@ protected:
 
     vx_bool m_allocator_need_flag;
     ExynosVisionAllocator *m_allocator;
+    /* allocator assigned by memory planner of graph, it replaces ion allocator at allocation */
+    ExynosVisionAllocator *m_planned_allocator;
 
     map<void*, ExynosVisionDataReference*> m_clone_object_map;
 
@@ -263,6 +265,7 @@ public:
     vx_uint32 getIndirectInputNodeNum(ExynosVisionGraph *graph);
     vx_uint32 getIndirectOutputNodeNum(ExynosVisionGraph *graph);
 
+    ExynosVisionNode* getDirectInputNode(ExynosVisionGraph *graph, vx_uint32 node_idx);
     ExynosVisionNode* getDirectOutputNode(ExynosVisionGraph *graph, vx_uint32 node_idx);
     ExynosVisionNode* getIndirectOutputNode(ExynosVisionGraph *graph, vx_uint32 node_idx);
 
@@ -509,6 +512,10 @@ public:
     virtual vx_status allocateMemory(void);
     virtual vx_status allocateMemory(vx_enum res_type, struct resource_param *param);
 
+    /* size of each memory that solid resource will allocate, it is used to plan memory before allocation */
+    virtual vx_status getMemorySize(Vector<vx_size> *size_vector);
+    vx_status setPlannedAllocator(ExynosVisionAllocator *allocator);
+
     template<typename T>
     vx_status allocateMemory_T(vx_enum res_type, struct resource_param *res_param,
                                                     vx_bool memory_allocator_need,
@@ -524,11 +531,16 @@ public:
 
             m_allocator_need_flag = memory_allocator_need;
             if (m_allocator_need_flag) {
-                m_allocator = new ExynosVisionIonAllocator();
-                status_t ret = m_allocator->init(true);
-                if (ret != NO_ERROR) {
-                    VXLOGE("ion allocator's init fail, ret:%d", ret);
-                    status = VX_ERROR_NO_RESOURCES;
+                if ((m_planned_allocator != NULL) && (res_type == RESOURCE_MNGR_SOLID)) {
+                    m_allocator = m_planned_allocator;
+                    m_planned_allocator = NULL;
+                } else {
+                    m_allocator = new ExynosVisionIonAllocator();
+                    status_t ret = m_allocator->init(true);
+                    if (ret != NO_ERROR) {
+                        VXLOGE("ion allocator's init fail, ret:%d", ret);
+                        status = VX_ERROR_NO_RESOURCES;
+                    }
                 }
             }
 
@@ -32,6 +32,13 @@ enum vx_node_attribute_ext_e {
     VX_NODE_ATTRIBUTE_SHARE_RESOURCE =  VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_NODE) + 0x4,
 };
 
+enum vx_kernel_attribute_ext_e {
+    /*! \brief Sets the row range entry point of a kernel for the tiled execution of fused nodes.
+     * Use a <tt>\ref vx_kernel_tile_t</tt> parameter.
+     */
+    VX_KERNEL_ATTRIBUTE_TILE = VX_ATTRIBUTE_BASE(VX_ID_SAMSUNG, VX_TYPE_KERNEL) + 0x0,
+};
+
 enum vx_target_ext_e {
     VX_TARGET_VPU = VX_ENUM_BASE(VX_ID_SAMSUNG, VX_ENUM_TARGET) + 0x0,
     VX_TARGET_CPU = VX_ENUM_BASE(VX_ID_SAMSUNG, VX_ENUM_TARGET) + 0x1,
@@ -84,6 +91,20 @@ enum vx_import_type_ext_e {
     VX_IMPORT_TYPE_ION = VX_ENUM_BASE(VX_ID_SAMSUNG, VX_ENUM_IMPORT_MEM) + 0x0,
 };
 
+/*!
+ * \brief Processes the output rows [start_y, end_y) of the node.
+ * The input rows of the output rows and their halo should be ready.
+ */
+typedef vx_status (VX_CALLBACK *vx_kernel_tile_f)(vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                                  vx_uint32 start_y, vx_uint32 end_y);
+
+typedef struct _vx_kernel_tile_t {
+    /*! \brief The row range entry point */
+    vx_kernel_tile_f function;
+    /*! \brief The number of input rows needed above and below an output row */
+    vx_uint32 halo_y;
+} vx_kernel_tile_t;
+
 /*!
  * \brief The entry point into modules loaded by <tt>\ref vxLoadKernels</tt>.
  * \param [in] context The handle to the implementation context.
@@ -0,0 +1,69 @@
+# Copyright (C) 2015 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+LOCAL_PATH:= $(call my-dir)
+
+include $(CLEAR_VARS)
+
+LOCAL_PRELINK_MODULE := false
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils libbinder liblog libcamera_client libhardware libui
+LOCAL_SHARED_LIBRARIES += libexynosutils libion
+LOCAL_SHARED_LIBRARIES += libexpat
+LOCAL_SHARED_LIBRARIES += libexynosvision
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_ARM_NEON := true
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/../../include \
+	$(LOCAL_PATH)/../../common \
+	$(LOCAL_PATH)/../../system \
+	$(LOCAL_PATH)/../../utils \
+	$(LOCAL_PATH)/
+
+LOCAL_SRC_FILES:= \
+	./cpu_kernel_module.cpp \
+	./cpu_kernel_util.cpp \
+	./cpu_kernel_absdiff.cpp \
+	./cpu_kernel_arithmetic.cpp \
+	./cpu_kernel_bitwise.cpp \
+	./cpu_kernel_colorconv.cpp \
+	./cpu_kernel_filter.cpp \
+	./cpu_kernel_sobel.cpp \
+	./cpu_kernel_convolution.cpp \
+	./cpu_kernel_magphase.cpp \
+	./cpu_kernel_histogram.cpp \
+	./cpu_kernel_integralimage.cpp \
+	./cpu_kernel_pyramid.cpp \
+	./cpu_kernel_scaleimage.cpp \
+	./cpu_kernel_warp.cpp \
+	./cpu_kernel_remap.cpp \
+	./cpu_kernel_harris.cpp \
+	./cpu_kernel_fastcorners.cpp \
+	./cpu_kernel_cannyedge.cpp \
+	./cpu_kernel_optpyrlk.cpp \
+
+$(foreach file,$(LOCAL_SRC_FILES),$(shell touch '$(LOCAL_PATH)/$(file)'))
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := libexynoscpukernel
+
+include $(BUILD_SHARED_LIBRARY)
+
+$(warning ##############################################)
+$(warning ##############################################)
+$(warning ##########    EVF CPU Kernel     #############)
+$(warning ##############################################)
+$(warning ##############################################)
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <stdlib.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+struct absdiff_tile_t {
+    struct cpu_image_t in[2];
+    struct cpu_image_t out;
+};
+
+static void absDiffTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct absdiff_tile_t *tile = (struct absdiff_tile_t*)arg;
+    vx_uint32 width = tile->out.width;
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        vx_uint32 x = 0;
+
+        if (tile->out.format == VX_DF_IMAGE_U8) {
+            const vx_uint8 *src0 = CPU_IMAGE_ROW(&tile->in[0], 0, vx_uint8, y);
+            const vx_uint8 *src1 = CPU_IMAGE_ROW(&tile->in[1], 0, vx_uint8, y);
+            vx_uint8 *dst = CPU_IMAGE_ROW(&tile->out, 0, vx_uint8, y);
+#if (CPU_KERNEL_NEON==1)
+            for (; x + 16 <= width; x += 16)
+                vst1q_u8(dst + x, vabdq_u8(vld1q_u8(src0 + x), vld1q_u8(src1 + x)));
+#endif
+            for (; x < width; x++)
+                dst[x] = (vx_uint8)abs((vx_int32)src0[x] - (vx_int32)src1[x]);
+        } else {
+            const vx_int16 *src0 = CPU_IMAGE_ROW(&tile->in[0], 0, vx_int16, y);
+            const vx_int16 *src1 = CPU_IMAGE_ROW(&tile->in[1], 0, vx_int16, y);
+            vx_int16 *dst = CPU_IMAGE_ROW(&tile->out, 0, vx_int16, y);
+#if (CPU_KERNEL_NEON==1)
+            for (; x + 8 <= width; x += 8)
+                vst1q_s16(dst + x, vqabsq_s16(vqsubq_s16(vld1q_s16(src0 + x), vld1q_s16(src1 + x))));
+#endif
+            for (; x < width; x++)
+                dst[x] = cpuSaturateS16(abs((vx_int32)src0[x] - (vx_int32)src1[x]));
+        }
+    }
+}
+
+static vx_status processAbsDiff(const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    vx_status status;
+    struct absdiff_tile_t tile;
+
+    if (num != 3) {
+        VXLOGE("parameter number is wrong, num:%d", num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &tile.in[0]);
+    status |= cpuAccessImage((vx_image)parameters[1], VX_READ_ONLY, &tile.in[1]);
+    status |= cpuAccessImage((vx_image)parameters[2], VX_WRITE_ONLY, &tile.out);
+    if (status == VX_SUCCESS)
+        cpuProcessTileRange(start_y, end_y, tile.out.height, absDiffTile, &tile);
+    else
+        VXLOGE("accessing images fails, err:%d", status);
+
+    status |= cpuCommitImage(&tile.in[0]);
+    status |= cpuCommitImage(&tile.in[1]);
+    status |= cpuCommitImage(&tile.out);
+
+    return status;
+}
+
+static vx_status vxAbsDiffKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = node ? processAbsDiff(parameters, num, 0, CPU_KERNEL_ALL_ROWS) : VX_ERROR_INVALID_NODE;
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxAbsDiffTile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return node ? processAbsDiff(parameters, num, start_y, end_y) : VX_ERROR_INVALID_NODE;
+}
+
+static vx_status vxAbsDiffInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format[2];
+
+    if (index == 0) {
+        if ((cpuQueryImageParam(node, 0, NULL, NULL, &format[0]) == VX_SUCCESS) &&
+            ((format[0] == VX_DF_IMAGE_U8) || (format[0] == VX_DF_IMAGE_S16)))
+            status = VX_SUCCESS;
+    } else if (index == 1) {
+        if ((cpuQueryImageParam(node, 0, NULL, NULL, &format[0]) == VX_SUCCESS) &&
+            (cpuQueryImageParam(node, 1, NULL, NULL, &format[1]) == VX_SUCCESS) &&
+            (format[0] == format[1]))
+            status = cpuCheckSameImageParam(node, 0, 1);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxAbsDiffOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+    vx_df_image format;
+
+    if (index == 2) {
+        status = cpuQueryImageParam(node, 0, &width, &height, &format);
+        if (status == VX_SUCCESS)
+            cpuSetImageMeta(meta, width, height, format);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t absdiff_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t absdiff_cpu_kernel = {
+    VX_KERNEL_ABSDIFF,
+    "org.khronos.openvx.absdiff",
+    vxAbsDiffKernel,
+    absdiff_kernel_params, dimof(absdiff_kernel_params),
+    vxAbsDiffInputValidator,
+    vxAbsDiffOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_tile_t absdiff_cpu_tile = {
+    vxAbsDiffTile,
+    0,
+};
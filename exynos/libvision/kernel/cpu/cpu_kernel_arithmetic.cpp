@@ -0,0 +1,449 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <math.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+enum cpu_arithmetic_op_t {
+    CPU_ARITHMETIC_ADD,
+    CPU_ARITHMETIC_SUBTRACT,
+    CPU_ARITHMETIC_MULTIPLY,
+};
+
+struct arithmetic_tile_t {
+    enum cpu_arithmetic_op_t op;
+    struct cpu_image_t in[2];
+    struct cpu_image_t out;
+    vx_enum overflow_policy;
+    vx_enum rounding_policy;
+    vx_float64 scale;
+};
+
+static inline vx_int32 convertResult(vx_int32 value, vx_df_image format, vx_enum policy)
+{
+    if (format == VX_DF_IMAGE_U8)
+        return (policy == VX_CONVERT_POLICY_SATURATE) ? cpuSaturateU8(value) : (vx_uint8)value;
+    else
+        return (policy == VX_CONVERT_POLICY_SATURATE) ? cpuSaturateS16(value) : (vx_int16)value;
+}
+
+template <typename T0, typename T1, typename TO>
+static void arithmeticRow(const struct arithmetic_tile_t *tile, const T0 *src0, const T1 *src1, TO *dst, vx_uint32 start_x)
+{
+    vx_uint32 width = tile->out.width;
+    vx_df_image format = tile->out.format;
+
+    for (vx_uint32 x = start_x; x < width; x++) {
+        vx_int32 value;
+
+        switch (tile->op) {
+        case CPU_ARITHMETIC_ADD:
+            value = (vx_int32)src0[x] + (vx_int32)src1[x];
+            break;
+        case CPU_ARITHMETIC_SUBTRACT:
+            value = (vx_int32)src0[x] - (vx_int32)src1[x];
+            break;
+        case CPU_ARITHMETIC_MULTIPLY:
+        default: {
+            vx_float64 product = (vx_float64)src0[x] * (vx_float64)src1[x] * tile->scale;
+            vx_float64 limit = (vx_float64)INT32_MAX;
+            product = (product > limit) ? limit : ((product < -limit) ? -limit : product);
+            if (tile->rounding_policy == VX_ROUND_POLICY_TO_ZERO)
+                value = (vx_int32)product;
+            else
+                value = (vx_int32)rint(product);
+            break;
+        }
+        }
+
+        dst[x] = (TO)convertResult(value, format, tile->overflow_policy);
+    }
+}
+
+#if (CPU_KERNEL_NEON==1)
+static vx_uint32 arithmeticRowU8Neon(const struct arithmetic_tile_t *tile, const vx_uint8 *src0, const vx_uint8 *src1, vx_uint8 *dst)
+{
+    vx_uint32 x = 0;
+    vx_uint32 width = tile->out.width;
+    vx_bool saturate = (tile->overflow_policy == VX_CONVERT_POLICY_SATURATE) ? vx_true_e : vx_false_e;
+
+    if (tile->op == CPU_ARITHMETIC_ADD) {
+        for (; x + 16 <= width; x += 16) {
+            uint8x16_t a = vld1q_u8(src0 + x);
+            uint8x16_t b = vld1q_u8(src1 + x);
+            vst1q_u8(dst + x, saturate ? vqaddq_u8(a, b) : vaddq_u8(a, b));
+        }
+    } else if (tile->op == CPU_ARITHMETIC_SUBTRACT) {
+        for (; x + 16 <= width; x += 16) {
+            uint8x16_t a = vld1q_u8(src0 + x);
+            uint8x16_t b = vld1q_u8(src1 + x);
+            vst1q_u8(dst + x, saturate ? vqsubq_u8(a, b) : vsubq_u8(a, b));
+        }
+    }
+
+    return x;
+}
+
+static vx_uint32 arithmeticRowS16Neon(const struct arithmetic_tile_t *tile, const vx_int16 *src0, const vx_int16 *src1, vx_int16 *dst)
+{
+    vx_uint32 x = 0;
+    vx_uint32 width = tile->out.width;
+    vx_bool saturate = (tile->overflow_policy == VX_CONVERT_POLICY_SATURATE) ? vx_true_e : vx_false_e;
+
+    if (tile->op == CPU_ARITHMETIC_ADD) {
+        for (; x + 8 <= width; x += 8) {
+            int16x8_t a = vld1q_s16(src0 + x);
+            int16x8_t b = vld1q_s16(src1 + x);
+            vst1q_s16(dst + x, saturate ? vqaddq_s16(a, b) : vaddq_s16(a, b));
+        }
+    } else if (tile->op == CPU_ARITHMETIC_SUBTRACT) {
+        for (; x + 8 <= width; x += 8) {
+            int16x8_t a = vld1q_s16(src0 + x);
+            int16x8_t b = vld1q_s16(src1 + x);
+            vst1q_s16(dst + x, saturate ? vqsubq_s16(a, b) : vsubq_s16(a, b));
+        }
+    }
+
+    return x;
+}
+#endif
+
+static void arithmeticTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct arithmetic_tile_t *tile = (struct arithmetic_tile_t*)arg;
+    vx_bool in0_u8 = (tile->in[0].format == VX_DF_IMAGE_U8) ? vx_true_e : vx_false_e;
+    vx_bool in1_u8 = (tile->in[1].format == VX_DF_IMAGE_U8) ? vx_true_e : vx_false_e;
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        if (tile->out.format == VX_DF_IMAGE_U8) {
+            const vx_uint8 *src0 = CPU_IMAGE_ROW(&tile->in[0], 0, vx_uint8, y);
+            const vx_uint8 *src1 = CPU_IMAGE_ROW(&tile->in[1], 0, vx_uint8, y);
+            vx_uint8 *dst = CPU_IMAGE_ROW(&tile->out, 0, vx_uint8, y);
+            vx_uint32 x = 0;
+#if (CPU_KERNEL_NEON==1)
+            x = arithmeticRowU8Neon(tile, src0, src1, dst);
+#endif
+            arithmeticRow(tile, src0, src1, dst, x);
+        } else if (in0_u8 && in1_u8) {
+            arithmeticRow(tile, CPU_IMAGE_ROW(&tile->in[0], 0, vx_uint8, y), CPU_IMAGE_ROW(&tile->in[1], 0, vx_uint8, y),
+                                    CPU_IMAGE_ROW(&tile->out, 0, vx_int16, y), 0);
+        } else if (in0_u8) {
+            arithmeticRow(tile, CPU_IMAGE_ROW(&tile->in[0], 0, vx_uint8, y), CPU_IMAGE_ROW(&tile->in[1], 0, vx_int16, y),
+                                    CPU_IMAGE_ROW(&tile->out, 0, vx_int16, y), 0);
+        } else if (in1_u8) {
+            arithmeticRow(tile, CPU_IMAGE_ROW(&tile->in[0], 0, vx_int16, y), CPU_IMAGE_ROW(&tile->in[1], 0, vx_uint8, y),
+                                    CPU_IMAGE_ROW(&tile->out, 0, vx_int16, y), 0);
+        } else {
+            const vx_int16 *src0 = CPU_IMAGE_ROW(&tile->in[0], 0, vx_int16, y);
+            const vx_int16 *src1 = CPU_IMAGE_ROW(&tile->in[1], 0, vx_int16, y);
+            vx_int16 *dst = CPU_IMAGE_ROW(&tile->out, 0, vx_int16, y);
+            vx_uint32 x = 0;
+#if (CPU_KERNEL_NEON==1)
+            x = arithmeticRowS16Neon(tile, src0, src1, dst);
+#endif
+            arithmeticRow(tile, src0, src1, dst, x);
+        }
+    }
+}
+
+static vx_status processArithmetic(struct arithmetic_tile_t *tile, vx_image in0, vx_image in1, vx_image out,
+                                        vx_uint32 start_y, vx_uint32 end_y)
+{
+    vx_status status;
+
+    status = cpuAccessImage(in0, VX_READ_ONLY, &tile->in[0]);
+    status |= cpuAccessImage(in1, VX_READ_ONLY, &tile->in[1]);
+    status |= cpuAccessImage(out, VX_WRITE_ONLY, &tile->out);
+    if (status == VX_SUCCESS)
+        cpuProcessTileRange(start_y, end_y, tile->out.height, arithmeticTile, tile);
+    else
+        VXLOGE("accessing images fails, err:%d", status);
+
+    status |= cpuCommitImage(&tile->in[0]);
+    status |= cpuCommitImage(&tile->in[1]);
+    status |= cpuCommitImage(&tile->out);
+
+    return status;
+}
+
+static vx_status processAddSubtract(vx_node node, const vx_reference parameters[], vx_uint32 num, enum cpu_arithmetic_op_t op,
+                                        vx_uint32 start_y, vx_uint32 end_y)
+{
+    vx_status status;
+    struct arithmetic_tile_t tile;
+
+    if ((node == NULL) || (num != 4)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    tile.op = op;
+    tile.rounding_policy = VX_ROUND_POLICY_TO_ZERO;
+    tile.scale = 1.0;
+    status = vxReadScalarValue((vx_scalar)parameters[2], &tile.overflow_policy);
+    if (status != VX_SUCCESS) {
+        VXLOGE("reading policy fails, err:%d", status);
+        return status;
+    }
+
+    return processArithmetic(&tile, (vx_image)parameters[0], (vx_image)parameters[1], (vx_image)parameters[3], start_y, end_y);
+}
+
+static vx_status vxAddKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = processAddSubtract(node, parameters, num, CPU_ARITHMETIC_ADD, 0, CPU_KERNEL_ALL_ROWS);
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxSubtractKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = processAddSubtract(node, parameters, num, CPU_ARITHMETIC_SUBTRACT, 0, CPU_KERNEL_ALL_ROWS);
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status processMultiply(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    vx_status status;
+    struct arithmetic_tile_t tile;
+    vx_float32 scale = 1.0f;
+
+    if ((node == NULL) || (num != 6)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    tile.op = CPU_ARITHMETIC_MULTIPLY;
+    status = vxReadScalarValue((vx_scalar)parameters[2], &scale);
+    status |= vxReadScalarValue((vx_scalar)parameters[3], &tile.overflow_policy);
+    status |= vxReadScalarValue((vx_scalar)parameters[4], &tile.rounding_policy);
+    if (status != VX_SUCCESS) {
+        VXLOGE("reading scalars fails, err:%d", status);
+        return status;
+    }
+    tile.scale = scale;
+
+    return processArithmetic(&tile, (vx_image)parameters[0], (vx_image)parameters[1], (vx_image)parameters[5], start_y, end_y);
+}
+
+static vx_status vxMultiplyKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = processMultiply(node, parameters, num, 0, CPU_KERNEL_ALL_ROWS);
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxAddTile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return processAddSubtract(node, parameters, num, CPU_ARITHMETIC_ADD, start_y, end_y);
+}
+
+static vx_status vxSubtractTile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return processAddSubtract(node, parameters, num, CPU_ARITHMETIC_SUBTRACT, start_y, end_y);
+}
+
+static vx_status vxMultiplyTile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return processMultiply(node, parameters, num, start_y, end_y);
+}
+
+static vx_status arithmeticImageValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format;
+
+    if ((cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) &&
+        ((format == VX_DF_IMAGE_U8) || (format == VX_DF_IMAGE_S16))) {
+        status = (index == 0) ? VX_SUCCESS : cpuCheckSameImageParam(node, 0, index);
+    }
+
+    return status;
+}
+
+static vx_status arithmeticOutputValidator(vx_node node, vx_uint32 out_index, vx_meta_format meta)
+{
+    vx_status status;
+    vx_uint32 width, height;
+    vx_df_image format[2];
+    vx_df_image out_format = VX_DF_IMAGE_S16;
+    vx_df_image user_format = VX_DF_IMAGE_VIRT;
+
+    status = cpuQueryImageParam(node, 0, &width, &height, &format[0]);
+    status |= cpuQueryImageParam(node, 1, NULL, NULL, &format[1]);
+    if (status != VX_SUCCESS)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    /* u8 output is allowed only if both inputs are u8 and user asks it */
+    cpuQueryImageParam(node, out_index, NULL, NULL, &user_format);
+    if ((format[0] == VX_DF_IMAGE_U8) && (format[1] == VX_DF_IMAGE_U8) && (user_format == VX_DF_IMAGE_U8))
+        out_format = VX_DF_IMAGE_U8;
+
+    cpuSetImageMeta(meta, width, height, out_format);
+
+    return VX_SUCCESS;
+}
+
+static vx_status vxAddSubtractInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_enum type = VX_TYPE_INVALID;
+    vx_enum policy;
+
+    if ((index == 0) || (index == 1)) {
+        status = arithmeticImageValidator(node, index);
+    } else if (index == 2) {
+        if ((cpuQueryScalarParam(node, index, &type, &policy) == VX_SUCCESS) && (type == VX_TYPE_ENUM) &&
+            ((policy == VX_CONVERT_POLICY_WRAP) || (policy == VX_CONVERT_POLICY_SATURATE)))
+            status = VX_SUCCESS;
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxAddSubtractOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    if (index == 3)
+        status = arithmeticOutputValidator(node, index, meta);
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxMultiplyInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_enum type = VX_TYPE_INVALID;
+    vx_float32 scale;
+    vx_enum policy;
+
+    if ((index == 0) || (index == 1)) {
+        status = arithmeticImageValidator(node, index);
+    } else if (index == 2) {
+        if ((cpuQueryScalarParam(node, index, &type, &scale) == VX_SUCCESS) && (type == VX_TYPE_FLOAT32) && (scale >= 0.0f))
+            status = VX_SUCCESS;
+    } else if (index == 3) {
+        if ((cpuQueryScalarParam(node, index, &type, &policy) == VX_SUCCESS) && (type == VX_TYPE_ENUM) &&
+            ((policy == VX_CONVERT_POLICY_WRAP) || (policy == VX_CONVERT_POLICY_SATURATE)))
+            status = VX_SUCCESS;
+    } else if (index == 4) {
+        if ((cpuQueryScalarParam(node, index, &type, &policy) == VX_SUCCESS) && (type == VX_TYPE_ENUM) &&
+            ((policy == VX_ROUND_POLICY_TO_ZERO) || (policy == VX_ROUND_POLICY_TO_NEAREST_EVEN)))
+            status = VX_SUCCESS;
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxMultiplyOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    if (index == 5)
+        status = arithmeticOutputValidator(node, index, meta);
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t addsub_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_param_description_t multiply_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t add_cpu_kernel = {
+    VX_KERNEL_ADD,
+    "org.khronos.openvx.add",
+    vxAddKernel,
+    addsub_kernel_params, dimof(addsub_kernel_params),
+    vxAddSubtractInputValidator,
+    vxAddSubtractOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t subtract_cpu_kernel = {
+    VX_KERNEL_SUBTRACT,
+    "org.khronos.openvx.subtract",
+    vxSubtractKernel,
+    addsub_kernel_params, dimof(addsub_kernel_params),
+    vxAddSubtractInputValidator,
+    vxAddSubtractOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t multiply_cpu_kernel = {
+    VX_KERNEL_MULTIPLY,
+    "org.khronos.openvx.multiply",
+    vxMultiplyKernel,
+    multiply_kernel_params, dimof(multiply_kernel_params),
+    vxMultiplyInputValidator,
+    vxMultiplyOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_tile_t add_cpu_tile = {
+    vxAddTile,
+    0,
+};
+
+vx_kernel_tile_t subtract_cpu_tile = {
+    vxSubtractTile,
+    0,
+};
+
+vx_kernel_tile_t multiply_cpu_tile = {
+    vxMultiplyTile,
+    0,
+};
@@ -0,0 +1,312 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <string.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+enum cpu_bitwise_op_t {
+    CPU_BITWISE_AND,
+    CPU_BITWISE_OR,
+    CPU_BITWISE_XOR,
+    CPU_BITWISE_NOT,
+};
+
+struct bitwise_tile_t {
+    enum cpu_bitwise_op_t op;
+    struct cpu_image_t in[2];
+    struct cpu_image_t out;
+};
+
+static void bitwiseTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct bitwise_tile_t *tile = (struct bitwise_tile_t*)arg;
+    vx_uint32 width = tile->out.width;
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        const vx_uint8 *src0 = CPU_IMAGE_ROW(&tile->in[0], 0, vx_uint8, y);
+        const vx_uint8 *src1 = (tile->op == CPU_BITWISE_NOT) ? src0 : CPU_IMAGE_ROW(&tile->in[1], 0, vx_uint8, y);
+        vx_uint8 *dst = CPU_IMAGE_ROW(&tile->out, 0, vx_uint8, y);
+        vx_uint32 x = 0;
+
+        switch (tile->op) {
+        case CPU_BITWISE_AND:
+#if (CPU_KERNEL_NEON==1)
+            for (; x + 16 <= width; x += 16)
+                vst1q_u8(dst + x, vandq_u8(vld1q_u8(src0 + x), vld1q_u8(src1 + x)));
+#endif
+            for (; x < width; x++)
+                dst[x] = src0[x] & src1[x];
+            break;
+        case CPU_BITWISE_OR:
+#if (CPU_KERNEL_NEON==1)
+            for (; x + 16 <= width; x += 16)
+                vst1q_u8(dst + x, vorrq_u8(vld1q_u8(src0 + x), vld1q_u8(src1 + x)));
+#endif
+            for (; x < width; x++)
+                dst[x] = src0[x] | src1[x];
+            break;
+        case CPU_BITWISE_XOR:
+#if (CPU_KERNEL_NEON==1)
+            for (; x + 16 <= width; x += 16)
+                vst1q_u8(dst + x, veorq_u8(vld1q_u8(src0 + x), vld1q_u8(src1 + x)));
+#endif
+            for (; x < width; x++)
+                dst[x] = src0[x] ^ src1[x];
+            break;
+        case CPU_BITWISE_NOT:
+        default:
+#if (CPU_KERNEL_NEON==1)
+            for (; x + 16 <= width; x += 16)
+                vst1q_u8(dst + x, vmvnq_u8(vld1q_u8(src0 + x)));
+#endif
+            for (; x < width; x++)
+                dst[x] = ~src0[x];
+            break;
+        }
+    }
+}
+
+static vx_status processBitwise(enum cpu_bitwise_op_t op, const vx_reference parameters[], vx_uint32 num,
+                                        vx_uint32 start_y, vx_uint32 end_y)
+{
+    vx_status status;
+    struct bitwise_tile_t tile;
+    vx_uint32 in_num = (op == CPU_BITWISE_NOT) ? 1 : 2;
+
+    if (num != in_num + 1) {
+        VXLOGE("parameter number is wrong, num:%d", num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    tile.op = op;
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &tile.in[0]);
+    if (in_num == 2)
+        status |= cpuAccessImage((vx_image)parameters[1], VX_READ_ONLY, &tile.in[1]);
+    else
+        memset(&tile.in[1], 0x0, sizeof(tile.in[1]));
+    status |= cpuAccessImage((vx_image)parameters[in_num], VX_WRITE_ONLY, &tile.out);
+    if (status == VX_SUCCESS)
+        cpuProcessTileRange(start_y, end_y, tile.out.height, bitwiseTile, &tile);
+    else
+        VXLOGE("accessing images fails, err:%d", status);
+
+    status |= cpuCommitImage(&tile.in[0]);
+    status |= cpuCommitImage(&tile.in[1]);
+    status |= cpuCommitImage(&tile.out);
+
+    return status;
+}
+
+static vx_status vxAndKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = node ? processBitwise(CPU_BITWISE_AND, parameters, num, 0, CPU_KERNEL_ALL_ROWS) : VX_ERROR_INVALID_NODE;
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxOrKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = node ? processBitwise(CPU_BITWISE_OR, parameters, num, 0, CPU_KERNEL_ALL_ROWS) : VX_ERROR_INVALID_NODE;
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxXorKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = node ? processBitwise(CPU_BITWISE_XOR, parameters, num, 0, CPU_KERNEL_ALL_ROWS) : VX_ERROR_INVALID_NODE;
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxNotKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = node ? processBitwise(CPU_BITWISE_NOT, parameters, num, 0, CPU_KERNEL_ALL_ROWS) : VX_ERROR_INVALID_NODE;
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxAndTile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return node ? processBitwise(CPU_BITWISE_AND, parameters, num, start_y, end_y) : VX_ERROR_INVALID_NODE;
+}
+
+static vx_status vxOrTile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return node ? processBitwise(CPU_BITWISE_OR, parameters, num, start_y, end_y) : VX_ERROR_INVALID_NODE;
+}
+
+static vx_status vxXorTile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return node ? processBitwise(CPU_BITWISE_XOR, parameters, num, start_y, end_y) : VX_ERROR_INVALID_NODE;
+}
+
+static vx_status vxNotTile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return node ? processBitwise(CPU_BITWISE_NOT, parameters, num, start_y, end_y) : VX_ERROR_INVALID_NODE;
+}
+
+static vx_status vxBinaryBitwiseInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format;
+
+    if ((index == 0) || (index == 1)) {
+        if ((cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+            status = (index == 0) ? VX_SUCCESS : cpuCheckSameImageParam(node, 0, 1);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxBinaryBitwiseOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+
+    if (index == 2) {
+        status = cpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            cpuSetImageMeta(meta, width, height, VX_DF_IMAGE_U8);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxUnaryBitwiseInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format;
+
+    if ((index == 0) && (cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+        status = VX_SUCCESS;
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxUnaryBitwiseOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+
+    if (index == 1) {
+        status = cpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            cpuSetImageMeta(meta, width, height, VX_DF_IMAGE_U8);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t binary_bitwise_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_param_description_t unary_bitwise_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t bitwiseand_cpu_kernel = {
+    VX_KERNEL_AND,
+    "org.khronos.openvx.and",
+    vxAndKernel,
+    binary_bitwise_kernel_params, dimof(binary_bitwise_kernel_params),
+    vxBinaryBitwiseInputValidator,
+    vxBinaryBitwiseOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t bitwiseor_cpu_kernel = {
+    VX_KERNEL_OR,
+    "org.khronos.openvx.or",
+    vxOrKernel,
+    binary_bitwise_kernel_params, dimof(binary_bitwise_kernel_params),
+    vxBinaryBitwiseInputValidator,
+    vxBinaryBitwiseOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t bitwisexor_cpu_kernel = {
+    VX_KERNEL_XOR,
+    "org.khronos.openvx.xor",
+    vxXorKernel,
+    binary_bitwise_kernel_params, dimof(binary_bitwise_kernel_params),
+    vxBinaryBitwiseInputValidator,
+    vxBinaryBitwiseOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t bitwisenot_cpu_kernel = {
+    VX_KERNEL_NOT,
+    "org.khronos.openvx.not",
+    vxNotKernel,
+    unary_bitwise_kernel_params, dimof(unary_bitwise_kernel_params),
+    vxUnaryBitwiseInputValidator,
+    vxUnaryBitwiseOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_tile_t bitwiseand_cpu_tile = {
+    vxAndTile,
+    0,
+};
+
+vx_kernel_tile_t bitwiseor_cpu_tile = {
+    vxOrTile,
+    0,
+};
+
+vx_kernel_tile_t bitwisexor_cpu_tile = {
+    vxXorTile,
+    0,
+};
+
+vx_kernel_tile_t bitwisenot_cpu_tile = {
+    vxNotTile,
+    0,
+};
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+enum canny_edge_t {
+    CANNY_NONE = 0,
+    CANNY_WEAK = 1,
+    CANNY_STRONG = 2,
+};
+
+struct canny_tile_t {
+    vx_uint32 width;
+    vx_uint32 height;
+    vx_int32 *grad_x;
+    vx_int32 *grad_y;
+    vx_int32 *mag;
+    vx_uint8 *edge;
+    vx_enum norm;
+    vx_int32 lower;
+    vx_int32 upper;
+};
+
+static void magnitudeTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct canny_tile_t *tile = (struct canny_tile_t*)arg;
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        vx_size offset = (vx_size)y * tile->width;
+
+        for (vx_uint32 x = 0; x < tile->width; x++) {
+            vx_int32 gx = tile->grad_x[offset + x];
+            vx_int32 gy = tile->grad_y[offset + x];
+
+            if (tile->norm == VX_NORM_L2)
+                tile->mag[offset + x] = (vx_int32)(sqrt((vx_float64)gx * gx + (vx_float64)gy * gy) + 0.5);
+            else
+                tile->mag[offset + x] = abs(gx) + abs(gy);
+        }
+    }
+}
+
+/* keeps the local maximum along the gradient direction quantized to 4 sectors, and classifies it by the thresholds */
+static void suppressTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct canny_tile_t *tile = (struct canny_tile_t*)arg;
+    vx_int32 width = (vx_int32)tile->width;
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        vx_uint8 *edge = tile->edge + (vx_size)y * tile->width;
+
+        memset(edge, CANNY_NONE, tile->width);
+        if ((y == 0) || (y + 1 >= tile->height))
+            continue;
+
+        for (vx_int32 x = 1; x + 1 < width; x++) {
+            vx_size pos = (vx_size)y * tile->width + x;
+            vx_int32 mag = tile->mag[pos];
+            vx_int32 gx = tile->grad_x[pos];
+            vx_int32 gy = tile->grad_y[pos];
+            vx_int32 ax = abs(gx), ay = abs(gy);
+            vx_int32 offset;
+
+            if (mag <= tile->lower)
+                continue;
+
+            /* tan(22.5) ~= 0.4142 and tan(67.5) ~= 2.4142, in 1/10000 fixed point */
+            if ((vx_int64)ay * 10000 <= (vx_int64)ax * 4142)
+                offset = 1;
+            else if ((vx_int64)ay * 10000 >= (vx_int64)ax * 24142)
+                offset = width;
+            else if ((gx ^ gy) >= 0)
+                offset = width + 1;
+            else
+                offset = width - 1;
+
+            if ((mag > tile->mag[pos - offset]) && (mag >= tile->mag[pos + offset]))
+                edge[x] = (mag > tile->upper) ? CANNY_STRONG : CANNY_WEAK;
+        }
+    }
+}
+
+/* promotes the weak edges connected to the strong edges */
+static vx_status traceEdges(struct canny_tile_t *tile)
+{
+    vx_size size = (vx_size)tile->width * tile->height;
+    vx_size *stack = (vx_size*)malloc(size * sizeof(vx_size));
+    vx_size top = 0;
+
+    if (stack == NULL) {
+        VXLOGE("allocating edge stack fails");
+        return VX_ERROR_NO_MEMORY;
+    }
+
+    for (vx_size pos = 0; pos < size; pos++) {
+        if (tile->edge[pos] == CANNY_STRONG)
+            stack[top++] = pos;
+    }
+
+    while (top > 0) {
+        vx_size pos = stack[--top];
+        vx_int32 x = (vx_int32)(pos % tile->width);
+        vx_int32 y = (vx_int32)(pos / tile->width);
+
+        for (vx_int32 j = -1; j <= 1; j++) {
+            for (vx_int32 i = -1; i <= 1; i++) {
+                vx_int32 nx = x + i, ny = y + j;
+                if ((nx < 0) || (ny < 0) || (nx >= (vx_int32)tile->width) || (ny >= (vx_int32)tile->height))
+                    continue;
+
+                vx_size npos = (vx_size)ny * tile->width + nx;
+                if (tile->edge[npos] == CANNY_WEAK) {
+                    tile->edge[npos] = CANNY_STRONG;
+                    stack[top++] = npos;
+                }
+            }
+        }
+    }
+
+    free(stack);
+
+    return VX_SUCCESS;
+}
+
+static vx_status vxCannyEdgeKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status;
+    struct canny_tile_t tile;
+    struct cpu_image_t in, out;
+    vx_int32 gradient_size = 0;
+    vx_size size;
+
+    if ((node == NULL) || (num != 5)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    memset(&tile, 0x0, sizeof(tile));
+    status = vxQueryThreshold((vx_threshold)parameters[1], VX_THRESHOLD_ATTRIBUTE_THRESHOLD_LOWER, &tile.lower, sizeof(tile.lower));
+    status |= vxQueryThreshold((vx_threshold)parameters[1], VX_THRESHOLD_ATTRIBUTE_THRESHOLD_UPPER, &tile.upper, sizeof(tile.upper));
+    status |= vxReadScalarValue((vx_scalar)parameters[2], &gradient_size);
+    status |= vxReadScalarValue((vx_scalar)parameters[3], &tile.norm);
+    if (status != VX_SUCCESS) {
+        VXLOGE("reading parameters fails, err:%d", status);
+        return status;
+    }
+
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &in);
+    status |= cpuAccessImage((vx_image)parameters[4], VX_WRITE_ONLY, &out);
+    if (status != VX_SUCCESS) {
+        VXLOGE("accessing images fails, err:%d", status);
+        goto EXIT;
+    }
+
+    tile.width = in.width;
+    tile.height = in.height;
+    size = (vx_size)in.width * in.height;
+    tile.grad_x = (vx_int32*)malloc(size * sizeof(vx_int32));
+    tile.grad_y = (vx_int32*)malloc(size * sizeof(vx_int32));
+    tile.mag = (vx_int32*)malloc(size * sizeof(vx_int32));
+    tile.edge = (vx_uint8*)malloc(size);
+    if ((tile.grad_x == NULL) || (tile.grad_y == NULL) || (tile.mag == NULL) || (tile.edge == NULL)) {
+        VXLOGE("allocating buffers fails");
+        status = VX_ERROR_NO_MEMORY;
+        goto EXIT;
+    }
+
+    status = cpuComputeGradients(&in, (vx_uint32)gradient_size, tile.grad_x, tile.grad_y);
+    if (status != VX_SUCCESS)
+        goto EXIT;
+
+    cpuProcessTiles(tile.height, magnitudeTile, &tile);
+    cpuProcessTiles(tile.height, suppressTile, &tile);
+    status = traceEdges(&tile);
+    if (status != VX_SUCCESS)
+        goto EXIT;
+
+    for (vx_uint32 y = 0; y < out.height; y++) {
+        vx_uint8 *dst = CPU_IMAGE_ROW(&out, 0, vx_uint8, y);
+        const vx_uint8 *edge = tile.edge + (vx_size)y * tile.width;
+
+        for (vx_uint32 x = 0; x < out.width; x++)
+            dst[x] = (edge[x] == CANNY_STRONG) ? 255 : 0;
+    }
+
+EXIT:
+    if (tile.grad_x)
+        free(tile.grad_x);
+    if (tile.grad_y)
+        free(tile.grad_y);
+    if (tile.mag)
+        free(tile.mag);
+    if (tile.edge)
+        free(tile.edge);
+
+    status |= cpuCommitImage(&in);
+    status |= cpuCommitImage(&out);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxCannyEdgeInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_enum type = VX_TYPE_INVALID;
+
+    if (index == 0) {
+        vx_df_image format;
+        if ((cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+            status = VX_SUCCESS;
+    } else if (index == 1) {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_threshold threshold = NULL;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &threshold, sizeof(threshold));
+            if (threshold) {
+                vx_enum thresh_type = 0;
+                vxQueryThreshold(threshold, VX_THRESHOLD_ATTRIBUTE_TYPE, &thresh_type, sizeof(thresh_type));
+                if (thresh_type == VX_THRESHOLD_TYPE_RANGE)
+                    status = VX_SUCCESS;
+                vxReleaseThreshold(&threshold);
+            }
+            vxReleaseParameter(&param);
+        }
+    } else if (index == 2) {
+        vx_int32 gradient_size = 0;
+        if ((cpuQueryScalarParam(node, index, &type, &gradient_size) == VX_SUCCESS) && (type == VX_TYPE_INT32) &&
+                ((gradient_size == 3) || (gradient_size == 5) || (gradient_size == 7)))
+            status = VX_SUCCESS;
+    } else if (index == 3) {
+        vx_enum norm = 0;
+        if ((cpuQueryScalarParam(node, index, &type, &norm) == VX_SUCCESS) && (type == VX_TYPE_ENUM) &&
+                ((norm == VX_NORM_L1) || (norm == VX_NORM_L2)))
+            status = VX_SUCCESS;
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxCannyEdgeOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+
+    if (index == 4) {
+        status = cpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            cpuSetImageMeta(meta, width, height, VX_DF_IMAGE_U8);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t canny_edge_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_THRESHOLD, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t cannyedge_cpu_kernel = {
+    VX_KERNEL_CANNY_EDGE_DETECTOR,
+    "org.khronos.openvx.canny_edge_detector",
+    vxCannyEdgeKernel,
+    canny_edge_kernel_params, dimof(canny_edge_kernel_params),
+    vxCannyEdgeInputValidator,
+    vxCannyEdgeOutputValidator,
+    NULL,
+    NULL,
+};
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+/* BT.709 coefficients in 16 bit fixed point */
+#define CPU_CSC_SHIFT   16
+#define CPU_CSC_ROUND   (1 << (CPU_CSC_SHIFT - 1))
+#define CPU_CSC(value)  ((vx_int32)((value) * (1 << CPU_CSC_SHIFT) + 0.5))
+
+struct colorconv_tile_t {
+    struct cpu_image_t in;
+    struct cpu_image_t out;
+};
+
+static vx_bool isRgbFormat(vx_df_image format)
+{
+    return ((format == VX_DF_IMAGE_RGB) || (format == VX_DF_IMAGE_RGBX)) ? vx_true_e : vx_false_e;
+}
+
+static vx_bool isSupportedConversion(vx_df_image src, vx_df_image dst)
+{
+    switch (src) {
+    case VX_DF_IMAGE_RGB:
+    case VX_DF_IMAGE_RGBX:
+        return ((dst == VX_DF_IMAGE_RGB) || (dst == VX_DF_IMAGE_RGBX) || (dst == VX_DF_IMAGE_NV12) ||
+                    (dst == VX_DF_IMAGE_IYUV) || (dst == VX_DF_IMAGE_YUV4)) && (src != dst) ? vx_true_e : vx_false_e;
+    case VX_DF_IMAGE_NV12:
+    case VX_DF_IMAGE_NV21:
+    case VX_DF_IMAGE_IYUV:
+        return ((dst == VX_DF_IMAGE_RGB) || (dst == VX_DF_IMAGE_RGBX) || (dst == VX_DF_IMAGE_NV12) ||
+                    (dst == VX_DF_IMAGE_IYUV) || (dst == VX_DF_IMAGE_YUV4)) && (src != dst) ? vx_true_e : vx_false_e;
+    case VX_DF_IMAGE_UYVY:
+    case VX_DF_IMAGE_YUYV:
+        return ((dst == VX_DF_IMAGE_RGB) || (dst == VX_DF_IMAGE_RGBX) || (dst == VX_DF_IMAGE_NV12) ||
+                    (dst == VX_DF_IMAGE_IYUV)) ? vx_true_e : vx_false_e;
+    default:
+        return vx_false_e;
+    }
+}
+
+static inline void convertRgbToYuv(const vx_int32 rgb[3], vx_int32 yuv[3])
+{
+    vx_int32 r = rgb[0], g = rgb[1], b = rgb[2];
+
+    yuv[0] = (CPU_CSC(0.2126) * r + CPU_CSC(0.7152) * g + CPU_CSC(0.0722) * b + CPU_CSC_ROUND) >> CPU_CSC_SHIFT;
+    yuv[1] = ((-CPU_CSC(0.1146) * r - CPU_CSC(0.3854) * g + CPU_CSC(0.5) * b + CPU_CSC_ROUND) >> CPU_CSC_SHIFT) + 128;
+    yuv[2] = ((CPU_CSC(0.5) * r - CPU_CSC(0.4542) * g - CPU_CSC(0.0458) * b + CPU_CSC_ROUND) >> CPU_CSC_SHIFT) + 128;
+
+    for (vx_uint32 c = 0; c < 3; c++)
+        yuv[c] = cpuSaturateU8(yuv[c]);
+}
+
+static inline void convertYuvToRgb(const vx_int32 yuv[3], vx_int32 rgb[3])
+{
+    vx_int32 y = yuv[0] << CPU_CSC_SHIFT, u = yuv[1] - 128, v = yuv[2] - 128;
+
+    rgb[0] = cpuSaturateU8((y + CPU_CSC(1.5748) * v + CPU_CSC_ROUND) >> CPU_CSC_SHIFT);
+    rgb[1] = cpuSaturateU8((y - CPU_CSC(0.1873) * u - CPU_CSC(0.4681) * v + CPU_CSC_ROUND) >> CPU_CSC_SHIFT);
+    rgb[2] = cpuSaturateU8((y + CPU_CSC(1.8556) * u + CPU_CSC_ROUND) >> CPU_CSC_SHIFT);
+}
+
+/* reads a pixel in rgb or yuv color space, following the destination */
+static void readPixel(const struct cpu_image_t *img, vx_uint32 x, vx_uint32 y, vx_bool want_rgb, vx_int32 pixel[3])
+{
+    vx_int32 value[3];
+    const vx_uint8 *row = CPU_IMAGE_ROW(img, 0, vx_uint8, y);
+
+    switch (img->format) {
+    case VX_DF_IMAGE_RGB:
+        value[0] = row[x * 3 + 0];
+        value[1] = row[x * 3 + 1];
+        value[2] = row[x * 3 + 2];
+        break;
+    case VX_DF_IMAGE_RGBX:
+        value[0] = row[x * 4 + 0];
+        value[1] = row[x * 4 + 1];
+        value[2] = row[x * 4 + 2];
+        break;
+    case VX_DF_IMAGE_NV12:
+    case VX_DF_IMAGE_NV21: {
+        const vx_uint8 *uv = CPU_IMAGE_ROW(img, 1, vx_uint8, y / 2) + (x / 2) * 2;
+        vx_uint32 u_index = (img->format == VX_DF_IMAGE_NV12) ? 0 : 1;
+        value[0] = row[x];
+        value[1] = uv[u_index];
+        value[2] = uv[1 - u_index];
+        break;
+    }
+    case VX_DF_IMAGE_IYUV:
+        value[0] = row[x];
+        value[1] = CPU_IMAGE_ROW(img, 1, vx_uint8, y / 2)[x / 2];
+        value[2] = CPU_IMAGE_ROW(img, 2, vx_uint8, y / 2)[x / 2];
+        break;
+    case VX_DF_IMAGE_UYVY:
+        value[0] = row[x * 2 + 1];
+        value[1] = row[(x / 2) * 4 + 0];
+        value[2] = row[(x / 2) * 4 + 2];
+        break;
+    case VX_DF_IMAGE_YUYV:
+    default:
+        value[0] = row[x * 2];
+        value[1] = row[(x / 2) * 4 + 1];
+        value[2] = row[(x / 2) * 4 + 3];
+        break;
+    }
+
+    if (isRgbFormat(img->format) == want_rgb) {
+        pixel[0] = value[0];
+        pixel[1] = value[1];
+        pixel[2] = value[2];
+    } else if (want_rgb) {
+        convertYuvToRgb(value, pixel);
+    } else {
+        convertRgbToYuv(value, pixel);
+    }
+}
+
+/* each unit of tile is a pair of rows, as chroma of 4:2:0 formats is shared by two rows */
+static void colorConvTile(void *arg, vx_uint32 start_pair, vx_uint32 end_pair)
+{
+    struct colorconv_tile_t *tile = (struct colorconv_tile_t*)arg;
+    struct cpu_image_t *out = &tile->out;
+    vx_bool want_rgb = isRgbFormat(out->format);
+    vx_uint32 width = out->width;
+    vx_uint32 end_y = (end_pair * 2 < out->height) ? end_pair * 2 : out->height;
+    vx_int32 pixel[2][2][3];
+
+    for (vx_uint32 y = start_pair * 2; y < end_y; y += 2) {
+        vx_uint32 rows = (y + 1 < end_y) ? 2 : 1;
+
+        for (vx_uint32 x = 0; x < width; x += 2) {
+            vx_uint32 cols = (x + 1 < width) ? 2 : 1;
+            vx_int32 u_sum = 0, v_sum = 0;
+
+            for (vx_uint32 j = 0; j < rows; j++) {
+                for (vx_uint32 i = 0; i < cols; i++) {
+                    vx_int32 *p = pixel[j][i];
+                    readPixel(&tile->in, x + i, y + j, want_rgb, p);
+                    u_sum += p[1];
+                    v_sum += p[2];
+
+                    switch (out->format) {
+                    case VX_DF_IMAGE_RGB: {
+                        vx_uint8 *dst = CPU_IMAGE_ROW(out, 0, vx_uint8, y + j) + (x + i) * 3;
+                        dst[0] = p[0];
+                        dst[1] = p[1];
+                        dst[2] = p[2];
+                        break;
+                    }
+                    case VX_DF_IMAGE_RGBX: {
+                        vx_uint8 *dst = CPU_IMAGE_ROW(out, 0, vx_uint8, y + j) + (x + i) * 4;
+                        dst[0] = p[0];
+                        dst[1] = p[1];
+                        dst[2] = p[2];
+                        dst[3] = 255;
+                        break;
+                    }
+                    case VX_DF_IMAGE_YUV4:
+                        CPU_IMAGE_ROW(out, 0, vx_uint8, y + j)[x + i] = p[0];
+                        CPU_IMAGE_ROW(out, 1, vx_uint8, y + j)[x + i] = p[1];
+                        CPU_IMAGE_ROW(out, 2, vx_uint8, y + j)[x + i] = p[2];
+                        break;
+                    default:
+                        CPU_IMAGE_ROW(out, 0, vx_uint8, y + j)[x + i] = p[0];
+                        break;
+                    }
+                }
+            }
+
+            /* subsampled chroma is the average of the block */
+            vx_uint32 count = rows * cols;
+            vx_uint8 u = (vx_uint8)((u_sum + count / 2) / count);
+            vx_uint8 v = (vx_uint8)((v_sum + count / 2) / count);
+            if (out->format == VX_DF_IMAGE_NV12) {
+                vx_uint8 *uv = CPU_IMAGE_ROW(out, 1, vx_uint8, y / 2) + x;
+                uv[0] = u;
+                uv[1] = v;
+            } else if (out->format == VX_DF_IMAGE_IYUV) {
+                CPU_IMAGE_ROW(out, 1, vx_uint8, y / 2)[x / 2] = u;
+                CPU_IMAGE_ROW(out, 2, vx_uint8, y / 2)[x / 2] = v;
+            }
+        }
+    }
+}
+
+static vx_status vxColorConvKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status;
+    struct colorconv_tile_t tile;
+
+    if ((node == NULL) || (num != 2)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &tile.in);
+    status |= cpuAccessImage((vx_image)parameters[1], VX_WRITE_ONLY, &tile.out);
+    if ((status == VX_SUCCESS) && (isSupportedConversion(tile.in.format, tile.out.format) == vx_false_e)) {
+        VXLOGE("conversion from 0x%x to 0x%x is not supported", tile.in.format, tile.out.format);
+        status = VX_ERROR_NOT_SUPPORTED;
+    }
+
+    if (status == VX_SUCCESS)
+        cpuProcessTiles((tile.out.height + 1) / 2, colorConvTile, &tile);
+    else
+        VXLOGE("color conversion fails, err:%d", status);
+
+    status |= cpuCommitImage(&tile.in);
+    status |= cpuCommitImage(&tile.out);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxColorConvInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+    vx_df_image format;
+
+    if ((index == 0) && (cpuQueryImageParam(node, index, &width, &height, &format) == VX_SUCCESS)) {
+        if (isSupportedConversion(format, VX_DF_IMAGE_RGB) || isSupportedConversion(format, VX_DF_IMAGE_NV12)) {
+            /* chroma subsampled formats need even size */
+            if ((isRgbFormat(format) == vx_false_e) && ((width & 1) || (height & 1)))
+                status = VX_ERROR_INVALID_DIMENSION;
+            else
+                status = VX_SUCCESS;
+        }
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxColorConvOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+    vx_df_image src_format, dst_format = VX_DF_IMAGE_VIRT;
+
+    if ((index == 1) &&
+        (cpuQueryImageParam(node, 0, &width, &height, &src_format) == VX_SUCCESS) &&
+        (cpuQueryImageParam(node, 1, NULL, NULL, &dst_format) == VX_SUCCESS)) {
+        /* destination format can't be inferred, it should be given by user */
+        if (isSupportedConversion(src_format, dst_format)) {
+            cpuSetImageMeta(meta, width, height, dst_format);
+            status = VX_SUCCESS;
+        }
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t colorconv_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t colorconv_cpu_kernel = {
+    VX_KERNEL_COLOR_CONVERT,
+    "org.khronos.openvx.color_convert",
+    vxColorConvKernel,
+    colorconv_kernel_params, dimof(colorconv_kernel_params),
+    vxColorConvInputValidator,
+    vxColorConvOutputValidator,
+    NULL,
+    NULL,
+};
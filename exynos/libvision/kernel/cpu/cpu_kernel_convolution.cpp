@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+#define CONVOLUTION_MAX_DIM     (CPU_KERNEL_MAX_RADIUS * 2 + 1)
+
+struct convolution_tile_t {
+    vx_border_mode_t border;
+    struct cpu_image_t in;
+    struct cpu_image_t out;
+    vx_uint32 radius;
+    vx_size conv_cols;
+    vx_size conv_rows;
+    vx_uint32 scale;
+    /* coefficients flipped to correlation order, indexed [row][col] */
+    vx_int16 coeff[CONVOLUTION_MAX_DIM * CONVOLUTION_MAX_DIM];
+};
+
+#if (CPU_KERNEL_NEON==1)
+/* accumulates 8 output pixels of one kernel tap row into the 32-bit sums */
+static inline void accumulateNeon(const vx_uint8 *src, const vx_int16 *coeff, vx_size cols,
+                                        int32x4_t *sum_lo, int32x4_t *sum_hi)
+{
+    for (vx_size j = 0; j < cols; j++) {
+        int16x8_t pixel = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src + j)));
+        *sum_lo = vmlal_n_s16(*sum_lo, vget_low_s16(pixel), coeff[j]);
+        *sum_hi = vmlal_n_s16(*sum_hi, vget_high_s16(pixel), coeff[j]);
+    }
+}
+#endif
+
+static void convolutionTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct convolution_tile_t *tile = (struct convolution_tile_t*)arg;
+    vx_uint32 width = tile->in.width;
+    vx_uint32 radius = tile->radius;
+    vx_int32 off_x = (vx_int32)(tile->conv_cols / 2);
+    vx_uint32 row_base = radius - (vx_uint32)(tile->conv_rows / 2);
+    vx_uint8 *rows[CONVOLUTION_MAX_DIM];
+    vx_uint8 *buf;
+
+    buf = (vx_uint8*)malloc((width + radius * 2) * (radius * 2 + 1));
+    if (buf == NULL) {
+        VXLOGE("allocating row buffer fails");
+        return;
+    }
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        vx_uint32 x = 0;
+
+        cpuLoadBorderedRowsU8(&tile->in, y, radius, &tile->border, buf, rows);
+
+#if (CPU_KERNEL_NEON==1)
+        /* taps are accumulated in vector, the division keeps the truncation of the scalar path */
+        for (; x + 8 <= width; x += 8) {
+            int32x4_t sum_lo = vdupq_n_s32(0);
+            int32x4_t sum_hi = vdupq_n_s32(0);
+            vx_int32 sum[8];
+
+            for (vx_size i = 0; i < tile->conv_rows; i++)
+                accumulateNeon(rows[row_base + i] + x - off_x, &tile->coeff[i * tile->conv_cols], tile->conv_cols, &sum_lo, &sum_hi);
+
+            vst1q_s32(sum, sum_lo);
+            vst1q_s32(sum + 4, sum_hi);
+            for (vx_uint32 k = 0; k < 8; k++) {
+                vx_int32 value = sum[k] / (vx_int32)tile->scale;
+                if (tile->out.format == VX_DF_IMAGE_U8)
+                    CPU_IMAGE_ROW(&tile->out, 0, vx_uint8, y)[x + k] = cpuSaturateU8(value);
+                else
+                    CPU_IMAGE_ROW(&tile->out, 0, vx_int16, y)[x + k] = cpuSaturateS16(value);
+            }
+        }
+#endif
+        for (; x < width; x++) {
+            vx_int32 sum = 0;
+
+            for (vx_size i = 0; i < tile->conv_rows; i++) {
+                const vx_uint8 *src = rows[row_base + i] + x - off_x;
+                const vx_int16 *coeff = &tile->coeff[i * tile->conv_cols];
+
+                for (vx_size j = 0; j < tile->conv_cols; j++)
+                    sum += (vx_int32)src[j] * coeff[j];
+            }
+
+            sum /= (vx_int32)tile->scale;
+            if (tile->out.format == VX_DF_IMAGE_U8)
+                CPU_IMAGE_ROW(&tile->out, 0, vx_uint8, y)[x] = cpuSaturateU8(sum);
+            else
+                CPU_IMAGE_ROW(&tile->out, 0, vx_int16, y)[x] = cpuSaturateS16(sum);
+        }
+    }
+
+    free(buf);
+}
+
+static vx_status readConvolution(vx_convolution conv, struct convolution_tile_t *tile)
+{
+    vx_status status;
+    vx_int16 coeff[CONVOLUTION_MAX_DIM * CONVOLUTION_MAX_DIM];
+
+    status = vxQueryConvolution(conv, VX_CONVOLUTION_ATTRIBUTE_COLUMNS, &tile->conv_cols, sizeof(tile->conv_cols));
+    status |= vxQueryConvolution(conv, VX_CONVOLUTION_ATTRIBUTE_ROWS, &tile->conv_rows, sizeof(tile->conv_rows));
+    status |= vxQueryConvolution(conv, VX_CONVOLUTION_ATTRIBUTE_SCALE, &tile->scale, sizeof(tile->scale));
+    if (status != VX_SUCCESS) {
+        VXLOGE("querying convolution fails, err:%d", status);
+        return status;
+    }
+
+    if ((tile->conv_cols > CONVOLUTION_MAX_DIM) || (tile->conv_rows > CONVOLUTION_MAX_DIM) || (tile->scale == 0)) {
+        VXLOGE("convolution is not supported, %dx%d, scale:%d", (vx_uint32)tile->conv_cols, (vx_uint32)tile->conv_rows, tile->scale);
+        return VX_ERROR_NOT_SUPPORTED;
+    }
+
+    status = vxReadConvolutionCoefficients(conv, coeff);
+    if (status != VX_SUCCESS) {
+        VXLOGE("reading coefficients fails, err:%d", status);
+        return status;
+    }
+
+    /* the convolution is a true convolution, flipping the matrix makes it a plain correlation */
+    vx_size size = tile->conv_cols * tile->conv_rows;
+    for (vx_size i = 0; i < size; i++)
+        tile->coeff[i] = coeff[size - 1 - i];
+
+    tile->radius = (vx_uint32)((tile->conv_cols > tile->conv_rows ? tile->conv_cols : tile->conv_rows) / 2);
+
+    return VX_SUCCESS;
+}
+
+static vx_status vxConvolveKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status;
+    struct convolution_tile_t tile;
+
+    if ((node == NULL) || (num != 3)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    memset(&tile, 0x0, sizeof(tile));
+    cpuGetBorderMode(node, &tile.border);
+
+    status = readConvolution((vx_convolution)parameters[1], &tile);
+    if (status != VX_SUCCESS)
+        return status;
+
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &tile.in);
+    status |= cpuAccessImage((vx_image)parameters[2], VX_WRITE_ONLY, &tile.out);
+    if (status == VX_SUCCESS)
+        cpuProcessTiles(tile.out.height, convolutionTile, &tile);
+    else
+        VXLOGE("accessing images fails, err:%d", status);
+
+    status |= cpuCommitImage(&tile.in);
+    status |= cpuCommitImage(&tile.out);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxConvolveInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    if (index == 0) {
+        vx_df_image format;
+        if ((cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+            status = VX_SUCCESS;
+    } else if (index == 1) {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_convolution conv = NULL;
+        vx_size cols = 0, rows = 0;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &conv, sizeof(conv));
+            if (conv) {
+                vxQueryConvolution(conv, VX_CONVOLUTION_ATTRIBUTE_COLUMNS, &cols, sizeof(cols));
+                vxQueryConvolution(conv, VX_CONVOLUTION_ATTRIBUTE_ROWS, &rows, sizeof(rows));
+                if ((cols <= CONVOLUTION_MAX_DIM) && (rows <= CONVOLUTION_MAX_DIM) && (cols & 0x1) && (rows & 0x1))
+                    status = VX_SUCCESS;
+                vxReleaseConvolution(&conv);
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxConvolveOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+    vx_df_image format;
+
+    if (index == 2) {
+        status = cpuQueryImageParam(node, 0, &width, &height, NULL);
+        if ((status == VX_SUCCESS) && (cpuQueryImageParam(node, 2, NULL, NULL, &format) == VX_SUCCESS) &&
+                ((format == VX_DF_IMAGE_U8) || (format == VX_DF_IMAGE_S16)))
+            cpuSetImageMeta(meta, width, height, format);
+        else if (status == VX_SUCCESS)
+            cpuSetImageMeta(meta, width, height, VX_DF_IMAGE_S16);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t convolution_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_CONVOLUTION, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t convolution_cpu_kernel = {
+    VX_KERNEL_CUSTOM_CONVOLUTION,
+    "org.khronos.openvx.custom_convolution",
+    vxConvolveKernel,
+    convolution_kernel_params, dimof(convolution_kernel_params),
+    vxConvolveInputValidator,
+    vxConvolveOutputValidator,
+    NULL,
+    NULL,
+};
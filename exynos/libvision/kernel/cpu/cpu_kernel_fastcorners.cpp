@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+#define FAST_CIRCLE_NUM     16
+#define FAST_ARC_LENGTH     9
+#define FAST_RADIUS         3
+
+static const vx_int32 fast_circle[FAST_CIRCLE_NUM][2] = {
+    {0, -3}, {1, -3}, {2, -2}, {3, -1}, {3, 0}, {3, 1}, {2, 2}, {1, 3},
+    {0, 3}, {-1, 3}, {-2, 2}, {-3, 1}, {-3, 0}, {-3, -1}, {-2, -2}, {-1, -3},
+};
+
+struct fast_tile_t {
+    struct cpu_image_t in;
+    vx_uint8 threshold;
+    vx_bool nonmax;
+    /* strength of every pixel, 0 for the pixel not being a corner */
+    vx_uint8 *strength;
+};
+
+static vx_bool isCorner(const vx_uint8 *circle, vx_int32 center, vx_int32 threshold)
+{
+    vx_uint32 bright = 0, dark = 0;
+
+    /* walks the circle twice to find the contiguous arc across the start point */
+    for (vx_uint32 i = 0; i < FAST_CIRCLE_NUM + FAST_ARC_LENGTH - 1; i++) {
+        vx_int32 value = circle[i % FAST_CIRCLE_NUM];
+
+        bright = (value > center + threshold) ? bright + 1 : 0;
+        dark = (value < center - threshold) ? dark + 1 : 0;
+        if ((bright >= FAST_ARC_LENGTH) || (dark >= FAST_ARC_LENGTH))
+            return vx_true_e;
+    }
+
+    return vx_false_e;
+}
+
+static void fastTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct fast_tile_t *tile = (struct fast_tile_t*)arg;
+    vx_uint32 width = tile->in.width;
+    vx_uint32 height = tile->in.height;
+    vx_uint8 circle[FAST_CIRCLE_NUM];
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        vx_uint8 *dst = tile->strength + (vx_size)y * width;
+
+        memset(dst, 0x0, width);
+        if ((y < FAST_RADIUS) || (y + FAST_RADIUS >= height))
+            continue;
+
+        const vx_uint8 *src = CPU_IMAGE_ROW(&tile->in, 0, vx_uint8, y);
+        for (vx_uint32 x = FAST_RADIUS; x + FAST_RADIUS < width; x++) {
+            vx_int32 center = src[x];
+
+            for (vx_uint32 i = 0; i < FAST_CIRCLE_NUM; i++)
+                circle[i] = CPU_IMAGE_ROW(&tile->in, 0, vx_uint8, (vx_int32)y + fast_circle[i][1])[(vx_int32)x + fast_circle[i][0]];
+
+            if (!isCorner(circle, center, tile->threshold))
+                continue;
+
+            if (!tile->nonmax) {
+                dst[x] = 1;
+                continue;
+            }
+
+            /* the strength is the largest threshold keeping the pixel a corner */
+            vx_int32 low = tile->threshold, high = 255;
+            while (low < high) {
+                vx_int32 mid = (low + high + 1) / 2;
+                if (isCorner(circle, center, mid))
+                    low = mid;
+                else
+                    high = mid - 1;
+            }
+            dst[x] = (vx_uint8)((low > 0) ? low : 1);
+        }
+    }
+}
+
+static vx_status vxFastCornersKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status;
+    struct fast_tile_t tile;
+    vx_float32 strength_thresh = 0;
+    vx_bool nonmax = vx_false_e;
+    vx_array corners;
+    vx_size capacity = 0, count = 0, found = 0;
+    vx_keypoint_t *keypoints = NULL;
+
+    if ((node == NULL) || (num != 5)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    status = vxReadScalarValue((vx_scalar)parameters[1], &strength_thresh);
+    status |= vxReadScalarValue((vx_scalar)parameters[2], &nonmax);
+    if (status != VX_SUCCESS) {
+        VXLOGE("reading scalars fails, err:%d", status);
+        return status;
+    }
+
+    corners = (vx_array)parameters[3];
+    vxQueryArray(corners, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity));
+
+    memset(&tile, 0x0, sizeof(tile));
+    tile.threshold = cpuSaturateU8((vx_int32)strength_thresh);
+    tile.nonmax = nonmax;
+
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &tile.in);
+    if (status != VX_SUCCESS) {
+        VXLOGE("accessing image fails, err:%d", status);
+        goto EXIT;
+    }
+
+    tile.strength = (vx_uint8*)malloc((vx_size)tile.in.width * tile.in.height);
+    keypoints = (vx_keypoint_t*)malloc(capacity * sizeof(vx_keypoint_t));
+    if ((tile.strength == NULL) || ((capacity != 0) && (keypoints == NULL))) {
+        VXLOGE("allocating buffers fails");
+        status = VX_ERROR_NO_MEMORY;
+        goto EXIT;
+    }
+
+    cpuProcessTiles(tile.in.height, fastTile, &tile);
+
+    for (vx_uint32 y = FAST_RADIUS; y + FAST_RADIUS < tile.in.height; y++) {
+        for (vx_uint32 x = FAST_RADIUS; x + FAST_RADIUS < tile.in.width; x++) {
+            vx_uint8 value = tile.strength[(vx_size)y * tile.in.width + x];
+            vx_bool suppressed = vx_false_e;
+
+            if (value == 0)
+                continue;
+
+            if (nonmax) {
+                for (vx_int32 j = -1; (j <= 1) && !suppressed; j++) {
+                    const vx_uint8 *row = tile.strength + (vx_size)((vx_int32)y + j) * tile.in.width;
+                    for (vx_int32 i = -1; i <= 1; i++) {
+                        if (row[(vx_int32)x + i] > value) {
+                            suppressed = vx_true_e;
+                            break;
+                        }
+                    }
+                }
+                if (suppressed)
+                    continue;
+            }
+
+            if (count < capacity) {
+                keypoints[count].x = (vx_int32)x;
+                keypoints[count].y = (vx_int32)y;
+                keypoints[count].strength = nonmax ? (vx_float32)value : strength_thresh;
+                keypoints[count].scale = 0;
+                keypoints[count].orientation = 0;
+                keypoints[count].tracking_status = 1;
+                keypoints[count].error = 0;
+                count++;
+            }
+            found++;
+        }
+    }
+
+    status = vxTruncateArray(corners, 0);
+    if ((status == VX_SUCCESS) && (count != 0))
+        status = vxAddArrayItems(corners, count, keypoints, sizeof(vx_keypoint_t));
+    if ((status == VX_SUCCESS) && parameters[4])
+        status = vxWriteScalarValue((vx_scalar)parameters[4], &found);
+
+EXIT:
+    if (tile.strength)
+        free(tile.strength);
+    if (keypoints)
+        free(keypoints);
+
+    status |= cpuCommitImage(&tile.in);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxFastCornersInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_enum type = VX_TYPE_INVALID;
+
+    if (index == 0) {
+        vx_df_image format;
+        if ((cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+            status = VX_SUCCESS;
+    } else if (index == 1) {
+        vx_float32 strength = 0;
+        if ((cpuQueryScalarParam(node, index, &type, &strength) == VX_SUCCESS) && (type == VX_TYPE_FLOAT32) &&
+                (strength > 0) && (strength < 256))
+            status = VX_SUCCESS;
+    } else if (index == 2) {
+        vx_bool nonmax = vx_false_e;
+        if ((cpuQueryScalarParam(node, index, &type, &nonmax) == VX_SUCCESS) && (type == VX_TYPE_BOOL))
+            status = VX_SUCCESS;
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxFastCornersOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    if (index == 3) {
+        vx_enum item_type = VX_TYPE_KEYPOINT;
+        vx_size capacity = 0;
+        vxSetMetaFormatAttribute(meta, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &item_type, sizeof(item_type));
+        vxSetMetaFormatAttribute(meta, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity));
+        status = VX_SUCCESS;
+    } else if (index == 4) {
+        vx_enum scalar_type = VX_TYPE_SIZE;
+        vxSetMetaFormatAttribute(meta, VX_SCALAR_ATTRIBUTE_TYPE, &scalar_type, sizeof(scalar_type));
+        status = VX_SUCCESS;
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t fast_corners_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL},
+};
+
+vx_kernel_description_t fastcorners_cpu_kernel = {
+    VX_KERNEL_FAST_CORNERS,
+    "org.khronos.openvx.fast_corners",
+    vxFastCornersKernel,
+    fast_corners_kernel_params, dimof(fast_corners_kernel_params),
+    vxFastCornersInputValidator,
+    vxFastCornersOutputValidator,
+    NULL,
+    NULL,
+};
@@ -0,0 +1,396 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <stdlib.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+struct filter_tile_t {
+    vx_enum kernel;
+    vx_border_mode_t border;
+    struct cpu_image_t in;
+    struct cpu_image_t out;
+};
+
+/* sorts a pair so that the first one is smaller */
+#define SORT_PAIR(type, a, b, min_op, max_op) \
+    do { type tmp = min_op(a, b); b = max_op(a, b); a = tmp; } while (0)
+
+#define SCALAR_MIN(a, b)    (((a) < (b)) ? (a) : (b))
+#define SCALAR_MAX(a, b)    (((a) > (b)) ? (a) : (b))
+
+/* median of 9 by the sorting network of 19 exchanges, the median ends up at p[4] */
+#define MEDIAN9(type, p, min_op, max_op) \
+    do { \
+        SORT_PAIR(type, p[1], p[2], min_op, max_op); SORT_PAIR(type, p[4], p[5], min_op, max_op); SORT_PAIR(type, p[7], p[8], min_op, max_op); \
+        SORT_PAIR(type, p[0], p[1], min_op, max_op); SORT_PAIR(type, p[3], p[4], min_op, max_op); SORT_PAIR(type, p[6], p[7], min_op, max_op); \
+        SORT_PAIR(type, p[1], p[2], min_op, max_op); SORT_PAIR(type, p[4], p[5], min_op, max_op); SORT_PAIR(type, p[7], p[8], min_op, max_op); \
+        SORT_PAIR(type, p[0], p[3], min_op, max_op); SORT_PAIR(type, p[5], p[8], min_op, max_op); SORT_PAIR(type, p[4], p[7], min_op, max_op); \
+        SORT_PAIR(type, p[3], p[6], min_op, max_op); SORT_PAIR(type, p[1], p[4], min_op, max_op); SORT_PAIR(type, p[2], p[5], min_op, max_op); \
+        SORT_PAIR(type, p[4], p[7], min_op, max_op); SORT_PAIR(type, p[4], p[2], min_op, max_op); SORT_PAIR(type, p[6], p[4], min_op, max_op); \
+        SORT_PAIR(type, p[4], p[2], min_op, max_op); \
+    } while (0)
+
+static vx_uint8 filterPixel(vx_enum kernel, vx_uint8 **rows, vx_uint32 x)
+{
+    vx_uint8 p[9];
+    vx_uint32 sum = 0;
+    vx_uint8 result;
+
+    for (vx_uint32 j = 0; j < 3; j++) {
+        const vx_uint8 *src = rows[j] + x - 1;
+        p[j * 3 + 0] = src[0];
+        p[j * 3 + 1] = src[1];
+        p[j * 3 + 2] = src[2];
+    }
+
+    switch (kernel) {
+    case VX_KERNEL_BOX_3x3:
+        for (vx_uint32 i = 0; i < 9; i++)
+            sum += p[i];
+        result = (vx_uint8)(sum / 9);
+        break;
+    case VX_KERNEL_GAUSSIAN_3x3:
+        sum = p[0] + 2 * p[1] + p[2] + 2 * p[3] + 4 * p[4] + 2 * p[5] + p[6] + 2 * p[7] + p[8];
+        result = (vx_uint8)(sum >> 4);
+        break;
+    case VX_KERNEL_MEDIAN_3x3: {
+        MEDIAN9(vx_uint8, p, SCALAR_MIN, SCALAR_MAX);
+        result = p[4];
+        break;
+    }
+    case VX_KERNEL_DILATE_3x3:
+        result = p[0];
+        for (vx_uint32 i = 1; i < 9; i++)
+            result = SCALAR_MAX(result, p[i]);
+        break;
+    case VX_KERNEL_ERODE_3x3:
+    default:
+        result = p[0];
+        for (vx_uint32 i = 1; i < 9; i++)
+            result = SCALAR_MIN(result, p[i]);
+        break;
+    }
+
+    return result;
+}
+
+#if (CPU_KERNEL_NEON==1)
+static vx_uint32 filterRowNeon(vx_enum kernel, vx_uint8 **rows, vx_uint8 *dst, vx_uint32 width)
+{
+    vx_uint32 x = 0;
+
+    /* rows are padded by a pixel, so the neighbours of the first and last pixel are readable */
+    for (; x + 8 <= width; x += 8) {
+        uint8x8_t p[9];
+        uint8x8_t result;
+
+        for (vx_uint32 j = 0; j < 3; j++) {
+            p[j * 3 + 0] = vld1_u8(rows[j] + x - 1);
+            p[j * 3 + 1] = vld1_u8(rows[j] + x);
+            p[j * 3 + 2] = vld1_u8(rows[j] + x + 1);
+        }
+
+        switch (kernel) {
+        case VX_KERNEL_BOX_3x3: {
+            uint16x8_t sum = vaddl_u8(p[0], p[1]);
+            for (vx_uint32 i = 2; i < 9; i++)
+                sum = vaddw_u8(sum, p[i]);
+            /* sum / 9 is exact as (sum * 58255) >> 19 for sum <= 9 * 255 */
+            uint32x4_t lo = vshrq_n_u32(vmull_n_u16(vget_low_u16(sum), 58255), 19);
+            uint32x4_t hi = vshrq_n_u32(vmull_n_u16(vget_high_u16(sum), 58255), 19);
+            result = vmovn_u16(vcombine_u16(vmovn_u32(lo), vmovn_u32(hi)));
+            break;
+        }
+        case VX_KERNEL_GAUSSIAN_3x3: {
+            uint16x8_t corner = vaddq_u16(vaddl_u8(p[0], p[2]), vaddl_u8(p[6], p[8]));
+            uint16x8_t edge = vaddq_u16(vaddl_u8(p[1], p[3]), vaddl_u8(p[5], p[7]));
+            uint16x8_t sum = vaddq_u16(corner, vshlq_n_u16(edge, 1));
+            sum = vaddq_u16(sum, vshll_n_u8(p[4], 2));
+            result = vshrn_n_u16(sum, 4);
+            break;
+        }
+        case VX_KERNEL_MEDIAN_3x3: {
+            MEDIAN9(uint8x8_t, p, vmin_u8, vmax_u8);
+            result = p[4];
+            break;
+        }
+        case VX_KERNEL_DILATE_3x3:
+            result = p[0];
+            for (vx_uint32 i = 1; i < 9; i++)
+                result = vmax_u8(result, p[i]);
+            break;
+        case VX_KERNEL_ERODE_3x3:
+        default:
+            result = p[0];
+            for (vx_uint32 i = 1; i < 9; i++)
+                result = vmin_u8(result, p[i]);
+            break;
+        }
+
+        vst1_u8(dst + x, result);
+    }
+
+    return x;
+}
+#endif
+
+static void filterTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct filter_tile_t *tile = (struct filter_tile_t*)arg;
+    vx_uint32 width = tile->out.width;
+    vx_uint8 *rows[3];
+    vx_uint8 *buf;
+
+    buf = (vx_uint8*)malloc((width + 2) * 3);
+    if (buf == NULL) {
+        VXLOGE("allocating row buffer fails");
+        return;
+    }
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        vx_uint8 *dst = CPU_IMAGE_ROW(&tile->out, 0, vx_uint8, y);
+        vx_uint32 x = 0;
+
+        cpuLoadBorderedRowsU8(&tile->in, y, 1, &tile->border, buf, rows);
+#if (CPU_KERNEL_NEON==1)
+        x = filterRowNeon(tile->kernel, rows, dst, width);
+#endif
+        for (; x < width; x++)
+            dst[x] = filterPixel(tile->kernel, rows, x);
+    }
+
+    free(buf);
+}
+
+static vx_status processFilter(vx_enum kernel, vx_node node, const vx_reference parameters[], vx_uint32 num,
+                                    vx_uint32 start_y, vx_uint32 end_y)
+{
+    vx_status status;
+    struct filter_tile_t tile;
+
+    if ((node == NULL) || (num != 2)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    tile.kernel = kernel;
+    cpuGetBorderMode(node, &tile.border);
+
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &tile.in);
+    status |= cpuAccessImage((vx_image)parameters[1], VX_WRITE_ONLY, &tile.out);
+    if (status == VX_SUCCESS)
+        cpuProcessTileRange(start_y, end_y, tile.out.height, filterTile, &tile);
+    else
+        VXLOGE("accessing images fails, err:%d", status);
+
+    status |= cpuCommitImage(&tile.in);
+    status |= cpuCommitImage(&tile.out);
+
+    return status;
+}
+
+static vx_status vxBox3x3Kernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = processFilter(VX_KERNEL_BOX_3x3, node, parameters, num, 0, CPU_KERNEL_ALL_ROWS);
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxGaussian3x3Kernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = processFilter(VX_KERNEL_GAUSSIAN_3x3, node, parameters, num, 0, CPU_KERNEL_ALL_ROWS);
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxMedian3x3Kernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = processFilter(VX_KERNEL_MEDIAN_3x3, node, parameters, num, 0, CPU_KERNEL_ALL_ROWS);
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxDilate3x3Kernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = processFilter(VX_KERNEL_DILATE_3x3, node, parameters, num, 0, CPU_KERNEL_ALL_ROWS);
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxErode3x3Kernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = processFilter(VX_KERNEL_ERODE_3x3, node, parameters, num, 0, CPU_KERNEL_ALL_ROWS);
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxBox3x3Tile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return processFilter(VX_KERNEL_BOX_3x3, node, parameters, num, start_y, end_y);
+}
+
+static vx_status vxGaussian3x3Tile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return processFilter(VX_KERNEL_GAUSSIAN_3x3, node, parameters, num, start_y, end_y);
+}
+
+static vx_status vxMedian3x3Tile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return processFilter(VX_KERNEL_MEDIAN_3x3, node, parameters, num, start_y, end_y);
+}
+
+static vx_status vxDilate3x3Tile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return processFilter(VX_KERNEL_DILATE_3x3, node, parameters, num, start_y, end_y);
+}
+
+static vx_status vxErode3x3Tile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return processFilter(VX_KERNEL_ERODE_3x3, node, parameters, num, start_y, end_y);
+}
+
+static vx_status vxFilterInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format;
+
+    if ((index == 0) && (cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+        status = VX_SUCCESS;
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxFilterOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+
+    if (index == 1) {
+        status = cpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            cpuSetImageMeta(meta, width, height, VX_DF_IMAGE_U8);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t filter_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t box3x3_cpu_kernel = {
+    VX_KERNEL_BOX_3x3,
+    "org.khronos.openvx.box_3x3",
+    vxBox3x3Kernel,
+    filter_kernel_params, dimof(filter_kernel_params),
+    vxFilterInputValidator,
+    vxFilterOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t gaussian3x3_cpu_kernel = {
+    VX_KERNEL_GAUSSIAN_3x3,
+    "org.khronos.openvx.gaussian_3x3",
+    vxGaussian3x3Kernel,
+    filter_kernel_params, dimof(filter_kernel_params),
+    vxFilterInputValidator,
+    vxFilterOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t median3x3_cpu_kernel = {
+    VX_KERNEL_MEDIAN_3x3,
+    "org.khronos.openvx.median_3x3",
+    vxMedian3x3Kernel,
+    filter_kernel_params, dimof(filter_kernel_params),
+    vxFilterInputValidator,
+    vxFilterOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t dilate3x3_cpu_kernel = {
+    VX_KERNEL_DILATE_3x3,
+    "org.khronos.openvx.dilate_3x3",
+    vxDilate3x3Kernel,
+    filter_kernel_params, dimof(filter_kernel_params),
+    vxFilterInputValidator,
+    vxFilterOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t erode3x3_cpu_kernel = {
+    VX_KERNEL_ERODE_3x3,
+    "org.khronos.openvx.erode_3x3",
+    vxErode3x3Kernel,
+    filter_kernel_params, dimof(filter_kernel_params),
+    vxFilterInputValidator,
+    vxFilterOutputValidator,
+    NULL,
+    NULL,
+};
+
+/* 3x3 filters read one row above and below of the output rows */
+vx_kernel_tile_t box3x3_cpu_tile = {
+    vxBox3x3Tile,
+    1,
+};
+
+vx_kernel_tile_t gaussian3x3_cpu_tile = {
+    vxGaussian3x3Tile,
+    1,
+};
+
+vx_kernel_tile_t median3x3_cpu_tile = {
+    vxMedian3x3Tile,
+    1,
+};
+
+vx_kernel_tile_t dilate3x3_cpu_tile = {
+    vxDilate3x3Tile,
+    1,
+};
+
+vx_kernel_tile_t erode3x3_cpu_tile = {
+    vxErode3x3Tile,
+    1,
+};
@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+struct harris_tile_t {
+    vx_uint32 width;
+    vx_uint32 height;
+    vx_int32 *grad_x;
+    vx_int32 *grad_y;
+    vx_float32 *response;
+    vx_float32 sensitivity;
+    vx_float32 threshold;
+    vx_int32 block_size;
+    /* normalizes the gradients of the sobel size and the window to the range of 0~1 */
+    vx_float64 scale;
+    /* pixels closer to the edge than this are not detected */
+    vx_uint32 margin;
+};
+
+static void harrisResponseTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct harris_tile_t *tile = (struct harris_tile_t*)arg;
+    vx_int32 radius = tile->block_size / 2;
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        vx_float32 *dst = tile->response + (vx_size)y * tile->width;
+
+        for (vx_uint32 x = 0; x < tile->width; x++) {
+            if ((x < tile->margin) || (y < tile->margin) ||
+                    (x + tile->margin >= tile->width) || (y + tile->margin >= tile->height)) {
+                dst[x] = 0;
+                continue;
+            }
+
+            vx_float64 sum_xx = 0, sum_yy = 0, sum_xy = 0;
+            for (vx_int32 j = -radius; j <= radius; j++) {
+                vx_size offset = (vx_size)((vx_int32)y + j) * tile->width;
+                for (vx_int32 i = -radius; i <= radius; i++) {
+                    vx_float64 gx = tile->grad_x[offset + x + i] * tile->scale;
+                    vx_float64 gy = tile->grad_y[offset + x + i] * tile->scale;
+                    sum_xx += gx * gx;
+                    sum_yy += gy * gy;
+                    sum_xy += gx * gy;
+                }
+            }
+
+            vx_float64 trace = sum_xx + sum_yy;
+            vx_float64 mc = (sum_xx * sum_yy - sum_xy * sum_xy) - tile->sensitivity * trace * trace;
+            dst[x] = (mc > tile->threshold) ? (vx_float32)mc : 0;
+        }
+    }
+}
+
+/* a response survives when no stronger one is in the min distance, ties keep the first in raster order */
+static vx_bool isLocalMax(const struct harris_tile_t *tile, vx_uint32 x, vx_uint32 y, vx_int32 distance, vx_float32 distance2)
+{
+    vx_float32 value = tile->response[(vx_size)y * tile->width + x];
+
+    for (vx_int32 j = -distance; j <= distance; j++) {
+        vx_int32 ny = (vx_int32)y + j;
+        if ((ny < 0) || (ny >= (vx_int32)tile->height))
+            continue;
+
+        for (vx_int32 i = -distance; i <= distance; i++) {
+            vx_int32 nx = (vx_int32)x + i;
+            if ((nx < 0) || (nx >= (vx_int32)tile->width) || ((i == 0) && (j == 0)) || ((vx_float32)(i * i + j * j) > distance2))
+                continue;
+
+            vx_float32 other = tile->response[(vx_size)ny * tile->width + nx];
+            if ((other > value) || ((other == value) && ((j < 0) || ((j == 0) && (i < 0)))))
+                return vx_false_e;
+        }
+    }
+
+    return vx_true_e;
+}
+
+static vx_status vxHarrisCornersKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status;
+    struct harris_tile_t tile;
+    struct cpu_image_t in;
+    vx_float32 strength_thresh = 0, min_distance = 0, sensitivity = 0;
+    vx_int32 gradient_size = 0, block_size = 0;
+    vx_array corners;
+    vx_size capacity = 0, count = 0;
+    vx_keypoint_t *keypoints = NULL;
+
+    if ((node == NULL) || (num != 8)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    status = vxReadScalarValue((vx_scalar)parameters[1], &strength_thresh);
+    status |= vxReadScalarValue((vx_scalar)parameters[2], &min_distance);
+    status |= vxReadScalarValue((vx_scalar)parameters[3], &sensitivity);
+    status |= vxReadScalarValue((vx_scalar)parameters[4], &gradient_size);
+    status |= vxReadScalarValue((vx_scalar)parameters[5], &block_size);
+    if ((status != VX_SUCCESS) || ((block_size != 3) && (block_size != 5) && (block_size != 7))) {
+        VXLOGE("reading scalars fails, err:%d, block size:%d", status, block_size);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    corners = (vx_array)parameters[6];
+    vxQueryArray(corners, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity));
+
+    memset(&tile, 0x0, sizeof(tile));
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &in);
+    if (status != VX_SUCCESS) {
+        VXLOGE("accessing image fails, err:%d", status);
+        goto EXIT;
+    }
+
+    tile.width = in.width;
+    tile.height = in.height;
+    tile.sensitivity = sensitivity;
+    tile.threshold = strength_thresh;
+    tile.block_size = block_size;
+    tile.scale = 1.0 / ((1 << (gradient_size - 1)) * block_size * 255.0);
+    tile.margin = (vx_uint32)(gradient_size / 2 + block_size / 2);
+    tile.grad_x = (vx_int32*)malloc((vx_size)in.width * in.height * sizeof(vx_int32));
+    tile.grad_y = (vx_int32*)malloc((vx_size)in.width * in.height * sizeof(vx_int32));
+    tile.response = (vx_float32*)malloc((vx_size)in.width * in.height * sizeof(vx_float32));
+    keypoints = (vx_keypoint_t*)malloc(capacity * sizeof(vx_keypoint_t));
+    if ((tile.grad_x == NULL) || (tile.grad_y == NULL) || (tile.response == NULL) || ((capacity != 0) && (keypoints == NULL))) {
+        VXLOGE("allocating buffers fails");
+        status = VX_ERROR_NO_MEMORY;
+        goto EXIT;
+    }
+
+    status = cpuComputeGradients(&in, (vx_uint32)gradient_size, tile.grad_x, tile.grad_y);
+    if (status != VX_SUCCESS)
+        goto EXIT;
+
+    cpuProcessTiles(tile.height, harrisResponseTile, &tile);
+
+    {
+        vx_int32 distance = (vx_int32)min_distance;
+        vx_float32 distance2 = min_distance * min_distance;
+        vx_size found = 0;
+
+        for (vx_uint32 y = tile.margin; y + tile.margin < tile.height; y++) {
+            for (vx_uint32 x = tile.margin; x + tile.margin < tile.width; x++) {
+                vx_float32 value = tile.response[(vx_size)y * tile.width + x];
+                if ((value <= 0) || !isLocalMax(&tile, x, y, distance, distance2))
+                    continue;
+
+                if (count < capacity) {
+                    keypoints[count].x = (vx_int32)x;
+                    keypoints[count].y = (vx_int32)y;
+                    keypoints[count].strength = value;
+                    keypoints[count].scale = 0;
+                    keypoints[count].orientation = 0;
+                    keypoints[count].tracking_status = 1;
+                    keypoints[count].error = 0;
+                    count++;
+                }
+                found++;
+            }
+        }
+
+        status = vxTruncateArray(corners, 0);
+        if ((status == VX_SUCCESS) && (count != 0))
+            status = vxAddArrayItems(corners, count, keypoints, sizeof(vx_keypoint_t));
+        if ((status == VX_SUCCESS) && parameters[7])
+            status = vxWriteScalarValue((vx_scalar)parameters[7], &found);
+    }
+
+EXIT:
+    if (tile.grad_x)
+        free(tile.grad_x);
+    if (tile.grad_y)
+        free(tile.grad_y);
+    if (tile.response)
+        free(tile.response);
+    if (keypoints)
+        free(keypoints);
+
+    status |= cpuCommitImage(&in);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxHarrisCornersInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_enum type = VX_TYPE_INVALID;
+
+    if (index == 0) {
+        vx_df_image format;
+        if ((cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+            status = VX_SUCCESS;
+    } else if ((index >= 1) && (index <= 3)) {
+        vx_float32 value = 0;
+        if ((cpuQueryScalarParam(node, index, &type, &value) == VX_SUCCESS) && (type == VX_TYPE_FLOAT32))
+            status = VX_SUCCESS;
+    } else if ((index == 4) || (index == 5)) {
+        vx_int32 size = 0;
+        if ((cpuQueryScalarParam(node, index, &type, &size) == VX_SUCCESS) && (type == VX_TYPE_INT32) &&
+                ((size == 3) || (size == 5) || (size == 7)))
+            status = VX_SUCCESS;
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxHarrisCornersOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    if (index == 6) {
+        vx_enum item_type = VX_TYPE_KEYPOINT;
+        vx_size capacity = 0;
+        vxSetMetaFormatAttribute(meta, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &item_type, sizeof(item_type));
+        vxSetMetaFormatAttribute(meta, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity));
+        status = VX_SUCCESS;
+    } else if (index == 7) {
+        vx_enum scalar_type = VX_TYPE_SIZE;
+        vxSetMetaFormatAttribute(meta, VX_SCALAR_ATTRIBUTE_TYPE, &scalar_type, sizeof(scalar_type));
+        status = VX_SUCCESS;
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t harris_corners_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL},
+};
+
+vx_kernel_description_t harris_cpu_kernel = {
+    VX_KERNEL_HARRIS_CORNERS,
+    "org.khronos.openvx.harris_corners",
+    vxHarrisCornersKernel,
+    harris_corners_kernel_params, dimof(harris_corners_kernel_params),
+    vxHarrisCornersInputValidator,
+    vxHarrisCornersOutputValidator,
+    NULL,
+    NULL,
+};
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+struct histogram_tile_t {
+    struct cpu_image_t in;
+    /* bin of every pixel value, -1 for the value out of range */
+    vx_int32 bin_lut[256];
+    vx_size bins;
+    vx_int32 *hist;
+};
+
+static void histogramTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct histogram_tile_t *tile = (struct histogram_tile_t*)arg;
+    vx_uint32 width = tile->in.width;
+    vx_uint32 count[256];
+
+    /* counts pixel values privately, the bins are merged once per tile */
+    memset(count, 0x0, sizeof(count));
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        const vx_uint8 *src = CPU_IMAGE_ROW(&tile->in, 0, vx_uint8, y);
+        vx_uint32 x = 0;
+
+        for (; x + 4 <= width; x += 4) {
+            count[src[x]]++;
+            count[src[x + 1]]++;
+            count[src[x + 2]]++;
+            count[src[x + 3]]++;
+        }
+        for (; x < width; x++)
+            count[src[x]]++;
+    }
+
+    for (vx_uint32 i = 0; i < 256; i++) {
+        if ((count[i] != 0) && (tile->bin_lut[i] >= 0))
+            __sync_fetch_and_add(&tile->hist[tile->bin_lut[i]], (vx_int32)count[i]);
+    }
+}
+
+static vx_status vxHistogramKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status;
+    struct histogram_tile_t tile;
+    vx_distribution dist;
+    vx_int32 offset = 0;
+    vx_uint32 range = 0, window = 0;
+    void *ptr = NULL;
+
+    if ((node == NULL) || (num != 2)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    dist = (vx_distribution)parameters[1];
+    status = vxQueryDistribution(dist, VX_DISTRIBUTION_ATTRIBUTE_BINS, &tile.bins, sizeof(tile.bins));
+    status |= vxQueryDistribution(dist, VX_DISTRIBUTION_ATTRIBUTE_OFFSET, &offset, sizeof(offset));
+    status |= vxQueryDistribution(dist, VX_DISTRIBUTION_ATTRIBUTE_RANGE, &range, sizeof(range));
+    status |= vxQueryDistribution(dist, VX_DISTRIBUTION_ATTRIBUTE_WINDOW, &window, sizeof(window));
+    if ((status != VX_SUCCESS) || (window == 0)) {
+        VXLOGE("querying distribution fails, err:%d, window:%d", status, window);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    for (vx_int32 i = 0; i < 256; i++) {
+        if ((i >= offset) && (i < offset + (vx_int32)range))
+            tile.bin_lut[i] = (vx_int32)((vx_uint32)(i - offset) / window);
+        else
+            tile.bin_lut[i] = -1;
+    }
+
+    status = vxAccessDistribution(dist, &ptr, VX_WRITE_ONLY);
+    if (status != VX_SUCCESS) {
+        VXLOGE("accessing distribution fails, err:%d", status);
+        return status;
+    }
+    tile.hist = (vx_int32*)ptr;
+    memset(tile.hist, 0x0, tile.bins * sizeof(vx_int32));
+
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &tile.in);
+    if (status == VX_SUCCESS)
+        cpuProcessTiles(tile.in.height, histogramTile, &tile);
+    else
+        VXLOGE("accessing image fails, err:%d", status);
+
+    status |= cpuCommitImage(&tile.in);
+    status |= vxCommitDistribution(dist, ptr);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxHistogramInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format;
+
+    if ((index == 0) && (cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+        status = VX_SUCCESS;
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxHistogramOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    /* the distribution is defined by the user, nothing to set */
+    if ((node != NULL) && (meta != NULL) && (index == 1))
+        status = VX_SUCCESS;
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t histogram_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_DISTRIBUTION, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t histogram_cpu_kernel = {
+    VX_KERNEL_HISTOGRAM,
+    "org.khronos.openvx.histogram",
+    vxHistogramKernel,
+    histogram_kernel_params, dimof(histogram_kernel_params),
+    vxHistogramInputValidator,
+    vxHistogramOutputValidator,
+    NULL,
+    NULL,
+};
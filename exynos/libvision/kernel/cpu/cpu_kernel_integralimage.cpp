@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+struct integral_tile_t {
+    struct cpu_image_t in;
+    struct cpu_image_t out;
+};
+
+/* first pass, the prefix sum of each row is independent of the others */
+static void rowSumTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct integral_tile_t *tile = (struct integral_tile_t*)arg;
+    vx_uint32 width = tile->in.width;
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        const vx_uint8 *src = CPU_IMAGE_ROW(&tile->in, 0, vx_uint8, y);
+        vx_uint32 *dst = CPU_IMAGE_ROW(&tile->out, 0, vx_uint32, y);
+        vx_uint32 sum = 0;
+
+        for (vx_uint32 x = 0; x < width; x++) {
+            sum += src[x];
+            dst[x] = sum;
+        }
+    }
+}
+
+/* second pass, accumulates the rows downward */
+static void accumulateRows(struct integral_tile_t *tile)
+{
+    vx_uint32 width = tile->out.width;
+
+    for (vx_uint32 y = 1; y < tile->out.height; y++) {
+        const vx_uint32 *prev = CPU_IMAGE_ROW(&tile->out, 0, vx_uint32, y - 1);
+        vx_uint32 *dst = CPU_IMAGE_ROW(&tile->out, 0, vx_uint32, y);
+        vx_uint32 x = 0;
+
+#if (CPU_KERNEL_NEON==1)
+        for (; x + 4 <= width; x += 4)
+            vst1q_u32(dst + x, vaddq_u32(vld1q_u32(dst + x), vld1q_u32(prev + x)));
+#endif
+        for (; x < width; x++)
+            dst[x] += prev[x];
+    }
+}
+
+static vx_status vxIntegralImageKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status;
+    struct integral_tile_t tile;
+
+    if ((node == NULL) || (num != 2)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &tile.in);
+    status |= cpuAccessImage((vx_image)parameters[1], VX_READ_AND_WRITE, &tile.out);
+    if (status == VX_SUCCESS) {
+        cpuProcessTiles(tile.in.height, rowSumTile, &tile);
+        accumulateRows(&tile);
+    } else {
+        VXLOGE("accessing images fails, err:%d", status);
+    }
+
+    status |= cpuCommitImage(&tile.in);
+    status |= cpuCommitImage(&tile.out);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxIntegralImageInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format;
+
+    if ((index == 0) && (cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+        status = VX_SUCCESS;
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxIntegralImageOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+
+    if (index == 1) {
+        status = cpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            cpuSetImageMeta(meta, width, height, VX_DF_IMAGE_U32);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t integral_image_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t integralimage_cpu_kernel = {
+    VX_KERNEL_INTEGRAL_IMAGE,
+    "org.khronos.openvx.integral_image",
+    vxIntegralImageKernel,
+    integral_image_kernel_params, dimof(integral_image_kernel_params),
+    vxIntegralImageInputValidator,
+    vxIntegralImageOutputValidator,
+    NULL,
+    NULL,
+};
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <math.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+struct magphase_tile_t {
+    vx_bool phase;
+    struct cpu_image_t in[2];
+    struct cpu_image_t out;
+};
+
+static void magphaseTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct magphase_tile_t *tile = (struct magphase_tile_t*)arg;
+    vx_uint32 width = tile->out.width;
+    const double phase_scale = 256.0 / (2.0 * M_PI);
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        const vx_int16 *grad_x = CPU_IMAGE_ROW(&tile->in[0], 0, vx_int16, y);
+        const vx_int16 *grad_y = CPU_IMAGE_ROW(&tile->in[1], 0, vx_int16, y);
+
+        if (tile->phase) {
+            vx_uint8 *dst = CPU_IMAGE_ROW(&tile->out, 0, vx_uint8, y);
+            for (vx_uint32 x = 0; x < width; x++) {
+                double angle = atan2((double)grad_y[x], (double)grad_x[x]);
+                if (angle < 0)
+                    angle += 2.0 * M_PI;
+                dst[x] = (vx_uint8)((vx_uint32)(angle * phase_scale + 0.5) & 0xFF);
+            }
+        } else {
+            vx_int16 *dst = CPU_IMAGE_ROW(&tile->out, 0, vx_int16, y);
+            for (vx_uint32 x = 0; x < width; x++) {
+                vx_int32 gx = grad_x[x];
+                vx_int32 gy = grad_y[x];
+                dst[x] = cpuSaturateS16((vx_int32)(sqrt((double)(gx * gx + gy * gy)) + 0.5));
+            }
+        }
+    }
+}
+
+static vx_status processMagPhase(vx_bool phase, const vx_reference parameters[], vx_uint32 num,
+                                        vx_uint32 start_y, vx_uint32 end_y)
+{
+    vx_status status;
+    struct magphase_tile_t tile;
+
+    if (num != 3) {
+        VXLOGE("parameter number is wrong, num:%d", num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    tile.phase = phase;
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &tile.in[0]);
+    status |= cpuAccessImage((vx_image)parameters[1], VX_READ_ONLY, &tile.in[1]);
+    status |= cpuAccessImage((vx_image)parameters[2], VX_WRITE_ONLY, &tile.out);
+    if (status == VX_SUCCESS)
+        cpuProcessTileRange(start_y, end_y, tile.out.height, magphaseTile, &tile);
+    else
+        VXLOGE("accessing images fails, err:%d", status);
+
+    status |= cpuCommitImage(&tile.in[0]);
+    status |= cpuCommitImage(&tile.in[1]);
+    status |= cpuCommitImage(&tile.out);
+
+    return status;
+}
+
+static vx_status vxMagnitudeKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = node ? processMagPhase(vx_false_e, parameters, num, 0, CPU_KERNEL_ALL_ROWS) : VX_ERROR_INVALID_NODE;
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxPhaseKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = node ? processMagPhase(vx_true_e, parameters, num, 0, CPU_KERNEL_ALL_ROWS) : VX_ERROR_INVALID_NODE;
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxMagnitudeTile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return node ? processMagPhase(vx_false_e, parameters, num, start_y, end_y) : VX_ERROR_INVALID_NODE;
+}
+
+static vx_status vxPhaseTile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return node ? processMagPhase(vx_true_e, parameters, num, start_y, end_y) : VX_ERROR_INVALID_NODE;
+}
+
+static vx_status vxMagPhaseInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format;
+
+    if ((index == 0) || (index == 1)) {
+        if ((cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_S16))
+            status = (index == 0) ? VX_SUCCESS : cpuCheckSameImageParam(node, 0, 1);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxMagnitudeOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+
+    if (index == 2) {
+        status = cpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            cpuSetImageMeta(meta, width, height, VX_DF_IMAGE_S16);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxPhaseOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+
+    if (index == 2) {
+        status = cpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            cpuSetImageMeta(meta, width, height, VX_DF_IMAGE_U8);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t magphase_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t magnitude_cpu_kernel = {
+    VX_KERNEL_MAGNITUDE,
+    "org.khronos.openvx.magnitude",
+    vxMagnitudeKernel,
+    magphase_kernel_params, dimof(magphase_kernel_params),
+    vxMagPhaseInputValidator,
+    vxMagnitudeOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t phase_cpu_kernel = {
+    VX_KERNEL_PHASE,
+    "org.khronos.openvx.phase",
+    vxPhaseKernel,
+    magphase_kernel_params, dimof(magphase_kernel_params),
+    vxMagPhaseInputValidator,
+    vxPhaseOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_tile_t magnitude_cpu_tile = {
+    vxMagnitudeTile,
+    0,
+};
+
+vx_kernel_tile_t phase_cpu_tile = {
+    vxPhaseTile,
+    0,
+};
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <VX/vx.h>
+#include <VX/vx_internal.h>
+#include <VX/vx_api.h>
+#include <VX/vx_helper.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_module.h"
+#include "cpu_kernel_util.h"
+
+extern vx_kernel_description_t colorconv_cpu_kernel;
+extern vx_kernel_description_t sobel3x3_cpu_kernel;
+extern vx_kernel_description_t magnitude_cpu_kernel;
+extern vx_kernel_description_t phase_cpu_kernel;
+extern vx_kernel_description_t scaleimage_cpu_kernel;
+extern vx_kernel_description_t histogram_cpu_kernel;
+extern vx_kernel_description_t absdiff_cpu_kernel;
+extern vx_kernel_description_t integralimage_cpu_kernel;
+extern vx_kernel_description_t dilate3x3_cpu_kernel;
+extern vx_kernel_description_t erode3x3_cpu_kernel;
+extern vx_kernel_description_t median3x3_cpu_kernel;
+extern vx_kernel_description_t box3x3_cpu_kernel;
+extern vx_kernel_description_t gaussian3x3_cpu_kernel;
+extern vx_kernel_description_t convolution_cpu_kernel;
+extern vx_kernel_description_t pyramid_cpu_kernel;
+extern vx_kernel_description_t cannyedge_cpu_kernel;
+extern vx_kernel_description_t bitwiseand_cpu_kernel;
+extern vx_kernel_description_t bitwiseor_cpu_kernel;
+extern vx_kernel_description_t bitwisexor_cpu_kernel;
+extern vx_kernel_description_t bitwisenot_cpu_kernel;
+extern vx_kernel_description_t multiply_cpu_kernel;
+extern vx_kernel_description_t add_cpu_kernel;
+extern vx_kernel_description_t subtract_cpu_kernel;
+extern vx_kernel_description_t warpaffine_cpu_kernel;
+extern vx_kernel_description_t warpperspective_cpu_kernel;
+extern vx_kernel_description_t harris_cpu_kernel;
+extern vx_kernel_description_t fastcorners_cpu_kernel;
+extern vx_kernel_description_t optpyrlk_cpu_kernel;
+extern vx_kernel_description_t remap_cpu_kernel;
+extern vx_kernel_description_t halfscalegaussian_cpu_kernel;
+
+extern vx_kernel_tile_t sobel3x3_cpu_tile;
+extern vx_kernel_tile_t magnitude_cpu_tile;
+extern vx_kernel_tile_t phase_cpu_tile;
+extern vx_kernel_tile_t absdiff_cpu_tile;
+extern vx_kernel_tile_t dilate3x3_cpu_tile;
+extern vx_kernel_tile_t erode3x3_cpu_tile;
+extern vx_kernel_tile_t median3x3_cpu_tile;
+extern vx_kernel_tile_t box3x3_cpu_tile;
+extern vx_kernel_tile_t gaussian3x3_cpu_tile;
+extern vx_kernel_tile_t bitwiseand_cpu_tile;
+extern vx_kernel_tile_t bitwiseor_cpu_tile;
+extern vx_kernel_tile_t bitwisexor_cpu_tile;
+extern vx_kernel_tile_t bitwisenot_cpu_tile;
+extern vx_kernel_tile_t multiply_cpu_tile;
+extern vx_kernel_tile_t add_cpu_tile;
+extern vx_kernel_tile_t subtract_cpu_tile;
+
+static vx_kernel_description_t *cpu_kernels[] = {
+    &colorconv_cpu_kernel,
+    &sobel3x3_cpu_kernel,
+    &magnitude_cpu_kernel,
+    &phase_cpu_kernel,
+    &scaleimage_cpu_kernel,
+    &histogram_cpu_kernel,
+    &absdiff_cpu_kernel,
+    &integralimage_cpu_kernel,
+    &dilate3x3_cpu_kernel,
+    &erode3x3_cpu_kernel,
+    &median3x3_cpu_kernel,
+    &box3x3_cpu_kernel,
+    &gaussian3x3_cpu_kernel,
+    &convolution_cpu_kernel,
+    &pyramid_cpu_kernel,
+    &cannyedge_cpu_kernel,
+    &bitwiseand_cpu_kernel,
+    &bitwiseor_cpu_kernel,
+    &bitwisexor_cpu_kernel,
+    &bitwisenot_cpu_kernel,
+    &multiply_cpu_kernel,
+    &add_cpu_kernel,
+    &subtract_cpu_kernel,
+    &warpaffine_cpu_kernel,
+    &warpperspective_cpu_kernel,
+    &harris_cpu_kernel,
+    &fastcorners_cpu_kernel,
+    &optpyrlk_cpu_kernel,
+    &remap_cpu_kernel,
+    &halfscalegaussian_cpu_kernel
+};
+
+/* kernels able to process a band of rows, a fused subgraph of them runs band by band */
+static struct {
+    vx_kernel_description_t *kernel;
+    vx_kernel_tile_t *tile;
+} cpu_kernel_tiles[] = {
+    {&sobel3x3_cpu_kernel, &sobel3x3_cpu_tile},
+    {&magnitude_cpu_kernel, &magnitude_cpu_tile},
+    {&phase_cpu_kernel, &phase_cpu_tile},
+    {&absdiff_cpu_kernel, &absdiff_cpu_tile},
+    {&dilate3x3_cpu_kernel, &dilate3x3_cpu_tile},
+    {&erode3x3_cpu_kernel, &erode3x3_cpu_tile},
+    {&median3x3_cpu_kernel, &median3x3_cpu_tile},
+    {&box3x3_cpu_kernel, &box3x3_cpu_tile},
+    {&gaussian3x3_cpu_kernel, &gaussian3x3_cpu_tile},
+    {&bitwiseand_cpu_kernel, &bitwiseand_cpu_tile},
+    {&bitwiseor_cpu_kernel, &bitwiseor_cpu_tile},
+    {&bitwisexor_cpu_kernel, &bitwisexor_cpu_tile},
+    {&bitwisenot_cpu_kernel, &bitwisenot_cpu_tile},
+    {&multiply_cpu_kernel, &multiply_cpu_tile},
+    {&add_cpu_kernel, &add_cpu_tile},
+    {&subtract_cpu_kernel, &subtract_cpu_tile},
+};
+
+static vx_kernel_tile_t *cpuFindKernelTile(vx_kernel_description_t *kernel)
+{
+    for (vx_uint32 i = 0; i < dimof(cpu_kernel_tiles); i++) {
+        if (cpu_kernel_tiles[i].kernel == kernel)
+            return cpu_kernel_tiles[i].tile;
+    }
+
+    return NULL;
+}
+
+VX_API_ENTRY vx_status VX_API_CALL vxPublishKernels(vx_context context)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+
+    vx_status status = VX_SUCCESS;
+
+    vx_uint32 num_cpu_kernels = dimof(cpu_kernels);
+
+    for (vx_uint32 k = 0; k < num_cpu_kernels; k++)
+    {
+        vx_kernel kernel = vxAddKernel(context,
+                             cpu_kernels[k]->name,
+                             cpu_kernels[k]->enumeration,
+                             cpu_kernels[k]->function,
+                             cpu_kernels[k]->numParams,
+                             cpu_kernels[k]->input_validate,
+                             cpu_kernels[k]->output_validate,
+                             cpu_kernels[k]->initialize,
+                             cpu_kernels[k]->deinitialize);
+
+        if (kernel)
+        {
+            vx_uint32 num_kernel_params = cpu_kernels[k]->numParams;
+            vx_param_description_t *parameters  = cpu_kernels[k]->parameters;
+
+            for (vx_uint32 p = 0; p < num_kernel_params; p++)
+            {
+                status = vxAddParameterToKernel(kernel, p, parameters[p].direction, parameters[p].data_type, parameters[p].state);
+                if (status != VX_SUCCESS) {
+                    VXLOGE("%s: add parameter to kernel fail(%d)", cpu_kernels[k]->name, status);
+                }
+            }
+
+            vx_kernel_tile_t *tile = cpuFindKernelTile(cpu_kernels[k]);
+            if (tile) {
+                status = vxSetKernelAttribute(kernel, VX_KERNEL_ATTRIBUTE_TILE, tile, sizeof(*tile));
+                if (status != VX_SUCCESS) {
+                    VXLOGE("%s: set tile function fail(%d)", cpu_kernels[k]->name, status);
+                }
+            }
+
+            status = vxFinalizeKernel(kernel);
+            if (status != VX_SUCCESS) {
+                VXLOGE("%s: finalize kernel fail(%d)", cpu_kernels[k]->name, status);
+            }
+        } else {
+            VXLOGE("%s: add kernel fail", cpu_kernels[k]->name);
+        }
+    }
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
@@ -0,0 +1,438 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+/* determinant under this means the window has no texture to track */
+#define OPTPYRLK_MIN_DET        (1.0e-7f)
+
+struct optpyrlk_tile_t {
+    vx_size levels;
+    vx_float32 scale;
+    struct cpu_image_t *old_level;
+    struct cpu_image_t *new_level;
+    const vx_keypoint_t *old_points;
+    vx_size old_stride;
+    const vx_keypoint_t *estimate_points;
+    vx_size estimate_stride;
+    vx_keypoint_t *new_points;
+    vx_enum termination;
+    vx_float32 epsilon;
+    vx_uint32 iterations;
+    vx_bool use_initial_estimate;
+    vx_int32 window;
+};
+
+static inline vx_float32 samplePixel(const struct cpu_image_t *img, vx_float32 x, vx_float32 y)
+{
+    vx_int32 x0 = (vx_int32)floorf(x);
+    vx_int32 y0 = (vx_int32)floorf(y);
+    vx_float32 wx = x - x0;
+    vx_float32 wy = y - y0;
+    vx_int32 x1 = x0 + 1, y1 = y0 + 1;
+    vx_int32 max_x = (vx_int32)img->width - 1, max_y = (vx_int32)img->height - 1;
+
+    x0 = (x0 < 0) ? 0 : ((x0 > max_x) ? max_x : x0);
+    x1 = (x1 < 0) ? 0 : ((x1 > max_x) ? max_x : x1);
+    y0 = (y0 < 0) ? 0 : ((y0 > max_y) ? max_y : y0);
+    y1 = (y1 < 0) ? 0 : ((y1 > max_y) ? max_y : y1);
+
+    const vx_uint8 *row0 = CPU_IMAGE_ROW(img, 0, vx_uint8, y0);
+    const vx_uint8 *row1 = CPU_IMAGE_ROW(img, 0, vx_uint8, y1);
+
+    return (1 - wy) * ((1 - wx) * row0[x0] + wx * row0[x1]) + wy * ((1 - wx) * row1[x0] + wx * row1[x1]);
+}
+
+/* tracks one point through the levels, returns false when the point is lost */
+static vx_bool trackPoint(const struct optpyrlk_tile_t *tile, const vx_keypoint_t *old_point, const vx_keypoint_t *estimate,
+                                    vx_float32 *patch, vx_float32 *new_x, vx_float32 *new_y)
+{
+    vx_int32 half = tile->window / 2;
+    vx_size patch_size = (vx_size)tile->window * tile->window;
+    vx_float32 *patch_ix = patch + patch_size;
+    vx_float32 *patch_iy = patch_ix + patch_size;
+    vx_float32 level_scale = powf(tile->scale, (vx_float32)(tile->levels - 1));
+    vx_float32 guess_x = 0, guess_y = 0;
+
+    if (tile->use_initial_estimate) {
+        guess_x = (estimate->x - old_point->x) * level_scale;
+        guess_y = (estimate->y - old_point->y) * level_scale;
+    }
+
+    for (vx_int32 level = (vx_int32)tile->levels - 1; level >= 0; level--) {
+        const struct cpu_image_t *old_img = &tile->old_level[level];
+        const struct cpu_image_t *new_img = &tile->new_level[level];
+        vx_float32 px = old_point->x * level_scale;
+        vx_float32 py = old_point->y * level_scale;
+        vx_float32 gxx = 0, gxy = 0, gyy = 0;
+        vx_float32 vx = 0, vy = 0;
+
+        /* the template and its scharr gradients are fixed during the iterations of the level */
+        for (vx_int32 j = -half, k = 0; j <= half; j++) {
+            for (vx_int32 i = -half; i <= half; i++, k++) {
+                vx_float32 x = px + i, y = py + j;
+                vx_float32 ix = (3 * (samplePixel(old_img, x + 1, y - 1) - samplePixel(old_img, x - 1, y - 1)) +
+                                10 * (samplePixel(old_img, x + 1, y) - samplePixel(old_img, x - 1, y)) +
+                                3 * (samplePixel(old_img, x + 1, y + 1) - samplePixel(old_img, x - 1, y + 1))) / 32.0f;
+                vx_float32 iy = (3 * (samplePixel(old_img, x - 1, y + 1) - samplePixel(old_img, x - 1, y - 1)) +
+                                10 * (samplePixel(old_img, x, y + 1) - samplePixel(old_img, x, y - 1)) +
+                                3 * (samplePixel(old_img, x + 1, y + 1) - samplePixel(old_img, x + 1, y - 1))) / 32.0f;
+
+                patch[k] = samplePixel(old_img, x, y);
+                patch_ix[k] = ix;
+                patch_iy[k] = iy;
+                gxx += ix * ix;
+                gxy += ix * iy;
+                gyy += iy * iy;
+            }
+        }
+
+        vx_float32 det = gxx * gyy - gxy * gxy;
+        if (det < OPTPYRLK_MIN_DET * patch_size * patch_size)
+            return vx_false_e;
+
+        for (vx_uint32 iter = 0; ; iter++) {
+            if ((tile->termination != VX_TERM_CRITERIA_EPSILON) && (iter >= tile->iterations))
+                break;
+
+            vx_float32 bx = 0, by = 0;
+            vx_float32 qx = px + guess_x + vx, qy = py + guess_y + vy;
+            for (vx_int32 j = -half, k = 0; j <= half; j++) {
+                for (vx_int32 i = -half; i <= half; i++, k++) {
+                    vx_float32 diff = patch[k] - samplePixel(new_img, qx + i, qy + j);
+                    bx += diff * patch_ix[k];
+                    by += diff * patch_iy[k];
+                }
+            }
+
+            vx_float32 eta_x = (gyy * bx - gxy * by) / det;
+            vx_float32 eta_y = (gxx * by - gxy * bx) / det;
+            vx += eta_x;
+            vy += eta_y;
+
+            if ((tile->termination != VX_TERM_CRITERIA_ITERATIONS) &&
+                    (eta_x * eta_x + eta_y * eta_y <= tile->epsilon * tile->epsilon))
+                break;
+            /* epsilon criteria alone is bounded, not to spin on a diverging point */
+            if ((tile->termination == VX_TERM_CRITERIA_EPSILON) && (iter >= 100))
+                break;
+        }
+
+        if (level > 0) {
+            guess_x = (guess_x + vx) / tile->scale;
+            guess_y = (guess_y + vy) / tile->scale;
+            level_scale /= tile->scale;
+        } else {
+            guess_x += vx;
+            guess_y += vy;
+        }
+    }
+
+    *new_x = old_point->x + guess_x;
+    *new_y = old_point->y + guess_y;
+
+    return vx_true_e;
+}
+
+static void optpyrlkTile(void *arg, vx_uint32 start, vx_uint32 end)
+{
+    struct optpyrlk_tile_t *tile = (struct optpyrlk_tile_t*)arg;
+    vx_float32 *patch;
+
+    patch = (vx_float32*)malloc((vx_size)tile->window * tile->window * 3 * sizeof(vx_float32));
+    if (patch == NULL) {
+        VXLOGE("allocating patch buffer fails");
+        return;
+    }
+
+    for (vx_uint32 i = start; i < end; i++) {
+        const vx_keypoint_t *old_point = (const vx_keypoint_t*)((const vx_uint8*)tile->old_points + i * tile->old_stride);
+        const vx_keypoint_t *estimate = (const vx_keypoint_t*)((const vx_uint8*)tile->estimate_points + i * tile->estimate_stride);
+        vx_keypoint_t *new_point = &tile->new_points[i];
+        vx_float32 new_x = 0, new_y = 0;
+
+        *new_point = *estimate;
+        if (old_point->tracking_status == 0) {
+            new_point->tracking_status = 0;
+            continue;
+        }
+
+        if (trackPoint(tile, old_point, estimate, patch, &new_x, &new_y) &&
+                (new_x >= 0) && (new_y >= 0) && (new_x < tile->new_level[0].width) && (new_y < tile->new_level[0].height)) {
+            new_point->x = (vx_int32)(new_x + 0.5f);
+            new_point->y = (vx_int32)(new_y + 0.5f);
+            new_point->tracking_status = 1;
+        } else {
+            new_point->tracking_status = 0;
+        }
+    }
+
+    free(patch);
+}
+
+static vx_status accessPyramid(vx_pyramid pyramid, vx_size levels, struct cpu_image_t *level_img)
+{
+    vx_status status = VX_SUCCESS;
+
+    for (vx_uint32 i = 0; i < levels; i++) {
+        vx_image image = vxGetPyramidLevel(pyramid, i);
+
+        status |= cpuAccessImage(image, VX_READ_ONLY, &level_img[i]);
+        /* the level image is owned by the pyramid, only the reference taken here is released */
+        vxReleaseImage(&image);
+    }
+
+    return status;
+}
+
+static vx_status vxOpticalFlowPyrLKKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status;
+    struct optpyrlk_tile_t tile;
+    vx_array old_points, estimate_points, new_points;
+    vx_size point_num = 0, estimate_num = 0, window = 0;
+    void *old_ptr = NULL, *estimate_ptr = NULL;
+
+    if ((node == NULL) || (num != 10)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    memset(&tile, 0x0, sizeof(tile));
+    old_points = (vx_array)parameters[2];
+    estimate_points = (vx_array)parameters[3];
+    new_points = (vx_array)parameters[4];
+
+    status = vxQueryPyramid((vx_pyramid)parameters[0], VX_PYRAMID_ATTRIBUTE_LEVELS, &tile.levels, sizeof(tile.levels));
+    status |= vxQueryPyramid((vx_pyramid)parameters[0], VX_PYRAMID_ATTRIBUTE_SCALE, &tile.scale, sizeof(tile.scale));
+    status |= vxQueryArray(old_points, VX_ARRAY_ATTRIBUTE_NUMITEMS, &point_num, sizeof(point_num));
+    status |= vxQueryArray(estimate_points, VX_ARRAY_ATTRIBUTE_NUMITEMS, &estimate_num, sizeof(estimate_num));
+    status |= vxReadScalarValue((vx_scalar)parameters[5], &tile.termination);
+    status |= vxReadScalarValue((vx_scalar)parameters[6], &tile.epsilon);
+    status |= vxReadScalarValue((vx_scalar)parameters[7], &tile.iterations);
+    status |= vxReadScalarValue((vx_scalar)parameters[8], &tile.use_initial_estimate);
+    status |= vxReadScalarValue((vx_scalar)parameters[9], &window);
+    if ((status != VX_SUCCESS) || (tile.levels == 0) || (point_num != estimate_num) || (window == 0)) {
+        VXLOGE("reading parameters fails, err:%d, points:%d/%d", status, (vx_uint32)point_num, (vx_uint32)estimate_num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+    tile.window = (vx_int32)window | 0x1;
+
+    tile.old_level = (struct cpu_image_t*)calloc(tile.levels, sizeof(struct cpu_image_t));
+    tile.new_level = (struct cpu_image_t*)calloc(tile.levels, sizeof(struct cpu_image_t));
+    tile.new_points = (vx_keypoint_t*)malloc((point_num ? point_num : 1) * sizeof(vx_keypoint_t));
+    if ((tile.old_level == NULL) || (tile.new_level == NULL) || (tile.new_points == NULL)) {
+        VXLOGE("allocating buffers fails");
+        status = VX_ERROR_NO_MEMORY;
+        goto EXIT;
+    }
+
+    status = accessPyramid((vx_pyramid)parameters[0], tile.levels, tile.old_level);
+    status |= accessPyramid((vx_pyramid)parameters[1], tile.levels, tile.new_level);
+    if (status != VX_SUCCESS) {
+        VXLOGE("accessing pyramids fails, err:%d", status);
+        goto EXIT;
+    }
+
+    if (point_num != 0) {
+        status = vxAccessArrayRange(old_points, 0, point_num, &tile.old_stride, &old_ptr, VX_READ_ONLY);
+        status |= vxAccessArrayRange(estimate_points, 0, point_num, &tile.estimate_stride, &estimate_ptr, VX_READ_ONLY);
+        if (status != VX_SUCCESS) {
+            VXLOGE("accessing point arrays fails, err:%d", status);
+            goto EXIT;
+        }
+
+        tile.old_points = (const vx_keypoint_t*)old_ptr;
+        tile.estimate_points = (const vx_keypoint_t*)estimate_ptr;
+        cpuProcessTiles((vx_uint32)point_num, optpyrlkTile, &tile);
+    }
+
+    status = vxTruncateArray(new_points, 0);
+    if ((status == VX_SUCCESS) && (point_num != 0))
+        status = vxAddArrayItems(new_points, point_num, tile.new_points, sizeof(vx_keypoint_t));
+
+EXIT:
+    if (old_ptr)
+        status |= vxCommitArrayRange(old_points, 0, 0, old_ptr);
+    if (estimate_ptr)
+        status |= vxCommitArrayRange(estimate_points, 0, 0, estimate_ptr);
+
+    for (vx_uint32 i = 0; i < tile.levels; i++) {
+        if (tile.old_level)
+            status |= cpuCommitImage(&tile.old_level[i]);
+        if (tile.new_level)
+            status |= cpuCommitImage(&tile.new_level[i]);
+    }
+
+    if (tile.old_level)
+        free(tile.old_level);
+    if (tile.new_level)
+        free(tile.new_level);
+    if (tile.new_points)
+        free(tile.new_points);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxOpticalFlowPyrLKInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_enum type = VX_TYPE_INVALID;
+
+    switch (index) {
+    case 0:
+    case 1: {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_pyramid pyramid = NULL;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &pyramid, sizeof(pyramid));
+            if (pyramid) {
+                vx_df_image format = 0;
+                vxQueryPyramid(pyramid, VX_PYRAMID_ATTRIBUTE_FORMAT, &format, sizeof(format));
+                if (format == VX_DF_IMAGE_U8)
+                    status = VX_SUCCESS;
+                vxReleasePyramid(&pyramid);
+            }
+            vxReleaseParameter(&param);
+        }
+        break;
+    }
+    case 2:
+    case 3: {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_array array = NULL;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &array, sizeof(array));
+            if (array) {
+                vx_enum item_type = 0;
+                vxQueryArray(array, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &item_type, sizeof(item_type));
+                if (item_type == VX_TYPE_KEYPOINT)
+                    status = VX_SUCCESS;
+                vxReleaseArray(&array);
+            }
+            vxReleaseParameter(&param);
+        }
+        break;
+    }
+    case 5: {
+        vx_enum termination = 0;
+        if ((cpuQueryScalarParam(node, index, &type, &termination) == VX_SUCCESS) && (type == VX_TYPE_ENUM) &&
+                ((termination == VX_TERM_CRITERIA_ITERATIONS) || (termination == VX_TERM_CRITERIA_EPSILON) ||
+                (termination == VX_TERM_CRITERIA_BOTH)))
+            status = VX_SUCCESS;
+        break;
+    }
+    case 6: {
+        vx_float32 epsilon = 0;
+        if ((cpuQueryScalarParam(node, index, &type, &epsilon) == VX_SUCCESS) && (type == VX_TYPE_FLOAT32))
+            status = VX_SUCCESS;
+        break;
+    }
+    case 7: {
+        vx_uint32 iterations = 0;
+        if ((cpuQueryScalarParam(node, index, &type, &iterations) == VX_SUCCESS) && (type == VX_TYPE_UINT32))
+            status = VX_SUCCESS;
+        break;
+    }
+    case 8: {
+        vx_bool use_initial = vx_false_e;
+        if ((cpuQueryScalarParam(node, index, &type, &use_initial) == VX_SUCCESS) && (type == VX_TYPE_BOOL))
+            status = VX_SUCCESS;
+        break;
+    }
+    case 9: {
+        vx_size window = 0;
+        if ((cpuQueryScalarParam(node, index, &type, &window) == VX_SUCCESS) && (type == VX_TYPE_SIZE) && (window != 0))
+            status = VX_SUCCESS;
+        break;
+    }
+    default:
+        break;
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxOpticalFlowPyrLKOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    if (index == 4) {
+        vx_parameter param = vxGetParameterByIndex(node, 2);
+        vx_array old_points = NULL;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &old_points, sizeof(old_points));
+            if (old_points) {
+                vx_enum item_type = VX_TYPE_KEYPOINT;
+                vx_size capacity = 0;
+
+                vxQueryArray(old_points, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity));
+                vxSetMetaFormatAttribute(meta, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &item_type, sizeof(item_type));
+                vxSetMetaFormatAttribute(meta, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity));
+                status = VX_SUCCESS;
+                vxReleaseArray(&old_points);
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t optpyrlk_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_PYRAMID, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_PYRAMID, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t optpyrlk_cpu_kernel = {
+    VX_KERNEL_OPTICAL_FLOW_PYR_LK,
+    "org.khronos.openvx.optical_flow_pyr_lk",
+    vxOpticalFlowPyrLKKernel,
+    optpyrlk_kernel_params, dimof(optpyrlk_kernel_params),
+    vxOpticalFlowPyrLKInputValidator,
+    vxOpticalFlowPyrLKOutputValidator,
+    NULL,
+    NULL,
+};
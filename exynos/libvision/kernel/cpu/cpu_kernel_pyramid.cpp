@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+struct downsample_tile_t {
+    vx_border_mode_t border;
+    struct cpu_image_t *in;
+    struct cpu_image_t *out;
+    vx_uint32 ksize;
+};
+
+static const vx_uint32 gaussian3_weight[3] = {1, 2, 1};
+static const vx_uint32 gaussian5_weight[5] = {1, 4, 6, 4, 1};
+
+/* nearest source position of the destination pixel, same mapping with the nearest neighbor scaling */
+static inline vx_int32 nearestSource(vx_uint32 dst, vx_uint32 src_size, vx_uint32 dst_size)
+{
+    vx_int32 src = (vx_int32)(((vx_float32)dst + 0.5f) * src_size / dst_size);
+
+    return (src < (vx_int32)src_size) ? src : (vx_int32)src_size - 1;
+}
+
+/* gaussian smoothing evaluated only on the sampled source pixels */
+static void downsampleTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct downsample_tile_t *tile = (struct downsample_tile_t*)arg;
+    struct cpu_image_t *in = tile->in;
+    struct cpu_image_t *out = tile->out;
+    vx_uint32 radius = tile->ksize / 2;
+    const vx_uint32 *weight = (tile->ksize == 5) ? gaussian5_weight : gaussian3_weight;
+    vx_uint32 shift = (tile->ksize == 5) ? 8 : 4;
+    vx_uint8 *rows[5];
+    vx_uint8 *buf;
+
+    buf = (vx_uint8*)malloc((in->width + radius * 2) * (radius * 2 + 1));
+    if (buf == NULL) {
+        VXLOGE("allocating row buffer fails");
+        return;
+    }
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        vx_int32 src_y = nearestSource(y, in->height, out->height);
+        vx_uint8 *dst = CPU_IMAGE_ROW(out, 0, vx_uint8, y);
+
+        cpuLoadBorderedRowsU8(in, src_y, radius, &tile->border, buf, rows);
+        for (vx_uint32 x = 0; x < out->width; x++) {
+            vx_int32 src_x = nearestSource(x, in->width, out->width);
+            vx_uint32 sum = 0;
+
+            if (radius == 0) {
+                dst[x] = rows[0][src_x];
+                continue;
+            }
+
+            for (vx_uint32 i = 0; i < tile->ksize; i++) {
+                vx_uint32 col = 0;
+                for (vx_uint32 j = 0; j < tile->ksize; j++)
+                    col += weight[j] * rows[j][src_x - (vx_int32)radius + (vx_int32)i];
+                sum += weight[i] * col;
+            }
+            dst[x] = (vx_uint8)((sum + (1 << (shift - 1))) >> shift);
+        }
+    }
+
+    free(buf);
+}
+
+static void downsampleImage(vx_node node, struct cpu_image_t *in, struct cpu_image_t *out, vx_uint32 ksize)
+{
+    struct downsample_tile_t tile;
+
+    cpuGetBorderMode(node, &tile.border);
+    tile.in = in;
+    tile.out = out;
+    tile.ksize = ksize;
+    cpuProcessTiles(out->height, downsampleTile, &tile);
+}
+
+static vx_status vxGaussianPyramidKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status;
+    vx_pyramid pyramid;
+    vx_size levels = 0;
+    struct cpu_image_t level_img[2];
+    vx_image level_image[2] = {NULL, NULL};
+
+    if ((node == NULL) || (num != 2)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    pyramid = (vx_pyramid)parameters[1];
+    status = vxQueryPyramid(pyramid, VX_PYRAMID_ATTRIBUTE_LEVELS, &levels, sizeof(levels));
+    if ((status != VX_SUCCESS) || (levels == 0)) {
+        VXLOGE("querying pyramid fails, err:%d", status);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    memset(level_img, 0x0, sizeof(level_img));
+
+    /* level 0 is the copy of input */
+    {
+        struct cpu_image_t in;
+
+        level_image[0] = vxGetPyramidLevel(pyramid, 0);
+        status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &in);
+        status |= cpuAccessImage(level_image[0], VX_WRITE_ONLY, &level_img[0]);
+        if (status == VX_SUCCESS) {
+            for (vx_uint32 y = 0; y < in.height; y++)
+                memcpy(CPU_IMAGE_ROW(&level_img[0], 0, vx_uint8, y), CPU_IMAGE_ROW(&in, 0, vx_uint8, y), in.width);
+        }
+        status |= cpuCommitImage(&in);
+    }
+
+    /* the previous level keeps being mapped until the next level is made from it */
+    for (vx_uint32 i = 1; (i < levels) && (status == VX_SUCCESS); i++) {
+        vx_uint32 cur = i & 0x1;
+        vx_uint32 prev = cur ^ 0x1;
+
+        level_image[cur] = vxGetPyramidLevel(pyramid, i);
+        status = cpuAccessImage(level_image[cur], VX_WRITE_ONLY, &level_img[cur]);
+        if (status == VX_SUCCESS)
+            downsampleImage(node, &level_img[prev], &level_img[cur], 5);
+
+        status |= cpuCommitImage(&level_img[prev]);
+        memset(&level_img[prev], 0x0, sizeof(level_img[prev]));
+        vxReleaseImage(&level_image[prev]);
+    }
+
+    for (vx_uint32 i = 0; i < 2; i++) {
+        status |= cpuCommitImage(&level_img[i]);
+        if (level_image[i])
+            vxReleaseImage(&level_image[i]);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("building pyramid fails, err:%d", status);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxHalfscaleGaussianKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status;
+    vx_int32 ksize = 0;
+    struct cpu_image_t in, out;
+
+    if ((node == NULL) || (num != 3)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    status = vxReadScalarValue((vx_scalar)parameters[2], &ksize);
+    if ((status != VX_SUCCESS) || ((ksize != 1) && (ksize != 3) && (ksize != 5))) {
+        VXLOGE("kernel size is not supported, ksize:%d", ksize);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &in);
+    status |= cpuAccessImage((vx_image)parameters[1], VX_WRITE_ONLY, &out);
+    if (status == VX_SUCCESS)
+        downsampleImage(node, &in, &out, (vx_uint32)ksize);
+    else
+        VXLOGE("accessing images fails, err:%d", status);
+
+    status |= cpuCommitImage(&in);
+    status |= cpuCommitImage(&out);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxU8InputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format;
+
+    if (index == 0) {
+        if ((cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+            status = VX_SUCCESS;
+    } else if (index == 2) {
+        vx_enum type = VX_TYPE_INVALID;
+        vx_int32 ksize = 0;
+        if ((cpuQueryScalarParam(node, index, &type, &ksize) == VX_SUCCESS) && (type == VX_TYPE_INT32) &&
+                ((ksize == 1) || (ksize == 3) || (ksize == 5)))
+            status = VX_SUCCESS;
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxGaussianPyramidOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+    vx_df_image format = VX_DF_IMAGE_U8;
+
+    if ((index == 1) && (cpuQueryImageParam(node, 0, &width, &height, NULL) == VX_SUCCESS)) {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_pyramid pyramid = NULL;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &pyramid, sizeof(pyramid));
+            if (pyramid) {
+                vx_size levels = 0;
+                vx_float32 scale = 0;
+
+                vxQueryPyramid(pyramid, VX_PYRAMID_ATTRIBUTE_LEVELS, &levels, sizeof(levels));
+                vxQueryPyramid(pyramid, VX_PYRAMID_ATTRIBUTE_SCALE, &scale, sizeof(scale));
+                vxSetMetaFormatAttribute(meta, VX_PYRAMID_ATTRIBUTE_WIDTH, &width, sizeof(width));
+                vxSetMetaFormatAttribute(meta, VX_PYRAMID_ATTRIBUTE_HEIGHT, &height, sizeof(height));
+                vxSetMetaFormatAttribute(meta, VX_PYRAMID_ATTRIBUTE_FORMAT, &format, sizeof(format));
+                vxSetMetaFormatAttribute(meta, VX_PYRAMID_ATTRIBUTE_LEVELS, &levels, sizeof(levels));
+                vxSetMetaFormatAttribute(meta, VX_PYRAMID_ATTRIBUTE_SCALE, &scale, sizeof(scale));
+
+                if ((scale == VX_SCALE_PYRAMID_HALF) || (scale == VX_SCALE_PYRAMID_ORB))
+                    status = VX_SUCCESS;
+                vxReleasePyramid(&pyramid);
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxHalfscaleGaussianOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+
+    if (index == 1) {
+        status = cpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            cpuSetImageMeta(meta, (width + 1) / 2, (height + 1) / 2, VX_DF_IMAGE_U8);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t gaussian_pyramid_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_PYRAMID, VX_PARAMETER_STATE_REQUIRED},
+};
+
+static vx_param_description_t halfscale_gaussian_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t pyramid_cpu_kernel = {
+    VX_KERNEL_GAUSSIAN_PYRAMID,
+    "org.khronos.openvx.gaussian_pyramid",
+    vxGaussianPyramidKernel,
+    gaussian_pyramid_kernel_params, dimof(gaussian_pyramid_kernel_params),
+    vxU8InputValidator,
+    vxGaussianPyramidOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t halfscalegaussian_cpu_kernel = {
+    VX_KERNEL_HALFSCALE_GAUSSIAN,
+    "org.khronos.openvx.halfscale_gaussian",
+    vxHalfscaleGaussianKernel,
+    halfscale_gaussian_kernel_params, dimof(halfscale_gaussian_kernel_params),
+    vxU8InputValidator,
+    vxHalfscaleGaussianOutputValidator,
+    NULL,
+    NULL,
+};
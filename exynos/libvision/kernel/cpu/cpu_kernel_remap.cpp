@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <string.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+struct remap_tile_t {
+    vx_border_mode_t border;
+    struct cpu_image_t in;
+    struct cpu_image_t out;
+    vx_remap table;
+    vx_enum interpolation;
+};
+
+static void remapTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct remap_tile_t *tile = (struct remap_tile_t*)arg;
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        vx_uint8 *dst = CPU_IMAGE_ROW(&tile->out, 0, vx_uint8, y);
+
+        for (vx_uint32 x = 0; x < tile->out.width; x++) {
+            vx_float32 src_x = 0, src_y = 0;
+
+            if (vxGetRemapPoint(tile->table, x, y, &src_x, &src_y) == VX_SUCCESS)
+                dst[x] = cpuSampleU8(&tile->in, src_x, src_y, tile->interpolation, &tile->border);
+        }
+    }
+}
+
+static vx_status vxRemapKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status;
+    struct remap_tile_t tile;
+
+    if ((node == NULL) || (num != 4)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    memset(&tile, 0x0, sizeof(tile));
+    cpuGetBorderMode(node, &tile.border);
+    tile.table = (vx_remap)parameters[1];
+    tile.interpolation = VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR;
+    if (parameters[2])
+        vxReadScalarValue((vx_scalar)parameters[2], &tile.interpolation);
+
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &tile.in);
+    status |= cpuAccessImage((vx_image)parameters[3], VX_WRITE_ONLY, &tile.out);
+    if (status == VX_SUCCESS)
+        cpuProcessTiles(tile.out.height, remapTile, &tile);
+    else
+        VXLOGE("accessing images fails, err:%d", status);
+
+    status |= cpuCommitImage(&tile.in);
+    status |= cpuCommitImage(&tile.out);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxRemapInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    if (index == 0) {
+        vx_df_image format;
+        if ((cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+            status = VX_SUCCESS;
+    } else if (index == 1) {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_remap table = NULL;
+        vx_uint32 src_width = 0, src_height = 0;
+        vx_uint32 width = 0, height = 0;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &table, sizeof(table));
+            if (table) {
+                vxQueryRemap(table, VX_REMAP_ATTRIBUTE_SOURCE_WIDTH, &src_width, sizeof(src_width));
+                vxQueryRemap(table, VX_REMAP_ATTRIBUTE_SOURCE_HEIGHT, &src_height, sizeof(src_height));
+                if ((cpuQueryImageParam(node, 0, &width, &height, NULL) == VX_SUCCESS) &&
+                        (width == src_width) && (height == src_height))
+                    status = VX_SUCCESS;
+                vxReleaseRemap(&table);
+            }
+            vxReleaseParameter(&param);
+        }
+    } else if (index == 2) {
+        vx_enum type = VX_TYPE_INVALID;
+        vx_enum interpolation = 0;
+        if ((cpuQueryScalarParam(node, index, &type, &interpolation) == VX_SUCCESS) && (type == VX_TYPE_ENUM) &&
+                ((interpolation == VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR) || (interpolation == VX_INTERPOLATION_TYPE_BILINEAR)))
+            status = VX_SUCCESS;
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxRemapOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    if (index == 3) {
+        vx_parameter param = vxGetParameterByIndex(node, 1);
+        vx_remap table = NULL;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &table, sizeof(table));
+            if (table) {
+                vx_uint32 width = 0, height = 0;
+
+                vxQueryRemap(table, VX_REMAP_ATTRIBUTE_DESTINATION_WIDTH, &width, sizeof(width));
+                vxQueryRemap(table, VX_REMAP_ATTRIBUTE_DESTINATION_HEIGHT, &height, sizeof(height));
+                cpuSetImageMeta(meta, width, height, VX_DF_IMAGE_U8);
+                status = VX_SUCCESS;
+                vxReleaseRemap(&table);
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t remap_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_REMAP, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t remap_cpu_kernel = {
+    VX_KERNEL_REMAP,
+    "org.khronos.openvx.remap",
+    vxRemapKernel,
+    remap_kernel_params, dimof(remap_kernel_params),
+    vxRemapInputValidator,
+    vxRemapOutputValidator,
+    NULL,
+    NULL,
+};
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+struct scale_tile_t {
+    vx_border_mode_t border;
+    struct cpu_image_t in;
+    struct cpu_image_t out;
+    vx_enum interpolation;
+    vx_float32 ratio_x;
+    vx_float32 ratio_y;
+    /* source column and its weight of every destination column, computed once per execution */
+    vx_int32 *col_x;
+    vx_float32 *col_weight;
+};
+
+static void scaleNearestRow(struct scale_tile_t *tile, vx_uint32 y, vx_uint8 *dst)
+{
+    vx_int32 src_y = (vx_int32)(((vx_float32)y + 0.5f) * tile->ratio_y);
+    if (src_y >= (vx_int32)tile->in.height)
+        src_y = tile->in.height - 1;
+
+    const vx_uint8 *src = CPU_IMAGE_ROW(&tile->in, 0, vx_uint8, src_y);
+    for (vx_uint32 x = 0; x < tile->out.width; x++)
+        dst[x] = src[tile->col_x[x]];
+}
+
+static void scaleBilinearRow(struct scale_tile_t *tile, vx_uint32 y, vx_uint8 *dst)
+{
+    vx_float32 src_yf = ((vx_float32)y + 0.5f) * tile->ratio_y - 0.5f;
+    vx_int32 y0 = (vx_int32)floorf(src_yf);
+    vx_float32 wy = src_yf - y0;
+
+    for (vx_uint32 x = 0; x < tile->out.width; x++) {
+        vx_int32 x0 = tile->col_x[x];
+        vx_float32 wx = tile->col_weight[x];
+        vx_float32 p00 = cpuGetBorderedPixelU8(&tile->in, x0, y0, &tile->border);
+        vx_float32 p01 = cpuGetBorderedPixelU8(&tile->in, x0 + 1, y0, &tile->border);
+        vx_float32 p10 = cpuGetBorderedPixelU8(&tile->in, x0, y0 + 1, &tile->border);
+        vx_float32 p11 = cpuGetBorderedPixelU8(&tile->in, x0 + 1, y0 + 1, &tile->border);
+        vx_float32 value = (1 - wy) * ((1 - wx) * p00 + wx * p01) + wy * ((1 - wx) * p10 + wx * p11);
+
+        dst[x] = cpuSaturateU8((vx_int32)(value + 0.5f));
+    }
+}
+
+static void scaleAreaRow(struct scale_tile_t *tile, vx_uint32 y, vx_uint8 *dst)
+{
+    vx_int32 y0 = (vx_int32)((vx_float32)y * tile->ratio_y);
+    vx_int32 y1 = (vx_int32)((vx_float32)(y + 1) * tile->ratio_y);
+    if (y1 <= y0)
+        y1 = y0 + 1;
+
+    for (vx_uint32 x = 0; x < tile->out.width; x++) {
+        vx_int32 x0 = (vx_int32)((vx_float32)x * tile->ratio_x);
+        vx_int32 x1 = (vx_int32)((vx_float32)(x + 1) * tile->ratio_x);
+        vx_uint32 sum = 0;
+
+        if (x1 <= x0)
+            x1 = x0 + 1;
+        for (vx_int32 sy = y0; sy < y1; sy++) {
+            for (vx_int32 sx = x0; sx < x1; sx++)
+                sum += cpuGetBorderedPixelU8(&tile->in, sx, sy, &tile->border);
+        }
+
+        vx_uint32 area = (vx_uint32)((y1 - y0) * (x1 - x0));
+        dst[x] = (vx_uint8)((sum + area / 2) / area);
+    }
+}
+
+static void scaleTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct scale_tile_t *tile = (struct scale_tile_t*)arg;
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        vx_uint8 *dst = CPU_IMAGE_ROW(&tile->out, 0, vx_uint8, y);
+
+        switch (tile->interpolation) {
+        case VX_INTERPOLATION_TYPE_BILINEAR:
+            scaleBilinearRow(tile, y, dst);
+            break;
+        case VX_INTERPOLATION_TYPE_AREA:
+            scaleAreaRow(tile, y, dst);
+            break;
+        case VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR:
+        default:
+            scaleNearestRow(tile, y, dst);
+            break;
+        }
+    }
+}
+
+static vx_status vxScaleImageKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status;
+    struct scale_tile_t tile;
+
+    if ((node == NULL) || (num != 3)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    memset(&tile, 0x0, sizeof(tile));
+    cpuGetBorderMode(node, &tile.border);
+    tile.interpolation = VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR;
+    if (parameters[2])
+        vxReadScalarValue((vx_scalar)parameters[2], &tile.interpolation);
+
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &tile.in);
+    status |= cpuAccessImage((vx_image)parameters[1], VX_WRITE_ONLY, &tile.out);
+    if (status != VX_SUCCESS) {
+        VXLOGE("accessing images fails, err:%d", status);
+        goto EXIT;
+    }
+
+    tile.ratio_x = (vx_float32)tile.in.width / tile.out.width;
+    tile.ratio_y = (vx_float32)tile.in.height / tile.out.height;
+    tile.col_x = (vx_int32*)malloc(tile.out.width * sizeof(vx_int32));
+    tile.col_weight = (vx_float32*)malloc(tile.out.width * sizeof(vx_float32));
+    if ((tile.col_x == NULL) || (tile.col_weight == NULL)) {
+        VXLOGE("allocating column table fails");
+        status = VX_ERROR_NO_MEMORY;
+        goto EXIT;
+    }
+
+    for (vx_uint32 x = 0; x < tile.out.width; x++) {
+        if (tile.interpolation == VX_INTERPOLATION_TYPE_BILINEAR) {
+            vx_float32 src_xf = ((vx_float32)x + 0.5f) * tile.ratio_x - 0.5f;
+            tile.col_x[x] = (vx_int32)floorf(src_xf);
+            tile.col_weight[x] = src_xf - tile.col_x[x];
+        } else {
+            vx_int32 src_x = (vx_int32)(((vx_float32)x + 0.5f) * tile.ratio_x);
+            tile.col_x[x] = (src_x < (vx_int32)tile.in.width) ? src_x : (vx_int32)tile.in.width - 1;
+            tile.col_weight[x] = 0;
+        }
+    }
+
+    cpuProcessTiles(tile.out.height, scaleTile, &tile);
+
+EXIT:
+    if (tile.col_x)
+        free(tile.col_x);
+    if (tile.col_weight)
+        free(tile.col_weight);
+
+    status |= cpuCommitImage(&tile.in);
+    status |= cpuCommitImage(&tile.out);
+
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxScaleImageInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    if (index == 0) {
+        vx_df_image format;
+        if ((cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+            status = VX_SUCCESS;
+    } else if (index == 2) {
+        vx_enum type = VX_TYPE_INVALID;
+        vx_enum interpolation = 0;
+        if ((cpuQueryScalarParam(node, index, &type, &interpolation) == VX_SUCCESS) && (type == VX_TYPE_ENUM) &&
+                ((interpolation == VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR) ||
+                (interpolation == VX_INTERPOLATION_TYPE_BILINEAR) ||
+                (interpolation == VX_INTERPOLATION_TYPE_AREA)))
+            status = VX_SUCCESS;
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxScaleImageOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+
+    /* the destination size is given by the user */
+    if (index == 1) {
+        status = cpuQueryImageParam(node, 1, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            cpuSetImageMeta(meta, width, height, VX_DF_IMAGE_U8);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t scale_image_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL},
+};
+
+vx_kernel_description_t scaleimage_cpu_kernel = {
+    VX_KERNEL_SCALE_IMAGE,
+    "org.khronos.openvx.scale_image",
+    vxScaleImageKernel,
+    scale_image_kernel_params, dimof(scale_image_kernel_params),
+    vxScaleImageInputValidator,
+    vxScaleImageOutputValidator,
+    NULL,
+    NULL,
+};
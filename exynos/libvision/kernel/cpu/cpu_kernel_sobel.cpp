@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+struct sobel_tile_t {
+    vx_border_mode_t border;
+    struct cpu_image_t in;
+    struct cpu_image_t out_x;
+    struct cpu_image_t out_y;
+    vx_bool has_x;
+    vx_bool has_y;
+};
+
+#if (CPU_KERNEL_NEON==1)
+static inline int16x8_t loadS16(const vx_uint8 *ptr)
+{
+    return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ptr)));
+}
+
+static vx_uint32 sobelRowNeon(vx_uint8 **rows, vx_int16 *dst_x, vx_int16 *dst_y, vx_uint32 width)
+{
+    vx_uint32 x = 0;
+
+    for (; x + 8 <= width; x += 8) {
+        int16x8_t l0 = loadS16(rows[0] + x - 1), c0 = loadS16(rows[0] + x), r0 = loadS16(rows[0] + x + 1);
+        int16x8_t l1 = loadS16(rows[1] + x - 1), r1 = loadS16(rows[1] + x + 1);
+        int16x8_t l2 = loadS16(rows[2] + x - 1), c2 = loadS16(rows[2] + x), r2 = loadS16(rows[2] + x + 1);
+
+        if (dst_x) {
+            int16x8_t gx = vaddq_s16(vsubq_s16(r0, l0), vsubq_s16(r2, l2));
+            gx = vaddq_s16(gx, vshlq_n_s16(vsubq_s16(r1, l1), 1));
+            vst1q_s16(dst_x + x, gx);
+        }
+        if (dst_y) {
+            int16x8_t gy = vaddq_s16(vsubq_s16(l2, l0), vsubq_s16(r2, r0));
+            gy = vaddq_s16(gy, vshlq_n_s16(vsubq_s16(c2, c0), 1));
+            vst1q_s16(dst_y + x, gy);
+        }
+    }
+
+    return x;
+}
+#endif
+
+static void sobelTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct sobel_tile_t *tile = (struct sobel_tile_t*)arg;
+    vx_uint32 width = tile->in.width;
+    vx_uint8 *rows[3];
+    vx_uint8 *buf;
+
+    buf = (vx_uint8*)malloc((width + 2) * 3);
+    if (buf == NULL) {
+        VXLOGE("allocating row buffer fails");
+        return;
+    }
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        vx_int16 *dst_x = tile->has_x ? CPU_IMAGE_ROW(&tile->out_x, 0, vx_int16, y) : NULL;
+        vx_int16 *dst_y = tile->has_y ? CPU_IMAGE_ROW(&tile->out_y, 0, vx_int16, y) : NULL;
+        vx_uint32 x = 0;
+
+        cpuLoadBorderedRowsU8(&tile->in, y, 1, &tile->border, buf, rows);
+#if (CPU_KERNEL_NEON==1)
+        x = sobelRowNeon(rows, dst_x, dst_y, width);
+#endif
+        for (; x < width; x++) {
+            const vx_uint8 *r0 = rows[0] + x - 1;
+            const vx_uint8 *r1 = rows[1] + x - 1;
+            const vx_uint8 *r2 = rows[2] + x - 1;
+
+            if (dst_x)
+                dst_x[x] = (vx_int16)((r0[2] - r0[0]) + 2 * (r1[2] - r1[0]) + (r2[2] - r2[0]));
+            if (dst_y)
+                dst_y[x] = (vx_int16)((r2[0] - r0[0]) + 2 * (r2[1] - r0[1]) + (r2[2] - r0[2]));
+        }
+    }
+
+    free(buf);
+}
+
+static vx_status processSobel3x3(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    vx_status status;
+    struct sobel_tile_t tile;
+
+    if ((node == NULL) || (num != 3)) {
+        VXLOGE("parameter is wrong, node:%p, num:%d", node, num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    memset(&tile, 0x0, sizeof(tile));
+    cpuGetBorderMode(node, &tile.border);
+    tile.has_x = parameters[1] ? vx_true_e : vx_false_e;
+    tile.has_y = parameters[2] ? vx_true_e : vx_false_e;
+
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &tile.in);
+    if (tile.has_x)
+        status |= cpuAccessImage((vx_image)parameters[1], VX_WRITE_ONLY, &tile.out_x);
+    if (tile.has_y)
+        status |= cpuAccessImage((vx_image)parameters[2], VX_WRITE_ONLY, &tile.out_y);
+    if (status == VX_SUCCESS)
+        cpuProcessTileRange(start_y, end_y, tile.in.height, sobelTile, &tile);
+    else
+        VXLOGE("accessing images fails, err:%d", status);
+
+    status |= cpuCommitImage(&tile.in);
+    status |= cpuCommitImage(&tile.out_x);
+    status |= cpuCommitImage(&tile.out_y);
+
+    return status;
+}
+
+static vx_status vxSobel3x3Kernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = processSobel3x3(node, parameters, num, 0, CPU_KERNEL_ALL_ROWS);
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxSobel3x3Tile(vx_node node, const vx_reference parameters[], vx_uint32 num, vx_uint32 start_y, vx_uint32 end_y)
+{
+    return processSobel3x3(node, parameters, num, start_y, end_y);
+}
+
+static vx_status vxSobel3x3InputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_df_image format;
+
+    if ((index == 0) && (cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+        status = VX_SUCCESS;
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxSobel3x3OutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+
+    if ((index == 1) || (index == 2)) {
+        status = cpuQueryImageParam(node, 0, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            cpuSetImageMeta(meta, width, height, VX_DF_IMAGE_S16);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t sobel3x3_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_OPTIONAL},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_OPTIONAL},
+};
+
+vx_kernel_description_t sobel3x3_cpu_kernel = {
+    VX_KERNEL_SOBEL_3x3,
+    "org.khronos.openvx.sobel_3x3",
+    vxSobel3x3Kernel,
+    sobel3x3_kernel_params, dimof(sobel3x3_kernel_params),
+    vxSobel3x3InputValidator,
+    vxSobel3x3OutputValidator,
+    NULL,
+    NULL,
+};
+
+/* reads one row above and below of the output rows */
+vx_kernel_tile_t sobel3x3_cpu_tile = {
+    vxSobel3x3Tile,
+    1,
+};
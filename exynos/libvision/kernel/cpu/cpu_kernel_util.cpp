@@ -0,0 +1,410 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelUtil"
+#include <cutils/log.h>
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+struct cpu_tile_job_t {
+    cpu_tile_func_t func;
+    void *arg;
+    vx_uint32 start_y;
+    vx_uint32 end_y;
+};
+
+static void* cpuTileThreadFunc(void *data)
+{
+    struct cpu_tile_job_t *job = (struct cpu_tile_job_t*)data;
+
+    job->func(job->arg, job->start_y, job->end_y);
+
+    return NULL;
+}
+
+static vx_uint32 cpuGetThreadNum(void)
+{
+    static vx_uint32 thread_num = 0;
+
+    if (thread_num == 0) {
+        long core_num = sysconf(_SC_NPROCESSORS_ONLN);
+        if (core_num < 1)
+            core_num = 1;
+        if (core_num > CPU_KERNEL_MAX_THREAD_NUM)
+            core_num = CPU_KERNEL_MAX_THREAD_NUM;
+        thread_num = (vx_uint32)core_num;
+    }
+
+    return thread_num;
+}
+
+vx_status cpuAccessImage(vx_image image, vx_enum usage, struct cpu_image_t *img)
+{
+    vx_status status = VX_SUCCESS;
+    vx_uint32 p;
+
+    memset(img, 0x0, sizeof(*img));
+    img->image = image;
+
+    status |= vxQueryImage(image, VX_IMAGE_ATTRIBUTE_WIDTH, &img->width, sizeof(img->width));
+    status |= vxQueryImage(image, VX_IMAGE_ATTRIBUTE_HEIGHT, &img->height, sizeof(img->height));
+    status |= vxQueryImage(image, VX_IMAGE_ATTRIBUTE_FORMAT, &img->format, sizeof(img->format));
+    status |= vxQueryImage(image, VX_IMAGE_ATTRIBUTE_PLANES, &img->planes, sizeof(img->planes));
+    if ((status != VX_SUCCESS) || (img->planes > CPU_KERNEL_MAX_PLANE_NUM)) {
+        VXLOGE("querying image fails, err:%d, planes:%d", status, img->planes);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    img->rect.start_x = 0;
+    img->rect.start_y = 0;
+    img->rect.end_x = img->width;
+    img->rect.end_y = img->height;
+
+    for (p = 0; p < img->planes; p++) {
+        void *ptr = NULL;
+        status = vxAccessImagePatch(image, &img->rect, p, &img->addr[p], &ptr, usage);
+        if (status != VX_SUCCESS) {
+            VXLOGE("accessing plane %d fails, err:%d", p, status);
+            break;
+        }
+        img->base[p] = (vx_uint8*)ptr;
+    }
+
+    if (status != VX_SUCCESS) {
+        /* release the planes already mapped, without writing back */
+        while (p-- > 0) {
+            vxCommitImagePatch(image, NULL, p, &img->addr[p], img->base[p]);
+            img->base[p] = NULL;
+        }
+    }
+
+    return status;
+}
+
+vx_status cpuCommitImage(struct cpu_image_t *img)
+{
+    vx_status status = VX_SUCCESS;
+
+    for (vx_uint32 p = 0; p < img->planes; p++) {
+        if (img->base[p] == NULL)
+            continue;
+
+        status |= vxCommitImagePatch(img->image, &img->rect, p, &img->addr[p], img->base[p]);
+        img->base[p] = NULL;
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("commiting image fails, err:%d", status);
+
+    return status;
+}
+
+void cpuProcessTiles(vx_uint32 height, cpu_tile_func_t func, void *arg)
+{
+    cpuProcessTileRange(0, height, height, func, arg);
+}
+
+void cpuProcessTileRange(vx_uint32 start_y, vx_uint32 end_y, vx_uint32 height, cpu_tile_func_t func, void *arg)
+{
+    if (end_y > height)
+        end_y = height;
+    if (start_y >= end_y)
+        return;
+
+    vx_uint32 rows = end_y - start_y;
+    vx_uint32 tile_num = cpuGetThreadNum();
+    if (tile_num > rows / CPU_KERNEL_MIN_TILE_ROWS)
+        tile_num = rows / CPU_KERNEL_MIN_TILE_ROWS;
+
+    if (tile_num <= 1) {
+        func(arg, start_y, end_y);
+        return;
+    }
+
+    struct cpu_tile_job_t jobs[CPU_KERNEL_MAX_THREAD_NUM];
+    pthread_t threads[CPU_KERNEL_MAX_THREAD_NUM];
+    vx_bool created[CPU_KERNEL_MAX_THREAD_NUM];
+    vx_uint32 tile_rows = (rows + tile_num - 1) / tile_num;
+    vx_uint32 i;
+
+    for (i = 0; i < tile_num; i++) {
+        jobs[i].func = func;
+        jobs[i].arg = arg;
+        jobs[i].start_y = start_y + i * tile_rows;
+        jobs[i].end_y = ((i + 1) * tile_rows < rows) ? start_y + (i + 1) * tile_rows : end_y;
+        created[i] = vx_false_e;
+    }
+
+    /* the first tile is processed by the calling thread */
+    for (i = 1; i < tile_num; i++) {
+        if (pthread_create(&threads[i], NULL, cpuTileThreadFunc, &jobs[i]) == 0)
+            created[i] = vx_true_e;
+        else
+            VXLOGE("creating tile thread fails, tile %d is processed inline", i);
+    }
+
+    cpuTileThreadFunc(&jobs[0]);
+
+    for (i = 1; i < tile_num; i++) {
+        if (created[i])
+            pthread_join(threads[i], NULL);
+        else
+            cpuTileThreadFunc(&jobs[i]);
+    }
+}
+
+vx_status cpuGetBorderMode(vx_node node, vx_border_mode_t *border)
+{
+    vx_status status;
+
+    status = vxQueryNode(node, VX_NODE_ATTRIBUTE_BORDER_MODE, border, sizeof(*border));
+    if (status != VX_SUCCESS) {
+        VXLOGE("querying border mode fails, err:%d", status);
+        border->mode = VX_BORDER_MODE_UNDEFINED;
+        border->constant_value = 0;
+    }
+
+    return status;
+}
+
+void cpuLoadBorderedRowsU8(const struct cpu_image_t *img, vx_int32 y, vx_uint32 radius,
+                                        const vx_border_mode_t *border, vx_uint8 *buf, vx_uint8 **rows)
+{
+    vx_bool constant = (border->mode == VX_BORDER_MODE_CONSTANT) ? vx_true_e : vx_false_e;
+    vx_uint8 constant_value = (vx_uint8)border->constant_value;
+    vx_uint32 width = img->width;
+    vx_uint32 padded_width = width + 2 * radius;
+
+    for (vx_uint32 i = 0; i < 2 * radius + 1; i++) {
+        vx_int32 src_y = y - (vx_int32)radius + (vx_int32)i;
+        vx_uint8 *dst = buf + i * padded_width;
+
+        if ((src_y < 0) || (src_y >= (vx_int32)img->height)) {
+            if (constant) {
+                memset(dst, constant_value, padded_width);
+                rows[i] = dst + radius;
+                continue;
+            }
+            src_y = (src_y < 0) ? 0 : (vx_int32)img->height - 1;
+        }
+
+        const vx_uint8 *src = CPU_IMAGE_ROW(img, 0, vx_uint8, src_y);
+        memcpy(dst + radius, src, width);
+        for (vx_uint32 x = 0; x < radius; x++) {
+            dst[x] = constant ? constant_value : src[0];
+            dst[radius + width + x] = constant ? constant_value : src[width - 1];
+        }
+        rows[i] = dst + radius;
+    }
+}
+
+vx_uint8 cpuGetBorderedPixelU8(const struct cpu_image_t *img, vx_int32 x, vx_int32 y, const vx_border_mode_t *border)
+{
+    if ((x < 0) || (x >= (vx_int32)img->width) || (y < 0) || (y >= (vx_int32)img->height)) {
+        if (border->mode == VX_BORDER_MODE_CONSTANT)
+            return (vx_uint8)border->constant_value;
+
+        x = (x < 0) ? 0 : ((x >= (vx_int32)img->width) ? (vx_int32)img->width - 1 : x);
+        y = (y < 0) ? 0 : ((y >= (vx_int32)img->height) ? (vx_int32)img->height - 1 : y);
+    }
+
+    return CPU_IMAGE_ROW(img, 0, vx_uint8, y)[x];
+}
+
+vx_uint8 cpuSampleU8(const struct cpu_image_t *img, vx_float32 x, vx_float32 y, vx_enum interpolation,
+                                const vx_border_mode_t *border)
+{
+    if (interpolation != VX_INTERPOLATION_TYPE_BILINEAR)
+        return cpuGetBorderedPixelU8(img, (vx_int32)floorf(x + 0.5f), (vx_int32)floorf(y + 0.5f), border);
+
+    vx_int32 x0 = (vx_int32)floorf(x);
+    vx_int32 y0 = (vx_int32)floorf(y);
+    vx_float32 wx = x - x0;
+    vx_float32 wy = y - y0;
+    vx_float32 p00 = cpuGetBorderedPixelU8(img, x0, y0, border);
+    vx_float32 p01 = cpuGetBorderedPixelU8(img, x0 + 1, y0, border);
+    vx_float32 p10 = cpuGetBorderedPixelU8(img, x0, y0 + 1, border);
+    vx_float32 p11 = cpuGetBorderedPixelU8(img, x0 + 1, y0 + 1, border);
+    vx_float32 value = (1 - wy) * ((1 - wx) * p00 + wx * p01) + wy * ((1 - wx) * p10 + wx * p11);
+
+    return cpuSaturateU8((vx_int32)(value + 0.5f));
+}
+
+struct cpu_gradient_tile_t {
+    const struct cpu_image_t *img;
+    vx_border_mode_t border;
+    vx_uint32 ksize;
+    vx_int32 *grad_x;
+    vx_int32 *grad_y;
+};
+
+static const vx_int32 sobel_smooth[3][7] = {
+    {1, 2, 1},
+    {1, 4, 6, 4, 1},
+    {1, 6, 15, 20, 15, 6, 1},
+};
+
+static const vx_int32 sobel_deriv[3][7] = {
+    {-1, 0, 1},
+    {-1, -2, 0, 2, 1},
+    {-1, -4, -5, 0, 5, 4, 1},
+};
+
+static void cpuGradientTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct cpu_gradient_tile_t *tile = (struct cpu_gradient_tile_t*)arg;
+    vx_uint32 width = tile->img->width;
+    vx_uint32 radius = tile->ksize / 2;
+    const vx_int32 *smooth = sobel_smooth[radius - 1];
+    const vx_int32 *deriv = sobel_deriv[radius - 1];
+    vx_uint8 *rows[CPU_KERNEL_MAX_RADIUS * 2 + 1];
+    vx_uint8 *buf;
+
+    buf = (vx_uint8*)malloc((width + radius * 2) * (radius * 2 + 1));
+    if (buf == NULL) {
+        VXLOGE("allocating row buffer fails");
+        return;
+    }
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        vx_int32 *dst_x = tile->grad_x + (vx_size)y * width;
+        vx_int32 *dst_y = tile->grad_y + (vx_size)y * width;
+
+        cpuLoadBorderedRowsU8(tile->img, y, radius, &tile->border, buf, rows);
+        for (vx_uint32 x = 0; x < width; x++) {
+            vx_int32 sum_x = 0, sum_y = 0;
+
+            for (vx_uint32 i = 0; i < tile->ksize; i++) {
+                const vx_uint8 *src = rows[i] + x - radius;
+                vx_int32 row_deriv = 0, row_smooth = 0;
+
+                for (vx_uint32 j = 0; j < tile->ksize; j++) {
+                    row_deriv += deriv[j] * src[j];
+                    row_smooth += smooth[j] * src[j];
+                }
+                sum_x += smooth[i] * row_deriv;
+                sum_y += deriv[i] * row_smooth;
+            }
+            dst_x[x] = sum_x;
+            dst_y[x] = sum_y;
+        }
+    }
+
+    free(buf);
+}
+
+vx_status cpuComputeGradients(const struct cpu_image_t *img, vx_uint32 ksize, vx_int32 *grad_x, vx_int32 *grad_y)
+{
+    struct cpu_gradient_tile_t tile;
+
+    if ((ksize != 3) && (ksize != 5) && (ksize != 7)) {
+        VXLOGE("gradient size is not supported, ksize:%d", ksize);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    tile.img = img;
+    tile.border.mode = VX_BORDER_MODE_REPLICATE;
+    tile.border.constant_value = 0;
+    tile.ksize = ksize;
+    tile.grad_x = grad_x;
+    tile.grad_y = grad_y;
+    cpuProcessTiles(img->height, cpuGradientTile, &tile);
+
+    return VX_SUCCESS;
+}
+
+vx_status cpuQueryImageParam(vx_node node, vx_uint32 index, vx_uint32 *width, vx_uint32 *height, vx_df_image *format)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_image image = 0;
+    vx_parameter param = vxGetParameterByIndex(node, index);
+
+    if (param == NULL) {
+        VXLOGE("getting parameter %d fails", index);
+        return status;
+    }
+
+    vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &image, sizeof(image));
+    if (image) {
+        status = VX_SUCCESS;
+        if (width)
+            status |= vxQueryImage(image, VX_IMAGE_ATTRIBUTE_WIDTH, width, sizeof(*width));
+        if (height)
+            status |= vxQueryImage(image, VX_IMAGE_ATTRIBUTE_HEIGHT, height, sizeof(*height));
+        if (format)
+            status |= vxQueryImage(image, VX_IMAGE_ATTRIBUTE_FORMAT, format, sizeof(*format));
+        vxReleaseImage(&image);
+    }
+    vxReleaseParameter(&param);
+
+    return status;
+}
+
+vx_status cpuQueryScalarParam(vx_node node, vx_uint32 index, vx_enum *type, void *value)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_scalar scalar = 0;
+    vx_parameter param = vxGetParameterByIndex(node, index);
+
+    if (param == NULL) {
+        VXLOGE("getting parameter %d fails", index);
+        return status;
+    }
+
+    vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &scalar, sizeof(scalar));
+    if (scalar) {
+        status = vxQueryScalar(scalar, VX_SCALAR_ATTRIBUTE_TYPE, type, sizeof(*type));
+        if ((status == VX_SUCCESS) && value)
+            status = vxReadScalarValue(scalar, value);
+        vxReleaseScalar(&scalar);
+    }
+    vxReleaseParameter(&param);
+
+    return status;
+}
+
+vx_status cpuCheckSameImageParam(vx_node node, vx_uint32 index1, vx_uint32 index2)
+{
+    vx_status status;
+    vx_uint32 width[2], height[2];
+
+    status = cpuQueryImageParam(node, index1, &width[0], &height[0], NULL);
+    status |= cpuQueryImageParam(node, index2, &width[1], &height[1], NULL);
+    if (status != VX_SUCCESS)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    if ((width[0] != width[1]) || (height[0] != height[1])) {
+        VXLOGE("size of param %d and %d is different, %dx%d, %dx%d", index1, index2, width[0], height[0], width[1], height[1]);
+        return VX_ERROR_INVALID_DIMENSION;
+    }
+
+    return VX_SUCCESS;
+}
+
+void cpuSetImageMeta(vx_meta_format meta, vx_uint32 width, vx_uint32 height, vx_df_image format)
+{
+    vxSetMetaFormatAttribute(meta, VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format));
+    vxSetMetaFormatAttribute(meta, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width));
+    vxSetMetaFormatAttribute(meta, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height));
+}
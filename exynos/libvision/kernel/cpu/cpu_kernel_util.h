@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXYNOS_CPU_KERNEL_UTIL_H
+#define EXYNOS_CPU_KERNEL_UTIL_H
+
+#include <VX/vx.h>
+#include <VX/vx_helper.h>
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CPU_KERNEL_NEON 1
+#else
+#define CPU_KERNEL_NEON 0
+#endif
+
+//#define EXYNOS_CPU_KERNEL_IF_TRACE
+#ifdef EXYNOS_CPU_KERNEL_IF_TRACE
+#define EXYNOS_CPU_KERNEL_IF_IN()   VXLOGD("IN...")
+#define EXYNOS_CPU_KERNEL_IF_OUT()  VXLOGD("OUT..")
+#else
+#define EXYNOS_CPU_KERNEL_IF_IN()   ((void *)0)
+#define EXYNOS_CPU_KERNEL_IF_OUT()  ((void *)0)
+#endif
+
+/* images having less rows than two tiles are processed by the calling thread only */
+#define CPU_KERNEL_MIN_TILE_ROWS    32
+#define CPU_KERNEL_MAX_THREAD_NUM   8
+
+#define CPU_KERNEL_MAX_PLANE_NUM    4
+
+/* largest neighbourhood of the filters, 9x9 of custom convolution */
+#define CPU_KERNEL_MAX_RADIUS       4
+
+struct cpu_image_t {
+    vx_image image;
+    vx_rectangle_t rect;
+    vx_uint32 width;
+    vx_uint32 height;
+    vx_df_image format;
+    vx_size planes;
+    vx_imagepatch_addressing_t addr[CPU_KERNEL_MAX_PLANE_NUM];
+    vx_uint8 *base[CPU_KERNEL_MAX_PLANE_NUM];
+};
+
+/* processes the rows [start_y, end_y) of the output */
+typedef void (*cpu_tile_func_t)(void *arg, vx_uint32 start_y, vx_uint32 end_y);
+
+/* end_y of the kernel functions running the whole image */
+#define CPU_KERNEL_ALL_ROWS         UINT32_MAX
+
+#define CPU_IMAGE_ROW(img, plane, type, y)  ((type*)((img)->base[plane] + (vx_size)(y) * (img)->addr[plane].stride_y))
+
+static inline vx_uint8 cpuSaturateU8(vx_int32 value)
+{
+    return (vx_uint8)((value < 0) ? 0 : ((value > UINT8_MAX) ? UINT8_MAX : value));
+}
+
+static inline vx_int16 cpuSaturateS16(vx_int32 value)
+{
+    return (vx_int16)((value < INT16_MIN) ? INT16_MIN : ((value > INT16_MAX) ? INT16_MAX : value));
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* maps the whole planes of image, it should be committed by cpuCommitImage */
+vx_status cpuAccessImage(vx_image image, vx_enum usage, struct cpu_image_t *img);
+vx_status cpuCommitImage(struct cpu_image_t *img);
+
+/* splits the rows to tiles and processes them on the worker threads and the calling thread */
+void cpuProcessTiles(vx_uint32 height, cpu_tile_func_t func, void *arg);
+/* same as cpuProcessTiles for the rows [start_y, end_y) only, end_y is clipped to height */
+void cpuProcessTileRange(vx_uint32 start_y, vx_uint32 end_y, vx_uint32 height, cpu_tile_func_t func, void *arg);
+
+vx_status cpuGetBorderMode(vx_node node, vx_border_mode_t *border);
+
+/*
+ * Copies 2*radius+1 source rows around y to buf with radius pixels of padding at each side.
+ * Pixels out of image follow the border mode, undefined mode replicates the edge.
+ * rows[i] points the padded row of (y - radius + i), at its first valid pixel.
+ */
+void cpuLoadBorderedRowsU8(const struct cpu_image_t *img, vx_int32 y, vx_uint32 radius,
+                                        const vx_border_mode_t *border, vx_uint8 *buf, vx_uint8 **rows);
+vx_uint8 cpuGetBorderedPixelU8(const struct cpu_image_t *img, vx_int32 x, vx_int32 y, const vx_border_mode_t *border);
+/* samples the sub-pixel position by nearest neighbor or bilinear interpolation */
+vx_uint8 cpuSampleU8(const struct cpu_image_t *img, vx_float32 x, vx_float32 y, vx_enum interpolation,
+                                const vx_border_mode_t *border);
+
+/* sobel derivatives of U8 image with the kernel size 3, 5 or 7, outputs have the stride of image width */
+vx_status cpuComputeGradients(const struct cpu_image_t *img, vx_uint32 ksize, vx_int32 *grad_x, vx_int32 *grad_y);
+
+/* helpers of validators */
+vx_status cpuQueryImageParam(vx_node node, vx_uint32 index, vx_uint32 *width, vx_uint32 *height, vx_df_image *format);
+vx_status cpuQueryScalarParam(vx_node node, vx_uint32 index, vx_enum *type, void *value);
+vx_status cpuCheckSameImageParam(vx_node node, vx_uint32 index1, vx_uint32 index2);
+void cpuSetImageMeta(vx_meta_format meta, vx_uint32 width, vx_uint32 height, vx_df_image format);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosCpuKernelInterface"
+#include <cutils/log.h>
+
+#include <string.h>
+
+#include "ExynosVisionCommonConfig.h"
+
+#include "cpu_kernel_util.h"
+
+struct warp_tile_t {
+    vx_border_mode_t border;
+    struct cpu_image_t in;
+    struct cpu_image_t out;
+    vx_enum interpolation;
+    vx_bool perspective;
+    /* m[i][j] is the coefficient of the i-th input term for the j-th output coordinate */
+    vx_float32 m[3][3];
+};
+
+static void warpTile(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    struct warp_tile_t *tile = (struct warp_tile_t*)arg;
+    vx_float32 (*m)[3] = tile->m;
+
+    for (vx_uint32 y = start_y; y < end_y; y++) {
+        vx_uint8 *dst = CPU_IMAGE_ROW(&tile->out, 0, vx_uint8, y);
+
+        /* the source position moves linearly along the row, only the increments are added per pixel */
+        vx_float32 src_x = m[1][0] * y + m[2][0];
+        vx_float32 src_y = m[1][1] * y + m[2][1];
+        vx_float32 src_z = tile->perspective ? (m[1][2] * y + m[2][2]) : 1.0f;
+
+        for (vx_uint32 x = 0; x < tile->out.width; x++) {
+            if (tile->perspective) {
+                vx_float32 z = (src_z != 0.0f) ? src_z : 1.0f;
+                dst[x] = cpuSampleU8(&tile->in, src_x / z, src_y / z, tile->interpolation, &tile->border);
+                src_z += m[0][2];
+            } else {
+                dst[x] = cpuSampleU8(&tile->in, src_x, src_y, tile->interpolation, &tile->border);
+            }
+            src_x += m[0][0];
+            src_y += m[0][1];
+        }
+    }
+}
+
+static vx_status processWarp(vx_node node, vx_bool perspective, const vx_reference parameters[], vx_uint32 num)
+{
+    vx_status status;
+    struct warp_tile_t tile;
+
+    if (num != 4) {
+        VXLOGE("parameter number is wrong, num:%d", num);
+        return VX_ERROR_INVALID_PARAMETERS;
+    }
+
+    memset(&tile, 0x0, sizeof(tile));
+    cpuGetBorderMode(node, &tile.border);
+    tile.perspective = perspective;
+    tile.interpolation = VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR;
+    if (parameters[2])
+        vxReadScalarValue((vx_scalar)parameters[2], &tile.interpolation);
+
+    if (perspective) {
+        status = vxReadMatrix((vx_matrix)parameters[1], tile.m);
+    } else {
+        vx_float32 affine[3][2];
+        status = vxReadMatrix((vx_matrix)parameters[1], affine);
+        for (vx_uint32 i = 0; i < 3; i++) {
+            tile.m[i][0] = affine[i][0];
+            tile.m[i][1] = affine[i][1];
+        }
+    }
+    if (status != VX_SUCCESS) {
+        VXLOGE("reading matrix fails, err:%d", status);
+        return status;
+    }
+
+    status = cpuAccessImage((vx_image)parameters[0], VX_READ_ONLY, &tile.in);
+    status |= cpuAccessImage((vx_image)parameters[3], VX_WRITE_ONLY, &tile.out);
+    if (status == VX_SUCCESS)
+        cpuProcessTiles(tile.out.height, warpTile, &tile);
+    else
+        VXLOGE("accessing images fails, err:%d", status);
+
+    status |= cpuCommitImage(&tile.in);
+    status |= cpuCommitImage(&tile.out);
+
+    return status;
+}
+
+static vx_status vxWarpAffineKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = node ? processWarp(node, vx_false_e, parameters, num) : VX_ERROR_INVALID_NODE;
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status vxWarpPerspectiveKernel(vx_node node, const vx_reference parameters[], vx_uint32 num)
+{
+    EXYNOS_CPU_KERNEL_IF_IN();
+    vx_status status = node ? processWarp(node, vx_true_e, parameters, num) : VX_ERROR_INVALID_NODE;
+    EXYNOS_CPU_KERNEL_IF_OUT();
+
+    return status;
+}
+
+static vx_status validateWarpInput(vx_node node, vx_uint32 index, vx_size matrix_cols)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+
+    if (index == 0) {
+        vx_df_image format;
+        if ((cpuQueryImageParam(node, index, NULL, NULL, &format) == VX_SUCCESS) && (format == VX_DF_IMAGE_U8))
+            status = VX_SUCCESS;
+    } else if (index == 1) {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        vx_matrix matrix = NULL;
+
+        if (param) {
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &matrix, sizeof(matrix));
+            if (matrix) {
+                vx_enum type = 0;
+                vx_size rows = 0, cols = 0;
+
+                vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_TYPE, &type, sizeof(type));
+                vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_ROWS, &rows, sizeof(rows));
+                vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_COLUMNS, &cols, sizeof(cols));
+                if ((type == VX_TYPE_FLOAT32) && (cols == matrix_cols) && (rows == 3))
+                    status = VX_SUCCESS;
+                vxReleaseMatrix(&matrix);
+            }
+            vxReleaseParameter(&param);
+        }
+    } else if (index == 2) {
+        vx_enum type = VX_TYPE_INVALID;
+        vx_enum interpolation = 0;
+        if ((cpuQueryScalarParam(node, index, &type, &interpolation) == VX_SUCCESS) && (type == VX_TYPE_ENUM) &&
+                ((interpolation == VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR) || (interpolation == VX_INTERPOLATION_TYPE_BILINEAR)))
+            status = VX_SUCCESS;
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("input validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_status vxWarpAffineInputValidator(vx_node node, vx_uint32 index)
+{
+    return validateWarpInput(node, index, 2);
+}
+
+static vx_status vxWarpPerspectiveInputValidator(vx_node node, vx_uint32 index)
+{
+    return validateWarpInput(node, index, 3);
+}
+
+static vx_status vxWarpOutputValidator(vx_node node, vx_uint32 index, vx_meta_format meta)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    vx_uint32 width, height;
+
+    /* the destination size is given by the user */
+    if (index == 3) {
+        status = cpuQueryImageParam(node, 3, &width, &height, NULL);
+        if (status == VX_SUCCESS)
+            cpuSetImageMeta(meta, width, height, VX_DF_IMAGE_U8);
+    }
+
+    if (status != VX_SUCCESS)
+        VXLOGE("output validation fails at index %d, err:%d", index, status);
+
+    return status;
+}
+
+static vx_param_description_t warp_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_MATRIX, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL},
+    {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t warpaffine_cpu_kernel = {
+    VX_KERNEL_WARP_AFFINE,
+    "org.khronos.openvx.warp_affine",
+    vxWarpAffineKernel,
+    warp_kernel_params, dimof(warp_kernel_params),
+    vxWarpAffineInputValidator,
+    vxWarpOutputValidator,
+    NULL,
+    NULL,
+};
+
+vx_kernel_description_t warpperspective_cpu_kernel = {
+    VX_KERNEL_WARP_PERSPECTIVE,
+    "org.khronos.openvx.warp_perspective",
+    vxWarpPerspectiveKernel,
+    warp_kernel_params, dimof(warp_kernel_params),
+    vxWarpPerspectiveInputValidator,
+    vxWarpOutputValidator,
+    NULL,
+    NULL,
+};
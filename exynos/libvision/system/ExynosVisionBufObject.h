@@ -68,6 +68,10 @@ public:
     {
         return m_fd;
     }
+    vx_uint32 getSize(void)
+    {
+        return m_buffer_size;
+    }
 
     vx_status alloc(ExynosVisionAllocator *allocator, vx_uint32 buf_size);
     vx_status import(void *ptr, int fd);
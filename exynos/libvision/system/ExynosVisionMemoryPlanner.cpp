@@ -0,0 +1,393 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosVisionMemoryPlanner"
+#include <cutils/log.h>
+
+#include "ExynosVisionMemoryPlanner.h"
+
+#include "ExynosVisionGraph.h"
+#include "ExynosVisionNode.h"
+
+namespace android {
+
+ExynosVisionArenaAllocator::ExynosVisionArenaAllocator(const Vector<ExynosVisionBufMemory*> &buf_vector, const Vector<vx_size> &size_vector)
+{
+    m_buf_vector = buf_vector;
+    m_size_vector = size_vector;
+    m_next_index = 0;
+}
+
+ExynosVisionArenaAllocator::~ExynosVisionArenaAllocator()
+{
+
+}
+
+status_t
+ExynosVisionArenaAllocator::init(bool isCached)
+{
+    VXLOGD3("arena is already allocated, isCached:%d", isCached);
+
+    return NO_ERROR;
+}
+
+status_t
+ExynosVisionArenaAllocator::alloc_mem(
+        int size,
+        int *fd,
+        char **addr,
+        bool mapNeeded)
+{
+    if (m_next_index >= m_buf_vector.size()) {
+        VXLOGE("arena has only %d memory, mapNeeded:%d", m_buf_vector.size(), mapNeeded);
+        return NO_MEMORY;
+    }
+
+    if ((vx_size)size > m_size_vector[m_next_index]) {
+        VXLOGE("memory[%d] of arena is smaller than request, %d > %d", m_next_index, size, m_size_vector[m_next_index]);
+        return NO_MEMORY;
+    }
+
+    ExynosVisionBufMemory *buf = m_buf_vector[m_next_index];
+    *fd = buf->getFd();
+    *addr = buf->getAddr();
+    m_next_index++;
+
+    return NO_ERROR;
+}
+
+status_t
+ExynosVisionArenaAllocator::free_mem(
+        int size,
+        int *fd,
+        char **addr,
+        bool mapNeeded)
+{
+    /* memory of arena is freed by memory planner */
+    VXLOGD3("release arena memory, size:%d, mapNeeded:%d", size, mapNeeded);
+
+    *fd = -1;
+    *addr = NULL;
+
+    return NO_ERROR;
+}
+
+ExynosVisionMemoryPlanner::ExynosVisionMemoryPlanner(ExynosVisionGraph *graph)
+{
+    m_graph = graph;
+    m_allocator = NULL;
+
+    m_planned_size = 0;
+    m_unplanned_size = 0;
+    m_planned_ref_num = 0;
+}
+
+ExynosVisionMemoryPlanner::~ExynosVisionMemoryPlanner()
+{
+
+}
+
+vx_status
+ExynosVisionMemoryPlanner::destroy(void)
+{
+    vx_status status = VX_SUCCESS;
+
+    List<memory_arena_t*>::iterator arena_iter;
+    for (arena_iter=m_arena_list.begin(); arena_iter!=m_arena_list.end(); arena_iter++) {
+        memory_arena_t *arena = *arena_iter;
+        for (vx_uint32 i = 0; i < arena->buf_vector.size(); i++) {
+            if (arena->buf_vector[i]->free(m_allocator) != VX_SUCCESS) {
+                VXLOGE("freeing arena memory fails");
+                status = VX_FAILURE;
+            }
+            delete arena->buf_vector[i];
+        }
+        delete arena;
+    }
+    m_arena_list.clear();
+
+    if (m_allocator) {
+        delete m_allocator;
+        m_allocator = NULL;
+    }
+
+    m_planned_size = 0;
+    m_unplanned_size = 0;
+    m_planned_ref_num = 0;
+
+    return status;
+}
+
+vx_status
+ExynosVisionMemoryPlanner::makeAncestorTable(List<ExynosVisionNode*> *sorted_node_list)
+{
+    vx_uint32 node_num = sorted_node_list->size();
+    vx_uint32 i = 0;
+
+    m_node_order_map.clear();
+    m_ancestor_vector.clear();
+    m_ancestor_vector.insertAt(vx_false_e, 0, node_num * node_num);
+
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=sorted_node_list->begin(); node_iter!=sorted_node_list->end(); node_iter++, i++) {
+        ExynosVisionNode *node = *node_iter;
+        m_node_order_map[node] = i;
+
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if ((data_ref == NULL) || (node->getKernelHandle()->getParamDirection(p) != VX_INPUT))
+                continue;
+
+            for (vx_uint32 w = 0; w < data_ref->getDirectInputNodeNum(m_graph); w++) {
+                ExynosVisionNode *writer = data_ref->getDirectInputNode(m_graph, w);
+                if (m_node_order_map.find(writer) == m_node_order_map.end())
+                    continue;
+
+                /* writer is sorted before, its ancestors are already complete */
+                vx_uint32 j = m_node_order_map[writer];
+                m_ancestor_vector.editItemAt(i * node_num + j) = vx_true_e;
+                for (vx_uint32 k = 0; k < node_num; k++) {
+                    if (m_ancestor_vector[j * node_num + k])
+                        m_ancestor_vector.editItemAt(i * node_num + k) = vx_true_e;
+                }
+            }
+        }
+    }
+
+    return VX_SUCCESS;
+}
+
+vx_bool
+ExynosVisionMemoryPlanner::isAncestor(ExynosVisionNode *node, ExynosVisionNode *ancestor_node)
+{
+    if ((m_node_order_map.find(node) == m_node_order_map.end()) ||
+        (m_node_order_map.find(ancestor_node) == m_node_order_map.end()))
+        return vx_false_e;
+
+    vx_uint32 node_num = m_node_order_map.size();
+
+    return m_ancestor_vector[m_node_order_map[node] * node_num + m_node_order_map[ancestor_node]];
+}
+
+vx_bool
+ExynosVisionMemoryPlanner::isPlannable(ExynosVisionDataReference *data_ref)
+{
+    if ((data_ref->isVirtual() == vx_false_e) || (data_ref->isAllocated() == vx_true_e))
+        return vx_false_e;
+
+    /* objects of child graph or delay could be accessed out of this graph */
+    if ((data_ref->getScope() != (ExynosVisionReference*)m_graph) || (data_ref->isDelayElement() == vx_true_e) ||
+        (data_ref->isQueue() == vx_true_e))
+        return vx_false_e;
+
+    if ((data_ref->getType() != VX_TYPE_IMAGE) && (data_ref->getType() != VX_TYPE_ARRAY))
+        return vx_false_e;
+
+    if ((data_ref->getDirectInputNodeNum(m_graph) != 1) ||
+        (data_ref->getDirectInputNodeNum(m_graph) != data_ref->getIndirectInputNodeNum(m_graph)) ||
+        (data_ref->getDirectOutputNodeNum(m_graph) != data_ref->getIndirectOutputNodeNum(m_graph)))
+        return vx_false_e;
+
+    return vx_true_e;
+}
+
+vx_bool
+ExynosVisionMemoryPlanner::isArenaFree(memory_arena_t *arena, ExynosVisionNode *writer)
+{
+    ExynosVisionDataReference *last_ref = arena->last_ref;
+
+    /* the last owner is not read by anyone, the writer of it should be finished */
+    if (last_ref->getDirectOutputNodeNum(m_graph) == 0) {
+#if (GRAPH_NODE_TILING==1)
+        if ((writer->getSubgraph() != NULL) && (writer->getSubgraph() == arena->last_writer->getSubgraph()))
+            return vx_false_e;
+#endif
+        return isAncestor(writer, arena->last_writer);
+    }
+
+    for (vx_uint32 i = 0; i < last_ref->getDirectOutputNodeNum(m_graph); i++) {
+        ExynosVisionNode *reader = last_ref->getDirectOutputNode(m_graph, i);
+        if (isAncestor(writer, reader) == vx_false_e)
+            return vx_false_e;
+#if (GRAPH_NODE_TILING==1)
+        /* fused nodes could run band by band, so the reader isn't finished when the writer starts */
+        if ((writer->getSubgraph() != NULL) && (writer->getSubgraph() == reader->getSubgraph()))
+            return vx_false_e;
+#endif
+    }
+
+    return vx_true_e;
+}
+
+vx_size
+ExynosVisionMemoryPlanner::getArenaGrowth(memory_arena_t *arena, const Vector<vx_size> &size_vector)
+{
+    vx_size growth = 0;
+
+    for (vx_uint32 i = 0; i < size_vector.size(); i++) {
+        if (i >= arena->size_vector.size())
+            growth += size_vector[i];
+        else if (size_vector[i] > arena->size_vector[i])
+            growth += size_vector[i] - arena->size_vector[i];
+    }
+
+    return growth;
+}
+
+vx_status
+ExynosVisionMemoryPlanner::allocateArena(memory_arena_t *arena)
+{
+    vx_status status = VX_SUCCESS;
+
+    if (m_allocator == NULL) {
+        m_allocator = new ExynosVisionIonAllocator();
+        status_t ret = m_allocator->init(true);
+        if (ret != NO_ERROR) {
+            VXLOGE("ion allocator's init fail, ret:%d", ret);
+            return VX_ERROR_NO_RESOURCES;
+        }
+    }
+
+    for (vx_uint32 i = 0; i < arena->size_vector.size(); i++) {
+        ExynosVisionBufMemory *buf = new ExynosVisionBufMemory();
+        status = buf->alloc(m_allocator, arena->size_vector[i]);
+        if (status != VX_SUCCESS) {
+            VXLOGE("arena allocation fails, size:%d", arena->size_vector[i]);
+            delete buf;
+            break;
+        }
+
+        arena->buf_vector.push_back(buf);
+    }
+
+    return status;
+}
+
+vx_status
+ExynosVisionMemoryPlanner::planMemory(List<ExynosVisionNode*> *sorted_node_list)
+{
+    EXYNOS_VISION_SYSTEM_IN();
+
+    vx_status status = VX_SUCCESS;
+    List<memory_arena_t*> new_arena_list;
+    List<memory_arena_t*>::iterator arena_iter;
+
+    makeAncestorTable(sorted_node_list);
+
+    /* linear scan in topological order, the output takes the arena that grows least */
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=sorted_node_list->begin(); node_iter!=sorted_node_list->end(); node_iter++) {
+        ExynosVisionNode *node = *node_iter;
+
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if ((data_ref == NULL) || (node->getKernelHandle()->getParamDirection(p) != VX_OUTPUT))
+                continue;
+
+            if (isPlannable(data_ref) == vx_false_e)
+                continue;
+
+            Vector<vx_size> size_vector;
+            if (data_ref->getMemorySize(&size_vector) != VX_SUCCESS)
+                continue;
+
+            memory_arena_t *best_arena = NULL;
+            vx_size best_growth = 0;
+            for (arena_iter=new_arena_list.begin(); arena_iter!=new_arena_list.end(); arena_iter++) {
+                if (isArenaFree(*arena_iter, node) == vx_false_e)
+                    continue;
+
+                vx_size growth = getArenaGrowth(*arena_iter, size_vector);
+                if ((best_arena == NULL) || (growth < best_growth)) {
+                    best_arena = *arena_iter;
+                    best_growth = growth;
+                }
+            }
+
+            if (best_arena == NULL) {
+                best_arena = new memory_arena_t;
+                best_arena->requested_size = 0;
+                new_arena_list.push_back(best_arena);
+            }
+
+            for (vx_uint32 i = 0; i < size_vector.size(); i++) {
+                if (i >= best_arena->size_vector.size())
+                    best_arena->size_vector.push_back(size_vector[i]);
+                else if (size_vector[i] > best_arena->size_vector[i])
+                    best_arena->size_vector.editItemAt(i) = size_vector[i];
+
+                best_arena->requested_size += size_vector[i];
+            }
+
+            best_arena->last_ref = data_ref;
+            best_arena->last_writer = node;
+            best_arena->ref_list.push_back(data_ref);
+
+            VXLOGD2("%s is planned to arena_%d", data_ref->getName(), m_arena_list.size() + new_arena_list.size());
+        }
+    }
+
+    for (arena_iter=new_arena_list.begin(); arena_iter!=new_arena_list.end(); arena_iter++) {
+        memory_arena_t *arena = *arena_iter;
+        m_arena_list.push_back(arena);
+
+        /* objects fall back to their own memory if arena can't be allocated */
+        if (allocateArena(arena) != VX_SUCCESS)
+            continue;
+
+        for (vx_uint32 i = 0; i < arena->size_vector.size(); i++)
+            m_planned_size += arena->size_vector[i];
+        m_unplanned_size += arena->requested_size;
+
+        List<ExynosVisionDataReference*>::iterator ref_iter;
+        for (ref_iter=arena->ref_list.begin(); ref_iter!=arena->ref_list.end(); ref_iter++) {
+            status = (*ref_iter)->setPlannedAllocator(new ExynosVisionArenaAllocator(arena->buf_vector, arena->size_vector));
+            if (status != VX_SUCCESS) {
+                VXLOGE("%s can't be planned, err:%d", (*ref_iter)->getName(), status);
+                break;
+            }
+            m_planned_ref_num++;
+        }
+    }
+
+    m_node_order_map.clear();
+    m_ancestor_vector.clear();
+
+    EXYNOS_VISION_SYSTEM_OUT();
+
+    return status;
+}
+
+void
+ExynosVisionMemoryPlanner::displayInfo(vx_uint32 tab_num, vx_bool detail_info)
+{
+    vx_char tap[MAX_TAB_NUM];
+
+    VXLOGI("%s[Memory ] planned object:%d, arena:%d, peak:%d bytes, without planner:%d bytes", MAKE_TAB(tap, tab_num),
+                                                                        m_planned_ref_num, m_arena_list.size(), m_planned_size, m_unplanned_size);
+
+    if (detail_info == vx_true_e) {
+        vx_uint32 i = 0;
+        List<memory_arena_t*>::iterator arena_iter;
+        for (arena_iter=m_arena_list.begin(); arena_iter!=m_arena_list.end(); arena_iter++, i++) {
+            List<ExynosVisionDataReference*>::iterator ref_iter;
+            for (ref_iter=(*arena_iter)->ref_list.begin(); ref_iter!=(*arena_iter)->ref_list.end(); ref_iter++)
+                VXLOGI("%s          arena_%d:%s", MAKE_TAB(tap, tab_num), i, (*ref_iter)->getName());
+        }
+    }
+}
+
+}; /* namespace android */
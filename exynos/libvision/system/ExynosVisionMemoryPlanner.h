@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXYNOS_VISION_MEMORY_PLANNER_H
+#define EXYNOS_VISION_MEMORY_PLANNER_H
+
+#include <map>
+
+#include <utils/List.h>
+#include <utils/Vector.h>
+
+#include <VX/vx.h>
+
+#include "ExynosVisionMemoryAllocator.h"
+#include "ExynosVisionBufObject.h"
+
+namespace android {
+
+using namespace std;
+
+class ExynosVisionGraph;
+class ExynosVisionNode;
+class ExynosVisionDataReference;
+
+/* allocator handing out the buffers of an arena, the arena keeps the ownership of them */
+class ExynosVisionArenaAllocator : public ExynosVisionAllocator {
+private:
+    Vector<ExynosVisionBufMemory*> m_buf_vector;
+    Vector<vx_size> m_size_vector;
+    vx_uint32 m_next_index;
+
+public:
+    ExynosVisionArenaAllocator(const Vector<ExynosVisionBufMemory*> &buf_vector, const Vector<vx_size> &size_vector);
+    virtual ~ExynosVisionArenaAllocator();
+
+    virtual status_t init(bool isCached);
+    virtual status_t alloc_mem(
+            int size,
+            int *fd,
+            char **addr,
+            bool mapNeeded);
+    virtual status_t free_mem(
+            int size,
+            int *fd,
+            char **addr,
+            bool mapNeeded);
+};
+
+/*
+ * Virtual objects whose lifetimes don't overlap share the memory of an arena.
+ * A virtual object could take over an arena when every reader of the last owner
+ * is an ancestor of its writer, so that the reuse is safe even if independent
+ * branches of graph are executed concurrently.
+ */
+class ExynosVisionMemoryPlanner {
+private:
+    typedef struct _memory_arena_t {
+        /* size of each memory plane */
+        Vector<vx_size> size_vector;
+        Vector<ExynosVisionBufMemory*> buf_vector;
+        ExynosVisionDataReference *last_ref;
+        ExynosVisionNode *last_writer;
+        List<ExynosVisionDataReference*> ref_list;
+        /* sum of memory that the objects request */
+        vx_size requested_size;
+    } memory_arena_t;
+
+    ExynosVisionGraph *m_graph;
+    ExynosVisionAllocator *m_allocator;
+
+    List<memory_arena_t*> m_arena_list;
+
+    /* memory of arenas, and memory that the planned objects would take without planner */
+    vx_size m_planned_size;
+    vx_size m_unplanned_size;
+    vx_uint32 m_planned_ref_num;
+
+    /* ancestor[i * node_num + j] is true if node j should be finished before node i starts */
+    map<ExynosVisionNode*, vx_uint32> m_node_order_map;
+    Vector<vx_bool> m_ancestor_vector;
+
+private:
+    vx_status makeAncestorTable(List<ExynosVisionNode*> *sorted_node_list);
+    vx_bool isAncestor(ExynosVisionNode *node, ExynosVisionNode *ancestor_node);
+    vx_bool isPlannable(ExynosVisionDataReference *data_ref);
+    vx_bool isArenaFree(memory_arena_t *arena, ExynosVisionNode *writer);
+    vx_size getArenaGrowth(memory_arena_t *arena, const Vector<vx_size> &size_vector);
+    vx_status allocateArena(memory_arena_t *arena);
+
+public:
+    /* Constructor */
+    ExynosVisionMemoryPlanner(ExynosVisionGraph *graph);
+
+    /* Destructor */
+    virtual ~ExynosVisionMemoryPlanner();
+
+    /* assign arena to unallocated virtual objects, it should be called before data references are allocated */
+    vx_status planMemory(List<ExynosVisionNode*> *sorted_node_list);
+    vx_status destroy(void);
+
+    vx_size getPlannedSize(void)
+    {
+        return m_planned_size;
+    }
+    vx_size getUnplannedSize(void)
+    {
+        return m_unplanned_size;
+    }
+
+    void displayInfo(vx_uint32 tab_num, vx_bool detail_info);
+};
+
+}; // namespace android
+#endif
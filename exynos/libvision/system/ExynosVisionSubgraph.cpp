@@ -23,6 +23,7 @@
 
 #include "ExynosVisionGraph.h"
 #include "ExynosVisionBufObject.h"
+#include "ExynosVisionImage.h"
 
 #define BIT_FLAG(i) ((1<<i))
 
@@ -46,6 +47,7 @@ ExynosVisionSubgraph::ExynosVisionSubgraph(ExynosVisionGraph *graph)
     m_graph = graph;
 
     m_represent_node = NULL;
+    m_tail_node = NULL;
 
     m_params = NULL;
     m_message_queue = NULL;
@@ -58,6 +60,13 @@ ExynosVisionSubgraph::ExynosVisionSubgraph(ExynosVisionGraph *graph)
     m_complete_event = NULL;
 
     m_last_process_frame = 0;
+
+    m_worker_pool = NULL;
+    m_task_scheduled = vx_false_e;
+
+    m_tiling = vx_false_e;
+    m_tile_height = 0;
+    m_tile_rows = 0;
 }
 
 ExynosVisionSubgraph::~ExynosVisionSubgraph(void)
@@ -69,6 +78,7 @@ vx_status
 ExynosVisionSubgraph::init(ExynosVisionNode *node)
 {
     m_represent_node = node;
+    m_tail_node = node;
     m_id = node->getId();
 
     sprintf(m_sg_name, "SG_%d-%s", m_id, m_represent_node->getKernelHandle()->getKernelFuncName());
@@ -80,6 +90,25 @@ ExynosVisionSubgraph::init(ExynosVisionNode *node)
     return VX_SUCCESS;
 }
 
+vx_status
+ExynosVisionSubgraph::addNode(ExynosVisionNode *node)
+{
+    if (m_represent_node == NULL) {
+        VXLOGE("subgraph is not initialized");
+        return VX_FAILURE;
+    }
+
+    m_node_list.push_back(node);
+    m_tail_node = node;
+
+    vx_uint32 name_len = strlen(m_sg_name);
+    snprintf(&m_sg_name[name_len], sizeof(m_sg_name) - name_len, "+%s", node->getKernelHandle()->getKernelFuncName());
+
+    VXLOGD2("%s, fusing %s", getSgName(), node->getName());
+
+    return VX_SUCCESS;
+}
+
 vx_status
 ExynosVisionSubgraph::destroy(void)
 {
@@ -106,61 +135,139 @@ ExynosVisionSubgraph::destroy(void)
     return status;
 }
 
+vx_bool
+ExynosVisionSubgraph::containNode(ExynosVisionNode *node)
+{
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        if (*node_iter == node)
+            return vx_true_e;
+    }
+
+    return vx_false_e;
+}
+
+vx_bool
+ExynosVisionSubgraph::isInternalDataRef(ExynosVisionDataReference *data_ref)
+{
+    if ((data_ref == NULL) || (m_node_list.size() < 2))
+        return vx_false_e;
+
+    /* queue, delay and alliance object could be accessed by somebody else */
+    if ((data_ref->isQueue() == vx_true_e) || (data_ref->isDelayElement() == vx_true_e) ||
+        (data_ref->getDirectInputNodeNum(m_graph) != data_ref->getIndirectInputNodeNum(m_graph)) ||
+        (data_ref->getDirectOutputNodeNum(m_graph) != data_ref->getIndirectOutputNodeNum(m_graph)))
+        return vx_false_e;
+
+    if ((data_ref->getDirectInputNodeNum(m_graph) == 0) || (data_ref->getDirectOutputNodeNum(m_graph) == 0))
+        return vx_false_e;
+
+    for (vx_uint32 i = 0; i < data_ref->getDirectInputNodeNum(m_graph); i++) {
+        if (containNode(data_ref->getDirectInputNode(m_graph, i)) == vx_false_e)
+            return vx_false_e;
+    }
+    for (vx_uint32 i = 0; i < data_ref->getDirectOutputNodeNum(m_graph); i++) {
+        if (containNode(data_ref->getDirectOutputNode(m_graph, i)) == vx_false_e)
+            return vx_false_e;
+    }
+
+    return vx_true_e;
+}
+
 vx_status
 ExynosVisionSubgraph::makeInputOutputPort(void)
 {
     EXYNOS_VISION_SYSTEM_IN();
 
     vx_status status = VX_SUCCESS;
+    vx_uint32 max_param_num = 0;
 
     m_target_done_bitmask = 0;
 
     m_input_data_ref_list.clear();
     m_output_data_ref_list.clear();
+    m_internal_data_ref_list.clear();
+    m_node_info_list.clear();
 
-    for (vx_uint32 p = 0; p < m_represent_node->getDataRefNum(); p++) {
-        ExynosVisionDataReference *data_ref = m_represent_node->getDataRefByIndex(p);
-        if ((data_ref == NULL) && m_represent_node->getKernelHandle()->getParamState(p) == VX_PARAMETER_STATE_REQUIRED) {
-            VXLOGE("%s(%s) does not have necessary parameter[%d]", m_represent_node->getName(), m_represent_node->getKernelName(), p);
-        }
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        ExynosVisionNode *node = *node_iter;
 
-        ref_connect_info_t connect_info;
-        connect_info.ref = data_ref;
-        connect_info.node_index = p;
+        sg_node_info_t node_info;
+        node_info.node = node;
+#if (GRAPH_NODE_TILING==1)
+        node_info.tile_halo = 0;
+#endif
 
-        if (m_represent_node->getKernelHandle()->getParamDirection(p) == VX_INPUT) {
-            m_input_data_ref_list.push_back(connect_info);
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if ((data_ref == NULL) && node->getKernelHandle()->getParamState(p) == VX_PARAMETER_STATE_REQUIRED) {
+                VXLOGE("%s(%s) does not have necessary parameter[%d]", node->getName(), node->getKernelName(), p);
+            }
 
-            /* exclusive object doesn't need to receive doen event */
-            if ((data_ref != NULL) &&
-                ((data_ref->getIndirectInputNodeNum(m_graph) != 0) || (data_ref->isQueue()))) {
-                m_target_done_bitmask |= BIT_FLAG(p);
+            ref_connect_info_t connect_info;
+            connect_info.ref = data_ref;
+            connect_info.node = node;
+            connect_info.node_index = p;
+
+            /* data reference between fused nodes is handed over in the thread of subgraph */
+            vx_bool internal = isInternalDataRef(data_ref);
+
+            if (node->getKernelHandle()->getParamDirection(p) == VX_INPUT) {
+                node_info.input_list.push_back(connect_info);
+                if (internal)
+                    continue;
+
+                /* exclusive object doesn't need to receive doen event */
+                if ((data_ref != NULL) &&
+                    ((data_ref->getIndirectInputNodeNum(m_graph) != 0) || (data_ref->isQueue()))) {
+                    m_target_done_bitmask |= BIT_FLAG(m_input_data_ref_list.size());
+                }
+                m_input_data_ref_list.push_back(connect_info);
+            } else {
+                node_info.output_list.push_back(connect_info);
+                if (internal) {
+                    m_internal_data_ref_list.push_back(data_ref);
+                    continue;
+                }
+
+                m_output_data_ref_list.push_back(connect_info);
             }
-        } else {
-            m_output_data_ref_list.push_back(connect_info);
         }
+
+        if (max_param_num < node_info.input_list.size() + node_info.output_list.size())
+            max_param_num = node_info.input_list.size() + node_info.output_list.size();
+
+        m_node_info_list.push_back(node_info);
+    }
+
+    if (m_input_data_ref_list.size() > sizeof(m_target_done_bitmask) * 8) {
+        VXLOGE("%s has too many input port:%d", getSgName(), m_input_data_ref_list.size());
+        status = VX_ERROR_NO_RESOURCES;
     }
 
-    m_param_num = m_input_data_ref_list.size() + m_output_data_ref_list.size();
+    m_param_num = max_param_num;
     m_params = new ExynosVisionDataReference*[m_param_num];
 
     EXYNOS_VISION_SYSTEM_OUT();
 
-    return VX_SUCCESS;
+    return status;
 }
 
 vx_status
-ExynosVisionSubgraph::replaceDataRef(ExynosVisionDataReference *old_ref, ExynosVisionDataReference *new_ref, vx_uint32 node_index, enum vx_direction_e dir)
+ExynosVisionSubgraph::replaceDataRef(ExynosVisionDataReference *old_ref, ExynosVisionDataReference *new_ref, ExynosVisionNode *node, vx_uint32 node_index, enum vx_direction_e dir)
 {
     EXYNOS_VISION_SYSTEM_IN();
 
     vx_status status = VX_FAILURE;
     vx_bool result = vx_false_e;
 
-    List<ExynosVisionNode*>::iterator node_iter;
+    List<sg_node_info_t>::iterator node_info_iter;
     List<ref_connect_info_t>::iterator ref_iter;
+    List<ExynosVisionDataReference*>::iterator internal_iter;
 
     List<ref_connect_info_t> *data_ref_list;
+    List<ref_connect_info_t> *port_list;
 
     Mutex::Autolock lock(m_exec_mutex);
 
@@ -177,29 +284,56 @@ ExynosVisionSubgraph::replaceDataRef(ExynosVisionDataReference *old_ref, ExynosV
         goto EXIT;
     }
 
-    if (dir == VX_INPUT)
-        data_ref_list = &m_input_data_ref_list;
-    else
-        data_ref_list = &m_output_data_ref_list;
+    /* data reference between fused nodes doesn't have a port, graph should be verified again */
+    for (internal_iter=m_internal_data_ref_list.begin(); internal_iter!=m_internal_data_ref_list.end(); internal_iter++) {
+        if (*internal_iter == old_ref) {
+            VXLOGE("%s is fused in %s, cannot replace it", old_ref->getName(), getSgName());
+            status = VX_FAILURE;
+            goto EXIT;
+        }
+    }
+
+    for (node_info_iter=m_node_info_list.begin(); node_info_iter!=m_node_info_list.end(); node_info_iter++) {
+        if ((*node_info_iter).node == node)
+            break;
+    }
+
+    if (node_info_iter == m_node_info_list.end()) {
+        VXLOGE("%s doesn't have %s", getSgName(), node->getName());
+        status = VX_FAILURE;
+        goto EXIT;
+    }
+
+    if (dir == VX_INPUT) {
+        data_ref_list = &(*node_info_iter).input_list;
+        port_list = &m_input_data_ref_list;
+    } else {
+        data_ref_list = &(*node_info_iter).output_list;
+        port_list = &m_output_data_ref_list;
+    }
 
     for (ref_iter=data_ref_list->begin(); ref_iter!=data_ref_list->end(); ref_iter++) {
         if (((*ref_iter).ref == old_ref) && ((*ref_iter).node_index == node_index)){
-            ref_iter = data_ref_list->erase(ref_iter);
-
-            ref_connect_info_t connect_info = { new_ref, node_index};
-            data_ref_list->insert(ref_iter, connect_info);
+            (*ref_iter).ref = new_ref;
             result = vx_true_e;
             break;
         }
     }
 
+    for (ref_iter=port_list->begin(); ref_iter!=port_list->end(); ref_iter++) {
+        if (((*ref_iter).ref == old_ref) && ((*ref_iter).node == node) && ((*ref_iter).node_index == node_index)){
+            (*ref_iter).ref = new_ref;
+            break;
+        }
+    }
+
     if (result != vx_true_e) {
         VXLOGE("can't replace %s to %s at %s", old_ref->getName(), new_ref->getName(), this->getSgName());
 
         for (ref_iter=data_ref_list->begin(); ref_iter!=data_ref_list->end(); ref_iter++) {
             VXLOGD("ref:%s, node_index:%d", (*ref_iter).ref->getName(), (*ref_iter).node_index);
         }
-        m_represent_node->displayInfo(0, vx_true_e);
+        node->displayInfo(0, vx_true_e);
 
         status = VX_FAILURE;
     } else {
@@ -220,18 +354,31 @@ ExynosVisionSubgraph::allocateDataRefMemory(void)
     vx_status status = VX_SUCCESS;
 
     /* allocation reference object memory */
-    for (vx_uint32 p = 0; p < m_represent_node->getDataRefNum(); p++) {
-        ExynosVisionDataReference *data_ref = m_represent_node->getDataRefByIndex(p);
-        if (data_ref == NULL)
-            continue;
-
-        if (data_ref->isAllocated() == vx_false_e) {
-            VXLOGD2("%s, allocating memory", data_ref->getName());
-            status = data_ref->allocateMemory();
-            if (status != VX_SUCCESS)
-                VXLOGE("data_ref(%s) allocation memory fail, error:%d", data_ref->getName(), status);
-        } else {
-            VXLOGD2("%s, memory is already allocated", data_ref->getName());
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        ExynosVisionNode *node = *node_iter;
+
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if (data_ref == NULL)
+                continue;
+
+            if (data_ref->isAllocated() == vx_false_e) {
+                VXLOGD2("%s, allocating memory", data_ref->getName());
+                if ((m_graph->getExecMode() == GRAPH_EXEC_STREAM) && (data_ref->isVirtual() == vx_true_e) &&
+                    (isInternalDataRef(data_ref) == vx_true_e)) {
+                    /* writer and reader of fused data reference run in turn, single slot is enough */
+                    struct resource_param res_param;
+                    res_param.param.slot_param.slot_num = 1;
+                    status = data_ref->allocateMemory(RESOURCE_MNGR_SLOT, &res_param);
+                } else {
+                    status = data_ref->allocateMemory();
+                }
+                if (status != VX_SUCCESS)
+                    VXLOGE("data_ref(%s) allocation memory fail, error:%d", data_ref->getName(), status);
+            } else {
+                VXLOGD2("%s, memory is already allocated", data_ref->getName());
+            }
         }
     }
 
@@ -252,22 +399,43 @@ ExynosVisionSubgraph::fixSubgraph(void)
         VXLOGE("making port fails, err:%d", status);
     }
 
+#if (GRAPH_NODE_TILING==1)
+    /* the nodes and their ports are fixed from here */
+    status = configureTiling();
+    if (status != VX_SUCCESS) {
+        VXLOGE("configuring tiling fails, err:%d", status);
+    }
+#endif
+
     status = allocateDataRefMemory();
     if (status != VX_SUCCESS) {
         VXLOGE("allocating memory fails, err:%d", status);
     }
 
     if (m_graph->getPerfMonitor() != NULL) {
-        m_graph->getPerfMonitor()->registerObjectForTrace(m_represent_node, NODE_TIMEPAIR_NUMBER);
+        List<ExynosVisionNode*>::iterator node_iter;
+        for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++)
+            m_graph->getPerfMonitor()->registerObjectForTrace(*node_iter, NODE_TIMEPAIR_NUMBER);
     } else {
         VXLOGE("performance monitor is not assigned");
     }
 
     m_last_process_frame = 0;
 
-    m_message_queue = new sg_msg_queue_t(0);
-    m_main_thread = new ExynosVisionThread<ExynosVisionSubgraph>(this, &ExynosVisionSubgraph::mainThreadFunc, "subgraph", PRIORITY_DEFAULT);
-    m_main_thread->run();
+    m_worker_pool = NULL;
+#if (GRAPH_WORKER_POOL==1)
+    /* a slot of stream mode could block the worker until the next subgraph releases it, so stream mode keeps own thread */
+    if (m_graph->getExecMode() == GRAPH_EXEC_NORMAL)
+        m_worker_pool = m_graph->getContext()->getWorkerPool();
+#endif
+
+    if (m_worker_pool) {
+        m_thread_state.setState(THREAD_STATE_WAIT_DONE);
+    } else {
+        m_message_queue = new sg_msg_queue_t(0);
+        m_main_thread = new ExynosVisionThread<ExynosVisionSubgraph>(this, &ExynosVisionSubgraph::mainThreadFunc, "subgraph", PRIORITY_DEFAULT);
+        m_main_thread->run();
+    }
 
     EXYNOS_VISION_SYSTEM_OUT();
 
@@ -275,14 +443,15 @@ ExynosVisionSubgraph::fixSubgraph(void)
 }
 
 vx_bool
-ExynosVisionSubgraph::verifyPopedEvent(ExynosVisionDataReference *data_ref, vx_uint32 node_index)
+ExynosVisionSubgraph::verifyPopedEvent(ExynosVisionDataReference *data_ref, ExynosVisionNode *node, vx_uint32 node_index, vx_uint32 *ret_port_index)
 {
     vx_uint32 i;
     vx_bool result = vx_false_e;
 
     List<ref_connect_info_t>::iterator ref_iter;
     for (ref_iter=m_input_data_ref_list.begin(), i=0; ref_iter!=m_input_data_ref_list.end(); ref_iter++, i++) {
-        if (((*ref_iter).ref == data_ref) && ((*ref_iter).node_index == node_index)) {
+        if (((*ref_iter).ref == data_ref) && ((*ref_iter).node == node) && ((*ref_iter).node_index == node_index)) {
+            *ret_port_index = i;
             result = vx_true_e;
             break;
         }
@@ -290,27 +459,48 @@ ExynosVisionSubgraph::verifyPopedEvent(ExynosVisionDataReference *data_ref, vx_u
 
     if (result != vx_true_e) {
         VXLOGE("[%s] data reference is not found", getSgName());
-        VXLOGD("ref:%s, node_index:%d", data_ref->getName(), node_index);
-        m_represent_node->displayInfo(0, vx_true_e);
+        VXLOGD("ref:%s, node:%s, node_index:%d", data_ref->getName(), node->getName(), node_index);
+        node->displayInfo(0, vx_true_e);
 
         for (ref_iter=m_input_data_ref_list.begin(), i=0; ref_iter!=m_input_data_ref_list.end(); ref_iter++, i++)
-            VXLOGD("input_list, ref:%s, node_index:%d", (*ref_iter).ref->getName(), (*ref_iter).node_index);
+            VXLOGD("input_list, ref:%s, node:%s, node_index:%d", (*ref_iter).ref->getName(), (*ref_iter).node->getName(), (*ref_iter).node_index);
     }
 
     return result;
 }
 
 vx_status
-ExynosVisionSubgraph::pushDoneEvent(vx_uint32 frame_cnt, ExynosVisionDataReference *ref, vx_uint32 node_index)
+ExynosVisionSubgraph::pushDoneEvent(vx_uint32 frame_cnt, ExynosVisionDataReference *ref, ExynosVisionNode *node, vx_uint32 node_index)
 {
     subgraph_message_t sg_msg;
     sg_msg.type = SG_MESSAGE_DONE_EVENT;
     sg_msg.frame_cnt = frame_cnt;
     sg_msg.done_reference = ref;
+    sg_msg.done_node = node;
     sg_msg.node_index = node_index;
 
     VXLOGTD("push done event: %s, frame(%d)", ref->getName(), frame_cnt);
 
+    if (m_worker_pool) {
+        vx_status status = VX_SUCCESS;
+        vx_uint32 port_index;
+
+        Mutex::Autolock lock(m_sched_mutex);
+
+        if (verifyPopedEvent(ref, node, node_index, &port_index) != vx_true_e) {
+            VXLOGE("done event doesn't match input reference information");
+            return VX_ERROR_INVALID_REFERENCE;
+        }
+
+        m_ready_bitmask_map[frame_cnt] |= BIT_FLAG(port_index);
+        if (m_ready_bitmask_map[frame_cnt] == m_target_done_bitmask) {
+            m_ready_bitmask_map.erase(frame_cnt);
+            status = scheduleReadyFrame(frame_cnt);
+        }
+
+        return status;
+    }
+
     m_message_queue->pushProcessQ(&sg_msg);
 
     return VX_SUCCESS;
@@ -323,15 +513,84 @@ ExynosVisionSubgraph::pushTrigger(vx_uint32 frame_cnt)
     sg_msg.type = SG_MESSAGE_TRIGGER;
     sg_msg.frame_cnt = frame_cnt;
     sg_msg.done_reference = NULL;
+    sg_msg.done_node = NULL;
     sg_msg.node_index = 0;
 
     VXLOGTD("push trigger:frame_%d", frame_cnt);
 
+    if (m_worker_pool) {
+        Mutex::Autolock lock(m_sched_mutex);
+
+        if (m_target_done_bitmask != 0x0) {
+            VXLOGE("Cannot receiving trigger when bitmask is %p, %s", m_target_done_bitmask, getSgName());
+            return VX_FAILURE;
+        }
+
+        return scheduleReadyFrame(frame_cnt);
+    }
+
     m_message_queue->pushProcessQ(&sg_msg);
 
     return VX_SUCCESS;
 }
 
+vx_status
+ExynosVisionSubgraph::scheduleReadyFrame(vx_uint32 frame_cnt)
+{
+    vx_status status = VX_SUCCESS;
+
+    /* the caller holds m_sched_mutex */
+    m_ready_frame_list.push_back(frame_cnt);
+
+    if (m_task_scheduled == vx_false_e) {
+        status = m_worker_pool->pushTask(workerTaskFunc, this);
+        if (status == VX_SUCCESS)
+            m_task_scheduled = vx_true_e;
+        else
+            VXLOGE("%s cannot push task to worker pool, err:%d", getSgName(), status);
+    }
+
+    return status;
+}
+
+void
+ExynosVisionSubgraph::workerTaskFunc(void *arg)
+{
+    ExynosVisionSubgraph *subgraph = (ExynosVisionSubgraph*)arg;
+
+    subgraph->processReadyFrame();
+}
+
+void
+ExynosVisionSubgraph::processReadyFrame(void)
+{
+    vx_status status;
+    vx_uint32 frame_cnt;
+    graph_exec_mode_t exec_mode = m_graph->getExecMode();
+
+    while (1) {
+        m_sched_mutex.lock();
+        if (m_ready_frame_list.empty()) {
+            m_task_scheduled = vx_false_e;
+            m_sched_cond.broadcast();
+            m_sched_mutex.unlock();
+            break;
+        }
+
+        List<vx_uint32>::iterator frame_iter = m_ready_frame_list.begin();
+        frame_cnt = *frame_iter;
+        m_ready_frame_list.erase(frame_iter);
+        m_sched_mutex.unlock();
+
+        /* successors are scheduled directly from the done events of this frame */
+        status = processFrame(frame_cnt, exec_mode);
+        if (status != VX_SUCCESS) {
+            displayInfo(0, vx_true_e);
+            m_graph->pushErrorEvent(this, status);
+        }
+    }
+}
+
 queue_exception_t
 ExynosVisionSubgraph::popDoneEvent(vx_uint32 *ret_frame_cnt)
 {
@@ -363,12 +622,13 @@ ExynosVisionSubgraph::popDoneEvent(vx_uint32 *ret_frame_cnt)
         ready_frame_cnt = sg_msg.frame_cnt;
     } else {
         while(1) {
-            if (verifyPopedEvent(sg_msg.done_reference, sg_msg.node_index) != vx_true_e) {
+            vx_uint32 port_index;
+            if (verifyPopedEvent(sg_msg.done_reference, sg_msg.done_node, sg_msg.node_index, &port_index) != vx_true_e) {
                 VXLOGE("poped event doesn't match input reference information");
                 break;
             }
 
-            m_ready_bitmask_map[sg_msg.frame_cnt] |= BIT_FLAG(sg_msg.node_index);
+            m_ready_bitmask_map[sg_msg.frame_cnt] |= BIT_FLAG(port_index);
             VXLOGTD("pop done: %s, frame(%d), ready_bitmask:%p, target_bitmask:%p", sg_msg.done_reference->getName(), sg_msg.frame_cnt,
                                                                                                                                m_ready_bitmask_map[sg_msg.frame_cnt], m_target_done_bitmask);
 
@@ -396,7 +656,7 @@ EXIT:
 }
 
 vx_status
-ExynosVisionSubgraph::getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode, vx_bool *ret_data_valid)
+ExynosVisionSubgraph::getSrcRef(List<ref_connect_info_t> *input_list, vx_uint32 frame_cnt, graph_exec_mode_t exec_mode, vx_bool *ret_data_valid)
 {
     vx_status status = VX_SUCCESS;
     *ret_data_valid = vx_true_e;
@@ -407,14 +667,14 @@ ExynosVisionSubgraph::getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
     /* prevent to get shared reference several times */
     map<ExynosVisionDataReference*, ExynosVisionDataReference*> ref_clone_map;
 
-    for (ref_iter=m_input_data_ref_list.begin(); ref_iter!=m_input_data_ref_list.end(); ref_iter++) {
+    for (ref_iter=input_list->begin(); ref_iter!=input_list->end(); ref_iter++) {
         ExynosVisionDataReference* ref_represent;
         ExynosVisionDataReference* ref_clone;
 
         ref_represent = (*ref_iter).ref;
         if (ref_represent == NULL) {
             /* null parameter, it could be optional parameter */
-            ref_connect_info_t connect_info = {NULL, (*ref_iter).node_index};
+            ref_connect_info_t connect_info = {NULL, (*ref_iter).node, (*ref_iter).node_index};
             m_cur_input_data_ref_list.push_back(connect_info);
             continue;
         }
@@ -427,7 +687,7 @@ ExynosVisionSubgraph::getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
                 ref_clone ->increaseKernelCount();
-                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node_index};
+                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node, (*ref_iter).node_index};
                 m_cur_input_data_ref_list.push_back(connect_info);
             }
         } else {
@@ -444,7 +704,7 @@ ExynosVisionSubgraph::getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
                 ref_clone ->increaseKernelCount();
-                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node_index};
+                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node, (*ref_iter).node_index};
                 m_cur_input_data_ref_list.push_back(connect_info);
             }
         }
@@ -454,7 +714,7 @@ ExynosVisionSubgraph::getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
 }
 
 vx_status
-ExynosVisionSubgraph::getDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode)
+ExynosVisionSubgraph::getDstRef(List<ref_connect_info_t> *output_list, vx_uint32 frame_cnt, graph_exec_mode_t exec_mode)
 {
     vx_status status = VX_SUCCESS;
     List<ref_connect_info_t>::iterator ref_iter;
@@ -463,14 +723,14 @@ ExynosVisionSubgraph::getDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
     /* prevent to get shared reference several times */
     map<ExynosVisionDataReference*, ExynosVisionDataReference*> ref_clone_map;
 
-    for (ref_iter=m_output_data_ref_list.begin(); ref_iter!=m_output_data_ref_list.end(); ref_iter++) {
+    for (ref_iter=output_list->begin(); ref_iter!=output_list->end(); ref_iter++) {
         ExynosVisionDataReference* ref_represent;
         ExynosVisionDataReference* ref_clone;
 
         ref_represent = (*ref_iter).ref;
         if (ref_represent == NULL) {
             /* null parameter, it could be optional parameter */
-            ref_connect_info_t connect_info = {NULL, (*ref_iter).node_index};
+            ref_connect_info_t connect_info = {NULL, (*ref_iter).node, (*ref_iter).node_index};
             m_cur_output_data_ref_list.push_back(connect_info);
             continue;
         }
@@ -483,7 +743,7 @@ ExynosVisionSubgraph::getDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
                 ref_clone ->increaseKernelCount();
-                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node_index};
+                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node, (*ref_iter).node_index};
                 m_cur_output_data_ref_list.push_back(connect_info);
             }
         } else {
@@ -500,7 +760,7 @@ ExynosVisionSubgraph::getDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
                 status = VX_ERROR_INVALID_REFERENCE;
             } else {
                 ref_clone ->increaseKernelCount();
-                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node_index};
+                ref_connect_info_t connect_info = {ref_clone, (*ref_iter).node, (*ref_iter).node_index};
                 m_cur_output_data_ref_list.push_back(connect_info);
             }
         }
@@ -510,7 +770,7 @@ ExynosVisionSubgraph::getDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
 }
 
 vx_status
-ExynosVisionSubgraph::kernelProcess(vx_uint32 frame_cnt)
+ExynosVisionSubgraph::kernelProcess(ExynosVisionNode *node, vx_uint32 frame_cnt)
 {
     vx_status status = VX_FAILURE;
 
@@ -527,8 +787,10 @@ ExynosVisionSubgraph::kernelProcess(vx_uint32 frame_cnt)
         m_params[(*ref_iter).node_index] = (*ref_iter).ref;
     }
 
-    const ExynosVisionKernel *kernel = m_represent_node->getKernelHandle();
-    status = kernel->kernelFunction(m_represent_node, (const ExynosVisionDataReference **)m_params, m_param_num);
+    vx_uint32 param_num = m_cur_input_data_ref_list.size() + m_cur_output_data_ref_list.size();
+
+    const ExynosVisionKernel *kernel = node->getKernelHandle();
+    status = kernel->kernelFunction(node, (const ExynosVisionDataReference **)m_params, param_num);
 
 EXIT:
 
@@ -536,7 +798,7 @@ EXIT:
 }
 
 vx_status
-ExynosVisionSubgraph::putSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode)
+ExynosVisionSubgraph::putSrcRef(List<ref_connect_info_t> *input_list, vx_uint32 frame_cnt, graph_exec_mode_t exec_mode)
 {
     vx_status status = VX_SUCCESS;
 
@@ -553,7 +815,7 @@ ExynosVisionSubgraph::putSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
             ref_clone ->decreaseKernelCount();
     }
 
-    for (ref_iter=m_input_data_ref_list.begin(); ref_iter!=m_input_data_ref_list.end(); ref_iter++) {
+    for (ref_iter=input_list->begin(); ref_iter!=input_list->end(); ref_iter++) {
         ExynosVisionDataReference* ref_represent = (*ref_iter).ref;
 
         /* null parameter, it could be optional parameter */
@@ -586,7 +848,7 @@ ExynosVisionSubgraph::putSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
 }
 
 vx_status
-ExynosVisionSubgraph::putDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode, vx_bool data_valid)
+ExynosVisionSubgraph::putDstRef(List<ref_connect_info_t> *output_list, vx_uint32 frame_cnt, graph_exec_mode_t exec_mode, vx_bool data_valid)
 {
     vx_status status = VX_SUCCESS;
 
@@ -602,7 +864,7 @@ ExynosVisionSubgraph::putDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode
             ref_clone ->decreaseKernelCount();
     }
 
-    for (ref_iter=m_output_data_ref_list.begin(); ref_iter!=m_output_data_ref_list.end(); ref_iter++) {
+    for (ref_iter=output_list->begin(); ref_iter!=output_list->end(); ref_iter++) {
         ExynosVisionDataReference* ref_represent = (*ref_iter).ref;
 
         /* null parameter, it could be optional parameter */
@@ -666,12 +928,21 @@ ExynosVisionSubgraph::exitThread()
     status_t ret;
     vx_status status = VX_SUCCESS;
 
-    m_main_thread->requestExit();
-    m_message_queue->wakeupPendingThreadAndQDisable();
-    ret = m_main_thread->requestExitAndWait();
-    if (ret != NO_ERROR) {
-        VXLOGE("thread of subgraph cann't exit, ret:%d", ret);
-        status = VX_FAILURE;
+    if (m_worker_pool) {
+        /* frames not started yet are dropped as the message queue does, the running one is waited */
+        m_sched_mutex.lock();
+        m_ready_frame_list.clear();
+        while (m_task_scheduled == vx_true_e)
+            m_sched_cond.wait(m_sched_mutex);
+        m_sched_mutex.unlock();
+    } else if (m_main_thread != NULL) {
+        m_main_thread->requestExit();
+        m_message_queue->wakeupPendingThreadAndQDisable();
+        ret = m_main_thread->requestExitAndWait();
+        if (ret != NO_ERROR) {
+            VXLOGE("thread of subgraph cann't exit, ret:%d", ret);
+            status = VX_FAILURE;
+        }
     }
     VXLOGTD("finishing to exit thread");
 
@@ -706,131 +977,385 @@ ExynosVisionSubgraph::waitSubgraphComplete(vx_uint64 wait_time)
     return status;
 }
 
-#if (DISPLAY_PROCESS_GRAPH_TIME==1)
-#include "ExynosVisionAutoTimer.h"
-#endif
-
-bool
-ExynosVisionSubgraph::mainThreadFunc(void)
+vx_status
+ExynosVisionSubgraph::processNode(sg_node_info_t *node_info, vx_uint32 frame_cnt, graph_exec_mode_t exec_mode)
 {
-    queue_exception_t exception;
-    vx_status status = VX_FAILURE;
-    vx_uint32 frame_cnt;
-    graph_exec_mode_t exec_mode = m_graph->getExecMode();
+    vx_status status = VX_SUCCESS;
+    ExynosVisionNode *node = node_info->node;
 
-    m_thread_state.setState(THREAD_STATE_WAIT_DONE);
-    VXLOGTD("waiting message");
-    exception = popDoneEvent(&frame_cnt);
-    VXLOGTD("receive message, exception:%d, frame_%d, exec:%d", exception, frame_cnt, exec_mode);
+    node->informKernelStart(frame_cnt);
 
-    if (exception == QUEUE_EXCEPTION_TIME_OUT) {
-        VXLOGE("queuing fails, excepton:%d", exception);
-        status = VX_FAILURE;
+    /* just handover frame count and error to next subgraph if the execution of previous subgraph fails */
+    m_thread_state.setState(THREAD_STATE_GET_INPUT);
+    VXLOGTD("getSrcRef");
+    vx_bool input_data_valid, output_data_valid;
+    status = getSrcRef(&node_info->input_list, frame_cnt, exec_mode, &input_data_valid);
+    if (status != VX_SUCCESS) {
+        VXLOGE("%s failed to getting src ref of %s", m_sg_name, node->getName());
+        goto EXIT;
+    }
+
+    m_thread_state.setState(THREAD_STATE_GET_OUTPUT);
+    VXLOGTD("getDstRef");
+    status = getDstRef(&node_info->output_list, frame_cnt, exec_mode);
+    if (status != VX_SUCCESS) {
+        VXLOGE("%s failed to getting dst ref of %s", m_sg_name, node->getName());
+        goto EXIT;
+    }
+
+    if (input_data_valid == vx_true_e) {
+        m_thread_state.setState(THREAD_STATE_EXE_KERNEL);
+        VXLOGTD("kernelProcess start");
+        VXLOGD2("%s process %s, frame_%d", m_sg_name, node->getName(), frame_cnt);
+        status = kernelProcess(node, frame_cnt);
+        if (status == VX_SUCCESS) {
+            output_data_valid = vx_true_e;
+        } else {
+            output_data_valid = vx_false_e;
+            VXLOGE("%s failed to process kernel function of %s", m_sg_name, node->getName());
+
+            /* Marking only single-frame as bad instead of stopping graph in stream mode */
+            if (exec_mode == GRAPH_EXEC_NORMAL) {
+                goto EXIT;
+            }
+        }
+        VXLOGTD("kernelProcess end");
+
+        /* node call back check */
+        if (node->m_callback) {
+            vx_action action;
+            action = node->m_callback((vx_node)node);
+            if (action == VX_ACTION_ABANDON) {
+                VXLOGE("abandon graph due to callback from %s", node->getName());
+                status = VX_ERROR_GRAPH_ABANDONED;
+                goto EXIT;
+            }
+        }
     } else {
-        status = VX_SUCCESS;
+        VXLOGE("receiving data is not valid");
+        output_data_valid = vx_false_e;
+    }
+
+    m_thread_state.setState(THREAD_STATE_PUT_INPUT);
+    VXLOGTD("putSrcRef");
+    status = putSrcRef(&node_info->input_list, frame_cnt, exec_mode);
+    if (status != VX_SUCCESS) {
+        VXLOGE("%s failed to putting src ref of %s", m_sg_name, node->getName());
+        goto EXIT;
     }
 
-    m_exec_mutex.lock();
+    /* invalid output is handed over to the next fused node as well */
+    m_thread_state.setState(THREAD_STATE_PUT_OUTPUT);
+    VXLOGTD("putDstRef");
+    status = putDstRef(&node_info->output_list, frame_cnt, exec_mode, output_data_valid);
+    if (status != VX_SUCCESS) {
+        VXLOGE("%s failed to putting dst ref of %s", m_sg_name, node->getName());
+        goto EXIT;
+    }
 
-    if (frame_cnt && status == VX_SUCCESS) {
-        VXLOGTD("%s, start frame_%d", getSgName(), frame_cnt);
-        m_represent_node->informKernelStart(frame_cnt);
+    node->informKernelEnd(frame_cnt, status);
 
-#if (DISPLAY_PROCESS_GRAPH_TIME==1)
-        uint64_t start_time, end_time;
-        start_time = ExynosVisionDurationTimer::getTimeUs();
-#endif
+EXIT:
+    return status;
+}
+
+#if (GRAPH_NODE_TILING==1)
+vx_status
+ExynosVisionSubgraph::configureTiling(void)
+{
+    vx_uint32 height = 0;
+    vx_size row_bytes = 0;
+
+    m_tiling = vx_false_e;
+
+    /* slots of stream mode are exchanged per frame, and a single node has nothing to keep in cache */
+    if ((m_graph->getExecMode() != GRAPH_EXEC_NORMAL) || (m_node_info_list.size() < 2))
+        return VX_SUCCESS;
+
+    List<ExynosVisionDataReference*> image_list;
+    List<ExynosVisionDataReference*>::iterator image_iter;
+    List<ExynosVisionNode*>::iterator node_iter;
+    for (node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        ExynosVisionNode *node = *node_iter;
+
+        if (node->getKernelHandle()->isTilable() == vx_false_e) {
+            VXLOGD2("%s, %s can't process a band", getSgName(), node->getKernelName());
+            return VX_SUCCESS;
+        }
+
+        for (vx_uint32 p = 0; p < node->getDataRefNum(); p++) {
+            ExynosVisionDataReference *data_ref = node->getDataRefByIndex(p);
+            if ((data_ref == NULL) || (data_ref->getType() != VX_TYPE_IMAGE))
+                continue;
+
+            if (data_ref->isQueue() == vx_true_e)
+                return VX_SUCCESS;
+
+            for (image_iter=image_list.begin(); image_iter!=image_list.end(); image_iter++) {
+                if (*image_iter == data_ref)
+                    break;
+            }
+            if (image_iter != image_list.end())
+                continue;
+
+            ExynosVisionImage *image = (ExynosVisionImage*)data_ref;
+            vx_uint32 image_height = 0;
+            vx_size image_size = 0;
+            vx_status status = image->queryImage(VX_IMAGE_ATTRIBUTE_HEIGHT, &image_height, sizeof(image_height));
+            status |= image->queryImage(VX_IMAGE_ATTRIBUTE_SIZE, &image_size, sizeof(image_size));
+            if ((status != VX_SUCCESS) || (image_height == 0)) {
+                VXLOGE("%s, querying %s fails, err:%d", getSgName(), data_ref->getName(), status);
+                return status;
+            }
+
+            /* the row of a band is the same row of every image */
+            if ((height != 0) && (height != image_height)) {
+                VXLOGD2("%s, %s has different height %d from %d", getSgName(), data_ref->getName(), image_height, height);
+                return VX_SUCCESS;
+            }
+
+            height = image_height;
+            row_bytes += image_size / image_height;
+            image_list.push_back(data_ref);
+        }
+    }
+
+    if ((height == 0) || (row_bytes == 0))
+        return VX_SUCCESS;
+
+    /* halo of a node is the rows the following nodes read beyond the band */
+    vx_uint32 halo = 0;
+    List<sg_node_info_t>::iterator node_info_iter = m_node_info_list.end();
+    while (node_info_iter != m_node_info_list.begin()) {
+        node_info_iter--;
+        (*node_info_iter).tile_halo = halo;
+        halo += (*node_info_iter).node->getKernelHandle()->getTileHalo();
+    }
+
+    m_tile_rows = GRAPH_TILE_CACHE_BYTES / row_bytes;
+    if (m_tile_rows < GRAPH_TILE_MIN_ROWS)
+        m_tile_rows = GRAPH_TILE_MIN_ROWS;
+    if (m_tile_rows >= height)
+        return VX_SUCCESS;
+
+    m_tile_height = height;
+    m_tiling = vx_true_e;
+
+    VXLOGD2("%s, %d rows of %d per band, %zu bytes per row", getSgName(), m_tile_rows, m_tile_height, row_bytes);
+
+    return VX_SUCCESS;
+}
+
+vx_status
+ExynosVisionSubgraph::tileProcess(sg_node_info_t *node_info, vx_uint32 start_y, vx_uint32 end_y)
+{
+    List<ref_connect_info_t>::iterator ref_iter;
+    for (ref_iter=node_info->cur_input_list.begin(); ref_iter!=node_info->cur_input_list.end(); ref_iter++) {
+        m_params[(*ref_iter).node_index] = (*ref_iter).ref;
+    }
+
+    for (ref_iter=node_info->cur_output_list.begin(); ref_iter!=node_info->cur_output_list.end(); ref_iter++) {
+        m_params[(*ref_iter).node_index] = (*ref_iter).ref;
+    }
+
+    vx_uint32 param_num = node_info->cur_input_list.size() + node_info->cur_output_list.size();
+
+    const ExynosVisionKernel *kernel = node_info->node->getKernelHandle();
+
+    return kernel->tileFunction(node_info->node, (const ExynosVisionDataReference **)m_params, param_num, start_y, end_y);
+}
+
+/*
+ * Every node processes the band of rows in turn, so an intermediate image is read back while its rows are still in cache.
+ * A node produces its band plus the halo rows that the following nodes read below it,
+ * the rows above were produced by the previous band already.
+ */
+vx_status
+ExynosVisionSubgraph::processFrameTiled(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode)
+{
+    vx_status status = VX_SUCCESS;
+    vx_bool data_valid = vx_true_e;
+    vx_uint32 node_num = m_node_info_list.size();
+    vx_uint32 done_y[GRAPH_FUSION_MAX_NODE_NUM];
+    vx_uint32 i;
+
+    List<sg_node_info_t>::iterator node_info_iter;
+
+    /* references of normal mode are solid, all of them are taken before the first band */
+    m_thread_state.setState(THREAD_STATE_GET_INPUT);
+    for (node_info_iter=m_node_info_list.begin(); node_info_iter!=m_node_info_list.end(); node_info_iter++) {
+        sg_node_info_t *node_info = &(*node_info_iter);
+        vx_bool input_data_valid;
+
+        node_info->node->informKernelStart(frame_cnt);
 
-        /* just handover frame count and error to next subgraph if the execution of previous subgraph fails */
-        m_thread_state.setState(THREAD_STATE_GET_INPUT);
-        VXLOGTD("getSrcRef");
-        vx_bool input_data_valid, output_data_valid;
-        status = getSrcRef(frame_cnt, exec_mode, &input_data_valid);
+        status = getSrcRef(&node_info->input_list, frame_cnt, exec_mode, &input_data_valid);
+        node_info->cur_input_list = m_cur_input_data_ref_list;
         if (status != VX_SUCCESS) {
-            VXLOGE("%s failed to getting src ref", m_sg_name);
+            VXLOGE("%s failed to getting src ref of %s", m_sg_name, node_info->node->getName());
             goto EXIT;
         }
+        if (input_data_valid != vx_true_e) {
+            VXLOGE("receiving data is not valid");
+            data_valid = vx_false_e;
+        }
 
-        m_thread_state.setState(THREAD_STATE_GET_OUTPUT);
-        VXLOGTD("getDstRef");
-        status = getDstRef(frame_cnt, exec_mode);
+        status = getDstRef(&node_info->output_list, frame_cnt, exec_mode);
+        node_info->cur_output_list = m_cur_output_data_ref_list;
         if (status != VX_SUCCESS) {
-            VXLOGE("%s failed to getting dst ref", m_sg_name);
+            VXLOGE("%s failed to getting dst ref of %s", m_sg_name, node_info->node->getName());
             goto EXIT;
         }
+    }
 
-        if (input_data_valid == vx_true_e) {
-            m_thread_state.setState(THREAD_STATE_EXE_KERNEL);
-            VXLOGTD("kernelProcess start");
-            VXLOGD2("%s process, frame_%d", m_sg_name, frame_cnt);
-            status = kernelProcess(frame_cnt);
-            if (status == VX_SUCCESS) {
-                output_data_valid = vx_true_e;
-            } else {
-                output_data_valid = vx_false_e;
-                VXLOGE("%s failed to process kernel function", m_sg_name);
-
-                /* Marking only single-frame as bad instead of stopping graph in stream mode */
-                if (exec_mode == GRAPH_EXEC_NORMAL) {
+    if (data_valid == vx_true_e) {
+        m_thread_state.setState(THREAD_STATE_EXE_KERNEL);
+        for (i = 0; i < node_num; i++)
+            done_y[i] = 0;
+
+        for (vx_uint32 y = 0; (y < m_tile_height) && (status == VX_SUCCESS); y += m_tile_rows) {
+            for (node_info_iter=m_node_info_list.begin(), i = 0; node_info_iter!=m_node_info_list.end(); node_info_iter++, i++) {
+                vx_uint32 end_y = y + m_tile_rows + (*node_info_iter).tile_halo;
+                if (end_y > m_tile_height)
+                    end_y = m_tile_height;
+                if (end_y <= done_y[i])
+                    continue;
+
+                status = tileProcess(&(*node_info_iter), done_y[i], end_y);
+                if (status != VX_SUCCESS) {
+                    VXLOGE("%s failed to process rows %d~%d of %s", m_sg_name, done_y[i], end_y, (*node_info_iter).node->getName());
                     goto EXIT;
                 }
+                done_y[i] = end_y;
             }
-            VXLOGTD("kernelProcess end");
+        }
 
-            /* node call back check */
-            if (m_represent_node->m_callback) {
+        /* node call back check, after the whole output is written */
+        for (node_info_iter=m_node_info_list.begin(); node_info_iter!=m_node_info_list.end(); node_info_iter++) {
+            ExynosVisionNode *node = (*node_info_iter).node;
+            if (node->m_callback) {
                 vx_action action;
-                action = m_represent_node->m_callback((vx_node)m_represent_node);
+                action = node->m_callback((vx_node)node);
                 if (action == VX_ACTION_ABANDON) {
-                    VXLOGE("abandon graph due to callback from %s", m_represent_node->getName());
+                    VXLOGE("abandon graph due to callback from %s", node->getName());
                     status = VX_ERROR_GRAPH_ABANDONED;
                     goto EXIT;
                 }
             }
-        } else {
-            VXLOGE("receiving data is not valid");
-            output_data_valid = vx_false_e;
         }
+    }
+
+    for (node_info_iter=m_node_info_list.begin(); node_info_iter!=m_node_info_list.end(); node_info_iter++) {
+        sg_node_info_t *node_info = &(*node_info_iter);
 
         m_thread_state.setState(THREAD_STATE_PUT_INPUT);
-        VXLOGTD("putSrcRef");
-        status = putSrcRef(frame_cnt, exec_mode);
+        m_cur_input_data_ref_list = node_info->cur_input_list;
+        status = putSrcRef(&node_info->input_list, frame_cnt, exec_mode);
         if (status != VX_SUCCESS) {
-            VXLOGE("%s failed to putting src ref", m_sg_name);
+            VXLOGE("%s failed to putting src ref of %s", m_sg_name, node_info->node->getName());
             goto EXIT;
         }
 
         m_thread_state.setState(THREAD_STATE_PUT_OUTPUT);
-        VXLOGTD("putDstRef");
-        status = putDstRef(frame_cnt, exec_mode, output_data_valid);
+        m_cur_output_data_ref_list = node_info->cur_output_list;
+        status = putDstRef(&node_info->output_list, frame_cnt, exec_mode, data_valid);
         if (status != VX_SUCCESS) {
-            VXLOGE("%s failed to putting dst ref", m_sg_name);
+            VXLOGE("%s failed to putting dst ref of %s", m_sg_name, node_info->node->getName());
             goto EXIT;
         }
 
-        m_thread_state.setState(THREAD_STATE_SEND_DONE);
-        VXLOGTD("sendDoneToPost");
-        status = sendDoneToPost(frame_cnt);
-        if (status != VX_SUCCESS) {
-            VXLOGE("%s failed to send done event", m_sg_name);
+        node_info->node->informKernelEnd(frame_cnt, status);
+    }
+
+EXIT:
+    for (node_info_iter=m_node_info_list.begin(); node_info_iter!=m_node_info_list.end(); node_info_iter++) {
+        (*node_info_iter).cur_input_list.clear();
+        (*node_info_iter).cur_output_list.clear();
+    }
+
+    return status;
+}
+#endif
+
+#if (DISPLAY_PROCESS_GRAPH_TIME==1)
+#include "ExynosVisionAutoTimer.h"
+#endif
+
+vx_status
+ExynosVisionSubgraph::processFrame(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode)
+{
+    vx_status status = VX_SUCCESS;
+
+    Mutex::Autolock lock(m_exec_mutex);
+
+    VXLOGTD("%s, start frame_%d", getSgName(), frame_cnt);
+
+#if (DISPLAY_PROCESS_GRAPH_TIME==1)
+    uint64_t start_time, end_time;
+    start_time = ExynosVisionDurationTimer::getTimeUs();
+#endif
+
+    /* fused nodes are executed in order, data references between them don't send done event */
+#if (GRAPH_NODE_TILING==1)
+    if (m_tiling == vx_true_e) {
+        status = processFrameTiled(frame_cnt, exec_mode);
+        if (status != VX_SUCCESS)
             goto EXIT;
+    } else
+#endif
+    {
+        List<sg_node_info_t>::iterator node_info_iter;
+        for (node_info_iter=m_node_info_list.begin(); node_info_iter!=m_node_info_list.end(); node_info_iter++) {
+            status = processNode(&(*node_info_iter), frame_cnt, exec_mode);
+            if (status != VX_SUCCESS)
+                goto EXIT;
         }
+    }
 
-        m_thread_state.setState(THREAD_STATE_WAIT_DONE);
+    m_thread_state.setState(THREAD_STATE_SEND_DONE);
+    VXLOGTD("sendDoneToPost");
+    status = sendDoneToPost(frame_cnt);
+    if (status != VX_SUCCESS) {
+        VXLOGE("%s failed to send done event", m_sg_name);
+        goto EXIT;
+    }
+
+    m_thread_state.setState(THREAD_STATE_WAIT_DONE);
+    m_last_process_frame = frame_cnt;
 
 #if (DISPLAY_PROCESS_GRAPH_TIME==1)
-        end_time = ExynosVisionDurationTimer::getTimeUs();
-        VXLOGI("[SG] %llu us", end_time - start_time);
+    end_time = ExynosVisionDurationTimer::getTimeUs();
+    VXLOGI("[SG] %llu us", end_time - start_time);
 #endif
 
-        m_represent_node->informKernelEnd(frame_cnt, status);
+EXIT:
+    return status;
+}
+
+bool
+ExynosVisionSubgraph::mainThreadFunc(void)
+{
+    queue_exception_t exception;
+    vx_status status = VX_FAILURE;
+    vx_uint32 frame_cnt;
+    graph_exec_mode_t exec_mode = m_graph->getExecMode();
+
+    m_thread_state.setState(THREAD_STATE_WAIT_DONE);
+    VXLOGTD("waiting message");
+    exception = popDoneEvent(&frame_cnt);
+    VXLOGTD("receive message, exception:%d, frame_%d, exec:%d", exception, frame_cnt, exec_mode);
+
+    if (exception == QUEUE_EXCEPTION_TIME_OUT) {
+        VXLOGE("queuing fails, excepton:%d", exception);
+        status = VX_FAILURE;
+    } else {
+        status = VX_SUCCESS;
     }
 
-EXIT:
-    m_exec_mutex.unlock();
+    if (frame_cnt && status == VX_SUCCESS)
+        status = processFrame(frame_cnt, exec_mode);
 
     if (status == VX_SUCCESS) {
-        m_last_process_frame = frame_cnt;
         if (m_main_thread->visionThreadExitPending()) {
             VXLOGTD("exit of main thread is requested");
         }
@@ -847,7 +1372,8 @@ ExynosVisionSubgraph::displayInfo(vx_uint32 tab_num, vx_bool detail_info)
 {
     vx_char tap[MAX_TAB_NUM];
 
-    VXLOGI("%s[Subgrap] %s, state:%d, last frame:%d", MAKE_TAB(tap, tab_num), getSgName(), m_thread_state.getState(), m_last_process_frame);
+    VXLOGI("%s[Subgrap] %s, state:%d, last frame:%d, fused node:%d", MAKE_TAB(tap, tab_num), getSgName(), m_thread_state.getState(), m_last_process_frame,
+                                                                                                                            m_node_list.size());
 
     if (m_cur_input_data_ref_list.size()) {
         List<ref_connect_info_t>::iterator ref_iter;
@@ -866,6 +1392,10 @@ ExynosVisionSubgraph::displayInfo(vx_uint32 tab_num, vx_bool detail_info)
         }
     }
 
+    List<ExynosVisionDataReference*>::iterator internal_iter;
+    for (internal_iter=m_internal_data_ref_list.begin(); internal_iter!=m_internal_data_ref_list.end(); internal_iter++)
+        VXLOGI("%s          Fused reference:%s", MAKE_TAB(tap, tab_num), (*internal_iter)->getName());
+
     if (detail_info == vx_true_e) {
         for (List<ExynosVisionNode*>::iterator node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++)
             (*node_iter)->displayInfo(tab_num+1, vx_true_e);
@@ -880,12 +1410,17 @@ ExynosVisionSubgraph::displayPerf(vx_uint32 tab_num, vx_bool detail_info)
     VXLOGI("%s[Subgrap][%d] represent node(%s, %s)", MAKE_TAB(tap, tab_num), detail_info,
         getSgName(), m_represent_node->getName(), m_represent_node->getKernelName());
 
-    vx_perf_t *vx_perf = m_graph->getPerfMonitor()->getVxPerfInfo(m_represent_node);
-    for (uint32_t i=0; i<NODE_TIMEPAIR_NUMBER; i++) {
-        VXLOGI("%s ==Set_%d, number of exec: %llu==", MAKE_TAB(tap, tab_num+1), i, vx_perf[i].num);
-        VXLOGI("%s average: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].avg/1000.0f);
-        VXLOGI("%s minimum: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].min/1000.0f);
-        VXLOGI("%s maximum: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].max/1000.0f);
+    for (List<ExynosVisionNode*>::iterator node_iter=m_node_list.begin(); node_iter!=m_node_list.end(); node_iter++) {
+        if (m_node_list.size() > 1)
+            VXLOGI("%s fused node(%s, %s)", MAKE_TAB(tap, tab_num), (*node_iter)->getName(), (*node_iter)->getKernelName());
+
+        vx_perf_t *vx_perf = m_graph->getPerfMonitor()->getVxPerfInfo(*node_iter);
+        for (uint32_t i=0; i<NODE_TIMEPAIR_NUMBER; i++) {
+            VXLOGI("%s ==Set_%d, number of exec: %llu==", MAKE_TAB(tap, tab_num+1), i, vx_perf[i].num);
+            VXLOGI("%s average: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].avg/1000.0f);
+            VXLOGI("%s minimum: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].min/1000.0f);
+            VXLOGI("%s maximum: %0.3lf ms", MAKE_TAB(tap, tab_num+1), (vx_float32)vx_perf[i].max/1000.0f);
+        }
     }
 }
 
@@ -27,12 +27,21 @@
 #include "ExynosVisionThread.h"
 #include "ExynosVisionEvent.h"
 #include "ExynosVisionState.h"
+#include "ExynosVisionWorkerPool.h"
 
 #include "ExynosVisionGraph.h"
 #include "ExynosVisionNode.h"
 
 namespace android {
 
+/* a band of fused subgraph is sized to keep the rows of all its images in this budget */
+#ifndef GRAPH_TILE_CACHE_BYTES
+#define GRAPH_TILE_CACHE_BYTES  (256 * 1024)
+#endif
+#ifndef GRAPH_TILE_MIN_ROWS
+#define GRAPH_TILE_MIN_ROWS     16
+#endif
+
 enum thread_state {
     THREAD_STATE_NOT_START = 0,
 
@@ -58,6 +67,7 @@ typedef struct _subgraph_message_t {
     vx_int32		frame_cnt;
 
     ExynosVisionDataReference   *done_reference;
+    ExynosVisionNode *done_node;
     vx_uint32 node_index;
 } subgraph_message_t;
 
@@ -67,9 +77,24 @@ class ExynosVisionSubgraph {
 
 typedef struct _ref_connect_info_t {
     ExynosVisionDataReference *ref;
+    ExynosVisionNode *node;
     vx_uint32 node_index;
 } ref_connect_info_t;
 
+/* all data references of a node, including the ones between fused nodes */
+typedef struct _sg_node_info_t {
+    ExynosVisionNode *node;
+    List<ref_connect_info_t> input_list;
+    List<ref_connect_info_t> output_list;
+#if (GRAPH_NODE_TILING==1)
+    /* extra rows below the band needed by the following fused nodes */
+    vx_uint32 tile_halo;
+    /* instance data references of the frame, kept while the bands run */
+    List<ref_connect_info_t> cur_input_list;
+    List<ref_connect_info_t> cur_output_list;
+#endif
+} sg_node_info_t;
+
 private:
     vx_uint32 m_id;
     vx_char m_sg_name[VX_MAX_SUBGRAPH_NAME];
@@ -78,8 +103,11 @@ private:
 
     /* represented node, it will be generated from dynamic kernel */
     ExynosVisionNode* m_represent_node;
-    /* list of all nodes including subgraph */
+    /* last node of fused nodes, it is same with represented node if nothing is fused */
+    ExynosVisionNode* m_tail_node;
+    /* list of all nodes including subgraph, in execution order */
     List<ExynosVisionNode*> m_node_list;
+    List<sg_node_info_t> m_node_info_list;
 
     sg_msg_queue_t *m_message_queue;
     Mutex m_exec_mutex;
@@ -91,8 +119,11 @@ private:
 
     vx_uint32 m_target_done_bitmask;
 
+    /* data references connected to other subgraphs or application, a bit of done bitmask is assigned to each input */
     List<ref_connect_info_t> m_input_data_ref_list;
     List<ref_connect_info_t> m_output_data_ref_list;
+    /* data references that are written and read only by the fused nodes */
+    List<ExynosVisionDataReference*> m_internal_data_ref_list;
 
     /* instance data reference list for single frame */
     List<ref_connect_info_t> m_cur_input_data_ref_list;
@@ -105,19 +136,46 @@ private:
 
     vx_uint32 m_last_process_frame;
 
+    /* frames of normal mode are run by the worker pool of context instead of own thread */
+    ExynosVisionWorkerPool *m_worker_pool;
+    Mutex m_sched_mutex;
+    mutable Condition m_sched_cond;
+    /* ready frames in arrival order, one task of the pool drains them so frames keep their order */
+    List<vx_uint32> m_ready_frame_list;
+    vx_bool m_task_scheduled;
+
+    /* fused nodes of normal mode run band by band if all of them can process a range of rows */
+    vx_bool m_tiling;
+    vx_uint32 m_tile_height;
+    vx_uint32 m_tile_rows;
+
 public:
 
 private:
     bool mainThreadFunc(void);
+    vx_status processFrame(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode);
+
+    static void workerTaskFunc(void *arg);
+    void processReadyFrame(void);
+    vx_status scheduleReadyFrame(vx_uint32 frame_cnt);
     queue_exception_t popDoneEvent(vx_uint32 *ret_frame_cnt);
 
-    vx_status getSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode, vx_bool *ret_data_valid);
-    vx_status getDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode);
-    vx_status kernelProcess(vx_uint32 frame_cnt);
-    vx_status putSrcRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode);
-    vx_status putDstRef(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode, vx_bool data_valid);
+    vx_status getSrcRef(List<ref_connect_info_t> *input_list, vx_uint32 frame_cnt, graph_exec_mode_t exec_mode, vx_bool *ret_data_valid);
+    vx_status getDstRef(List<ref_connect_info_t> *output_list, vx_uint32 frame_cnt, graph_exec_mode_t exec_mode);
+    vx_status kernelProcess(ExynosVisionNode *node, vx_uint32 frame_cnt);
+    vx_status putSrcRef(List<ref_connect_info_t> *input_list, vx_uint32 frame_cnt, graph_exec_mode_t exec_mode);
+    vx_status putDstRef(List<ref_connect_info_t> *output_list, vx_uint32 frame_cnt, graph_exec_mode_t exec_mode, vx_bool data_valid);
+    vx_status processNode(sg_node_info_t *node_info, vx_uint32 frame_cnt, graph_exec_mode_t exec_mode);
+#if (GRAPH_NODE_TILING==1)
+    vx_status configureTiling(void);
+    vx_status tileProcess(sg_node_info_t *node_info, vx_uint32 start_y, vx_uint32 end_y);
+    vx_status processFrameTiled(vx_uint32 frame_cnt, graph_exec_mode_t exec_mode);
+#endif
     vx_status sendDoneToPost(vx_uint32 frame_cnt);
 
+    vx_bool containNode(ExynosVisionNode *node);
+    vx_bool isInternalDataRef(ExynosVisionDataReference *data_ref);
+
     vx_status makeInputOutputPort(void);
     vx_status allocateDataRefMemory(void);
 
@@ -130,11 +188,14 @@ public:
     virtual ~ExynosVisionSubgraph();
 
     vx_status init(ExynosVisionNode *node);
+    /* fuse node to the tail of subgraph, the node is executed in the thread of subgraph */
+    vx_status addNode(ExynosVisionNode *node);
     vx_status destroy(void);
 
     vx_status fixSubgraph(void);
 
-    vx_bool verifyPopedEvent(ExynosVisionDataReference *data_ref, vx_uint32 node_index);
+    /* port_index is the position of data reference in the input port list */
+    vx_bool verifyPopedEvent(ExynosVisionDataReference *data_ref, ExynosVisionNode *node, vx_uint32 node_index, vx_uint32 *ret_port_index);
 
     vx_bool isHeader(void)
     {
@@ -142,7 +203,15 @@ public:
     }
     vx_bool isFooter(void)
     {
-        return m_represent_node->isFooter();
+        return m_tail_node->isFooter();
+    }
+    ExynosVisionNode* getTailNode(void)
+    {
+        return m_tail_node;
+    }
+    vx_uint32 getNodeNum(void)
+    {
+        return m_node_list.size();
     }
     vx_uint32 getId()
     {
@@ -156,7 +225,7 @@ public:
     /* push start signal to subgraph, all input data reference should be exclusive */
     vx_status pushTrigger(vx_uint32 frame_cnt);
     /* push doen event to subgraph, each input data reference send done event individually */
-    vx_status pushDoneEvent(vx_uint32 frame_cnt, ExynosVisionDataReference *ref, vx_uint32 node_index);
+    vx_status pushDoneEvent(vx_uint32 frame_cnt, ExynosVisionDataReference *ref, ExynosVisionNode *node, vx_uint32 node_index);
 
     vx_status clearSubgraphComplete(void);
     vx_status waitSubgraphComplete(vx_uint64 wait_time);
@@ -164,7 +233,7 @@ public:
     vx_status flushWaitEvent();
     vx_status exitThread();
 
-    vx_status replaceDataRef(ExynosVisionDataReference *old_ref, ExynosVisionDataReference *new_ref, vx_uint32 node_index, enum vx_direction_e dir);
+    vx_status replaceDataRef(ExynosVisionDataReference *old_ref, ExynosVisionDataReference *new_ref, ExynosVisionNode *node, vx_uint32 node_index, enum vx_direction_e dir);
 
     virtual void displayInfo(vx_uint32 tab_num, vx_bool detail_info);
     virtual void displayPerf(vx_uint32 tab_num, vx_bool detail_info);
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ExynosVisionWorkerPool"
+#include <cutils/log.h>
+
+#include <unistd.h>
+
+#include "ExynosVisionWorkerPool.h"
+
+namespace android {
+
+ExynosVisionWorker::ExynosVisionWorker(ExynosVisionWorkerPool *pool, vx_uint32 index)
+{
+    m_pool = pool;
+    m_index = index;
+}
+
+ExynosVisionWorker::~ExynosVisionWorker()
+{
+
+}
+
+vx_status
+ExynosVisionWorker::start(void)
+{
+    status_t ret;
+
+    m_thread = new ExynosVisionThread<ExynosVisionWorker>(this, &ExynosVisionWorker::workerThreadFunc, "visionworker", PRIORITY_DEFAULT);
+    ret = m_thread->run();
+    if (ret != NO_ERROR) {
+        VXLOGE("worker(%d) cannot run, ret:%d", m_index, ret);
+        return VX_FAILURE;
+    }
+
+    return VX_SUCCESS;
+}
+
+vx_status
+ExynosVisionWorker::stop(void)
+{
+    status_t ret;
+
+    if (m_thread == NULL)
+        return VX_SUCCESS;
+
+    ret = m_thread->requestExitAndWait();
+    if (ret != NO_ERROR) {
+        VXLOGE("worker(%d) cannot exit, ret:%d", m_index, ret);
+        return VX_FAILURE;
+    }
+
+    return VX_SUCCESS;
+}
+
+void
+ExynosVisionWorker::pushTask(const worker_task_t &task)
+{
+    Mutex::Autolock lock(m_deque_mutex);
+    m_task_deque.push_back(task);
+}
+
+vx_bool
+ExynosVisionWorker::popTask(worker_task_t *ret_task)
+{
+    Mutex::Autolock lock(m_deque_mutex);
+
+    if (m_task_deque.empty())
+        return vx_false_e;
+
+    List<worker_task_t>::iterator task_iter = --m_task_deque.end();
+    *ret_task = *task_iter;
+    m_task_deque.erase(task_iter);
+
+    return vx_true_e;
+}
+
+vx_bool
+ExynosVisionWorker::stealTask(worker_task_t *ret_task)
+{
+    Mutex::Autolock lock(m_deque_mutex);
+
+    if (m_task_deque.empty())
+        return vx_false_e;
+
+    List<worker_task_t>::iterator task_iter = m_task_deque.begin();
+    *ret_task = *task_iter;
+    m_task_deque.erase(task_iter);
+
+    return vx_true_e;
+}
+
+bool
+ExynosVisionWorker::workerThreadFunc(void)
+{
+    worker_task_t task;
+
+    if (m_pool->waitTask(this, &task) == vx_false_e)
+        return false;
+
+    task.func(task.arg);
+
+    return true;
+}
+
+ExynosVisionWorkerPool::ExynosVisionWorkerPool()
+{
+    m_next_worker = 0;
+    m_pending_task_num = 0;
+    m_exit_flag = vx_false_e;
+
+    pthread_key_create(&m_worker_key, NULL);
+}
+
+ExynosVisionWorkerPool::~ExynosVisionWorkerPool()
+{
+    pthread_key_delete(m_worker_key);
+}
+
+vx_status
+ExynosVisionWorkerPool::init(vx_uint32 worker_num)
+{
+    vx_status status = VX_SUCCESS;
+
+    if (worker_num == 0) {
+        long core_num = sysconf(_SC_NPROCESSORS_ONLN);
+        worker_num = (core_num > 0) ? (vx_uint32)core_num : 1;
+    }
+
+    for (vx_uint32 i = 0; i < worker_num; i++) {
+        ExynosVisionWorker *worker = new ExynosVisionWorker(this, i);
+        m_worker_vector.push_back(worker);
+    }
+
+    for (vx_uint32 i = 0; i < m_worker_vector.size(); i++) {
+        status = m_worker_vector[i]->start();
+        if (status != VX_SUCCESS) {
+            VXLOGE("starting worker(%d) fails, err:%d", i, status);
+            break;
+        }
+    }
+
+    VXLOGD2("worker pool is initialized with %d workers", m_worker_vector.size());
+
+    return status;
+}
+
+vx_status
+ExynosVisionWorkerPool::destroy(void)
+{
+    vx_status status = VX_SUCCESS;
+
+    /* the workers drain the pending tasks before exiting */
+    m_pool_mutex.lock();
+    m_exit_flag = vx_true_e;
+    m_pool_cond.broadcast();
+    m_pool_mutex.unlock();
+
+    for (vx_uint32 i = 0; i < m_worker_vector.size(); i++) {
+        if (m_worker_vector[i]->stop() != VX_SUCCESS)
+            status = VX_FAILURE;
+        delete m_worker_vector[i];
+    }
+    m_worker_vector.clear();
+
+    return status;
+}
+
+vx_status
+ExynosVisionWorkerPool::pushTask(worker_task_func_t func, void *arg)
+{
+    worker_task_t task;
+    task.func = func;
+    task.arg = arg;
+
+    if (m_worker_vector.size() == 0) {
+        VXLOGE("worker pool is not initialized");
+        return VX_ERROR_NOT_ALLOCATED;
+    }
+
+    ExynosVisionWorker *worker = (ExynosVisionWorker*)pthread_getspecific(m_worker_key);
+    if ((worker == NULL) || (worker->getPool() != this)) {
+        m_pool_mutex.lock();
+        worker = m_worker_vector[m_next_worker];
+        m_next_worker = (m_next_worker + 1) % m_worker_vector.size();
+        m_pool_mutex.unlock();
+    }
+
+    worker->pushTask(task);
+
+    m_pool_mutex.lock();
+    m_pending_task_num++;
+    m_pool_cond.signal();
+    m_pool_mutex.unlock();
+
+    return VX_SUCCESS;
+}
+
+vx_bool
+ExynosVisionWorkerPool::waitTask(ExynosVisionWorker *worker, worker_task_t *ret_task)
+{
+    if (pthread_getspecific(m_worker_key) != worker)
+        pthread_setspecific(m_worker_key, worker);
+
+    m_pool_mutex.lock();
+    while ((m_pending_task_num == 0) && (m_exit_flag == vx_false_e))
+        m_pool_cond.wait(m_pool_mutex);
+
+    if (m_pending_task_num == 0) {
+        m_pool_mutex.unlock();
+        return vx_false_e;
+    }
+    /* claiming a task guarantees that one is left on some deque for this worker */
+    m_pending_task_num--;
+    m_pool_mutex.unlock();
+
+    vx_uint32 worker_num = m_worker_vector.size();
+    vx_uint32 index = worker->getIndex();
+
+    while (1) {
+        if (worker->popTask(ret_task))
+            break;
+
+        vx_bool stolen = vx_false_e;
+        for (vx_uint32 i = 1; i < worker_num; i++) {
+            if (m_worker_vector[(index + i) % worker_num]->stealTask(ret_task)) {
+                stolen = vx_true_e;
+                break;
+            }
+        }
+        if (stolen)
+            break;
+    }
+
+    return vx_true_e;
+}
+
+}; /* namespace android */
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXYNOS_VISION_WORKER_POOL_H
+#define EXYNOS_VISION_WORKER_POOL_H
+
+#include <pthread.h>
+
+#include <utils/threads.h>
+#include <utils/Mutex.h>
+#include <utils/List.h>
+#include <utils/Vector.h>
+
+#include <VX/vx.h>
+
+#include "ExynosVisionCommonConfig.h"
+#include "ExynosVisionThread.h"
+
+namespace android {
+
+typedef void (*worker_task_func_t)(void *arg);
+
+typedef struct _worker_task_t {
+    worker_task_func_t func;
+    void *arg;
+} worker_task_t;
+
+class ExynosVisionWorkerPool;
+
+class ExynosVisionWorker {
+private:
+    ExynosVisionWorkerPool *m_pool;
+    vx_uint32 m_index;
+
+    /* the owner pushes and pops at the back, the others steal from the front */
+    Mutex m_deque_mutex;
+    List<worker_task_t> m_task_deque;
+
+    sp<ExynosVisionThread<ExynosVisionWorker>> m_thread;
+
+private:
+    bool workerThreadFunc(void);
+
+public:
+    ExynosVisionWorker(ExynosVisionWorkerPool *pool, vx_uint32 index);
+    virtual ~ExynosVisionWorker();
+
+    vx_status start(void);
+    vx_status stop(void);
+
+    ExynosVisionWorkerPool* getPool(void)
+    {
+        return m_pool;
+    }
+    vx_uint32 getIndex(void)
+    {
+        return m_index;
+    }
+
+    void pushTask(const worker_task_t &task);
+    vx_bool popTask(worker_task_t *ret_task);
+    vx_bool stealTask(worker_task_t *ret_task);
+};
+
+/*
+ * Threads shared by the subgraphs of every graph of a context.
+ * A task pushed from a worker stays on the deque of that worker, so a successor
+ * triggered at completion runs next on the same core while idle workers steal the rest.
+ */
+class ExynosVisionWorkerPool {
+private:
+    Vector<ExynosVisionWorker*> m_worker_vector;
+    vx_uint32 m_next_worker;
+
+    Mutex m_pool_mutex;
+    mutable Condition m_pool_cond;
+    /* number of tasks that are pushed but not claimed by any worker yet */
+    vx_uint32 m_pending_task_num;
+    vx_bool m_exit_flag;
+
+    pthread_key_t m_worker_key;
+
+public:
+    ExynosVisionWorkerPool();
+    virtual ~ExynosVisionWorkerPool();
+
+    /* the pool is sized to the online cores if worker_num is zero */
+    vx_status init(vx_uint32 worker_num);
+    vx_status destroy(void);
+
+    vx_status pushTask(worker_task_func_t func, void *arg);
+
+    /* called by a worker, returns false if the pool is exiting */
+    vx_bool waitTask(ExynosVisionWorker *worker, worker_task_t *ret_task);
+
+    vx_uint32 getWorkerNum(void)
+    {
+        return m_worker_vector.size();
+    }
+};
+
+}; // namespace android
+#endif
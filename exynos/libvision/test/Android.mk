@@ -0,0 +1,66 @@
+# Copyright (C) 2015 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+LOCAL_PATH:= $(call my-dir)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_SHARED_LIBRARIES += libexynosvision
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/../include
+
+LOCAL_SRC_FILES:= \
+	./vx_graph_benchmark.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := vx_graph_benchmark
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_SHARED_LIBRARIES += libexynosvision
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/../include
+
+LOCAL_SRC_FILES:= \
+	./vx_conformance_test.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := vx_conformance_test
+
+include $(BUILD_NATIVE_TEST)
+
+include $(CLEAR_VARS)
+
+LOCAL_SHARED_LIBRARIES:= libutils libcutils liblog
+LOCAL_SHARED_LIBRARIES += libexynosvision
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_C_INCLUDES += \
+	$(LOCAL_PATH)/../include
+
+LOCAL_SRC_FILES:= \
+	./vx_scheduler_benchmark.cpp
+
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := vx_scheduler_benchmark
+
+include $(BUILD_EXECUTABLE)
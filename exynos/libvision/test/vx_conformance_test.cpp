@@ -0,0 +1,529 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Conformance of the kernel targets.
+ * The CPU target is checked against the plain C references below with the replicate border,
+ * and every other target that accepts the node is checked against the CPU target.
+ * Accelerators are free to handle the border differently, so their comparison skips the halo of the kernel.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <VX/vx.h>
+#include <VX/vx_api_ext.h>
+
+#define TEST_WIDTH      133
+#define TEST_HEIGHT     71
+
+typedef std::vector<vx_int32> plane_t;
+
+struct conformance_case_t {
+    const char *name;
+    vx_uint32 in_num;
+    vx_df_image in_format[2];
+    vx_uint32 out_num;
+    vx_df_image out_format[2];
+    vx_node (*make_node)(vx_graph graph, vx_image *in, vx_image *out);
+    void (*reference)(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height);
+    /* rows and columns at the border that accelerators could fill differently */
+    vx_uint32 halo;
+    /* phase is an angle, 255 and 0 are neighbours */
+    bool wrap_u8;
+};
+
+static vx_int32 saturate(vx_int32 value, vx_int32 min, vx_int32 max)
+{
+    return (value < min) ? min : ((value > max) ? max : value);
+}
+
+static vx_int32 pixelAt(const plane_t &plane, vx_int32 x, vx_int32 y, vx_int32 width, vx_int32 height)
+{
+    x = saturate(x, 0, width - 1);
+    y = saturate(y, 0, height - 1);
+
+    return plane[y * width + x];
+}
+
+static void gather3x3(const plane_t &plane, vx_int32 x, vx_int32 y, vx_int32 width, vx_int32 height, vx_int32 *p)
+{
+    for (vx_int32 j = 0; j < 3; j++) {
+        for (vx_int32 i = 0; i < 3; i++)
+            p[j * 3 + i] = pixelAt(plane, x + i - 1, y + j - 1, width, height);
+    }
+}
+
+/* references */
+
+static void refAbsDiff(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    for (vx_int32 i = 0; i < width * height; i++)
+        out[0][i] = abs(in[0][i] - in[1][i]);
+}
+
+static void refAdd(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    for (vx_int32 i = 0; i < width * height; i++)
+        out[0][i] = saturate(in[0][i] + in[1][i], 0, UINT8_MAX);
+}
+
+static void refSubtract(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    for (vx_int32 i = 0; i < width * height; i++)
+        out[0][i] = saturate(in[0][i] - in[1][i], 0, UINT8_MAX);
+}
+
+static void refMultiply(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    for (vx_int32 i = 0; i < width * height; i++)
+        out[0][i] = saturate(in[0][i] * in[1][i], 0, UINT8_MAX);
+}
+
+static void refAnd(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    for (vx_int32 i = 0; i < width * height; i++)
+        out[0][i] = in[0][i] & in[1][i];
+}
+
+static void refOr(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    for (vx_int32 i = 0; i < width * height; i++)
+        out[0][i] = in[0][i] | in[1][i];
+}
+
+static void refXor(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    for (vx_int32 i = 0; i < width * height; i++)
+        out[0][i] = in[0][i] ^ in[1][i];
+}
+
+static void refNot(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    for (vx_int32 i = 0; i < width * height; i++)
+        out[0][i] = (~in[0][i]) & 0xFF;
+}
+
+static void refBox3x3(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    vx_int32 p[9];
+
+    for (vx_int32 y = 0; y < height; y++) {
+        for (vx_int32 x = 0; x < width; x++) {
+            gather3x3(in[0], x, y, width, height, p);
+            vx_int32 sum = 0;
+            for (vx_int32 i = 0; i < 9; i++)
+                sum += p[i];
+            out[0][y * width + x] = sum / 9;
+        }
+    }
+}
+
+static void refGaussian3x3(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    static const vx_int32 coeff[9] = {1, 2, 1, 2, 4, 2, 1, 2, 1};
+    vx_int32 p[9];
+
+    for (vx_int32 y = 0; y < height; y++) {
+        for (vx_int32 x = 0; x < width; x++) {
+            gather3x3(in[0], x, y, width, height, p);
+            vx_int32 sum = 0;
+            for (vx_int32 i = 0; i < 9; i++)
+                sum += coeff[i] * p[i];
+            out[0][y * width + x] = sum >> 4;
+        }
+    }
+}
+
+static int compareInt(const void *a, const void *b)
+{
+    return *(const vx_int32*)a - *(const vx_int32*)b;
+}
+
+static void refMedian3x3(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    vx_int32 p[9];
+
+    for (vx_int32 y = 0; y < height; y++) {
+        for (vx_int32 x = 0; x < width; x++) {
+            gather3x3(in[0], x, y, width, height, p);
+            qsort(p, 9, sizeof(p[0]), compareInt);
+            out[0][y * width + x] = p[4];
+        }
+    }
+}
+
+static void refDilate3x3(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    vx_int32 p[9];
+
+    for (vx_int32 y = 0; y < height; y++) {
+        for (vx_int32 x = 0; x < width; x++) {
+            gather3x3(in[0], x, y, width, height, p);
+            qsort(p, 9, sizeof(p[0]), compareInt);
+            out[0][y * width + x] = p[8];
+        }
+    }
+}
+
+static void refErode3x3(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    vx_int32 p[9];
+
+    for (vx_int32 y = 0; y < height; y++) {
+        for (vx_int32 x = 0; x < width; x++) {
+            gather3x3(in[0], x, y, width, height, p);
+            qsort(p, 9, sizeof(p[0]), compareInt);
+            out[0][y * width + x] = p[0];
+        }
+    }
+}
+
+static void refSobel3x3(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    vx_int32 p[9];
+
+    for (vx_int32 y = 0; y < height; y++) {
+        for (vx_int32 x = 0; x < width; x++) {
+            gather3x3(in[0], x, y, width, height, p);
+            out[0][y * width + x] = (p[2] - p[0]) + 2 * (p[5] - p[3]) + (p[8] - p[6]);
+            out[1][y * width + x] = (p[6] - p[0]) + 2 * (p[7] - p[1]) + (p[8] - p[2]);
+        }
+    }
+}
+
+static void refMagnitude(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    for (vx_int32 i = 0; i < width * height; i++) {
+        double mag = sqrt((double)in[0][i] * in[0][i] + (double)in[1][i] * in[1][i]);
+        out[0][i] = saturate((vx_int32)(mag + 0.5), INT16_MIN, INT16_MAX);
+    }
+}
+
+static void refPhase(const plane_t *in, plane_t *out, vx_int32 width, vx_int32 height)
+{
+    for (vx_int32 i = 0; i < width * height; i++) {
+        double angle = atan2((double)in[1][i], (double)in[0][i]);
+        if (angle < 0)
+            angle += 2.0 * M_PI;
+        out[0][i] = (vx_int32)(angle * 256.0 / (2.0 * M_PI) + 0.5) & 0xFF;
+    }
+}
+
+/* node makers */
+
+static vx_node makeAbsDiff(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxAbsDiffNode(graph, in[0], in[1], out[0]);
+}
+
+static vx_node makeAdd(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxAddNode(graph, in[0], in[1], VX_CONVERT_POLICY_SATURATE, out[0]);
+}
+
+static vx_node makeSubtract(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxSubtractNode(graph, in[0], in[1], VX_CONVERT_POLICY_SATURATE, out[0]);
+}
+
+static vx_node makeMultiply(vx_graph graph, vx_image *in, vx_image *out)
+{
+    vx_float32 scale = 1.0f;
+    vx_scalar scale_scalar = vxCreateScalar(vxGetContext((vx_reference)graph), VX_TYPE_FLOAT32, &scale);
+    vx_node node = vxMultiplyNode(graph, in[0], in[1], scale_scalar, VX_CONVERT_POLICY_SATURATE,
+                                    VX_ROUND_POLICY_TO_ZERO, out[0]);
+    vxReleaseScalar(&scale_scalar);
+
+    return node;
+}
+
+static vx_node makeAnd(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxAndNode(graph, in[0], in[1], out[0]);
+}
+
+static vx_node makeOr(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxOrNode(graph, in[0], in[1], out[0]);
+}
+
+static vx_node makeXor(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxXorNode(graph, in[0], in[1], out[0]);
+}
+
+static vx_node makeNot(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxNotNode(graph, in[0], out[0]);
+}
+
+static vx_node makeBox3x3(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxBox3x3Node(graph, in[0], out[0]);
+}
+
+static vx_node makeGaussian3x3(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxGaussian3x3Node(graph, in[0], out[0]);
+}
+
+static vx_node makeMedian3x3(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxMedian3x3Node(graph, in[0], out[0]);
+}
+
+static vx_node makeDilate3x3(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxDilate3x3Node(graph, in[0], out[0]);
+}
+
+static vx_node makeErode3x3(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxErode3x3Node(graph, in[0], out[0]);
+}
+
+static vx_node makeSobel3x3(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxSobel3x3Node(graph, in[0], out[0], out[1]);
+}
+
+static vx_node makeMagnitude(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxMagnitudeNode(graph, in[0], in[1], out[0]);
+}
+
+static vx_node makePhase(vx_graph graph, vx_image *in, vx_image *out)
+{
+    return vxPhaseNode(graph, in[0], in[1], out[0]);
+}
+
+#define U8  VX_DF_IMAGE_U8
+#define S16 VX_DF_IMAGE_S16
+
+static const conformance_case_t conformance_cases[] = {
+    {"absdiff", 2, {U8, U8}, 1, {U8}, makeAbsDiff, refAbsDiff, 0, false},
+    {"add", 2, {U8, U8}, 1, {U8}, makeAdd, refAdd, 0, false},
+    {"subtract", 2, {U8, U8}, 1, {U8}, makeSubtract, refSubtract, 0, false},
+    {"multiply", 2, {U8, U8}, 1, {U8}, makeMultiply, refMultiply, 0, false},
+    {"and", 2, {U8, U8}, 1, {U8}, makeAnd, refAnd, 0, false},
+    {"or", 2, {U8, U8}, 1, {U8}, makeOr, refOr, 0, false},
+    {"xor", 2, {U8, U8}, 1, {U8}, makeXor, refXor, 0, false},
+    {"not", 1, {U8}, 1, {U8}, makeNot, refNot, 0, false},
+    {"box3x3", 1, {U8}, 1, {U8}, makeBox3x3, refBox3x3, 1, false},
+    {"gaussian3x3", 1, {U8}, 1, {U8}, makeGaussian3x3, refGaussian3x3, 1, false},
+    {"median3x3", 1, {U8}, 1, {U8}, makeMedian3x3, refMedian3x3, 1, false},
+    {"dilate3x3", 1, {U8}, 1, {U8}, makeDilate3x3, refDilate3x3, 1, false},
+    {"erode3x3", 1, {U8}, 1, {U8}, makeErode3x3, refErode3x3, 1, false},
+    {"sobel3x3", 1, {U8}, 2, {S16, S16}, makeSobel3x3, refSobel3x3, 1, false},
+    {"magnitude", 2, {S16, S16}, 1, {S16}, makeMagnitude, refMagnitude, 0, false},
+    {"phase", 2, {S16, S16}, 1, {U8}, makePhase, refPhase, 0, true},
+};
+
+#undef U8
+#undef S16
+
+/* targets compared with the CPU target, a target that doesn't accept the node is skipped */
+static const vx_enum accelerator_targets[] = {
+    VX_TARGET_VPU,
+    VX_TARGET_DSP,
+    VX_TARGET_GPU,
+};
+
+class VxConformanceTest : public ::testing::TestWithParam<conformance_case_t> {
+protected:
+    vx_context m_context;
+    vx_image m_in[2];
+    plane_t m_in_plane[2];
+
+    virtual void SetUp()
+    {
+        const conformance_case_t &test_case = GetParam();
+
+        m_context = vxCreateContext();
+        ASSERT_EQ(VX_SUCCESS, vxGetStatus((vx_reference)m_context));
+
+        for (vx_uint32 i = 0; i < test_case.in_num; i++) {
+            m_in[i] = vxCreateImage(m_context, TEST_WIDTH, TEST_HEIGHT, test_case.in_format[i]);
+            ASSERT_EQ(VX_SUCCESS, fillImage(m_in[i], i + 1, &m_in_plane[i]));
+        }
+    }
+
+    virtual void TearDown()
+    {
+        for (vx_uint32 i = 0; i < GetParam().in_num; i++)
+            vxReleaseImage(&m_in[i]);
+        vxReleaseContext(&m_context);
+    }
+
+    /* random pixels, S16 stays in the range of 3x3 sobel */
+    static vx_status fillImage(vx_image image, vx_uint32 seed, plane_t *plane)
+    {
+        vx_rectangle_t rect = {0, 0, TEST_WIDTH, TEST_HEIGHT};
+        vx_imagepatch_addressing_t addr;
+        vx_df_image format;
+        void *base = NULL;
+        vx_status status;
+
+        status = vxQueryImage(image, VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format));
+        status |= vxAccessImagePatch(image, &rect, 0, &addr, &base, VX_WRITE_ONLY);
+        if (status != VX_SUCCESS)
+            return status;
+
+        plane->resize(TEST_WIDTH * TEST_HEIGHT);
+        for (vx_uint32 y = 0; y < TEST_HEIGHT; y++) {
+            vx_uint8 *row = (vx_uint8*)base + y * addr.stride_y;
+            for (vx_uint32 x = 0; x < TEST_WIDTH; x++) {
+                seed = seed * 1103515245 + 12345;
+                if (format == VX_DF_IMAGE_U8) {
+                    row[x] = (vx_uint8)(seed >> 16);
+                    (*plane)[y * TEST_WIDTH + x] = row[x];
+                } else {
+                    ((vx_int16*)row)[x] = (vx_int16)((vx_int32)((seed >> 16) & 0x7FF) - 1024);
+                    (*plane)[y * TEST_WIDTH + x] = ((vx_int16*)row)[x];
+                }
+            }
+        }
+
+        return vxCommitImagePatch(image, &rect, 0, &addr, base);
+    }
+
+    static vx_status readImage(vx_image image, plane_t *plane)
+    {
+        vx_rectangle_t rect = {0, 0, TEST_WIDTH, TEST_HEIGHT};
+        vx_imagepatch_addressing_t addr;
+        vx_df_image format;
+        void *base = NULL;
+        vx_status status;
+
+        status = vxQueryImage(image, VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format));
+        status |= vxAccessImagePatch(image, &rect, 0, &addr, &base, VX_READ_ONLY);
+        if (status != VX_SUCCESS)
+            return status;
+
+        plane->resize(TEST_WIDTH * TEST_HEIGHT);
+        for (vx_uint32 y = 0; y < TEST_HEIGHT; y++) {
+            const vx_uint8 *row = (const vx_uint8*)base + y * addr.stride_y;
+            for (vx_uint32 x = 0; x < TEST_WIDTH; x++) {
+                if (format == VX_DF_IMAGE_U8)
+                    (*plane)[y * TEST_WIDTH + x] = row[x];
+                else
+                    (*plane)[y * TEST_WIDTH + x] = ((const vx_int16*)row)[x];
+            }
+        }
+
+        return vxCommitImagePatch(image, NULL, 0, &addr, base);
+    }
+
+    /* runs the node on the target, VX_ERROR_NOT_SUPPORTED if the target doesn't take it */
+    vx_status runTarget(vx_enum target, plane_t *out_plane)
+    {
+        const conformance_case_t &test_case = GetParam();
+        vx_border_mode_t border = {VX_BORDER_MODE_REPLICATE, 0};
+        vx_image out[2] = {NULL, NULL};
+        vx_status status;
+
+        vx_graph graph = vxCreateGraph(m_context);
+        for (vx_uint32 i = 0; i < test_case.out_num; i++)
+            out[i] = vxCreateImage(m_context, TEST_WIDTH, TEST_HEIGHT, test_case.out_format[i]);
+
+        vx_node node = test_case.make_node(graph, m_in, out);
+        status = vxGetStatus((vx_reference)node);
+        if (status == VX_SUCCESS) {
+            if ((vxSetNodeTarget(node, target, NULL) != VX_SUCCESS) ||
+                (vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_BORDER_MODE, &border, sizeof(border)) != VX_SUCCESS) ||
+                (vxVerifyGraph(graph) != VX_SUCCESS)) {
+                status = VX_ERROR_NOT_SUPPORTED;
+            } else {
+                status = vxProcessGraph(graph);
+                for (vx_uint32 i = 0; (i < test_case.out_num) && (status == VX_SUCCESS); i++)
+                    status = readImage(out[i], &out_plane[i]);
+            }
+            vxReleaseNode(&node);
+        }
+
+        vxReleaseGraph(&graph);
+        for (vx_uint32 i = 0; i < test_case.out_num; i++)
+            vxReleaseImage(&out[i]);
+
+        return status;
+    }
+
+    /* number of pixels differing by more than tolerance, the halo at the border is excluded */
+    static vx_uint32 countMismatch(const plane_t &expected, const plane_t &actual, vx_uint32 halo, vx_int32 tolerance, bool wrap_u8)
+    {
+        vx_uint32 mismatch = 0;
+
+        for (vx_uint32 y = halo; y < TEST_HEIGHT - halo; y++) {
+            for (vx_uint32 x = halo; x < TEST_WIDTH - halo; x++) {
+                vx_int32 diff = abs(expected[y * TEST_WIDTH + x] - actual[y * TEST_WIDTH + x]);
+                if (wrap_u8 && (diff > 128))
+                    diff = 256 - diff;
+                if (diff > tolerance)
+                    mismatch++;
+            }
+        }
+
+        return mismatch;
+    }
+};
+
+TEST_P(VxConformanceTest, CpuMatchesReference)
+{
+    const conformance_case_t &test_case = GetParam();
+    plane_t expected[2], actual[2];
+
+    for (vx_uint32 i = 0; i < test_case.out_num; i++)
+        expected[i].resize(TEST_WIDTH * TEST_HEIGHT);
+    test_case.reference(m_in_plane, expected, TEST_WIDTH, TEST_HEIGHT);
+
+    ASSERT_EQ(VX_SUCCESS, runTarget(VX_TARGET_CPU, actual));
+    for (vx_uint32 i = 0; i < test_case.out_num; i++)
+        EXPECT_EQ(0u, countMismatch(expected[i], actual[i], 0, 0, test_case.wrap_u8)) << test_case.name << " output " << i;
+}
+
+TEST_P(VxConformanceTest, AcceleratorMatchesCpu)
+{
+    const conformance_case_t &test_case = GetParam();
+    plane_t expected[2];
+
+    ASSERT_EQ(VX_SUCCESS, runTarget(VX_TARGET_CPU, expected));
+
+    for (vx_uint32 t = 0; t < sizeof(accelerator_targets) / sizeof(accelerator_targets[0]); t++) {
+        plane_t actual[2];
+        vx_status status = runTarget(accelerator_targets[t], actual);
+        if (status == VX_ERROR_NOT_SUPPORTED)
+            continue;
+
+        ASSERT_EQ(VX_SUCCESS, status) << test_case.name << " target " << accelerator_targets[t];
+        /* fixed point accelerators could round the last bit differently */
+        for (vx_uint32 i = 0; i < test_case.out_num; i++)
+            EXPECT_EQ(0u, countMismatch(expected[i], actual[i], test_case.halo, 1, test_case.wrap_u8))
+                << test_case.name << " target " << accelerator_targets[t] << " output " << i;
+    }
+}
+
+static std::string caseName(const ::testing::TestParamInfo<conformance_case_t> &info)
+{
+    return info.param.name;
+}
+
+INSTANTIATE_TEST_CASE_P(Kernels, VxConformanceTest, ::testing::ValuesIn(conformance_cases), caseName);
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Frame latency of a CPU edge pipeline, absdiff -> gaussian3x3 -> sobel3x3 -> magnitude.
+ * The fused graph keeps the intermediates virtual so that the nodes are fused and run band by band,
+ * the baseline runs one single-node graph per kernel on real images, i.e. one full image pass per kernel.
+ * Both outputs are compared, so a band or halo error shows up as a mismatch.
+ *
+ * usage: vx_graph_benchmark [width] [height] [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <VX/vx.h>
+#include <VX/vx_api_ext.h>
+
+#define BENCH_DEFAULT_WIDTH     1920
+#define BENCH_DEFAULT_HEIGHT    1080
+#define BENCH_DEFAULT_ITERATION 30
+
+#define BENCH_CHECK(status, msg) \
+    do { \
+        if ((status) != VX_SUCCESS) { \
+            printf("%s fails, err:%d\n", msg, (status)); \
+            return (status); \
+        } \
+    } while (0)
+
+static vx_uint64 getTimeUs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (vx_uint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static vx_status fillImage(vx_image image, vx_uint32 seed)
+{
+    vx_rectangle_t rect;
+    vx_imagepatch_addressing_t addr;
+    void *base = NULL;
+    vx_status status;
+
+    status = vxGetValidRegionImage(image, &rect);
+    status |= vxAccessImagePatch(image, &rect, 0, &addr, &base, VX_WRITE_ONLY);
+    if (status != VX_SUCCESS)
+        return status;
+
+    for (vx_uint32 y = 0; y < addr.dim_y; y++) {
+        vx_uint8 *row = (vx_uint8*)base + y * addr.stride_y;
+        for (vx_uint32 x = 0; x < addr.dim_x; x++) {
+            seed = seed * 1103515245 + 12345;
+            row[x] = (vx_uint8)(seed >> 16);
+        }
+    }
+
+    return vxCommitImagePatch(image, &rect, 0, &addr, base);
+}
+
+static vx_status compareImage(vx_image image1, vx_image image2, vx_uint32 *ret_diff)
+{
+    vx_rectangle_t rect;
+    vx_imagepatch_addressing_t addr1, addr2;
+    void *base1 = NULL, *base2 = NULL;
+    vx_status status;
+
+    *ret_diff = 0;
+
+    status = vxGetValidRegionImage(image1, &rect);
+    status |= vxAccessImagePatch(image1, &rect, 0, &addr1, &base1, VX_READ_ONLY);
+    status |= vxAccessImagePatch(image2, &rect, 0, &addr2, &base2, VX_READ_ONLY);
+    if (status == VX_SUCCESS) {
+        for (vx_uint32 y = 0; y < addr1.dim_y; y++) {
+            const vx_uint8 *row1 = (const vx_uint8*)base1 + y * addr1.stride_y;
+            const vx_uint8 *row2 = (const vx_uint8*)base2 + y * addr2.stride_y;
+            if (memcmp(row1, row2, addr1.dim_x * addr1.stride_x) != 0)
+                (*ret_diff)++;
+        }
+    }
+
+    if (base1)
+        vxCommitImagePatch(image1, NULL, 0, &addr1, base1);
+    if (base2)
+        vxCommitImagePatch(image2, NULL, 0, &addr2, base2);
+
+    return status;
+}
+
+static vx_status setCpuTarget(vx_node node)
+{
+    if (node == NULL)
+        return VX_ERROR_INVALID_NODE;
+
+    return vxSetNodeTarget(node, VX_TARGET_CPU, NULL);
+}
+
+static vx_status measureGraph(vx_graph graph, vx_uint32 iteration, vx_uint64 *ret_avg_us)
+{
+    vx_status status;
+    vx_uint64 start;
+
+    /* the first frame allocates the memory, it is not measured */
+    status = vxProcessGraph(graph);
+    BENCH_CHECK(status, "warming up graph");
+
+    start = getTimeUs();
+    for (vx_uint32 i = 0; i < iteration; i++) {
+        status = vxProcessGraph(graph);
+        BENCH_CHECK(status, "processing graph");
+    }
+    *ret_avg_us = (getTimeUs() - start) / iteration;
+
+    return VX_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
+    vx_uint32 width = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_WIDTH;
+    vx_uint32 height = (argc > 2) ? atoi(argv[2]) : BENCH_DEFAULT_HEIGHT;
+    vx_uint32 iteration = (argc > 3) ? atoi(argv[3]) : BENCH_DEFAULT_ITERATION;
+    vx_status status = VX_SUCCESS;
+
+    if ((width == 0) || (height == 0) || (iteration == 0)) {
+        printf("usage: %s [width] [height] [iterations]\n", argv[0]);
+        return -1;
+    }
+
+    vx_context context = vxCreateContext();
+    if (vxGetStatus((vx_reference)context) != VX_SUCCESS) {
+        printf("creating context fails\n");
+        return -1;
+    }
+
+    vx_image in[2], out_fused, out_sep;
+    in[0] = vxCreateImage(context, width, height, VX_DF_IMAGE_U8);
+    in[1] = vxCreateImage(context, width, height, VX_DF_IMAGE_U8);
+    out_fused = vxCreateImage(context, width, height, VX_DF_IMAGE_S16);
+    out_sep = vxCreateImage(context, width, height, VX_DF_IMAGE_S16);
+    status = fillImage(in[0], 1);
+    status |= fillImage(in[1], 2);
+    BENCH_CHECK(status, "filling input");
+
+    /* fused graph, the intermediates are virtual */
+    vx_graph fused = vxCreateGraph(context);
+    vx_image diff = vxCreateVirtualImage(fused, width, height, VX_DF_IMAGE_U8);
+    vx_image blur = vxCreateVirtualImage(fused, width, height, VX_DF_IMAGE_U8);
+    vx_image grad_x = vxCreateVirtualImage(fused, width, height, VX_DF_IMAGE_S16);
+    vx_image grad_y = vxCreateVirtualImage(fused, width, height, VX_DF_IMAGE_S16);
+    status = setCpuTarget(vxAbsDiffNode(fused, in[0], in[1], diff));
+    status |= setCpuTarget(vxGaussian3x3Node(fused, diff, blur));
+    status |= setCpuTarget(vxSobel3x3Node(fused, blur, grad_x, grad_y));
+    status |= setCpuTarget(vxMagnitudeNode(fused, grad_x, grad_y, out_fused));
+    status |= vxVerifyGraph(fused);
+    BENCH_CHECK(status, "making fused graph");
+
+    /* one graph per kernel, every intermediate is written and read back as a whole image */
+    vx_image sep_diff = vxCreateImage(context, width, height, VX_DF_IMAGE_U8);
+    vx_image sep_blur = vxCreateImage(context, width, height, VX_DF_IMAGE_U8);
+    vx_image sep_grad_x = vxCreateImage(context, width, height, VX_DF_IMAGE_S16);
+    vx_image sep_grad_y = vxCreateImage(context, width, height, VX_DF_IMAGE_S16);
+    vx_graph sep[4];
+    for (vx_uint32 i = 0; i < 4; i++)
+        sep[i] = vxCreateGraph(context);
+    status = setCpuTarget(vxAbsDiffNode(sep[0], in[0], in[1], sep_diff));
+    status |= setCpuTarget(vxGaussian3x3Node(sep[1], sep_diff, sep_blur));
+    status |= setCpuTarget(vxSobel3x3Node(sep[2], sep_blur, sep_grad_x, sep_grad_y));
+    status |= setCpuTarget(vxMagnitudeNode(sep[3], sep_grad_x, sep_grad_y, out_sep));
+    for (vx_uint32 i = 0; i < 4; i++)
+        status |= vxVerifyGraph(sep[i]);
+    BENCH_CHECK(status, "making separate graphs");
+
+    vx_uint64 fused_us = 0, sep_us = 0;
+    status = measureGraph(fused, iteration, &fused_us);
+    BENCH_CHECK(status, "measuring fused graph");
+
+    for (vx_uint32 i = 0; i < 4; i++) {
+        vx_uint64 node_us = 0;
+        status = measureGraph(sep[i], iteration, &node_us);
+        BENCH_CHECK(status, "measuring separate graph");
+        sep_us += node_us;
+    }
+
+    vx_uint32 diff_rows = 0;
+    status = compareImage(out_fused, out_sep, &diff_rows);
+    BENCH_CHECK(status, "comparing output");
+
+    /* U8 diff, U8 blur and two S16 gradients */
+    vx_size intermediate_bytes = (vx_size)width * height * (1 + 1 + 2 + 2);
+
+    printf("%ux%u, %u iterations\n", width, height, iteration);
+    printf("fused    : %llu us/frame\n", (unsigned long long)fused_us);
+    printf("separate : %llu us/frame\n", (unsigned long long)sep_us);
+    printf("intermediate images : %zu bytes\n", intermediate_bytes);
+    printf("output : %s (%u rows differ)\n", diff_rows ? "MISMATCH" : "match", diff_rows);
+
+    for (vx_uint32 i = 0; i < 4; i++)
+        vxReleaseGraph(&sep[i]);
+    vxReleaseGraph(&fused);
+    vxReleaseImage(&diff);
+    vxReleaseImage(&blur);
+    vxReleaseImage(&grad_x);
+    vxReleaseImage(&grad_y);
+    vxReleaseImage(&sep_diff);
+    vxReleaseImage(&sep_blur);
+    vxReleaseImage(&sep_grad_x);
+    vxReleaseImage(&sep_grad_y);
+    vxReleaseImage(&in[0]);
+    vxReleaseImage(&in[1]);
+    vxReleaseImage(&out_fused);
+    vxReleaseImage(&out_sep);
+    vxReleaseContext(&context);
+
+    return diff_rows ? -1 : 0;
+}
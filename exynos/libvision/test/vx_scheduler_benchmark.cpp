@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2015, Samsung Electronics Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Scheduling overhead of the subgraphs, on graphs of many small CPU nodes that are not fused.
+ * Each graph has two branches of scale nodes that are merged by absdiff,
+ * so every node boundary is a hand-over between subgraphs.
+ *
+ * per-frame latency : one graph processed frame by frame
+ * throughput        : several graphs scheduled together, frames per second of all of them
+ *
+ * The thread per subgraph model is measured by turning the worker pool off,
+ *   setprop vendor.vision.worker_pool false
+ *
+ * usage: vx_scheduler_benchmark [depth] [graphs] [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <cutils/properties.h>
+
+#include <VX/vx.h>
+#include <VX/vx_api_ext.h>
+
+#define BENCH_WIDTH             320
+#define BENCH_HEIGHT            240
+#define BENCH_DEFAULT_DEPTH     8
+#define BENCH_DEFAULT_GRAPHS    4
+#define BENCH_DEFAULT_ITERATION 200
+#define BENCH_MAX_GRAPHS        16
+
+static vx_uint64 getTimeUs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (vx_uint64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static vx_image makeBranch(vx_graph graph, vx_image in, vx_uint32 depth, vx_status *status)
+{
+    vx_image cur = in;
+
+    for (vx_uint32 i = 0; i < depth; i++) {
+        vx_image next = vxCreateVirtualImage(graph, BENCH_WIDTH, BENCH_HEIGHT, VX_DF_IMAGE_U8);
+        vx_node node = vxScaleImageNode(graph, cur, next, VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR);
+        *status |= vxGetStatus((vx_reference)node);
+        if (*status == VX_SUCCESS)
+            *status |= vxSetNodeTarget(node, VX_TARGET_CPU, NULL);
+        vxReleaseNode(&node);
+        if (cur != in)
+            vxReleaseImage(&cur);
+        cur = next;
+    }
+
+    return cur;
+}
+
+static vx_graph makeGraph(vx_context context, vx_image in, vx_image out, vx_uint32 depth)
+{
+    vx_status status = VX_SUCCESS;
+    vx_graph graph = vxCreateGraph(context);
+
+    vx_image branch0 = makeBranch(graph, in, depth, &status);
+    vx_image branch1 = makeBranch(graph, in, depth, &status);
+    vx_node node = vxAbsDiffNode(graph, branch0, branch1, out);
+    status |= vxGetStatus((vx_reference)node);
+    if (status == VX_SUCCESS)
+        status |= vxSetNodeTarget(node, VX_TARGET_CPU, NULL);
+    vxReleaseNode(&node);
+    vxReleaseImage(&branch0);
+    vxReleaseImage(&branch1);
+
+    if (status == VX_SUCCESS)
+        status = vxVerifyGraph(graph);
+    if (status != VX_SUCCESS) {
+        printf("making graph fails, err:%d\n", status);
+        vxReleaseGraph(&graph);
+        return NULL;
+    }
+
+    return graph;
+}
+
+int main(int argc, char **argv)
+{
+    vx_uint32 depth = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_DEPTH;
+    vx_uint32 graph_num = (argc > 2) ? atoi(argv[2]) : BENCH_DEFAULT_GRAPHS;
+    vx_uint32 iteration = (argc > 3) ? atoi(argv[3]) : BENCH_DEFAULT_ITERATION;
+    vx_status status = VX_SUCCESS;
+    vx_uint32 g;
+
+    if ((depth == 0) || (graph_num == 0) || (graph_num > BENCH_MAX_GRAPHS) || (iteration == 0)) {
+        printf("usage: %s [depth] [graphs(1~%d)] [iterations]\n", argv[0], BENCH_MAX_GRAPHS);
+        return -1;
+    }
+
+    vx_context context = vxCreateContext();
+    if (vxGetStatus((vx_reference)context) != VX_SUCCESS) {
+        printf("creating context fails\n");
+        return -1;
+    }
+
+    vx_image in = vxCreateImage(context, BENCH_WIDTH, BENCH_HEIGHT, VX_DF_IMAGE_U8);
+    vx_image out[BENCH_MAX_GRAPHS];
+    vx_graph graph[BENCH_MAX_GRAPHS];
+    for (g = 0; g < graph_num; g++) {
+        out[g] = vxCreateImage(context, BENCH_WIDTH, BENCH_HEIGHT, VX_DF_IMAGE_U8);
+        graph[g] = makeGraph(context, in, out[g], depth);
+        if (graph[g] == NULL)
+            return -1;
+        /* the first frame allocates the memory, it is not measured */
+        status |= vxProcessGraph(graph[g]);
+    }
+    if (status != VX_SUCCESS) {
+        printf("warming up fails, err:%d\n", status);
+        return -1;
+    }
+
+    /* per-frame latency of a single graph */
+    std::vector<vx_uint64> latency;
+    for (vx_uint32 i = 0; i < iteration; i++) {
+        vx_uint64 start = getTimeUs();
+        status = vxProcessGraph(graph[0]);
+        latency.push_back(getTimeUs() - start);
+        if (status != VX_SUCCESS) {
+            printf("processing graph fails, err:%d\n", status);
+            return -1;
+        }
+    }
+    std::sort(latency.begin(), latency.end());
+    vx_uint64 latency_sum = 0;
+    for (vx_uint32 i = 0; i < latency.size(); i++)
+        latency_sum += latency[i];
+
+    /* throughput of the graphs running together */
+    vx_uint64 start = getTimeUs();
+    for (vx_uint32 i = 0; i < iteration; i++) {
+        for (g = 0; g < graph_num; g++)
+            status |= vxScheduleGraph(graph[g]);
+        for (g = 0; g < graph_num; g++)
+            status |= vxWaitGraph(graph[g]);
+        if (status != VX_SUCCESS) {
+            printf("scheduling graphs fails, err:%d\n", status);
+            return -1;
+        }
+    }
+    vx_uint64 elapsed = getTimeUs() - start;
+
+    printf("%s, %u graphs of %u nodes, %u iterations\n",
+            property_get_bool("vendor.vision.worker_pool", true) ? "worker pool" : "thread per subgraph",
+            graph_num, depth * 2 + 1, iteration);
+    printf("latency    : avg %llu us, p50 %llu us, p99 %llu us\n",
+            (unsigned long long)(latency_sum / latency.size()),
+            (unsigned long long)latency[latency.size() / 2],
+            (unsigned long long)latency[latency.size() * 99 / 100]);
+    printf("throughput : %.1f frames/s\n", (double)iteration * graph_num * 1000000 / elapsed);
+
+    for (g = 0; g < graph_num; g++) {
+        vxReleaseGraph(&graph[g]);
+        vxReleaseImage(&out[g]);
+    }
+    vxReleaseImage(&in);
+    vxReleaseContext(&context);
+
+    return 0;
+}
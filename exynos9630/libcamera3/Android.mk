@@ -65,6 +65,11 @@ LOCAL_CFLAGS += -DUSES_HIFI_LLS
 LOCAL_SHARED_LIBRARIES += libexynoscamera_hifills_plugin
 endif
 
+# the video nodes are simulated, to run the pipes without the driver
+ifeq ($(BOARD_CAMERA_USES_NODE_SIMULATOR), true)
+LOCAL_CFLAGS += -DEXYNOS_CAMERA_NODE_SIMULATOR
+endif
+
 LOCAL_C_INCLUDES += \
 	$(LOCAL_PATH)/../include \
 	$(LOCAL_PATH)/../libcamera3 \
@@ -134,6 +139,7 @@ LOCAL_SRC_FILES = \
 	../../exynos/libcamera3/common_v2/PostProcessing/ExynosCameraPPJPEG.cpp \
 	../../exynos/libcamera3/common_v2/PostProcessing/ExynosCameraPPGDC.cpp \
 	../../exynos/libcamera3/common_v2/PostProcessing/ExynosCameraPPFactory.cpp \
+	../../exynos/libcamera3/common_v2/PostProcessing/ExynosCameraPPSW.cpp \
 	../../exynos/libcamera3/common_v2/MCPipes/ExynosCameraMCPipe.cpp \
 	../../exynos/libcamera3/common_v2/Pipes2/ExynosCameraPipe.cpp \
 	../../exynos/libcamera3/common_v2/Pipes2/ExynosCameraSWPipe.cpp \
@@ -225,6 +231,9 @@ ifeq ($(BOARD_CAMERA_USES_SLSI_PLUGIN), true)
 include $(TOP)/hardware/samsung_slsi/exynos/libcamera3/common_v2/PlugIn/converter/libs/Android.mk
 endif
 
+LIBEXYNOSCAMERA3_C_INCLUDES := $(LOCAL_C_INCLUDES)
+LIBEXYNOSCAMERA3_CFLAGS := $(LOCAL_CFLAGS)
+
 include $(BUILD_SHARED_LIBRARY)
 
 
@@ -320,3 +329,7 @@ ifeq ($(BOARD_CAMERA_USES_SLSI_PLUGIN), true)
 # plugIn
 include $(TOP)/hardware/samsung_slsi/exynos/libcamera3/common_v2/PlugIn/Android.mk
 endif
+
+#################
+# tests
+include $(TOP)/hardware/samsung_slsi/exynos/libcamera3/common_v2/test/Android.mk
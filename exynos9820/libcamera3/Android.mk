@@ -136,6 +136,11 @@ ifeq ($(BOARD_CAMERA_USES_3AA_DNG), true)
 LOCAL_CFLAGS += -DBOARD_CAMERA_3AA_DNG
 endif
 
+# the video nodes are simulated, to run the pipes without the driver
+ifeq ($(BOARD_CAMERA_USES_NODE_SIMULATOR), true)
+LOCAL_CFLAGS += -DEXYNOS_CAMERA_NODE_SIMULATOR
+endif
+
 ifneq ($(LOCAL_PROJECT_DIR),)
 LOCAL_C_INCLUDES += $(LOCAL_PATH)/../libcamera3/Vendor/$(LOCAL_PROJECT_DIR)
 else
@@ -163,6 +168,7 @@ LOCAL_SRC_FILES = \
 	../../exynos/libcamera3/common_v2/PostProcessing/ExynosCameraPPJPEG.cpp \
 	../../exynos/libcamera3/common_v2/PostProcessing/ExynosCameraPPGDC.cpp \
 	../../exynos/libcamera3/common_v2/PostProcessing/ExynosCameraPPFactory.cpp \
+	../../exynos/libcamera3/common_v2/PostProcessing/ExynosCameraPPSW.cpp \
 	../../exynos/libcamera3/common_v2/MCPipes/ExynosCameraMCPipe.cpp \
 	../../exynos/libcamera3/common_v2/Pipes2/ExynosCameraPipe.cpp \
 	../../exynos/libcamera3/common_v2/Pipes2/ExynosCameraSWPipe.cpp \
@@ -281,6 +287,9 @@ ifeq ($(BOARD_CAMERA_USES_SLSI_PLUGIN), true)
 include $(TOP)/hardware/samsung_slsi/exynos/libcamera3/common_v2/PlugIn/converter/libs/Android.mk
 endif
 
+LIBEXYNOSCAMERA3_C_INCLUDES := $(LOCAL_C_INCLUDES)
+LIBEXYNOSCAMERA3_CFLAGS := $(LOCAL_CFLAGS)
+
 include $(BUILD_SHARED_LIBRARY)
 
 
@@ -422,3 +431,7 @@ ifeq ($(BOARD_CAMERA_USES_SLSI_PLUGIN), true)
 # plugIn
 include $(TOP)/hardware/samsung_slsi/exynos/libcamera3/common_v2/PlugIn/Android.mk
 endif
+
+#################
+# tests
+include $(TOP)/hardware/samsung_slsi/exynos/libcamera3/common_v2/test/Android.mk
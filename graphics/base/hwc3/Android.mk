@@ -76,6 +76,7 @@ LOCAL_SRC_FILES := \
 	Composer.cpp \
 	ComposerClient.cpp \
 	ComposerCommandEngine.cpp \
+	LayerStateCache.cpp \
 	impl/HalImpl.cpp \
 	impl/ResourceManager.cpp \
 	service.cpp
@@ -90,3 +91,23 @@ LOCAL_VINTF_FRAGMENTS = hwc3-default.xml
 LOCAL_INIT_RC := hwc3-slsi.rc
 
 include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := hwc3-layer-state-benchmark
+
+LOCAL_LICENSE_KINDS := SPDX-license-identifier-Apache-2.0
+LOCAL_LICENSE_CONDITIONS := notice
+LOCAL_NOTICE_FILE := $(LOCAL_PATH)/NOTICE
+
+LOCAL_PROPRIETARY_MODULE := true
+
+LOCAL_SHARED_LIBRARIES := \
+	android.hardware.graphics.composer3-V1-ndk \
+	libbinder_ndk
+
+LOCAL_SRC_FILES := \
+	LayerStateCache.cpp \
+	benchmark/LayerStateCacheBenchmark.cpp
+
+include $(BUILD_NATIVE_BENCHMARK)
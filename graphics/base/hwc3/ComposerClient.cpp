@@ -73,6 +73,9 @@ ndk::ScopedAStatus ComposerClient::createLayer(int64_t display, int32_t bufferSl
         err = mResources->addLayer(display, *layer, bufferSlotCount);
         if (err) {
             layer = 0;
+        } else {
+            // layer ids can be reused by the HAL, don't inherit the cached state
+            mCommandEngine->removeLayer(display, *layer);
         }
     }
     return TO_BINDER_STATUS(err);
@@ -95,6 +98,7 @@ ndk::ScopedAStatus ComposerClient::destroyLayer(int64_t display, int64_t layer)
     auto err = mHal->destroyLayer(display, layer);
     if (!err) {
         err = mResources->removeLayer(display, layer);
+        mCommandEngine->removeLayer(display, layer);
     }
     return TO_BINDER_STATUS(err);
 }
@@ -104,6 +108,7 @@ ndk::ScopedAStatus ComposerClient::destroyVirtualDisplay(int64_t display) {
     auto err = mHal->destroyVirtualDisplay(display);
     if (!err) {
         err = mResources->removeDisplay(display);
+        mCommandEngine->removeDisplay(display);
     }
     return TO_BINDER_STATUS(err);
 }
@@ -55,7 +55,9 @@ namespace aidl::android::hardware::graphics::composer3::impl {
 
 bool ComposerCommandEngine::init() {
     mWriter = std::make_unique<ComposerServiceWriter>();
-    return (mWriter != nullptr);
+    mBufferReleaser = mResources->createReleaser(true);
+    mStreamReleaser = mResources->createReleaser(false);
+    return (mWriter != nullptr) && (mBufferReleaser != nullptr) && (mStreamReleaser != nullptr);
 }
 
 int32_t ComposerCommandEngine::execute(const std::vector<DisplayCommand>& commands,
@@ -91,18 +93,9 @@ void ComposerCommandEngine::dispatchLayerCommand(int64_t display, const LayerCom
     DISPATCH_LAYER_COMMAND(display, command, cursorPosition, CursorPosition);
     DISPATCH_LAYER_COMMAND(display, command, buffer, Buffer);
     DISPATCH_LAYER_COMMAND(display, command, damage, SurfaceDamage);
-    DISPATCH_LAYER_COMMAND(display, command, blendMode, BlendMode);
-    DISPATCH_LAYER_COMMAND(display, command, color, Color);
     DISPATCH_LAYER_COMMAND(display, command, composition, Composition);
-    DISPATCH_LAYER_COMMAND(display, command, dataspace, Dataspace);
-    DISPATCH_LAYER_COMMAND(display, command, displayFrame, DisplayFrame);
-    DISPATCH_LAYER_COMMAND(display, command, planeAlpha, PlaneAlpha);
     DISPATCH_LAYER_COMMAND(display, command, sidebandStream, SidebandStream);
-    DISPATCH_LAYER_COMMAND(display, command, sourceCrop, SourceCrop);
-    DISPATCH_LAYER_COMMAND(display, command, transform, Transform);
-    DISPATCH_LAYER_COMMAND(display, command, visibleRegion, VisibleRegion);
-    DISPATCH_LAYER_COMMAND(display, command, z, ZOrder);
-    DISPATCH_LAYER_COMMAND(display, command, colorTransform, ColorTransform);
+    executeSetLayerState(display, command);
     // TODO: (b/196171661) add support for mixed composition
     // DISPATCH_LAYER_COMMAND(display, command, whitePointNits, WhitePointNits);
     DISPATCH_LAYER_COMMAND(display, command, perFrameMetadata, PerFrameMetadata);
@@ -146,9 +139,8 @@ void ComposerCommandEngine::executeSetClientTarget(int64_t display, const Client
                              ? nullptr
                              : ::android::makeFromAidl(*command.buffer.handle);
     buffer_handle_t clientTarget;
-    auto bufferReleaser = mResources->createReleaser(true);
     auto err = mResources->getDisplayClientTarget(display, command.buffer.slot, useCache, handle,
-                                                  clientTarget, bufferReleaser.get());
+                                                  clientTarget, mBufferReleaser.get());
     if (!err) {
         err = mHal->setClientTarget(display, clientTarget, command.buffer.fence,
                                     command.dataspace, command.damage);
@@ -160,6 +152,7 @@ void ComposerCommandEngine::executeSetClientTarget(int64_t display, const Client
         LOG(ERROR) << __func__ << " getDisplayClientTarget : err " << err;
         mWriter->setError(mCommandIndex, err);
     }
+    mBufferReleaser->release();
 }
 
 void ComposerCommandEngine::executeSetOutputBuffer(uint64_t display, const Buffer& buffer) {
@@ -168,9 +161,8 @@ void ComposerCommandEngine::executeSetOutputBuffer(uint64_t display, const Buffe
                              ? nullptr
                              : ::android::makeFromAidl(*buffer.handle);
     buffer_handle_t outputBuffer;
-    auto bufferReleaser = mResources->createReleaser(true);
     auto err = mResources->getDisplayOutputBuffer(display, buffer.slot, useCache, handle,
-                                                  outputBuffer, bufferReleaser.get());
+                                                  outputBuffer, mBufferReleaser.get());
     if (!err) {
         err = mHal->setOutputBuffer(display, outputBuffer, buffer.fence);
         if (err) {
@@ -181,6 +173,7 @@ void ComposerCommandEngine::executeSetOutputBuffer(uint64_t display, const Buffe
         LOG(ERROR) << __func__ << " getDisplayOutputBuffer: err " << err;
         mWriter->setError(mCommandIndex, err);
     }
+    mBufferReleaser->release();
 }
 
 void ComposerCommandEngine::executeSetExpectedPresentTimeInternal(
@@ -262,9 +255,8 @@ void ComposerCommandEngine::executeSetLayerBuffer(int64_t display, int64_t layer
                              ? nullptr
                              : ::android::makeFromAidl(*buffer.handle);
     buffer_handle_t hwcBuffer;
-    auto bufferReleaser = mResources->createReleaser(true);
     auto err = mResources->getLayerBuffer(display, layer, buffer.slot, useCache,
-                                          handle, hwcBuffer, bufferReleaser.get());
+                                          handle, hwcBuffer, mBufferReleaser.get());
     if (!err) {
         err = mHal->setLayerBuffer(display, layer, hwcBuffer, buffer.fence);
         if (err) {
@@ -275,6 +267,7 @@ void ComposerCommandEngine::executeSetLayerBuffer(int64_t display, int64_t layer
         LOG(ERROR) << __func__ << ": getLayerBuffer err " << err;
         mWriter->setError(mCommandIndex, err);
     }
+    mBufferReleaser->release();
 }
 
 void ComposerCommandEngine::executeSetLayerSurfaceDamage(int64_t display, int64_t layer,
@@ -286,24 +279,6 @@ void ComposerCommandEngine::executeSetLayerSurfaceDamage(int64_t display, int64_
     }
 }
 
-void ComposerCommandEngine::executeSetLayerBlendMode(int64_t display, int64_t layer,
-                                                     const ParcelableBlendMode& blendMode) {
-    auto err = mHal->setLayerBlendMode(display, layer, blendMode.blendMode);
-    if (err) {
-        LOG(ERROR) << __func__ << ": err " << err;
-        mWriter->setError(mCommandIndex, err);
-    }
-}
-
-void ComposerCommandEngine::executeSetLayerColor(int64_t display, int64_t layer,
-                                                 const Color& color) {
-    auto err = mHal->setLayerColor(display, layer, color);
-    if (err) {
-        LOG(ERROR) << __func__ << ": err " << err;
-        mWriter->setError(mCommandIndex, err);
-    }
-}
-
 void ComposerCommandEngine::executeSetLayerComposition(int64_t display, int64_t layer,
                                                        const ParcelableComposition& composition) {
     auto err = mHal->setLayerCompositionType(display, layer, composition.composition);
@@ -313,41 +288,13 @@ void ComposerCommandEngine::executeSetLayerComposition(int64_t display, int64_t
     }
 }
 
-void ComposerCommandEngine::executeSetLayerDataspace(int64_t display, int64_t layer,
-                                                     const ParcelableDataspace& dataspace) {
-    auto err = mHal->setLayerDataspace(display, layer, dataspace.dataspace);
-    if (err) {
-        LOG(ERROR) << __func__ << ": err " << err;
-        mWriter->setError(mCommandIndex, err);
-    }
-}
-
-void ComposerCommandEngine::executeSetLayerDisplayFrame(int64_t display, int64_t layer,
-                                                        const common::Rect& rect) {
-    auto err = mHal->setLayerDisplayFrame(display, layer, rect);
-    if (err) {
-        LOG(ERROR) << __func__ << ": err " << err;
-        mWriter->setError(mCommandIndex, err);
-    }
-}
-
-void ComposerCommandEngine::executeSetLayerPlaneAlpha(int64_t display, int64_t layer,
-                                                      const PlaneAlpha& planeAlpha) {
-    auto err = mHal->setLayerPlaneAlpha(display, layer, planeAlpha.alpha);
-    if (err) {
-        LOG(ERROR) << __func__ << ": err " << err;
-        mWriter->setError(mCommandIndex, err);
-    }
-}
-
 void ComposerCommandEngine::executeSetLayerSidebandStream(int64_t display, int64_t layer,
                                                  const AidlNativeHandle& sidebandStream) {
     buffer_handle_t handle = ::android::makeFromAidl(sidebandStream);
     buffer_handle_t stream;
 
-    auto bufferReleaser = mResources->createReleaser(false);
     auto err = mResources->getLayerSidebandStream(display, layer, handle,
-                                                  stream, bufferReleaser.get());
+                                                  stream, mStreamReleaser.get());
     if (err) {
         err = mHal->setLayerSidebandStream(display, layer, stream);
     }
@@ -355,41 +302,21 @@ void ComposerCommandEngine::executeSetLayerSidebandStream(int64_t display, int64
         LOG(ERROR) << __func__ << ": err " << err;
         mWriter->setError(mCommandIndex, err);
     }
+    mStreamReleaser->release();
 }
 
-void ComposerCommandEngine::executeSetLayerSourceCrop(int64_t display, int64_t layer,
-                                                      const common::FRect& sourceCrop) {
-    auto err = mHal->setLayerSourceCrop(display, layer, sourceCrop);
-    if (err) {
-        LOG(ERROR) << __func__ << ": err " << err;
-        mWriter->setError(mCommandIndex, err);
-    }
-}
-
-void ComposerCommandEngine::executeSetLayerTransform(int64_t display, int64_t layer,
-                                                     const ParcelableTransform& transform) {
-    auto err = mHal->setLayerTransform(display, layer, transform.transform);
-    if (err) {
-        LOG(ERROR) << __func__ << ": err " << err;
-        mWriter->setError(mCommandIndex, err);
-    }
-}
-
-void ComposerCommandEngine::executeSetLayerVisibleRegion(int64_t display, int64_t layer,
-                          const std::vector<std::optional<common::Rect>>& visibleRegion) {
-    auto err = mHal->setLayerVisibleRegion(display, layer, visibleRegion);
-    if (err) {
-        LOG(ERROR) << __func__ << ": err " << err;
-        mWriter->setError(mCommandIndex, err);
+void ComposerCommandEngine::executeSetLayerState(int64_t display, const LayerCommand& command) {
+    LayerCommand changed;
+    if (!mLayerStates.update(display, command, &changed)) {
+        return;
     }
-}
 
-void ComposerCommandEngine::executeSetLayerZOrder(int64_t display, int64_t layer,
-                                                  const ZOrder& zOrder) {
-    auto err = mHal->setLayerZOrder(display, layer, zOrder.z);
+    auto err = mHal->setLayerState(display, command.layer, changed);
     if (err) {
         LOG(ERROR) << __func__ << ": err " << err;
         mWriter->setError(mCommandIndex, err);
+        // part of the state may not be applied, send all of it next time
+        mLayerStates.removeLayer(display, command.layer);
     }
 }
 
@@ -402,15 +329,6 @@ void ComposerCommandEngine::executeSetLayerPerFrameMetadata(int64_t display, int
     }
 }
 
-void ComposerCommandEngine::executeSetLayerColorTransform(int64_t display, int64_t layer,
-                                                       const std::vector<float>& matrix) {
-    auto err = mHal->setLayerColorTransform(display, layer, matrix);
-    if (err) {
-        LOG(ERROR) << __func__ << ": err " << err;
-        mWriter->setError(mCommandIndex, err);
-    }
-}
-
 void ComposerCommandEngine::executeSetLayerPerFrameMetadataBlobs(int64_t display, int64_t layer,
                       const std::vector<std::optional<PerFrameMetadataBlob>>& metadata) {
     auto err = mHal->setLayerPerFrameMetadataBlobs(display, layer, metadata);
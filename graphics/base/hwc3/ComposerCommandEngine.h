@@ -20,6 +20,7 @@
 
 #include <memory>
 
+#include "LayerStateCache.h"
 #include "include/IComposerHal.h"
 #include "include/IResourceManager.h"
 
@@ -38,6 +39,14 @@ class ComposerCommandEngine {
           mWriter->reset();
       }
 
+      // Forget the cached state of destroyed layers and displays
+      void removeLayer(int64_t display, int64_t layer) {
+          mLayerStates.removeLayer(display, layer);
+      }
+      void removeDisplay(int64_t display) {
+          mLayerStates.removeDisplay(display);
+      }
+
   private:
       void dispatchDisplayCommand(const DisplayCommand& displayCommand);
       void dispatchLayerCommand(int64_t display, const LayerCommand& displayCommand);
@@ -58,30 +67,14 @@ class ComposerCommandEngine {
       void executeSetLayerBuffer(int64_t display, int64_t layer, const Buffer& buffer);
       void executeSetLayerSurfaceDamage(int64_t display, int64_t layer,
                                         const std::vector<std::optional<common::Rect>>& damage);
-      void executeSetLayerBlendMode(int64_t display, int64_t layer,
-                                    const ParcelableBlendMode& blendMode);
-      void executeSetLayerColor(int64_t display, int64_t layer, const Color& color);
       void executeSetLayerComposition(int64_t display, int64_t layer,
                                       const ParcelableComposition& composition);
-      void executeSetLayerDataspace(int64_t display, int64_t layer,
-                                    const ParcelableDataspace& dataspace);
-      void executeSetLayerDisplayFrame(int64_t display, int64_t layer, const common::Rect& rect);
-      void executeSetLayerPlaneAlpha(int64_t display, int64_t layer, const PlaneAlpha& planeAlpha);
       void executeSetLayerSidebandStream(int64_t display, int64_t layer,
                                          const AidlNativeHandle& sidebandStream);
-      void executeSetLayerSourceCrop(int64_t display, int64_t layer,
-                                     const common::FRect& sourceCrop);
-      void executeSetLayerTransform(int64_t display, int64_t layer,
-                                    const ParcelableTransform& transform);
-      void executeSetLayerVisibleRegion(
-              int64_t display, int64_t layer,
-              const std::vector<std::optional<common::Rect>>& visibleRegion);
-      void executeSetLayerZOrder(int64_t display, int64_t layer, const ZOrder& zOrder);
+      void executeSetLayerState(int64_t display, const LayerCommand& command);
       void executeSetLayerPerFrameMetadata(
               int64_t display, int64_t layer,
               const std::vector<std::optional<PerFrameMetadata>>& perFrameMetadata);
-      void executeSetLayerColorTransform(int64_t display, int64_t layer,
-                                         const std::vector<float>& colorTransform);
       void executeSetLayerPerFrameMetadataBlobs(
               int64_t display, int64_t layer,
               const std::vector<std::optional<PerFrameMetadataBlob>>& perFrameMetadataBlob);
@@ -94,6 +87,10 @@ class ComposerCommandEngine {
       IResourceManager* mResources;
       std::unique_ptr<ComposerServiceWriter> mWriter;
       int32_t mCommandIndex;
+      LayerStateCache mLayerStates;
+      // Reused by every command, release() drops the replaced buffer after each use
+      std::unique_ptr<IBufferReleaser> mBufferReleaser;
+      std::unique_ptr<IBufferReleaser> mStreamReleaser;
 };
 
 } // namespace aidl::android::hardware::graphics::composer3::impl
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LayerStateCache.h"
+
+namespace aidl::android::hardware::graphics::composer3::impl {
+
+#define UPDATE_LAYER_STATE(layerCmd, cached, changed, field)       \
+    do {                                                           \
+        if (layerCmd.field && layerCmd.field != cached.field) {    \
+            cached.field = layerCmd.field;                         \
+            changed->field = layerCmd.field;                       \
+            hasChange = true;                                      \
+        }                                                          \
+    } while (0)
+
+bool LayerStateCache::update(int64_t display, const LayerCommand& command,
+                             LayerCommand* outChanged) {
+    LayerCommand& cached = mDisplays[display][command.layer];
+    bool hasChange = false;
+
+    outChanged->layer = command.layer;
+    UPDATE_LAYER_STATE(command, cached, outChanged, blendMode);
+    UPDATE_LAYER_STATE(command, cached, outChanged, color);
+    UPDATE_LAYER_STATE(command, cached, outChanged, displayFrame);
+    UPDATE_LAYER_STATE(command, cached, outChanged, planeAlpha);
+    UPDATE_LAYER_STATE(command, cached, outChanged, sourceCrop);
+    UPDATE_LAYER_STATE(command, cached, outChanged, transform);
+    UPDATE_LAYER_STATE(command, cached, outChanged, visibleRegion);
+    UPDATE_LAYER_STATE(command, cached, outChanged, z);
+    UPDATE_LAYER_STATE(command, cached, outChanged, colorTransform);
+
+    // The HAL resets the dataspace of a layer when it gets a new buffer
+    if (command.buffer) {
+        cached.dataspace.reset();
+    }
+    UPDATE_LAYER_STATE(command, cached, outChanged, dataspace);
+
+    return hasChange;
+}
+
+void LayerStateCache::removeLayer(int64_t display, int64_t layer) {
+    auto it = mDisplays.find(display);
+    if (it != mDisplays.end()) {
+        it->second.erase(layer);
+    }
+}
+
+void LayerStateCache::removeDisplay(int64_t display) {
+    mDisplays.erase(display);
+}
+
+} // namespace aidl::android::hardware::graphics::composer3::impl
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <aidl/android/hardware/graphics/composer3/LayerCommand.h>
+
+#include <unordered_map>
+
+namespace aidl::android::hardware::graphics::composer3::impl {
+
+/// Layer state last applied to the HAL. The client sends the full layer state
+// with every geometry change, so most fields are the same as in the previous
+// frame and don't have to reach the HAL again.
+//
+// Only the fields that are pure state are tracked. Buffer, damage, composition,
+// cursor, sideband and metadata fields always have to be applied.
+class LayerStateCache {
+  public:
+      // Copies the tracked fields of command that differ from the cache into
+      // outChanged and updates the cache. Returns false if there is nothing to apply.
+      bool update(int64_t display, const LayerCommand& command, LayerCommand* outChanged);
+
+      // The HAL state of the layer is unknown, apply everything next time.
+      void removeLayer(int64_t display, int64_t layer);
+      void removeDisplay(int64_t display);
+      void clear() { mDisplays.clear(); }
+
+  private:
+      // Only the tracked fields of the cached commands are set
+      using LayerStates = std::unordered_map<int64_t, LayerCommand>;
+      std::unordered_map<int64_t, LayerStates> mDisplays;
+};
+
+} // namespace aidl::android::hardware::graphics::composer3::impl
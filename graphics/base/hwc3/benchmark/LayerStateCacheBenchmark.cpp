@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "LayerStateCache.h"
+
+using namespace aidl::android::hardware::graphics;
+using namespace aidl::android::hardware::graphics::composer3;
+using aidl::android::hardware::graphics::composer3::impl::LayerStateCache;
+
+static constexpr int64_t kDisplay = 0;
+
+// Full layer state as the client sends it after a geometry change
+static LayerCommand makeLayerCommand(int64_t layer) {
+    LayerCommand command;
+    command.layer = layer;
+    command.blendMode = ParcelableBlendMode{common::BlendMode::PREMULTIPLIED};
+    command.color = Color{0.f, 0.f, 0.f, 1.f};
+    command.dataspace = ParcelableDataspace{common::Dataspace::SRGB};
+    command.displayFrame = common::Rect{0, static_cast<int32_t>(layer) * 10, 1080,
+                                        static_cast<int32_t>(layer) * 10 + 100};
+    command.planeAlpha = PlaneAlpha{1.f};
+    command.sourceCrop = common::FRect{0.f, 0.f, 1080.f, 100.f};
+    command.transform = ParcelableTransform{common::Transform::NONE};
+    command.visibleRegion = std::vector<std::optional<common::Rect>>{command.displayFrame};
+    command.z = ZOrder{static_cast<int32_t>(layer)};
+    command.colorTransform = std::vector<float>(16, 0.f);
+    return command;
+}
+
+static int countFields(const LayerCommand& command) {
+    return !!command.blendMode + !!command.color + !!command.dataspace +
+           !!command.displayFrame + !!command.planeAlpha + !!command.sourceCrop +
+           !!command.transform + !!command.visibleRegion + !!command.z +
+           !!command.colorTransform;
+}
+
+// arg(0): number of layers, arg(1): number of layers moving in every frame
+static void BM_LayerStateCache_Update(benchmark::State& state) {
+    const int64_t numLayers = state.range(0);
+    const int64_t numMoving = state.range(1);
+
+    std::vector<LayerCommand> commands;
+    for (int64_t layer = 0; layer < numLayers; layer++) {
+        commands.push_back(makeLayerCommand(layer));
+    }
+
+    LayerStateCache cache;
+    int64_t frame = 0;
+    int64_t perFieldCalls = 0;
+    int64_t batchedCalls = 0;
+    for (auto _ : state) {
+        for (int64_t layer = 0; layer < numMoving; layer++) {
+            commands[layer].displayFrame->top = static_cast<int32_t>(frame % 100);
+        }
+        for (const auto& command : commands) {
+            LayerCommand changed;
+            // one HAL call per field without the cache, one per changed layer with it
+            perFieldCalls += countFields(command);
+            if (cache.update(kDisplay, command, &changed)) {
+                batchedCalls++;
+            }
+            benchmark::DoNotOptimize(changed);
+        }
+        frame++;
+    }
+
+    state.counters["perFieldHalCalls/frame"] =
+            benchmark::Counter(perFieldCalls, benchmark::Counter::kAvgIterations);
+    state.counters["batchedHalCalls/frame"] =
+            benchmark::Counter(batchedCalls, benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * numLayers);
+}
+BENCHMARK(BM_LayerStateCache_Update)
+        ->Args({20, 0})->Args({20, 2})->Args({20, 20})
+        ->Args({35, 0})->Args({35, 2})->Args({35, 35})
+        ->Args({50, 0})->Args({50, 2})->Args({50, 50});
+
+BENCHMARK_MAIN();
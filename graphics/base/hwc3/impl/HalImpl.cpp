@@ -866,6 +866,79 @@ int32_t HalImpl::setLayerZOrder(int64_t display, int64_t layer, uint32_t z) {
     return mDevice->setLayerZOrder(halLayer, z);
 }
 
+int32_t HalImpl::setLayerState(int64_t display, int64_t layer, const LayerCommand& command) {
+    ExynosLayer *halLayer;
+    RET_IF_ERR(getHalLayer(display, layer, halLayer));
+
+    int32_t ret = HWC2_ERROR_NONE;
+    int32_t err;
+
+    // attributes that do not change geometry are set without the device lock
+    if (command.color) {
+        hwc_color_t hwcColor;
+        a2h::translate(*command.color, hwcColor);
+        if ((err = halLayer->setLayerColor(hwcColor)) != HWC2_ERROR_NONE) ret = err;
+    }
+    if (command.planeAlpha) {
+        if ((err = halLayer->setLayerPlaneAlpha(command.planeAlpha->alpha)) != HWC2_ERROR_NONE)
+            ret = err;
+    }
+    if (command.visibleRegion) {
+        std::vector<hwc_rect_t> hwcVisible;
+        a2h::translate(*command.visibleRegion, hwcVisible);
+        hwc_region_t region = { hwcVisible.size(), hwcVisible.data() };
+        if ((err = halLayer->setLayerVisibleRegion(region)) != HWC2_ERROR_NONE) ret = err;
+    }
+    if (command.colorTransform) {
+        if ((err = halLayer->setLayerColorTransform(command.colorTransform->data())) !=
+            HWC2_ERROR_NONE)
+            ret = err;
+    }
+
+    ExynosLayerState state;
+    bool hasState = false;
+    if (command.blendMode) {
+        int32_t hwcMode;
+        a2h::translate(command.blendMode->blendMode, hwcMode);
+        state.blendMode = hwcMode;
+        hasState = true;
+    }
+    if (command.dataspace) {
+        int32_t hwcDataspace;
+        a2h::translate(command.dataspace->dataspace, hwcDataspace);
+        state.dataspace = hwcDataspace;
+        hasState = true;
+    }
+    if (command.displayFrame) {
+        hwc_rect_t hwcFrame;
+        a2h::translate(*command.displayFrame, hwcFrame);
+        state.displayFrame = hwcFrame;
+        hasState = true;
+    }
+    if (command.sourceCrop) {
+        hwc_frect_t hwcCrop;
+        a2h::translate(*command.sourceCrop, hwcCrop);
+        state.sourceCrop = hwcCrop;
+        hasState = true;
+    }
+    if (command.transform) {
+        int32_t hwcTransform;
+        a2h::translate(command.transform->transform, hwcTransform);
+        state.transform = hwcTransform;
+        hasState = true;
+    }
+    if (command.z) {
+        state.z = command.z->z;
+        hasState = true;
+    }
+
+    if (hasState && (err = mDevice->setLayerState(halLayer, state)) != HWC2_ERROR_NONE) {
+        ret = err;
+    }
+
+    return ret;
+}
+
 int32_t HalImpl::setOutputBuffer(int64_t display, buffer_handle_t buffer,
                                  const ndk::ScopedFileDescriptor& releaseFence) {
     ExynosDisplay* halDisplay;
@@ -966,9 +1039,15 @@ int32_t HalImpl::validateDisplay(int64_t display, std::vector<int64_t>* outChang
 }
 
 int HalImpl::setExpectedPresentTime(
-        int64_t __unused display, const std::optional<ClockMonotonicTimestamp> __unused expectedPresentTime) {
+        int64_t display, const std::optional<ClockMonotonicTimestamp> expectedPresentTime) {
+    ExynosDisplay* halDisplay;
+    RET_IF_ERR(getHalDisplay(display, halDisplay));
 
-    return HWC2_ERROR_UNSUPPORTED;
+    uint64_t timestamp = 0;
+    if (expectedPresentTime.has_value() && expectedPresentTime->timestampNanos > 0)
+        timestamp = expectedPresentTime->timestampNanos;
+
+    return halDisplay->setExpectedPresentTime(timestamp);
 }
 
 } // namespace aidl::android::hardware::graphics::composer3::impl
@@ -31,6 +31,7 @@ class BufferReleaser : public IBufferReleaser {
     virtual ~BufferReleaser() = default;
 
     ComposerResources::ReplacedHandle* getReplacedHandle() { return &mReplacedHandle; }
+    void release() override { mReplacedHandle.reset(); }
 
   private:
     // ReplacedHandle releases buffer at its destruction.
@@ -193,6 +193,11 @@ class IComposerHal {
     virtual int32_t setLayerVisibleRegion(int64_t display, int64_t layer,
                                  const std::vector<std::optional<common::Rect>>& visible) = 0;
     virtual int32_t setLayerZOrder(int64_t display, int64_t layer, uint32_t z) = 0;
+    // Applies blendMode, color, dataspace, displayFrame, planeAlpha, sourceCrop,
+    // transform, visibleRegion, z and colorTransform of command with one layer lookup.
+    // Other fields of command are ignored.
+    virtual int32_t setLayerState(int64_t display, int64_t layer,
+                                  const LayerCommand& command) = 0; // cmd
     virtual int32_t setOutputBuffer(int64_t display, buffer_handle_t buffer,
                                     const ndk::ScopedFileDescriptor& releaseFence) = 0;
     virtual int32_t setPowerMode(int64_t display, PowerMode mode) = 0;
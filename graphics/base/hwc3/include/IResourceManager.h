@@ -23,10 +23,12 @@ using AidlNativeHandle = aidl::android::hardware::common::NativeHandle;
 namespace aidl::android::hardware::graphics::composer3::impl {
 
 /// Some IResourceManager functions return a replaced buffer and that buffer should be
-// released later (at the time of IBufferReleaser object destruction)
+// released later (at the time of IBufferReleaser object destruction or release())
 class IBufferReleaser {
  public:
     virtual ~IBufferReleaser() = default;
+    // Releases the replaced buffer so that the releaser can be used again
+    virtual void release() = 0;
 };
 
 class IResourceManager {
@@ -37,7 +37,8 @@ LOCAL_SRC_FILES := \
 	drmplane.cpp \
 	drmproperty.cpp \
 	drmeventlistener.cpp \
-	vsyncworker.cpp
+	vsyncworker.cpp \
+	vsyncpredictor.cpp
 
 LOCAL_CFLAGS := -DHLOG_CODE=0
 LOCAL_CFLAGS += -Wno-unused-parameter
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "hwc-vsync-predictor"
+
+#include "vsyncpredictor.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+
+namespace android {
+
+static const size_t kHistorySize = 20;
+static const size_t kMinSamples = 6;
+/* Timestamps further than this from the model are jitter */
+static const int64_t kOutlierPercent = 20;
+/* This many rejects in a row means the phase has moved */
+static const uint32_t kMaxConsecutiveRejects = 3;
+/* Fitted period further than this from the mode is not trusted */
+static const int64_t kPeriodTolerancePercent = 10;
+/* Mode period changes smaller than this keep the history */
+static const int64_t kPeriodChangePercent = 1;
+
+VSyncPredictor::VSyncPredictor()
+    : ideal_period_(0),
+      next_index_(0),
+      last_timestamp_(-1),
+      consecutive_rejects_(0),
+      model_valid_(false),
+      base_(0),
+      intercept_(0),
+      period_(0),
+      total_abs_error_ns_(0),
+      error_count_(0) {
+  timestamps_.reserve(kHistorySize);
+}
+
+void VSyncPredictor::ResetLocked() {
+  timestamps_.clear();
+  next_index_ = 0;
+  last_timestamp_ = -1;
+  consecutive_rejects_ = 0;
+  model_valid_ = false;
+}
+
+void VSyncPredictor::Reset() {
+  std::lock_guard<std::mutex> lock(lock_);
+  ResetLocked();
+}
+
+void VSyncPredictor::SetIdealPeriod(int64_t period_ns) {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (period_ns <= 0)
+    return;
+  if (ideal_period_ &&
+      llabs(period_ns - ideal_period_) * 100 <=
+          ideal_period_ * kPeriodChangePercent)
+    return;
+
+  ideal_period_ = period_ns;
+  if (!timestamps_.empty()) {
+    ResetLocked();
+    metrics_.resets++;
+  }
+}
+
+void VSyncPredictor::UpdateModelLocked() {
+  model_valid_ = false;
+  if (timestamps_.size() < 2)
+    return;
+
+  base_ = *std::min_element(timestamps_.begin(), timestamps_.end());
+
+  int64_t guess = ideal_period_;
+  if (guess <= 0) {
+    /* Without the mode period, the shortest interval is the best guess */
+    std::vector<int64_t> sorted(timestamps_);
+    std::sort(sorted.begin(), sorted.end());
+    guess = INT64_MAX;
+    for (size_t i = 1; i < sorted.size(); i++)
+      guess = std::min(guess, sorted[i] - sorted[i - 1]);
+    if (guess <= 0 || guess == INT64_MAX)
+      return;
+  }
+
+  /* Least squares of (t - base_) against the vsync ordinal */
+  double n = timestamps_.size();
+  double sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+  for (int64_t timestamp : timestamps_) {
+    double y = timestamp - base_;
+    double x = llround(y / guess);
+    sum_x += x;
+    sum_y += y;
+    sum_xx += x * x;
+    sum_xy += x * y;
+  }
+  double denom = n * sum_xx - sum_x * sum_x;
+  if (denom == 0)
+    return;
+
+  double slope = (n * sum_xy - sum_x * sum_y) / denom;
+  if (ideal_period_ > 0 &&
+      fabs(slope - ideal_period_) * 100 > ideal_period_ * kPeriodTolerancePercent)
+    slope = ideal_period_;
+
+  period_ = slope;
+  intercept_ = (sum_y - slope * sum_x) / n;
+  model_valid_ = (timestamps_.size() >= kMinSamples);
+}
+
+bool VSyncPredictor::AddTimestamp(int64_t timestamp) {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (timestamp <= last_timestamp_) {
+    metrics_.rejected++;
+    return false;
+  }
+
+  if (model_valid_) {
+    double offset = (timestamp - base_) - intercept_;
+    double predicted = intercept_ + period_ * llround(offset / period_);
+    int64_t error = llabs(llround((timestamp - base_) - predicted));
+    if (error * 100 > llround(period_) * kOutlierPercent) {
+      metrics_.rejected++;
+      if (++consecutive_rejects_ < kMaxConsecutiveRejects)
+        return false;
+      /* Phase has moved, start over from this timestamp */
+      ResetLocked();
+      metrics_.resets++;
+    } else {
+      total_abs_error_ns_ += error;
+      error_count_++;
+      metrics_.max_abs_error_ns = std::max(metrics_.max_abs_error_ns, error);
+    }
+  }
+
+  consecutive_rejects_ = 0;
+  if (timestamps_.size() < kHistorySize) {
+    timestamps_.push_back(timestamp);
+  } else {
+    timestamps_[next_index_] = timestamp;
+  }
+  next_index_ = (next_index_ + 1) % kHistorySize;
+  last_timestamp_ = timestamp;
+  metrics_.samples++;
+
+  UpdateModelLocked();
+  return true;
+}
+
+int64_t VSyncPredictor::NextVSyncAfterLocked(int64_t after) const {
+  if (model_valid_) {
+    double offset = (after - base_) - intercept_;
+    double n = floor(offset / period_) + 1;
+    return base_ + llround(intercept_ + n * period_);
+  }
+
+  if (last_timestamp_ < 0 || ideal_period_ <= 0)
+    return -1;
+
+  double n = floor((double)(after - last_timestamp_) / ideal_period_) + 1;
+  return last_timestamp_ + llround(n * ideal_period_);
+}
+
+int64_t VSyncPredictor::NextVSyncAfter(int64_t after) const {
+  std::lock_guard<std::mutex> lock(lock_);
+  return NextVSyncAfterLocked(after);
+}
+
+int64_t VSyncPredictor::GetPeriod() const {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (model_valid_)
+    return llround(period_);
+  return ideal_period_;
+}
+
+int64_t VSyncPredictor::GetModelTimestamp() const {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (!model_valid_)
+    return -1;
+  return last_timestamp_;
+}
+
+VSyncPredictor::Metrics VSyncPredictor::GetMetrics() const {
+  std::lock_guard<std::mutex> lock(lock_);
+  Metrics metrics = metrics_;
+  if (error_count_)
+    metrics.mean_abs_error_ns = total_abs_error_ns_ / error_count_;
+  return metrics;
+}
+}  // namespace android
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_VSYNC_PREDICTOR_H_
+#define ANDROID_VSYNC_PREDICTOR_H_
+
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+
+namespace android {
+
+/*
+ * Estimates vsync period and phase from hardware vsync timestamps.
+ *
+ * Timestamps are fitted with least squares against their vsync ordinal,
+ * so missed events only leave a gap in the ordinals. Timestamps that are
+ * too far from the model are dropped as jitter, and the history is dropped
+ * when the nominal period of the mode changes.
+ */
+class VSyncPredictor {
+ public:
+  struct Metrics {
+    uint64_t samples = 0;
+    uint64_t rejected = 0;
+    uint64_t resets = 0;
+    /* Error of the prediction made before each accepted timestamp */
+    int64_t mean_abs_error_ns = 0;
+    int64_t max_abs_error_ns = 0;
+  };
+
+  VSyncPredictor();
+
+  void SetIdealPeriod(int64_t period_ns);
+  /* Returns false if the timestamp is rejected */
+  bool AddTimestamp(int64_t timestamp);
+  void Reset();
+
+  /* Returns the first vsync after the given time, or -1 without history */
+  int64_t NextVSyncAfter(int64_t after) const;
+  int64_t GetPeriod() const;
+  /* Returns the newest timestamp of the model, or -1 if it is not valid */
+  int64_t GetModelTimestamp() const;
+  Metrics GetMetrics() const;
+
+ private:
+  void ResetLocked();
+  void UpdateModelLocked();
+  int64_t NextVSyncAfterLocked(int64_t after) const;
+
+  mutable std::mutex lock_;
+  int64_t ideal_period_;
+  std::vector<int64_t> timestamps_;
+  size_t next_index_;
+  int64_t last_timestamp_;
+  uint32_t consecutive_rejects_;
+
+  /* vsync(n) = base_ + intercept_ + period_ * n */
+  bool model_valid_;
+  int64_t base_;
+  double intercept_;
+  double period_;
+
+  Metrics metrics_;
+  int64_t total_abs_error_ns_;
+  uint64_t error_count_;
+};
+}  // namespace android
+
+#endif
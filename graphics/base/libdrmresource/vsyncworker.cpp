@@ -64,6 +64,22 @@ void VSyncWorker::VSyncControl(bool enabled) {
   Signal();
 }
 
+int64_t VSyncWorker::GetExpectedVSync(int64_t after) const {
+  return predictor_.NextVSyncAfter(after);
+}
+
+int64_t VSyncWorker::GetVSyncPeriod() const {
+  return predictor_.GetPeriod();
+}
+
+int64_t VSyncWorker::GetLastVSync() const {
+  return predictor_.GetModelTimestamp();
+}
+
+VSyncPredictor::Metrics VSyncWorker::GetPredictorMetrics() const {
+  return predictor_.GetMetrics();
+}
+
 /*
  * Returns the timestamp of the next vsync in phase with last_timestamp_.
  * For example:
@@ -87,21 +103,31 @@ int64_t VSyncWorker::GetPhasedVSync(int64_t frame_ns, int64_t current) {
 
 static const int64_t kOneSecondNs = 1LL * 1000 * 1000 * 1000;
 
+/* Returns the vsync period of the active mode, 0 if it is unknown */
+int64_t VSyncWorker::GetIdealPeriod(int display) {
+  DrmConnector *conn = drm_->GetConnectorForDisplay(display);
+  if (conn && conn->active_mode().v_refresh() != 0.0f)
+    return kOneSecondNs / conn->active_mode().v_refresh();
+  return 0;
+}
+
 int VSyncWorker::SyntheticWaitVBlank(int64_t *timestamp) {
   struct timespec vsync;
   int ret = clock_gettime(CLOCK_MONOTONIC, &vsync);
 
-  float refresh = 60.0f;  // Default to 60Hz refresh rate
-  DrmConnector *conn = drm_->GetConnectorForDisplay(display_);
-  if (conn && conn->active_mode().v_refresh() != 0.0f)
-    refresh = conn->active_mode().v_refresh();
-  else
-    ALOGW("Vsync worker active with conn=%p refresh=%f\n", conn,
-          conn ? conn->active_mode().v_refresh() : 0.0f);
-
-  int64_t phased_timestamp = GetPhasedVSync(kOneSecondNs / refresh,
-                                            vsync.tv_sec * kOneSecondNs +
-                                                vsync.tv_nsec);
+  int64_t current = vsync.tv_sec * kOneSecondNs + vsync.tv_nsec;
+  /* Stay in phase with the hardware vsync model while it is available */
+  int64_t phased_timestamp = predictor_.NextVSyncAfter(current);
+  if (phased_timestamp < 0) {
+    int64_t frame_ns = GetIdealPeriod(display_);
+    if (frame_ns == 0) {
+      DrmConnector *conn = drm_->GetConnectorForDisplay(display_);
+      ALOGW("Vsync worker active with conn=%p refresh=%f\n", conn,
+            conn ? conn->active_mode().v_refresh() : 0.0f);
+      frame_ns = kOneSecondNs / 60;  // Default to 60Hz refresh rate
+    }
+    phased_timestamp = GetPhasedVSync(frame_ns, current);
+  }
   vsync.tv_sec = phased_timestamp / kOneSecondNs;
   vsync.tv_nsec = phased_timestamp - (vsync.tv_sec * kOneSecondNs);
   do {
@@ -143,6 +169,9 @@ void VSyncWorker::Routine() {
       DRM_VBLANK_RELATIVE | (high_crtc & DRM_VBLANK_HIGH_CRTC_MASK));
   vblank.request.sequence = 1;
 
+  /* Mode change drops the history of the previous period */
+  predictor_.SetIdealPeriod(GetIdealPeriod(display));
+
   int64_t timestamp;
   ret = drmWaitVBlank(drm_->fd(), &vblank);
   if (ret == -EINTR) {
@@ -154,6 +183,8 @@ void VSyncWorker::Routine() {
   } else {
     timestamp = (int64_t)vblank.reply.tval_sec * kOneSecondNs +
                 (int64_t)vblank.reply.tval_usec * 1000;
+    /* Only hardware timestamps feed the model */
+    predictor_.AddTimestamp(timestamp);
   }
 
   /*
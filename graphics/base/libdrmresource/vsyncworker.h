@@ -18,6 +18,7 @@
 #define ANDROID_EVENT_WORKER_H_
 
 #include "drmdevice.h"
+#include "vsyncpredictor.h"
 #include "worker.h"
 
 #include <stdint.h>
@@ -45,11 +46,19 @@ class VSyncWorker : public Worker {
 
   void VSyncControl(bool enabled);
 
+  /* Predicted vsync after the given time, -1 if there is no history */
+  int64_t GetExpectedVSync(int64_t after) const;
+  int64_t GetVSyncPeriod() const;
+  /* Newest vsync the prediction is made from, -1 if it is not valid */
+  int64_t GetLastVSync() const;
+  VSyncPredictor::Metrics GetPredictorMetrics() const;
+
  protected:
   void Routine() override;
 
  private:
   int64_t GetPhasedVSync(int64_t frame_ns, int64_t current);
+  int64_t GetIdealPeriod(int display);
   int SyntheticWaitVBlank(int64_t *timestamp);
 
   DrmDevice *drm_;
@@ -59,6 +68,7 @@ class VSyncWorker : public Worker {
   int display_;
   std::atomic_bool enabled_;
   int64_t last_timestamp_;
+  VSyncPredictor predictor_;
 };
 }  // namespace android
 
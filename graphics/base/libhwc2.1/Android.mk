@@ -76,6 +76,7 @@ LOCAL_SRC_FILES := \
 	device/ExynosDeviceInterface.cpp \
 	device/ExynosResourceManager.cpp \
 	display/ExynosDisplay.cpp \
+	display/ExynosDamageRegion.cpp \
 	display/ExynosDisplayDrmInterface.cpp \
 	display/ExynosDrmFramebufferManager.cpp \
 	display/ExynosDisplayFbInterface.cpp \
@@ -88,6 +89,7 @@ LOCAL_SRC_FILES := \
 	virtualdisplay/ExynosVirtualDisplay.cpp \
 	virtualdisplay/ExynosVirtualDisplayFbInterface.cpp \
 	resources/ExynosMPP.cpp \
+	resources/ExynosBandwidthModel.cpp \
 	utils/ExynosFenceTracer.cpp \
 	utils/ExynosHWCDebug.cpp \
 	utils/ExynosHWCFormat.cpp \
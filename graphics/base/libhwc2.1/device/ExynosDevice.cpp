@@ -309,6 +309,8 @@ void ExynosDevice::handleHotplug() {
             if (mDisplays[i]->checkHotplugEventUpdated(hpdStatus)) {
                 mDisplays[i]->handleHotplugEvent(hpdStatus);
                 displayIndex = i;
+                if (!hpdStatus)
+                    mResourceManager->removeBandwidthEstimation(mDisplays[i]->mDisplayId);
                 if (mDisplays[i]->mType == HWC_DISPLAY_EXTERNAL) {
                     updateNonPrimaryDisplayList(mDisplays[i]);
                     if (!hpdStatus) {
@@ -326,8 +328,10 @@ void ExynosDevice::handleHotplug() {
                     Mutex::Autolock lock(mMutex);
                     ExynosVirtualDisplay *virtualDisplay = (ExynosVirtualDisplay *)mDisplays[i];
                     virtualDisplay->setExternalPlugState(hpdStatus, mGeometryChanged);
-                    if (hpdStatus && virtualDisplay->mPlugState)
+                    if (hpdStatus && virtualDisplay->mPlugState) {
                         virtualDisplay->destroyVirtualDisplay();
+                        mResourceManager->removeBandwidthEstimation(virtualDisplay->mDisplayId);
+                    }
                     break;
                 }
             }
@@ -557,6 +561,7 @@ int32_t ExynosDevice::destroyVirtualDisplay(ExynosDisplay *display) {
     Mutex::Autolock lock(mMutex);
 
     ((ExynosVirtualDisplay *)display)->destroyVirtualDisplay();
+    mResourceManager->removeBandwidthEstimation(display->mDisplayId);
     mResourceManager->reloadResourceForHWFC();
     mResourceManager->setTargetDisplayLuminance(0, 100);
     mResourceManager->setTargetDisplayDevice(0);
@@ -679,6 +684,7 @@ void ExynosDevice::dump(uint32_t *outSize, char *outBuffer) {
         if (display->mPlugState == true)
             display->dump(result);
     }
+    mResourceManager->dump(result);
 
     if (outBuffer == NULL) {
         *outSize = (uint32_t)result.length();
@@ -1308,6 +1314,13 @@ int32_t ExynosDevice::validateAllDisplays(ExynosDisplay *firstDisplay,
 
     HDEBUGLOGD(eDebugResourceManager, "This is first validate");
 
+    /*
+     * Resources and layers of every display are updated below.
+     * Wait for the displays being committed without device lock.
+     */
+    for (size_t i = 0; i < mDisplays.size(); i++)
+        mDisplays[i]->waitForCommit();
+
     if ((exynosHWCControl.displayMode < DISPLAY_MODE_NUM) &&
         (mDisplayMode != exynosHWCControl.displayMode)) {
         setGeometryChanged(GEOMETRY_DEVICE_DISP_MODE_CHAGED);
@@ -1650,7 +1663,14 @@ int32_t ExynosDevice::presentDisplay(ExynosDisplay *display,
     }
 #endif
     getDevicePresentInfo(mDevicePresentInfo);
-    ret = display->presentDisplay(mDevicePresentInfo, outPresentFence);
+    /*
+     * Other displays can be presented while this display commits
+     * so it uses its own copy of mDevicePresentInfo.
+     */
+    DevicePresentInfo presentInfo = mDevicePresentInfo;
+    presentInfo.releaseDeviceLock = [this]() { mMutex.unlock(); };
+    presentInfo.acquireDeviceLock = [this]() { mMutex.lock(); };
+    ret = display->presentDisplay(presentInfo, outPresentFence);
     if (ret != HWC2_ERROR_NONE) {
         errString.appendFormat("%s:: %s display present error : %d\n", __func__,
                                display->mDisplayName.c_str(), ret);
@@ -2046,6 +2066,35 @@ int32_t ExynosDevice::setLayerZOrder(ExynosLayer *layer, uint32_t z) {
     return ret;
 }
 
+int32_t ExynosDevice::setLayerState(ExynosLayer *layer, const ExynosLayerState &state) {
+    Mutex::Autolock lock(mMutex);
+    int32_t ret = HWC2_ERROR_NONE;
+    int32_t err;
+
+    if (state.blendMode &&
+        ((err = layer->setLayerBlendMode(*state.blendMode, mGeometryChanged)) != NO_ERROR))
+        ret = err;
+    if (state.dataspace &&
+        ((err = layer->setLayerDataspace(*state.dataspace, mGeometryChanged)) != NO_ERROR))
+        ret = err;
+    if (state.displayFrame) {
+        clearRenderingStateFlags();
+        if ((err = layer->setLayerDisplayFrame(*state.displayFrame, mGeometryChanged)) != NO_ERROR)
+            ret = err;
+    }
+    if (state.sourceCrop &&
+        ((err = layer->setLayerSourceCrop(*state.sourceCrop, mGeometryChanged)) != NO_ERROR))
+        ret = err;
+    if (state.transform &&
+        ((err = layer->setLayerTransform(*state.transform, mGeometryChanged)) != NO_ERROR))
+        ret = err;
+    if (state.z &&
+        ((err = layer->setLayerZOrder(*state.z, mGeometryChanged)) != NO_ERROR))
+        ret = err;
+
+    return ret;
+}
+
 int32_t ExynosDevice::setColorMode(ExynosDisplay *display, int32_t mode) {
     Mutex::Autolock lock(mMutex);
     return display->setColorMode(mode, mCanProcessWCG, mGeometryChanged);
@@ -2076,6 +2125,8 @@ int32_t ExynosDevice::setPowerMode(ExynosDisplay *display, int32_t /*hwc2_power_
             finishFrame();
     }
 
+    /* Power off clears the display, wait for the frame in commit */
+    display->waitForCommit();
     int32_t ret = display->setPowerMode(mode, mGeometryChanged);
     handleVsyncPeriodChangeInternal();
     return ret;
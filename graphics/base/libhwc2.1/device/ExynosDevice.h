@@ -31,6 +31,7 @@
 #include <sys/resource.h>
 #include <cutils/atomic.h>
 #include <unordered_map>
+#include <optional>
 
 #include <thread>
 #include <atomic>
@@ -90,6 +91,19 @@ class ExynosLayer;
 class ExynosResourceManager;
 class ExynosDeviceInterface;
 
+/*
+ * Layer attributes that changed since the last command.
+ * Attributes that are not set are left as they are.
+ */
+struct ExynosLayerState {
+    std::optional<int32_t> /*hwc2_blend_mode_t*/ blendMode;
+    std::optional<int32_t> /*android_dataspace_t*/ dataspace;
+    std::optional<hwc_rect_t> displayFrame;
+    std::optional<hwc_frect_t> sourceCrop;
+    std::optional<int32_t> /*hwc_transform_t*/ transform;
+    std::optional<uint32_t> z;
+};
+
 class ExynosDevice : public ExynosHotplugHandler, ExynosPanelResetHandler, ExynosFpsChangedCallback {
   public:
     /**
@@ -342,6 +356,8 @@ class ExynosDevice : public ExynosHotplugHandler, ExynosPanelResetHandler, Exyno
     int32_t setLayerTransform(ExynosLayer *layer,
                               int32_t /*hwc_transform_t*/ transform);
     int32_t setLayerZOrder(ExynosLayer *layer, uint32_t z);
+    /* Applies all attributes in state under one device lock */
+    int32_t setLayerState(ExynosLayer *layer, const ExynosLayerState &state);
     int32_t printMppsAttr();
     void resetForDestroyClient();
 
@@ -350,6 +366,19 @@ class ExynosDevice : public ExynosHotplugHandler, ExynosPanelResetHandler, Exyno
 
   protected:
     uint32_t mInterfaceType;
+    /*
+     * Lock ordering
+     * mMutex -> ExynosExternalDisplay::mExternalMutex ->
+     * ExynosDisplay::mDisplayMutex -> ExynosDisplay::mCommitMutex ->
+     * ExynosFenceTracer::mFenceMutex
+     * A lock is taken only after the ones before it.
+     * presentDisplay() drops mMutex and mDisplayMutex while it holds
+     * mCommitMutex for the commit, and takes them again after
+     * mCommitMutex is released (beginCommit() and endCommit()).
+     * A commit begins only with mMutex held, so the device waits for the
+     * frame in commit with ExynosDisplay::waitForCommit() under mMutex
+     * instead of holding mCommitMutex across the display calls.
+     */
     Mutex mMutex;
     DeviceValidateInfo mDeviceValidateInfo;
     DevicePresentInfo mDevicePresentInfo;
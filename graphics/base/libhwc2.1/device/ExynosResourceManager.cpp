@@ -143,6 +143,7 @@ ExynosResourceManager::ExynosResourceManager() {
     }
 
     ALOGI("mOtfMPPs(%zu), mM2mMPPs(%zu)", mOtfMPPs.size(), mM2mMPPs.size());
+    mUseBandwidthQos = property_get_bool("vendor.hwc.exynos.bw_model_qos", false);
     if (hwcCheckDebugMessages(eDebugResourceManager)) {
         for (uint32_t i = 0; i < mOtfMPPs.size(); i++) {
             HDEBUGLOGD(eDebugResourceManager, "otfMPP[%d]", i);
@@ -1822,16 +1823,87 @@ int32_t ExynosResourceManager::updateResourceState() {
 void ExynosResourceManager::setFrameRateForPerformance(ExynosMPP &mpp,
                                                        AcrylicPerformanceRequestFrame *frame) {
     int M2MFps = (int)(1000 / mpp.mCapacity);
+    /*
+     * The driver requests (frame bytes * frame rate) to the bus.
+     * The job should end in BW_M2M_BUDGET_RATIO of the vsync period of the
+     * assigned display, so the rate is the refresh rate / BW_M2M_BUDGET_RATIO
+     * and the request equals the M2M peak of the bandwidth model.
+     */
+    if (mUseBandwidthQos && (mpp.mAssignedDisplayInfo.workingVsyncPeriod != 0))
+        M2MFps = ExynosBandwidthModel::getM2mQosFrameRate(mpp.mAssignedDisplayInfo.workingVsyncPeriod);
     HDEBUGLOGD(eDebugResourceAssigning, "M2M(%d) setFrameRate %d", mpp.mPhysicalType, M2MFps);
     frame->setFrameRate(M2MFps);
 }
 
+void ExynosResourceManager::updateBandwidthEstimation(ExynosDisplay *display) {
+    ExynosDisplayBandwidth &bandwidth = mDisplayBandwidth[display->mDisplayId];
+    uint32_t vsyncPeriod = display->mDisplayInfo.workingVsyncPeriod;
+
+    bandwidth.reset();
+
+    for (uint32_t i = 0; i < mOtfMPPs.size(); i++) {
+        ExynosMPP *mpp = mOtfMPPs[i];
+        if (mpp->mAssignedDisplayInfo.displayIdentifier.id != display->mDisplayId)
+            continue;
+        for (uint32_t j = 0; j < mpp->mAssignedSources.size(); j++) {
+            ExynosMPPSource *mppSource = mpp->mAssignedSources[j];
+            /* DPP reads the output of M2M if the source was processed by M2M */
+            exynos_image &src = (mppSource->mM2mMPP != nullptr) ? mppSource->mMidImg : mppSource->mSrcImg;
+            exynos_image &dst = mppSource->mDstImg;
+            ExynosChannelBandwidth channel;
+            channel.chId = mpp->mChId;
+            channel.top = dst.y;
+            channel.bottom = dst.y + dst.h;
+            channel.bw = ExynosBandwidthModel::getOtfBandwidth(src, dst, display->mYres, vsyncPeriod);
+            bandwidth.dpuAvgRead += channel.bw.avgRead;
+            bandwidth.channels.push_back(channel);
+        }
+    }
+    bandwidth.dpuPeakRead = ExynosBandwidthModel::getOverlapPeakBandwidth(bandwidth.channels);
+    bandwidth.dpuPeakReadMax = std::max(bandwidth.dpuPeakReadMax, bandwidth.dpuPeakRead);
+
+    for (uint32_t i = 0; i < mM2mMPPs.size(); i++) {
+        ExynosMPP *mpp = mM2mMPPs[i];
+        if ((mpp->mAssignedDisplayInfo.displayIdentifier.id != display->mDisplayId) ||
+            (mpp->mAssignedSources.size() == 0))
+            continue;
+        std::vector<exynos_image> srcs;
+        for (uint32_t j = 0; j < mpp->mAssignedSources.size(); j++)
+            srcs.push_back(mpp->mAssignedSources[j]->mSrcImg);
+        ExynosM2mBandwidth job;
+        job.physicalType = mpp->mPhysicalType;
+        job.physicalIndex = mpp->mPhysicalIndex;
+        job.bytesPerFrame = ExynosBandwidthModel::getM2mFrameBytes(srcs);
+        job.bw = ExynosBandwidthModel::getM2mBandwidth(srcs, mpp->mAssignedSources[0]->mMidImg,
+                                                       mpp->mAssignedDisplayInfo.workingVsyncPeriod);
+        bandwidth.m2mJobs.push_back(job);
+    }
+
+    HDEBUGLOGD(eDebugResourceManager, "%s:: display(%d) DPU read avg(%" PRIu64 "), peak(%" PRIu64 "), m2m jobs(%zu)",
+               __func__, display->mDisplayId, bandwidth.dpuAvgRead, bandwidth.dpuPeakRead,
+               bandwidth.m2mJobs.size());
+}
+
+void ExynosResourceManager::dump(String8 &result) const {
+    result.appendFormat("Bandwidth estimation (M2M QoS from model: %d)\n", mUseBandwidthQos);
+    for (auto &it : mDisplayBandwidth) {
+        result.appendFormat("display id(%d)\n", it.first);
+        it.second.dump(result);
+    }
+}
+
+void ExynosResourceManager::removeBandwidthEstimation(uint32_t displayId) {
+    mDisplayBandwidth.erase(displayId);
+}
+
 int32_t ExynosResourceManager::deliverPerformanceInfo(ExynosDisplay *display) {
     int ret = NO_ERROR;
 
     if (display == nullptr)
         return -EINVAL;
 
+    updateBandwidthEstimation(display);
+
     for (uint32_t mpp_physical_type = MPP_DPP_NUM; mpp_physical_type < MPP_P_TYPE_MAX; mpp_physical_type++) {
         AcrylicPerformanceRequest request;
         uint32_t assignedInstanceNum = 0;
@@ -26,6 +26,7 @@
 #include "ExynosHWCHelper.h"
 #include "ExynosMPPModule.h"
 #include "ExynosResourceRestriction.h"
+#include "ExynosBandwidthModel.h"
 
 using namespace android;
 
@@ -153,6 +154,10 @@ class ExynosResourceManager {
                                         ExynosLayer *layer, std::vector<exynos_image> &image_lists);
     int32_t setResourcePriority(ExynosDisplay *display);
     int32_t deliverPerformanceInfo(ExynosDisplay *display);
+    void updateBandwidthEstimation(ExynosDisplay *display);
+    /* Called when the display is disconnected or destroyed */
+    void removeBandwidthEstimation(uint32_t displayId);
+    void dump(String8 &result) const;
     virtual int32_t prepareResources();
     int32_t finishAssignResourceWork();
 
@@ -240,6 +245,10 @@ class ExynosResourceManager {
     std::map<uint32_t, ExynosDisplay *> mDisplayMap;
     DeviceResourceInfo mDeviceInfo;
     bool mDeviceSupportWCG = false;
+    /* Estimated DRAM traffic of the last frame per display id */
+    std::map<uint32_t, ExynosDisplayBandwidth> mDisplayBandwidth;
+    /* Request M2M QoS from the bandwidth model instead of the capacity table */
+    bool mUseBandwidthQos = false;
 
   public:
     virtual bool isHWResourceAvailable(ExynosDisplay __unused *display, ExynosMPP __unused *currentMPP, ExynosMPPSource __unused *mppSrc) { return true; };
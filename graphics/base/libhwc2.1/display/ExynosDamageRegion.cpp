@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2012 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+#include "ExynosDamageRegion.h"
+#include "ExynosHWCHelper.h"
+
+void ExynosDamageStats::dump(String8 &result) {
+    result.appendFormat("\twindow update: frames(%" PRIu64 "), partial(%" PRIu64 "), "
+                        "pixels(%" PRIu64 " / %" PRIu64 ")\n",
+                        frames, partialFrames, pixelsTransferred, pixelsFull);
+}
+
+ExynosDamageRegion::ExynosDamageRegion()
+    : mXres(0), mYres(0) {
+}
+
+void ExynosDamageRegion::init(uint32_t xres, uint32_t yres, const ExynosDamageCost &cost) {
+    mXres = xres;
+    mYres = yres;
+    mCost = cost;
+    if (mCost.maxRegions == 0)
+        mCost.maxRegions = 1;
+    mRects.clear();
+}
+
+uint64_t ExynosDamageRegion::getArea(const hwc_rect &rect) {
+    if ((rect.right <= rect.left) || (rect.bottom <= rect.top))
+        return 0;
+    return (uint64_t)(rect.right - rect.left) * (rect.bottom - rect.top);
+}
+
+bool ExynosDamageRegion::isIntersected(const hwc_rect &r1, const hwc_rect &r2) {
+    return (r1.left < r2.right) && (r2.left < r1.right) &&
+           (r1.top < r2.bottom) && (r2.top < r1.bottom);
+}
+
+hwc_rect ExynosDamageRegion::align(const hwc_rect &rect) const {
+    hwc_rect aligned = rect;
+    aligned.left = pixel_align_down(max(rect.left, 0), mCost.xAlign);
+    aligned.top = pixel_align_down(max(rect.top, 0), mCost.yAlign);
+    aligned.right = min(pixel_align(rect.right, mCost.xAlign), (int)mXres);
+    aligned.bottom = min(pixel_align(rect.bottom, mCost.yAlign), (int)mYres);
+    return aligned;
+}
+
+uint64_t ExynosDamageRegion::getRegionOverhead() const {
+    if (mCost.regionOverhead)
+        return mCost.regionOverhead;
+    return (uint64_t)mXres * WINUPDATE_REGION_OVERHEAD_LINES;
+}
+
+uint64_t ExynosDamageRegion::getCost(const std::vector<hwc_rect> &rects) const {
+    uint64_t cost = 0;
+    for (auto &rect : rects)
+        cost += getArea(rect) + getRegionOverhead();
+    return cost;
+}
+
+uint64_t ExynosDamageRegion::getFullCost() const {
+    /* Full update does not need partial region setup */
+    return (uint64_t)mXres * mYres;
+}
+
+uint64_t ExynosDamageRegion::getPixels() const {
+    uint64_t pixels = 0;
+    for (auto &rect : mRects)
+        pixels += getArea(rect);
+    return pixels;
+}
+
+hwc_rect ExynosDamageRegion::getBounds() const {
+    hwc_rect bounds = {(int)mXres, (int)mYres, 0, 0};
+    for (auto &rect : mRects)
+        bounds = expand(bounds, rect);
+    return bounds;
+}
+
+void ExynosDamageRegion::insert(hwc_rect rect) {
+    /* Bounding box of merged rects can overlap others, so repeat until disjoint */
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (auto it = mRects.begin(); it != mRects.end(); it++) {
+            if (isIntersected(*it, rect)) {
+                rect = expand(rect, *it);
+                mRects.erase(it);
+                merged = true;
+                break;
+            }
+        }
+    }
+    mRects.push_back(rect);
+}
+
+void ExynosDamageRegion::add(const hwc_rect &rect) {
+    hwc_rect aligned = align(rect);
+    if (getArea(aligned) == 0)
+        return;
+
+    insert(aligned);
+
+    if (mRects.size() > WINUPDATE_MAX_TRACKED_RECTS) {
+        hwc_rect bounds = getBounds();
+        mRects.clear();
+        mRects.push_back(bounds);
+    }
+}
+
+bool ExynosDamageRegion::plan() {
+    while (mRects.size() > 1) {
+        /* Find the pair whose merge costs the least */
+        uint64_t curCost = getCost();
+        std::vector<hwc_rect> bestRects;
+        uint64_t bestCost = UINT64_MAX;
+        for (size_t i = 0; i < mRects.size(); i++) {
+            for (size_t j = i + 1; j < mRects.size(); j++) {
+                ExynosDamageRegion candidate = *this;
+                candidate.mRects.erase(candidate.mRects.begin() + j);
+                candidate.mRects.erase(candidate.mRects.begin() + i);
+                candidate.insert(expand(mRects[i], mRects[j]));
+                uint64_t cost = candidate.getCost();
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestRects = candidate.mRects;
+                }
+            }
+        }
+
+        if ((mRects.size() <= mCost.maxRegions) && (bestCost >= curCost))
+            break;
+        mRects = bestRects;
+    }
+
+    if (mRects.empty())
+        return true;
+
+    return getCost() >= getFullCost();
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2012 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _EXYNOSDAMAGEREGION_H
+#define _EXYNOSDAMAGEREGION_H
+
+#include <hardware/hwcomposer2.h>
+#include <utils/String8.h>
+#include <vector>
+
+using namespace android;
+
+/*
+ * Fixed cost of one partial update region in pixels.
+ * It covers the DSI column/page address commands and the DPU setup,
+ * expressed as a number of display lines.
+ */
+#define WINUPDATE_REGION_OVERHEAD_LINES 16
+
+/* Damage rects beyond this are merged into their bounding box on add */
+#define WINUPDATE_MAX_TRACKED_RECTS 16
+
+struct ExynosDamageCost {
+    /* Panel partial update alignment */
+    uint32_t xAlign = 1;
+    uint32_t yAlign = 1;
+    /* Number of regions the DPU can update in one frame */
+    uint32_t maxRegions = 1;
+    /* Cost of each region in pixels, 0 means WINUPDATE_REGION_OVERHEAD_LINES lines */
+    uint64_t regionOverhead = 0;
+};
+
+struct ExynosDamageStats {
+    uint64_t frames = 0;
+    uint64_t partialFrames = 0;
+    uint64_t pixelsTransferred = 0;
+    uint64_t pixelsFull = 0;
+    void reset() { *this = {}; };
+    void dump(String8 &result);
+};
+
+/*
+ * Keeps the damage of a frame as a small set of disjoint, aligned rects
+ * and merges them while it lowers the transfer cost or while there are
+ * more rects than the DPU can update.
+ */
+class ExynosDamageRegion {
+  public:
+    ExynosDamageRegion();
+    void init(uint32_t xres, uint32_t yres, const ExynosDamageCost &cost);
+    void clear() { mRects.clear(); };
+    bool isEmpty() const { return mRects.empty(); };
+
+    /* rect is aligned and clipped to the display */
+    void add(const hwc_rect &rect);
+    /* Merges rects following the cost model, returns true for full update */
+    bool plan();
+
+    const std::vector<hwc_rect> &getRects() const { return mRects; };
+    hwc_rect getBounds() const;
+    uint64_t getCost() const { return getCost(mRects); };
+    uint64_t getFullCost() const;
+    uint64_t getPixels() const;
+
+    static uint64_t getArea(const hwc_rect &rect);
+    static bool isIntersected(const hwc_rect &r1, const hwc_rect &r2);
+
+  private:
+    hwc_rect align(const hwc_rect &rect) const;
+    uint64_t getCost(const std::vector<hwc_rect> &rects) const;
+    uint64_t getRegionOverhead() const;
+    /* Merges rect into the set so that the set stays disjoint */
+    void insert(hwc_rect rect);
+
+    uint32_t mXres;
+    uint32_t mYres;
+    ExynosDamageCost mCost;
+    std::vector<hwc_rect> mRects;
+};
+
+#endif  //_EXYNOSDAMAGEREGION_H
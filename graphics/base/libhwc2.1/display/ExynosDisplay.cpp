@@ -50,6 +50,17 @@ extern struct update_time_info updateTimeInfo;
 
 constexpr auto microsecsPerSec = std::chrono::microseconds(1s).count();
 
+void PresentScheduleInfo::dump(String8 &result) {
+    if (frames == 0)
+        return;
+    result.appendFormat("\tpresent schedule: frames(%" PRIu64 "), held(%" PRIu64 "), missed(%" PRIu64 "), "
+                        "hold avg(%" PRId64 " ns), slack avg(%" PRId64 " ns), min(%" PRId64 " ns), "
+                        "commit latency(%" PRId64 " ns)\n",
+                        frames, heldFrames, missedFrames,
+                        heldFrames ? totalHold / (int64_t)heldFrames : 0,
+                        totalSlack / (int64_t)frames, minSlack, commitLatency);
+}
+
 int ExynosSortedLayer::compare(ExynosLayer *const *lhs, ExynosLayer *const *rhs) {
     ExynosLayer *left = *((ExynosLayer **)(lhs));
     ExynosLayer *right = *((ExynosLayer **)(rhs));
@@ -344,6 +355,8 @@ void ExynosDisplay::init(uint32_t maxWindowNum, ExynosMPP *blendingMPP) {
     mExynosCompositionInfo.init(mDisplayInfo.displayIdentifier, blendingMPP);
     initDisplay();
 
+    mUsePresentSchedule = property_get_bool("vendor.hwc.exynos.present_schedule", false);
+
     if (!mUseDpu)
         return;
 
@@ -1797,9 +1810,162 @@ int ExynosDisplay::setWindowUpdate(const hwc_rect &merge_rect) {
     }
 }
 
+/*
+ * Plans the damage region and sets it to mDpuData.
+ * Disjoint regions are delivered only if the DPU can update them in one frame,
+ * win_update_region always has their bounds.
+ */
+int ExynosDisplay::setWindowUpdate(ExynosDamageRegion &region) {
+    bool fullUpdate = region.plan();
+    hwc_rect mergedRect = region.getBounds();
+    if (fullUpdate && !region.isEmpty()) {
+        DISPLAY_LOGD(eDebugWindowUpdate, "Partial cost(%" PRIu64 ") is not lower than full(%" PRIu64 ")",
+                     region.getCost(), region.getFullCost());
+        mergedRect = {0, 0, (int)mXres, (int)mYres};
+    }
+
+    mDpuData.win_update_region_cnt = 0;
+    if (setWindowUpdate(mergedRect) != NO_ERROR)
+        return -1;
+
+    const std::vector<hwc_rect> &rects = region.getRects();
+    if (fullUpdate || (rects.size() <= 1) || (rects.size() > MAX_WIN_UPDATE_REGIONS))
+        return NO_ERROR;
+
+    for (size_t i = 0; i < rects.size(); i++) {
+        DISPLAY_LOGD(eDebugWindowUpdate, "Partial region[%zu] : %d, %d, %d, %d",
+                     i, rects[i].left, rects[i].top, rects[i].right, rects[i].bottom);
+        mDpuData.win_update_regions[i].x = rects[i].left;
+        mDpuData.win_update_regions[i].y = rects[i].top;
+        mDpuData.win_update_regions[i].w = WIDTH(rects[i]);
+        mDpuData.win_update_regions[i].h = HEIGHT(rects[i]);
+    }
+    mDpuData.win_update_region_cnt = rects.size();
+
+    return NO_ERROR;
+}
+
+int32_t ExynosDisplay::setExpectedPresentTime(uint64_t expectedPresentTime) {
+    Mutex::Autolock lock(mDisplayMutex);
+    mPresentSchedule.expectedPresentTime = expectedPresentTime;
+    return HWC2_ERROR_NONE;
+}
+
+/*
+ * Returns the predicted vsync closest to the expected present time,
+ * -1 if the frame should be committed right away.
+ */
+int64_t ExynosDisplay::getPresentTargetVsync() {
+    uint64_t expectedPresentTime = mPresentSchedule.expectedPresentTime;
+    /* The hint is only for one frame */
+    mPresentSchedule.expectedPresentTime = 0;
+
+    if (!mUsePresentSchedule || (expectedPresentTime == 0) || (mVsyncPeriod == 0))
+        return -1;
+
+    int64_t targetVsync = 0;
+    int64_t period = 0;
+    int64_t lastVsync = -1;
+    int64_t after = (int64_t)expectedPresentTime - (int64_t)mVsyncPeriod / 2;
+    if (mDisplayInterface->getPredictedVsync(after, &targetVsync, &period, &lastVsync) != HWC2_ERROR_NONE)
+        return -1;
+
+    /*
+     * The model gets samples only while HW vsync is enabled,
+     * so it is not trusted after vsync has been off for a while.
+     */
+    if ((lastVsync < 0) ||
+        (systemTime(SYSTEM_TIME_MONOTONIC) - lastVsync > period * PRESENT_SCHEDULE_MAX_VSYNC_AGE_FRAMES))
+        return -1;
+
+    return targetVsync;
+}
+
+/*
+ * Committing early makes the frame wait for the previous one in the
+ * driver, so sleep until the latest point the commit still makes
+ * targetVsync. Caller does not hold the device lock while committing.
+ */
+void ExynosDisplay::holdUntilPresentTime(int64_t targetVsync) {
+    if (targetVsync < 0)
+        return;
+
+    int64_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+    int64_t wakeup = targetVsync - mPresentSchedule.commitLatency - PRESENT_SCHEDULE_MARGIN_NS;
+    if (wakeup - now < PRESENT_SCHEDULE_MIN_HOLD_NS)
+        return;
+    wakeup = min(wakeup, now + (int64_t)mVsyncPeriod * PRESENT_SCHEDULE_MAX_HOLD_FRAMES);
+
+    ATRACE_NAME("holdUntilPresentTime");
+    struct timespec wakeupTime;
+    wakeupTime.tv_sec = wakeup / std::chrono::nanoseconds(1s).count();
+    wakeupTime.tv_nsec = wakeup % std::chrono::nanoseconds(1s).count();
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeupTime, NULL) == EINTR)
+        ;
+
+    mPresentSchedule.heldFrames++;
+    mPresentSchedule.totalHold += systemTime(SYSTEM_TIME_MONOTONIC) - now;
+}
+
+void ExynosDisplay::updatePresentSchedule(int64_t targetVsync, int64_t commitStart) {
+    if (targetVsync < 0)
+        return;
+
+    int64_t commitEnd = systemTime(SYSTEM_TIME_MONOTONIC);
+    int64_t latency = commitEnd - commitStart;
+    /* One slow commit should not move the wakeup time much */
+    if (mPresentSchedule.commitLatency == 0)
+        mPresentSchedule.commitLatency = latency;
+    else
+        mPresentSchedule.commitLatency = (mPresentSchedule.commitLatency * 7 + latency) / 8;
+
+    int64_t slack = targetVsync - commitEnd;
+    mPresentSchedule.frames++;
+    mPresentSchedule.totalSlack += slack;
+    mPresentSchedule.minSlack = min(mPresentSchedule.minSlack, slack);
+    if (slack < 0)
+        mPresentSchedule.missedFrames++;
+    ATRACE_INT("presentSlackUs", (int32_t)(slack / 1000));
+}
+
 /**
  * @return int
  */
+/*
+ * Waiting for the previous frame and committing to the driver only use
+ * data of this display. Device lock and mDisplayMutex are released meanwhile
+ * so that other displays can be validated and presented.
+ * The caller holds both locks, they are taken again in the same order.
+ */
+void ExynosDisplay::beginCommit(DevicePresentInfo &presentInfo) {
+    if ((presentInfo.releaseDeviceLock == nullptr) ||
+        (presentInfo.acquireDeviceLock == nullptr))
+        return;
+
+    mCommitMutex.lock();
+    mDisplayMutex.unlock();
+    presentInfo.releaseDeviceLock();
+}
+
+void ExynosDisplay::endCommit(DevicePresentInfo &presentInfo) {
+    if ((presentInfo.releaseDeviceLock == nullptr) ||
+        (presentInfo.acquireDeviceLock == nullptr))
+        return;
+
+    /* Commit lock is the inner one so it is released first */
+    mCommitMutex.unlock();
+    presentInfo.acquireDeviceLock();
+    mDisplayMutex.lock();
+}
+
+/*
+ * A commit begins only with device lock held, so no other commit
+ * can begin until the caller releases device lock.
+ */
+void ExynosDisplay::waitForCommit() {
+    Mutex::Autolock lock(mCommitMutex);
+}
+
 int ExynosDisplay::deliverWinConfigData(DevicePresentInfo &presentInfo) {
     ATRACE_CALL();
     int ret = NO_ERROR;
@@ -1819,6 +1985,9 @@ int ExynosDisplay::deliverWinConfigData(DevicePresentInfo &presentInfo) {
         dumpConfig(mDpuData.configs[i]);
     }
 
+    /* Consume the hint even if the config is skipped */
+    int64_t targetVsync = getPresentTargetVsync();
+
     bool canSkipConfig = exynosHWCControl.skipWinConfig;
     if ((presentInfo.vsyncMode != HIGHEST_MODE) ||
         ((presentInfo.nonPrimaryDisplays.size() > 0) &&
@@ -1851,6 +2020,7 @@ int ExynosDisplay::deliverWinConfigData(DevicePresentInfo &presentInfo) {
 #ifdef WAIT_FENCE
         waitFence = true;
 #endif
+        beginCommit(presentInfo);
         if (waitFence) {
             waitPreviousFrameDone(mLastPresentFence);
         } else {
@@ -1867,12 +2037,19 @@ int ExynosDisplay::deliverWinConfigData(DevicePresentInfo &presentInfo) {
             }
         }
 
+        holdUntilPresentTime(targetVsync);
+        int64_t commitStart = systemTime(SYSTEM_TIME_MONOTONIC);
+
         for (size_t i = 0; i < mDpuData.configs.size(); i++) {
             mFenceTracer.setFenceInfo(mDpuData.configs[i].acq_fence, mDisplayInfo.displayIdentifier,
                                       FENCE_TYPE_SRC_ACQUIRE, FENCE_IP_DPP, FENCE_TO);
         }
 
-        if ((ret = mDisplayInterface->deliverWinConfigData(mDpuData)) < 0) {
+        ret = mDisplayInterface->deliverWinConfigData(mDpuData);
+        updatePresentSchedule(targetVsync, commitStart);
+        endCommit(presentInfo);
+
+        if (ret < 0) {
             DISPLAY_LOGE("%s::interface's deliverWinConfigData() failed: %s, ret(%d)",
                          __func__, strerror(errno), ret);
             return ret;
@@ -3878,6 +4055,9 @@ void ExynosDisplay::dumpConfig(const exynos_win_config_data &c) {
 }
 
 void ExynosDisplay::dump(String8 &result) {
+    /* Do not dump while the frame is being committed without device lock */
+    Mutex::Autolock lock(mCommitMutex);
+
     result.appendFormat("[%s] display information size: %d x %d, vsyncState: %d, colorMode: %d, colorTransformHint: %d\n",
                         mDisplayName.c_str(),
                         mXres, mYres, mVsyncState, mColorMode, mColorTransformHint);
@@ -3888,6 +4068,10 @@ void ExynosDisplay::dump(String8 &result) {
         ExynosLayer *layer = mLayers[i];
         layer->dump(result);
     }
+    mWindowUpdateStats.dump(result);
+    mPresentSchedule.dump(result);
+    if (mDisplayInterface)
+        mDisplayInterface->dumpVsyncPrediction(result);
     result.appendFormat("\n");
 }
 
@@ -4488,26 +4672,49 @@ int ExynosDisplay::handleWindowUpdate() {
     mDpuData.win_update_region.w = mXres;
     mDpuData.win_update_region.y = 0;
     mDpuData.win_update_region.h = mYres;
+    mDpuData.win_update_region_cnt = 0;
+
+    mWindowUpdateStats.frames++;
+    mWindowUpdateStats.pixelsFull += (uint64_t)mXres * mYres;
 
-    if (windowUpdateExceptions())
+    if (windowUpdateExceptions()) {
+        mWindowUpdateStats.pixelsTransferred += (uint64_t)mXres * mYres;
         return 0;
+    }
 
-    hwc_rect mergedRect = {(int)mXres, (int)mYres, 0, 0};
-    hwc_rect damageRect = {(int)mXres, (int)mYres, 0, 0};
-    if (mergeDamageRect(mergedRect, damageRect) != NO_ERROR) {
+    mWindowUpdateCost.xAlign = WIN_UPDATE_X_ALIGN;
+    mWindowUpdateCost.yAlign = WIN_UPDATE_Y_ALIGN;
+    mWindowUpdateCost.maxRegions = mDisplayInterface->getMaxWinUpdateRegions();
+    mDamageRegion.init(mXres, mYres, mWindowUpdateCost);
+    if (mergeDamageRect(mDamageRegion) != NO_ERROR) {
         DISPLAY_LOGD(eDebugWindowUpdate, "Window update is canceled");
+        mWindowUpdateStats.pixelsTransferred += (uint64_t)mXres * mYres;
         return 0;
     }
 
-    if (setWindowUpdate(mergedRect) != NO_ERROR) {
+    if (setWindowUpdate(mDamageRegion) != NO_ERROR) {
         DISPLAY_LOGD(eDebugWindowUpdate, "Window update is canceled");
+        mWindowUpdateStats.pixelsTransferred += (uint64_t)mXres * mYres;
         return 0;
     }
 
+    uint64_t pixels = (uint64_t)mDpuData.win_update_region.w * mDpuData.win_update_region.h;
+    if (mDpuData.win_update_region_cnt > 1) {
+        pixels = 0;
+        for (uint32_t i = 0; i < mDpuData.win_update_region_cnt; i++)
+            pixels += (uint64_t)mDpuData.win_update_regions[i].w * mDpuData.win_update_regions[i].h;
+    }
+    mWindowUpdateStats.pixelsTransferred += pixels;
+    if (pixels < (uint64_t)mXres * mYres)
+        mWindowUpdateStats.partialFrames++;
+
     return 0;
 }
 
-int ExynosDisplay::mergeDamageRect(hwc_rect &merge_rect, hwc_rect &damage_rect) {
+int ExynosDisplay::mergeDamageRect(ExynosDamageRegion &region) {
+    std::vector<hwc_rect> damageRects;
+    hwc_rect damage_rect;
+
     for (size_t i = 0; i < mLayers.size(); i++) {
         int32_t windowIndex = mLayers[i]->mWindowIndex;
         if ((windowIndex < 0) ||
@@ -4528,22 +4735,24 @@ int ExynosDisplay::mergeDamageRect(hwc_rect &merge_rect, hwc_rect &damage_rect)
             damage_rect.bottom = mLayers[i]->mDisplayFrame.bottom;
             DISPLAY_LOGD(eDebugWindowUpdate, "Skip layer (origin) : %d, %d, %d, %d",
                          damage_rect.left, damage_rect.top, damage_rect.right, damage_rect.bottom);
-            merge_rect = expand(merge_rect, damage_rect);
+            region.add(damage_rect);
             hwc_rect prevDst = {mLastDpuData.configs[windowIndex].dst.x, mLastDpuData.configs[windowIndex].dst.y,
                                 mLastDpuData.configs[windowIndex].dst.x + (int)mLastDpuData.configs[windowIndex].dst.w,
                                 mLastDpuData.configs[windowIndex].dst.y + (int)mLastDpuData.configs[windowIndex].dst.h};
             DISPLAY_LOGD(eDebugWindowUpdate, "prev rect(%d, %d, %d, %d)",
                          prevDst.left, prevDst.top, prevDst.right, prevDst.bottom);
 
-            merge_rect = expand(merge_rect, prevDst);
+            region.add(prevDst);
             continue;
         }
 
-        unsigned int excp = getLayerRegion(mLayers[i], damage_rect, eDamageRegionByDamage);
+        damageRects.clear();
+        unsigned int excp = getLayerRegion(mLayers[i], damage_rect, eDamageRegionByDamage, &damageRects);
         if (excp == eDamageRegionPartial) {
             DISPLAY_LOGD(eDebugWindowUpdate, "layer(%zu) partial : %d, %d, %d, %d", i,
                          damage_rect.left, damage_rect.top, damage_rect.right, damage_rect.bottom);
-            merge_rect = expand(merge_rect, damage_rect);
+            for (auto &rect : damageRects)
+                region.add(rect);
         } else if (excp == eDamageRegionSkip) {
             DISPLAY_LOGD(eDebugWindowUpdate, "layer(%zu) skip", i);
             continue;
@@ -4557,7 +4766,7 @@ int ExynosDisplay::mergeDamageRect(hwc_rect &merge_rect, hwc_rect &damage_rect)
                          mLayers[i]->mDisplayFrame.top,
                          mLayers[i]->mDisplayFrame.right,
                          mLayers[i]->mDisplayFrame.bottom);
-            merge_rect = expand(merge_rect, damage_rect);
+            region.add(damage_rect);
         } else {
             DISPLAY_LOGD(eDebugWindowUpdate, "Window update is canceled, Skip reason (layer %zu) : %d", i, excp);
             return -1;
@@ -4567,7 +4776,8 @@ int ExynosDisplay::mergeDamageRect(hwc_rect &merge_rect, hwc_rect &damage_rect)
     return NO_ERROR;
 }
 
-unsigned int ExynosDisplay::getLayerRegion(ExynosLayer *layer, hwc_rect &rect_area, uint32_t regionType) {
+unsigned int ExynosDisplay::getLayerRegion(ExynosLayer *layer, hwc_rect &rect_area, uint32_t regionType,
+                                           std::vector<hwc_rect> *rects) {
     android::Vector<hwc_rect_t> hwcRects;
     size_t numRects = 0;
 
@@ -4612,6 +4822,8 @@ unsigned int ExynosDisplay::getLayerRegion(ExynosLayer *layer, hwc_rect &rect_ar
             adjustRect(rect, INT_MAX, INT_MAX);
             /* Get sums of rects */
             rect_area = expand(rect_area, rect);
+            if (rects != nullptr)
+                rects->push_back(rect);
         }
         return eDamageRegionPartial;
         break;
@@ -5514,6 +5726,8 @@ bool ExynosDisplay::checkHotplugEventUpdated(bool &hpdStatus) {
 void ExynosDisplay::handleHotplugEvent(bool hpdStatus) {
     {
         Mutex::Autolock lock(mDisplayMutex);
+        /* The interface must not be removed during the commit */
+        Mutex::Autolock commitLock(mCommitMutex);
         mHpdStatus = hpdStatus;
         if (!mHpdStatus)
             mDisplayInterface->onDisplayRemoved();
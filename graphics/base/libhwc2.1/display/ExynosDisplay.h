@@ -31,6 +31,7 @@
 #include "ExynosDisplayInterface.h"
 #include "ExynosHWCDebug.h"
 #include "OneShotTimer.h"
+#include "ExynosDamageRegion.h"
 
 //#include <hardware/exynos/hdrInterface.h>
 //#include <hardware/exynos/hdr10pMetaInterface.h>
@@ -45,10 +46,34 @@
 #define SECOND_DISPLAY_START_BIT 4
 #endif
 
+/* Partial update alignment of the panel, ExynosHWCModule.h can override it */
+#ifndef WIN_UPDATE_X_ALIGN
+#define WIN_UPDATE_X_ALIGN 2
+#endif
+#ifndef WIN_UPDATE_Y_ALIGN
+#define WIN_UPDATE_Y_ALIGN 2
+#endif
+
 #ifndef DYNAMIC_RECOMP_TIMER_MS
 #define DYNAMIC_RECOMP_TIMER_MS 500
 #endif
 
+/* Commit is done this long before the target vsync on top of the commit latency */
+#ifndef PRESENT_SCHEDULE_MARGIN_NS
+#define PRESENT_SCHEDULE_MARGIN_NS 2000000
+#endif
+/* Shorter holds are not worth the sleep */
+#ifndef PRESENT_SCHEDULE_MIN_HOLD_NS
+#define PRESENT_SCHEDULE_MIN_HOLD_NS 500000
+#endif
+#ifndef PRESENT_SCHEDULE_MAX_HOLD_FRAMES
+#define PRESENT_SCHEDULE_MAX_HOLD_FRAMES 2
+#endif
+/* Vsync model older than this is not used to hold the commit */
+#ifndef PRESENT_SCHEDULE_MAX_VSYNC_AGE_FRAMES
+#define PRESENT_SCHEDULE_MAX_VSYNC_AGE_FRAMES 4
+#endif
+
 #define LAYER_DUMP_FRAME_CNT_MAX 30
 #define LAYER_DUMP_LAYER_CNT_MAX 30
 #define ATRACE_FD(fd, w, h)                                                \
@@ -334,6 +359,21 @@ struct PendingConfigInfo {
     };
 };
 
+/* Commit timing for the expected present time of the frame */
+struct PresentScheduleInfo {
+    uint64_t expectedPresentTime = 0;
+    /* Moving average of the commit duration */
+    int64_t commitLatency = 0;
+    uint64_t frames = 0;
+    uint64_t heldFrames = 0;
+    uint64_t missedFrames = 0;
+    int64_t totalHold = 0;
+    /* Target vsync - commit done time */
+    int64_t totalSlack = 0;
+    int64_t minSlack = INT64_MAX;
+    void dump(String8 &result);
+};
+
 class ExynosDisplay : public ExynosVsyncHandler {
   public:
     uint32_t mDisplayId;
@@ -427,6 +467,21 @@ class ExynosDisplay : public ExynosVsyncHandler {
          */
     exynos_dpu_data mLastDpuData;
 
+    /**
+         * Damage of the frame for window update.
+         * maxRegions comes from the display interface on each frame.
+         */
+    ExynosDamageRegion mDamageRegion;
+    ExynosDamageCost mWindowUpdateCost;
+    ExynosDamageStats mWindowUpdateStats;
+
+    /**
+         * Frame is held until the latest safe commit point
+         * before the vsync of the expected present time.
+         */
+    bool mUsePresentSchedule = true;
+    PresentScheduleInfo mPresentSchedule;
+
     /**
          * Restore release fence from DECON.
          */
@@ -922,6 +977,13 @@ class ExynosDisplay : public ExynosVsyncHandler {
          */
     virtual int32_t getDisplayVsyncPeriod(hwc2_vsync_period_t *__unused outVsyncPeriod);
 
+    /* setExpectedPresentTime(..., expectedPresentTime)
+         * Hint for the frame of the next validate or present.
+         * The frame is committed just in time for the vsync
+         * closest to expectedPresentTime, 0 clears the hint.
+         */
+    int32_t setExpectedPresentTime(uint64_t expectedPresentTime);
+
     /* setActiveConfigWithConstraints(...,
          *                                config,
          *                                vsyncPeriodChangeConstraints,
@@ -1147,12 +1209,14 @@ class ExynosDisplay : public ExynosVsyncHandler {
     void printConfig(exynos_win_config_data &c);
 
     unsigned int getLayerRegion(ExynosLayer *layer,
-                                hwc_rect &rect_area, uint32_t regionType);
+                                hwc_rect &rect_area, uint32_t regionType,
+                                std::vector<hwc_rect> *rects = nullptr);
     int canApplyWindowUpdate(const exynos_dpu_data &lastConfigsData,
                              const exynos_dpu_data &newConfigsData,
                              uint32_t index);
-    int mergeDamageRect(hwc_rect &merge_rect, hwc_rect &damage_rect);
+    int mergeDamageRect(ExynosDamageRegion &region);
     int setWindowUpdate(const hwc_rect &merge_rect);
+    int setWindowUpdate(ExynosDamageRegion &region);
     bool windowUpdateExceptions();
     int handleWindowUpdate();
 
@@ -1221,9 +1285,24 @@ class ExynosDisplay : public ExynosVsyncHandler {
         return false;
     };
     virtual void resetForDestroyClient();
+    /*
+     * Called with device lock held before the device changes the state
+     * the commit uses. Refer to ExynosDevice.h.
+     */
+    void waitForCommit();
 
   protected:
     Mutex mDisplayMutex;
+    /*
+     * Held instead of mDisplayMutex and device lock
+     * while the frame is committed to the driver.
+     */
+    Mutex mCommitMutex;
+    void beginCommit(DevicePresentInfo &presentInfo);
+    int64_t getPresentTargetVsync();
+    void holdUntilPresentTime(int64_t targetVsync);
+    void updatePresentSchedule(int64_t targetVsync, int64_t commitStart);
+    void endCommit(DevicePresentInfo &presentInfo);
     ExynosVsyncCallback mVsyncCallback;
     ExynosFenceTracer &mFenceTracer = ExynosFenceTracer::getInstance();
     PendingConfigInfo mPendConfigInfo;
@@ -501,6 +501,26 @@ void ExynosDisplayDrmInterface::dumpDisplayConfigs() {
     }
 }
 
+int32_t ExynosDisplayDrmInterface::getPredictedVsync(int64_t after, int64_t *outTimestamp,
+                                                     int64_t *outPeriod, int64_t *outLastVsync) {
+    int64_t timestamp = mDrmVSyncWorker.GetExpectedVSync(after);
+    if (timestamp < 0)
+        return HWC2_ERROR_UNSUPPORTED;
+
+    *outTimestamp = timestamp;
+    *outPeriod = mDrmVSyncWorker.GetVSyncPeriod();
+    *outLastVsync = mDrmVSyncWorker.GetLastVSync();
+    return HWC2_ERROR_NONE;
+}
+
+void ExynosDisplayDrmInterface::dumpVsyncPrediction(String8 &result) {
+    VSyncPredictor::Metrics metrics = mDrmVSyncWorker.GetPredictorMetrics();
+    result.appendFormat("\tvsync model: period(%" PRId64 " ns), samples(%" PRIu64 "), rejected(%" PRIu64 "), "
+                        "resets(%" PRIu64 "), error mean(%" PRId64 " ns), max(%" PRId64 " ns)\n",
+                        mDrmVSyncWorker.GetVSyncPeriod(), metrics.samples, metrics.rejected,
+                        metrics.resets, metrics.mean_abs_error_ns, metrics.max_abs_error_ns);
+}
+
 int32_t ExynosDisplayDrmInterface::getDisplayVsyncPeriod(hwc2_vsync_period_t *outVsyncPeriod) {
     int ret = 0;
     if (mDrmConnector->adjusted_fps().id() == 0) {
@@ -1142,18 +1162,27 @@ int32_t ExynosDisplayDrmInterface::setupPartialRegion(
 
     int ret = NO_ERROR;
 
-    struct decon_frame &update_region = dpuData.win_update_region;
-    struct drm_clip_rect partial_rect = {
-        static_cast<unsigned short>(update_region.x),
-        static_cast<unsigned short>(update_region.y),
-        static_cast<unsigned short>(update_region.x + update_region.w),
-        static_cast<unsigned short>(update_region.y + update_region.h),
+    auto toClipRect = [](const struct decon_frame &update_region) -> drm_clip_rect {
+        return {static_cast<unsigned short>(update_region.x),
+                static_cast<unsigned short>(update_region.y),
+                static_cast<unsigned short>(update_region.x + update_region.w),
+                static_cast<unsigned short>(update_region.y + update_region.h)};
     };
+    std::vector<drm_clip_rect> partial_rects;
+    if ((dpuData.win_update_region_cnt > 1) &&
+        (dpuData.win_update_region_cnt <= getMaxWinUpdateRegions())) {
+        for (uint32_t i = 0; i < dpuData.win_update_region_cnt; i++)
+            partial_rects.push_back(toClipRect(dpuData.win_update_regions[i]));
+    } else {
+        partial_rects.push_back(toClipRect(dpuData.win_update_region));
+    }
+
     if ((mPartialRegionState.blob_id == 0) ||
-        mPartialRegionState.isUpdated(partial_rect)) {
+        mPartialRegionState.isUpdated(partial_rects)) {
         uint32_t blob_id = 0;
-        ret = mDrmDevice->CreatePropertyBlob(&partial_rect,
-                                             sizeof(partial_rect), &blob_id);
+        ret = mDrmDevice->CreatePropertyBlob(partial_rects.data(),
+                                             sizeof(drm_clip_rect) * partial_rects.size(),
+                                             &blob_id);
         if (ret || (blob_id == 0)) {
             HWC_LOGE(mDisplayIdentifier, "Failed to create partial region "
                                          "blob id=%d, ret=%d",
@@ -1161,19 +1190,17 @@ int32_t ExynosDisplayDrmInterface::setupPartialRegion(
             return ret;
         }
 
-        HDEBUGLOGD(eDebugWindowUpdate,
-                   "%s: partial region updated [%d, %d, %d, %d] -> [%d, %d, %d, %d] blob(%d)",
-                   mDisplayIdentifier.name.c_str(),
-                   mPartialRegionState.partial_rect.x1,
-                   mPartialRegionState.partial_rect.y1,
-                   mPartialRegionState.partial_rect.x2,
-                   mPartialRegionState.partial_rect.y2,
-                   partial_rect.x1,
-                   partial_rect.y1,
-                   partial_rect.x2,
-                   partial_rect.y2,
-                   blob_id);
-        mPartialRegionState.partial_rect = partial_rect;
+        for (auto &partial_rect : partial_rects) {
+            HDEBUGLOGD(eDebugWindowUpdate,
+                       "%s: partial region updated [%d, %d, %d, %d] blob(%d)",
+                       mDisplayIdentifier.name.c_str(),
+                       partial_rect.x1,
+                       partial_rect.y1,
+                       partial_rect.x2,
+                       partial_rect.y2,
+                       blob_id);
+        }
+        mPartialRegionState.partial_rects = partial_rects;
 
         if (mPartialRegionState.blob_id)
             drmReq.addOldBlob(mPartialRegionState.blob_id);
@@ -1557,6 +1584,12 @@ uint32_t ExynosDisplayDrmInterface::getMaxWindowNum() {
     return mDrmDevice->planes().size();
 }
 
+uint32_t ExynosDisplayDrmInterface::getMaxWinUpdateRegions() {
+    if (!mDrmCrtc || !mDrmCrtc->partial_region_property().id())
+        return 1;
+    return std::min<uint32_t>(WIN_UPDATE_MAX_REGIONS, MAX_WIN_UPDATE_REGIONS);
+}
+
 ExynosDisplayDrmInterface::DrmModeAtomicReq::DrmModeAtomicReq(ExynosDisplayDrmInterface *displayInterface) {
     init(displayInterface);
 }
@@ -29,6 +29,14 @@
 #include "ExynosHWCTypes.h"
 #include "ExynosDrmFramebufferManager.h"
 #include "drmconnector.h"
+
+/*
+ * Number of drm_clip_rect the partial_region blob of the CRTC takes.
+ * ExynosHWCModule.h defines it if the DPU updates several regions in a frame.
+ */
+#ifndef WIN_UPDATE_MAX_REGIONS
+#define WIN_UPDATE_MAX_REGIONS 1
+#endif
 #include "drmcrtc.h"
 #include "vsyncworker.h"
 
@@ -129,6 +137,7 @@ class ExynosDisplayDrmInterface : public ExynosDisplayInterface,
     virtual int getDisplayFd() { return mDrmDevice->fd(); };
     virtual void initDrmDevice(DrmDevice *drmDevice, int drmDisplayId);
     virtual uint32_t getMaxWindowNum();
+    virtual uint32_t getMaxWinUpdateRegions();
     virtual int32_t getReadbackBufferAttributes(int32_t * /*android_pixel_format_t*/ outFormat,
                                                 int32_t * /*android_dataspace_t*/ outDataspace);
     virtual int32_t getDisplayIdentificationData(uint8_t *outPort,
@@ -136,6 +145,9 @@ class ExynosDisplayDrmInterface : public ExynosDisplayInterface,
 
     /* For HWC 2.4 APIs */
     virtual int32_t getDisplayVsyncPeriod(hwc2_vsync_period_t *outVsyncPeriod);
+    virtual int32_t getPredictedVsync(int64_t after, int64_t *outTimestamp,
+                                      int64_t *outPeriod, int64_t *outLastVsync) override;
+    virtual void dumpVsyncPrediction(String8 &result) override;
     virtual int32_t getConfigChangeDuration();
     virtual int32_t getVsyncAppliedTime(hwc2_config_t configId, displayConfigs &config,
                                         int64_t *actualChangeTime);
@@ -297,13 +309,19 @@ class ExynosDisplayDrmInterface : public ExynosDisplayInterface,
 
   protected:
     struct PartialRegionState {
-        struct drm_clip_rect partial_rect = {0, 0, 0, 0};
+        std::vector<drm_clip_rect> partial_rects;
         uint32_t blob_id = 0;
-        bool isUpdated(drm_clip_rect rect) {
-            return ((partial_rect.x1 != rect.x1) ||
-                    (partial_rect.y1 != rect.y1) ||
-                    (partial_rect.x2 != rect.x2) ||
-                    (partial_rect.y2 != rect.y2));
+        bool isUpdated(const std::vector<drm_clip_rect> &rects) {
+            if (partial_rects.size() != rects.size())
+                return true;
+            for (size_t i = 0; i < rects.size(); i++) {
+                if ((partial_rects[i].x1 != rects[i].x1) ||
+                    (partial_rects[i].y1 != rects[i].y1) ||
+                    (partial_rects[i].x2 != rects[i].x2) ||
+                    (partial_rects[i].y2 != rects[i].y2))
+                    return true;
+            }
+            return false;
         };
     };
 
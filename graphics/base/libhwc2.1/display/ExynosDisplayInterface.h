@@ -63,6 +63,8 @@ class ExynosDisplayInterface {
                                           float *__unused outMaxLuminance, float *__unused outMaxAverageLuminance,
                                           float *__unused outMinLuminance) { return HWC2_ERROR_NONE; };
     virtual int32_t deliverWinConfigData(exynos_dpu_data &__unused dpuData) { return NO_ERROR; };
+    /* Number of partial update regions the DPU updates in one frame */
+    virtual uint32_t getMaxWinUpdateRegions() { return 1; };
     virtual int32_t clearDisplay() { return NO_ERROR; };
     virtual int32_t disableSelfRefresh(uint32_t __unused disable) { return NO_ERROR; };
     virtual int32_t setForcePanic();
@@ -108,6 +110,14 @@ class ExynosDisplayInterface {
     virtual uint64_t getWorkingVsyncPeriod() { return 0; };
     virtual hwc2_config_t getPreferredModeId() { return 0; };
     virtual void resetConfigRequestState(){};
+    /*
+     * First vsync after the given time from the vsync model of the display,
+     * and the newest vsync the model is made from
+     */
+    virtual int32_t getPredictedVsync(int64_t __unused after, int64_t *__unused outTimestamp,
+                                      int64_t *__unused outPeriod,
+                                      int64_t *__unused outLastVsync) { return HWC2_ERROR_UNSUPPORTED; };
+    virtual void dumpVsyncPrediction(String8 &__unused result){};
 
   public:
     uint32_t mType = INTERFACE_TYPE_NONE;
@@ -71,6 +71,9 @@ struct exynos_win_config_data {
     };
 };
 
+/* Partial update regions that can be delivered in one frame */
+#define MAX_WIN_UPDATE_REGIONS 4
+
 struct exynos_dpu_data {
     int present_fence = -1;
     std::vector<exynos_win_config_data> configs;
@@ -78,6 +81,12 @@ struct exynos_dpu_data {
     std::atomic<bool> enable_readback = false;
     bool enable_standalone_writeback = false;
     struct decon_frame win_update_region = {0, 0, 0, 0, 0, 0};
+    /*
+     * Disjoint regions of the partial update, win_update_region is their bounds.
+     * 0 means win_update_region is the only region.
+     */
+    uint32_t win_update_region_cnt = 0;
+    struct decon_frame win_update_regions[MAX_WIN_UPDATE_REGIONS] = {};
     struct exynos_writeback_info readback_info;
     struct exynos_writeback_info standalone_writeback_info;
 #ifdef USE_DQE_INTERFACE
@@ -252,34 +252,46 @@ int32_t ExynosExternalDisplay::canSkipValidate() {
     return ExynosDisplay::canSkipValidate();
 }
 
-int32_t ExynosExternalDisplay::presentDisplay(
-    DevicePresentInfo &presentInfo, int32_t *outPresentFence) {
+/*
+ * Closes the fences of the frame that is not presented.
+ * mExternalMutex is not held during the commit of presentDisplay(),
+ * which takes device lock again. Refer to ExynosDevice.h.
+ */
+bool ExynosExternalDisplay::skipPresent(int32_t *outPresentFence) {
     Mutex::Autolock lock(mExternalMutex);
-    DISPLAY_LOGD(eDebugExternalDisplay, "");
-    int32_t ret;
 
-    if ((mIsSkipFrame) || (mHpdStatus == false) || (mBlanked == true)) {
-        *outPresentFence = -1;
-        for (size_t i = 0; i < mLayers.size(); i++) {
-            ExynosLayer *layer = mLayers[i];
-            layer->mAcquireFence = mFenceTracer.fence_close(layer->mAcquireFence,
-                                                            mDisplayInfo.displayIdentifier, FENCE_TYPE_SRC_ACQUIRE, FENCE_IP_LAYER,
-                                                            "ext::presentDisplay: layer acq_fence, skip case");
-            layer->mReleaseFence = -1;
-        }
-        mClientCompositionInfo.mAcquireFence =
-            mFenceTracer.fence_close(mClientCompositionInfo.mAcquireFence,
-                                     mDisplayInfo.displayIdentifier, FENCE_TYPE_SRC_ACQUIRE, FENCE_IP_FB,
-                                     "ext::presentDisplay: client_comp acq_fence, skip case");
-        mClientCompositionInfo.mReleaseFence = -1;
+    if ((mIsSkipFrame == false) && (mHpdStatus == true) && (mBlanked == false))
+        return false;
 
-        /* this frame is not presented, but mRenderingState is updated to RENDERING_STATE_PRESENTED */
-        initDisplay();
+    *outPresentFence = -1;
+    for (size_t i = 0; i < mLayers.size(); i++) {
+        ExynosLayer *layer = mLayers[i];
+        layer->mAcquireFence = mFenceTracer.fence_close(layer->mAcquireFence,
+                                                        mDisplayInfo.displayIdentifier, FENCE_TYPE_SRC_ACQUIRE, FENCE_IP_LAYER,
+                                                        "ext::presentDisplay: layer acq_fence, skip case");
+        layer->mReleaseFence = -1;
+    }
+    mClientCompositionInfo.mAcquireFence =
+        mFenceTracer.fence_close(mClientCompositionInfo.mAcquireFence,
+                                 mDisplayInfo.displayIdentifier, FENCE_TYPE_SRC_ACQUIRE, FENCE_IP_FB,
+                                 "ext::presentDisplay: client_comp acq_fence, skip case");
+    mClientCompositionInfo.mReleaseFence = -1;
 
-        invalidate();
+    /* this frame is not presented, but mRenderingState is updated to RENDERING_STATE_PRESENTED */
+    initDisplay();
+
+    invalidate();
+
+    return true;
+}
 
+int32_t ExynosExternalDisplay::presentDisplay(
+    DevicePresentInfo &presentInfo, int32_t *outPresentFence) {
+    DISPLAY_LOGD(eDebugExternalDisplay, "");
+    int32_t ret;
+
+    if (skipPresent(outPresentFence))
         return HWC2_ERROR_NONE;
-    }
 
     ret = ExynosDisplay::presentDisplay(presentInfo, outPresentFence);
 
@@ -460,6 +472,8 @@ void ExynosExternalDisplay::handleHotplugEvent(bool hpdStatus) {
     Mutex::Autolock lock(mExternalMutex);
     {
         Mutex::Autolock lock(mDisplayMutex);
+        /* The interface must not be removed during the commit */
+        Mutex::Autolock commitLock(mCommitMutex);
         mHpdStatus = hpdStatus;
         if (!mHpdStatus)
             mDisplayInterface->onDisplayRemoved();
@@ -99,6 +99,7 @@ class ExynosExternalDisplay : public ExynosDisplay {
     virtual bool getHDRException(ExynosLayer *layer,
                                  DevicePresentInfo &deviceInfo) override;
     virtual bool getHDRException();
+    bool skipPresent(int32_t *outPresentFence);
 
   private:
 };
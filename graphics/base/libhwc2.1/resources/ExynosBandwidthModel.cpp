@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2012 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <inttypes.h>
+#include <math.h>
+#include <hardware/hwcomposer_defs.h>
+#include "ExynosBandwidthModel.h"
+
+#define BW_TO_MB(bw) ((bw) / (1024 * 1024))
+
+float ExynosBandwidthModel::getCompressionRatio(const exynos_image &img) {
+    switch (img.compressionInfo.type) {
+    case COMP_TYPE_AFBC:
+        return BW_COMP_RATIO_AFBC;
+    case COMP_TYPE_SBWC:
+        return BW_COMP_RATIO_SBWC;
+    case COMP_TYPE_SAJC:
+        return BW_COMP_RATIO_SAJC;
+    default:
+        return 1.0f;
+    }
+}
+
+float ExynosBandwidthModel::getRotationFactor(const exynos_image &img) {
+    if ((img.transform & HAL_TRANSFORM_ROT_90) == 0)
+        return 1.0f;
+    /* Compressed buffers are fetched by blocks */
+    if (getCompressionRatio(img) < 1.0f)
+        return 1.0f;
+    return BW_ROT_LINEAR_FACTOR;
+}
+
+uint64_t ExynosBandwidthModel::getFrameBytes(const exynos_image &img, bool applyRotation) {
+    if ((img.layerFlags & EXYNOS_HWC_DIM_LAYER) || (img.w == 0) || (img.h == 0))
+        return 0;
+
+    /* bpp of YUV formats already includes chroma planes */
+    uint64_t bytes = ((uint64_t)img.w * img.h * img.exynosFormat.bpp()) / 8;
+    float ratio = getCompressionRatio(img);
+    if (applyRotation)
+        ratio *= getRotationFactor(img);
+
+    return (uint64_t)(bytes * ratio);
+}
+
+uint32_t ExynosBandwidthModel::getFrameRate(uint32_t vsyncPeriod) {
+    if (vsyncPeriod == 0)
+        return 0;
+    return (uint32_t)((BW_NSEC_PER_SEC + vsyncPeriod / 2) / vsyncPeriod);
+}
+
+ExynosBandwidthInfo ExynosBandwidthModel::getOtfBandwidth(const exynos_image &src,
+                                                          const exynos_image &dst,
+                                                          uint32_t displayYres, uint32_t vsyncPeriod) {
+    ExynosBandwidthInfo info;
+    uint32_t fps = getFrameRate(vsyncPeriod);
+    uint64_t bytes = getFrameBytes(src, true);
+
+    if ((bytes == 0) || (fps == 0) || (dst.h == 0) || (displayYres == 0))
+        return info;
+
+    info.avgRead = bytes * fps;
+    /*
+     * Source is fetched during dst.h lines of displayYres lines.
+     * Downscaled layers read several source lines per output line
+     * and it is already included in the frame bytes.
+     */
+    info.peakRead = (info.avgRead * displayYres) / std::min(dst.h, displayYres);
+
+    return info;
+}
+
+uint64_t ExynosBandwidthModel::getOverlapPeakBandwidth(const std::vector<ExynosChannelBandwidth> &channels) {
+    /* Sweep over the scanlines where the set of active channels changes */
+    std::vector<std::pair<uint32_t, int64_t>> edges;
+    edges.reserve(channels.size() * 2);
+    for (auto &ch : channels) {
+        if (ch.bottom <= ch.top)
+            continue;
+        edges.push_back({ch.top, (int64_t)ch.bw.peakRead});
+        edges.push_back({ch.bottom, -(int64_t)ch.bw.peakRead});
+    }
+    /* Channel that ends at a line does not overlap with one that starts there */
+    std::sort(edges.begin(), edges.end(),
+              [](const std::pair<uint32_t, int64_t> &l, const std::pair<uint32_t, int64_t> &r) {
+                  if (l.first != r.first)
+                      return l.first < r.first;
+                  return l.second < r.second;
+              });
+
+    int64_t current = 0;
+    int64_t peak = 0;
+    for (auto &edge : edges) {
+        current += edge.second;
+        peak = std::max(peak, current);
+    }
+    return (uint64_t)peak;
+}
+
+uint64_t ExynosBandwidthModel::getM2mFrameBytes(const std::vector<exynos_image> &srcs) {
+    uint64_t bytes = 0;
+    for (auto &src : srcs)
+        bytes += getFrameBytes(src, true);
+    return bytes;
+}
+
+ExynosBandwidthInfo ExynosBandwidthModel::getM2mBandwidth(const std::vector<exynos_image> &srcs,
+                                                          const exynos_image &dst, uint32_t vsyncPeriod) {
+    ExynosBandwidthInfo info;
+    uint32_t fps = getFrameRate(vsyncPeriod);
+    uint64_t readBytes = getM2mFrameBytes(srcs);
+
+    if (fps == 0)
+        return info;
+
+    info.avgRead = readBytes * fps;
+    info.peakRead = readBytes * getM2mQosFrameRate(vsyncPeriod);
+    info.avgWrite = getFrameBytes(dst, false) * fps;
+
+    return info;
+}
+
+int ExynosBandwidthModel::getM2mQosFrameRate(uint32_t vsyncPeriod) {
+    if (vsyncPeriod == 0)
+        return 0;
+    return (int)roundf((float)BW_NSEC_PER_SEC / (vsyncPeriod * BW_M2M_BUDGET_RATIO));
+}
+
+void ExynosDisplayBandwidth::dump(String8 &result) const {
+    result.appendFormat("\tDPU read bandwidth avg(%" PRIu64 " MB/s), peak(%" PRIu64 " MB/s), max peak(%" PRIu64 " MB/s)\n",
+                        BW_TO_MB(dpuAvgRead), BW_TO_MB(dpuPeakRead), BW_TO_MB(dpuPeakReadMax));
+    for (auto &ch : channels) {
+        result.appendFormat("\t\tch[%d] lines[%d, %d) avg(%" PRIu64 " MB/s), peak(%" PRIu64 " MB/s)\n",
+                            ch.chId, ch.top, ch.bottom,
+                            BW_TO_MB(ch.bw.avgRead), BW_TO_MB(ch.bw.peakRead));
+    }
+    for (auto &job : m2mJobs) {
+        result.appendFormat("\t\tm2m[%d, %d] bytes/frame(%" PRIu64 "), read avg(%" PRIu64 " MB/s), "
+                            "read peak(%" PRIu64 " MB/s), write avg(%" PRIu64 " MB/s)\n",
+                            job.physicalType, job.physicalIndex, job.bytesPerFrame,
+                            BW_TO_MB(job.bw.avgRead), BW_TO_MB(job.bw.peakRead),
+                            BW_TO_MB(job.bw.avgWrite));
+    }
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2012 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _EXYNOSBANDWIDTHMODEL_H
+#define _EXYNOSBANDWIDTHMODEL_H
+
+#include <utils/String8.h>
+#include <vector>
+#include "ExynosHWCHelper.h"
+
+using namespace android;
+
+/*
+ * Average ratio of compressed to uncompressed size.
+ * Used only for the estimation, the real ratio depends on the contents.
+ */
+#define BW_COMP_RATIO_AFBC 0.5f
+#define BW_COMP_RATIO_SBWC 0.5f
+#define BW_COMP_RATIO_SAJC 0.6f
+
+/*
+ * Linear buffers are fetched column-wise by a rotating DPP,
+ * so some of every burst is wasted. Block based formats are not affected.
+ */
+#define BW_ROT_LINEAR_FACTOR 1.25f
+
+/*
+ * M2M job should be finished before the DPU latches the next frame.
+ * The rest of the vsync period is left for fence signaling and DPU setup.
+ */
+#define BW_M2M_BUDGET_RATIO 0.8f
+
+#define BW_NSEC_PER_SEC 1000000000ULL
+
+struct ExynosBandwidthInfo {
+    /* bytes per second */
+    uint64_t avgRead = 0;
+    uint64_t peakRead = 0;
+    uint64_t avgWrite = 0;
+    void reset() { *this = {}; };
+    void add(const ExynosBandwidthInfo &other) {
+        avgRead += other.avgRead;
+        peakRead += other.peakRead;
+        avgWrite += other.avgWrite;
+    };
+};
+
+/* Bandwidth of one DPP channel and the scanlines where it fetches data */
+struct ExynosChannelBandwidth {
+    int32_t chId = -1;
+    uint32_t top = 0;
+    uint32_t bottom = 0;
+    ExynosBandwidthInfo bw;
+};
+
+/* Bandwidth of one M2M job */
+struct ExynosM2mBandwidth {
+    uint32_t physicalType = 0;
+    uint32_t physicalIndex = 0;
+    uint64_t bytesPerFrame = 0;
+    ExynosBandwidthInfo bw;
+};
+
+struct ExynosDisplayBandwidth {
+    std::vector<ExynosChannelBandwidth> channels;
+    std::vector<ExynosM2mBandwidth> m2mJobs;
+    /* Sum of DPP read bandwidth on the busiest scanline */
+    uint64_t dpuPeakRead = 0;
+    uint64_t dpuAvgRead = 0;
+    /* Max of dpuPeakRead since the display was connected */
+    uint64_t dpuPeakReadMax = 0;
+    void reset() {
+        channels.clear();
+        m2mJobs.clear();
+        dpuPeakRead = 0;
+        dpuAvgRead = 0;
+    };
+    void dump(String8 &result) const;
+};
+
+class ExynosBandwidthModel {
+  public:
+    static float getCompressionRatio(const exynos_image &img);
+    static float getRotationFactor(const exynos_image &img);
+    static uint64_t getFrameBytes(const exynos_image &img, bool applyRotation);
+    static uint32_t getFrameRate(uint32_t vsyncPeriod);
+
+    /*
+     * DPP fetches the source only while the destination scanlines are
+     * scanned out, so the peak is the frame bytes over the active lines.
+     */
+    static ExynosBandwidthInfo getOtfBandwidth(const exynos_image &src,
+                                               const exynos_image &dst,
+                                               uint32_t displayYres, uint32_t vsyncPeriod);
+    /* Sum of channel peaks on the scanline where the most channels overlap */
+    static uint64_t getOverlapPeakBandwidth(const std::vector<ExynosChannelBandwidth> &channels);
+
+    static uint64_t getM2mFrameBytes(const std::vector<exynos_image> &srcs);
+    static ExynosBandwidthInfo getM2mBandwidth(const std::vector<exynos_image> &srcs,
+                                               const exynos_image &dst, uint32_t vsyncPeriod);
+    /*
+     * Frame rate that makes (frame bytes * frame rate) equal to the M2M peak,
+     * which is the frame bytes over BW_M2M_BUDGET_RATIO of the vsync period.
+     * e.g. 60Hz display -> 75fps.
+     */
+    static int getM2mQosFrameRate(uint32_t vsyncPeriod);
+};
+
+#endif  //_EXYNOSBANDWIDTHMODEL_H
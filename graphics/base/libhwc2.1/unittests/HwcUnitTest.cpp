@@ -21,8 +21,12 @@
 #include "ExynosHWCHelper.h"
 #include "ExynosResourceManagerModule.h"
 #include "ExynosPrimaryDisplayModule.h"
+#include "ExynosExternalDisplay.h"
 #include "ExynosMPPModule.h"
 #include "ExynosMPP.h"
+#include "ExynosBandwidthModel.h"
+#include "ExynosDamageRegion.h"
+#include "vsyncpredictor.h"
 
 #include <drm/drm_mode.h>
 #include <drm_fourcc.h>
@@ -36,6 +40,9 @@
 #include "ExynosHWCService.h"
 
 #include <sys/types.h>
+#include <atomic>
+#include <thread>
+#include <unistd.h>
 #include <drm_fourcc.h>
 #include <xf86drm.h>
 #include <drm.h>
@@ -554,3 +561,486 @@ TEST_F(HwcUnitTest, ExynosDisplay_cpp) {
 
     delete tmp;
 }
+
+TEST_F(HwcUnitTest, ExynosBandwidthModel_OtfBandwidth) {
+    exynos_image src, dst;
+    src.exynosFormat = HAL_PIXEL_FORMAT_RGBA_8888;
+    src.w = 1080;
+    src.h = 960;
+    dst.y = 0;
+    dst.w = 1080;
+    dst.h = 960;
+
+    /* 60Hz, half of the panel */
+    ExynosBandwidthInfo bw = ExynosBandwidthModel::getOtfBandwidth(src, dst, 1920, 16666666);
+    EXPECT_EQ(bw.avgRead, (uint64_t)1080 * 960 * 4 * 60);
+    EXPECT_EQ(bw.peakRead, bw.avgRead * 2);
+
+    src.compressionInfo.type = COMP_TYPE_AFBC;
+    ExynosBandwidthInfo afbc = ExynosBandwidthModel::getOtfBandwidth(src, dst, 1920, 16666666);
+    EXPECT_LT(afbc.avgRead, bw.avgRead);
+
+    src.layerFlags = EXYNOS_HWC_DIM_LAYER;
+    EXPECT_EQ(ExynosBandwidthModel::getOtfBandwidth(src, dst, 1920, 16666666).avgRead, (uint64_t)0);
+}
+
+TEST_F(HwcUnitTest, ExynosBandwidthModel_OverlapPeak) {
+    std::vector<ExynosChannelBandwidth> channels(3);
+    channels[0].top = 0;
+    channels[0].bottom = 100;
+    channels[0].bw.peakRead = 10;
+    channels[1].top = 100;
+    channels[1].bottom = 200;
+    channels[1].bw.peakRead = 20;
+    channels[2].top = 50;
+    channels[2].bottom = 150;
+    channels[2].bw.peakRead = 5;
+
+    /* ch0 and ch1 do not overlap, ch2 overlaps with both */
+    EXPECT_EQ(ExynosBandwidthModel::getOverlapPeakBandwidth(channels), (uint64_t)25);
+
+    channels[2].bottom = 50;
+    EXPECT_EQ(ExynosBandwidthModel::getOverlapPeakBandwidth(channels), (uint64_t)20);
+}
+
+TEST_F(HwcUnitTest, ExynosBandwidthModel_M2mBandwidth) {
+    std::vector<exynos_image> srcs(1);
+    exynos_image dst;
+    srcs[0].exynosFormat = HAL_PIXEL_FORMAT_RGBA_8888;
+    srcs[0].w = 100;
+    srcs[0].h = 100;
+    dst.exynosFormat = HAL_PIXEL_FORMAT_RGBA_8888;
+    dst.w = 100;
+    dst.h = 100;
+
+    uint64_t bytes = ExynosBandwidthModel::getM2mFrameBytes(srcs);
+    EXPECT_EQ(bytes, (uint64_t)100 * 100 * 4);
+
+    /* Rotation of linear buffer costs more than that of block based buffer */
+    srcs[0].transform = HAL_TRANSFORM_ROT_90;
+    EXPECT_GT(ExynosBandwidthModel::getM2mFrameBytes(srcs), bytes);
+
+    int fps = ExynosBandwidthModel::getM2mQosFrameRate(16666666);
+    EXPECT_GE(fps, 60);
+    ExynosBandwidthInfo bw = ExynosBandwidthModel::getM2mBandwidth(srcs, dst, 16666666);
+    EXPECT_EQ(bw.peakRead, ExynosBandwidthModel::getM2mFrameBytes(srcs) * fps);
+    EXPECT_LE(bw.avgRead, bw.peakRead);
+}
+
+class BandwidthResourceManager : public ExynosResourceManagerModule {
+  public:
+    using ExynosResourceManager::mDisplayBandwidth;
+};
+
+TEST_F(HwcUnitTest, ExynosResourceManager_BandwidthDump) {
+    BandwidthResourceManager *resourceManager = new BandwidthResourceManager();
+    resourceManager->mDisplayBandwidth[0].dpuPeakReadMax = 100;
+    resourceManager->mDisplayBandwidth[1].dpuPeakReadMax = 200;
+
+    /* dump does not change the state */
+    String8 first, second;
+    resourceManager->dump(first);
+    resourceManager->dump(second);
+    EXPECT_EQ(std::string(first.c_str()), std::string(second.c_str()));
+    EXPECT_EQ(resourceManager->mDisplayBandwidth[0].dpuPeakReadMax, (uint64_t)100);
+
+    resourceManager->removeBandwidthEstimation(1);
+    EXPECT_EQ(resourceManager->mDisplayBandwidth.count(1), (size_t)0);
+    EXPECT_EQ(resourceManager->mDisplayBandwidth.size(), (size_t)1);
+    delete resourceManager;
+}
+
+TEST_F(HwcUnitTest, ExynosFenceTracer_ConcurrentDisplays) {
+    ExynosFenceTracer &fenceTracer = ExynosFenceTracer::getInstance();
+    constexpr uint32_t kDisplayNum = 3;
+    constexpr uint32_t kFrameNum = 500;
+    int pipeFds[2];
+    ASSERT_EQ(pipe(pipeFds), 0);
+
+    /* Each display dups and closes its present fence as in concurrent commits */
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < kDisplayNum; i++) {
+        threads.emplace_back([&fenceTracer, &pipeFds, i]() {
+            DisplayIdentifier display;
+            display.id = i;
+            for (uint32_t frame = 0; frame < kFrameNum; frame++) {
+                int fence = fenceTracer.hwc_dup(pipeFds[0], display,
+                                                FENCE_TYPE_PRESENT, FENCE_IP_DPP);
+                fenceTracer.fence_close(fence, display, FENCE_TYPE_PRESENT, FENCE_IP_DPP);
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    for (uint32_t i = 0; i < kDisplayNum; i++) {
+        DisplayIdentifier display;
+        display.id = i;
+        EXPECT_TRUE(fenceTracer.validateFencePerFrame(display));
+    }
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+}
+
+/* Counts the calls that change the display while its frame is committed */
+class CommitCheckInterface : public ExynosDisplayInterface {
+  public:
+    CommitCheckInterface() { mType = INTERFACE_TYPE_DRM; };
+    int32_t deliverWinConfigData(exynos_dpu_data &__unused dpuData) override {
+        mInCommit = true;
+        usleep(20);
+        mInCommit = false;
+        mCommitCount++;
+        return NO_ERROR;
+    };
+    int32_t clearDisplay() override {
+        checkRace();
+        return NO_ERROR;
+    };
+    int32_t setPowerMode(int32_t __unused mode) override {
+        checkRace();
+        return HWC2_ERROR_NONE;
+    };
+    void onDisplayRemoved() override { checkRace(); };
+    void checkRace() {
+        if (mInCommit)
+            mRaceCount++;
+    };
+
+    std::atomic<bool> mInCommit{false};
+    std::atomic<uint32_t> mRaceCount{0};
+    std::atomic<uint32_t> mCommitCount{0};
+};
+
+class CommitStressDisplay : public ExynosDisplay {
+  public:
+    CommitStressDisplay(DisplayIdentifier node) : ExynosDisplay(node) {
+        mDisplayInterface = std::make_unique<CommitCheckInterface>();
+    };
+    CommitCheckInterface *getCheckInterface() {
+        return static_cast<CommitCheckInterface *>(mDisplayInterface.get());
+    };
+    /* The commit part of presentDisplay() */
+    int commitFrame(DevicePresentInfo &presentInfo) {
+        Mutex::Autolock lock(mDisplayMutex);
+        return deliverWinConfigData(presentInfo);
+    };
+};
+
+TEST_F(HwcUnitTest, ExynosDisplay_CommitStress) {
+    constexpr uint32_t kDisplayNum = 2;
+    constexpr uint32_t kFrameNum = 2000;
+    constexpr uint32_t kEventNum = 500;
+    Mutex deviceMutex;
+    std::vector<CommitStressDisplay *> displays;
+
+    for (uint32_t i = 0; i < kDisplayNum; i++) {
+        DisplayIdentifier node = {getDisplayId(HWC_DISPLAY_EXTERNAL, i), HWC_DISPLAY_EXTERNAL, i,
+                                  String8("StressDisplay"), String8("fake_decon_fb")};
+        displays.push_back(new CommitStressDisplay(node));
+    }
+
+    std::vector<std::thread> threads;
+    /* presentDisplay() of each display, the device lock is released during the commit */
+    for (auto display : displays) {
+        threads.emplace_back([&deviceMutex, display]() {
+            for (uint32_t frame = 0; frame < kFrameNum; frame++) {
+                Mutex::Autolock lock(deviceMutex);
+                DevicePresentInfo presentInfo;
+                presentInfo.releaseDeviceLock = [&]() { deviceMutex.unlock(); };
+                presentInfo.acquireDeviceLock = [&]() { deviceMutex.lock(); };
+                EXPECT_EQ(display->commitFrame(presentInfo), NO_ERROR);
+            }
+        });
+    }
+    /* ExynosDevice::handleHotplug() */
+    threads.emplace_back([&]() {
+        for (uint32_t i = 0; i < kEventNum; i++) {
+            Mutex::Autolock lock(deviceMutex);
+            displays[i % kDisplayNum]->handleHotplugEvent((i & 0x2) != 0);
+        }
+    });
+    /* ExynosDevice::setPowerMode() */
+    threads.emplace_back([&]() {
+        uint64_t geometryFlag = 0;
+        for (uint32_t i = 0; i < kEventNum; i++) {
+            Mutex::Autolock lock(deviceMutex);
+            ExynosDisplay *display = displays[i % kDisplayNum];
+            display->waitForCommit();
+            display->setPowerMode((i & 0x2) ? HWC2_POWER_MODE_ON : HWC2_POWER_MODE_OFF,
+                                  geometryFlag);
+        }
+    });
+    /* ExynosDevice::validateAllDisplays() */
+    threads.emplace_back([&]() {
+        for (uint32_t i = 0; i < kEventNum; i++) {
+            Mutex::Autolock lock(deviceMutex);
+            for (auto display : displays)
+                display->waitForCommit();
+            for (auto display : displays)
+                display->getCheckInterface()->checkRace();
+        }
+    });
+    for (auto &thread : threads)
+        thread.join();
+
+    for (auto display : displays) {
+        EXPECT_EQ(display->getCheckInterface()->mRaceCount, (uint32_t)0);
+        EXPECT_EQ(display->getCheckInterface()->mCommitCount, kFrameNum);
+        delete display;
+    }
+}
+
+class CommitStressExternalDisplay : public ExynosExternalDisplay {
+  public:
+    CommitStressExternalDisplay(DisplayIdentifier node) : ExynosExternalDisplay(node) {
+        mDisplayInterface = std::make_unique<CommitCheckInterface>();
+    };
+    CommitCheckInterface *getCheckInterface() {
+        return static_cast<CommitCheckInterface *>(mDisplayInterface.get());
+    };
+    /* The commit part of presentDisplay(), false if the frame is skipped */
+    bool commitFrame(DevicePresentInfo &presentInfo) {
+        int32_t presentFence = -1;
+        if (skipPresent(&presentFence))
+            return false;
+        Mutex::Autolock lock(mDisplayMutex);
+        EXPECT_EQ(deliverWinConfigData(presentInfo), NO_ERROR);
+        return true;
+    };
+};
+
+/* Primary and DP, the DP is validated and plugged in and out during its commit */
+TEST_F(HwcUnitTest, ExynosExternalDisplay_CommitStress) {
+    constexpr uint32_t kFrameNum = 2000;
+    constexpr uint32_t kEventNum = 500;
+    Mutex deviceMutex;
+    DisplayIdentifier primaryNode = {getDisplayId(HWC_DISPLAY_PRIMARY, 0), HWC_DISPLAY_PRIMARY, 0,
+                                     String8("StressPrimary"), String8("fake_decon_fb")};
+    DisplayIdentifier externalNode = {getDisplayId(HWC_DISPLAY_EXTERNAL, 0), HWC_DISPLAY_EXTERNAL, 0,
+                                      String8("StressExternal"), String8("fake_decon_fb")};
+    CommitStressDisplay *primary = new CommitStressDisplay(primaryNode);
+    CommitStressExternalDisplay *external = new CommitStressExternalDisplay(externalNode);
+    std::atomic<uint32_t> externalFrameNum{0};
+
+    std::vector<std::thread> threads;
+    /* presentDisplay() of each display, the device lock is released during the commit */
+    threads.emplace_back([&]() {
+        for (uint32_t frame = 0; frame < kFrameNum; frame++) {
+            Mutex::Autolock lock(deviceMutex);
+            DevicePresentInfo presentInfo;
+            presentInfo.releaseDeviceLock = [&]() { deviceMutex.unlock(); };
+            presentInfo.acquireDeviceLock = [&]() { deviceMutex.lock(); };
+            EXPECT_EQ(primary->commitFrame(presentInfo), NO_ERROR);
+        }
+    });
+    threads.emplace_back([&]() {
+        for (uint32_t frame = 0; frame < kFrameNum; frame++) {
+            Mutex::Autolock lock(deviceMutex);
+            DevicePresentInfo presentInfo;
+            presentInfo.releaseDeviceLock = [&]() { deviceMutex.unlock(); };
+            presentInfo.acquireDeviceLock = [&]() { deviceMutex.lock(); };
+            if (external->commitFrame(presentInfo))
+                externalFrameNum++;
+        }
+    });
+    /* ExynosDevice::handleHotplug() */
+    threads.emplace_back([&]() {
+        for (uint32_t i = 0; i < kEventNum; i++) {
+            Mutex::Autolock lock(deviceMutex);
+            external->handleHotplugEvent((i & 0x1) == 0);
+        }
+    });
+    /* ExynosDevice::validateAllDisplays() */
+    threads.emplace_back([&]() {
+        DeviceValidateInfo validateInfo;
+        uint64_t geometryFlag = 0;
+        for (uint32_t i = 0; i < kEventNum * 4; i++) {
+            Mutex::Autolock lock(deviceMutex);
+            primary->waitForCommit();
+            external->waitForCommit();
+            primary->getCheckInterface()->checkRace();
+            external->getCheckInterface()->checkRace();
+            external->preProcessValidate(validateInfo, geometryFlag);
+            external->postProcessValidate();
+        }
+    });
+    for (auto &thread : threads)
+        thread.join();
+
+    EXPECT_EQ(primary->getCheckInterface()->mRaceCount, (uint32_t)0);
+    EXPECT_EQ(primary->getCheckInterface()->mCommitCount, kFrameNum);
+    EXPECT_EQ(external->getCheckInterface()->mRaceCount, (uint32_t)0);
+    EXPECT_EQ(external->getCheckInterface()->mCommitCount, externalFrameNum.load());
+    delete primary;
+    delete external;
+}
+
+TEST_F(HwcUnitTest, ExynosDamageRegion_Disjoint) {
+    ExynosDamageRegion region;
+    ExynosDamageCost cost;
+    cost.maxRegions = 4;
+    region.init(1080, 2400, cost);
+
+    /* Overlapping rects are merged on add, separate ones are kept */
+    region.add({0, 0, 100, 100});
+    region.add({50, 50, 200, 200});
+    region.add({900, 2300, 1000, 2400});
+    ASSERT_EQ(region.getRects().size(), (size_t)2);
+    for (size_t i = 0; i < region.getRects().size(); i++) {
+        for (size_t j = i + 1; j < region.getRects().size(); j++)
+            EXPECT_FALSE(ExynosDamageRegion::isIntersected(region.getRects()[i],
+                                                           region.getRects()[j]));
+    }
+
+    /* Far apart rects are cheaper to send separately */
+    EXPECT_FALSE(region.plan());
+    EXPECT_EQ(region.getRects().size(), (size_t)2);
+    EXPECT_EQ(region.getPixels(), (uint64_t)(200 * 200 + 100 * 100));
+}
+
+TEST_F(HwcUnitTest, ExynosDamageRegion_CostModel) {
+    ExynosDamageRegion region;
+    ExynosDamageCost cost;
+    cost.xAlign = 8;
+    cost.yAlign = 8;
+    region.init(1080, 2400, cost);
+
+    /* Rects are aligned to the panel restriction */
+    region.add({3, 3, 10, 10});
+    hwc_rect bounds = region.getBounds();
+    EXPECT_EQ(bounds.left, 0);
+    EXPECT_EQ(bounds.top, 0);
+    EXPECT_EQ(bounds.right, 16);
+    EXPECT_EQ(bounds.bottom, 16);
+
+    /* Only one region fits in the DPU */
+    region.add({100, 100, 200, 200});
+    EXPECT_FALSE(region.plan());
+    ASSERT_EQ(region.getRects().size(), (size_t)1);
+    EXPECT_EQ(region.getRects()[0].right, 200);
+
+    /* Bounding box close to the full frame is not worth a partial update */
+    region.init(1080, 2400, cost);
+    region.add({0, 0, 100, 100});
+    region.add({1000, 2380, 1080, 2400});
+    EXPECT_TRUE(region.plan());
+
+    /* Nothing damaged */
+    region.init(1080, 2400, cost);
+    EXPECT_TRUE(region.plan());
+}
+
+class MultiRegionInterface : public ExynosDisplayInterface {
+  public:
+    uint32_t getMaxWinUpdateRegions() override { return 2; };
+};
+
+TEST_F(HwcUnitTest, ExynosDisplay_WindowUpdateRegions) {
+    uint32_t id = getDisplayId(HWC_DISPLAY_PRIMARY, 0);
+    DisplayIdentifier node = {id, HWC_DISPLAY_PRIMARY, 0,
+                              String8("PrimaryDisplay"),
+                              String8("fake_decon_fb")};
+    ExynosDisplay *display = new ExynosDisplay(node);
+    display->mDisplayInterface = std::make_unique<MultiRegionInterface>();
+    display->mXres = 1080;
+    display->mYres = 2400;
+
+    ExynosDamageCost cost;
+    cost.xAlign = WIN_UPDATE_X_ALIGN;
+    cost.yAlign = WIN_UPDATE_Y_ALIGN;
+    cost.maxRegions = display->mDisplayInterface->getMaxWinUpdateRegions();
+
+    /* Two separate damage rects stay separate */
+    display->mDamageRegion.init(display->mXres, display->mYres, cost);
+    display->mDamageRegion.add({0, 0, 100, 100});
+    display->mDamageRegion.add({900, 2300, 1000, 2400});
+    ASSERT_EQ(display->setWindowUpdate(display->mDamageRegion), NO_ERROR);
+    ASSERT_EQ(display->mDpuData.win_update_region_cnt, (uint32_t)2);
+    for (uint32_t i = 0; i < 2; i++) {
+        decon_frame &r = display->mDpuData.win_update_regions[i];
+        EXPECT_EQ((uint64_t)r.w * r.h, (uint64_t)100 * 100);
+    }
+    decon_frame &r0 = display->mDpuData.win_update_regions[0];
+    decon_frame &r1 = display->mDpuData.win_update_regions[1];
+    EXPECT_FALSE(ExynosDamageRegion::isIntersected(
+            {(int)r0.x, (int)r0.y, (int)(r0.x + r0.w), (int)(r0.y + r0.h)},
+            {(int)r1.x, (int)r1.y, (int)(r1.x + r1.w), (int)(r1.y + r1.h)}));
+    /* win_update_region has their bounds */
+    EXPECT_EQ(display->mDpuData.win_update_region.w, (uint32_t)1000);
+    EXPECT_EQ(display->mDpuData.win_update_region.h, (uint32_t)2400);
+
+    /* A single region interface gets the bounds only */
+    display->mDisplayInterface = std::make_unique<ExynosDisplayInterface>();
+    cost.maxRegions = display->mDisplayInterface->getMaxWinUpdateRegions();
+    display->mDamageRegion.init(display->mXres, display->mYres, cost);
+    display->mDamageRegion.add({0, 0, 100, 100});
+    display->mDamageRegion.add({0, 200, 100, 300});
+    ASSERT_EQ(display->setWindowUpdate(display->mDamageRegion), NO_ERROR);
+    EXPECT_EQ(display->mDpuData.win_update_region_cnt, (uint32_t)0);
+    EXPECT_EQ(display->mDpuData.win_update_region.h, (uint32_t)300);
+
+    delete display;
+}
+
+TEST_F(HwcUnitTest, VSyncPredictor_JitterAndMissedEvents) {
+    VSyncPredictor predictor;
+    const int64_t period = 16600000;
+    const int64_t base = 1000000000;
+    predictor.SetIdealPeriod(16666666);
+    EXPECT_EQ(predictor.NextVSyncAfter(base), -1);
+
+    for (int64_t i = 0; i < 40; i++) {
+        /* Every 5th event is missed */
+        if (i % 5 == 4)
+            continue;
+        int64_t jitter = (i % 2) ? 100000 : -100000;
+        predictor.AddTimestamp(base + period * i + jitter);
+    }
+    /* Late event is rejected and does not move the model */
+    EXPECT_FALSE(predictor.AddTimestamp(base + period * 40 + period / 2));
+
+    EXPECT_NEAR(predictor.GetPeriod(), period, 50000);
+    int64_t next = predictor.NextVSyncAfter(base + period * 50 + 1000);
+    EXPECT_NEAR(next, base + period * 51, 500000);
+
+    VSyncPredictor::Metrics metrics = predictor.GetMetrics();
+    EXPECT_EQ(metrics.rejected, (uint64_t)1);
+    EXPECT_LT(metrics.mean_abs_error_ns, 500000);
+}
+
+TEST_F(HwcUnitTest, VSyncPredictor_ModeChange) {
+    VSyncPredictor predictor;
+    predictor.SetIdealPeriod(16666666);
+    for (int64_t i = 0; i < 10; i++)
+        predictor.AddTimestamp(1000000000 + 16666666 * i);
+
+    /* History of the previous mode is dropped */
+    predictor.SetIdealPeriod(8333333);
+    EXPECT_EQ(predictor.NextVSyncAfter(2000000000), -1);
+    EXPECT_EQ(predictor.GetMetrics().resets, (uint64_t)1);
+
+    predictor.AddTimestamp(2000000000);
+    EXPECT_EQ(predictor.NextVSyncAfter(2000000000), 2000000000 + 8333333);
+}
+
+TEST_F(HwcUnitTest, VSyncPredictor_ModelTimestamp) {
+    VSyncPredictor predictor;
+    predictor.SetIdealPeriod(16666666);
+
+    /* The prediction from the mode period is not a model */
+    predictor.AddTimestamp(1000000000);
+    EXPECT_NE(predictor.NextVSyncAfter(1000000000), -1);
+    EXPECT_EQ(predictor.GetModelTimestamp(), -1);
+
+    for (int64_t i = 1; i < 10; i++)
+        predictor.AddTimestamp(1000000000 + 16666666 * i);
+    EXPECT_EQ(predictor.GetModelTimestamp(), 1000000000 + 16666666 * 9);
+
+    /* Rejected timestamp is not the newest sample */
+    EXPECT_FALSE(predictor.AddTimestamp(1000000000 + 16666666 * 9 + 8000000));
+    EXPECT_EQ(predictor.GetModelTimestamp(), 1000000000 + 16666666 * 9);
+
+    predictor.Reset();
+    EXPECT_EQ(predictor.GetModelTimestamp(), -1);
+}
@@ -78,6 +78,7 @@ void ExynosFenceTracer::writeFenceInfo(uint32_t fd, hwc_fence_info_t *info,
 void ExynosFenceTracer::changeFenceInfoState(uint32_t fd, const DisplayIdentifier &display,
                                              hwc_fdebug_fence_type type, hwc_fdebug_ip_type ip,
                                              uint32_t direction, bool pendingAllowed) {
+    std::lock_guard<std::recursive_mutex> lock(mFenceMutex);
     if (!fence_valid(fd))
         return;
 
@@ -97,6 +98,7 @@ void ExynosFenceTracer::changeFenceInfoState(uint32_t fd, const DisplayIdentifie
 void ExynosFenceTracer::setFenceInfo(uint32_t fd, const DisplayIdentifier &display,
                                      hwc_fdebug_fence_type type, hwc_fdebug_ip_type ip,
                                      uint32_t direction, bool pendingAllowed) {
+    std::lock_guard<std::recursive_mutex> lock(mFenceMutex);
     if (!fence_valid(fd))
         return;
 
@@ -141,6 +143,7 @@ void ExynosFenceTracer::setFenceInfo(uint32_t fd, const DisplayIdentifier &displ
 }
 
 void ExynosFenceTracer::printLastFenceInfo(uint32_t fd) {
+    std::lock_guard<std::recursive_mutex> lock(mFenceMutex);
     struct timeval tv;
     if (!fence_valid(fd))
         return;
@@ -169,6 +172,7 @@ void ExynosFenceTracer::printLastFenceInfo(uint32_t fd) {
 }
 
 void ExynosFenceTracer::dumpFenceInfo(int32_t depth) {
+    std::lock_guard<std::recursive_mutex> lock(mFenceMutex);
     FT_LOGD("Dump fence ++");
     for (auto it = mFenceInfo.begin(); it != mFenceInfo.end(); ++it) {
         uint32_t i = it->first;
@@ -183,6 +187,7 @@ void ExynosFenceTracer::dumpFenceInfo(int32_t depth) {
 }
 
 bool ExynosFenceTracer::fenceWarn(uint32_t threshold) {
+    std::lock_guard<std::recursive_mutex> lock(mFenceMutex);
     uint32_t cnt = 0, r_cnt = 0;
 
     for (auto it = mFenceInfo.begin(); it != mFenceInfo.end(); ++it) {
@@ -205,6 +210,7 @@ bool ExynosFenceTracer::fenceWarn(uint32_t threshold) {
 }
 
 void ExynosFenceTracer::resetFenceCurFlag() {
+    std::lock_guard<std::recursive_mutex> lock(mFenceMutex);
     FT_LOGD("%s ++", __func__);
     for (auto it = mFenceInfo.begin(); it != mFenceInfo.end(); ++it) {
         uint32_t i = it->first;
@@ -224,6 +230,7 @@ void ExynosFenceTracer::resetFenceCurFlag() {
 }
 
 void ExynosFenceTracer::printFenceTrace(String8 &saveString, struct tm *localTime) {
+    std::lock_guard<std::recursive_mutex> lock(mFenceMutex);
     for (auto it = mFenceInfo.begin(); it != mFenceInfo.end(); ++it) {
         uint32_t i = it->first;
         if (mFenceInfo.count(i) == 0)
@@ -254,6 +261,7 @@ void ExynosFenceTracer::printFenceTrace(String8 &saveString, struct tm *localTim
 }
 
 void ExynosFenceTracer::printLeakFds() {
+    std::lock_guard<std::recursive_mutex> lock(mFenceMutex);
     int cnt = 1;
     String8 errStringPlus;
     String8 errStringMinus;
@@ -291,6 +299,7 @@ void ExynosFenceTracer::printLeakFds() {
 }
 
 bool ExynosFenceTracer::validateFencePerFrame(const DisplayIdentifier &display) {
+    std::lock_guard<std::recursive_mutex> lock(mFenceMutex);
     bool ret = true;
 
     for (auto it = mFenceInfo.begin(); it != mFenceInfo.end(); ++it) {
@@ -317,6 +326,7 @@ bool ExynosFenceTracer::validateFencePerFrame(const DisplayIdentifier &display)
 }
 
 void ExynosFenceTracer::dumpNCheckLeak(int32_t depth) {
+    std::lock_guard<std::recursive_mutex> lock(mFenceMutex);
     FT_LOGD("Dump leaking fence ++");
     for (auto it = mFenceInfo.begin(); it != mFenceInfo.end(); ++it) {
         uint32_t i = it->first;
@@ -20,6 +20,7 @@
 #include "ExynosHWCHelper.h"
 #include "ExynosHWCTypes.h"
 #include <vector>
+#include <mutex>
 #include <unordered_map>
 #include <utils/Singleton.h>
 
@@ -159,6 +160,11 @@ class ExynosFenceTracer : public Singleton<ExynosFenceTracer> {
     // Variable for fence tracer
     std::unordered_map<int32_t, hwc_fence_info> mFenceInfo;
     uint32_t mFenceLogSize = 0;
+    /*
+     * Displays can be committed concurrently so mFenceInfo has its own lock.
+     * It is the innermost lock, no other lock is taken while holding it.
+     */
+    std::recursive_mutex mFenceMutex;
 };
 
 #endif
@@ -17,6 +17,7 @@
 #define _EXYNOSHWCTypes_H
 
 #include <hardware/hwcomposer2.h>
+#include <functional>
 #include <vector>
 #include "ExynosMPPType.h"
 
@@ -296,6 +297,13 @@ struct DevicePresentInfo {
     uint32_t vsyncMode = DEFAULT_MODE;
     bool isBootFinished = true;
     std::vector<DisplayIdentifier> nonPrimaryDisplays;
+    /*
+     * Device lock is released while a display waits for its previous frame
+     * and commits the current frame so that other displays are not blocked.
+     * Refer to the lock ordering in ExynosDevice.h.
+     */
+    std::function<void()> releaseDeviceLock = nullptr;
+    std::function<void()> acquireDeviceLock = nullptr;
 };
 
 struct DisplayInfo {
@@ -22,6 +22,12 @@ endif
 ifdef BOARD_LIBHWJPEG_LEGACY
 LOCAL_CFLAGS += -DUSE_LEGACY_HWJPEG
 endif
+# Compresses by libjpeg-turbo instead of HWJPEG. The users should see the same
+# ExynosJpegEncoder class layout.
+ifdef BOARD_LIBHWJPEG_USES_SW_COMPRESSOR
+LOCAL_CFLAGS += -DUSE_SW_HWJPEG
+LOCAL_EXPORT_CFLAGS += -DUSE_SW_HWJPEG
+endif
 
 LOCAL_SHARED_LIBRARIES := liblog libutils libcutils libion_exynos libgiantmscl libacryl
 LOCAL_HEADER_LIBRARIES := libcutils_headers libsystem_headers libhardware_headers libexynos_headers
@@ -33,9 +39,16 @@ LOCAL_SRC_FILES := hwjpeg-base.cpp hwjpeg-v4l2.cpp ExynosJpegEncoder.cpp \
                    LibScalerForJpeg.cpp AppMarkerWriter.cpp ExynosJpegEncoderForCamera.cpp \
                    libhwjpeg-exynos.cpp ThumbnailScaler.cpp GiantThumbnailScaler.cpp G2dThumbnailScaler.cpp
 
+ifdef BOARD_LIBHWJPEG_USES_SW_COMPRESSOR
+LOCAL_SRC_FILES += hwjpeg-sw.cpp SWThumbnailScaler.cpp
+LOCAL_SHARED_LIBRARIES += libjpeg
+endif
+
 LOCAL_MODULE := libhwjpeg
 LOCAL_MODULE_TAGS := optional
 
 LOCAL_PROPRIETARY_MODULE := true
 
 include $(BUILD_SHARED_LIBRARY)
+
+include $(LOCAL_PATH)/test/Android.mk
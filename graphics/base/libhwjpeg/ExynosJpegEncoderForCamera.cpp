@@ -80,13 +80,18 @@ ExynosJpegEncoderForCamera::ExynosJpegEncoderForCamera(bool bBTBComp, unsigned i
           m_nThumbWidth(0), m_nThumbHeight(0), m_nThumbQuality(0),
           m_pStreamBase(NULL), m_fThumbBufferType(0)
 {
+    pthread_mutex_init(&m_mutexThumbJob, NULL);
+    pthread_cond_init(&m_condThumbJob, NULL);
+
     m_pAppWriter = new CAppMarkerWriter();
     if (!m_pAppWriter) {
         ALOGE("Failed to allocated an instance of CAppMarkerWriter");
         return;
     }
 
-#ifdef USE_LEGACY_HWJPEG
+#if defined(USE_SW_HWJPEG)
+    m_phwjpeg4thumb = new CHWJpegSWCompressor();
+#elif defined(USE_LEGACY_HWJPEG)
     m_phwjpeg4thumb = new CHWJpegV4L2Compressor(jpeg_node[HWJPEG_INDEX]);
 #else
     m_phwjpeg4thumb = new CHWJpegV4L2Compressor(jpeg_node[index]);
@@ -125,6 +130,20 @@ ExynosJpegEncoderForCamera::ExynosJpegEncoderForCamera(bool bBTBComp, unsigned i
 
 ExynosJpegEncoderForCamera::~ExynosJpegEncoderForCamera()
 {
+    if (m_threadWorker != 0) {
+        CancelThumbnailGeneration();
+
+        pthread_mutex_lock(&m_mutexThumbJob);
+        m_bWorkerExit = true;
+        pthread_cond_broadcast(&m_condThumbJob);
+        pthread_mutex_unlock(&m_mutexThumbJob);
+
+        pthread_join(m_threadWorker, NULL);
+    }
+
+    pthread_cond_destroy(&m_condThumbJob);
+    pthread_mutex_destroy(&m_mutexThumbJob);
+
     delete m_pAppWriter;
     delete m_phwjpeg4thumb;
 
@@ -226,12 +245,115 @@ size_t ExynosJpegEncoderForCamera::RemoveTrailingDummies(char *base, size_t len)
     return 0;
 }
 
-void *ExynosJpegEncoderForCamera::tCompressThumbnail(void *p)
+void *ExynosJpegEncoderForCamera::tThumbnailWorker(void *p)
 {
     ExynosJpegEncoderForCamera *encoder = reinterpret_cast<ExynosJpegEncoderForCamera *>(p);
 
-    size_t thumblen = encoder->CompressThumbnail();
-    return reinterpret_cast<void *>(thumblen);
+    encoder->RunThumbnailWorker();
+    return NULL;
+}
+
+void ExynosJpegEncoderForCamera::RunThumbnailWorker()
+{
+    pthread_mutex_lock(&m_mutexThumbJob);
+
+    while (true) {
+        while ((m_iThumbJobState != THUMB_JOB_QUEUED) && !m_bWorkerExit)
+            pthread_cond_wait(&m_condThumbJob, &m_mutexThumbJob);
+
+        if (m_iThumbJobState != THUMB_JOB_QUEUED)
+            break;
+
+        pthread_mutex_unlock(&m_mutexThumbJob);
+        size_t thumblen = CompressThumbnail();
+        pthread_mutex_lock(&m_mutexThumbJob);
+
+        m_szThumbJobResult = thumblen;
+        m_iThumbJobState = THUMB_JOB_DONE;
+        pthread_cond_broadcast(&m_condThumbJob);
+    }
+
+    pthread_mutex_unlock(&m_mutexThumbJob);
+}
+
+bool ExynosJpegEncoderForCamera::StartThumbnailGeneration()
+{
+    // The job of the previous encode() if WaitForCompression() is not called
+    CancelThumbnailGeneration();
+
+    if (m_threadWorker == 0) {
+        if (pthread_create(&m_threadWorker, NULL,
+                tThumbnailWorker, reinterpret_cast<void *>(this)) != 0) {
+            ALOGERR("Failed to create thumbnail generation thread");
+            m_threadWorker = 0;
+            return false;
+        }
+    }
+
+    getSize(&m_nThumbSrcWidth, &m_nThumbSrcHeight);
+    m_iThumbSrcFormat = getColorFormat();
+    m_iThumbSrcBufType = checkInBufType();
+
+    int ret;
+    if (m_iThumbSrcBufType == JPEG_BUF_TYPE_USER_PTR)
+        ret = getInBuf(m_pThumbSrcBuffer, m_szThumbSrcBuffer, 3);
+    else
+        ret = getInBuf(m_fdThumbSrcBuffer, m_szThumbSrcBuffer, 3);
+
+    ALOGE_IF(ret < 0, "Failed to retrieve the main image buffers");
+
+    // The failure is regarded as a failure of the thumbnail generation: no thumbnail is embedded.
+    bool okay = (ret == 0) && AllocThumbBuffer(m_iThumbSrcFormat);
+
+    pthread_mutex_lock(&m_mutexThumbJob);
+    m_bThumbJobCancel = false;
+    m_szThumbJobLimit = 0;
+    m_szThumbJobResult = 0;
+    m_iThumbJobState = okay ? THUMB_JOB_QUEUED : THUMB_JOB_DONE;
+    pthread_cond_broadcast(&m_condThumbJob);
+    pthread_mutex_unlock(&m_mutexThumbJob);
+
+    return true;
+}
+
+void ExynosJpegEncoderForCamera::SetThumbnailStreamLimit(size_t limit)
+{
+    pthread_mutex_lock(&m_mutexThumbJob);
+    m_szThumbJobLimit = limit;
+    pthread_cond_broadcast(&m_condThumbJob);
+    pthread_mutex_unlock(&m_mutexThumbJob);
+}
+
+size_t ExynosJpegEncoderForCamera::WaitForThumbnailGeneration()
+{
+    pthread_mutex_lock(&m_mutexThumbJob);
+
+    while (m_iThumbJobState == THUMB_JOB_QUEUED)
+        pthread_cond_wait(&m_condThumbJob, &m_mutexThumbJob);
+
+    size_t thumblen = (m_iThumbJobState == THUMB_JOB_DONE) ? m_szThumbJobResult : 0;
+    m_iThumbJobState = THUMB_JOB_IDLE;
+
+    pthread_mutex_unlock(&m_mutexThumbJob);
+
+    return thumblen;
+}
+
+void ExynosJpegEncoderForCamera::CancelThumbnailGeneration()
+{
+    pthread_mutex_lock(&m_mutexThumbJob);
+
+    if (m_iThumbJobState == THUMB_JOB_IDLE) {
+        pthread_mutex_unlock(&m_mutexThumbJob);
+        return;
+    }
+
+    m_bThumbJobCancel = true;
+    pthread_cond_broadcast(&m_condThumbJob);
+    pthread_mutex_unlock(&m_mutexThumbJob);
+
+    // The worker should not access the main image after encode() returns
+    WaitForThumbnailGeneration();
 }
 
 bool ExynosJpegEncoderForCamera::ProcessExif(char *base, size_t limit,
@@ -306,13 +428,9 @@ bool ExynosJpegEncoderForCamera::PrepareCompression(bool thumbnail)
     if (!thumbnail)
         return true;
 
-    if (IsThumbGenerationNeeded()) {
-        if (pthread_create(&m_threadWorker, NULL,
-                tCompressThumbnail, reinterpret_cast<void *>(this)) != 0) {
-            ALOGERR("Failed to create thumbnail generation thread");
-            return false;
-        }
-    } else {
+    // If IsThumbGenerationNeeded(), the worker has been generating the thumbnail
+    // since StartThumbnailGeneration() with the buffers allocated there.
+    if (!IsThumbGenerationNeeded()) {
         // allocate temporary thumbnail stream buffer
         // to prevent overflow of the compressed stream
         if (!AllocThumbJpegBuffer()) {
@@ -388,8 +506,38 @@ int ExynosJpegEncoderForCamera::encode(int *size, exif_attribute_t *exifInfo,
 
     CStopWatch stopwatch(true);
 
-    if (!ProcessExif(jpeg_base, m_nStreamSize, exifInfo, appInfo))
+    // Thumbnail is going to be embedded if ProcessExif() succeeds.
+    bool thumbreq = exifInfo && exifInfo->enableThumb && (m_nThumbWidth > 0) && (m_nThumbHeight > 0);
+
+    if (thumbreq) {
+        if (!IsThumbGenerationNeeded() && IsBTBCompressionSupported() &&
+                   (m_fThumbBufferType != checkInBufType())) {
+            ALOGE("Buffer types of thumbnail(%d) and main(%d) images should be the same",
+                    m_fThumbBufferType, checkInBufType());
+            return -1;
+        } else if (!IsThumbGenerationNeeded() && (m_fThumbBufferType == 0)) {
+            // Thumbnail buffer configuration failed but the client forces to compress with thumbnail
+            ThumbGenerationNeeded();
+            SetState(STATE_THUMBSIZE_CHANGED);
+        }
+
+        // The thumbnail image is generated while Exif and the main image are compressed
+        if (IsThumbGenerationNeeded() && !StartThumbnailGeneration()) {
+            ALOGE("Failed to prepare compression");
+            return -1;
+        }
+    }
+
+    if (!ProcessExif(jpeg_base, m_nStreamSize, exifInfo, appInfo)) {
+        CancelThumbnailGeneration();
         return -1;
+    }
+
+    bool thumbenc = m_pAppWriter->GetThumbStreamBase() != NULL;
+    if (thumbenc)
+        SetThumbnailStreamLimit(m_pAppWriter->GetMaxThumbnailSize());
+    else
+        CancelThumbnailGeneration();
 
     int offset = PTR_DIFF(m_pStreamBase, m_pAppWriter->GetMainStreamBase());
     int buffsize = static_cast<int>(m_nStreamSize - offset);
@@ -397,18 +545,19 @@ int ExynosJpegEncoderForCamera::encode(int *size, exif_attribute_t *exifInfo,
         if (setOutBuf(m_pAppWriter->GetMainStreamBase(), buffsize) < 0) {
             ALOGE("Failed to configure stream buffer : fd %d, addr %p, streamSize %d",
                     fdJpegBuffer, m_pAppWriter->GetMainStreamBase(), buffsize);
+            CancelThumbnailGeneration();
             return -1;
         }
     } else { // JPEG_BUF_TYPE_DMA_BUF
         if (setOutBuf(fdJpegBuffer, buffsize, offset) < 0) {
             ALOGE("Failed to configure stream buffer : fd %d, addr %p, streamSize %d",
                     fdJpegBuffer, m_pAppWriter->GetMainStreamBase(), buffsize);
+            CancelThumbnailGeneration();
             return -1;
         }
     }
 
     bool block_mode = !TestState(STATE_HWFC_ENABLED);
-    bool thumbenc = m_pAppWriter->GetThumbStreamBase() != NULL;
     size_t thumblen = 0;
 
     //        THUMB REQ? | THUMB IMG GIVEN? | B2B COMP? | HWFC(NONBLOCKING)?
@@ -427,38 +576,51 @@ int ExynosJpegEncoderForCamera::encode(int *size, exif_attribute_t *exifInfo,
     // CASE5 = thumbenc && !IsThumbGenerationNeeded() && !STATE_NO_BTBCOMP && IsBTBCompressionSupported() && block_mode
     // CASE6 = !thumbenc
     // CASE7 = thumbenc && !IsThumbGenerationNeeded() && STATE_NO_BTBCOMP && block_mode
+    //
+    // In CASE1 and CASE2, the worker thread generates and compresses the thumbnail
+    // since before ProcessExif(). In CASE3 and CASE7 in block mode, the given
+    // thumbnail image is compressed while HWJPEG compresses the main image.
 
     if (!thumbenc) {
         // Confirm that no thumbnail information is transferred to HWJPEG
         setThumbnailSize(0, 0);
-    } else if (!IsThumbGenerationNeeded() && IsBTBCompressionSupported() &&
-               (m_fThumbBufferType != checkInBufType())) {
-        ALOGE("Buffer types of thumbnail(%d) and main(%d) images should be the same",
-                m_fThumbBufferType, checkInBufType());
-        return -1;
-    } else if (!IsThumbGenerationNeeded() && (m_fThumbBufferType == 0)) {
-        // Thumbnail buffer configuration failed but the client forces to compress with thumbnail
-        ThumbGenerationNeeded();
-        SetState(STATE_THUMBSIZE_CHANGED);
     }
 
     if (!EnsureFormatIsApplied()) {
         ALOGE("Failed to confirm format");
+        CancelThumbnailGeneration();
         return -1;
     }
 
     if (!PrepareCompression(thumbenc)) {
         ALOGE("Failed to prepare compression");
+        CancelThumbnailGeneration();
         return -1;
     }
 
-    ssize_t mainlen = GetCompressor().Compress(&thumblen, block_mode);
+    bool thumb_overlap = thumbenc && !IsThumbGenerationNeeded() && block_mode &&
+                         (TestState(STATE_NO_BTBCOMP) || !IsBTBCompressionSupported());
+
+    ssize_t mainlen = GetCompressor().Compress(&thumblen, block_mode && !thumb_overlap);
     if (mainlen < 0) {
         ALOGE("Error occured while JPEG compression: %zd", mainlen);
+        CancelThumbnailGeneration();
         return -1;
     }
 
-    if (mainlen == 0) { /* non-blocking compression */
+    if (thumb_overlap) {
+        size_t len = CompressThumbnailOnly(m_pAppWriter->GetMaxThumbnailSize(), m_nThumbQuality,
+                                           getColorFormat(), checkInBufType());
+
+        mainlen = GetCompressor().WaitForCompression(&thumblen);
+        if (mainlen < 0) {
+            ALOGE("Error occured while JPEG compression: %zd", mainlen);
+            return -1;
+        }
+
+        thumblen = len;
+        SetState(STATE_THUMB_COMPRESSED);
+    } else if (mainlen == 0) { /* non-blocking compression */
         ALOGI("Waiting for MCSC run");
         return 0;
     }
@@ -482,7 +644,9 @@ ssize_t ExynosJpegEncoderForCamera::FinishCompression(size_t mainlen, size_t thu
     size_t max_streamsize = m_nStreamSize;
     char *mainbase = m_pAppWriter->GetMainStreamBase();
     char *thumbbase = m_pAppWriter->GetThumbStreamBase();
+    bool thumb_compressed = TestState(STATE_THUMB_COMPRESSED);
 
+    ClearState(STATE_THUMB_COMPRESSED);
     m_nStreamSize = 0;
 
     mainlen = RemoveTrailingDummies(mainbase, mainlen);
@@ -493,17 +657,11 @@ ssize_t ExynosJpegEncoderForCamera::FinishCompression(size_t mainlen, size_t thu
 
     if (thumbbase) {
         if (IsThumbGenerationNeeded()) {
-            void *len;
-            int ret = pthread_join(m_threadWorker, &len);
-            if (ret != 0) {
-                ALOGERR("Failed to wait thumbnail thread(%d)", ret);
-                return -1;
-            }
-
-            if (len == NULL)
+            thumblen = WaitForThumbnailGeneration();
+            if (thumblen == 0)
                 ALOGE("Error occurred during thumbnail creation: no thumbnail is embedded");
-
-            thumblen = reinterpret_cast<size_t>(len);
+        } else if (thumb_compressed) {
+            // compressed by encode() during the main image compression
         } else if (TestState(STATE_NO_BTBCOMP) || !IsBTBCompressionSupported()) {
             thumblen = CompressThumbnailOnly(m_pAppWriter->GetMaxThumbnailSize(), m_nThumbQuality, getColorFormat(), checkInBufType());
         } else {
@@ -583,18 +741,12 @@ ssize_t ExynosJpegEncoderForCamera::WaitForCompression()
     return FinishCompression(streamlen, thumblen);
 }
 
+// The main image configuration is given by StartThumbnailGeneration()
 bool ExynosJpegEncoderForCamera::GenerateThumbnailImage()
 {
-    int main_width, main_height;
-    if (getSize(&main_width, &main_height) < 0) {
-        ALOGE("Failed to get main image size");
-        return false;
-    }
-
-    int v4l2Format = getColorFormat();
-
-    if (!AllocThumbBuffer(v4l2Format))
-        return false;
+    int main_width = m_nThumbSrcWidth;
+    int main_height = m_nThumbSrcHeight;
+    int v4l2Format = m_iThumbSrcFormat;
 
     ALOGI("Generating thumbnail image: %dx%d -> %dx%d",
           main_width, main_height, m_nThumbWidth, m_nThumbHeight);
@@ -617,26 +769,12 @@ bool ExynosJpegEncoderForCamera::GenerateThumbnailImage()
 
     bool okay = false;
 
-    if (checkInBufType() == JPEG_BUF_TYPE_USER_PTR) {
-        char *bufs[ThumbnailScaler::SCALER_MAX_PLANES];
-        int len_srcbufs[ThumbnailScaler::SCALER_MAX_PLANES];
-
-        if (getInBuf(bufs, len_srcbufs, ThumbnailScaler::SCALER_MAX_PLANES) < 0) {
-            ALOGE("Failed to retrieve the main image buffers");
-            return false;
-        }
-
-        okay = mThumbnailScaler->RunStream(bufs, len_srcbufs, m_fdIONThumbImgBuffer, m_szIONThumbImgBuffer);
-    } else { // mainbuftype == JPEG_BUF_TYPE_DMA_BUF
-        int bufs[ThumbnailScaler::SCALER_MAX_PLANES];
-        int len_srcbufs[ThumbnailScaler::SCALER_MAX_PLANES];
-
-        if (getInBuf(bufs, len_srcbufs, ThumbnailScaler::SCALER_MAX_PLANES) < 0) {
-            ALOGE("Failed to retrieve the main image buffers");
-            return false;
-        }
-        okay = mThumbnailScaler->RunStream(bufs, len_srcbufs, m_fdIONThumbImgBuffer, m_szIONThumbImgBuffer);
-    }
+    if (m_iThumbSrcBufType == JPEG_BUF_TYPE_USER_PTR)
+        okay = mThumbnailScaler->RunStream(m_pThumbSrcBuffer, m_szThumbSrcBuffer,
+                                           m_fdIONThumbImgBuffer, m_szIONThumbImgBuffer);
+    else // mainbuftype == JPEG_BUF_TYPE_DMA_BUF
+        okay = mThumbnailScaler->RunStream(m_fdThumbSrcBuffer, m_szThumbSrcBuffer,
+                                           m_fdIONThumbImgBuffer, m_szIONThumbImgBuffer);
 
     if (!okay) {
         ALOGE("Failed to convert the main image to thumbnail with the thumbnail scaler");
@@ -646,25 +784,29 @@ bool ExynosJpegEncoderForCamera::GenerateThumbnailImage()
     return true;
 }
 
+// Runs on the worker thread
 size_t ExynosJpegEncoderForCamera::CompressThumbnail()
 {
-    unsigned int v4l2Format = getColorFormat();
-    int buftype = checkInBufType();
+    if (!GenerateThumbnailImage())
+        return 0;
 
-    if (IsThumbGenerationNeeded()) {
-        if (!GenerateThumbnailImage())
-            return 0;
+    // libcsc output configured by this class is always NV21.
+    unsigned int v4l2Format = GetThumbnailFormat(m_iThumbSrcFormat);
 
-        // libcsc output configured by this class is always NV21.
-        v4l2Format = GetThumbnailFormat(getColorFormat());
+    // reduced setInBuf2()
+    m_fdThumbnailImageBuffer[0] = m_fdIONThumbImgBuffer;
+    m_szThumbnailImageLen[0] = m_szIONThumbImgBuffer;
 
-        buftype = JPEG_BUF_TYPE_DMA_BUF;
-        // reduced setInBuf2()
-        m_fdThumbnailImageBuffer[0] = m_fdIONThumbImgBuffer;
-        m_szThumbnailImageLen[0] = m_szIONThumbImgBuffer;
-    }
+    pthread_mutex_lock(&m_mutexThumbJob);
+    while ((m_szThumbJobLimit == 0) && !m_bThumbJobCancel)
+        pthread_cond_wait(&m_condThumbJob, &m_mutexThumbJob);
+    size_t limit = m_bThumbJobCancel ? 0 : m_szThumbJobLimit;
+    pthread_mutex_unlock(&m_mutexThumbJob);
+
+    if (limit == 0)
+        return 0;
 
-    return CompressThumbnailOnly(m_pAppWriter->GetMaxThumbnailSize(), m_nThumbQuality, v4l2Format, buftype);
+    return CompressThumbnailOnly(limit, m_nThumbQuality, v4l2Format, JPEG_BUF_TYPE_DMA_BUF);
 }
 
 bool ExynosJpegEncoderForCamera::AllocThumbBuffer(int v4l2Format)
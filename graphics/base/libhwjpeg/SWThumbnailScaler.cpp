@@ -0,0 +1,105 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <linux/videodev2.h>
+
+#include <log/log.h>
+
+#include "SWThumbnailScaler.h"
+
+bool SWThumbnailScaler::SetSrcImage(unsigned int width, unsigned int height, unsigned int v4l2_format)
+{
+    return mSrcLayout.Configure(v4l2_format, width, height);
+}
+
+bool SWThumbnailScaler::SetDstImage(unsigned int width, unsigned int height, unsigned int v4l2_format)
+{
+    if (!mDstLayout.Configure(v4l2_format, width, height))
+        return false;
+
+    if (mDstLayout.GetNumPlanes() != 1) {
+        ALOGE("The thumbnail image should be in a single buffer (format %#x)", v4l2_format);
+        return false;
+    }
+
+    return true;
+}
+
+bool SWThumbnailScaler::RunStream(int srcBuf[SCALER_MAX_PLANES], int srcLen[SCALER_MAX_PLANES],
+                                  int dstBuf, size_t dstLen)
+{
+    size_t len[SCALER_MAX_PLANES];
+    CSWBufferMapper src;
+
+    for (unsigned int i = 0; i < mSrcLayout.GetNumPlanes(); i++)
+        len[i] = static_cast<size_t>(srcLen[i]);
+
+    if (!src.Map(srcBuf, len, mSrcLayout.GetNumPlanes(), false))
+        return false;
+
+    return Scale(src.GetAddrs(), dstBuf, dstLen);
+}
+
+bool SWThumbnailScaler::RunStream(char *srcBuf[SCALER_MAX_PLANES], int __unused srcLen[SCALER_MAX_PLANES],
+                                  int dstBuf, size_t dstLen)
+{
+    return Scale(srcBuf, dstBuf, dstLen);
+}
+
+bool SWThumbnailScaler::Scale(char *srcBuf[SCALER_MAX_PLANES], int dstBuf, size_t dstLen)
+{
+    if ((mSrcLayout.GetFormat() == 0) || (mDstLayout.GetFormat() == 0)) {
+        ALOGE("The source or the target image is not configured");
+        return false;
+    }
+
+    if (dstLen < mDstLayout.GetPlaneSize(0)) {
+        ALOGE("Too small thumbnail buffer %zu bytes (required %zu)", dstLen, mDstLayout.GetPlaneSize(0));
+        return false;
+    }
+
+    CSWBufferMapper dst;
+    if (!dst.Map(&dstBuf, &dstLen, 1, true))
+        return false;
+
+    for (unsigned int comp = 0; comp < 3; comp++) {
+        unsigned int sw = (comp == 0) ? mSrcLayout.GetWidth() : mSrcLayout.GetChromaWidth();
+        unsigned int sh = (comp == 0) ? mSrcLayout.GetHeight() : mSrcLayout.GetChromaHeight();
+        unsigned int dw = (comp == 0) ? mDstLayout.GetWidth() : mDstLayout.GetChromaWidth();
+        unsigned int dh = (comp == 0) ? mDstLayout.GetHeight() : mDstLayout.GetChromaHeight();
+        unsigned int sstep = mSrcLayout.GetStep(comp);
+        unsigned int dstep = mDstLayout.GetStep(comp);
+
+        for (unsigned int y = 0; y < dh; y++) {
+            // the rows at 1/4 and 3/4 of the source rows of the destination row
+            const unsigned char *row0 = mSrcLayout.GetRow(srcBuf, comp,
+                                            static_cast<unsigned int>((4ULL * y + 1) * sh / (4ULL * dh)));
+            const unsigned char *row1 = mSrcLayout.GetRow(srcBuf, comp,
+                                            static_cast<unsigned int>((4ULL * y + 3) * sh / (4ULL * dh)));
+            unsigned char *out = mDstLayout.GetRow(dst.GetAddrs(), comp, y);
+
+            for (unsigned int x = 0; x < dw; x++) {
+                unsigned int x0 = static_cast<unsigned int>((4ULL * x + 1) * sw / (4ULL * dw)) * sstep;
+                unsigned int x1 = static_cast<unsigned int>((4ULL * x + 3) * sw / (4ULL * dw)) * sstep;
+
+                out[x * dstep] = static_cast<unsigned char>(
+                        (row0[x0] + row0[x1] + row1[x0] + row1[x1] + 2) / 4);
+            }
+        }
+    }
+
+    return true;
+}
@@ -17,12 +17,20 @@
 #include <log/log.h>
 
 #include "ThumbnailScaler.h"
+#ifdef USE_SW_HWJPEG
+#include "SWThumbnailScaler.h"
+#else
 #include "LibScalerForJpeg.h"
 #include "GiantThumbnailScaler.h"
 #include "G2dThumbnailScaler.h"
+#endif
 
 ThumbnailScaler *ThumbnailScaler::createInstance()
 {
+#ifdef USE_SW_HWJPEG
+    ALOGI("Created thumbnail scaler: S/W Scaler");
+    return new SWThumbnailScaler();
+#else
 #ifdef USE_G2D_SCALER
     G2dThumbnailScaler *scaler = new G2dThumbnailScaler();
     if (scaler->available()) {
@@ -41,4 +49,5 @@ ThumbnailScaler *ThumbnailScaler::createInstance()
 
     ALOGI("Created thumbnail scaler: legacy V4L2 Scaler");
     return new LibScalerForJpeg();
+#endif
 }
@@ -27,13 +27,18 @@
 #include "hwjpeg-internal.h"
 
 CHWJpegBase::CHWJpegBase(const char *path)
-         : m_iFD(-1), m_uiDeviceCaps(0), m_uiAuxFlags(0)
+         : m_iFD(-1), m_bNoDevice(false), m_uiDeviceCaps(0), m_uiAuxFlags(0)
 {
     m_iFD = open(path, O_RDWR);
     if (m_iFD < 0)
         ALOGERR("Failed to open '%s'", path);
 }
 
+CHWJpegBase::CHWJpegBase()
+         : m_iFD(-1), m_bNoDevice(true), m_uiDeviceCaps(0), m_uiAuxFlags(0)
+{
+}
+
 CHWJpegBase::~CHWJpegBase()
 {
     if (m_iFD >= 0)
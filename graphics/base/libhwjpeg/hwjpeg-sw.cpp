@@ -0,0 +1,834 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <csetjmp>
+
+#include <sys/mman.h>
+
+#include <linux/videodev2.h>
+
+#include <jpeglib.h>
+#include <jerror.h>
+
+#include <exynos-hwjpeg.h>
+#include "hwjpeg-internal.h"
+#include "hwjpeg-sw.h"
+
+// The default quality factor until SetQuality() is called
+#define SW_JPEG_DEFAULT_QUALITY 90
+
+bool CSWImageLayout::Configure(unsigned int v4l2_fmt, unsigned int width, unsigned int height)
+{
+    if ((width == 0) || (height == 0)) {
+        ALOGE("Invalid image size %ux%u", width, height);
+        return false;
+    }
+
+    m_uiFormat = v4l2_fmt;
+    m_nWidth = width;
+    m_nHeight = height;
+
+    size_t ysize = width * height;
+    size_t cw = (width + 1) / 2;
+    bool crcb = false;
+
+    switch (v4l2_fmt) {
+        case V4L2_PIX_FMT_NV21:
+        case V4L2_PIX_FMT_NV21M:
+        case V4L2_PIX_FMT_NV61:
+            crcb = true;
+            [[clang::fallthrough]];
+        case V4L2_PIX_FMT_NV12:
+        case V4L2_PIX_FMT_NV12M:
+        case V4L2_PIX_FMT_NV16: {
+            bool multiplane = (v4l2_fmt == V4L2_PIX_FMT_NV12M) || (v4l2_fmt == V4L2_PIX_FMT_NV21M);
+            hshift = 1;
+            vshift = ((v4l2_fmt == V4L2_PIX_FMT_NV16) || (v4l2_fmt == V4L2_PIX_FMT_NV61)) ? 0 : 1;
+
+            size_t csize = cw * 2 * GetChromaHeight();
+            size_t coffset = multiplane ? 0 : ysize;
+
+            m_nPlaneOf[0] = 0;
+            m_nOffset[0] = 0;
+            m_nStride[0] = width;
+            m_nStep[0] = 1;
+            for (int i = 1; i < 3; i++) {
+                m_nPlaneOf[i] = multiplane ? 1 : 0;
+                m_nOffset[i] = coffset + (((i == 1) == crcb) ? 1 : 0);
+                m_nStride[i] = cw * 2;
+                m_nStep[i] = 2;
+            }
+
+            m_nPlanes = multiplane ? 2 : 1;
+            m_szPlane[0] = multiplane ? ysize : ysize + csize;
+            m_szPlane[1] = csize;
+            break;
+        }
+        case V4L2_PIX_FMT_YVU420:
+        case V4L2_PIX_FMT_YVU420M:
+            crcb = true;
+            [[clang::fallthrough]];
+        case V4L2_PIX_FMT_YUV420:
+        case V4L2_PIX_FMT_YUV420M:
+        case V4L2_PIX_FMT_YUV422P: {
+            bool multiplane = (v4l2_fmt == V4L2_PIX_FMT_YUV420M) || (v4l2_fmt == V4L2_PIX_FMT_YVU420M);
+            hshift = 1;
+            vshift = (v4l2_fmt == V4L2_PIX_FMT_YUV422P) ? 0 : 1;
+
+            size_t csize = cw * GetChromaHeight();
+
+            m_nPlaneOf[0] = 0;
+            m_nOffset[0] = 0;
+            m_nStride[0] = width;
+            m_nStep[0] = 1;
+            for (int i = 1; i < 3; i++) {
+                // the first chroma plane is Cr if crcb
+                unsigned int order = ((i == 1) != crcb) ? 0 : 1;
+                m_nPlaneOf[i] = multiplane ? 1 + order : 0;
+                m_nOffset[i] = multiplane ? 0 : ysize + csize * order;
+                m_nStride[i] = cw;
+                m_nStep[i] = 1;
+            }
+
+            m_nPlanes = multiplane ? 3 : 1;
+            m_szPlane[0] = multiplane ? ysize : ysize + csize * 2;
+            m_szPlane[1] = csize;
+            m_szPlane[2] = csize;
+            break;
+        }
+        case V4L2_PIX_FMT_YUYV:
+        case V4L2_PIX_FMT_YVYU:
+        case V4L2_PIX_FMT_UYVY:
+        case V4L2_PIX_FMT_VYUY: {
+            // offsets of Y, Cb and Cr in a 4-byte group of two pixels
+            static const unsigned int offsets[][3] = {
+                {0, 1, 3}, // YUYV
+                {0, 3, 1}, // YVYU
+                {1, 0, 2}, // UYVY
+                {1, 2, 0}, // VYUY
+            };
+            unsigned int idx = (v4l2_fmt == V4L2_PIX_FMT_YUYV) ? 0 :
+                               (v4l2_fmt == V4L2_PIX_FMT_YVYU) ? 1 :
+                               (v4l2_fmt == V4L2_PIX_FMT_UYVY) ? 2 : 3;
+            hshift = 1;
+            vshift = 0;
+
+            for (int i = 0; i < 3; i++) {
+                m_nPlaneOf[i] = 0;
+                m_nOffset[i] = offsets[idx][i];
+                m_nStride[i] = cw * 4;
+                m_nStep[i] = (i == 0) ? 2 : 4;
+            }
+
+            m_nPlanes = 1;
+            m_szPlane[0] = cw * 4 * height;
+            break;
+        }
+        default:
+            ALOGE("Unsupported image format %#x", v4l2_fmt);
+            m_uiFormat = 0;
+            return false;
+    }
+
+    return true;
+}
+
+bool CSWBufferMapper::Map(int fds[], size_t len[], unsigned int num_buffers, bool writable)
+{
+    Unmap();
+
+    for (unsigned int i = 0; i < num_buffers; i++) {
+        void *addr = mmap(NULL, len[i], PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, fds[i], 0);
+        if (addr == MAP_FAILED) {
+            ALOGERR("Failed to map buffer[%u] (fd %d, %zu bytes)", i, fds[i], len[i]);
+            Unmap();
+            return false;
+        }
+
+        m_pAddr[i] = reinterpret_cast<char *>(addr);
+        m_szMapped[i] = len[i];
+        m_nBuffers++;
+    }
+
+    return true;
+}
+
+bool CSWBufferMapper::Map(char *addrs[], unsigned int num_buffers)
+{
+    Unmap();
+
+    for (unsigned int i = 0; i < num_buffers; i++) {
+        m_pAddr[i] = addrs[i];
+        m_szMapped[i] = 0; // not to be unmapped
+    }
+    m_nBuffers = num_buffers;
+
+    return true;
+}
+
+void CSWBufferMapper::Unmap()
+{
+    for (unsigned int i = 0; i < m_nBuffers; i++) {
+        if (m_szMapped[i] > 0)
+            munmap(m_pAddr[i], m_szMapped[i]);
+    }
+
+    m_nBuffers = 0;
+}
+
+// Index of the natural order of the coefficient at the position in zig-zag order
+static const unsigned char zigzag_to_natural[64] = {
+     0,  1,  8, 16,  9,  2,  3, 10,
+    17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34,
+    27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36,
+    29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46,
+    53, 60, 61, 54, 47, 55, 62, 63,
+};
+
+struct sw_jpeg_error_mgr {
+    jpeg_error_mgr pub;
+    jmp_buf jmpbuf;
+};
+
+static void SWJpegErrorExit(j_common_ptr cinfo)
+{
+    char msg[JMSG_LENGTH_MAX];
+
+    (*cinfo->err->format_message)(cinfo, msg);
+    ALOGE("libjpeg: %s", msg);
+
+    longjmp(reinterpret_cast<sw_jpeg_error_mgr *>(cinfo->err)->jmpbuf, 1);
+}
+
+static void SWJpegOutputMessage(j_common_ptr cinfo)
+{
+    char msg[JMSG_LENGTH_MAX];
+
+    (*cinfo->err->format_message)(cinfo, msg);
+    ALOGW("libjpeg: %s", msg);
+}
+
+// The stream is written to the given buffer directly. It never grows.
+static void SWJpegInitDestination(j_compress_ptr __unused cinfo) { }
+
+static boolean SWJpegEmptyOutputBuffer(j_compress_ptr cinfo)
+{
+    ERREXIT(cinfo, JERR_BUFFER_SIZE);
+    return FALSE;
+}
+
+static void SWJpegTermDestination(j_compress_ptr __unused cinfo) { }
+
+/*
+ * Copies @num_rows rows of the component @comp from the row @first into @rows.
+ * A sample of the output covers @scale_x x @scale_y pixels of the image and it
+ * is taken from the nearest sample of the image. The rows are padded to
+ * @width by replicating the last sample as well as the rows below the image.
+ */
+static void FillRows(CSWImageLayout &layout, char *planes[], unsigned int comp,
+                     unsigned int scale_x, unsigned int scale_y,
+                     unsigned int first, unsigned int num_rows,
+                     unsigned int width, JSAMPROW rows[])
+{
+    unsigned int xshift = (comp == 0) ? 0 : layout.hshift;
+    unsigned int yshift = (comp == 0) ? 0 : layout.vshift;
+    unsigned int src_width = (comp == 0) ? layout.GetWidth() : layout.GetChromaWidth();
+    unsigned int src_height = (comp == 0) ? layout.GetHeight() : layout.GetChromaHeight();
+    unsigned int step = layout.GetStep(comp);
+
+    for (unsigned int r = 0; r < num_rows; r++) {
+        unsigned int y = min(((first + r) * scale_y) >> yshift, src_height - 1);
+        const unsigned char *src = layout.GetRow(planes, comp, y);
+        JSAMPLE *dst = rows[r];
+        unsigned int x = 0;
+
+        if ((step == 1) && (scale_x == (1U << xshift))) {
+            x = min(width, src_width);
+            memcpy(dst, src, x);
+        } else {
+            for (; x < width; x++) {
+                unsigned int sx = (x * scale_x) >> xshift;
+                if (sx >= src_width)
+                    break;
+                dst[x] = src[sx * step];
+            }
+        }
+
+        for (; x < width; x++)
+            dst[x] = dst[x - 1];
+    }
+}
+
+/*
+ * Compresses the image to @stream with the chroma subsampling of
+ * @hfactor x @vfactor. The samples are given to libjpeg in the raw form not to
+ * convert the color space. Zero @hfactor means the grayscale.
+ */
+static ssize_t CompressYUV(CSWImageLayout &layout, char *planes[],
+                           unsigned int hfactor, unsigned int vfactor,
+                           unsigned int quality, const unsigned char *qtable,
+                           char *stream, size_t len)
+{
+    bool gray = (hfactor == 0);
+    unsigned int hmax = gray ? 1 : hfactor;
+    unsigned int vmax = gray ? 1 : vfactor;
+    unsigned int band = DCTSIZE * vmax;
+    unsigned int ywidth = (layout.GetWidth() + DCTSIZE * hmax - 1) / (DCTSIZE * hmax) * (DCTSIZE * hmax);
+    unsigned int cwidth = ywidth / hmax;
+
+    // allocated before setjmp() not to be clobbered by longjmp()
+    JSAMPLE *buffer = reinterpret_cast<JSAMPLE *>(
+                        malloc(ywidth * band + (gray ? 0 : cwidth * DCTSIZE * 2)));
+    if (!buffer) {
+        ALOGE("Failed to allocate row buffers for %ux%u", ywidth, band);
+        return -1;
+    }
+
+    JSAMPROW yrows[DCTSIZE * 2];
+    JSAMPROW cbrows[DCTSIZE];
+    JSAMPROW crrows[DCTSIZE];
+    JSAMPARRAY data[3] = {yrows, cbrows, crrows};
+
+    for (unsigned int i = 0; i < band; i++)
+        yrows[i] = buffer + ywidth * i;
+    for (unsigned int i = 0; !gray && (i < DCTSIZE); i++) {
+        cbrows[i] = buffer + ywidth * band + cwidth * i;
+        crrows[i] = buffer + ywidth * band + cwidth * (DCTSIZE + i);
+    }
+
+    jpeg_compress_struct cinfo;
+    sw_jpeg_error_mgr jerr;
+    jpeg_destination_mgr dest;
+
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = SWJpegErrorExit;
+    jerr.pub.output_message = SWJpegOutputMessage;
+
+    if (setjmp(jerr.jmpbuf)) {
+        jpeg_destroy_compress(&cinfo);
+        free(buffer);
+        return -1;
+    }
+
+    jpeg_create_compress(&cinfo);
+
+    dest.init_destination = SWJpegInitDestination;
+    dest.empty_output_buffer = SWJpegEmptyOutputBuffer;
+    dest.term_destination = SWJpegTermDestination;
+    dest.next_output_byte = reinterpret_cast<JOCTET *>(stream);
+    dest.free_in_buffer = len;
+    cinfo.dest = &dest;
+
+    cinfo.image_width = layout.GetWidth();
+    cinfo.image_height = layout.GetHeight();
+    cinfo.input_components = gray ? 1 : 3;
+    cinfo.in_color_space = gray ? JCS_GRAYSCALE : JCS_YCbCr;
+
+    jpeg_set_defaults(&cinfo);
+
+    // HWJPEG writes no JFIF. APP segments are written by the users.
+    cinfo.write_JFIF_header = FALSE;
+    cinfo.raw_data_in = TRUE;
+    cinfo.comp_info[0].h_samp_factor = hmax;
+    cinfo.comp_info[0].v_samp_factor = vmax;
+    for (int i = 1; i < cinfo.num_components; i++) {
+        cinfo.comp_info[i].h_samp_factor = 1;
+        cinfo.comp_info[i].v_samp_factor = 1;
+    }
+
+    if (qtable) {
+        unsigned int table[DCTSIZE2];
+
+        for (int t = 0; t < 2; t++) {
+            for (int i = 0; i < DCTSIZE2; i++)
+                table[zigzag_to_natural[i]] = max(qtable[t * DCTSIZE2 + i], static_cast<unsigned char>(1));
+            jpeg_add_quant_table(&cinfo, t, table, 100, TRUE);
+        }
+    } else {
+        jpeg_set_quality(&cinfo, quality, TRUE);
+    }
+
+    jpeg_start_compress(&cinfo, TRUE);
+
+    while (cinfo.next_scanline < cinfo.image_height) {
+        unsigned int row = cinfo.next_scanline;
+
+        FillRows(layout, planes, 0, 1, 1, row, band, ywidth, yrows);
+        if (!gray) {
+            FillRows(layout, planes, 1, hmax, vmax, row / vmax, DCTSIZE, cwidth, cbrows);
+            FillRows(layout, planes, 2, hmax, vmax, row / vmax, DCTSIZE, cwidth, crrows);
+        }
+
+        jpeg_write_raw_data(&cinfo, data, band);
+    }
+
+    jpeg_finish_compress(&cinfo);
+
+    ssize_t written = static_cast<ssize_t>(len - dest.free_in_buffer);
+
+    jpeg_destroy_compress(&cinfo);
+    free(buffer);
+
+    return written;
+}
+
+CHWJpegSWCompressor::CHWJpegSWCompressor(const char __unused *path)
+        : CHWJpegCompressor(), m_uiV4L2Format(0), m_nWidth(0), m_nHeight(0),
+          m_uiHFactor(2), m_uiVFactor(2), m_uiQuality(SW_JPEG_DEFAULT_QUALITY),
+          m_bSrcDmabuf(false), m_nSrcBuffers(0),
+          m_bDstDmabuf(false), m_pDstBuffer(NULL), m_fdDstBuffer(-1), m_szDstBuffer(0), m_nDstOffset(0),
+          m_uiHWDelay(0), m_threadCompress(0), m_pPendingQTable(NULL), m_nPendingStreamSize(0)
+{
+    memset(m_qtable, 0, sizeof(m_qtable));
+    memset(m_pSrcBuffer, 0, sizeof(m_pSrcBuffer));
+    memset(m_szSrcBuffer, 0, sizeof(m_szSrcBuffer));
+
+    // The stream and the image can be anywhere because the CPU reads and writes them.
+    SetDeviceCapabilities(V4L2_CAP_EXYNOS_JPEG_NO_STREAMBASE_ALIGN |
+                          V4L2_CAP_EXYNOS_JPEG_NO_IMAGEBASE_ALIGN |
+                          V4L2_CAP_EXYNOS_JPEG_NO_BUFFER_OVERRUN |
+                          V4L2_CAP_EXYNOS_JPEG_DMABUF_OFFSET);
+
+    ALOGI("CHWJpegSWCompressor Created: %p", this);
+}
+
+CHWJpegSWCompressor::~CHWJpegSWCompressor()
+{
+    Release();
+
+    ALOGI("CHWJpegSWCompressor Destroyed: %p", this);
+}
+
+bool CHWJpegSWCompressor::SetChromaSampFactor(
+                    unsigned int horizontal, unsigned int vertical)
+{
+    switch ((horizontal << 4) | vertical) {
+        case 0x00:
+        case 0x11:
+        case 0x21:
+        case 0x22:
+        case 0x41:
+            break;
+        case 0x12:
+        default:
+           ALOGE("Unsupported chroma subsampling %ux%u", horizontal, vertical);
+           return false;
+    }
+
+    m_uiHFactor = horizontal;
+    m_uiVFactor = vertical;
+
+    return true;
+}
+
+bool CHWJpegSWCompressor::SetQuality(
+        unsigned int quality_factor, unsigned int quality_factor2)
+{
+    if (quality_factor > 100) {
+        ALOGE("Unsupported quality factor %u", quality_factor);
+        return false;
+    }
+
+    if (quality_factor2 > 100) {
+        ALOGE("Unsupported quality factor %u for the secondary image",
+                 quality_factor2);
+        return false;
+    }
+
+    if (quality_factor > 0) {
+        m_uiQuality = quality_factor;
+        ClearFlag(HWJPEG_FLAG_QTABLE);
+    }
+
+    return true;
+}
+
+bool CHWJpegSWCompressor::SetQuality(const unsigned char qtable[])
+{
+    memcpy(m_qtable, qtable, sizeof(m_qtable));
+    SetFlag(HWJPEG_FLAG_QTABLE);
+
+    return true;
+}
+
+bool CHWJpegSWCompressor::SetImageFormat(unsigned int v4l2_fmt,
+                                         unsigned int width, unsigned int height,
+                                         unsigned int width2, unsigned int height2)
+{
+    if ((width2 | height2) != 0) {
+        ALOGE("Back-to-back compression is not suppored by S/W");
+        return false;
+    }
+
+    CSWImageLayout layout;
+    if (!layout.Configure(v4l2_fmt, width, height))
+        return false;
+
+    if ((m_uiV4L2Format != v4l2_fmt) || (m_nWidth != width) || (m_nHeight != height)) {
+        m_uiV4L2Format = v4l2_fmt;
+        m_nWidth = width;
+        m_nHeight = height;
+
+        // the buffers are not large enough for the new format
+        ClearFlag(HWJPEG_FLAG_SRC_BUFFER);
+    }
+
+    return true;
+}
+
+bool CHWJpegSWCompressor::GetImageBufferSizes(size_t buf_sizes[], unsigned int *num_buffers)
+{
+    CSWImageLayout layout;
+    if (!layout.Configure(m_uiV4L2Format, m_nWidth, m_nHeight))
+        return false;
+
+    if (buf_sizes) {
+        for (unsigned int i = 0; i < layout.GetNumPlanes(); i++)
+            buf_sizes[i] = layout.GetPlaneSize(i);
+    }
+
+    if (num_buffers) {
+        if (*num_buffers < layout.GetNumPlanes()) {
+            ALOGE("The size array length %u is smaller than the number of required buffers %u",
+                    *num_buffers, layout.GetNumPlanes());
+            return false;
+        }
+
+        *num_buffers = layout.GetNumPlanes();
+    }
+
+    return true;
+}
+
+bool CHWJpegSWCompressor::SetImageBuffer(char *buffers[], size_t len_buffers[],
+                                         unsigned int num_buffers)
+{
+    size_t sizes[3];
+    unsigned int num_planes = 3;
+
+    if (!GetImageBufferSizes(sizes, &num_planes))
+        return false;
+
+    if (num_buffers < num_planes) {
+        ALOGE("The number of buffers %u is smaller than the required %u",
+                num_buffers, num_planes);
+        return false;
+    }
+
+    for (unsigned int i = 0; i < num_planes; i++) {
+        if (len_buffers[i] < sizes[i]) {
+            ALOGE("The size of the buffer[%u] %zu is smaller than required %zu",
+                    i, len_buffers[i], sizes[i]);
+            return false;
+        }
+        m_pSrcBuffer[i] = buffers[i];
+        m_szSrcBuffer[i] = len_buffers[i];
+    }
+
+    m_nSrcBuffers = num_planes;
+    m_bSrcDmabuf = false;
+
+    SetFlag(HWJPEG_FLAG_SRC_BUFFER);
+
+    return true;
+}
+
+bool CHWJpegSWCompressor::SetImageBuffer(int buffers[], size_t len_buffers[],
+                                         unsigned int num_buffers)
+{
+    size_t sizes[3];
+    unsigned int num_planes = 3;
+
+    if (!GetImageBufferSizes(sizes, &num_planes))
+        return false;
+
+    if (num_buffers < num_planes) {
+        ALOGE("The number of buffers %u is smaller than the required %u",
+                num_buffers, num_planes);
+        return false;
+    }
+
+    for (unsigned int i = 0; i < num_planes; i++) {
+        if (len_buffers[i] < sizes[i]) {
+            ALOGE("The size of the buffer[%u] %zu is smaller than required %zu",
+                    i, len_buffers[i], sizes[i]);
+            return false;
+        }
+        m_fdSrcBuffer[i] = buffers[i];
+        m_szSrcBuffer[i] = len_buffers[i];
+    }
+
+    m_nSrcBuffers = num_planes;
+    m_bSrcDmabuf = true;
+
+    SetFlag(HWJPEG_FLAG_SRC_BUFFER);
+
+    return true;
+}
+
+bool CHWJpegSWCompressor::SetImageBuffer2(char __unused *buffers[], size_t __unused len_buffers[],
+                                          unsigned int __unused num_buffers)
+{
+    ALOGE("Back-to-back compression is not suppored by S/W");
+    return false;
+}
+
+bool CHWJpegSWCompressor::SetImageBuffer2(int __unused buffers[], size_t __unused len_buffers[],
+                                          unsigned int __unused num_buffers)
+{
+    ALOGE("Back-to-back compression is not suppored by S/W");
+    return false;
+}
+
+bool CHWJpegSWCompressor::SetJpegBuffer(char *buffer, size_t len_buffer)
+{
+    m_pDstBuffer = buffer;
+    m_szDstBuffer = len_buffer;
+    m_nDstOffset = 0;
+    m_bDstDmabuf = false;
+    SetFlag(HWJPEG_FLAG_DST_BUFFER);
+    return true;
+}
+
+bool CHWJpegSWCompressor::SetJpegBuffer(int buffer, size_t len_buffer, int offset)
+{
+    m_fdDstBuffer = buffer;
+    m_szDstBuffer = len_buffer;
+    m_nDstOffset = offset;
+    m_bDstDmabuf = true;
+    SetFlag(HWJPEG_FLAG_DST_BUFFER);
+    return true;
+}
+
+bool CHWJpegSWCompressor::SetJpegBuffer2(char __unused *buffer, size_t __unused len_buffer)
+{
+    ALOGE("Back-to-back compression is not suppored by S/W");
+    return false;
+}
+
+bool CHWJpegSWCompressor::SetJpegBuffer2(int __unused buffer, size_t __unused len_buffer)
+{
+    ALOGE("Back-to-back compression is not suppored by S/W");
+    return false;
+}
+
+ssize_t CHWJpegSWCompressor::CompressImage(const unsigned char *qtable)
+{
+    CStopWatch stopwatch(true);
+    CSWImageLayout layout;
+
+    if (!layout.Configure(m_uiV4L2Format, m_nWidth, m_nHeight))
+        return -1;
+
+    CSWBufferMapper src;
+    if (m_bSrcDmabuf) {
+        if (!src.Map(m_fdSrcBuffer, m_szSrcBuffer, m_nSrcBuffers, false))
+            return -1;
+    } else {
+        src.Map(m_pSrcBuffer, m_nSrcBuffers);
+    }
+
+    CSWBufferMapper dst;
+    char *stream = m_pDstBuffer;
+    if (m_bDstDmabuf) {
+        // the offset of mmap() should be page aligned
+        size_t len = m_szDstBuffer + m_nDstOffset;
+        if (!dst.Map(&m_fdDstBuffer, &len, 1, true))
+            return -1;
+        stream = dst.GetAddrs()[0] + m_nDstOffset;
+    }
+
+    ssize_t len = CompressYUV(layout, src.GetAddrs(), m_uiHFactor, m_uiVFactor, m_uiQuality,
+                              qtable, stream, m_szDstBuffer);
+
+    m_uiHWDelay = static_cast<unsigned int>(stopwatch.GetElapsed());
+
+    if (len < 0) {
+        ALOGE("Failed to compress %ux%u image of format %#x to %zu bytes",
+              m_nWidth, m_nHeight, m_uiV4L2Format, m_szDstBuffer);
+        return -1;
+    }
+
+    SetStreamSize(len);
+
+    return len;
+}
+
+void *CHWJpegSWCompressor::tCompressImage(void *p)
+{
+    CHWJpegSWCompressor *compressor = reinterpret_cast<CHWJpegSWCompressor *>(p);
+
+    compressor->m_nPendingStreamSize = compressor->CompressImage(compressor->m_pPendingQTable);
+    return NULL;
+}
+
+ssize_t CHWJpegSWCompressor::Compress(size_t *secondary_stream_size, bool block_mode)
+{
+    if (TestFlag(HWJPEG_FLAG_PENDING)) {
+        ALOGE("The previous compression is not finished");
+        return -1;
+    }
+
+    if (!TestFlag(HWJPEG_FLAG_SRC_BUFFER)) {
+        ALOGE("Source image buffer is not specified");
+        return -1;
+    }
+
+    if (!TestFlag(HWJPEG_FLAG_DST_BUFFER)) {
+        ALOGE("Output JPEG stream buffer is not specified");
+        return -1;
+    }
+
+    if (secondary_stream_size)
+        *secondary_stream_size = 0;
+
+    const unsigned char *qtable = TestFlag(HWJPEG_FLAG_QTABLE) ? m_qtable : NULL;
+
+    if (block_mode)
+        return CompressImage(qtable);
+
+    // The flags are not touched by the compression thread
+    m_pPendingQTable = qtable;
+    SetFlag(HWJPEG_FLAG_PENDING);
+
+    if (pthread_create(&m_threadCompress, NULL, tCompressImage, reinterpret_cast<void *>(this)) != 0) {
+        ALOGERR("Failed to create compression thread");
+        ClearFlag(HWJPEG_FLAG_PENDING);
+        return -1;
+    }
+
+    return 0;
+}
+
+ssize_t CHWJpegSWCompressor::WaitForCompression(size_t *secondary_stream_size)
+{
+    if (!TestFlag(HWJPEG_FLAG_PENDING))
+        return GetStreamSize(secondary_stream_size);
+
+    int ret = pthread_join(m_threadCompress, NULL);
+    ClearFlag(HWJPEG_FLAG_PENDING);
+    if (ret != 0) {
+        ALOGE("Failed to wait for compression thread (%d)", ret);
+        return -1;
+    }
+
+    if (secondary_stream_size)
+        *secondary_stream_size = 0;
+
+    return m_nPendingStreamSize;
+}
+
+bool CHWJpegSWCompressor::GetImageBuffers(int buffers[], size_t len_buffers[],
+                                          unsigned int num_buffers)
+{
+    if (!m_bSrcDmabuf) {
+        ALOGE("Current image buffer type is not dma-buf but attempted to retrieve dma-buf buffers");
+        return false;
+    }
+
+    if (num_buffers < m_nSrcBuffers) {
+        ALOGE("Number of planes are %u but attemts to retrieve %u buffers",
+                m_nSrcBuffers, num_buffers);
+        return false;
+    }
+
+    for (unsigned int i = 0; i < m_nSrcBuffers; i++) {
+        buffers[i] = m_fdSrcBuffer[i];
+        len_buffers[i] = m_szSrcBuffer[i];
+    }
+
+    return true;
+}
+
+bool CHWJpegSWCompressor::GetImageBuffers(char *buffers[], size_t len_buffers[],
+                                          unsigned int num_buffers)
+{
+    if (m_bSrcDmabuf) {
+        ALOGE("Current image buffer type is not userptr but attempted to retrieve userptr buffers");
+        return false;
+    }
+
+    if (num_buffers < m_nSrcBuffers) {
+        ALOGE("Number of planes are %u but attemts to retrieve %u buffers",
+                m_nSrcBuffers, num_buffers);
+        return false;
+    }
+
+    for (unsigned int i = 0; i < m_nSrcBuffers; i++) {
+        buffers[i] = m_pSrcBuffer[i];
+        len_buffers[i] = m_szSrcBuffer[i];
+    }
+
+    return true;
+}
+
+bool CHWJpegSWCompressor::GetJpegBuffer(int *buffer, size_t *len_buffer)
+{
+    if (!m_bDstDmabuf) {
+        ALOGE("Current jpeg buffer type is not dma-buf but attempted to retrieve dma-buf buffer");
+        return false;
+    }
+
+    *buffer = m_fdDstBuffer;
+    *len_buffer = m_szDstBuffer;
+
+    return true;
+}
+
+bool CHWJpegSWCompressor::GetJpegBuffer(char **buffer, size_t *len_buffer)
+{
+    if (m_bDstDmabuf) {
+        ALOGE("Current jpeg buffer type is not userptr but attempted to retrieve userptr buffer");
+        return false;
+    }
+
+    *buffer = m_pDstBuffer;
+    *len_buffer = m_szDstBuffer;
+
+    return true;
+}
+
+void CHWJpegSWCompressor::Release()
+{
+    if (TestFlag(HWJPEG_FLAG_PENDING))
+        WaitForCompression();
+
+    ClearFlag(HWJPEG_FLAG_SRC_BUFFER | HWJPEG_FLAG_DST_BUFFER);
+}
+
+void CHWJpegSWCompressor::DumpInfo(bool thumb, bool __unused btb)
+{
+    const char *str = thumb ? "thumb" : "main";
+
+    ALOGI("srcbuf fmt(%u) %ux%u factor(%ux%u) quality(%u%s)", m_uiV4L2Format, m_nWidth, m_nHeight,
+            m_uiHFactor, m_uiVFactor, m_uiQuality, TestFlag(HWJPEG_FLAG_QTABLE) ? ", qtable" : "");
+
+    for (unsigned int i = 0; i < m_nSrcBuffers; i++) {
+        ALOGI("%s srcbuf[%u]: %s(%lu) len(%zu)", str, i, m_bSrcDmabuf ? "fd" : "userptr",
+                m_bSrcDmabuf ? (unsigned long)m_fdSrcBuffer[i] : PTR_TO_ULONG(m_pSrcBuffer[i]),
+                m_szSrcBuffer[i]);
+    }
+
+    ALOGI("%s dstbuf: %s(%lu) len(%zu) offset(%d)", str, m_bDstDmabuf ? "fd" : "userptr",
+            m_bDstDmabuf ? (unsigned long)m_fdDstBuffer : PTR_TO_ULONG(m_pDstBuffer),
+            m_szDstBuffer, m_nDstOffset);
+}
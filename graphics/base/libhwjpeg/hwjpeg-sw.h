@@ -0,0 +1,90 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __HWJPEG_SW_H__
+#define __HWJPEG_SW_H__
+
+#include <cstddef>
+
+/*
+ * CSWImageLayout - where the pixels of a YUV image are in the memory
+ *
+ * It describes the images handled by CHWJpegSWCompressor and SWThumbnailScaler
+ * that only have the CPU. A pixel of a component is at
+ * base + row * stride + column * step and the chroma planes have
+ * (1 << hshift) x (1 << vshift) times less pixels than the luma plane.
+ * Semi-planar, planar and packed YUV formats are described in the same way.
+ */
+class CSWImageLayout {
+    unsigned int m_uiFormat;
+    unsigned int m_nWidth;
+    unsigned int m_nHeight;
+    unsigned int m_nPlanes; // the number of buffers of the format
+    size_t m_szPlane[3];
+
+    // offset, row stride and column step of Y, Cb and Cr
+    size_t m_nOffset[3];
+    unsigned int m_nPlaneOf[3];
+    size_t m_nStride[3];
+    unsigned int m_nStep[3];
+public:
+    unsigned int hshift;
+    unsigned int vshift;
+
+    CSWImageLayout(): m_uiFormat(0), m_nWidth(0), m_nHeight(0), m_nPlanes(0), hshift(0), vshift(0) { }
+
+    // returns false if @v4l2_fmt is not supported
+    bool Configure(unsigned int v4l2_fmt, unsigned int width, unsigned int height);
+
+    unsigned int GetFormat() { return m_uiFormat; }
+    unsigned int GetWidth() { return m_nWidth; }
+    unsigned int GetHeight() { return m_nHeight; }
+    unsigned int GetChromaWidth() { return (m_nWidth + (1 << hshift) - 1) >> hshift; }
+    unsigned int GetChromaHeight() { return (m_nHeight + (1 << vshift) - 1) >> vshift; }
+    unsigned int GetNumPlanes() { return m_nPlanes; }
+    size_t GetPlaneSize(unsigned int plane) { return m_szPlane[plane]; }
+
+    // @comp: 0 for Y, 1 for Cb and 2 for Cr
+    unsigned char *GetRow(char *planes[], unsigned int comp, unsigned int row) {
+        return reinterpret_cast<unsigned char *>(planes[m_nPlaneOf[comp]]) +
+                m_nOffset[comp] + row * m_nStride[comp];
+    }
+    unsigned int GetStep(unsigned int comp) { return m_nStep[comp]; }
+};
+
+/*
+ * CSWBufferMapper - the CPU view of the buffers given by dma-buf or userptr
+ *
+ * The dma-buf buffers are mapped by Map() and unmapped by Unmap() or by the
+ * destructor. The userptr buffers are just referenced.
+ */
+class CSWBufferMapper {
+    char *m_pAddr[3];
+    size_t m_szMapped[3];
+    unsigned int m_nBuffers;
+public:
+    CSWBufferMapper(): m_nBuffers(0) { }
+    ~CSWBufferMapper() { Unmap(); }
+
+    bool Map(int fds[], size_t len[], unsigned int num_buffers, bool writable);
+    bool Map(char *addrs[], unsigned int num_buffers);
+    void Unmap();
+
+    char **GetAddrs() { return m_pAddr; }
+};
+
+#endif //__HWJPEG_SW_H__
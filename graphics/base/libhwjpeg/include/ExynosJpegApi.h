@@ -63,8 +63,14 @@ class ExynosJpegEncoder {
      * because it has a lot of virtual functions which require extra memory for
      * vtables. Moreover, ExynosJpegEncoder class implements no virtual function
      * of CHWJpegV4L2Compressor.
+     * CHWJpegSWCompressor takes the place of CHWJpegV4L2Compressor if
+     * USE_SW_HWJPEG is defined.
      */
+#ifdef USE_SW_HWJPEG
+    CHWJpegSWCompressor m_hwjpeg;
+#else
     CHWJpegV4L2Compressor m_hwjpeg;
+#endif
 
     char m_iInBufType;
     char m_iOutBufType;
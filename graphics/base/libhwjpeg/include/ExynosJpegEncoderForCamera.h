@@ -35,6 +35,13 @@ class ExynosJpegEncoderForCamera: public ExynosJpegEncoder {
         STATE_HWFC_ENABLED = STATE_BASE_MAX << 1,
         STATE_NO_CREATE_THUMBIMAGE = STATE_BASE_MAX << 2,
         STATE_NO_BTBCOMP = STATE_BASE_MAX << 3,
+        STATE_THUMB_COMPRESSED = STATE_BASE_MAX << 4,
+    };
+
+    enum {
+        THUMB_JOB_IDLE,
+        THUMB_JOB_QUEUED,   // the worker is generating or compressing the thumbnail
+        THUMB_JOB_DONE,     // m_szThumbJobResult is the stream length of the thumbnail
     };
 
     CHWJpegCompressor *m_phwjpeg4thumb;
@@ -70,7 +77,33 @@ class ExynosJpegEncoderForCamera: public ExynosJpegEncoder {
 
     CAppMarkerWriter *m_pAppWriter;
 
+    /*
+     * The thumbnail image is generated and compressed by a worker thread that
+     * lives as long as the encoder. The job is queued before Exif is written
+     * in order that the downscaling overlaps Exif and the main image compression.
+     * The worker waits for m_szThumbJobLimit to compress the thumbnail because
+     * the maximum stream length is known after APP1 segment is laid out.
+     * The main image configuration is copied for the worker not to race with
+     * the main image compression.
+     */
     pthread_t m_threadWorker = 0;
+    pthread_mutex_t m_mutexThumbJob;
+    pthread_cond_t m_condThumbJob;
+    int m_iThumbJobState = THUMB_JOB_IDLE;
+    bool m_bThumbJobCancel = false;
+    bool m_bWorkerExit = false;
+    size_t m_szThumbJobLimit = 0;
+    size_t m_szThumbJobResult = 0;
+
+    int m_nThumbSrcWidth = 0;
+    int m_nThumbSrcHeight = 0;
+    int m_iThumbSrcFormat = 0;
+    int m_iThumbSrcBufType = 0;
+    union {
+        char *m_pThumbSrcBuffer[3]; // m_iThumbSrcBufType == JPEG_BUF_TYPE_USER_PTR
+        int m_fdThumbSrcBuffer[3]; // m_iThumbSrcBufType == JPEG_BUF_TYPE_DMA_BUF
+    };
+    int m_szThumbSrcBuffer[3];
 
     extra_appinfo_t m_extraInfo;
     app_info_t m_appInfo[15];
@@ -83,12 +116,17 @@ class ExynosJpegEncoderForCamera: public ExynosJpegEncoder {
     size_t RemoveTrailingDummies(char *base, size_t len);
     ssize_t FinishCompression(size_t mainlen, size_t thumblen);
     bool ProcessExif(char *base, size_t limit, exif_attribute_t *exifInfo, extra_appinfo_t *extra);
-    static void *tCompressThumbnail(void *p);
+    static void *tThumbnailWorker(void *p);
+    void RunThumbnailWorker();
+    bool StartThumbnailGeneration();
+    void SetThumbnailStreamLimit(size_t limit);
+    size_t WaitForThumbnailGeneration();
+    void CancelThumbnailGeneration();
     bool PrepareCompression(bool thumbnail);
     void DumpInfo();
 
     // IsThumbGenerationNeeded - true if thumbnail image needed to be generated from the main image
-    //                           It also implies that a worker thread is generated to generate thumbnail concurrently.
+    //                           It also implies that the worker thread generates thumbnail concurrently.
     inline bool IsThumbGenerationNeeded() { return !TestState(STATE_NO_CREATE_THUMBIMAGE); }
     inline void NoThumbGenerationNeeded() { SetState(STATE_NO_CREATE_THUMBIMAGE); }
     inline void ThumbGenerationNeeded() { ClearState(STATE_NO_CREATE_THUMBIMAGE); }
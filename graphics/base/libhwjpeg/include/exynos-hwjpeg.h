@@ -19,6 +19,7 @@
 #define __EXYNOS_HWJPEG_H__
 
 #include <cstddef> // size_t
+#include <pthread.h>
 /*
  * exynos-hwjpeg.h does not include videodev2.h because Exynos HAL code may
  * define its version of videodev2.h that may differ from <linux/videodev2.h>
@@ -70,6 +71,7 @@
  */
 class CHWJpegBase {
     int m_iFD;
+    bool m_bNoDevice;
     unsigned int m_uiDeviceCaps;
     /*
      * Auxiliary option flags are implementation specific to derived classes
@@ -83,6 +85,8 @@ class CHWJpegBase {
     unsigned int m_uiAuxFlags;
 protected:
     CHWJpegBase(const char *path);
+    // For the implementations that do not need a device node
+    CHWJpegBase();
     virtual ~CHWJpegBase();
     int GetDeviceFD() { return m_iFD; }
     void SetDeviceCapabilities(unsigned int cap) { m_uiDeviceCaps = cap; }
@@ -99,7 +103,7 @@ public:
      * A user that creates this object *must* test if the object is successfully
      * created because some initialization in the constructor may fail.
      */
-    bool Okay() { return m_iFD >= 0; }
+    bool Okay() { return m_bNoDevice || (m_iFD >= 0); }
     operator bool() { return Okay(); }
 
     /*
@@ -157,6 +161,7 @@ protected:
     }
 public:
     CHWJpegCompressor(const char *path): CHWJpegBase(path), m_nLastStreamSize(0), m_nLastThumbStreamSize(0) { }
+    CHWJpegCompressor(): CHWJpegBase(), m_nLastStreamSize(0), m_nLastThumbStreamSize(0) { }
 
     /*
      * SetImageFormat - Configure uncompressed image format, width and height
@@ -591,6 +596,92 @@ public:
     virtual void DumpInfo(bool thumb, bool btb);
 };
 
+#ifdef USE_SW_HWJPEG
+/*
+ * CHWJpegSWCompressor - JPEG compression by libjpeg(-turbo) on the CPU
+ *
+ * It takes the place of CHWJpegV4L2Compressor on the targets without HWJPEG
+ * and on Linux hosts. The JPEG stream is the same as HWJPEG writes: SOI, DQT,
+ * SOF0, DHT, SOS and EOI without JFIF. Compress() in non-block mode compresses
+ * on a thread and WaitForCompression() waits for the thread to finish.
+ * Back-to-back compression and HWFC are not supported.
+ */
+class CHWJpegSWCompressor : public CHWJpegCompressor, private CHWJpegFlagManager {
+    enum  {
+        HWJPEG_FLAG_QTABLE      = 0x1, // Set if the quantization tables are given by SetQuality(qtable)
+        HWJPEG_FLAG_PENDING     = 0x2, // Set if the compression thread is not joined
+
+        HWJPEG_FLAG_SRC_BUFFER  = 0x10000, // Set if SetImageBuffer() is invoked successfully
+        HWJPEG_FLAG_DST_BUFFER  = 0x40000, // Set if SetJpegBuffer() is invoked successfully
+    };
+
+    unsigned int m_uiV4L2Format;
+    unsigned int m_nWidth;
+    unsigned int m_nHeight;
+    unsigned int m_uiHFactor;
+    unsigned int m_uiVFactor;
+    unsigned int m_uiQuality;
+    unsigned char m_qtable[128]; // luma and chroma tables in zig-zag scan order
+
+    // The source image buffers are either userptr or dmabuf
+    bool m_bSrcDmabuf;
+    union {
+        char *m_pSrcBuffer[3];
+        int m_fdSrcBuffer[3];
+    };
+    size_t m_szSrcBuffer[3];
+    unsigned int m_nSrcBuffers;
+
+    bool m_bDstDmabuf;
+    char *m_pDstBuffer;
+    int m_fdDstBuffer;
+    size_t m_szDstBuffer;
+    int m_nDstOffset;
+
+    // Time taken by the last compression in usec. instead of the H/W delay
+    unsigned int m_uiHWDelay;
+
+    pthread_t m_threadCompress;
+    const unsigned char *m_pPendingQTable;
+    ssize_t m_nPendingStreamSize;
+
+    ssize_t CompressImage(const unsigned char *qtable);
+    static void *tCompressImage(void *p);
+public:
+    // @path is ignored because no device node is used.
+    CHWJpegSWCompressor(const char *path = NULL);
+    virtual ~CHWJpegSWCompressor();
+
+    unsigned int GetHWDelay() { return m_uiHWDelay; }
+
+    virtual bool SetChromaSampFactor(unsigned int horizontal,
+                                     unsigned int vertical);
+    virtual bool SetQuality(unsigned int quality_factor,
+                            unsigned int quality_factor2 = 0);
+    virtual bool SetQuality(const unsigned char qtable[]);
+
+    virtual bool SetImageFormat(unsigned int v4l2_fmt, unsigned int width, unsigned int height,
+                              unsigned int sec_width = 0, unsigned sec_height = 0);
+    virtual bool GetImageBufferSizes(size_t buf_sizes[], unsigned int *num_bufffers);
+    virtual bool SetImageBuffer(char *buffers[], size_t len_buffers[], unsigned int num_buffers);
+    virtual bool SetImageBuffer(int buffers[], size_t len_buffers[], unsigned int num_buffers);
+    virtual bool SetImageBuffer2(char *buffers[], size_t len_buffers[], unsigned int num_buffers);
+    virtual bool SetImageBuffer2(int buffers[], size_t len_buffers[], unsigned int num_buffers);
+    virtual bool SetJpegBuffer(char *buffer, size_t len_buffer);
+    virtual bool SetJpegBuffer(int buffer, size_t len_buffer, int offset = 0);
+    virtual bool SetJpegBuffer2(char *buffer, size_t len_buffer);
+    virtual bool SetJpegBuffer2(int buffer, size_t len_buffer);
+    virtual ssize_t Compress(size_t *secondary_stream_size = NULL, bool bock_mode = true);
+    virtual bool GetImageBuffers(int buffers[], size_t len_buffers[], unsigned int num_buffers);
+    virtual bool GetImageBuffers(char *buffers[], size_t len_buffers[], unsigned int num_buffers);
+    virtual bool GetJpegBuffer(char **buffer, size_t *len_buffer);
+    virtual bool GetJpegBuffer(int *buffer, size_t *len_buffer);
+    virtual ssize_t WaitForCompression(size_t *secondary_stream_size = NULL);
+    virtual void Release();
+    virtual void DumpInfo(bool thumb, bool btb);
+};
+#endif
+
 class CHWJpegV4L2Decompressor : public CHWJpegDecompressor, private CHWJpegFlagManager {
     enum  {
         HWJPEG_FLAG_OUTPUT_READY  = 0x10, /* the output stream is ready */
@@ -0,0 +1,27 @@
+# Copyright (C) 2017 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+#### Shot to shot benchmark of libhwjpeg ####
+
+LOCAL_PATH:= $(call my-dir)
+
+include $(CLEAR_VARS)
+LOCAL_CFLAGS += -DLOG_TAG=\"hwjpeg-shot-benchmark\"
+LOCAL_SHARED_LIBRARIES := liblog libutils libcutils libion_exynos libhwjpeg libjpeg
+LOCAL_HEADER_LIBRARIES := libcutils_headers libsystem_headers libhardware_headers libexynos_headers
+LOCAL_SRC_FILES := hwjpeg_shot_benchmark.cpp
+LOCAL_MODULE_TAGS := optional
+LOCAL_MODULE := hwjpeg_shot_benchmark
+LOCAL_PROPRIETARY_MODULE := true
+include $(BUILD_EXECUTABLE)
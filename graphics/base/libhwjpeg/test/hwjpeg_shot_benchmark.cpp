@@ -0,0 +1,464 @@
+/*
+ * Copyright Samsung Electronics Co.,LTD.
+ * Copyright (C) 2017 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Shot to shot latency of ExynosJpegEncoderForCamera::encode(), with the thumbnail and the
+ * Exif, on synthetic YUV frames. Two frames are encoded in turn so that a stream left over
+ * from the previous shot does not pass the check.
+ *
+ * The streams of the first two shots and the last one are checked:
+ *  - SOI, APP1 with Exif, DQT, SOF0 of the image size, DHT, SOS and EOI in order
+ *  - the thumbnail in APP1 is a JPEG of the thumbnail size that libjpeg decodes
+ *  - the main image decodes, and its luma is close to the frame (PSNR over BENCH_MIN_PSNR)
+ *
+ * It runs on HWJPEG, or on libjpeg with BOARD_LIBHWJPEG_USES_SW_COMPRESSOR.
+ *
+ * usage: hwjpeg_shot_benchmark [shots] [case]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <linux/videodev2.h>
+
+#include <jpeglib.h>
+
+#include <hardware/exynos/ion.h>
+
+#include <ExynosJpegEncoderForCamera.h>
+
+#define BENCH_DEFAULT_SHOTS     20
+#define BENCH_THUMB_WIDTH       512
+#define BENCH_THUMB_HEIGHT      384
+#define BENCH_QUALITY           90
+#define BENCH_THUMB_QUALITY     80
+#define BENCH_MIN_PSNR          30.0
+#define BENCH_FRAMES            2
+
+struct benchCase {
+    const char *name;
+    unsigned int format;
+    bool givenThumb;    // the thumbnail image is given by setInBuf2()
+    bool userPtr;
+    int width;
+    int height;
+};
+
+static const benchCase benchCases[] = {
+    {"12mp-nv21",           V4L2_PIX_FMT_NV21, false, false, 4032, 3024},
+    {"12mp-nv21-thumb",     V4L2_PIX_FMT_NV21, true,  false, 4032, 3024},
+    {"fhd-nv12-userptr",    V4L2_PIX_FMT_NV12, false, true,  1920, 1080},
+    {"hd-yuyv",             V4L2_PIX_FMT_YUYV, false, false, 1280, 720},
+    {"odd-nv21",            V4L2_PIX_FMT_NV21, false, false, 1000, 750},
+};
+
+struct benchImage {
+    int fd;
+    char *addr;
+    size_t len;
+};
+
+static double getTimeUs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static bool allocImage(int ionClient, size_t len, benchImage *image)
+{
+    image->len = len;
+    image->fd = exynos_ion_alloc(ionClient, len, EXYNOS_ION_HEAP_SYSTEM_MASK, ION_FLAG_CACHED);
+    if (image->fd < 0)
+        return false;
+
+    image->addr = reinterpret_cast<char *>(mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, image->fd, 0));
+    if (image->addr == MAP_FAILED) {
+        close(image->fd);
+        return false;
+    }
+
+    return true;
+}
+
+static void freeImage(benchImage *image)
+{
+    munmap(image->addr, image->len);
+    close(image->fd);
+}
+
+static bool isPacked(unsigned int format)
+{
+    return format == V4L2_PIX_FMT_YUYV;
+}
+
+static size_t imageSize(unsigned int format, int width, int height)
+{
+    return isPacked(format) ? width * height * 2 : width * height * 3 / 2;
+}
+
+static unsigned char lumaAt(const unsigned char *image, unsigned int format, int width, int x, int y)
+{
+    return isPacked(format) ? image[(y * width + x) * 2] : image[y * width + x];
+}
+
+/* a gradient with some texture, compressed to about the size of a photo */
+static void fillImage(unsigned char *image, unsigned int format, int width, int height, int seed)
+{
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            unsigned char luma = (x * 255 / width + y * 128 / height + (x * 7 + y * 13 + seed) % 23) & 0xFF;
+            if (isPacked(format)) {
+                image[(y * width + x) * 2] = luma;
+                image[(y * width + x) * 2 + 1] = (x % 2) ? 150 - y * 50 / height : 100 + x * 50 / width;
+            } else {
+                image[y * width + x] = luma;
+            }
+        }
+    }
+
+    if (isPacked(format))
+        return;
+
+    unsigned char *chroma = image + width * height;
+    for (int y = 0; y < height / 2; y++) {
+        for (int x = 0; x < width / 2; x++) {
+            chroma[y * width + x * 2] = 100 + x * 100 / width;
+            chroma[y * width + x * 2 + 1] = 150 - y * 100 / height;
+        }
+    }
+}
+
+static int readBE16(const unsigned char *p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+/* the luma of the decoded stream, false if libjpeg does not decode it */
+static bool decodeLuma(const unsigned char *stream, size_t len, int *width, int *height,
+                       std::vector<unsigned char> *luma)
+{
+    jpeg_decompress_struct cinfo;
+    jpeg_error_mgr jerr;
+
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, const_cast<unsigned char *>(stream), len);
+
+    if (jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+
+    cinfo.out_color_space = JCS_YCbCr;
+    jpeg_start_decompress(&cinfo);
+
+    *width = cinfo.output_width;
+    *height = cinfo.output_height;
+    luma->resize(*width * *height);
+
+    std::vector<unsigned char> row(*width * 3);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW rowptr = row.data();
+        int y = cinfo.output_scanline;
+
+        jpeg_read_scanlines(&cinfo, &rowptr, 1);
+        for (int x = 0; x < *width; x++)
+            (*luma)[y * *width + x] = row[x * 3];
+    }
+
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+
+    return true;
+}
+
+/* the thumbnail is the JPEG stream from the first SOI to the last EOI in APP1 */
+static bool checkThumbnail(const unsigned char *app1, size_t len)
+{
+    const unsigned char *soi = NULL;
+    const unsigned char *eoi = NULL;
+    std::vector<unsigned char> luma;
+    int width, height;
+
+    for (size_t i = 0; i + 2 < len; i++) {
+        if (app1[i] == 0xFF && app1[i + 1] == 0xD8 && app1[i + 2] == 0xFF) {
+            soi = app1 + i;
+            break;
+        }
+    }
+
+    for (size_t i = len - 2; soi != NULL && app1 + i > soi; i--) {
+        if (app1[i] == 0xFF && app1[i + 1] == 0xD9) {
+            eoi = app1 + i + 2;
+            break;
+        }
+    }
+
+    if (soi == NULL || eoi == NULL) {
+        printf("  no thumbnail in APP1\n");
+        return false;
+    }
+
+    if (!decodeLuma(soi, eoi - soi, &width, &height, &luma)
+            || width != BENCH_THUMB_WIDTH || height != BENCH_THUMB_HEIGHT) {
+        printf("  thumbnail is not a %dx%d JPEG\n", BENCH_THUMB_WIDTH, BENCH_THUMB_HEIGHT);
+        return false;
+    }
+
+    return true;
+}
+
+static bool checkStream(const unsigned char *stream, size_t len, const benchCase &test,
+                        const unsigned char *image, double *psnr)
+{
+    enum { SEG_APP1 = 1 << 0, SEG_DQT = 1 << 1, SEG_SOF0 = 1 << 2, SEG_DHT = 1 << 3, SEG_SOS = 1 << 4 };
+    unsigned int segments = 0;
+    size_t offset = 2;
+
+    if (len < 4 || readBE16(stream) != 0xFFD8 || readBE16(stream + len - 2) != 0xFFD9) {
+        printf("  no SOI or EOI\n");
+        return false;
+    }
+
+    while (!(segments & SEG_SOS) && offset + 4 <= len) {
+        int marker = readBE16(stream + offset);
+        size_t seglen = readBE16(stream + offset + 2);
+
+        if ((marker & 0xFF00) != 0xFF00 || offset + 2 + seglen > len) {
+            printf("  broken segment at %zu\n", offset);
+            return false;
+        }
+
+        switch (marker) {
+        case 0xFFE1:
+            if (memcmp(stream + offset + 4, "Exif\0\0", 6) != 0) {
+                printf("  APP1 is not Exif\n");
+                return false;
+            }
+            if (!checkThumbnail(stream + offset + 4, seglen - 2))
+                return false;
+            segments |= SEG_APP1;
+            break;
+        case 0xFFDB:
+            segments |= SEG_DQT;
+            break;
+        case 0xFFC0:
+            if (readBE16(stream + offset + 5) != test.height || readBE16(stream + offset + 7) != test.width) {
+                printf("  SOF0 is not %dx%d\n", test.width, test.height);
+                return false;
+            }
+            segments |= SEG_SOF0;
+            break;
+        case 0xFFC4:
+            segments |= SEG_DHT;
+            break;
+        case 0xFFDA:
+            segments |= SEG_SOS;
+            break;
+        }
+
+        offset += 2 + seglen;
+    }
+
+    if (segments != (SEG_APP1 | SEG_DQT | SEG_SOF0 | SEG_DHT | SEG_SOS)) {
+        printf("  missing segments (found %#x)\n", segments);
+        return false;
+    }
+
+    std::vector<unsigned char> luma;
+    int width, height;
+    if (!decodeLuma(stream, len, &width, &height, &luma) || width != test.width || height != test.height) {
+        printf("  main image does not decode\n");
+        return false;
+    }
+
+    double sum = 0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            double diff = luma[y * width + x] - lumaAt(image, test.format, width, x, y);
+            sum += diff * diff;
+        }
+    }
+    *psnr = 10 * log10(255.0 * 255.0 / (sum / (width * height) + 1e-9));
+    if (*psnr < BENCH_MIN_PSNR) {
+        printf("  luma PSNR %.1f dB\n", *psnr);
+        return false;
+    }
+
+    return true;
+}
+
+static void setExif(exif_attribute_t *exif, int width, int height)
+{
+    memset(exif, 0, sizeof(*exif));
+
+    exif->enableThumb = true;
+    exif->width = width;
+    exif->height = height;
+    exif->widthThumb = BENCH_THUMB_WIDTH;
+    exif->heightThumb = BENCH_THUMB_HEIGHT;
+    strcpy(reinterpret_cast<char *>(exif->maker), "SAMSUNG");
+    strcpy(reinterpret_cast<char *>(exif->model), "hwjpeg_shot_benchmark");
+    strcpy(reinterpret_cast<char *>(exif->software), "libhwjpeg");
+    strcpy(reinterpret_cast<char *>(exif->date_time), "2017:01:01 00:00:00");
+    memcpy(exif->exif_version, "0220", 4);
+    exif->x_resolution.num = 72;
+    exif->x_resolution.den = 1;
+    exif->y_resolution.num = 72;
+    exif->y_resolution.den = 1;
+    exif->resolution_unit = 2;
+}
+
+/* returns false if a stream is not valid or the encoder fails */
+static bool runCase(int ionClient, const benchCase &test, int shots)
+{
+    size_t len = imageSize(test.format, test.width, test.height);
+    size_t thumbLen = imageSize(V4L2_PIX_FMT_NV21, BENCH_THUMB_WIDTH, BENCH_THUMB_HEIGHT);
+    std::vector<char> stream(len + 1024 * 1024);
+    std::vector<double> latency;
+    benchImage frame[BENCH_FRAMES];
+    benchImage thumb;
+    exif_attribute_t exif;
+    double psnr = 0;
+    bool valid = true;
+
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        if (!allocImage(ionClient, len, &frame[i]))
+            return false;
+        fillImage(reinterpret_cast<unsigned char *>(frame[i].addr), test.format, test.width, test.height, i * 5);
+    }
+    if (!allocImage(ionClient, thumbLen, &thumb))
+        return false;
+    fillImage(reinterpret_cast<unsigned char *>(thumb.addr), V4L2_PIX_FMT_NV21, BENCH_THUMB_WIDTH, BENCH_THUMB_HEIGHT, 3);
+
+    ExynosJpegEncoderForCamera encoder(false);
+    if (encoder.create() < 0) {
+        printf("  failed to create the encoder\n");
+        return false;
+    }
+
+    encoder.setColorFormat(test.format);
+    encoder.setJpegFormat(V4L2_PIX_FMT_JPEG_420);
+    encoder.setSize(test.width, test.height);
+    encoder.setQuality(BENCH_QUALITY);
+    encoder.setThumbnailSize(BENCH_THUMB_WIDTH, BENCH_THUMB_HEIGHT);
+    encoder.setThumbnailQuality(BENCH_THUMB_QUALITY);
+    setExif(&exif, test.width, test.height);
+
+    for (int shot = 0; shot < shots && valid; shot++) {
+        benchImage &image = frame[shot % BENCH_FRAMES];
+        int lens[3] = {static_cast<int>(len), 0, 0};
+        int ret;
+
+        if (test.userPtr) {
+            char *bufs[3] = {image.addr, NULL, NULL};
+            ret = encoder.setInBuf(bufs, lens);
+        } else {
+            int bufs[3] = {image.fd, -1, -1};
+            ret = encoder.setInBuf(bufs, lens);
+        }
+
+        if (ret == 0 && test.givenThumb) {
+            int bufs[3] = {thumb.fd, -1, -1};
+            int thumbLens[3] = {static_cast<int>(thumbLen), 0, 0};
+            ret = encoder.setInBuf2(bufs, thumbLens);
+        }
+
+        if (ret < 0) {
+            printf("  failed to set the image\n");
+            valid = false;
+            break;
+        }
+
+        int size = static_cast<int>(stream.size());
+        char *out = stream.data();
+        double start = getTimeUs();
+        ret = encoder.encode(&size, &exif, &out, static_cast<debug_attribute_t *>(NULL));
+        latency.push_back(getTimeUs() - start);
+
+        if (ret < 0 || size <= 0) {
+            printf("  failed to encode shot %d\n", shot);
+            valid = false;
+            break;
+        }
+
+        if (shot < BENCH_FRAMES || shot == shots - 1)
+            valid = checkStream(reinterpret_cast<unsigned char *>(out), size, test,
+                                reinterpret_cast<unsigned char *>(image.addr), &psnr);
+    }
+
+    if (!latency.empty()) {
+        double sum = 0;
+        for (double us : latency)
+            sum += us;
+        std::sort(latency.begin(), latency.end());
+
+        printf("%-17s | %4dx%-4d | %7.2f ms | %7.2f ms | %7.2f ms | %4.1f dB | %s\n", test.name,
+                test.width, test.height, sum / latency.size() / 1000, latency[latency.size() / 2] / 1000,
+                latency[latency.size() * 9 / 10] / 1000, psnr, valid ? "valid" : "INVALID");
+    }
+
+    for (int i = 0; i < BENCH_FRAMES; i++)
+        freeImage(&frame[i]);
+    freeImage(&thumb);
+
+    return valid;
+}
+
+int main(int argc, char **argv)
+{
+    int shots = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_SHOTS;
+    const char *name = (argc > 2) ? argv[2] : NULL;
+    int invalid = 0;
+
+    if (shots < BENCH_FRAMES) {
+        printf("usage: %s [shots(%d~)] [case]\n", argv[0], BENCH_FRAMES);
+        return -1;
+    }
+
+    int ionClient = exynos_ion_open();
+    if (ionClient < 0) {
+        printf("failed to open ion\n");
+        return -1;
+    }
+
+    printf("%d shots, thumbnail %dx%d\n", shots, BENCH_THUMB_WIDTH, BENCH_THUMB_HEIGHT);
+    printf("case              | size      |     mean   |     p50    |     p90    | PSNR    | stream\n");
+
+    for (const benchCase &test : benchCases) {
+        if (name != NULL && strcmp(name, test.name) != 0)
+            continue;
+        if (!runCase(ionClient, test, shots))
+            invalid++;
+    }
+
+    exynos_ion_close(ionClient);
+
+    printf("streams : %s (%d cases invalid)\n", invalid ? "INVALID" : "valid", invalid);
+
+    return invalid ? -1 : 0;
+}